@@ -0,0 +1,73 @@
+"""Measure time-to-first-task for many actors created on a single node.
+
+Runs the benchmark twice on a local Ray instance: once starting each worker
+from a fresh interpreter, and once forking workers from a worker fork server.
+"""
+import argparse
+import json
+import os
+import time
+
+import ray
+import ray._private.test_utils as test_utils
+import tqdm
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--num-actors", type=int, default=1000)
+parser.add_argument("--num-cpus", type=int, default=None)
+
+
+@ray.remote(num_cpus=0)
+class Actor:
+    def ready(self):
+        return time.time()
+
+
+def no_resource_leaks():
+    return ray.available_resources() == ray.cluster_resources()
+
+
+def time_to_first_task(num_actors, num_cpus, fork_server):
+    ray.init(
+        num_cpus=num_cpus,
+        _system_config={"worker_fork_server_enabled": fork_server})
+    # Warm up, so that the fork server template (if any) is running.
+    ray.get(Actor.remote().ready.remote())
+    test_utils.wait_for_condition(no_resource_leaks)
+
+    start_time = time.time()
+    actors = [
+        Actor.remote() for _ in tqdm.trange(num_actors, desc="Creating actors")
+    ]
+    first_task_times = ray.get([actor.ready.remote() for actor in actors])
+    end_time = time.time()
+    ray.shutdown()
+
+    first_task_latencies = sorted(t - start_time for t in first_task_times)
+    return {
+        "total_time": end_time - start_time,
+        "p50_time_to_first_task": first_task_latencies[num_actors // 2],
+        "max_time_to_first_task": first_task_latencies[-1],
+        "actors_per_second": num_actors / (end_time - start_time),
+    }
+
+
+if __name__ == "__main__":
+    args = parser.parse_args()
+    results = {"num_actors": args.num_actors}
+    for fork_server in [False, True]:
+        mode = "fork_server" if fork_server else "exec"
+        result = time_to_first_task(args.num_actors, args.num_cpus,
+                                    fork_server)
+        print(f"[{mode}] Created {args.num_actors} actors in "
+              f"{result['total_time']}s ({result['actors_per_second']} "
+              f"actors/s), p50 time to first task "
+              f"{result['p50_time_to_first_task']}s, max "
+              f"{result['max_time_to_first_task']}s.")
+        for key, value in result.items():
+            results[f"{mode}_{key}"] = value
+
+    if "TEST_OUTPUT_JSON" in os.environ:
+        out_file = open(os.environ["TEST_OUTPUT_JSON"], "w")
+        results["success"] = "1"
+        json.dump(results, out_file)
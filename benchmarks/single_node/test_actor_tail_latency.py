@@ -0,0 +1,89 @@
+"""Measure the call latency of a busy actor on a loaded node.
+
+Runs the benchmark twice on a local Ray instance: once letting the kernel
+schedule workers freely, and once pinning every worker that holds whole CPUs
+to dedicated cores.
+"""
+import argparse
+import json
+import os
+import time
+
+import numpy as np
+import ray
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--num-calls", type=int, default=20000)
+parser.add_argument("--work-ms", type=float, default=1.0)
+parser.add_argument("--num-cpus", type=int, default=os.cpu_count())
+
+
+@ray.remote(num_cpus=1)
+class BusyActor:
+    def __init__(self):
+        self.data = np.random.rand(64 * 1024)
+
+    def work(self, work_ms):
+        # Touch a cache-sized working set until the time is up.
+        deadline = time.perf_counter() + work_ms / 1000
+        while time.perf_counter() < deadline:
+            self.data.sum()
+        return time.perf_counter()
+
+
+@ray.remote(num_cpus=1)
+class LoadActor:
+    def spin(self, duration_s):
+        deadline = time.time() + duration_s
+        while time.time() < deadline:
+            pass
+
+
+def call_latencies(num_calls, work_ms, num_cpus, pinning):
+    ray.init(
+        num_cpus=num_cpus,
+        _system_config={"worker_cpu_pinning_enabled": pinning})
+    actor = BusyActor.remote()
+    ray.get(actor.work.remote(0))
+    # Load all the other CPUs, so that an unpinned actor competes for cores.
+    load_actors = [LoadActor.remote() for _ in range(num_cpus - 1)]
+    for load_actor in load_actors:
+        load_actor.spin.remote(3600)
+
+    latencies = []
+    for _ in range(num_calls):
+        start = time.perf_counter()
+        ray.get(actor.work.remote(work_ms))
+        latencies.append(time.perf_counter() - start)
+    for load_actor in load_actors:
+        ray.kill(load_actor)
+    ray.shutdown()
+
+    latencies_ms = np.array(latencies) * 1000
+    return {
+        "p50_latency_ms": float(np.percentile(latencies_ms, 50)),
+        "p99_latency_ms": float(np.percentile(latencies_ms, 99)),
+        "p999_latency_ms": float(np.percentile(latencies_ms, 99.9)),
+        "max_latency_ms": float(latencies_ms.max()),
+    }
+
+
+if __name__ == "__main__":
+    args = parser.parse_args()
+    results = {"num_calls": args.num_calls, "work_ms": args.work_ms}
+    for pinning in [False, True]:
+        mode = "pinned" if pinning else "unpinned"
+        result = call_latencies(args.num_calls, args.work_ms, args.num_cpus,
+                                pinning)
+        print(f"[{mode}] {args.num_calls} calls of {args.work_ms}ms: p50 "
+              f"{result['p50_latency_ms']:.3f}ms, p99 "
+              f"{result['p99_latency_ms']:.3f}ms, p99.9 "
+              f"{result['p999_latency_ms']:.3f}ms, max "
+              f"{result['max_latency_ms']:.3f}ms.")
+        for key, value in result.items():
+            results[f"{mode}_{key}"] = value
+
+    if "TEST_OUTPUT_JSON" in os.environ:
+        out_file = open(os.environ["TEST_OUTPUT_JSON"], "w")
+        results["success"] = "1"
+        json.dump(results, out_file)
@@ -69,6 +69,18 @@ def small_value_batch(n):
     return 0
 
 
+@ray.remote
+def chain_step(prev):
+    # The result of the previous step is nested in a list, so this task borrows
+    # it and waits for it while it runs.
+    return ray.get(prev[0]) + 1 if prev else 0
+
+
+@ray.remote
+def fan_in(*args):
+    return len(args)
+
+
 @ray.remote
 def create_object_containing_ref():
     obj_refs = []
@@ -285,6 +297,76 @@ def main(results=None):
     results += timeit("n:n async-actor calls async", async_actor_multi, m * n)
     ray.shutdown()
 
+    # Push every actor task in its own RPC instead of coalescing the tasks that
+    # queue up into batches, to compare with "1:1 actor calls async".
+    ray.init(_system_config={"actor_task_push_batch_size": 1})
+
+    a = Actor.remote()
+
+    def actor_async_unbatched():
+        ray.get([a.small_value.remote() for _ in range(1000)])
+
+    results += timeit("1:1 actor calls async (unbatched push)",
+                      actor_async_unbatched, 1000)
+    ray.shutdown()
+
+    # The latency per step of a chain of tasks that each wait for the small
+    # result of the previous one, with the results going through the driver
+    # that owns them or pushed directly to the next step.
+    depth = 20
+
+    def task_chain():
+        ref = chain_step.remote([])
+        for _ in range(depth - 1):
+            ref = chain_step.remote([ref])
+        assert ray.get(ref) == depth - 1
+
+    for push_to_borrowers in [False, True]:
+        ray.init(_system_config={
+            "push_small_returns_to_borrowers": push_to_borrowers
+        })
+        results += timeit(
+            "nested task chain steps (push small returns to borrowers: "
+            f"{push_to_borrowers})", task_chain, depth)
+        ray.shutdown()
+
+    # Tasks that each gather the small results of several tasks submitted just
+    # before them, with the worker for each gathering task leased only after
+    # its arguments are resolved or while they are resolved.
+    fan_in_width = 10
+
+    def fan_in_tasks():
+        refs = []
+        for _ in range(100):
+            args = [small_value.remote() for _ in range(fan_in_width)]
+            refs.append(fan_in.remote(*args))
+        ray.get(refs)
+
+    for pipeline_resolution in [False, True]:
+        ray.init(_system_config={
+            "pipeline_task_dependency_resolution": pipeline_resolution
+        })
+        results += timeit(
+            "fan-in tasks async (pipelined dependency resolution: "
+            f"{pipeline_resolution})", fan_in_tasks, 100)
+        ray.shutdown()
+
+    # Gathering the results of many tasks in a single ray.get, with the results
+    # deserialized after all of them are available or as they become available.
+    num_shards = 10000
+
+    def gather_shards():
+        ray.get([small_value.remote() for _ in range(num_shards)])
+
+    for as_completed in [False, True]:
+        ray.init(_system_config={
+            "get_as_completed_min_objects": num_shards if as_completed else 0
+        })
+        results += timeit(
+            f"gather 10k task results (get as completed: {as_completed})",
+            gather_shards, num_shards)
+        ray.shutdown()
+
     client_microbenchmark_main(results)
 
     return results
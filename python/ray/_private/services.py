@@ -1630,6 +1630,10 @@ def start_raylet(redis_address,
         subprocess.list2cmdline(agent_command)))
     if huge_pages:
         command.append("--huge_pages")
+    topology_path = os.environ.get(
+        ray_constants.RAY_NODE_TOPOLOGY_PATH_ENVIRONMENT_VARIABLE)
+    if topology_path:
+        command.append(f"--topology_path={topology_path}")
     if socket_to_use:
         socket_to_use.close()
     process_info = start_ray_process(
@@ -0,0 +1,115 @@
+"""A fork server that starts pre-initialized Python workers on demand.
+
+When `worker_fork_server_enabled` is set, the raylet starts one template
+worker process per runtime env with `--fork-server-socket`. The template has
+already paid for interpreter startup and for importing Ray, and instead of
+connecting to the raylet it forks a spare worker for each connection on a Unix
+domain socket. The spare worker waits on the connection for the options it is
+started with. See src/ray/raylet/worker_fork_server.h for the wire protocol.
+"""
+
+import logging
+import os
+import select
+import signal
+import socket
+import struct
+
+logger = logging.getLogger(__name__)
+
+# How often the template checks whether the raylet is still alive.
+PARENT_CHECK_INTERVAL_S = 1.0
+
+
+def _recv_exactly(conn, size):
+    data = b""
+    while len(data) < size:
+        chunk = conn.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("Fork request was truncated.")
+        data += chunk
+    return data
+
+
+def decode_request(payload):
+    """Decode the payload of a fork request into (argv, env)."""
+    parts = payload.split(b"\0")
+    separator = parts.index(b"")
+    argv = [part.decode() for part in parts[:separator]]
+    env = {}
+    for part in parts[separator + 1:]:
+        if not part:
+            continue
+        key, _, value = part.decode().partition("=")
+        env[key] = value
+    return argv, env
+
+
+def _wait_for_request(conn):
+    """Wait in a spare worker for the options it is started with."""
+    try:
+        (size, ) = struct.unpack("<I", _recv_exactly(conn, 4))
+        argv, env = decode_request(_recv_exactly(conn, size))
+    except Exception:
+        # The raylet discarded this spare worker, or exited.
+        os._exit(0)
+    finally:
+        conn.close()
+    os.environ.update(env)
+    return argv, env
+
+
+def serve(socket_path):
+    """Serve fork requests until the raylet exits.
+
+    This only returns in forked workers.
+
+    Args:
+        socket_path (str): The path of the Unix domain socket to listen on.
+
+    Returns:
+        The command line arguments and the environment variables the forked
+        worker was requested with. The environment variables are already set.
+    """
+    parent_pid = os.getppid()
+    # Forked workers are tracked by the raylet by PID, so let the kernel reap
+    # them instead of leaving zombies behind.
+    signal.signal(signal.SIGCHLD, signal.SIG_IGN)
+
+    if os.path.exists(socket_path):
+        os.unlink(socket_path)
+    # Bind to a temporary path and rename it once we are listening, because the
+    # raylet considers the fork server ready as soon as the socket path exists.
+    tmp_socket_path = socket_path + ".tmp"
+    if os.path.exists(tmp_socket_path):
+        os.unlink(tmp_socket_path)
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(tmp_socket_path)
+    server.listen(128)
+    os.rename(tmp_socket_path, socket_path)
+    logger.info(f"Worker fork server listening on {socket_path}.")
+
+    while True:
+        if os.getppid() != parent_pid:
+            # The raylet has died.
+            server.close()
+            os._exit(0)
+        ready, _, _ = select.select([server], [], [], PARENT_CHECK_INTERVAL_S)
+        if not ready:
+            continue
+        conn, _ = server.accept()
+        pid = os.fork()
+        if pid == 0:
+            server.close()
+            signal.signal(signal.SIGCHLD, signal.SIG_DFL)
+            return _wait_for_request(conn)
+
+        try:
+            conn.sendall(f"{pid}\n".encode())
+        except OSError:
+            # The raylet gave up on this request, so the worker will never be
+            # started.
+            logger.exception(f"Failed to report forked worker {pid}.")
+            os.kill(pid, signal.SIGKILL)
+        finally:
+            conn.close()
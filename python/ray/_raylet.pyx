@@ -94,6 +94,7 @@ from ray.includes.libcoreworker cimport (
     ResourceMappingType,
     CFiberEvent,
     CActorHandle,
+    CAsCompletedGet,
 )
 
 from ray.includes.gcs_client cimport CGcsClient
@@ -627,6 +628,12 @@ cdef execute_task(
                             ray.util.pdb.set_trace(
                                 breakpoint_uuid=debugger_breakpoint)
                         outputs = function_executor(*args, **kwargs)
+                        if (core_worker
+                                .get_current_task_is_streaming_generator()):
+                            # The values are reported to the caller as they are
+                            # produced, and the task returns their number.
+                            outputs = core_worker.store_generator_outputs(
+                                worker, outputs)
                         next_breakpoint = (
                             ray.worker.global_worker.debugger_breakpoint)
                         if next_breakpoint != b"":
@@ -1022,6 +1029,38 @@ cdef class EmptyProfileEvent:
     def __exit__(self, *args):
         pass
 
+cdef class AsCompletedGet:
+    """A get of many objects that returns them as they become available.
+
+    Created by CoreWorker.get_objects_as_completed, and must only be used on
+    the thread that created it.
+    """
+    cdef:
+        unique_ptr[CAsCompletedGet] inner
+
+    def done(self):
+        return self.inner.get().Done()
+
+    def next(self, int64_t timeout_ms=-1):
+        """Wait until at least one of the remaining objects is available.
+
+        Returns:
+            A list of (index, (data, metadata)) tuples for the available
+            objects, where index is the position of the object in the
+            requested refs. Empty if all objects were already returned.
+        """
+        cdef:
+            c_vector[pair[size_t, shared_ptr[CRayObject]]] ready
+            c_vector[shared_ptr[CRayObject]] objects
+        with nogil:
+            check_status(self.inner.get().Next(timeout_ms, &ready))
+        for i in range(ready.size()):
+            objects.push_back(ready[i].second)
+        data_metadata_pairs = RayObjectsToDataMetadataPairs(objects)
+        return [(ready[i].first, data_metadata_pairs[i])
+                for i in range(ready.size())]
+
+
 cdef class CoreWorker:
 
     def __cinit__(self, worker_type, store_socket, raylet_socket,
@@ -1113,6 +1152,10 @@ cdef class CoreWorker:
         return CCoreWorkerProcess.GetCoreWorker(
             ).GetCurrentTaskRetryExceptions()
 
+    def get_current_task_is_streaming_generator(self):
+        return CCoreWorkerProcess.GetCoreWorker(
+            ).GetCurrentTaskIsStreamingGenerator()
+
     def get_current_task_id(self):
         return TaskID(
             CCoreWorkerProcess.GetCoreWorker().GetCurrentTaskId().Binary())
@@ -1163,6 +1206,46 @@ cdef class CoreWorker:
 
         return RayObjectsToDataMetadataPairs(results)
 
+    def get_objects_as_completed(self, object_refs):
+        cdef:
+            c_vector[CObjectID] c_object_ids = ObjectRefsToVector(object_refs)
+            AsCompletedGet get = AsCompletedGet.__new__(AsCompletedGet)
+        get.inner = move(
+            CCoreWorkerProcess.GetCoreWorker().GetAsCompleted(c_object_ids))
+        return get
+
+    def read_object_ref_stream(self, ObjectRef generator_ref,
+                               int64_t timeout_ms=-1):
+        """Wait for the next value of a streaming generator task.
+
+        Returns:
+            The ref to the next value, or None at the end of the stream.
+        """
+        cdef:
+            CObjectID c_generator_id = generator_ref.native()
+            CObjectID c_object_id
+            c_bool end_of_stream = False
+        with nogil:
+            check_status(
+                CCoreWorkerProcess.GetCoreWorker().ReadObjectRefStream(
+                    c_generator_id, timeout_ms, &c_object_id,
+                    &end_of_stream))
+        if c_object_id.IsNil():
+            return None
+        # The stream's reference to the value is handed over to the ref.
+        return ObjectRef(
+            c_object_id.Binary(),
+            CCoreWorkerProcess.GetCoreWorker()
+            .GetRpcAddress().SerializeAsString(),
+            skip_adding_local_ref=True)
+
+    def del_object_ref_stream(self, ObjectRef generator_ref):
+        cdef:
+            CObjectID c_generator_id = generator_ref.native()
+        with nogil:
+            CCoreWorkerProcess.GetCoreWorker().DelObjectRefStream(
+                c_generator_id)
+
     def get_if_local(self, object_refs):
         """Get objects from local plasma store directly
         without a fetch request to raylet."""
@@ -1429,6 +1512,7 @@ cdef class CoreWorker:
                     c_string debugger_breakpoint,
                     c_string serialized_runtime_env,
                     runtime_env_uris,
+                    c_bool streaming_generator=False,
                     ):
         cdef:
             unordered_map[c_string, double] c_resources
@@ -1454,7 +1538,8 @@ cdef class CoreWorker:
                     name, num_returns, c_resources,
                     b"",
                     serialized_runtime_env,
-                    c_runtime_env_uris),
+                    c_runtime_env_uris,
+                    streaming_generator),
                 max_retries, retry_exceptions,
                 c_pair[CPlacementGroupID, int64_t](
                     c_placement_group_id, placement_group_bundle_index),
@@ -1889,6 +1974,62 @@ cdef class CoreWorker:
                     CCoreWorkerProcess.GetCoreWorker().SealReturnObject(
                         return_id, returns[0][i]))
 
+    cdef store_generator_outputs(self, worker, generator):
+        """Report each value of a streaming generator task to the caller as
+        soon as it is produced.
+
+        Returns:
+            The number of values.
+        """
+        cdef:
+            CObjectID return_id
+            size_t data_size
+            shared_ptr[CBuffer] metadata
+            c_vector[CObjectID] contained_id
+            int64_t task_output_inlined_bytes
+            shared_ptr[CRayObject] return_object
+            int64_t item_index = 0
+
+        if not hasattr(generator, "__iter__"):
+            raise ValueError(
+                "Task with num_returns=\"streaming\" must return an iterable, "
+                "but it returned {}.".format(type(generator)))
+        context = worker.get_serialization_context()
+        for output in generator:
+            serialized_object = context.serialize(output)
+            data_size = serialized_object.total_bytes
+            metadata = string_to_buffer(serialized_object.metadata)
+            contained_id = ObjectRefsToVector(
+                serialized_object.contained_object_refs)
+            # Each value is sent to the caller in its own message, so it may be
+            # inlined up to the limit on its own.
+            task_output_inlined_bytes = 0
+            return_object.reset()
+            return_id = (CCoreWorkerProcess.GetCoreWorker()
+                         .AllocateDynamicReturnId())
+
+            with nogil:
+                check_status(
+                    CCoreWorkerProcess.GetCoreWorker().AllocateReturnObject(
+                        return_id, data_size, metadata, contained_id,
+                        task_output_inlined_bytes, &return_object))
+
+            if (return_object.get() != NULL and
+                    return_object.get().HasData()):
+                (<SerializedObject>serialized_object).write_to(
+                    Buffer.make(return_object.get().GetData()))
+
+            with nogil:
+                check_status(
+                    CCoreWorkerProcess.GetCoreWorker().SealReturnObject(
+                        return_id, return_object))
+                check_status(
+                    CCoreWorkerProcess.GetCoreWorker()
+                    .ReportGeneratorItemReturns(
+                        return_id, return_object, item_index))
+            item_index += 1
+        return item_index
+
     cdef c_function_descriptors_to_python(
             self,
             const c_vector[CFunctionDescriptor] &c_function_descriptors):
@@ -240,6 +240,12 @@ cdef extern from "ray/core_worker/common.h" nogil:
                      c_string concurrency_group_name,
                      c_string serialized_runtime_env,
                      c_vector[c_string] runtime_env_uris)
+        CTaskOptions(c_string name, int num_returns,
+                     unordered_map[c_string, double] &resources,
+                     c_string concurrency_group_name,
+                     c_string serialized_runtime_env,
+                     c_vector[c_string] runtime_env_uris,
+                     c_bool streaming_generator)
 
     cdef cppclass CActorCreationOptions "ray::core::ActorCreationOptions":
         CActorCreationOptions()
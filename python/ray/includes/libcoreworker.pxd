@@ -83,6 +83,12 @@ cdef extern from "ray/core_worker/fiber.h" nogil:
         void Wait()
         void Notify()
 
+cdef extern from "ray/core_worker/store_provider/as_completed_get.h" nogil:
+    cdef cppclass CAsCompletedGet "ray::core::AsCompletedGet":
+        CRayStatus Next(int64_t timeout_ms,
+                        c_vector[pair[size_t, shared_ptr[CRayObject]]] *ready)
+        c_bool Done()
+
 cdef extern from "ray/core_worker/context.h" nogil:
     cdef cppclass CWorkerContext "ray::core::WorkerContext":
         c_bool CurrentActorIsAsync()
@@ -145,11 +151,17 @@ cdef extern from "ray/core_worker/core_worker.h" nogil:
             const CObjectID& return_id,
             shared_ptr[CRayObject] return_object
         )
+        CObjectID AllocateDynamicReturnId()
+        CRayStatus ReportGeneratorItemReturns(
+            const CObjectID &object_id,
+            const shared_ptr[CRayObject] &object,
+            int64_t item_index)
 
         CJobID GetCurrentJobId()
         CTaskID GetCurrentTaskId()
         CNodeID GetCurrentNodeId()
         c_bool GetCurrentTaskRetryExceptions()
+        c_bool GetCurrentTaskIsStreamingGenerator()
         CPlacementGroupID GetCurrentPlacementGroupId()
         CWorkerID GetWorkerID()
         c_bool ShouldCaptureChildTasksInPlacementGroup()
@@ -212,6 +224,12 @@ cdef extern from "ray/core_worker/core_worker.h" nogil:
                                 const unique_ptr[CAddress] &owner_address)
         CRayStatus Get(const c_vector[CObjectID] &ids, int64_t timeout_ms,
                        c_vector[shared_ptr[CRayObject]] *results)
+        unique_ptr[CAsCompletedGet] GetAsCompleted(
+            const c_vector[CObjectID] &ids)
+        CRayStatus ReadObjectRefStream(
+            const CObjectID &generator_id, int64_t timeout_ms,
+            CObjectID *object_id, c_bool *end_of_stream)
+        void DelObjectRefStream(const CObjectID &generator_id)
         CRayStatus GetIfLocal(
             const c_vector[CObjectID] &ids,
             c_vector[shared_ptr[CRayObject]] *results)
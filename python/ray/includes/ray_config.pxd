@@ -66,3 +66,5 @@ cdef extern from "ray/common/ray_config.h" nogil:
         uint32_t max_grpc_message_size() const
 
         c_bool record_ref_creation_sites() const
+
+        int64_t get_as_completed_min_objects() const
@@ -111,3 +111,7 @@ cdef class Config:
     @staticmethod
     def record_ref_creation_sites():
         return RayConfig.instance().record_ref_creation_sites()
+
+    @staticmethod
+    def get_as_completed_min_objects():
+        return RayConfig.instance().get_as_completed_min_objects()
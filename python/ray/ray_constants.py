@@ -51,6 +51,9 @@ DEFAULT_PORT = 6379
 RAY_ADDRESS_ENVIRONMENT_VARIABLE = "RAY_ADDRESS"
 RAY_NAMESPACE_ENVIRONMENT_VARIABLE = "RAY_NAMESPACE"
 RAY_RUNTIME_ENV_ENVIRONMENT_VARIABLE = "RAY_RUNTIME_ENV"
+# The topology path of a node, from the widest failure domain to the narrowest,
+# e.g., "us-west-2a/rack-17". The schedulers prefer to keep work within a rack.
+RAY_NODE_TOPOLOGY_PATH_ENVIRONMENT_VARIABLE = "RAY_NODE_TOPOLOGY_PATH"
 
 DEFAULT_DASHBOARD_IP = "127.0.0.1"
 DEFAULT_DASHBOARD_PORT = 8265
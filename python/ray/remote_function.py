@@ -31,6 +31,38 @@ DEFAULT_REMOTE_FUNCTION_RETRY_EXCEPTIONS = False
 logger = logging.getLogger(__name__)
 
 
+class StreamingObjectRefGenerator:
+    """The refs to the values of a task with num_returns="streaming".
+
+    Iterating over the generator yields a ref to each value as soon as the
+    task produces it, in order, so that the caller can start consuming the
+    values while the task is still running. Once the task finished, the
+    iteration raises the task's error, if any.
+    """
+
+    def __init__(self, generator_ref, worker):
+        # The ref to the task's return value, which is the number of values.
+        self._generator_ref = generator_ref
+        self._worker = worker
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        ref = self._worker.core_worker.read_object_ref_stream(
+            self._generator_ref)
+        if ref is None:
+            # Raise the task's error if it failed.
+            ray.get(self._generator_ref)
+            raise StopIteration
+        return ref
+
+    def __del__(self):
+        if self._worker.connected:
+            # Release the values that weren't consumed.
+            self._worker.core_worker.del_object_ref_stream(self._generator_ref)
+
+
 class RemoteFunction:
     """A remote function.
 
@@ -280,6 +312,12 @@ class RemoteFunction:
 
         if num_returns is None:
             num_returns = self._num_returns
+        streaming_generator = num_returns == "streaming"
+        if streaming_generator:
+            if worker.mode == ray.worker.LOCAL_MODE:
+                raise ValueError(
+                    "num_returns=\"streaming\" is not supported in local mode")
+            num_returns = 1
         if max_retries is None:
             max_retries = self._max_retries
         if retry_exceptions is None:
@@ -342,10 +380,12 @@ class RemoteFunction:
                 placement_group.id, placement_group_bundle_index,
                 placement_group_capture_child_tasks,
                 worker.debugger_breakpoint, parsed_runtime_env.serialize(),
-                parsed_runtime_env.get_uris())
+                parsed_runtime_env.get_uris(), streaming_generator)
             # Reset worker's debug context from the last "remote" command
             # (which applies only to this .remote call).
             worker.debugger_breakpoint = b""
+            if streaming_generator:
+                return StreamingObjectRefGenerator(object_refs[0], worker)
             if len(object_refs) == 1:
                 return object_refs[0]
             elif len(object_refs) > 1:
@@ -13,6 +13,7 @@ from ray._private.test_utils import (
     dicts_equal,
     wait_for_pid_to_exit,
     wait_for_condition,
+    SignalActor,
 )
 from pathlib import Path
 
@@ -315,5 +316,46 @@ def test_function_unique_export(ray_start_regular):
     assert ray.worker.global_worker.redis_client.llen("Exports") == num_exports
 
 
+def test_streaming_generator(ray_start_regular):
+    @ray.remote(num_returns="streaming")
+    def generator(n, fail=False):
+        for i in range(n):
+            yield np.ones(i * 100 * 1024, dtype=np.uint8)
+        if fail:
+            raise ValueError("generator failed")
+
+    # Small values are inlined and large ones are stored in plasma.
+    refs = list(generator.remote(5))
+    assert [ray.get(ref).size for ref in refs] == [
+        i * 100 * 1024 for i in range(5)
+    ]
+
+    # The values yielded before the failure are still available.
+    gen = generator.remote(2, fail=True)
+    assert ray.get(next(gen)).size == 0
+    assert ray.get(next(gen)).size == 100 * 1024
+    with pytest.raises(ValueError):
+        next(gen)
+
+    # The values are consumed while the task is still running.
+    @ray.remote(num_returns="streaming")
+    def wait_for_signal(signal):
+        yield 1
+        ray.get(signal.wait.remote())
+        yield 2
+
+    signal = SignalActor.remote()
+    gen = wait_for_signal.remote(signal)
+    assert ray.get(next(gen)) == 1
+    ray.get(signal.send.remote())
+    assert ray.get(next(gen)) == 2
+    with pytest.raises(StopIteration):
+        next(gen)
+
+    # A generator that isn't consumed releases its values.
+    gen = generator.remote(3)
+    del gen
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main(["-v", __file__]))
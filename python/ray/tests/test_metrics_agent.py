@@ -45,6 +45,8 @@ _METRICS = [
     "ray_heartbeat_report_ms_sum",
     "ray_process_startup_time_ms_sum",
     "ray_internal_num_processes_started",
+    "ray_internal_num_predictive_prestarted_workers",
+    "ray_internal_num_predictive_prestart_hits",
     "ray_internal_num_received_tasks",
     "ray_internal_num_dispatched_tasks",
     "ray_internal_num_spilled_tasks",
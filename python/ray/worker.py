@@ -347,8 +347,50 @@ class Worker:
                     "which is not an ray.ObjectRef.")
 
         timeout_ms = int(timeout * 1000) if timeout else -1
+        min_objects = ray._config.get_as_completed_min_objects()
+        if min_objects > 0 and len(object_refs) >= min_objects:
+            return self._get_objects_as_completed(object_refs, timeout_ms)
         data_metadata_pairs = self.core_worker.get_objects(
             object_refs, self.current_task_id, timeout_ms)
+        debugger_breakpoint = self._get_debugger_breakpoint(
+            data_metadata_pairs)
+        return self.deserialize_objects(data_metadata_pairs,
+                                        object_refs), debugger_breakpoint
+
+    def _get_objects_as_completed(self, object_refs, timeout_ms):
+        """Get the values associated with the IDs as they become available.
+
+        The values that are available are deserialized while the rest are
+        still being fetched, instead of after all of them are fetched. Like
+        get_objects, this returns early if any of the values is an error.
+        """
+        values = [None] * len(object_refs)
+        debugger_breakpoint = b""
+        deadline = None
+        if timeout_ms >= 0:
+            deadline = time.monotonic() + timeout_ms / 1000
+        get = self.core_worker.get_objects_as_completed(object_refs)
+        while not get.done():
+            remaining_ms = -1
+            if deadline is not None:
+                remaining_ms = max(0, int(
+                    (deadline - time.monotonic()) * 1000))
+            ready = get.next(remaining_ms)
+            indices = [index for index, _ in ready]
+            data_metadata_pairs = [pair for _, pair in ready]
+            debugger_breakpoint = self._get_debugger_breakpoint(
+                data_metadata_pairs) or debugger_breakpoint
+            batch = self.deserialize_objects(
+                data_metadata_pairs, [object_refs[i] for i in indices])
+            for index, value in zip(indices, batch):
+                values[index] = value
+            if any(isinstance(value, RayError) for value in batch):
+                break
+        return values, debugger_breakpoint
+
+    def _get_debugger_breakpoint(self, data_metadata_pairs):
+        """Return the UUID of the last debugger breakpoint in the objects, or
+        b"" if there is none."""
         debugger_breakpoint = b""
         for (data, metadata) in data_metadata_pairs:
             if metadata:
@@ -357,8 +399,7 @@ class Worker:
                         ray_constants.OBJECT_METADATA_DEBUG_PREFIX):
                     debugger_breakpoint = metadata_fields[1][len(
                         ray_constants.OBJECT_METADATA_DEBUG_PREFIX):]
-        return self.deserialize_objects(data_metadata_pairs,
-                                        object_refs), debugger_breakpoint
+        return debugger_breakpoint
 
     def run_function_on_all_workers(self, function):
         """Run arbitrary code on all of the workers.
@@ -1961,11 +2002,11 @@ def make_decorator(num_returns=None,
             if max_task_retries is not None:
                 raise ValueError("The keyword 'max_task_retries' is not "
                                  "allowed for remote functions.")
-            if num_returns is not None and (not isinstance(num_returns, int)
-                                            or num_returns < 0):
+            if num_returns is not None and num_returns != "streaming" and (
+                    not isinstance(num_returns, int) or num_returns < 0):
                 raise ValueError(
-                    "The keyword 'num_returns' only accepts 0 or a"
-                    " positive integer")
+                    "The keyword 'num_returns' only accepts 0, a positive"
+                    " integer, or \"streaming\"")
             if max_retries is not None and (not isinstance(max_retries, int)
                                             or max_retries < -1):
                 raise ValueError(
@@ -2072,7 +2113,10 @@ def remote(*args, **kwargs):
     Args:
         num_returns (int): This is only for *remote functions*. It specifies
             the number of object refs returned by
-            the remote function invocation.
+            the remote function invocation. If "streaming", the function
+            must be a generator, and the invocation returns an iterator over
+            refs to the values that the generator yields, each available as
+            soon as it is yielded.
         num_cpus (float): The quantity of CPU cores to reserve
             for this task or for the lifetime of the actor.
         num_gpus (int): The quantity of GPUs to reserve
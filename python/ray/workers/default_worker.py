@@ -134,6 +134,13 @@ parser.add_argument(
     default=False,
     action="store_true",
     help="True if Ray debugger is made available externally.")
+parser.add_argument(
+    "--fork-server-socket",
+    required=False,
+    type=str,
+    default=None,
+    help="If set, run as a template that forks pre-initialized workers "
+    "on requests received on this Unix domain socket.")
 
 if __name__ == "__main__":
     # NOTE(sang): For some reason, if we move the code below
@@ -141,6 +148,13 @@ if __name__ == "__main__":
     # as a step function. For more details, check out
     # https://github.com/ray-project/ray/pull/12225#issue-525059663.
     args = parser.parse_args()
+    if args.fork_server_socket is not None:
+        from ray._private import worker_fork_server
+        worker_argv, _ = worker_fork_server.serve(args.fork_server_socket)
+        # This is a forked worker. Parse its own options from the command line
+        # it would have been started with, ignoring those of the interpreter
+        # and of the runtime env setup.
+        args, _ = parser.parse_known_args(worker_argv[1:])
     ray._private.ray_logging.setup_logger(args.logging_level,
                                           args.logging_format)
 
@@ -45,6 +45,10 @@ class MockActorInfoAccessor : public ActorInfoAccessor {
               (const TaskSpecification &task_spec,
                const rpc::ClientCallback<rpc::CreateActorReply> &callback),
               (override));
+  MOCK_METHOD(Status, AsyncCreateActors,
+              (const std::vector<TaskSpecification> &task_specs,
+               const rpc::ClientCallback<rpc::CreateActorsReply> &callback),
+              (override));
   MOCK_METHOD(Status, AsyncSubscribeAll,
               ((const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe),
                const StatusCallback &done),
@@ -35,6 +35,10 @@ class MockGcsActorManager : public GcsActorManager {
               (const rpc::CreateActorRequest &request, rpc::CreateActorReply *reply,
                rpc::SendReplyCallback send_reply_callback),
               (override));
+  MOCK_METHOD(void, HandleCreateActors,
+              (const rpc::CreateActorsRequest &request, rpc::CreateActorsReply *reply,
+               rpc::SendReplyCallback send_reply_callback),
+              (override));
   MOCK_METHOD(void, HandleGetActorInfo,
               (const rpc::GetActorInfoRequest &request, rpc::GetActorInfoReply *reply,
                rpc::SendReplyCallback send_reply_callback),
@@ -18,6 +18,8 @@ namespace gcs {
 class MockGcsActorSchedulerInterface : public GcsActorSchedulerInterface {
  public:
   MOCK_METHOD(void, Schedule, (std::shared_ptr<GcsActor> actor), (override));
+  MOCK_METHOD(void, ScheduleBatch, (std::vector<std::shared_ptr<GcsActor>> actors),
+              (override));
   MOCK_METHOD(void, Reschedule, (std::shared_ptr<GcsActor> actor), (override));
   MOCK_METHOD(std::vector<ActorID>, CancelOnNode, (const NodeID &node_id), (override));
   MOCK_METHOD(void, CancelOnLeasing,
@@ -40,6 +42,8 @@ namespace gcs {
 class MockGcsActorScheduler : public GcsActorScheduler {
  public:
   MOCK_METHOD(void, Schedule, (std::shared_ptr<GcsActor> actor), (override));
+  MOCK_METHOD(void, ScheduleBatch, (std::vector<std::shared_ptr<GcsActor>> actors),
+              (override));
   MOCK_METHOD(void, Reschedule, (std::shared_ptr<GcsActor> actor), (override));
   MOCK_METHOD(std::vector<ActorID>, CancelOnNode, (const NodeID &node_id), (override));
   MOCK_METHOD(void, CancelOnLeasing,
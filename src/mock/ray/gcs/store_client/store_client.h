@@ -26,6 +26,11 @@ class MockStoreClient : public StoreClient {
                const std::string &index_key, const std::string &data,
                const StatusCallback &callback),
               (override));
+  MOCK_METHOD(Status, AsyncBatchPut,
+              (const std::string &table_name, const std::vector<std::string> &keys,
+               const std::vector<std::string> &index_keys,
+               const std::vector<std::string> &data, const StatusCallback &callback),
+              (override));
   MOCK_METHOD(Status, AsyncGet,
               (const std::string &table_name, const std::string &key,
                const OptionalItemCallback<std::string> &callback),
@@ -123,6 +123,11 @@ class MockNodeManager : public NodeManager {
                rpc::GetGcsServerAddressReply *reply,
                rpc::SendReplyCallback send_reply_callback),
               (override));
+  MOCK_METHOD(void, HandleGetTaskEventsTrace,
+              (const rpc::GetTaskEventsTraceRequest &request,
+               rpc::GetTaskEventsTraceReply *reply,
+               rpc::SendReplyCallback send_reply_callback),
+              (override));
 };
 
 }  // namespace raylet
@@ -100,10 +100,12 @@ class MockResourceTrackingInterface : public ResourceTrackingInterface {
  public:
   MOCK_METHOD(void, UpdateResourceUsage,
               (std::string & serialized_resource_usage_batch,
+               const std::vector<rpc::Address> &relay_addresses,
                const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback),
               (override));
   MOCK_METHOD(void, RequestResourceReport,
-              (const rpc::ClientCallback<rpc::RequestResourceReportReply> &callback),
+              (int64_t last_applied_version,
+               const rpc::ClientCallback<rpc::RequestResourceReportReply> &callback),
               (override));
 };
 
@@ -176,10 +178,12 @@ class MockRayletClientInterface : public RayletClientInterface {
               (override));
   MOCK_METHOD(void, UpdateResourceUsage,
               (std::string & serialized_resource_usage_batch,
+               const std::vector<rpc::Address> &relay_addresses,
                const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback),
               (override));
   MOCK_METHOD(void, RequestResourceReport,
-              (const rpc::ClientCallback<rpc::RequestResourceReportReply> &callback),
+              (int64_t last_applied_version,
+               const rpc::ClientCallback<rpc::RequestResourceReportReply> &callback),
               (override));
   MOCK_METHOD(void, ShutdownRaylet,
               (const NodeID &node_id, bool graceful,
@@ -0,0 +1,48 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace ray {
+
+/// Split the receivers of a message that is relayed along a broadcast tree. The sender
+/// sends the message to the first `fanout` receivers, and hands each of them a
+/// contiguous chunk of the remaining receivers to relay the message to in turn. Applied
+/// at every hop, each receiver gets the message exactly once, and the tree has a depth
+/// of O(log_fanout(N)).
+///
+/// \param receivers The receivers that the sender is responsible for.
+/// \param fanout The maximum number of receivers the sender sends to directly.
+/// \return A (child, receivers the child should relay to) pair per child.
+template <typename T>
+std::vector<std::pair<T, std::vector<T>>> SplitBroadcastTree(
+    const std::vector<T> &receivers, size_t fanout) {
+  fanout = std::max<size_t>(fanout, 1);
+  const size_t num_children = std::min(fanout, receivers.size());
+  const size_t num_relayed = receivers.size() - num_children;
+  std::vector<std::pair<T, std::vector<T>>> subtrees;
+  subtrees.reserve(num_children);
+  for (size_t i = 0; i < num_children; i++) {
+    auto begin = receivers.begin() + num_children + i * num_relayed / num_children;
+    auto end = receivers.begin() + num_children + (i + 1) * num_relayed / num_children;
+    subtrees.emplace_back(receivers[i], std::vector<T>(begin, end));
+  }
+  return subtrees;
+}
+
+}  // namespace ray
@@ -57,6 +57,12 @@ RAY_CONFIG(int64_t, num_heartbeats_timeout, 30)
 /// heartbeat periods ago, then a warning will be logged that the heartbeat
 /// handler is drifting.
 RAY_CONFIG(uint64_t, num_heartbeats_warning, 5)
+/// If positive, the GCS adapts the heartbeat timeout of each node to the history of
+/// its heartbeat intervals, like a phi accrual failure detector: a node is declared
+/// dead once the probability that its next heartbeat is still coming falls below
+/// 10^-threshold. The timeout is at least num_heartbeats_timeout heartbeat periods, so
+/// nodes that have paused before, e.g., for GC, get more time. 0 disables it.
+RAY_CONFIG(double, gcs_heartbeat_phi_threshold, 0)
 
 /// The duration between reporting resources sent by the raylets.
 RAY_CONFIG(uint64_t, raylet_report_resources_period_milliseconds, 100)
@@ -92,6 +98,12 @@ RAY_CONFIG(size_t, free_objects_batch_size, 100)
 
 RAY_CONFIG(bool, lineage_pinning_enabled, false)
 
+/// The maximum number of bytes of the specs of finished tasks that an owner keeps as
+/// lineage to reconstruct their return values. Beyond this, the lineage of the tasks
+/// that finished first is evicted, and their return values can no longer be
+/// reconstructed.
+RAY_CONFIG(int64_t, max_lineage_bytes, 1024 * 1024 * 1024)
+
 /// Whether to re-populate plasma memory. This avoids memory allocation failures
 /// at runtime (SIGBUS errors creating new objects), however it will use more memory
 /// upfront and can slow down Ray startup.
@@ -103,6 +115,12 @@ RAY_CONFIG(bool, preallocate_plasma_memory, false)
 /// even balancing of load. Low values (min 0.0) encourage more load spreading.
 RAY_CONFIG(float, scheduler_spread_threshold, 0.5);
 
+/// Whether the schedulers should first pick a topology group (e.g., a rack) and then a
+/// node within it, for nodes that are started with a topology path (e.g.,
+/// RAY_NODE_TOPOLOGY_PATH="us-west-2a/rack-17"). This has no effect if no node has a
+/// topology path.
+RAY_CONFIG(bool, scheduler_topology_aware, true);
+
 // The max allowed size in bytes of a return object from direct actor calls.
 // Objects larger than this size will be spilled/promoted to plasma.
 RAY_CONFIG(int64_t, max_direct_call_object_size, 100 * 1024)
@@ -123,6 +141,24 @@ RAY_CONFIG(uint64_t, actor_creation_min_retries, 3)
 /// It likely indicates a bug in the user code.
 RAY_CONFIG(int64_t, actor_excess_queueing_warn_threshold, 5000)
 
+/// The maximum number of actor tasks that a worker pushes to an actor in one RPC.
+/// Tasks that are submitted while `actor_task_max_push_rpcs_in_flight` pushes to
+/// the actor are in flight are coalesced into batches of up to this size. The result
+/// of each task is still received as soon as it finished. Set to 1 to push every task
+/// in its own RPC.
+RAY_CONFIG(int64_t, actor_task_push_batch_size, 100)
+
+/// The maximum number of RPCs pushing tasks to an actor that a worker keeps in
+/// flight when pushing tasks in batches. It only applies to actors that execute tasks
+/// one at a time, since the tasks of asyncio and threaded actors may wait for later
+/// tasks.
+RAY_CONFIG(int64_t, actor_task_max_push_rpcs_in_flight, 4)
+
+/// The maximum number of task spec templates that a worker caches to build the specs
+/// of repeated calls to the same function or actor method. Set to 0 to build every
+/// spec from scratch.
+RAY_CONFIG(uint64_t, task_spec_template_cache_size, 1000)
+
 /// When trying to resolve an object, the initial period that the raylet will
 /// wait before contacting the object's owner to check if the object is still
 /// available. This is a lower bound on the time to report the loss of an
@@ -147,6 +183,17 @@ RAY_CONFIG(int64_t, worker_fetch_request_size, 10000)
 /// user.
 RAY_CONFIG(int64_t, fetch_warn_timeout_milliseconds, 60000)
 
+/// The minimum number of objects in a ray.get for the frontend to get the objects as
+/// they become available, and deserialize them while the rest are being fetched.
+/// Set to 0 to always get all objects first.
+RAY_CONFIG(int64_t, get_as_completed_min_objects, 1000)
+
+/// How often a get that returns objects as they complete checks the local plasma
+/// store for the objects that were promoted to plasma, while it also waits for
+/// objects in the memory store. The objects are fetched by a single request to the
+/// raylet that stays open until the get ends, so polling doesn't contact the raylet.
+RAY_CONFIG(int64_t, get_as_completed_plasma_poll_milliseconds, 10)
+
 /// Temporary workaround for https://github.com/ray-project/ray/pull/16402.
 RAY_CONFIG(bool, yield_plasma_lock_workaround, true)
 
@@ -154,6 +201,20 @@ RAY_CONFIG(bool, yield_plasma_lock_workaround, true)
 // See https://github.com/ray-project/ray/issues/16025 for more details.
 RAY_CONFIG(bool, inline_object_status_in_refs, true)
 
+/// The maximum number of objects that a borrower asks their owner about in one
+/// GetObjectStatusBatch RPC. Set to 1 to ask for every object in its own RPC.
+RAY_CONFIG(int64_t, get_object_status_batch_size, 100)
+
+/// How long an owner keeps the statuses of a batch of objects for a borrower that
+/// stopped polling for them, e.g., because the borrower died.
+RAY_CONFIG(int64_t, get_object_status_batch_timeout_ms, 60000)
+
+/// If enabled, the owner of a task's return objects forwards the borrowers that wait
+/// for them to the worker executing the task. That worker pushes the return values
+/// that are small enough to be inlined directly to the borrowers, which saves the
+/// hop through the owner.
+RAY_CONFIG(bool, push_small_returns_to_borrowers, false)
+
 /// Number of times raylet client tries connecting to a raylet.
 RAY_CONFIG(int64_t, raylet_client_num_connect_attempts, 10)
 RAY_CONFIG(int64_t, raylet_client_connect_timeout_milliseconds, 1000)
@@ -171,6 +232,26 @@ RAY_CONFIG(int64_t, kill_worker_timeout_milliseconds, 100)
 /// starting_worker_timeout_callback() is called.
 RAY_CONFIG(int64_t, worker_register_timeout_seconds, 30)
 
+/// Whether to start Python workers by forking them from a pre-initialized template
+/// process (a "fork server") instead of exec'ing a fresh interpreter. One fork server
+/// is kept per runtime env. Workers with dynamic options are never forked. Not
+/// supported on Windows.
+RAY_CONFIG(bool, worker_fork_server_enabled, false)
+
+/// The maximum number of forked worker processes that can be pending registration at
+/// the same time. Forking is much cheaper than starting an interpreter, so this can be
+/// larger than the raylet's maximum startup concurrency.
+RAY_CONFIG(int64_t, worker_fork_server_max_startup_concurrency, 64)
+
+/// The number of spare workers that each fork server keeps forked in the background,
+/// so that starting a worker doesn't wait for the fork. Workers that are started while
+/// there are no spare workers are started from scratch.
+RAY_CONFIG(int64_t, worker_fork_server_num_spare_workers, 4)
+
+/// The timeout of forking a spare worker from a fork server, including connecting to
+/// it. On timeout the raylet falls back to starting worker processes from scratch.
+RAY_CONFIG(int64_t, worker_fork_server_request_timeout_ms, 1000)
+
 /// The maximum number of workers to iterate whenever we analyze the resources usage.
 RAY_CONFIG(uint32_t, worker_max_resource_analysis_iteration, 128);
 
@@ -209,6 +290,35 @@ RAY_CONFIG(uint32_t, maximum_gcs_deletion_batch_size, 1000)
 /// Maximum number of items in one batch to scan/get/delete from GCS storage.
 RAY_CONFIG(uint32_t, maximum_gcs_storage_operation_batch_size, 1000)
 
+/// If not empty, the GCS tables are stored in this local directory instead of Redis, in
+/// a write-ahead log and a snapshot, so that a single node GCS can restart from disk.
+RAY_CONFIG(std::string, gcs_storage_dir, "")
+
+/// The size of the GCS storage log in bytes above which it is compacted into a
+/// snapshot.
+RAY_CONFIG(uint64_t, gcs_storage_compaction_bytes, 64 * 1024 * 1024)
+
+/// If greater than 0, the writes of the GCS tables are buffered for up to this many
+/// milliseconds, so that the writes of a key in that window are coalesced into one and
+/// the buffered keys are written in batches. A batch is also written as soon as it has
+/// `maximum_gcs_storage_operation_batch_size` keys.
+RAY_CONFIG(uint32_t, gcs_storage_write_coalescing_ms, 0)
+
+/// If true, the GCS serves the internal KV from memory and persists it through the
+/// store client of the GCS tables, instead of running every operation on Redis. Keys
+/// that are written to Redis directly, bypassing the GCS, are not visible to the KV.
+RAY_CONFIG(bool, gcs_internal_kv_in_memory, false)
+
+/// The interval at which the GCS snapshots the tables that it loads on restart, so that
+/// a restart reads a single snapshot instead of scanning every table. Every write of
+/// these tables is also logged to the tail of the snapshot. 0 disables it.
+RAY_CONFIG(uint64_t, gcs_init_data_snapshot_interval_ms, 0)
+
+/// A snapshot of the tables is only taken once the tail has at least this many records
+/// per entry of the previous snapshot, so that the cost of reading and serializing
+/// all tables is amortized over the mutations, and an idle GCS takes no snapshots.
+RAY_CONFIG(double, gcs_init_data_snapshot_min_tail_ratio, 0.25)
+
 /// Maximum number of rows in GCS profile table.
 RAY_CONFIG(int32_t, maximum_profile_table_rows_count, 10 * 1000)
 
@@ -220,6 +330,10 @@ RAY_CONFIG(uint32_t, object_store_get_max_ids_to_print_in_warning, 20)
 RAY_CONFIG(uint32_t, gcs_server_rpc_server_thread_num, 1)
 /// Number of threads used by rpc server in gcs server.
 RAY_CONFIG(uint32_t, gcs_server_rpc_client_thread_num, 1)
+/// Number of event loops that drive the managers in gcs server, including the main
+/// one. The main loop drives the actor, node, job, placement group and resource
+/// managers, and the KV, pubsub, worker and stats services are spread over the others.
+RAY_CONFIG(uint32_t, gcs_server_num_event_loops, 1)
 /// Allow up to 5 seconds for connecting to gcs service.
 /// Note: this only takes effect when gcs service is enabled.
 RAY_CONFIG(int64_t, gcs_service_connect_retries, 50)
@@ -236,6 +350,13 @@ RAY_CONFIG(uint32_t, gcs_create_actor_retry_interval_ms, 200)
 RAY_CONFIG(uint64_t, gcs_create_placement_group_retry_min_interval_ms, 100)
 RAY_CONFIG(uint64_t, gcs_create_placement_group_retry_max_interval_ms, 1000)
 RAY_CONFIG(double, gcs_create_placement_group_retry_multiplier, 1.5);
+/// The algorithm that places the bundles of `PACK` and `SPREAD` placement groups on
+/// nodes, one of "greedy", "best_fit_decreasing" and "bounded_search".
+RAY_CONFIG(std::string, gcs_pack_placement_algorithm, "greedy")
+RAY_CONFIG(std::string, gcs_spread_placement_algorithm, "greedy")
+/// The maximum number of bundle placements that the "bounded_search" placement
+/// algorithm tries per placement group.
+RAY_CONFIG(uint64_t, gcs_placement_search_max_steps, 1000)
 /// Maximum number of destroyed actors in GCS server memory cache.
 RAY_CONFIG(uint32_t, maximum_gcs_destroyed_actor_cached_count, 100000)
 /// Maximum number of dead nodes in GCS server memory cache.
@@ -249,6 +370,11 @@ RAY_CONFIG(uint64_t, gcs_max_concurrent_resource_pulls, 100)
 // Feature flag to use grpc instead of redis for resource broadcast.
 // TODO(ekl) broken as of https://github.com/ray-project/ray/issues/16858
 RAY_CONFIG(bool, grpc_based_resource_broadcast, false)
+/// If greater than 0, the GCS sends grpc based resource broadcasts to only this many
+/// raylets, which relay them along a tree to the rest of the cluster, instead of sending
+/// them to every raylet itself. This bounds the outbound bandwidth of the GCS at the
+/// cost of one extra hop of staleness per tree level.
+RAY_CONFIG(uint64_t, resource_broadcast_relay_fanout, 0)
 // Feature flag to enable grpc based pubsub in GCS.
 RAY_CONFIG(bool, gcs_grpc_based_pubsub, false)
 
@@ -307,6 +433,18 @@ RAY_CONFIG(uint32_t, max_tasks_in_flight_per_worker, 1)
 /// Maximum number of pending lease requests per scheduling category
 RAY_CONFIG(uint64_t, max_pending_lease_requests_per_scheduling_category, 1)
 
+/// Whether a worker whose tasks are done may run the queued tasks of another
+/// scheduling category, if their resources fit within the resources granted to its
+/// lease and they depend on the same plasma objects, instead of being returned to
+/// the raylet.
+RAY_CONFIG(bool, reuse_worker_leases_across_scheduling_classes, false)
+
+/// Whether to request a worker lease for a normal task while its arguments are still
+/// being resolved, instead of after they are all available. The lease is requested
+/// for the task's resource shape without its arguments, and is used if all of the
+/// arguments end up inlined.
+RAY_CONFIG(bool, pipeline_task_dependency_resolution, false)
+
 /// Interval to restart dashboard agent after the process exit.
 RAY_CONFIG(uint32_t, agent_restart_interval_ms, 1000)
 
@@ -337,6 +475,26 @@ RAY_CONFIG(uint64_t, kill_idle_workers_interval_ms, 200)
 /// The idle time threshold for an idle worker to be killed.
 RAY_CONFIG(int64_t, idle_worker_killing_time_threshold_ms, 1000)
 
+/// Whether to prestart workers ahead of periodic bursts of tasks. The worker pool
+/// keeps a history of demand bursts per job and runtime env, and if they repeat
+/// periodically, prestarts the expected number of workers before the next burst and
+/// keeps them from being killed as idle until it arrives. Requires
+/// enable_worker_prestart.
+RAY_CONFIG(bool, predictive_worker_prestart_enabled, false)
+
+/// The minimum time without new demand that separates two bursts of tasks.
+RAY_CONFIG(int64_t, predictive_worker_prestart_burst_gap_ms, 10000)
+
+/// The minimum number of observed bursts before bursts are predicted.
+RAY_CONFIG(uint64_t, predictive_worker_prestart_min_bursts, 3)
+
+/// How long before a predicted burst the workers for it are prestarted.
+RAY_CONFIG(int64_t, predictive_worker_prestart_lead_time_ms, 10000)
+
+/// How long after the predicted start of a burst the prestarted workers are kept
+/// from being killed as idle.
+RAY_CONFIG(int64_t, predictive_worker_prestart_keep_warm_ms, 30000)
+
 // The interval where metrics are exported in milliseconds.
 RAY_CONFIG(uint64_t, metrics_report_interval_ms, 10000)
 
@@ -430,6 +588,12 @@ RAY_CONFIG(uint32_t, max_error_msg_size_bytes, 512 * 1024)
 /// If enabled, raylet will report resources only when resources are changed.
 RAY_CONFIG(bool, enable_light_weight_resource_report, true)
 
+/// If enabled, raylets report versioned deltas of their resources, i.e., only the
+/// entries and load shapes that changed since the last report the GCS has, and the GCS
+/// forwards the merged deltas to the other raylets. Receivers that miss a version
+/// resync from the GCS.
+RAY_CONFIG(bool, resource_report_delta_encoding, false)
+
 // The number of seconds to wait for the Raylet to start. This is normally
 // fast, but when RAY_preallocate_plasma_memory=1 is set, it may take some time
 // (a few GB/s) to populate all the pages on Raylet startup.
@@ -449,6 +613,22 @@ RAY_CONFIG(std::string, predefined_unit_instance_resources, "GPU")
 /// When set it to "FPGA", we will treat FPGA as unit_instance.
 RAY_CONFIG(std::string, custom_unit_instance_resources, "")
 
+/// Whether to pin leased workers to dedicated CPU cores. This treats CPU as a
+/// unit_instance resource, maps each CPU instance to a logical CPU (NUMA node by NUMA
+/// node, preferring one hyperthread per physical core), and sets the CPU affinity of
+/// a worker to the CPU instances it is granted if it is granted a whole one. Only
+/// supported on Linux.
+/// Since CPU becomes a unit_instance resource, a request for more than one CPU is
+/// granted as whole instances plus, if it has a fractional part, a share of one more
+/// instance. Such a request may not fit on a node whose free CPU is split across
+/// instances even though the total suffices, so fractional num_cpus above one are best
+/// avoided. The fractional instance is shared with other workers.
+RAY_CONFIG(bool, worker_cpu_pinning_enabled, false)
+
+/// The logical CPUs that workers may be pinned to, e.g., "2-15". If empty, all CPUs
+/// the raylet may run on are used.
+RAY_CONFIG(std::string, worker_cpu_pinning_cpus, "")
+
 // Maximum size of the batches when broadcasting resources to raylet.
 RAY_CONFIG(uint64_t, resource_broadcast_batch_size, 512);
 
@@ -480,6 +660,12 @@ RAY_CONFIG(bool, event_log_reporter_enabled, false)
 /// be passed to other worker until it is registered to GCS.
 RAY_CONFIG(bool, actor_register_async, true)
 
+/// The maximum number of actors that a worker creates with one CreateActors request
+/// to the GCS. The actors whose dependencies are resolved before the worker's event
+/// loop gets to send them are batched. Set to 1 to create every actor with its own
+/// request.
+RAY_CONFIG(int64_t, actor_creation_batch_size, 100)
+
 /// Event severity threshold value
 RAY_CONFIG(std::string, event_level, "warning")
 
@@ -489,6 +675,16 @@ RAY_CONFIG(bool, scheduler_avoid_gpu_nodes, true)
 /// Whether to skip running local GC in runtime env.
 RAY_CONFIG(bool, runtime_env_skip_local_gc, false)
 
+/// The number of task events that each worker keeps in its task event buffer, see
+/// TaskEventBuffer. 0 disables recording them.
+RAY_CONFIG(uint64_t, task_events_buffer_size, 16384)
+
+/// The directory that workers create their task event buffers in, for the raylet or
+/// the dashboard agent to read them. Each raylet creates a subdirectory for its
+/// workers in it, which it removes when it stops. If empty, the buffers are only kept
+/// in the memory of the workers.
+RAY_CONFIG(std::string, task_events_buffer_directory, "/dev/shm")
+
 /// Whether or not use TLS.
 RAY_CONFIG(bool, USE_TLS, false)
 
@@ -0,0 +1,281 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/resource_usage_delta.h"
+
+#include <algorithm>
+#include <map>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+
+namespace ray {
+
+namespace {
+
+using ResourceMap = google::protobuf::Map<std::string, double>;
+
+/// Add the entries of `current` that differ from `base` to `delta`. Entries that are
+/// missing from `current` are added with a value of 0.
+void DiffResourceMap(const ResourceMap &base, const ResourceMap &current,
+                     ResourceMap *delta) {
+  for (const auto &entry : current) {
+    auto it = base.find(entry.first);
+    if (it == base.end() || it->second != entry.second) {
+      (*delta)[entry.first] = entry.second;
+    }
+  }
+  for (const auto &entry : base) {
+    if (current.find(entry.first) == current.end()) {
+      (*delta)[entry.first] = 0;
+    }
+  }
+}
+
+/// Apply the entries of `delta` to `view`. An entry with a value of 0 removes the
+/// resource, unless `keep_zeros` is set because the view is a delta itself.
+bool ApplyResourceMap(const ResourceMap &delta, bool keep_zeros, ResourceMap *view) {
+  bool changed = false;
+  for (const auto &entry : delta) {
+    auto it = view->find(entry.first);
+    if (entry.second == 0 && !keep_zeros) {
+      if (it != view->end()) {
+        view->erase(it);
+        changed = true;
+      }
+    } else if (it == view->end() || it->second != entry.second) {
+      (*view)[entry.first] = entry.second;
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+/// A key that identifies a load shape, independent of the order of its entries.
+std::string ShapeKey(const rpc::ResourceDemand &demand) {
+  std::map<std::string, double> shape(demand.shape().begin(), demand.shape().end());
+  std::string key;
+  for (const auto &entry : shape) {
+    absl::StrAppend(&key, entry.first, ":", entry.second, ",");
+  }
+  return key;
+}
+
+bool SameDemand(const rpc::ResourceDemand &a, const rpc::ResourceDemand &b) {
+  return a.num_ready_requests_queued() == b.num_ready_requests_queued() &&
+         a.num_infeasible_requests_queued() == b.num_infeasible_requests_queued() &&
+         a.backlog_size() == b.backlog_size();
+}
+
+bool IsEmptyDemand(const rpc::ResourceDemand &demand) {
+  return demand.num_ready_requests_queued() == 0 &&
+         demand.num_infeasible_requests_queued() == 0 && demand.backlog_size() == 0;
+}
+
+/// Add the load shapes of `current` that differ from `base` to `delta`. Shapes that are
+/// missing from `current` are added with zero counts.
+void DiffResourceLoad(const rpc::ResourceLoad &base, const rpc::ResourceLoad &current,
+                      rpc::ResourceLoad *delta) {
+  absl::flat_hash_map<std::string, const rpc::ResourceDemand *> base_demands;
+  for (const auto &demand : base.resource_demands()) {
+    base_demands[ShapeKey(demand)] = &demand;
+  }
+  for (const auto &demand : current.resource_demands()) {
+    auto it = base_demands.find(ShapeKey(demand));
+    if (it == base_demands.end() || !SameDemand(*it->second, demand)) {
+      delta->add_resource_demands()->CopyFrom(demand);
+    }
+    if (it != base_demands.end()) {
+      base_demands.erase(it);
+    }
+  }
+  for (const auto &demand : base.resource_demands()) {
+    if (base_demands.contains(ShapeKey(demand))) {
+      *delta->add_resource_demands()->mutable_shape() = demand.shape();
+    }
+  }
+}
+
+/// Apply the load shapes of `delta` to `view`. A shape with zero counts is removed,
+/// unless `keep_zeros` is set because the view is a delta itself.
+bool ApplyResourceLoad(const rpc::ResourceLoad &delta, bool keep_zeros,
+                       rpc::ResourceLoad *view) {
+  if (delta.resource_demands_size() == 0) {
+    return false;
+  }
+  absl::flat_hash_map<std::string, int> index;
+  for (int i = 0; i < view->resource_demands_size(); i++) {
+    index[ShapeKey(view->resource_demands(i))] = i;
+  }
+  bool changed = false;
+  std::vector<bool> removed(view->resource_demands_size(), false);
+  for (const auto &demand : delta.resource_demands()) {
+    auto it = index.find(ShapeKey(demand));
+    if (IsEmptyDemand(demand) && !keep_zeros) {
+      if (it != index.end() && !removed[it->second]) {
+        removed[it->second] = true;
+        changed = true;
+      }
+    } else if (it == index.end()) {
+      view->add_resource_demands()->CopyFrom(demand);
+      removed.push_back(false);
+      changed = true;
+    } else if (removed[it->second] ||
+               !SameDemand(view->resource_demands(it->second), demand)) {
+      view->mutable_resource_demands(it->second)->CopyFrom(demand);
+      removed[it->second] = false;
+      changed = true;
+    }
+  }
+  if (std::find(removed.begin(), removed.end(), true) != removed.end()) {
+    rpc::ResourceLoad remaining;
+    for (int i = 0; i < view->resource_demands_size(); i++) {
+      if (!removed[i]) {
+        remaining.add_resource_demands()->Swap(view->mutable_resource_demands(i));
+      }
+    }
+    view->Swap(&remaining);
+  }
+  return changed;
+}
+
+}  // namespace
+
+bool ComputeResourceUsageDelta(const rpc::ResourcesData &base,
+                               const rpc::ResourcesData &current,
+                               rpc::ResourcesData *delta) {
+  delta->Clear();
+  delta->set_node_id(current.node_id());
+  delta->set_is_delta(true);
+  delta->set_base_version(base.version());
+
+  DiffResourceMap(base.resources_available(), current.resources_available(),
+                  delta->mutable_resources_available());
+  for (const auto &entry : current.resources_total()) {
+    auto it = base.resources_total().find(entry.first);
+    if (it == base.resources_total().end() || it->second != entry.second) {
+      (*delta->mutable_resources_total())[entry.first] = entry.second;
+    }
+  }
+  for (const auto &entry : base.resources_total()) {
+    if (current.resources_total().find(entry.first) == current.resources_total().end()) {
+      delta->add_deleted_resources(entry.first);
+    }
+  }
+  DiffResourceMap(base.resource_load(), current.resource_load(),
+                  delta->mutable_resource_load());
+  DiffResourceMap(base.resources_normal_task(), current.resources_normal_task(),
+                  delta->mutable_resources_normal_task());
+  DiffResourceLoad(base.resource_load_by_shape(), current.resource_load_by_shape(),
+                   delta->mutable_resource_load_by_shape());
+
+  delta->set_resources_available_changed(delta->resources_available_size() > 0 ||
+                                         delta->deleted_resources_size() > 0);
+  delta->set_resource_load_changed(
+      delta->resource_load_size() > 0 ||
+      delta->resource_load_by_shape().resource_demands_size() > 0);
+  delta->set_resources_normal_task_changed(current.resources_normal_task_changed());
+  delta->set_resources_normal_task_timestamp(current.resources_normal_task_timestamp());
+  delta->set_should_global_gc(current.should_global_gc());
+  delta->set_object_pulls_queued(current.object_pulls_queued());
+  delta->set_cluster_full_of_actors_detected(current.cluster_full_of_actors_detected());
+  if (current.node_manager_address() != base.node_manager_address()) {
+    delta->set_node_manager_address(current.node_manager_address());
+  }
+
+  bool changed = delta->resources_available_changed() ||
+                 delta->resources_total_size() > 0 || delta->resource_load_changed() ||
+                 delta->resources_normal_task_size() > 0 ||
+                 delta->resources_normal_task_changed() || delta->should_global_gc() ||
+                 current.object_pulls_queued() != base.object_pulls_queued() ||
+                 current.cluster_full_of_actors_detected() !=
+                     base.cluster_full_of_actors_detected() ||
+                 !delta->node_manager_address().empty();
+  delta->set_version(changed ? current.version() : base.version());
+  return changed;
+}
+
+bool ApplyResourceUsageDelta(const rpc::ResourcesData &report, rpc::ResourcesData *view) {
+  if (!report.is_delta()) {
+    // A global GC request that hasn't been forwarded yet must not be lost.
+    bool should_global_gc =
+        report.should_global_gc() || (view->is_delta() && view->should_global_gc());
+    view->CopyFrom(report);
+    view->set_should_global_gc(should_global_gc);
+    return true;
+  }
+
+  const bool keep_zeros = view->is_delta();
+  bool changed = ApplyResourceMap(report.resources_available(), keep_zeros,
+                                  view->mutable_resources_available());
+  for (const auto &entry : report.resources_total()) {
+    auto it = view->resources_total().find(entry.first);
+    if (it == view->resources_total().end() || it->second != entry.second) {
+      (*view->mutable_resources_total())[entry.first] = entry.second;
+      changed = true;
+    }
+  }
+  if (keep_zeros && report.resources_total_size() > 0) {
+    // Resources that are added back are no longer deleted.
+    auto deleted = view->mutable_deleted_resources();
+    deleted->erase(std::remove_if(deleted->begin(), deleted->end(),
+                                  [&report](const std::string &label) {
+                                    return report.resources_total().count(label) > 0;
+                                  }),
+                   deleted->end());
+  }
+  for (const auto &label : report.deleted_resources()) {
+    changed |= view->mutable_resources_total()->erase(label) > 0;
+    changed |= view->mutable_resources_available()->erase(label) > 0;
+    if (keep_zeros && std::find(view->deleted_resources().begin(),
+                                view->deleted_resources().end(),
+                                label) == view->deleted_resources().end()) {
+      view->add_deleted_resources(label);
+    }
+  }
+  changed |= ApplyResourceMap(report.resource_load(), keep_zeros,
+                              view->mutable_resource_load());
+  changed |= ApplyResourceMap(report.resources_normal_task(), keep_zeros,
+                              view->mutable_resources_normal_task());
+  changed |= ApplyResourceLoad(report.resource_load_by_shape(), keep_zeros,
+                               view->mutable_resource_load_by_shape());
+
+  changed |= report.should_global_gc() || report.resources_normal_task_changed() ||
+             report.object_pulls_queued() != view->object_pulls_queued() ||
+             report.cluster_full_of_actors_detected() !=
+                 view->cluster_full_of_actors_detected();
+  // Flags of a full view describe the last report, and flags of a delta accumulate.
+  view->set_resources_available_changed(
+      report.resources_available_changed() ||
+      (keep_zeros && view->resources_available_changed()));
+  view->set_resource_load_changed(report.resource_load_changed() ||
+                                  (keep_zeros && view->resource_load_changed()));
+  view->set_should_global_gc(report.should_global_gc() ||
+                             (keep_zeros && view->should_global_gc()));
+  if (report.resources_normal_task_changed()) {
+    view->set_resources_normal_task_changed(true);
+    view->set_resources_normal_task_timestamp(report.resources_normal_task_timestamp());
+  } else if (!keep_zeros) {
+    view->set_resources_normal_task_changed(false);
+  }
+  view->set_object_pulls_queued(report.object_pulls_queued());
+  view->set_cluster_full_of_actors_detected(report.cluster_full_of_actors_detected());
+  if (!report.node_manager_address().empty()) {
+    view->set_node_manager_address(report.node_manager_address());
+  }
+  view->set_version(report.version());
+  return changed;
+}
+
+}  // namespace ray
@@ -0,0 +1,43 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "src/ray/protobuf/gcs.pb.h"
+
+namespace ray {
+
+/// Compute the delta between two full resource reports of a node, see the `is_delta`
+/// field of `rpc::ResourcesData`.
+///
+/// \param base The last report that the receiver has.
+/// \param current The new report.
+/// \param[out] delta The delta from `base` to `current`. If nothing changed, this is an
+/// empty delta with the version of `base`, otherwise it has the version of `current`.
+/// \return Whether anything changed.
+bool ComputeResourceUsageDelta(const rpc::ResourcesData &base,
+                               const rpc::ResourcesData &current,
+                               rpc::ResourcesData *delta);
+
+/// Apply a resource report to the view of a node. A full report replaces the view,
+/// and a delta must be on top of the version of the view. If the view is a delta
+/// itself, e.g., one that hasn't been forwarded yet, the result is a delta that is
+/// equivalent to applying both deltas in order.
+///
+/// \param report A full report or a delta.
+/// \param[in,out] view The view of the node to update.
+/// \return Whether the view changed.
+bool ApplyResourceUsageDelta(const rpc::ResourcesData &report, rpc::ResourcesData *view);
+
+}  // namespace ray
@@ -0,0 +1,344 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/task/task_event_buffer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "absl/strings/str_cat.h"
+#include "nlohmann/json.hpp"
+#include "ray/util/logging.h"
+
+using json = nlohmann::json;
+
+namespace ray {
+
+namespace {
+
+const char *const kTaskEventTypeNames[] = {
+    "task:submitted",          "task:received", "task:execution_started",
+    "task:execution_finished", "task:finished",
+};
+static_assert(sizeof(kTaskEventTypeNames) / sizeof(kTaskEventTypeNames[0]) ==
+                  static_cast<size_t>(TaskEventType::NUM_TYPES),
+              "Every task event type needs a name");
+
+size_t BufferSize(uint64_t capacity) {
+  return sizeof(TaskEventBufferHeader) + capacity * sizeof(TaskEventRecord);
+}
+
+Status ReadTaskEventsFromBuffer(const TaskEventBufferHeader &header, size_t size,
+                                WorkerID *worker_id, std::vector<TaskEvent> *events) {
+  const uint64_t capacity = header.capacity;
+  if (header.magic != TaskEventBufferHeader::kMagic ||
+      header.version != TaskEventBufferHeader::kVersion || capacity == 0 ||
+      (capacity & (capacity - 1)) != 0 || BufferSize(capacity) > size) {
+    return Status::Invalid("Not a task event buffer.");
+  }
+  *worker_id = WorkerID::FromBinary(
+      std::string(reinterpret_cast<const char *>(header.worker_id), WorkerID::Size()));
+
+  const auto *records = reinterpret_cast<const TaskEventRecord *>(&header + 1);
+  const uint64_t end = header.next_index.load(std::memory_order_acquire);
+  const uint64_t begin = end > capacity ? end - capacity : 0;
+  std::vector<uint64_t> event_types;
+  events->clear();
+  events->reserve(end - begin);
+  event_types.reserve(end - begin);
+  for (uint64_t index = begin; index < end; index++) {
+    const auto &record = records[index & (capacity - 1)];
+    const uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * index + 2) {
+      // The event is still being written, or was already overwritten.
+      continue;
+    }
+    TaskEvent event;
+    event.index = index;
+    event.timestamp_ns = record.timestamp_ns.load(std::memory_order_relaxed);
+    const uint64_t event_type = record.event_type.load(std::memory_order_relaxed);
+    uint64_t task_id[3];
+    for (size_t i = 0; i < 3; i++) {
+      task_id[i] = record.task_id[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (record.sequence.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+    event.task_id = TaskID::FromBinary(
+        std::string(reinterpret_cast<const char *>(task_id), sizeof(task_id)));
+    events->push_back(std::move(event));
+    event_types.push_back(event_type);
+  }
+
+  // Event types are interned before they are recorded, so read their names last.
+  const uint32_t num_event_types =
+      std::min<uint32_t>(header.num_event_types.load(std::memory_order_acquire),
+                         TaskEventBufferHeader::kMaxEventTypes);
+  for (size_t i = 0; i < events->size(); i++) {
+    if (event_types[i] < num_event_types) {
+      const char *name = header.event_types[event_types[i]];
+      (*events)[i].event_type =
+          std::string(name, strnlen(name, TaskEventBufferHeader::kMaxEventTypeLength));
+    } else {
+      (*events)[i].event_type = "unknown";
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+TaskEventBuffer::TaskEventBuffer(const WorkerID &worker_id, const std::string &directory,
+                                 size_t capacity) {
+  uint32_t rounded_capacity = 1;
+  while (rounded_capacity < capacity && rounded_capacity < (1u << 31)) {
+    rounded_capacity <<= 1;
+  }
+  mapping_size_ = BufferSize(rounded_capacity);
+#ifndef _WIN32
+  if (!directory.empty()) {
+    const std::string path = GetPath(directory, worker_id);
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0 && ftruncate(fd, static_cast<off_t>(mapping_size_)) == 0) {
+      void *mapping =
+          mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (mapping != MAP_FAILED) {
+        mapping_ = mapping;
+        path_ = path;
+      }
+    }
+    if (mapping_ == nullptr) {
+      RAY_LOG(WARNING) << "Failed to create the task event buffer " << path
+                       << ", error: " << std::strerror(errno)
+                       << ". Task events are only kept in the memory of the worker.";
+      if (fd >= 0) {
+        unlink(path.c_str());
+      }
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+  if (mapping_ == nullptr) {
+    mapping_ = ::operator new(mapping_size_);
+    std::memset(mapping_, 0, mapping_size_);
+  }
+  Initialize(worker_id, rounded_capacity);
+}
+
+TaskEventBuffer::~TaskEventBuffer() {
+#ifndef _WIN32
+  if (!path_.empty()) {
+    munmap(mapping_, mapping_size_);
+    unlink(path_.c_str());
+    return;
+  }
+#endif
+  ::operator delete(mapping_);
+}
+
+void TaskEventBuffer::Initialize(const WorkerID &worker_id, uint32_t capacity) {
+  header_ = new (mapping_) TaskEventBufferHeader();
+  records_ = reinterpret_cast<TaskEventRecord *>(header_ + 1);
+  mask_ = capacity - 1;
+  header_->version = TaskEventBufferHeader::kVersion;
+  header_->capacity = capacity;
+  std::memcpy(header_->worker_id, worker_id.Data(), WorkerID::Size());
+  for (const char *name : kTaskEventTypeNames) {
+    RAY_CHECK(InternEventType(name) >= 0);
+  }
+  // Readers check the magic number last.
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = TaskEventBufferHeader::kMagic;
+}
+
+std::string TaskEventBuffer::GetNodeDirectory(const std::string &base_directory,
+                                              const NodeID &node_id) {
+  return absl::StrCat(base_directory, "/ray_task_events_", node_id.Hex());
+}
+
+std::string TaskEventBuffer::GetPath(const std::string &directory,
+                                     const WorkerID &worker_id) {
+  return absl::StrCat(directory, "/ray_task_events_", worker_id.Hex());
+}
+
+int64_t TaskEventBuffer::InternEventType(const std::string &name) {
+  absl::MutexLock lock(&mu_);
+  auto it = event_type_ids_.find(name);
+  if (it != event_type_ids_.end()) {
+    return it->second;
+  }
+  const uint32_t id = header_->num_event_types.load(std::memory_order_relaxed);
+  if (id >= TaskEventBufferHeader::kMaxEventTypes) {
+    return -1;
+  }
+  char *slot = header_->event_types[id];
+  const size_t length =
+      std::min(name.size(), TaskEventBufferHeader::kMaxEventTypeLength - 1);
+  std::memcpy(slot, name.data(), length);
+  slot[length] = '\0';
+  header_->num_event_types.store(id + 1, std::memory_order_release);
+  event_type_ids_.emplace(name, id);
+  return id;
+}
+
+void TaskEventBuffer::Record(uint32_t event_type, const TaskID &task_id) {
+  // Reading the clock is most of the cost of recording an event.
+  const int64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+  uint64_t task_id_words[3];
+  std::memcpy(task_id_words, task_id.Data(), sizeof(task_id_words));
+  const uint64_t index = header_->next_index.fetch_add(1, std::memory_order_relaxed);
+  auto &record = records_[index & mask_];
+  // Mark the record as being written before any of its fields change.
+  record.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  record.timestamp_ns.store(timestamp_ns, std::memory_order_relaxed);
+  record.event_type.store(event_type, std::memory_order_relaxed);
+  for (size_t i = 0; i < 3; i++) {
+    record.task_id[i].store(task_id_words[i], std::memory_order_relaxed);
+  }
+  record.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+Status ReadTaskEvents(const std::string &path, WorkerID *worker_id,
+                      std::vector<TaskEvent> *events) {
+#ifdef _WIN32
+  return Status::NotImplemented("Task event buffers aren't shared on Windows.");
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return Status::IOError(
+        absl::StrCat("Failed to open ", path, ", error: ", std::strerror(errno)));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(TaskEventBufferHeader)) {
+    close(fd);
+    return Status::Invalid(absl::StrCat(path, " is not a task event buffer."));
+  }
+  const size_t size = file_stat.st_size;
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return Status::IOError(
+        absl::StrCat("Failed to map ", path, ", error: ", std::strerror(errno)));
+  }
+  auto status = ReadTaskEventsFromBuffer(
+      *static_cast<const TaskEventBufferHeader *>(mapping), size, worker_id, events);
+  munmap(mapping, size);
+  return status;
+#endif
+}
+
+namespace {
+
+/// Append task events to a trace in the Chrome trace format, see
+/// TaskEventsToChromeTrace.
+void AppendChromeTrace(const WorkerID &worker_id, const std::vector<TaskEvent> &events,
+                       json *trace) {
+  const std::string pid = absl::StrCat("worker:", worker_id.Hex());
+  auto add_event = [trace, &pid](const TaskEvent &event, const TaskEvent *next) {
+    json entry = {{"cat", "task"},
+                  {"name", event.event_type},
+                  {"pid", pid},
+                  {"tid", event.task_id.Hex()},
+                  {"ts", event.timestamp_ns / 1000.0}};
+    if (next != nullptr) {
+      entry["ph"] = "X";
+      entry["dur"] = (next->timestamp_ns - event.timestamp_ns) / 1000.0;
+    } else {
+      // The last event of a task is an instant.
+      entry["ph"] = "i";
+      entry["s"] = "t";
+    }
+    trace->push_back(std::move(entry));
+  };
+
+  absl::flat_hash_map<TaskID, size_t> last_event_of_task;
+  for (size_t i = 0; i < events.size(); i++) {
+    auto it = last_event_of_task.find(events[i].task_id);
+    if (it == last_event_of_task.end()) {
+      last_event_of_task.emplace(events[i].task_id, i);
+    } else {
+      add_event(events[it->second], &events[i]);
+      it->second = i;
+    }
+  }
+  std::vector<size_t> last_events;
+  for (const auto &task_and_event : last_event_of_task) {
+    last_events.push_back(task_and_event.second);
+  }
+  std::sort(last_events.begin(), last_events.end());
+  for (size_t i : last_events) {
+    add_event(events[i], nullptr);
+  }
+}
+
+}  // namespace
+
+std::string TaskEventsToChromeTrace(const WorkerID &worker_id,
+                                    const std::vector<TaskEvent> &events) {
+  json trace = json::array();
+  AppendChromeTrace(worker_id, events, &trace);
+  return trace.dump();
+}
+
+Status ReadTaskEventsTrace(const std::string &directory, std::string *trace) {
+#ifdef _WIN32
+  return Status::NotImplemented("Task event buffers aren't shared on Windows.");
+#else
+  DIR *dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    return Status::IOError(
+        absl::StrCat("Failed to open ", directory, ", error: ", std::strerror(errno)));
+  }
+  json merged_trace = json::array();
+  while (const dirent *entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    const std::string path = absl::StrCat(directory, "/", name);
+    WorkerID worker_id;
+    std::vector<TaskEvent> events;
+    auto status = ReadTaskEvents(path, &worker_id, &events);
+    if (!status.ok()) {
+      // The worker may have exited, or may not have initialized its buffer yet.
+      RAY_LOG(DEBUG) << "Skipping task event buffer " << path << ": " << status;
+      continue;
+    }
+    AppendChromeTrace(worker_id, events, &merged_trace);
+  }
+  closedir(dir);
+  *trace = merged_trace.dump();
+  return Status::OK();
+#endif
+}
+
+}  // namespace ray
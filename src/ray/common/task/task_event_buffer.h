@@ -0,0 +1,189 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/id.h"
+#include "ray/common/status.h"
+
+namespace ray {
+
+/// Task state transitions that a worker records. The values are the ids that the names
+/// of these event types are interned with in every buffer.
+enum class TaskEventType : uint32_t {
+  /// The owner submitted the task.
+  SUBMITTED = 0,
+  /// The executor received the task. It may then wait behind earlier tasks and for its
+  /// arguments before its execution starts.
+  RECEIVED = 1,
+  /// The executor started to run the task's function.
+  EXECUTION_STARTED = 2,
+  /// The task's function returned.
+  EXECUTION_FINISHED = 3,
+  /// The executor released the task's arguments and is about to reply.
+  FINISHED = 4,
+  NUM_TYPES = 5,
+};
+
+/// The layout of a task event buffer, which is a file that is mapped by the worker that
+/// records the events and by the processes that read them. The file starts with a
+/// TaskEventBufferHeader, followed by `capacity` TaskEventRecords.
+struct TaskEventBufferHeader {
+  static constexpr uint64_t kMagic = 0x5241595441534b45;  // "RAYTASKE"
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kMaxEventTypes = 256;
+  static constexpr size_t kMaxEventTypeLength = 64;
+
+  uint64_t magic;
+  uint32_t version;
+  /// The number of records, a power of two.
+  uint32_t capacity;
+  /// The index of the next event. The event with index i is stored in record
+  /// i % capacity, so the buffer holds the last `capacity` events.
+  std::atomic<uint64_t> next_index;
+  /// The number of interned event types. Their names are published before this is
+  /// incremented.
+  std::atomic<uint32_t> num_event_types;
+  uint8_t worker_id[kUniqueIDSize];
+  char event_types[kMaxEventTypes][kMaxEventTypeLength];
+};
+
+/// A recorded event. The fields are atomics so that an event can be read while it is
+/// overwritten by the next lap through the buffer, which readers detect from the
+/// sequence number.
+struct TaskEventRecord {
+  /// 2 * index + 1 while the event with the given index is written, and 2 * index + 2
+  /// once it's complete.
+  std::atomic<uint64_t> sequence;
+  std::atomic<int64_t> timestamp_ns;
+  std::atomic<uint64_t> event_type;
+  std::atomic<uint64_t> task_id[3];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Task event buffers need lock free atomics to be shared across processes");
+static_assert(sizeof(TaskEventRecord::task_id) == TaskID::Size(),
+              "Task ids must fit into a task event record");
+
+/// A fixed size ring buffer of the task events of a worker, in shared memory so that
+/// the raylet or the dashboard agent can read them on demand, see ReadTaskEvents and
+/// ReadTaskEventsTrace. Recording an event takes no locks and doesn't allocate, so it
+/// can be left on.
+class TaskEventBuffer {
+ public:
+  /// Create a buffer in a new file, which is removed when the buffer is destroyed.
+  ///
+  /// \param worker_id The worker that records the events.
+  /// \param directory The directory to create the file in, see GetNodeDirectory and
+  /// GetPath. If it's empty or the file can't be created, the buffer is only kept in
+  /// the memory of this process.
+  /// \param capacity The number of events to keep, rounded up to a power of two.
+  TaskEventBuffer(const WorkerID &worker_id, const std::string &directory,
+                  size_t capacity);
+
+  ~TaskEventBuffer();
+
+  TaskEventBuffer(const TaskEventBuffer &) = delete;
+  TaskEventBuffer &operator=(const TaskEventBuffer &) = delete;
+
+  /// The directory that the workers of a raylet create their buffers in. It's created
+  /// by the raylet and removed with all buffers in it when the raylet stops, so that
+  /// buffers don't outlive their session.
+  ///
+  /// \param base_directory The `task_events_buffer_directory` config, e.g., /dev/shm.
+  /// \param node_id The raylet of the workers.
+  static std::string GetNodeDirectory(const std::string &base_directory,
+                                      const NodeID &node_id);
+
+  /// The path of the buffer of a worker.
+  static std::string GetPath(const std::string &directory, const WorkerID &worker_id);
+
+  /// Intern the name of an event type that isn't a TaskEventType, e.g., one of the
+  /// profile events of a language frontend. Names longer than the header allows are
+  /// truncated.
+  ///
+  /// \param name The name of the event type.
+  /// \return The id to record events of this type with, or -1 if the header is full.
+  int64_t InternEventType(const std::string &name) LOCKS_EXCLUDED(mu_);
+
+  /// Record an event with the current time. This is safe to call from any thread.
+  void Record(TaskEventType event_type, const TaskID &task_id) {
+    Record(static_cast<uint32_t>(event_type), task_id);
+  }
+  void Record(uint32_t event_type, const TaskID &task_id);
+
+  /// The path of the file of this buffer, or empty if it's only kept in memory.
+  const std::string &Path() const { return path_; }
+
+ private:
+  /// Initialize the header, and intern the names of the TaskEventTypes.
+  void Initialize(const WorkerID &worker_id, uint32_t capacity);
+
+  std::string path_;
+  void *mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  TaskEventBufferHeader *header_ = nullptr;
+  TaskEventRecord *records_ = nullptr;
+  uint64_t mask_ = 0;
+
+  /// Serializes the interning of event types.
+  absl::Mutex mu_;
+  absl::flat_hash_map<std::string, uint32_t> event_type_ids_ GUARDED_BY(mu_);
+};
+
+/// An event read from a task event buffer.
+struct TaskEvent {
+  uint64_t index;
+  int64_t timestamp_ns;
+  std::string event_type;
+  TaskID task_id;
+};
+
+/// Read the events of a task event buffer, oldest first. Events that are overwritten
+/// while they are read are skipped.
+///
+/// \param path The path of the buffer, see TaskEventBuffer::GetPath.
+/// \param[out] worker_id The worker that recorded the events.
+/// \param[out] events The events that are in the buffer.
+/// \return Status::IOError if the file can't be mapped, or Status::Invalid if it isn't
+/// a task event buffer.
+Status ReadTaskEvents(const std::string &path, WorkerID *worker_id,
+                      std::vector<TaskEvent> *events);
+
+/// Export task events in the Chrome trace format. Each task is shown as a row of spans
+/// from one of its events to the next, named after the event that starts them.
+///
+/// \param worker_id The worker that recorded the events.
+/// \param events The events, oldest first.
+/// \return The trace as a JSON array.
+std::string TaskEventsToChromeTrace(const WorkerID &worker_id,
+                                    const std::vector<TaskEvent> &events);
+
+/// Read the buffers of all workers in a directory, and export their events as one
+/// trace in the Chrome trace format, see TaskEventsToChromeTrace. Files that aren't
+/// readable task event buffers, e.g., of workers that just exited, are skipped.
+///
+/// \param directory The directory of the buffers, see TaskEventBuffer::GetNodeDirectory.
+/// \param[out] trace The trace as a JSON array.
+/// \return Status::IOError if the directory can't be listed.
+Status ReadTaskEventsTrace(const std::string &directory, std::string *trace);
+
+}  // namespace ray
@@ -260,6 +260,10 @@ bool TaskSpecification::IsActorTask() const {
   return message_->type() == TaskType::ACTOR_TASK;
 }
 
+bool TaskSpecification::IsStreamingGenerator() const {
+  return message_->streaming_generator();
+}
+
 // === Below are getter methods specific to actor creation tasks.
 
 ActorID TaskSpecification::ActorCreationId() const {
@@ -95,6 +95,19 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
     ComputeResources();
   }
 
+  /// Construct from a protobuf message shared_ptr, reusing the resources and the
+  /// scheduling class of a template instead of computing them again. The message must
+  /// have the same resources as the template, e.g., because it was copied from it.
+  ///
+  /// \param message The protobuf message.
+  /// \param spec_template The task spec that the message was built from.
+  TaskSpecification(std::shared_ptr<rpc::TaskSpec> message,
+                    const TaskSpecification &spec_template)
+      : MessageWrapper(message),
+        required_resources_(spec_template.required_resources_),
+        required_placement_resources_(spec_template.required_placement_resources_),
+        sched_cls_id_(spec_template.sched_cls_id_) {}
+
   /// Construct from protobuf-serialized binary.
   ///
   /// \param serialized_binary Protobuf-serialized binary.
@@ -202,6 +215,10 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   /// Whether this task is an actor task.
   bool IsActorTask() const;
 
+  /// Whether this task streams its return values, see `streaming_generator` in
+  /// `common.proto`.
+  bool IsStreamingGenerator() const;
+
   // Methods specific to actor creation tasks.
 
   ActorID ActorCreationId() const;
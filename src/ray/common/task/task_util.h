@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "ray/common/buffer.h"
 #include "ray/common/ray_object.h"
 #include "ray/common/task/task_spec.h"
@@ -86,8 +88,23 @@ class TaskSpecBuilder {
  public:
   TaskSpecBuilder() : message_(std::make_shared<rpc::TaskSpec>()) {}
 
+  /// Start from a copy of a template, see `TaskSpecTemplateCache`. Only the fields that
+  /// differ per call, i.e., those set by `SetCallSpecificFields`, `AddArg` and
+  /// `SetActorTaskSpec`, should be set on the builder.
+  ///
+  /// \param spec_template The template to copy.
+  explicit TaskSpecBuilder(std::shared_ptr<const TaskSpecification> spec_template)
+      : message_(std::make_shared<rpc::TaskSpec>(spec_template->GetMessage())),
+        spec_template_(std::move(spec_template)) {}
+
   /// Build the `TaskSpecification` object.
-  TaskSpecification Build() { return TaskSpecification(message_); }
+  TaskSpecification Build() {
+    if (spec_template_ != nullptr) {
+      // The resources are the same as the template's, so don't compute them again.
+      return TaskSpecification(message_, *spec_template_);
+    }
+    return TaskSpecification(message_);
+  }
 
   /// Get a reference to the internal protobuf message object.
   const rpc::TaskSpec &GetMessage() const { return *message_; }
@@ -136,9 +153,26 @@ class TaskSpecBuilder {
     return *this;
   }
 
-  TaskSpecBuilder &SetNormalTaskSpec(int max_retries, bool retry_exceptions) {
+  /// Set the fields of the common task spec that differ between calls to the same
+  /// function. See `common.proto` for meaning of the arguments.
+  ///
+  /// \return Reference to the builder object itself.
+  TaskSpecBuilder &SetCallSpecificFields(const TaskID &task_id,
+                                         const TaskID &parent_task_id,
+                                         uint64_t parent_counter,
+                                         const TaskID &caller_id) {
+    message_->set_task_id(task_id.Binary());
+    message_->set_parent_task_id(parent_task_id.Binary());
+    message_->set_parent_counter(parent_counter);
+    message_->set_caller_id(caller_id.Binary());
+    return *this;
+  }
+
+  TaskSpecBuilder &SetNormalTaskSpec(int max_retries, bool retry_exceptions,
+                                     bool streaming_generator = false) {
     message_->set_max_retries(max_retries);
     message_->set_retry_exceptions(retry_exceptions);
+    message_->set_streaming_generator(streaming_generator);
     return *this;
   }
 
@@ -230,6 +264,72 @@ class TaskSpecBuilder {
 
  private:
   std::shared_ptr<rpc::TaskSpec> message_;
+  /// The template the message was copied from, if any.
+  std::shared_ptr<const TaskSpecification> spec_template_;
+};
+
+/// A cache of task spec templates, i.e., task specs without the fields that differ
+/// between calls, keyed by everything else that the caller sets on the spec. Repeated
+/// calls to the same function or actor method then only copy the template and fill in
+/// the task ID, counters and arguments, instead of building the spec field by field and
+/// computing its resources and scheduling class again. This class is thread safe.
+class TaskSpecTemplateCache {
+ public:
+  /// \param max_size The maximum number of templates to keep. 0 disables the cache.
+  explicit TaskSpecTemplateCache(size_t max_size) : max_size_(max_size) {}
+
+  /// Whether templates are cached at all.
+  bool Enabled() const { return max_size_ > 0; }
+
+  /// Get the template for a key.
+  ///
+  /// \param key The key of the template.
+  /// \return The template, or nullptr if there is none.
+  std::shared_ptr<const TaskSpecification> Get(const std::string &key) const {
+    absl::MutexLock lock(&mutex_);
+    auto it = templates_.find(key);
+    return it == templates_.end() ? nullptr : it->second;
+  }
+
+  /// Add the template of a task spec that was built for a key. The task ID, counters,
+  /// caller and arguments of the spec are cleared in the template.
+  ///
+  /// \param key The key of the template.
+  /// \param spec A task spec that was built for the key.
+  void Put(const std::string &key, const TaskSpecification &spec) {
+    if (!Enabled()) {
+      return;
+    }
+    auto message = std::make_shared<rpc::TaskSpec>(spec.GetMessage());
+    message->clear_task_id();
+    message->clear_parent_task_id();
+    message->clear_parent_counter();
+    message->clear_caller_id();
+    message->clear_args();
+    if (message->has_actor_task_spec()) {
+      message->mutable_actor_task_spec()->clear_previous_actor_task_dummy_object_id();
+      message->mutable_actor_task_spec()->clear_actor_counter();
+    }
+    auto spec_template = std::make_shared<const TaskSpecification>(message, spec);
+    absl::MutexLock lock(&mutex_);
+    if (templates_.size() >= max_size_) {
+      // Templates are cheap to rebuild, so start over instead of tracking usage.
+      templates_.clear();
+    }
+    templates_[key] = std::move(spec_template);
+  }
+
+  /// The number of cached templates.
+  size_t Size() const {
+    absl::MutexLock lock(&mutex_);
+    return templates_.size();
+  }
+
+ private:
+  const size_t max_size_;
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::shared_ptr<const TaskSpecification>> templates_
+      GUARDED_BY(mutex_);
 };
 
 }  // namespace ray
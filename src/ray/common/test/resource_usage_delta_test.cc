@@ -0,0 +1,190 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/resource_usage_delta.h"
+
+#include <map>
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace {
+
+rpc::ResourcesData MakeReport(int64_t version, int num_custom_resources,
+                              int num_shapes) {
+  rpc::ResourcesData report;
+  report.set_node_id("node");
+  report.set_version(version);
+  (*report.mutable_resources_total())["CPU"] = 64;
+  (*report.mutable_resources_available())["CPU"] = 32;
+  (*report.mutable_resources_total())["memory"] = 256.0 * 1024 * 1024 * 1024;
+  (*report.mutable_resources_available())["memory"] = 128.0 * 1024 * 1024 * 1024;
+  for (int i = 0; i < num_custom_resources; i++) {
+    (*report.mutable_resources_total())[absl::StrCat("custom_", i)] = 1;
+    (*report.mutable_resources_available())[absl::StrCat("custom_", i)] = 1;
+  }
+  for (int i = 0; i < num_shapes; i++) {
+    auto demand = report.mutable_resource_load_by_shape()->add_resource_demands();
+    (*demand->mutable_shape())["CPU"] = i + 1;
+    demand->set_num_ready_requests_queued(10);
+    demand->set_backlog_size(100);
+    (*report.mutable_resource_load())["CPU"] += (i + 1) * 10;
+  }
+  return report;
+}
+
+std::map<std::string, double> ToMap(
+    const google::protobuf::Map<std::string, double> &map) {
+  return std::map<std::string, double>(map.begin(), map.end());
+}
+
+/// Compare two views, ignoring the order of the load shapes and the report flags.
+void AssertSameView(const rpc::ResourcesData &a, const rpc::ResourcesData &b) {
+  ASSERT_EQ(a.version(), b.version());
+  ASSERT_EQ(ToMap(a.resources_total()), ToMap(b.resources_total()));
+  ASSERT_EQ(ToMap(a.resources_available()), ToMap(b.resources_available()));
+  ASSERT_EQ(ToMap(a.resource_load()), ToMap(b.resource_load()));
+  ASSERT_EQ(ToMap(a.resources_normal_task()), ToMap(b.resources_normal_task()));
+  ASSERT_EQ(a.object_pulls_queued(), b.object_pulls_queued());
+  ASSERT_EQ(a.resource_load_by_shape().resource_demands_size(),
+            b.resource_load_by_shape().resource_demands_size());
+  for (const auto &demand : a.resource_load_by_shape().resource_demands()) {
+    bool found = false;
+    for (const auto &other : b.resource_load_by_shape().resource_demands()) {
+      if (ToMap(demand.shape()) == ToMap(other.shape())) {
+        ASSERT_EQ(demand.SerializeAsString(), other.SerializeAsString());
+        found = true;
+      }
+    }
+    ASSERT_TRUE(found);
+  }
+}
+
+}  // namespace
+
+TEST(ResourceUsageDeltaTest, TestUnchanged) {
+  auto base = MakeReport(1, 4, 4);
+  auto current = MakeReport(2, 4, 4);
+  rpc::ResourcesData delta;
+  ASSERT_FALSE(ComputeResourceUsageDelta(base, current, &delta));
+  ASSERT_TRUE(delta.is_delta());
+  // An empty delta doesn't advance the version.
+  ASSERT_EQ(delta.version(), 1);
+  ASSERT_EQ(delta.resources_available_size(), 0);
+  ASSERT_EQ(delta.resources_total_size(), 0);
+  ASSERT_EQ(delta.resource_load_by_shape().resource_demands_size(), 0);
+
+  auto view = base;
+  ASSERT_FALSE(ApplyResourceUsageDelta(delta, &view));
+  AssertSameView(view, base);
+}
+
+TEST(ResourceUsageDeltaTest, TestRoundTrip) {
+  auto base = MakeReport(1, 4, 4);
+  auto current = MakeReport(2, 4, 4);
+  (*current.mutable_resources_available())["CPU"] = 16;
+  current.mutable_resources_available()->erase("custom_0");
+  current.mutable_resources_total()->erase("custom_1");
+  current.mutable_resources_available()->erase("custom_1");
+  (*current.mutable_resources_total())["GPU"] = 8;
+  (*current.mutable_resources_available())["GPU"] = 8;
+  current.mutable_resource_load_by_shape()->mutable_resource_demands(0)->set_backlog_size(
+      5);
+  current.mutable_resource_load_by_shape()->mutable_resource_demands()->SwapElements(1,
+                                                                                     3);
+  current.mutable_resource_load_by_shape()->mutable_resource_demands()->RemoveLast();
+  current.set_object_pulls_queued(true);
+
+  rpc::ResourcesData delta;
+  ASSERT_TRUE(ComputeResourceUsageDelta(base, current, &delta));
+  ASSERT_EQ(delta.version(), 2);
+  ASSERT_EQ(delta.base_version(), 1);
+  // CPU, GPU, and the resources that are no longer available.
+  ASSERT_EQ(delta.resources_available_size(), 4);
+  ASSERT_EQ(delta.resources_available().at("custom_0"), 0);
+  ASSERT_EQ(delta.resources_total_size(), 1);
+  ASSERT_EQ(delta.deleted_resources_size(), 1);
+  // The changed shape and the removed one.
+  ASSERT_EQ(delta.resource_load_by_shape().resource_demands_size(), 2);
+  ASSERT_TRUE(delta.resources_available_changed());
+  ASSERT_TRUE(delta.resource_load_changed());
+
+  auto view = base;
+  ASSERT_TRUE(ApplyResourceUsageDelta(delta, &view));
+  AssertSameView(view, current);
+  ASSERT_FALSE(view.is_delta());
+}
+
+TEST(ResourceUsageDeltaTest, TestMergeDeltas) {
+  auto v1 = MakeReport(1, 4, 4);
+  auto v2 = v1;
+  v2.set_version(2);
+  v2.mutable_resources_available()->erase("custom_0");
+  v2.mutable_resources_total()->erase("custom_1");
+  v2.mutable_resources_available()->erase("custom_1");
+  v2.set_should_global_gc(true);
+  auto v3 = v2;
+  v3.set_version(3);
+  v3.set_should_global_gc(false);
+  (*v3.mutable_resources_total())["custom_1"] = 2;
+  v3.mutable_resource_load_by_shape()->mutable_resource_demands()->RemoveLast();
+  rpc::ResourcesData d2, d3;
+  ASSERT_TRUE(ComputeResourceUsageDelta(v1, v2, &d2));
+  ASSERT_TRUE(ComputeResourceUsageDelta(v2, v3, &d3));
+
+  // Merging the deltas that weren't forwarded yet is the same as applying both.
+  auto pending = d2;
+  ApplyResourceUsageDelta(d3, &pending);
+  ASSERT_TRUE(pending.is_delta());
+  ASSERT_EQ(pending.base_version(), 1);
+  ASSERT_EQ(pending.version(), 3);
+  ASSERT_EQ(pending.resources_available().at("custom_0"), 0);
+  ASSERT_EQ(pending.deleted_resources_size(), 0);
+  ASSERT_TRUE(pending.should_global_gc());
+
+  auto view = v1;
+  ApplyResourceUsageDelta(pending, &view);
+  AssertSameView(view, v3);
+
+  // A full report replaces the view.
+  ApplyResourceUsageDelta(v1, &view);
+  AssertSameView(view, v1);
+}
+
+/// Measure the bytes per report of full and delta encoded reports of a node with many
+/// resources and load shapes, when only one value changes per report.
+TEST(ResourceUsageDeltaTest, TestBytesPerReport) {
+  const int num_reports = 100;
+  auto last = MakeReport(1, 32, 32);
+  size_t full_bytes = 0;
+  size_t delta_bytes = 0;
+  for (int i = 0; i < num_reports; i++) {
+    auto current = last;
+    current.set_version(last.version() + 1);
+    (*current.mutable_resources_available())["CPU"] = i;
+    rpc::ResourcesData delta;
+    ASSERT_TRUE(ComputeResourceUsageDelta(last, current, &delta));
+    full_bytes += current.ByteSizeLong();
+    delta_bytes += delta.ByteSizeLong();
+    last = current;
+  }
+  RAY_LOG(INFO) << "Bytes per report: " << full_bytes / num_reports << " full, "
+                << delta_bytes / num_reports << " delta encoded.";
+  ASSERT_LT(delta_bytes * 10, full_bytes);
+}
+
+}  // namespace ray
@@ -0,0 +1,35 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+
+#include "absl/time/clock.h"
+#include "ray/common/task/task_event_buffer.h"
+#include "ray/util/filesystem.h"
+
+/// Measure the time it takes to record a task event.
+int main(int argc, char **argv) {
+  const auto worker_id = ray::WorkerID::FromRandom();
+  const auto task_id = ray::TaskID::ForFakeTask();
+  const int num_events = 1000000;
+  ray::TaskEventBuffer buffer(worker_id, ray::GetUserTempDir(), 1 << 14);
+  const int64_t start = absl::GetCurrentTimeNanos();
+  for (int i = 0; i < num_events; i++) {
+    buffer.Record(ray::TaskEventType::EXECUTION_STARTED, task_id);
+  }
+  const int64_t duration = absl::GetCurrentTimeNanos() - start;
+  std::cout << "Recording a task event took " << duration / num_events << "ns."
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,193 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/task/task_event_buffer.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <thread>
+
+#include "absl/container/flat_hash_set.h"
+#include "gtest/gtest.h"
+#include "nlohmann/json.hpp"
+#include "ray/util/filesystem.h"
+
+using json = nlohmann::json;
+
+namespace ray {
+
+namespace {
+
+std::vector<TaskEvent> ReadEvents(const TaskEventBuffer &buffer,
+                                  const WorkerID &expected_worker_id) {
+  WorkerID worker_id;
+  std::vector<TaskEvent> events;
+  RAY_CHECK_OK(ReadTaskEvents(buffer.Path(), &worker_id, &events));
+  RAY_CHECK(worker_id == expected_worker_id);
+  return events;
+}
+
+}  // namespace
+
+TEST(TaskEventBufferTest, TestRecordAndRead) {
+  const auto worker_id = WorkerID::FromRandom();
+  const auto task1 = TaskID::ForFakeTask();
+  const auto task2 = TaskID::ForFakeTask();
+  std::string path;
+  {
+    TaskEventBuffer buffer(worker_id, GetUserTempDir(), 16);
+    path = buffer.Path();
+    ASSERT_EQ(path, TaskEventBuffer::GetPath(GetUserTempDir(), worker_id));
+    const auto custom_type = buffer.InternEventType("task:custom");
+    ASSERT_EQ(custom_type, static_cast<int64_t>(TaskEventType::NUM_TYPES));
+    ASSERT_EQ(buffer.InternEventType("task:custom"), custom_type);
+
+    buffer.Record(TaskEventType::RECEIVED, task1);
+    buffer.Record(TaskEventType::EXECUTION_STARTED, task2);
+    buffer.Record(custom_type, task1);
+    auto events = ReadEvents(buffer, worker_id);
+    ASSERT_EQ(events.size(), 3);
+    ASSERT_EQ(events[0].event_type, "task:received");
+    ASSERT_EQ(events[0].task_id, task1);
+    ASSERT_EQ(events[1].event_type, "task:execution_started");
+    ASSERT_EQ(events[1].task_id, task2);
+    ASSERT_EQ(events[2].event_type, "task:custom");
+    ASSERT_EQ(events[2].index, 2);
+    ASSERT_LE(events[0].timestamp_ns, events[2].timestamp_ns);
+  }
+  // The file is removed with the buffer.
+  ASSERT_FALSE(std::ifstream(path).good());
+
+  // A buffer without a directory is only kept in memory.
+  TaskEventBuffer in_memory_buffer(worker_id, "", 16);
+  ASSERT_TRUE(in_memory_buffer.Path().empty());
+  in_memory_buffer.Record(TaskEventType::SUBMITTED, task1);
+}
+
+TEST(TaskEventBufferTest, TestWrapAround) {
+  const auto worker_id = WorkerID::FromRandom();
+  const auto task_id = TaskID::ForFakeTask();
+  // The capacity is rounded up to 4.
+  TaskEventBuffer buffer(worker_id, GetUserTempDir(), 3);
+  for (int i = 0; i < 10; i++) {
+    buffer.Record(TaskEventType::SUBMITTED, task_id);
+  }
+  auto events = ReadEvents(buffer, worker_id);
+  ASSERT_EQ(events.size(), 4);
+  for (size_t i = 0; i < events.size(); i++) {
+    ASSERT_EQ(events[i].index, 6 + i);
+  }
+}
+
+TEST(TaskEventBufferTest, TestConcurrentRecord) {
+  const auto worker_id = WorkerID::FromRandom();
+  const int num_threads = 4;
+  const int num_events_per_thread = 10000;
+  TaskEventBuffer buffer(worker_id, GetUserTempDir(), num_threads * num_events_per_thread);
+  std::vector<TaskID> task_ids;
+  for (int i = 0; i < num_threads; i++) {
+    task_ids.push_back(TaskID::ForFakeTask());
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&buffer, &task_ids, i]() {
+      for (int j = 0; j < num_events_per_thread; j++) {
+        buffer.Record(TaskEventType::EXECUTION_STARTED, task_ids[i]);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto events = ReadEvents(buffer, worker_id);
+  ASSERT_EQ(events.size(), num_threads * num_events_per_thread);
+  absl::flat_hash_map<TaskID, int> num_events_per_task;
+  for (size_t i = 0; i < events.size(); i++) {
+    ASSERT_EQ(events[i].index, i);
+    num_events_per_task[events[i].task_id]++;
+  }
+  for (const auto &task_id : task_ids) {
+    ASSERT_EQ(num_events_per_task[task_id], num_events_per_thread);
+  }
+}
+
+TEST(TaskEventBufferTest, TestChromeTrace) {
+  const auto worker_id = WorkerID::FromRandom();
+  const auto task1 = TaskID::ForFakeTask();
+  const auto task2 = TaskID::ForFakeTask();
+  std::vector<TaskEvent> events = {
+      {0, 1000, "task:received", task1},
+      {1, 3000, "task:execution_started", task1},
+      {2, 4000, "task:received", task2},
+      {3, 9000, "task:finished", task1},
+  };
+  auto trace = json::parse(TaskEventsToChromeTrace(worker_id, events));
+  ASSERT_EQ(trace.size(), 4);
+  ASSERT_EQ(trace[0]["name"], "task:received");
+  ASSERT_EQ(trace[0]["ph"], "X");
+  ASSERT_EQ(trace[0]["tid"], task1.Hex());
+  ASSERT_EQ(trace[0]["pid"], "worker:" + worker_id.Hex());
+  ASSERT_EQ(trace[0]["ts"], 1.0);
+  ASSERT_EQ(trace[0]["dur"], 2.0);
+  ASSERT_EQ(trace[1]["name"], "task:execution_started");
+  ASSERT_EQ(trace[1]["dur"], 6.0);
+  // The last events of the tasks are instants, in the order they were recorded.
+  ASSERT_EQ(trace[2]["tid"], task2.Hex());
+  ASSERT_EQ(trace[2]["ph"], "i");
+  ASSERT_EQ(trace[3]["name"], "task:finished");
+  ASSERT_EQ(trace[3]["ph"], "i");
+}
+
+TEST(TaskEventBufferTest, TestReadTrace) {
+  const std::string directory = JoinPaths(
+      GetUserTempDir(), "ray_task_events_test_" + WorkerID::FromRandom().Hex());
+  ASSERT_EQ(mkdir(directory.c_str(), 0755), 0);
+  std::string trace;
+  ASSERT_TRUE(ReadTaskEventsTrace(directory + "_missing", &trace).IsIOError());
+
+  const auto worker1 = WorkerID::FromRandom();
+  const auto worker2 = WorkerID::FromRandom();
+  const auto task1 = TaskID::ForFakeTask();
+  const auto task2 = TaskID::ForFakeTask();
+  {
+    TaskEventBuffer buffer1(worker1, directory, 16);
+    TaskEventBuffer buffer2(worker2, directory, 16);
+    buffer1.Record(TaskEventType::RECEIVED, task1);
+    buffer1.Record(TaskEventType::FINISHED, task1);
+    buffer2.Record(TaskEventType::RECEIVED, task2);
+    // Files that aren't buffers are skipped.
+    std::ofstream(directory + "/not_a_buffer") << "garbage";
+
+    RAY_CHECK_OK(ReadTaskEventsTrace(directory, &trace));
+    auto merged_trace = json::parse(trace);
+    ASSERT_EQ(merged_trace.size(), 3);
+    absl::flat_hash_map<std::string, int> num_events_per_worker;
+    for (const auto &entry : merged_trace) {
+      num_events_per_worker[entry["pid"].get<std::string>()]++;
+    }
+    ASSERT_EQ(num_events_per_worker["worker:" + worker1.Hex()], 2);
+    ASSERT_EQ(num_events_per_worker["worker:" + worker2.Hex()], 1);
+  }
+
+  // The buffers are removed with their workers.
+  RAY_CHECK_OK(ReadTaskEventsTrace(directory, &trace));
+  ASSERT_EQ(json::parse(trace).size(), 0);
+  unlink((directory + "/not_a_buffer").c_str());
+  rmdir(directory.c_str());
+}
+
+}  // namespace ray
@@ -0,0 +1,104 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+
+#include "ray/common/task/task_util.h"
+#include "ray/util/util.h"
+
+namespace ray {
+namespace {
+
+std::vector<std::unique_ptr<TaskArg>> MakeArgs(int num_args) {
+  std::vector<std::unique_ptr<TaskArg>> args;
+  for (int i = 0; i < num_args; i++) {
+    auto data = std::make_shared<LocalMemoryBuffer>(reinterpret_cast<uint8_t *>(&i),
+                                                    sizeof(i), /*copy_data=*/true);
+    args.emplace_back(new TaskArgByValue(std::make_shared<RayObject>(
+        data, nullptr, std::vector<rpc::ObjectReference>())));
+  }
+  return args;
+}
+
+/// Set the fields of a normal task that are the same for every call.
+void SetCommonFields(TaskSpecBuilder &builder, const TaskID &task_id,
+                     const TaskID &parent_task_id, uint64_t parent_counter) {
+  rpc::Address address;
+  address.set_ip_address("127.0.0.1");
+  address.set_port(1234);
+  builder.SetCommonTaskSpec(
+      task_id, "f()", Language::PYTHON,
+      FunctionDescriptorBuilder::BuildPython("module", "", "f", "hash"),
+      JobID::FromInt(1), parent_task_id, parent_counter, parent_task_id, address, 1,
+      {{"CPU", 1}, {"custom", 0.5}}, {}, std::make_pair(PlacementGroupID::Nil(), -1),
+      true, "", "{\"env_vars\": {\"A\": \"B\"}}");
+  builder.SetNormalTaskSpec(3, false);
+}
+
+TaskSpecification BuildFromScratch(const TaskID &parent_task_id, uint64_t parent_counter,
+                                   const std::vector<std::unique_ptr<TaskArg>> &args) {
+  const auto task_id = TaskID::ForNormalTask(JobID::FromInt(1), parent_task_id,
+                                             parent_counter);
+  TaskSpecBuilder builder;
+  SetCommonFields(builder, task_id, parent_task_id, parent_counter);
+  for (const auto &arg : args) {
+    builder.AddArg(*arg);
+  }
+  return builder.Build();
+}
+
+TaskSpecification BuildFromTemplate(
+    std::shared_ptr<const TaskSpecification> spec_template,
+    const TaskID &parent_task_id, uint64_t parent_counter,
+    const std::vector<std::unique_ptr<TaskArg>> &args) {
+  const auto task_id = TaskID::ForNormalTask(JobID::FromInt(1), parent_task_id,
+                                             parent_counter);
+  TaskSpecBuilder builder(std::move(spec_template));
+  builder.SetCallSpecificFields(task_id, parent_task_id, parent_counter, parent_task_id);
+  for (const auto &arg : args) {
+    builder.AddArg(*arg);
+  }
+  return builder.Build();
+}
+
+}  // namespace
+}  // namespace ray
+
+/// Measure the latency of building the spec of a task, which is on the critical path of
+/// every task submission, from scratch and from a template.
+int main(int argc, char **argv) {
+  const int num_tasks = 10000;
+  const auto parent_task_id = ray::TaskID::ForDriverTask(ray::JobID::FromInt(1));
+  const auto args = ray::MakeArgs(1);
+  ray::TaskSpecTemplateCache cache(1);
+  cache.Put("f", ray::BuildFromScratch(parent_task_id, 0, args));
+
+  int64_t start_us = current_sys_time_us();
+  for (int i = 1; i <= num_tasks; i++) {
+    ray::BuildFromScratch(parent_task_id, i, args);
+  }
+  const int64_t scratch_us = current_sys_time_us() - start_us;
+
+  start_us = current_sys_time_us();
+  for (int i = 1; i <= num_tasks; i++) {
+    ray::BuildFromTemplate(cache.Get("f"), parent_task_id, i, args);
+  }
+  const int64_t template_us = current_sys_time_us() - start_us;
+
+  std::cout << "Task spec build latency: "
+            << static_cast<double>(scratch_us) / num_tasks << "us from scratch, "
+            << static_cast<double>(template_us) / num_tasks << "us from a template."
+            << std::endl;
+  return 0;
+}
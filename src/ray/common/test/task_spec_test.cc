@@ -0,0 +1,146 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+#include "ray/common/task/task_util.h"
+
+namespace ray {
+
+namespace {
+
+std::vector<std::unique_ptr<TaskArg>> MakeArgs(int num_args) {
+  std::vector<std::unique_ptr<TaskArg>> args;
+  for (int i = 0; i < num_args; i++) {
+    auto data = std::make_shared<LocalMemoryBuffer>(reinterpret_cast<uint8_t *>(&i),
+                                                    sizeof(i), /*copy_data=*/true);
+    args.emplace_back(new TaskArgByValue(std::make_shared<RayObject>(
+        data, nullptr, std::vector<rpc::ObjectReference>())));
+  }
+  return args;
+}
+
+/// Set the fields of a normal task that are the same for every call.
+void SetCommonFields(TaskSpecBuilder &builder, const TaskID &task_id,
+                     const TaskID &parent_task_id, uint64_t parent_counter) {
+  rpc::Address address;
+  address.set_ip_address("127.0.0.1");
+  address.set_port(1234);
+  builder.SetCommonTaskSpec(
+      task_id, "f()", Language::PYTHON,
+      FunctionDescriptorBuilder::BuildPython("module", "", "f", "hash"),
+      JobID::FromInt(1), parent_task_id, parent_counter, parent_task_id, address, 1,
+      {{"CPU", 1}, {"custom", 0.5}}, {}, std::make_pair(PlacementGroupID::Nil(), -1),
+      true, "", "{\"env_vars\": {\"A\": \"B\"}}");
+  builder.SetNormalTaskSpec(3, false);
+}
+
+TaskSpecification BuildFromScratch(const TaskID &parent_task_id, uint64_t parent_counter,
+                                   const std::vector<std::unique_ptr<TaskArg>> &args) {
+  const auto task_id = TaskID::ForNormalTask(JobID::FromInt(1), parent_task_id,
+                                             parent_counter);
+  TaskSpecBuilder builder;
+  SetCommonFields(builder, task_id, parent_task_id, parent_counter);
+  for (const auto &arg : args) {
+    builder.AddArg(*arg);
+  }
+  return builder.Build();
+}
+
+TaskSpecification BuildFromTemplate(
+    std::shared_ptr<const TaskSpecification> spec_template,
+    const TaskID &parent_task_id, uint64_t parent_counter,
+    const std::vector<std::unique_ptr<TaskArg>> &args) {
+  const auto task_id = TaskID::ForNormalTask(JobID::FromInt(1), parent_task_id,
+                                             parent_counter);
+  TaskSpecBuilder builder(std::move(spec_template));
+  builder.SetCallSpecificFields(task_id, parent_task_id, parent_counter, parent_task_id);
+  for (const auto &arg : args) {
+    builder.AddArg(*arg);
+  }
+  return builder.Build();
+}
+
+}  // namespace
+
+TEST(TaskSpecTemplateTest, TestBuildFromTemplate) {
+  TaskSpecTemplateCache cache(10);
+  const auto parent_task_id = TaskID::ForDriverTask(JobID::FromInt(1));
+  auto first = BuildFromScratch(parent_task_id, 1, MakeArgs(2));
+  ASSERT_EQ(cache.Get("f"), nullptr);
+  cache.Put("f", first);
+  auto spec_template = cache.Get("f");
+  ASSERT_NE(spec_template, nullptr);
+  ASSERT_TRUE(spec_template->TaskId().IsNil());
+  ASSERT_EQ(spec_template->NumArgs(), 0);
+
+  // A spec built from the template is the same as one built from scratch.
+  const auto args = MakeArgs(3);
+  auto expected = BuildFromScratch(parent_task_id, 2, args);
+  auto actual = BuildFromTemplate(spec_template, parent_task_id, 2, args);
+  ASSERT_EQ(actual, expected);
+  ASSERT_EQ(actual.GetSchedulingClass(), expected.GetSchedulingClass());
+  ASSERT_EQ(actual.GetRequiredResources(), expected.GetRequiredResources());
+  ASSERT_EQ(actual.GetRequiredPlacementResources(),
+            expected.GetRequiredPlacementResources());
+
+  // Building from the template doesn't change the template.
+  ASSERT_TRUE(spec_template->TaskId().IsNil());
+  ASSERT_EQ(spec_template->NumArgs(), 0);
+}
+
+TEST(TaskSpecTemplateTest, TestActorTaskTemplate) {
+  TaskSpecTemplateCache cache(10);
+  const auto job_id = JobID::FromInt(1);
+  const auto parent_task_id = TaskID::ForDriverTask(job_id);
+  const auto actor_id = ActorID::Of(job_id, parent_task_id, 1);
+  const auto creation_dummy =
+      ObjectID::FromIndex(TaskID::ForActorCreationTask(actor_id), 1);
+  auto build = [&](uint64_t counter, const ObjectID &cursor) {
+    TaskSpecBuilder builder;
+    const auto task_id = TaskID::ForActorTask(job_id, parent_task_id, counter, actor_id);
+    SetCommonFields(builder, task_id, parent_task_id, counter);
+    builder.SetActorTaskSpec(actor_id, creation_dummy, cursor, counter);
+    return builder.Build();
+  };
+  cache.Put("actor", build(0, ObjectID::Nil()));
+  auto spec_template = cache.Get("actor");
+  ASSERT_TRUE(spec_template->IsActorTask());
+
+  const auto cursor = ObjectID::FromRandom();
+  TaskSpecBuilder builder(spec_template);
+  builder.SetCallSpecificFields(TaskID::ForActorTask(job_id, parent_task_id, 5, actor_id),
+                                parent_task_id, 5, parent_task_id);
+  builder.SetActorTaskSpec(actor_id, creation_dummy, cursor, 5);
+  ASSERT_EQ(builder.Build(), build(5, cursor));
+}
+
+TEST(TaskSpecTemplateTest, TestCacheSize) {
+  const auto parent_task_id = TaskID::ForDriverTask(JobID::FromInt(1));
+  auto spec = BuildFromScratch(parent_task_id, 1, {});
+
+  TaskSpecTemplateCache disabled(0);
+  ASSERT_FALSE(disabled.Enabled());
+  disabled.Put("f", spec);
+  ASSERT_EQ(disabled.Get("f"), nullptr);
+
+  TaskSpecTemplateCache cache(2);
+  cache.Put("a", spec);
+  cache.Put("b", spec);
+  ASSERT_EQ(cache.Size(), 2);
+  cache.Put("c", spec);
+  ASSERT_EQ(cache.Size(), 1);
+  ASSERT_NE(cache.Get("c"), nullptr);
+}
+
+}  // namespace ray
@@ -15,6 +15,8 @@
 #pragma once
 #include <memory>
 
+#include "absl/synchronization/mutex.h"
+#include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/ray_config.h"
 #include "ray/gcs/gcs_client/gcs_client.h"
 
@@ -64,8 +66,12 @@ class ActorCreatorInterface {
 
 class DefaultActorCreator : public ActorCreatorInterface {
  public:
-  explicit DefaultActorCreator(std::shared_ptr<gcs::GcsClient> gcs_client)
-      : gcs_client_(std::move(gcs_client)) {}
+  /// \param gcs_client The client to register and create actors with.
+  /// \param io_service The event loop to send batches of actor creations on. If it's
+  /// null, every actor is created with its own request.
+  explicit DefaultActorCreator(std::shared_ptr<gcs::GcsClient> gcs_client,
+                               instrumented_io_context *io_service = nullptr)
+      : gcs_client_(std::move(gcs_client)), io_service_(io_service) {}
 
   Status RegisterActor(const TaskSpecification &task_spec) override {
     auto promise = std::make_shared<std::promise<void>>();
@@ -117,14 +123,86 @@ class DefaultActorCreator : public ActorCreatorInterface {
     iter->second.emplace_back(std::move(callback));
   }
 
+  /// The actors whose creation is requested before the event loop gets to send them
+  /// are created with one CreateActors request, see actor_creation_batch_size.
   Status AsyncCreateActor(
       const TaskSpecification &task_spec,
       const rpc::ClientCallback<rpc::CreateActorReply> &callback) override {
-    return gcs_client_->Actors().AsyncCreateActor(task_spec, callback);
+    const size_t batch_size =
+        std::max<int64_t>(::RayConfig::instance().actor_creation_batch_size(), 1);
+    if (io_service_ == nullptr || batch_size == 1) {
+      return gcs_client_->Actors().AsyncCreateActor(task_spec, callback);
+    }
+    size_t num_pending;
+    {
+      absl::MutexLock lock(&mutex_);
+      pending_creations_.emplace_back(task_spec, callback);
+      num_pending = pending_creations_.size();
+    }
+    if (num_pending >= batch_size) {
+      SendPendingCreations();
+    } else if (num_pending == 1) {
+      io_service_->post([this]() { SendPendingCreations(); },
+                        "ActorCreator.SendPendingCreations");
+    }
+    return Status::OK();
   }
 
  private:
+  /// Create the actors whose creation was requested since the last call. A batch is
+  /// replied to once all of its actors are created or failed. The handles of an actor
+  /// connect to it as soon as it's alive, though, through the actor table.
+  void SendPendingCreations() LOCKS_EXCLUDED(mutex_) {
+    std::vector<std::pair<TaskSpecification, rpc::ClientCallback<rpc::CreateActorReply>>>
+        creations;
+    {
+      absl::MutexLock lock(&mutex_);
+      creations.swap(pending_creations_);
+    }
+    if (creations.empty()) {
+      return;
+    }
+    if (creations.size() == 1) {
+      RAY_CHECK_OK(gcs_client_->Actors().AsyncCreateActor(creations.front().first,
+                                                          creations.front().second));
+      return;
+    }
+    std::vector<TaskSpecification> task_specs;
+    std::vector<rpc::ClientCallback<rpc::CreateActorReply>> callbacks;
+    for (auto &creation : creations) {
+      task_specs.push_back(std::move(creation.first));
+      callbacks.push_back(std::move(creation.second));
+    }
+    RAY_CHECK_OK(gcs_client_->Actors().AsyncCreateActors(
+        task_specs,
+        [callbacks = std::move(callbacks)](Status status,
+                                           const rpc::CreateActorsReply &reply) {
+          if (status.ok() && reply.replies_size() != static_cast<int>(callbacks.size())) {
+            status = Status::IOError("The GCS replied to a batch of " +
+                                     std::to_string(reply.replies_size()) + " of " +
+                                     std::to_string(callbacks.size()) + " actors.");
+          }
+          for (size_t i = 0; i < callbacks.size(); i++) {
+            if (!status.ok()) {
+              callbacks[i](status, rpc::CreateActorReply());
+              continue;
+            }
+            const auto &actor_reply = reply.replies(i);
+            callbacks[i](actor_reply.status().code() == (int)StatusCode::OK
+                             ? Status::OK()
+                             : Status(StatusCode(actor_reply.status().code()),
+                                      actor_reply.status().message()),
+                         actor_reply);
+          }
+        }));
+  }
+
   std::shared_ptr<gcs::GcsClient> gcs_client_;
+  instrumented_io_context *io_service_;
+  absl::Mutex mutex_;
+  /// The actors to create with the next batch, with their callbacks.
+  std::vector<std::pair<TaskSpecification, rpc::ClientCallback<rpc::CreateActorReply>>>
+      pending_creations_ GUARDED_BY(mutex_);
   using RegisteringActorType =
       absl::flat_hash_map<ActorID, std::vector<ray::gcs::StatusCallback>>;
   ThreadPrivate<RegisteringActorType> registering_actors_;
@@ -60,13 +60,15 @@ struct TaskOptions {
               std::unordered_map<std::string, double> &resources,
               const std::string &concurrency_group_name = "",
               const std::string &serialized_runtime_env = "{}",
-              const std::vector<std::string> &runtime_env_uris = {})
+              const std::vector<std::string> &runtime_env_uris = {},
+              bool streaming_generator = false)
       : name(name),
         num_returns(num_returns),
         resources(resources),
         concurrency_group_name(concurrency_group_name),
         serialized_runtime_env(serialized_runtime_env),
-        runtime_env_uris(runtime_env_uris) {}
+        runtime_env_uris(runtime_env_uris),
+        streaming_generator(streaming_generator) {}
 
   /// The name of this task.
   std::string name;
@@ -80,6 +82,8 @@ struct TaskOptions {
   std::string serialized_runtime_env;
   // URIs contained in the runtime_env.
   std::vector<std::string> runtime_env_uris;
+  /// Whether the task streams its return values. If so, num_returns must be 1.
+  bool streaming_generator = false;
 };
 
 /// Options for actor creation tasks.
@@ -14,6 +14,8 @@
 
 #include "ray/core_worker/core_worker.h"
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "boost/fiber/all.hpp"
 #include "ray/common/bundle_spec.h"
 #include "ray/common/ray_config.h"
@@ -63,6 +65,36 @@ ObjectLocation CreateObjectLocation(const rpc::GetObjectLocationsOwnerReply &rep
                         NodeID::FromBinary(object_info.spilled_node_id()));
 }
 
+/// Append a field to the key of a task spec template. Strings are prefixed with their
+/// length so that different fields can't produce the same key.
+void AppendToTemplateKey(std::string *key, const std::string &field) {
+  absl::StrAppend(key, field.size(), ":", field);
+}
+
+void AppendToTemplateKey(std::string *key,
+                         const std::unordered_map<std::string, double> &resources) {
+  absl::StrAppend(key, resources.size(), "{");
+  for (const auto &resource : resources) {
+    AppendToTemplateKey(key, resource.first);
+    // Encode the exact value, since StrAppend rounds doubles to 6 significant digits.
+    absl::StrAppend(key, absl::StrFormat("%a", resource.second), ",");
+  }
+  absl::StrAppend(key, "}");
+}
+
+/// The key of the template of a task spec, which covers everything that the caller sets
+/// on the spec except for the fields that differ per call.
+std::string TaskSpecTemplateKey(const RayFunction &function,
+                                const TaskOptions &task_options) {
+  std::string key;
+  absl::StrAppend(&key, function.GetLanguage(), ",", task_options.num_returns, ",");
+  AppendToTemplateKey(&key, function.GetFunctionDescriptor()->Serialize());
+  AppendToTemplateKey(&key, task_options.name);
+  AppendToTemplateKey(&key, task_options.resources);
+  AppendToTemplateKey(&key, task_options.concurrency_group_name);
+  return key;
+}
+
 /// The global instance of `CoreWorkerProcess`.
 std::unique_ptr<CoreWorkerProcess> core_worker_process;
 }  // namespace
@@ -412,7 +444,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       num_executed_tasks_(0),
       resource_ids_(new ResourceMappingType()),
       grpc_service_(io_service_, *this),
-      task_execution_service_work_(task_execution_service_) {
+      task_execution_service_work_(task_execution_service_),
+      task_spec_templates_(RayConfig::instance().task_spec_template_cache_size()) {
   RAY_LOG(DEBUG) << "Constructing CoreWorker, worker_id: " << worker_id;
 
   // Initialize task receivers.
@@ -523,6 +556,16 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
   // Initialize profiler.
   profiler_ = std::make_shared<worker::Profiler>(
       worker_context_, options_.node_ip_address, io_service_, gcs_client_);
+  if (RayConfig::instance().task_events_buffer_size() > 0) {
+    const auto &task_events_directory =
+        RayConfig::instance().task_events_buffer_directory();
+    task_event_buffer_ = std::make_unique<TaskEventBuffer>(
+        GetWorkerID(),
+        task_events_directory.empty()
+            ? ""
+            : TaskEventBuffer::GetNodeDirectory(task_events_directory, local_raylet_id),
+        RayConfig::instance().task_events_buffer_size());
+  }
 
   core_worker_client_pool_ =
       std::make_shared<rpc::CoreWorkerClientPool>(*client_call_manager_);
@@ -631,7 +674,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
           }
         }
       },
-      check_node_alive_fn, reconstruct_object_callback, push_error_callback));
+      check_node_alive_fn, reconstruct_object_callback, push_error_callback,
+      RayConfig::instance().max_lineage_bytes()));
 
   // Create an entry for the driver task in the task table. This task is
   // added immediately with status RUNNING. This allows us to push errors
@@ -672,7 +716,7 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
         PushError(options_.job_id, "excess_queueing_warning", stream.str(), timestamp));
   };
 
-  actor_creator_ = std::make_shared<DefaultActorCreator>(gcs_client_);
+  actor_creator_ = std::make_shared<DefaultActorCreator>(gcs_client_, &io_service_);
 
   direct_actor_submitter_ = std::shared_ptr<CoreWorkerDirectActorTaskSubmitter>(
       new CoreWorkerDirectActorTaskSubmitter(*core_worker_client_pool_, *memory_store_,
@@ -711,7 +755,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       };
   future_resolver_.reset(new FutureResolver(memory_store_, reference_counter_,
                                             std::move(report_locality_data_callback),
-                                            core_worker_client_pool_, rpc_address_));
+                                            core_worker_client_pool_, rpc_address_,
+                                            io_service_));
 
   // Unfortunately the raylet client has to be constructed after the receivers.
   if (direct_task_receiver_ != nullptr) {
@@ -1042,6 +1087,9 @@ void CoreWorker::InternalHeartbeat() {
   if (options_.worker_type == WorkerType::DRIVER && options_.interactive) {
     memory_store_->NotifyUnhandledErrors();
   }
+
+  object_status_batches_.EraseAbandonedBatches(
+      RayConfig::instance().get_object_status_batch_timeout_ms());
 }
 
 std::unordered_map<ObjectID, std::pair<size_t, size_t>>
@@ -1386,6 +1434,83 @@ Status CoreWorker::Get(const std::vector<ObjectID> &ids, const int64_t timeout_m
   return Status::OK();
 }
 
+std::unique_ptr<AsCompletedGet> CoreWorker::GetAsCompleted(
+    const std::vector<ObjectID> &ids) {
+  auto plasma_fetch = [this](const std::vector<ObjectID> &object_ids) {
+    return plasma_store_provider_->Fetch(object_ids, worker_context_);
+  };
+  auto plasma_get =
+      [this](const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
+             absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results) {
+        return plasma_store_provider_->GetFromLocalStore(object_ids, timeout_ms,
+                                                         results);
+      };
+  auto notify_blocked = [this]() { NotifyTaskBlocked(true); };
+  // This unblocks the worker and cancels the fetch of the plasma objects.
+  auto notify_done = [this]() {
+    RAY_CHECK_OK(plasma_store_provider_->EndFetch(worker_context_));
+  };
+  return std::make_unique<AsCompletedGet>(
+      ids, *memory_store_, std::move(plasma_fetch), std::move(plasma_get),
+      std::move(notify_blocked), std::move(notify_done), options_.check_signals);
+}
+
+void CoreWorker::NotifyTaskBlocked(bool blocked) {
+  // Only send block/unblock IPCs for non-actor tasks on the main thread.
+  if (!worker_context_.ShouldReleaseResourcesOnBlockingCalls()) {
+    return;
+  }
+  if (blocked) {
+    RAY_CHECK_OK(
+        local_raylet_client_->NotifyDirectCallTaskBlocked(/*release_resources=*/true));
+  } else {
+    RAY_CHECK_OK(local_raylet_client_->NotifyDirectCallTaskUnblocked());
+  }
+}
+
+Status CoreWorker::ReadObjectRefStream(const ObjectID &generator_id, int64_t timeout_ms,
+                                       ObjectID *object_id, bool *end_of_stream) {
+  const int64_t start_time = current_time_ms();
+  bool blocked = false;
+  Status status;
+  while (true) {
+    status =
+        task_manager_->TryReadObjectRefStream(generator_id, object_id, end_of_stream);
+    if (!status.ok() || !object_id->IsNil() || *end_of_stream) {
+      break;
+    }
+    int64_t wait_ms = RayConfig::instance().get_timeout_milliseconds();
+    if (timeout_ms >= 0) {
+      const int64_t remaining_ms = timeout_ms - (current_time_ms() - start_time);
+      if (remaining_ms <= 0) {
+        status = Status::TimedOut("Timed out waiting for the next value of generator " +
+                                  generator_id.Hex());
+        break;
+      }
+      wait_ms = std::min(wait_ms, remaining_ms);
+    }
+    if (!blocked) {
+      NotifyTaskBlocked(true);
+      blocked = true;
+    }
+    if (!task_manager_->WaitForObjectRefStream(generator_id, wait_ms) &&
+        options_.check_signals) {
+      status = options_.check_signals();
+      if (!status.ok()) {
+        break;
+      }
+    }
+  }
+  if (blocked) {
+    NotifyTaskBlocked(false);
+  }
+  return status;
+}
+
+void CoreWorker::DelObjectRefStream(const ObjectID &generator_id) {
+  task_manager_->DelObjectRefStream(generator_id);
+}
+
 Status CoreWorker::GetIfLocal(const std::vector<ObjectID> &ids,
                               std::vector<std::shared_ptr<RayObject>> *results) {
   results->resize(ids.size(), nullptr);
@@ -1706,32 +1831,74 @@ void CoreWorker::BuildCommonTaskSpec(
   }
 }
 
+void CoreWorker::SetCallSpecificFields(
+    TaskSpecBuilder &builder, const TaskID &task_id, uint64_t task_index,
+    const std::vector<std::unique_ptr<TaskArg>> &args) {
+  builder.SetCallSpecificFields(task_id, worker_context_.GetCurrentTaskID(), task_index,
+                                GetCallerId());
+  for (const auto &arg : args) {
+    builder.AddArg(*arg);
+  }
+}
+
 std::vector<rpc::ObjectReference> CoreWorker::SubmitTask(
     const RayFunction &function, const std::vector<std::unique_ptr<TaskArg>> &args,
     const TaskOptions &task_options, int max_retries, bool retry_exceptions,
     BundleID placement_options, bool placement_group_capture_child_tasks,
     const std::string &debugger_breakpoint) {
-  TaskSpecBuilder builder;
+  RAY_CHECK(!task_options.streaming_generator ||
+            (task_options.num_returns == 1 && !options_.is_local_mode))
+      << "Streaming generator tasks have a single return object and are not supported "
+         "in local mode.";
   const auto next_task_index = worker_context_.GetNextTaskIndex();
   const auto task_id =
       TaskID::ForNormalTask(worker_context_.GetCurrentJobID(),
                             worker_context_.GetCurrentTaskID(), next_task_index);
-  auto constrained_resources = AddPlacementGroupConstraint(
-      task_options.resources, placement_options.first, placement_options.second);
-
-  const std::unordered_map<std::string, double> required_resources;
-  auto task_name = task_options.name.empty()
-                       ? function.GetFunctionDescriptor()->DefaultTaskName()
-                       : task_options.name;
-  // TODO(ekl) offload task building onto a thread pool for performance
-  BuildCommonTaskSpec(builder, worker_context_.GetCurrentJobID(), task_id, task_name,
-                      worker_context_.GetCurrentTaskID(), next_task_index, GetCallerId(),
-                      rpc_address_, function, args, task_options.num_returns,
-                      constrained_resources, required_resources, placement_options,
-                      placement_group_capture_child_tasks, debugger_breakpoint,
-                      task_options.serialized_runtime_env, task_options.runtime_env_uris);
-  builder.SetNormalTaskSpec(max_retries, retry_exceptions);
-  TaskSpecification task_spec = builder.Build();
+  std::string template_key;
+  std::shared_ptr<const TaskSpecification> spec_template;
+  if (task_spec_templates_.Enabled()) {
+    template_key = TaskSpecTemplateKey(function, task_options);
+    absl::StrAppend(&template_key, worker_context_.GetCurrentJobID().Binary(),
+                    max_retries, ",", retry_exceptions, ",",
+                    task_options.streaming_generator, ",",
+                    placement_options.first.Binary(), placement_options.second, ",",
+                    placement_group_capture_child_tasks, ",");
+    AppendToTemplateKey(&template_key, debugger_breakpoint);
+    AppendToTemplateKey(&template_key, task_options.serialized_runtime_env);
+    for (const auto &uri : task_options.runtime_env_uris) {
+      AppendToTemplateKey(&template_key, uri);
+    }
+    spec_template = task_spec_templates_.Get(template_key);
+  }
+
+  TaskSpecification task_spec;
+  if (spec_template != nullptr) {
+    TaskSpecBuilder builder(spec_template);
+    SetCallSpecificFields(builder, task_id, next_task_index, args);
+    task_spec = builder.Build();
+  } else {
+    TaskSpecBuilder builder;
+    auto constrained_resources = AddPlacementGroupConstraint(
+        task_options.resources, placement_options.first, placement_options.second);
+
+    const std::unordered_map<std::string, double> required_resources;
+    auto task_name = task_options.name.empty()
+                         ? function.GetFunctionDescriptor()->DefaultTaskName()
+                         : task_options.name;
+    // TODO(ekl) offload task building onto a thread pool for performance
+    BuildCommonTaskSpec(builder, worker_context_.GetCurrentJobID(), task_id, task_name,
+                        worker_context_.GetCurrentTaskID(), next_task_index,
+                        GetCallerId(), rpc_address_, function, args,
+                        task_options.num_returns, constrained_resources,
+                        required_resources, placement_options,
+                        placement_group_capture_child_tasks, debugger_breakpoint,
+                        task_options.serialized_runtime_env,
+                        task_options.runtime_env_uris);
+    builder.SetNormalTaskSpec(max_retries, retry_exceptions,
+                              task_options.streaming_generator);
+    task_spec = builder.Build();
+    task_spec_templates_.Put(template_key, task_spec);
+  }
   RAY_LOG(DEBUG) << "Submit task " << task_spec.DebugString();
   std::vector<rpc::ObjectReference> returned_refs;
   if (options_.is_local_mode) {
@@ -1739,6 +1906,7 @@ std::vector<rpc::ObjectReference> CoreWorker::SubmitTask(
   } else {
     returned_refs = task_manager_->AddPendingTask(task_spec.CallerAddress(), task_spec,
                                                   CurrentCallSite(), max_retries);
+    RecordTaskEvent(TaskEventType::SUBMITTED, task_id);
     io_service_.post(
         [this, task_spec]() {
           RAY_UNUSED(direct_task_submitter_->SubmitTask(task_spec));
@@ -1832,6 +2000,7 @@ Status CoreWorker::CreateActor(const RayFunction &function,
     }
     task_manager_->AddPendingTask(rpc_address_, task_spec, CurrentCallSite(),
                                   max_retries);
+    RecordTaskEvent(TaskEventType::SUBMITTED, task_spec.TaskId());
 
     if (actor_name.empty()) {
       io_service_.post(
@@ -1956,40 +2125,60 @@ std::vector<rpc::ObjectReference> CoreWorker::SubmitActorTask(
   // Add one for actor cursor object id for tasks.
   const int num_returns = task_options.num_returns + 1;
 
-  // Build common task spec.
-  TaskSpecBuilder builder;
   const auto next_task_index = worker_context_.GetNextTaskIndex();
   const TaskID actor_task_id = TaskID::ForActorTask(
       worker_context_.GetCurrentJobID(), worker_context_.GetCurrentTaskID(),
       next_task_index, actor_handle->GetActorID());
-  const std::unordered_map<std::string, double> required_resources;
-  const auto task_name = task_options.name.empty()
-                             ? function.GetFunctionDescriptor()->DefaultTaskName()
-                             : task_options.name;
-  BuildCommonTaskSpec(builder, actor_handle->CreationJobID(), actor_task_id, task_name,
-                      worker_context_.GetCurrentTaskID(), next_task_index, GetCallerId(),
-                      rpc_address_, function, args, num_returns, task_options.resources,
-                      required_resources, std::make_pair(PlacementGroupID::Nil(), -1),
-                      true, /* placement_group_capture_child_tasks */
-                      "",   /* debugger_breakpoint */
-                      "{}", /* serialized_runtime_env */
-                      {},   /* runtime_env_uris */
-                      task_options.concurrency_group_name);
-  // NOTE: placement_group_capture_child_tasks and runtime_env will
-  // be ignored in the actor because we should always follow the actor's option.
-
   // TODO(swang): Do we actually need to set this ObjectID?
   const ObjectID new_cursor = ObjectID::FromIndex(actor_task_id, num_returns);
-  actor_handle->SetActorTaskSpec(builder, new_cursor);
+
+  std::string template_key;
+  std::shared_ptr<const TaskSpecification> spec_template;
+  if (task_spec_templates_.Enabled()) {
+    template_key = TaskSpecTemplateKey(function, task_options);
+    absl::StrAppend(&template_key, actor_id.Binary());
+    spec_template = task_spec_templates_.Get(template_key);
+  }
+
+  TaskSpecification task_spec;
+  if (spec_template != nullptr) {
+    TaskSpecBuilder builder(spec_template);
+    SetCallSpecificFields(builder, actor_task_id, next_task_index, args);
+    actor_handle->SetActorTaskSpec(builder, new_cursor);
+    task_spec = builder.Build();
+  } else {
+    // Build common task spec.
+    TaskSpecBuilder builder;
+    const std::unordered_map<std::string, double> required_resources;
+    const auto task_name = task_options.name.empty()
+                               ? function.GetFunctionDescriptor()->DefaultTaskName()
+                               : task_options.name;
+    BuildCommonTaskSpec(builder, actor_handle->CreationJobID(), actor_task_id, task_name,
+                        worker_context_.GetCurrentTaskID(), next_task_index,
+                        GetCallerId(), rpc_address_, function, args, num_returns,
+                        task_options.resources, required_resources,
+                        std::make_pair(PlacementGroupID::Nil(), -1),
+                        true, /* placement_group_capture_child_tasks */
+                        "",   /* debugger_breakpoint */
+                        "{}", /* serialized_runtime_env */
+                        {},   /* runtime_env_uris */
+                        task_options.concurrency_group_name);
+    // NOTE: placement_group_capture_child_tasks and runtime_env will
+    // be ignored in the actor because we should always follow the actor's option.
+
+    actor_handle->SetActorTaskSpec(builder, new_cursor);
+    task_spec = builder.Build();
+    task_spec_templates_.Put(template_key, task_spec);
+  }
 
   // Submit task.
-  TaskSpecification task_spec = builder.Build();
   std::vector<rpc::ObjectReference> returned_refs;
   if (options_.is_local_mode) {
     returned_refs = ExecuteTaskLocalMode(task_spec, actor_id);
   } else {
     returned_refs = task_manager_->AddPendingTask(
         rpc_address_, task_spec, CurrentCallSite(), actor_handle->MaxTaskRetries());
+    RecordTaskEvent(TaskEventType::SUBMITTED, actor_task_id);
     io_service_.post(
         [this, task_spec]() {
           RAY_UNUSED(direct_actor_submitter_->SubmitTask(task_spec));
@@ -2316,12 +2505,14 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
     name_of_concurrency_group_to_execute = task_spec.ConcurrencyGroupName();
   }
 
+  RecordTaskEvent(TaskEventType::EXECUTION_STARTED, task_spec.TaskId());
   status = options_.task_execution_callback(
       task_type, task_spec.GetName(), func,
       task_spec.GetRequiredResources().GetResourceUnorderedMap(), args, arg_refs,
       return_ids, task_spec.GetDebuggerBreakpoint(), return_objects,
       creation_task_exception_pb_bytes, is_application_level_error,
       defined_concurrency_groups, name_of_concurrency_group_to_execute);
+  RecordTaskEvent(TaskEventType::EXECUTION_FINISHED, task_spec.TaskId());
 
   // Get the reference counts for any IDs that we borrowed during this task,
   // remove the local reference for these IDs, and return the ref count info to
@@ -2366,6 +2557,7 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
 
   RAY_LOG(DEBUG) << "Finished executing task " << task_spec.TaskId()
                  << ", status=" << status;
+  RecordTaskEvent(TaskEventType::FINISHED, task_spec.TaskId());
   if (status.IsCreationTaskError()) {
     Exit(rpc::WorkerExitType::CREATION_TASK_ERROR, creation_task_exception_pb_bytes);
   } else if (status.IsIntentionalSystemExit()) {
@@ -2399,6 +2591,53 @@ Status CoreWorker::SealReturnObject(const ObjectID &return_id,
   return status;
 }
 
+ObjectID CoreWorker::AllocateDynamicReturnId() {
+  return ObjectID::FromIndex(worker_context_.GetCurrentTaskID(),
+                             worker_context_.GetNextPutIndex());
+}
+
+Status CoreWorker::ReportGeneratorItemReturns(const ObjectID &object_id,
+                                              const std::shared_ptr<RayObject> &object,
+                                              int64_t item_index) {
+  const auto &task_spec = worker_context_.GetCurrentTask();
+  RAY_CHECK(task_spec->IsStreamingGenerator());
+  rpc::ReportGeneratorItemReturnsRequest request;
+  request.set_intended_worker_id(task_spec->CallerWorkerId().Binary());
+  request.set_generator_id(task_spec->ReturnId(0).Binary());
+  request.set_item_index(item_index);
+  request.mutable_worker_addr()->CopyFrom(rpc_address_);
+  auto return_object = request.mutable_returned_object();
+  return_object->set_object_id(object_id.Binary());
+  // The object is nullptr if it already existed in the object store.
+  if (object == nullptr ||
+      (object->GetData() != nullptr && object->GetData()->IsPlasmaBuffer())) {
+    return_object->set_in_plasma(true);
+  } else {
+    if (object->GetData() != nullptr) {
+      return_object->set_data(object->GetData()->Data(), object->GetData()->Size());
+    }
+    if (object->GetMetadata() != nullptr) {
+      return_object->set_metadata(object->GetMetadata()->Data(),
+                                  object->GetMetadata()->Size());
+    }
+  }
+  if (object != nullptr) {
+    return_object->set_size(object->GetSize());
+    for (const auto &nested_ref : object->GetNestedRefs()) {
+      return_object->add_nested_inlined_refs()->CopyFrom(nested_ref);
+    }
+  }
+
+  auto status_promise = std::make_shared<std::promise<Status>>();
+  auto client = core_worker_client_pool_->GetOrConnect(task_spec->CallerAddress());
+  client->ReportGeneratorItemReturns(
+      request, [status_promise](const Status &status,
+                                const rpc::ReportGeneratorItemReturnsReply &reply) {
+        status_promise->set_value(status);
+      });
+  return status_promise->get_future().get();
+}
+
 std::vector<rpc::ObjectReference> CoreWorker::ExecuteTaskLocalMode(
     const TaskSpecification &task_spec, const ActorID &actor_id) {
   auto resource_ids = std::make_shared<ResourceMappingType>();
@@ -2531,6 +2770,8 @@ void CoreWorker::HandlePushTask(const rpc::PushTaskRequest &request,
                            send_reply_callback)) {
     return;
   }
+  RecordTaskEvent(TaskEventType::RECEIVED,
+                  TaskID::FromBinary(request.task_spec().task_id()));
 
   // Increment the task_queue_length and per function counter.
   task_queue_length_ += 1;
@@ -2543,17 +2784,34 @@ void CoreWorker::HandlePushTask(const rpc::PushTaskRequest &request,
   }
 
   // For actor tasks, we just need to post a HandleActorTask instance to the task
-  // execution service.
+  // execution service. The request is shared rather than copied into the closure.
   if (request.task_spec().type() == TaskType::ACTOR_TASK) {
     task_execution_service_.post(
-        [this, request, reply, send_reply_callback = std::move(send_reply_callback)] {
+        [this, shared_request = rpc::TakeRequestMessage(request), reply,
+         send_reply_callback = std::move(send_reply_callback)] {
           // We have posted an exit task onto the main event loop,
           // so shouldn't bother executing any further work.
           if (exiting_) return;
-          direct_task_receiver_->HandleTask(request, reply, send_reply_callback);
+          direct_task_receiver_->HandleTask(shared_request, reply, send_reply_callback);
         },
         "CoreWorker.HandlePushTaskActor");
   } else {
+    if (RayConfig::instance().push_small_returns_to_borrowers()) {
+      // Track the borrowers that the owner forwards to us while the task runs.
+      const auto task_id = TaskID::FromBinary(request.task_spec().task_id());
+      {
+        absl::MutexLock lock(&mutex_);
+        return_object_borrowers_[task_id];
+      }
+      send_reply_callback = [this, task_id, reply,
+                             owner_address = request.task_spec().caller_address(),
+                             send_reply_callback = std::move(send_reply_callback)](
+                                Status status, std::function<void()> success,
+                                std::function<void()> failure) {
+        PushReturnObjectsToBorrowers(task_id, owner_address, status, *reply);
+        send_reply_callback(status, std::move(success), std::move(failure));
+      };
+    }
     // Normal tasks are enqueued here, and we post a RunNormalTasksFromQueue instance to
     // the task execution service.
     direct_task_receiver_->HandleTask(request, reply, send_reply_callback);
@@ -2568,6 +2826,41 @@ void CoreWorker::HandlePushTask(const rpc::PushTaskRequest &request,
   }
 }
 
+void CoreWorker::HandlePushTasks(const rpc::PushTasksRequest &request,
+                                 rpc::PushTasksReply *reply,
+                                 rpc::SendReplyCallback send_reply_callback) {
+  if (request.requests_size() == 0) {
+    // The client polls for the results of a batch that it pushed before.
+    actor_task_batch_results_.Poll(request.batch_id(), request.num_results_received(),
+                                   reply, std::move(send_reply_callback));
+    return;
+  }
+  bool accept_batch = direct_task_receiver_->ExecutesActorTasksInOrder();
+  for (const auto &task_request : request.requests()) {
+    accept_batch &= task_request.task_spec().type() == TaskType::ACTOR_TASK;
+  }
+  if (!accept_batch) {
+    reply->set_batch_rejected(true);
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
+
+  // The tasks finish on the task execution thread, and their results are sent as
+  // they finish.
+  auto task_replies =
+      actor_task_batch_results_.AddBatch(request.batch_id(), request.requests_size());
+  for (int i = 0; i < request.requests_size(); i++) {
+    HandlePushTask(request.requests(i), task_replies[i],
+                   [this, batch_id = request.batch_id(), i](
+                       Status status, std::function<void()> success,
+                       std::function<void()> failure) {
+                     actor_task_batch_results_.SetResult(batch_id, i, status);
+                   });
+  }
+  actor_task_batch_results_.Poll(request.batch_id(), 0, reply,
+                                 std::move(send_reply_callback));
+}
+
 void CoreWorker::HandleStealTasks(const rpc::StealTasksRequest &request,
                                   rpc::StealTasksReply *reply,
                                   rpc::SendReplyCallback send_reply_callback) {
@@ -2639,6 +2932,164 @@ void CoreWorker::HandleGetObjectStatus(const rpc::GetObjectStatusRequest &reques
   RemoveLocalReference(object_id);
 }
 
+void CoreWorker::HandleGetObjectStatusBatch(
+    const rpc::GetObjectStatusBatchRequest &request,
+    rpc::GetObjectStatusBatchReply *reply, rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.owner_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  if (request.object_ids().empty()) {
+    object_status_batches_.Poll(request.batch_id(), reply,
+                                std::move(send_reply_callback));
+    return;
+  }
+
+  std::vector<ObjectID> object_ids;
+  for (const auto &object_id : request.object_ids()) {
+    object_ids.push_back(ObjectID::FromBinary(object_id));
+  }
+  RAY_LOG(DEBUG) << "Received GetObjectStatusBatch for " << object_ids.size()
+                 << " objects";
+  // Acquire references to the objects, see HandleGetObjectStatus.
+  for (const auto &object_id : object_ids) {
+    AddLocalReference(object_id, "<temporary (get object status)>");
+  }
+
+  const bool forward_borrower = request.has_borrower_address() &&
+                                RayConfig::instance().push_small_returns_to_borrowers();
+  absl::flat_hash_set<TaskID> forwarded_tasks;
+  // The statuses are sent as the objects become available, in the reply to this
+  // request and to the borrower's polls for the rest of the batch.
+  const auto &batch_id = request.batch_id();
+  object_status_batches_.AddBatch(batch_id, object_ids.size());
+  for (const auto &object_id : object_ids) {
+    rpc::ObjectStatusEntry entry;
+    entry.set_object_id(object_id.Binary());
+    rpc::Address owner_address;
+    if (!reference_counter_->GetOwner(object_id, &owner_address)) {
+      // We owned this object, but the object has gone out of scope.
+      entry.mutable_status()->set_status(rpc::GetObjectStatusReply::OUT_OF_SCOPE);
+      object_status_batches_.AddStatus(batch_id, std::move(entry));
+      continue;
+    }
+    RAY_CHECK(owner_address.worker_id() == request.owner_worker_id());
+    if (forward_borrower && memory_store_->GetIfExists(object_id) == nullptr &&
+        forwarded_tasks.insert(object_id.TaskId()).second) {
+      direct_task_submitter_->AddReturnObjectBorrower(object_id.TaskId(),
+                                                      request.borrower_address());
+    }
+    const bool is_freed = reference_counter_->IsPlasmaObjectFreed(object_id);
+    memory_store_->GetAsync(
+        object_id, [this, batch_id, object_id, is_freed,
+                    entry = std::move(entry)](std::shared_ptr<RayObject> obj) mutable {
+          if (is_freed) {
+            entry.mutable_status()->set_status(rpc::GetObjectStatusReply::FREED);
+          } else {
+            PopulateObjectStatus(object_id, obj, entry.mutable_status());
+          }
+          object_status_batches_.AddStatus(batch_id, std::move(entry));
+        });
+  }
+  object_status_batches_.Poll(batch_id, reply, std::move(send_reply_callback));
+
+  for (const auto &object_id : object_ids) {
+    RemoveLocalReference(object_id);
+  }
+}
+
+void CoreWorker::HandleAddReturnObjectBorrower(
+    const rpc::AddReturnObjectBorrowerRequest &request,
+    rpc::AddReturnObjectBorrowerReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    // If the task already finished, the borrower gets the values from the owner.
+    auto it = return_object_borrowers_.find(TaskID::FromBinary(request.task_id()));
+    if (it != return_object_borrowers_.end() &&
+        std::none_of(it->second.begin(), it->second.end(),
+                     [&request](const rpc::Address &borrower) {
+                       return borrower.worker_id() ==
+                              request.borrower_address().worker_id();
+                     })) {
+      it->second.push_back(request.borrower_address());
+    }
+  }
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void CoreWorker::HandlePushReturnObjects(const rpc::PushReturnObjectsRequest &request,
+                                         rpc::PushReturnObjectsReply *reply,
+                                         rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  future_resolver_->ProcessPushedReturnObjects(request.owner_address(),
+                                               request.return_objects());
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void CoreWorker::HandleReportGeneratorItemReturns(
+    const rpc::ReportGeneratorItemReturnsRequest &request,
+    rpc::ReportGeneratorItemReturnsReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  // Values that the owner no longer wants are dropped, which the executor doesn't need
+  // to know about.
+  task_manager_->HandleReportGeneratorItemReturns(request);
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void CoreWorker::PushReturnObjectsToBorrowers(const TaskID &task_id,
+                                              const rpc::Address &owner_address,
+                                              const Status &status,
+                                              const rpc::PushTaskReply &reply) {
+  std::vector<rpc::Address> borrowers;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = return_object_borrowers_.find(task_id);
+    if (it == return_object_borrowers_.end()) {
+      return;
+    }
+    borrowers = std::move(it->second);
+    return_object_borrowers_.erase(it);
+  }
+  // The owner may retry a task that failed, so only the values of successful tasks
+  // are final.
+  if (borrowers.empty() || !status.ok() || reply.is_application_level_error()) {
+    return;
+  }
+
+  rpc::PushReturnObjectsRequest request;
+  request.mutable_owner_address()->CopyFrom(owner_address);
+  for (const auto &return_object : reply.return_objects()) {
+    // Objects with nested references go through the owner, which must learn about the
+    // nested references before a borrower can use them.
+    if (!return_object.in_plasma() && return_object.nested_inlined_refs_size() == 0) {
+      request.add_return_objects()->CopyFrom(return_object);
+    }
+  }
+  if (request.return_objects_size() == 0) {
+    return;
+  }
+  for (const auto &borrower : borrowers) {
+    RAY_LOG(DEBUG) << "Pushing " << request.return_objects_size()
+                   << " return objects of task " << task_id << " to borrower "
+                   << WorkerID::FromBinary(borrower.worker_id());
+    request.set_intended_worker_id(borrower.worker_id());
+    core_worker_client_pool_->GetOrConnect(borrower)->PushReturnObjects(request,
+                                                                        nullptr);
+  }
+}
+
 void CoreWorker::PopulateObjectStatus(const ObjectID &object_id,
                                       std::shared_ptr<RayObject> obj,
                                       rpc::GetObjectStatusReply *reply) {
@@ -2999,6 +3450,9 @@ void CoreWorker::HandleGetCoreWorkerStats(const rpc::GetCoreWorkerStatsRequest &
   // TODO(swang): Differentiate between tasks that are currently pending
   // execution and tasks that have finished but may be retried.
   stats->set_num_pending_tasks(task_manager_->NumSubmissibleTasks());
+  stats->set_num_lineage_tasks(task_manager_->NumLineageTasks());
+  stats->set_lineage_bytes(task_manager_->NumLineageBytes());
+  stats->set_num_lineage_evictions(task_manager_->NumLineageEvictions());
   stats->set_task_queue_length(task_queue_length_);
   stats->set_num_executed_tasks(num_executed_tasks_);
   stats->set_num_object_refs_in_scope(reference_counter_->NumObjectIDsInScope());
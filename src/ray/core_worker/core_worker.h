@@ -19,6 +19,7 @@
 #include "ray/common/asio/periodical_runner.h"
 #include "ray/common/buffer.h"
 #include "ray/common/placement_group.h"
+#include "ray/common/task/task_event_buffer.h"
 #include "ray/core_worker/actor_handle.h"
 #include "ray/core_worker/actor_manager.h"
 #include "ray/core_worker/common.h"
@@ -29,8 +30,11 @@
 #include "ray/core_worker/object_recovery_manager.h"
 #include "ray/core_worker/profiling.h"
 #include "ray/core_worker/reference_count.h"
+#include "ray/core_worker/store_provider/as_completed_get.h"
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
 #include "ray/core_worker/store_provider/plasma_store_provider.h"
+#include "ray/core_worker/object_status_batches.h"
+#include "ray/core_worker/transport/actor_task_batch_results.h"
 #include "ray/core_worker/transport/direct_actor_transport.h"
 #include "ray/core_worker/transport/direct_task_transport.h"
 #include "ray/gcs/gcs_client/gcs_client.h"
@@ -429,6 +433,14 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
     }
   }
 
+  bool GetCurrentTaskIsStreamingGenerator() const {
+    if (!options_.is_local_mode) {
+      return worker_context_.GetCurrentTask()->IsStreamingGenerator();
+    } else {
+      return false;
+    }
+  }
+
   void SetWebuiDisplay(const std::string &key, const std::string &message);
 
   void SetActorTitle(const std::string &title);
@@ -616,6 +628,34 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   Status Get(const std::vector<ObjectID> &ids, const int64_t timeout_ms,
              std::vector<std::shared_ptr<RayObject>> *results);
 
+  /// Get a list of objects in the order in which they become available, so that the
+  /// caller can consume the objects that are ready while the rest are still being
+  /// fetched. The returned get must only be used on the calling thread.
+  ///
+  /// \param[in] ids IDs of the objects to get.
+  /// \return The get, whose Next() returns the objects as they become available.
+  std::unique_ptr<AsCompletedGet> GetAsCompleted(const std::vector<ObjectID> &ids);
+
+  /// Read the next value of a streaming generator task that this worker submitted,
+  /// waiting until the task reports it. The caller takes over the local reference to
+  /// the value.
+  ///
+  /// \param[in] generator_id The return object ID of the task.
+  /// \param[in] timeout_ms Timeout in milliseconds, wait infinitely if it's negative.
+  /// \param[out] object_id The next value, or nil at the end of the stream.
+  /// \param[out] end_of_stream Whether the task finished or failed and all of its
+  /// values were read. The task's return object then holds its result or error.
+  /// \return Status::TimedOut if no value was reported in time, or NotFound if the
+  /// stream was deleted.
+  Status ReadObjectRefStream(const ObjectID &generator_id, int64_t timeout_ms,
+                             ObjectID *object_id, bool *end_of_stream);
+
+  /// Stop consuming the values of a streaming generator task. The values that
+  /// weren't read are released, and values that the task reports later are dropped.
+  ///
+  /// \param[in] generator_id The return object ID of the task.
+  void DelObjectRefStream(const ObjectID &generator_id);
+
   /// Get objects directly from the local plasma store, without waiting for the
   /// objects to be fetched from another node. This should only be used
   /// internally, never by user code.
@@ -876,6 +916,26 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   Status SealReturnObject(const ObjectID &return_id,
                           std::shared_ptr<RayObject> return_object);
 
+  /// Allocate the ID of a value of the executing streaming generator task. The
+  /// value is then allocated and sealed like a return object with
+  /// AllocateReturnObject() and SealReturnObject().
+  ///
+  /// \return The object ID of the value.
+  ObjectID AllocateDynamicReturnId();
+
+  /// Report a value of the executing streaming generator task to the caller, which
+  /// owns the value. This blocks until the caller stored the value, so that a task
+  /// that produces values faster than they can be transferred is throttled, and all
+  /// of the values reach the caller before the task finishes.
+  ///
+  /// \param[in] object_id Object ID of the value, see AllocateDynamicReturnId().
+  /// \param[in] object The sealed value, or nullptr if it already existed.
+  /// \param[in] item_index The index of the value in the stream.
+  /// \return Status.
+  Status ReportGeneratorItemReturns(const ObjectID &object_id,
+                                    const std::shared_ptr<RayObject> &object,
+                                    int64_t item_index);
+
   /// Get a handle to an actor.
   ///
   /// NOTE: This function should be called ONLY WHEN we know actor handle exists.
@@ -918,6 +978,10 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   void HandlePushTask(const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
                       rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandlePushTasks(const rpc::PushTasksRequest &request, rpc::PushTasksReply *reply,
+                       rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleStealTasks(const rpc::StealTasksRequest &request,
                         rpc::StealTasksReply *reply,
@@ -934,6 +998,27 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                              rpc::GetObjectStatusReply *reply,
                              rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandleGetObjectStatusBatch(const rpc::GetObjectStatusBatchRequest &request,
+                                  rpc::GetObjectStatusBatchReply *reply,
+                                  rpc::SendReplyCallback send_reply_callback) override;
+
+  /// Implements gRPC server handler.
+  void HandleAddReturnObjectBorrower(const rpc::AddReturnObjectBorrowerRequest &request,
+                                     rpc::AddReturnObjectBorrowerReply *reply,
+                                     rpc::SendReplyCallback send_reply_callback) override;
+
+  /// Implements gRPC server handler.
+  void HandlePushReturnObjects(const rpc::PushReturnObjectsRequest &request,
+                               rpc::PushReturnObjectsReply *reply,
+                               rpc::SendReplyCallback send_reply_callback) override;
+
+  /// Implements gRPC server handler.
+  void HandleReportGeneratorItemReturns(
+      const rpc::ReportGeneratorItemReturnsRequest &request,
+      rpc::ReportGeneratorItemReturnsReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleWaitForActorOutOfScope(const rpc::WaitForActorOutOfScopeRequest &request,
                                     rpc::WaitForActorOutOfScopeReply *reply,
@@ -1067,6 +1152,17 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
       const std::string &debugger_breakpoint, const std::string &serialized_runtime_env,
       const std::vector<std::string> &runtime_env_uris,
       const std::string &concurrency_group_name = "");
+
+  /// Set the fields of a task spec that is built from a template that differ per call.
+  ///
+  /// \param builder The builder that was created from the template.
+  /// \param task_id The ID of the task.
+  /// \param task_index The index of the task in the current task.
+  /// \param args The arguments of the task.
+  void SetCallSpecificFields(TaskSpecBuilder &builder, const TaskID &task_id,
+                             uint64_t task_index,
+                             const std::vector<std::unique_ptr<TaskArg>> &args);
+
   void SetCurrentTaskId(const TaskID &task_id);
 
   void SetActorId(const ActorID &actor_id);
@@ -1093,6 +1189,25 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   void PopulateObjectStatus(const ObjectID &object_id, std::shared_ptr<RayObject> obj,
                             rpc::GetObjectStatusReply *reply);
 
+  /// Push the return values of a finished task that are small enough to be inlined to
+  /// the borrowers that the owner forwarded to us, see AddReturnObjectBorrower.
+  ///
+  /// \param[in] task_id The ID of the task.
+  /// \param[in] owner_address The address of the owner of the task's return objects.
+  /// \param[in] status The status of the task's reply to the owner.
+  /// \param[in] reply The task's reply to the owner.
+  void PushReturnObjectsToBorrowers(const TaskID &task_id,
+                                    const rpc::Address &owner_address,
+                                    const Status &status,
+                                    const rpc::PushTaskReply &reply);
+
+  /// Notify the raylet that the executing task blocked or unblocked in a get, so
+  /// that it can release and reacquire the task's resources. This only applies to
+  /// non-actor tasks on the main thread.
+  ///
+  /// \param[in] blocked Whether the task blocked or unblocked.
+  void NotifyTaskBlocked(bool blocked);
+
   ///
   /// Private methods related to task submission.
   ///
@@ -1136,6 +1251,13 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                      ReferenceCounter::ReferenceTableProto *borrowed_refs,
                      bool *is_application_level_error);
 
+  /// Record a task event in the task event buffer, if it's enabled.
+  void RecordTaskEvent(TaskEventType event_type, const TaskID &task_id) {
+    if (task_event_buffer_) {
+      task_event_buffer_->Record(event_type, task_id);
+    }
+  }
+
   /// Put an object in the local plasma store.
   Status PutInLocalPlasmaStore(const RayObject &object, const ObjectID &object_id,
                                bool pin_object);
@@ -1386,6 +1508,17 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// Actor title that consists of class name, args, kwargs for actor construction.
   std::string actor_title_ GUARDED_BY(mutex_);
 
+  /// The borrowers waiting for the return values of the normal tasks that were pushed
+  /// to us, if `push_small_returns_to_borrowers` is enabled.
+  absl::flat_hash_map<TaskID, std::vector<rpc::Address>> return_object_borrowers_
+      GUARDED_BY(mutex_);
+
+  /// The results of the batches of actor tasks that were pushed to us.
+  ActorTaskBatchResults actor_task_batch_results_;
+
+  /// The statuses of the batches of our objects that borrowers asked about.
+  ObjectStatusBatches object_status_batches_;
+
   /// Number of tasks that have been pushed to the actor but not executed.
   std::atomic<int64_t> task_queue_length_;
 
@@ -1395,6 +1528,10 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// Profiler including a background thread that pushes profiling events to the GCS.
   std::shared_ptr<worker::Profiler> profiler_;
 
+  /// Task state transitions of this worker, in shared memory for the raylet and the
+  /// dashboard agent to read. Nullptr if disabled.
+  std::unique_ptr<TaskEventBuffer> task_event_buffer_;
+
   /// A map from resource name to the resource IDs that are currently reserved
   /// for this worker. Each pair consists of the resource ID and the fraction
   /// of that resource allocated for this worker. This is set on task assignment.
@@ -1446,6 +1583,9 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
 
   std::unique_ptr<rpc::JobConfig> job_config_;
 
+  /// Templates of the specs of the functions and actor methods that this worker calls.
+  TaskSpecTemplateCache task_spec_templates_;
+
   /// Simple container for per function task counters. The counters will be
   /// keyed by the function name in task spec.
   struct TaskCounter {
@@ -24,16 +24,146 @@ void FutureResolver::ResolveFutureAsync(const ObjectID &object_id,
     // with a borrowed reference executes on the object's owning worker.
     return;
   }
-  auto conn = owner_clients_->GetOrConnect(owner_address);
-
-  rpc::GetObjectStatusRequest request;
-  request.set_object_id(object_id.Binary());
-  request.set_owner_worker_id(owner_address.worker_id());
-  conn->GetObjectStatus(
-      request, [this, object_id, owner_address](const Status &status,
-                                                const rpc::GetObjectStatusReply &reply) {
-        ProcessResolvedObject(object_id, owner_address, status, reply);
-      });
+  const auto owner_id = WorkerID::FromBinary(owner_address.worker_id());
+  absl::MutexLock lock(&mu_);
+  auto &owner = owners_[owner_id];
+  owner.address = owner_address;
+  if (owner.pending.insert(object_id).second) {
+    RequestObjectStatusesLocked(owner, owner_id, {object_id});
+  }
+}
+
+void FutureResolver::RequestObjectStatusesLocked(
+    OwnerState &owner, const WorkerID &owner_id,
+    const std::vector<ObjectID> &object_ids) {
+  owner.to_request.insert(owner.to_request.end(), object_ids.begin(), object_ids.end());
+  if (!owner.send_scheduled) {
+    // Futures that are resolved until the event loop gets to the send are batched.
+    owner.send_scheduled = true;
+    io_service_.post([this, owner_id] { SendObjectStatusRequests(owner_id); },
+                     "FutureResolver.SendObjectStatusRequests");
+  }
+}
+
+void FutureResolver::SendObjectStatusRequests(const WorkerID &owner_id) {
+  std::vector<rpc::GetObjectStatusBatchRequest> requests;
+  std::vector<std::shared_ptr<absl::flat_hash_set<ObjectID>>> batches;
+  rpc::Address owner_address;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = owners_.find(owner_id);
+    if (it == owners_.end()) {
+      return;
+    }
+    auto &owner = it->second;
+    owner.send_scheduled = false;
+    if (owner.pending.empty()) {
+      owners_.erase(it);
+      return;
+    }
+    owner_address = owner.address;
+    for (const auto &object_id : owner.to_request) {
+      if (!owner.pending.contains(object_id)) {
+        continue;
+      }
+      if (batches.empty() ||
+          static_cast<int64_t>(batches.back()->size()) == batch_size_) {
+        batches.push_back(std::make_shared<absl::flat_hash_set<ObjectID>>());
+        requests.emplace_back();
+        requests.back().set_owner_worker_id(owner.address.worker_id());
+        requests.back().mutable_borrower_address()->CopyFrom(rpc_address_);
+        requests.back().set_batch_id(UniqueID::FromRandom().Binary());
+      }
+      batches.back()->insert(object_id);
+      requests.back().add_object_ids(object_id.Binary());
+    }
+    owner.to_request.clear();
+  }
+
+  for (size_t i = 0; i < requests.size(); i++) {
+    SendObjectStatusRequest(owner_address, requests[i], std::move(batches[i]));
+  }
+}
+
+void FutureResolver::SendObjectStatusRequest(
+    const rpc::Address &owner_address, const rpc::GetObjectStatusBatchRequest &request,
+    std::shared_ptr<absl::flat_hash_set<ObjectID>> unreported) {
+  owner_clients_->GetOrConnect(owner_address)
+      ->GetObjectStatusBatch(
+          request, [this, owner_address, batch_id = request.batch_id(), unreported](
+                       const Status &status,
+                       const rpc::GetObjectStatusBatchReply &reply) {
+            OnObjectStatusBatchReply(owner_address, batch_id, unreported, status, reply);
+          });
+}
+
+void FutureResolver::OnObjectStatusBatchReply(
+    const rpc::Address &owner_address, const std::string &batch_id,
+    std::shared_ptr<absl::flat_hash_set<ObjectID>> unreported, const Status &status,
+    const rpc::GetObjectStatusBatchReply &reply) {
+  const auto owner_id = WorkerID::FromBinary(owner_address.worker_id());
+  if (!status.ok()) {
+    for (const auto &object_id : *unreported) {
+      if (TakePendingFuture(owner_id, object_id)) {
+        ProcessResolvedObject(object_id, owner_address, status,
+                              rpc::GetObjectStatusReply());
+      }
+    }
+    return;
+  }
+
+  for (const auto &entry : reply.statuses()) {
+    const auto object_id = ObjectID::FromBinary(entry.object_id());
+    unreported->erase(object_id);
+    if (TakePendingFuture(owner_id, object_id)) {
+      ProcessResolvedObject(object_id, owner_address, status, entry.status());
+    }
+  }
+
+  if (!unreported->empty()) {
+    // The owner replies once some of the objects are available, and keeps the rest.
+    // Poll for them even if they were resolved otherwise, so that the owner can drop
+    // the batch.
+    rpc::GetObjectStatusBatchRequest poll;
+    poll.set_owner_worker_id(owner_address.worker_id());
+    poll.set_batch_id(batch_id);
+    SendObjectStatusRequest(owner_address, poll, std::move(unreported));
+  }
+}
+
+bool FutureResolver::TakePendingFuture(const WorkerID &owner_id,
+                                       const ObjectID &object_id) {
+  absl::MutexLock lock(&mu_);
+  auto it = owners_.find(owner_id);
+  if (it == owners_.end() || it->second.pending.erase(object_id) == 0) {
+    return false;
+  }
+  if (it->second.pending.empty() && !it->second.send_scheduled) {
+    owners_.erase(it);
+  }
+  return true;
+}
+
+void FutureResolver::ProcessPushedReturnObjects(
+    const rpc::Address &owner_address,
+    const google::protobuf::RepeatedPtrField<rpc::ReturnObject> &return_objects) {
+  const auto owner_id = WorkerID::FromBinary(owner_address.worker_id());
+  for (const auto &return_object : return_objects) {
+    const auto object_id = ObjectID::FromBinary(return_object.object_id());
+    if (return_object.in_plasma() || !TakePendingFuture(owner_id, object_id)) {
+      continue;
+    }
+    RAY_LOG(DEBUG) << "Object " << object_id
+                   << " was pushed by the worker that created it";
+    rpc::GetObjectStatusReply object_status;
+    object_status.set_status(rpc::GetObjectStatusReply::CREATED);
+    object_status.mutable_object()->set_data(return_object.data());
+    object_status.mutable_object()->set_metadata(return_object.metadata());
+    object_status.mutable_object()->mutable_nested_inlined_refs()->CopyFrom(
+        return_object.nested_inlined_refs());
+    object_status.set_object_size(return_object.size());
+    ProcessResolvedObject(object_id, owner_address, Status::OK(), object_status);
+  }
 }
 
 void FutureResolver::ProcessResolvedObject(const ObjectID &object_id,
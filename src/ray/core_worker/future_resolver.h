@@ -14,10 +14,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/grpc_util.h"
 #include "ray/common/id.h"
+#include "ray/common/ray_config.h"
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
 #include "ray/rpc/worker/core_worker_client.h"
 #include "ray/rpc/worker/core_worker_client_pool.h"
@@ -37,18 +45,26 @@ class FutureResolver {
                  std::shared_ptr<ReferenceCounter> ref_counter,
                  ReportLocalityDataCallback report_locality_data_callback,
                  std::shared_ptr<rpc::CoreWorkerClientPool> core_worker_client_pool,
-                 const rpc::Address &rpc_address)
+                 const rpc::Address &rpc_address, instrumented_io_context &io_service)
       : in_memory_store_(store),
         reference_counter_(ref_counter),
         report_locality_data_callback_(std::move(report_locality_data_callback)),
         owner_clients_(core_worker_client_pool),
-        rpc_address_(rpc_address) {}
+        rpc_address_(rpc_address),
+        io_service_(io_service),
+        batch_size_(std::max<int64_t>(
+            RayConfig::instance().get_object_status_batch_size(), 1)) {}
 
   /// Resolve the value for a future. This will periodically contact the given
   /// owner until the owner dies or the owner has finished creating the object.
   /// In either case, this will put an OBJECT_IN_PLASMA error as the future's
   /// value.
   ///
+  /// The futures of the same owner that are resolved at the same time are
+  /// batched into one GetObjectStatusBatch request of up to
+  /// `get_object_status_batch_size` objects. The owner keeps the objects of the
+  /// batch, and we poll it for their statuses until we received all of them.
+  ///
   /// \param[in] object_id The ID of the future to resolve.
   /// \param[in] owner_address The address of the task or actor that owns the
   /// future.
@@ -64,7 +80,58 @@ class FutureResolver {
                              const Status &status,
                              const rpc::GetObjectStatusReply &object_status);
 
+  /// Process the return values of a task that the worker executing the task pushed
+  /// to us directly. Objects that we aren't resolving are ignored.
+  ///
+  /// \param[in] owner_address The address of the owner of the objects.
+  /// \param[in] return_objects The return values of the task.
+  void ProcessPushedReturnObjects(
+      const rpc::Address &owner_address,
+      const google::protobuf::RepeatedPtrField<rpc::ReturnObject> &return_objects);
+
  private:
+  /// The futures of an owner that we are resolving.
+  struct OwnerState {
+    /// The address of the owner.
+    rpc::Address address;
+    /// The futures that aren't resolved yet.
+    absl::flat_hash_set<ObjectID> pending;
+    /// The pending futures that we need to ask the owner about.
+    std::vector<ObjectID> to_request;
+    /// Whether sending the requests for `to_request` is scheduled.
+    bool send_scheduled = false;
+  };
+
+  /// Ask the owner about the futures that are queued for it.
+  void SendObjectStatusRequests(const WorkerID &owner_id);
+
+  /// Queue pending futures to ask the owner about.
+  void RequestObjectStatusesLocked(OwnerState &owner, const WorkerID &owner_id,
+                                   const std::vector<ObjectID> &object_ids)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Send a GetObjectStatusBatch request, and poll the owner for the rest of the
+  /// batch until it sent the status of every object of the batch.
+  ///
+  /// \param[in] owner_address The address of the owner.
+  /// \param[in] request The request for the batch, or the poll for its rest.
+  /// \param[in] unreported The objects of the batch whose status we didn't receive.
+  void SendObjectStatusRequest(
+      const rpc::Address &owner_address, const rpc::GetObjectStatusBatchRequest &request,
+      std::shared_ptr<absl::flat_hash_set<ObjectID>> unreported);
+
+  /// Handle the reply of a GetObjectStatusBatch request.
+  void OnObjectStatusBatchReply(
+      const rpc::Address &owner_address, const std::string &batch_id,
+      std::shared_ptr<absl::flat_hash_set<ObjectID>> unreported, const Status &status,
+      const rpc::GetObjectStatusBatchReply &reply);
+
+  /// Stop tracking a future of an owner.
+  ///
+  /// \return Whether the future was pending, in which case the caller must process
+  /// its value.
+  bool TakePendingFuture(const WorkerID &owner_id, const ObjectID &object_id);
+
   /// Used to store values of resolved futures.
   std::shared_ptr<CoreWorkerMemoryStore> in_memory_store_;
 
@@ -81,6 +148,17 @@ class FutureResolver {
   /// address, so the owner can contact us to ask when our reference to the
   /// object has gone out of scope.
   const rpc::Address rpc_address_;
+
+  /// Event loop where the batched requests are sent.
+  instrumented_io_context &io_service_;
+
+  /// The maximum number of futures to ask an owner about in one request.
+  const int64_t batch_size_;
+
+  absl::Mutex mu_;
+
+  /// The owners of the futures that we are resolving.
+  absl::flat_hash_map<WorkerID, OwnerState> owners_ GUARDED_BY(mu_);
 };
 
 }  // namespace core
@@ -0,0 +1,112 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/lineage_log.h"
+
+#include "ray/util/logging.h"
+
+namespace ray {
+namespace core {
+
+void LineageLog::Add(const TaskSpecification &spec) {
+  const auto &message = spec.GetMessage();
+  Entry entry;
+  rpc::TaskSpec own_fields;
+  own_fields.set_task_id(message.task_id());
+  own_fields.set_parent_counter(message.parent_counter());
+  if (message.has_actor_task_spec()) {
+    own_fields.mutable_actor_task_spec()->CopyFrom(message.actor_task_spec());
+  }
+  for (int i = 0; i < message.args_size(); i++) {
+    const auto &arg = message.args(i);
+    if (arg.data().size() + arg.metadata().size() >= kMinSharedArgBytes) {
+      own_fields.add_args();
+      entry.shared_args.emplace_back(i, Share(arg.SerializeAsString()));
+    } else {
+      own_fields.add_args()->CopyFrom(arg);
+    }
+  }
+  entry.own_fields = own_fields.SerializeAsString();
+
+  rpc::TaskSpec shared_fields;
+  shared_fields.CopyFrom(message);
+  shared_fields.clear_task_id();
+  shared_fields.clear_parent_counter();
+  shared_fields.clear_actor_task_spec();
+  shared_fields.clear_args();
+  entry.shared_fields = Share(shared_fields.SerializeAsString());
+
+  num_bytes_ += entry.own_fields.size();
+  entry.order = order_.insert(order_.end(), spec.TaskId());
+  RAY_CHECK(entries_.emplace(spec.TaskId(), std::move(entry)).second)
+      << "Task " << spec.TaskId() << " is already in the lineage log";
+}
+
+bool LineageLog::Get(const TaskID &task_id, TaskSpecification *spec) const {
+  auto it = entries_.find(task_id);
+  if (it == entries_.end()) {
+    return false;
+  }
+  // The own fields only set the fields that the shared ones leave empty, so merging
+  // them restores the spec.
+  rpc::TaskSpec message;
+  RAY_CHECK(message.ParseFromString(*it->second.shared_fields));
+  RAY_CHECK(message.MergeFromString(it->second.own_fields));
+  for (const auto &shared_arg : it->second.shared_args) {
+    auto arg = message.mutable_args(shared_arg.first);
+    RAY_CHECK(arg->ParseFromString(*shared_arg.second));
+  }
+  *spec = TaskSpecification(std::move(message));
+  return true;
+}
+
+bool LineageLog::Remove(const TaskID &task_id) {
+  auto it = entries_.find(task_id);
+  if (it == entries_.end()) {
+    return false;
+  }
+  num_bytes_ -= it->second.own_fields.size();
+  Unshare(it->second.shared_fields);
+  for (const auto &shared_arg : it->second.shared_args) {
+    Unshare(shared_arg.second);
+  }
+  order_.erase(it->second.order);
+  entries_.erase(it);
+  return true;
+}
+
+TaskID LineageLog::Oldest() const {
+  return order_.empty() ? TaskID::Nil() : order_.front();
+}
+
+const std::string *LineageLog::Share(std::string value) {
+  auto it = shared_.emplace(std::move(value), 0).first;
+  if (it->second == 0) {
+    num_bytes_ += it->first.size();
+  }
+  it->second++;
+  return &it->first;
+}
+
+void LineageLog::Unshare(const std::string *value) {
+  auto it = shared_.find(*value);
+  RAY_CHECK(it != shared_.end());
+  if (--it->second == 0) {
+    num_bytes_ -= it->first.size();
+    shared_.erase(it);
+  }
+}
+
+}  // namespace core
+}  // namespace ray
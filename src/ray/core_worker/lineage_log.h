@@ -0,0 +1,107 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/common/id.h"
+#include "ray/common/task/task_spec.h"
+
+namespace ray {
+namespace core {
+
+/// The specs of finished tasks that are kept as lineage, so that the tasks can be
+/// resubmitted to reconstruct their return values. The specs are stored serialized,
+/// which is much smaller than the parsed protobuf. The fields that the tasks
+/// submitted by the same caller for the same function have in common, e.g. the
+/// function descriptor, resources, and runtime env, are stored once for all of these
+/// tasks. Large inlined arguments are stored once as well, which is common for
+/// iterative workloads that pass the same value to many tasks.
+///
+/// This class is not thread-safe.
+class LineageLog {
+ public:
+  /// Add the spec of a task. The task must not be in the log yet.
+  ///
+  /// \param[in] spec The spec of the task.
+  void Add(const TaskSpecification &spec);
+
+  /// Get the spec of a task.
+  ///
+  /// \param[in] task_id The ID of the task.
+  /// \param[out] spec The spec of the task.
+  /// \return Whether the task is in the log.
+  bool Get(const TaskID &task_id, TaskSpecification *spec) const;
+
+  /// Remove a task from the log.
+  ///
+  /// \param[in] task_id The ID of the task.
+  /// \return Whether the task was in the log.
+  bool Remove(const TaskID &task_id);
+
+  /// \return The task that was added first, or nil if the log is empty.
+  TaskID Oldest() const;
+
+  /// \return The number of bytes of the serialized specs, where the fields that are
+  /// shared by several tasks are counted once.
+  int64_t NumBytes() const { return num_bytes_; }
+
+  /// \return The number of tasks in the log.
+  size_t Size() const { return entries_.size(); }
+
+ private:
+  /// Inlined arguments of at least this size are stored once for all tasks.
+  static constexpr size_t kMinSharedArgBytes = 256;
+
+  struct Entry {
+    /// The serialized fields that only this task has. Shared arguments are empty
+    /// placeholders here.
+    std::string own_fields;
+    /// The serialized fields that this task shares with other tasks.
+    const std::string *shared_fields;
+    /// The serialized shared arguments, by their index in the task's arguments.
+    std::vector<std::pair<int, const std::string *>> shared_args;
+    /// The position of the task in insertion order.
+    std::list<TaskID>::iterator order;
+  };
+
+  /// Store a serialized value once for all tasks that contain it.
+  ///
+  /// \return A pointer to the stored value, which stays valid until the last task
+  /// that contains it is removed.
+  const std::string *Share(std::string value);
+
+  /// Release the reference of a task to a shared value.
+  void Unshare(const std::string *value);
+
+  absl::flat_hash_map<TaskID, Entry> entries_;
+
+  /// The task IDs in the order in which they were added.
+  std::list<TaskID> order_;
+
+  /// The shared values and the number of tasks that contain them. A node based map,
+  /// so that entries can point to the keys.
+  std::unordered_map<std::string, int64_t> shared_;
+
+  int64_t num_bytes_ = 0;
+};
+
+}  // namespace core
+}  // namespace ray
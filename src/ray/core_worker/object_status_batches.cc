@@ -0,0 +1,111 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/object_status_batches.h"
+
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+namespace ray {
+namespace core {
+
+void ObjectStatusBatches::AddBatch(const std::string &batch_id, int num_objects) {
+  absl::MutexLock lock(&mu_);
+  auto inserted = batches_.emplace(batch_id, Batch(num_objects));
+  RAY_CHECK(inserted.second) << "Received a batch of objects twice";
+  inserted.first->second.last_reply_ms = current_time_ms();
+}
+
+void ObjectStatusBatches::AddStatus(const std::string &batch_id,
+                                    rpc::ObjectStatusEntry entry) {
+  rpc::SendReplyCallback send_reply_callback;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = batches_.find(batch_id);
+    if (it == batches_.end()) {
+      // The batch was abandoned.
+      return;
+    }
+    RAY_CHECK(it->second.num_pending > 0);
+    it->second.num_pending--;
+    it->second.ready.push_back(std::move(entry));
+    send_reply_callback = TakeReadyStatuses(it);
+  }
+  if (send_reply_callback) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+}
+
+void ObjectStatusBatches::Poll(const std::string &batch_id,
+                               rpc::GetObjectStatusBatchReply *reply,
+                               rpc::SendReplyCallback send_reply_callback) {
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = batches_.find(batch_id);
+    if (it != batches_.end() && it->second.reply == nullptr) {
+      it->second.reply = reply;
+      it->second.send_reply_callback = std::move(send_reply_callback);
+      send_reply_callback = TakeReadyStatuses(it);
+    }
+  }
+  if (send_reply_callback) {
+    // Either statuses are ready, or the poll doesn't match a batch, e.g., because
+    // the batch was abandoned.
+    send_reply_callback(
+        reply->statuses_size() > 0 ? Status::OK()
+                                   : Status::Invalid("Unknown batch of objects"),
+        nullptr, nullptr);
+  }
+}
+
+void ObjectStatusBatches::EraseAbandonedBatches(int64_t timeout_ms) {
+  const int64_t now_ms = current_time_ms();
+  absl::MutexLock lock(&mu_);
+  for (auto it = batches_.begin(); it != batches_.end();) {
+    auto current = it++;
+    if (current->second.reply == nullptr &&
+        now_ms - current->second.last_reply_ms > timeout_ms) {
+      RAY_LOG(DEBUG) << "Erasing a batch of " << current->second.num_pending
+                     << " pending objects whose borrower stopped polling";
+      batches_.erase(current);
+    }
+  }
+}
+
+size_t ObjectStatusBatches::NumBatches() const {
+  absl::MutexLock lock(&mu_);
+  return batches_.size();
+}
+
+rpc::SendReplyCallback ObjectStatusBatches::TakeReadyStatuses(
+    absl::flat_hash_map<std::string, Batch>::iterator it) {
+  auto &batch = it->second;
+  if (batch.reply == nullptr || batch.ready.empty()) {
+    return nullptr;
+  }
+  for (auto &entry : batch.ready) {
+    batch.reply->add_statuses()->Swap(&entry);
+  }
+  batch.ready.clear();
+  batch.reply = nullptr;
+  batch.last_reply_ms = current_time_ms();
+  auto send_reply_callback = std::move(batch.send_reply_callback);
+  if (batch.num_pending == 0) {
+    batches_.erase(it);
+  }
+  return send_reply_callback;
+}
+
+}  // namespace core
+}  // namespace ray
@@ -0,0 +1,99 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/status.h"
+#include "ray/rpc/server_call.h"
+#include "src/ray/protobuf/core_worker.pb.h"
+
+namespace ray {
+namespace core {
+
+/// The statuses of the batches of objects that borrowers asked their owner about in
+/// GetObjectStatusBatch RPCs. The owner keeps the objects of a batch that aren't
+/// available yet, and sends their statuses as they become available, in the reply of
+/// the RPC that asked for the batch or of a later one that polls for the rest. So the
+/// borrower sends each object ID once, and the owner waits for each object once.
+///
+/// This class is thread-safe.
+class ObjectStatusBatches {
+ public:
+  /// Add a batch of objects.
+  ///
+  /// \param[in] batch_id The ID of the batch.
+  /// \param[in] num_objects The number of objects of the batch.
+  void AddBatch(const std::string &batch_id, int num_objects);
+
+  /// Record the status of an object of a batch, and send it if the borrower is
+  /// waiting for it. Statuses of unknown batches are ignored.
+  ///
+  /// \param[in] batch_id The ID of the batch.
+  /// \param[in] entry The status of the object.
+  void AddStatus(const std::string &batch_id, rpc::ObjectStatusEntry entry);
+
+  /// Reply with the statuses of a batch that the borrower didn't receive yet, as soon
+  /// as there is at least one.
+  ///
+  /// \param[in] batch_id The ID of the batch.
+  /// \param[out] reply The reply to fill in.
+  /// \param[in] send_reply_callback The callback to send the reply.
+  void Poll(const std::string &batch_id, rpc::GetObjectStatusBatchReply *reply,
+            rpc::SendReplyCallback send_reply_callback);
+
+  /// Erase the batches whose borrower didn't poll for longer than the timeout after
+  /// the last reply, e.g., because the borrower died.
+  ///
+  /// \param[in] timeout_ms The timeout in milliseconds.
+  void EraseAbandonedBatches(int64_t timeout_ms);
+
+  /// \return The number of batches whose statuses haven't all been sent yet.
+  size_t NumBatches() const;
+
+ private:
+  struct Batch {
+    explicit Batch(int num_objects) : num_pending(num_objects) {}
+    /// The number of objects whose status isn't known yet.
+    int num_pending;
+    /// The statuses that weren't sent yet.
+    std::vector<rpc::ObjectStatusEntry> ready;
+    /// The reply of the pending poll, or nullptr if the borrower isn't polling.
+    rpc::GetObjectStatusBatchReply *reply = nullptr;
+    rpc::SendReplyCallback send_reply_callback;
+    /// When the last reply was sent.
+    int64_t last_reply_ms;
+  };
+
+  /// Move the ready statuses into the pending reply of the batch. The batch is erased
+  /// if all statuses were sent.
+  ///
+  /// \return The callback to send the reply, or nullptr if there is nothing to send
+  /// yet. It must be called without holding the lock.
+  rpc::SendReplyCallback TakeReadyStatuses(
+      absl::flat_hash_map<std::string, Batch>::iterator it)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  mutable absl::Mutex mu_;
+
+  absl::flat_hash_map<std::string, Batch> batches_ GUARDED_BY(mu_);
+};
+
+}  // namespace core
+}  // namespace ray
@@ -0,0 +1,179 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/store_provider/as_completed_get.h"
+
+#include <algorithm>
+
+#include "ray/common/ray_config.h"
+#include "ray/util/util.h"
+
+namespace ray {
+namespace core {
+
+AsCompletedGet::AsCompletedGet(const std::vector<ObjectID> &object_ids,
+                               CoreWorkerMemoryStore &memory_store,
+                               PlasmaFetchFunction plasma_fetch,
+                               PlasmaGetFunction plasma_get,
+                               std::function<void()> notify_blocked,
+                               std::function<void()> notify_done,
+                               std::function<Status()> check_signals)
+    : plasma_fetch_(std::move(plasma_fetch)),
+      plasma_get_(std::move(plasma_get)),
+      notify_blocked_(std::move(notify_blocked)),
+      notify_done_(std::move(notify_done)),
+      check_signals_(std::move(check_signals)),
+      completion_queue_(std::make_shared<CompletionQueue>()) {
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    indices_[object_ids[i]].push_back(i);
+  }
+  for (const auto &entry : indices_) {
+    // The memory store can't cancel the callback, so it only holds a weak reference
+    // in case the get is abandoned before the object is available.
+    std::weak_ptr<CompletionQueue> weak_queue = completion_queue_;
+    const ObjectID object_id = entry.first;
+    memory_store.GetAsync(object_id,
+                          [weak_queue, object_id](std::shared_ptr<RayObject> object) {
+                            auto queue = weak_queue.lock();
+                            if (queue == nullptr) {
+                              return;
+                            }
+                            absl::MutexLock lock(&queue->mu);
+                            queue->objects.emplace_back(object_id, std::move(object));
+                            queue->cv.Signal();
+                          });
+  }
+}
+
+AsCompletedGet::~AsCompletedGet() { Finish(); }
+
+Status AsCompletedGet::Next(int64_t timeout_ms, std::vector<ReadyObject> *ready) {
+  ready->clear();
+  const int64_t start_ms = current_time_ms();
+  Status status;
+  while (!Done()) {
+    status = DrainCompletionQueue(ready);
+    if (!status.ok() || !ready->empty()) {
+      break;
+    }
+
+    int64_t wait_ms = RayConfig::instance().get_timeout_milliseconds();
+    if (timeout_ms >= 0) {
+      int64_t remaining_ms = timeout_ms - (current_time_ms() - start_ms);
+      if (remaining_ms <= 0) {
+        status = Status::TimedOut("Get timed out: some object(s) not ready.");
+        break;
+      }
+      wait_ms = std::min(wait_ms, remaining_ms);
+    }
+
+    SetBlocked();
+    if (!plasma_pending_.empty()) {
+      // Poll the local plasma store on a short timeout, so that the objects that
+      // become available in the memory store meanwhile aren't held back by the
+      // slowest plasma fetch. The fetch stays open meanwhile.
+      wait_ms = std::min(
+          wait_ms, RayConfig::instance().get_as_completed_plasma_poll_milliseconds());
+      status = GetFromPlasma(
+          std::vector<ObjectID>(plasma_pending_.begin(), plasma_pending_.end()), wait_ms,
+          ready);
+    } else {
+      absl::MutexLock lock(&completion_queue_->mu);
+      if (completion_queue_->objects.empty()) {
+        completion_queue_->cv.WaitWithTimeout(&completion_queue_->mu,
+                                              absl::Milliseconds(wait_ms));
+      }
+    }
+    if (status.ok() && ready->empty() && check_signals_) {
+      status = check_signals_();
+    }
+    if (!status.ok() || !ready->empty()) {
+      break;
+    }
+  }
+  if (Done()) {
+    Finish();
+  }
+  return status;
+}
+
+Status AsCompletedGet::DrainCompletionQueue(std::vector<ReadyObject> *ready) {
+  std::deque<std::pair<ObjectID, std::shared_ptr<RayObject>>> objects;
+  {
+    absl::MutexLock lock(&completion_queue_->mu);
+    objects.swap(completion_queue_->objects);
+  }
+  std::vector<ObjectID> promoted;
+  for (auto &entry : objects) {
+    if (entry.second->IsInPlasmaError()) {
+      RAY_LOG(DEBUG) << entry.first << " in plasma, doing fetch-and-get";
+      if (plasma_pending_.insert(entry.first).second) {
+        promoted.push_back(entry.first);
+      }
+    } else {
+      AddReady(entry.first, entry.second, ready);
+    }
+  }
+  if (promoted.empty()) {
+    return Status::OK();
+  }
+  // Start fetching the promoted objects right away, so that the pulls overlap with
+  // the frontend consuming the objects that are ready.
+  fetched_ = true;
+  RAY_RETURN_NOT_OK(plasma_fetch_(promoted));
+  return GetFromPlasma(promoted, 0, ready);
+}
+
+Status AsCompletedGet::GetFromPlasma(const std::vector<ObjectID> &object_ids,
+                                     int64_t timeout_ms,
+                                     std::vector<ReadyObject> *ready) {
+  absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> results;
+  RAY_RETURN_NOT_OK(plasma_get_(object_ids, timeout_ms, &results));
+  for (const auto &entry : results) {
+    plasma_pending_.erase(entry.first);
+    AddReady(entry.first, entry.second, ready);
+  }
+  return Status::OK();
+}
+
+void AsCompletedGet::AddReady(const ObjectID &object_id,
+                              const std::shared_ptr<RayObject> &object,
+                              std::vector<ReadyObject> *ready) {
+  auto it = indices_.find(object_id);
+  if (it == indices_.end()) {
+    return;
+  }
+  for (size_t index : it->second) {
+    ready->emplace_back(index, object);
+  }
+  indices_.erase(it);
+}
+
+void AsCompletedGet::SetBlocked() {
+  if (!blocked_ && notify_blocked_ != nullptr) {
+    notify_blocked_();
+  }
+  blocked_ = true;
+}
+
+void AsCompletedGet::Finish() {
+  if ((blocked_ || fetched_) && notify_done_ != nullptr) {
+    notify_done_();
+  }
+  blocked_ = false;
+  fetched_ = false;
+}
+
+}  // namespace core
+}  // namespace ray
@@ -0,0 +1,145 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/id.h"
+#include "ray/common/ray_object.h"
+#include "ray/common/status.h"
+#include "ray/core_worker/store_provider/memory_store/memory_store.h"
+
+namespace ray {
+namespace core {
+
+/// A get of many objects that hands out the objects in the order in which they become
+/// available, instead of blocking until all of them are. This lets the language
+/// frontend deserialize the objects that are ready while the rest are still being
+/// computed or fetched.
+///
+/// The objects are waited for in the memory store, and the ones that were promoted to
+/// plasma are fetched as soon as the memory store reports them, so that all pulls are
+/// in flight while the frontend consumes the results. The fetch stays open until the
+/// get ends, and the fetched objects are waited for in the local plasma store only, so
+/// polling them doesn't interrupt their pulls. Likewise, the worker stays blocked from
+/// the first wait until the get ends, also while the frontend consumes the results.
+///
+/// Not thread safe: Next() must be called, and the get destroyed, on the thread that
+/// created the get, since plasma gets depend on the worker context of that thread.
+class AsCompletedGet {
+ public:
+  /// Add objects to the fetch that stays open until the get ends, see
+  /// CoreWorkerPlasmaStoreProvider::Fetch.
+  using PlasmaFetchFunction =
+      std::function<Status(const std::vector<ObjectID> &object_ids)>;
+
+  /// Get objects from the local plasma store, see
+  /// CoreWorkerPlasmaStoreProvider::GetFromLocalStore.
+  using PlasmaGetFunction = std::function<Status(
+      const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
+      absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results)>;
+
+  /// A ready object and its index in the requested IDs.
+  using ReadyObject = std::pair<size_t, std::shared_ptr<RayObject>>;
+
+  /// Start the get.
+  ///
+  /// \param[in] object_ids IDs of the objects to get. Duplicates are allowed.
+  /// \param[in] memory_store The memory store to wait for the objects in.
+  /// \param[in] plasma_fetch Used to fetch the objects that were promoted to plasma.
+  /// \param[in] plasma_get Used to get the fetched objects.
+  /// \param[in] notify_blocked If not null, called before the calling thread blocks for
+  /// the first time.
+  /// \param[in] notify_done If not null, called when the get ends, i.e., all objects
+  /// were returned or the get is destroyed, if the get blocked or fetched objects. It
+  /// must end the fetch and unblock the worker.
+  /// \param[in] check_signals If not null, called periodically while blocked. The get
+  /// is aborted if it returns an error.
+  AsCompletedGet(const std::vector<ObjectID> &object_ids,
+                 CoreWorkerMemoryStore &memory_store, PlasmaFetchFunction plasma_fetch,
+                 PlasmaGetFunction plasma_get,
+                 std::function<void()> notify_blocked = nullptr,
+                 std::function<void()> notify_done = nullptr,
+                 std::function<Status()> check_signals = nullptr);
+
+  ~AsCompletedGet();
+
+  /// Wait until at least one of the remaining objects is available, and return all
+  /// the objects that are available at that point.
+  ///
+  /// \param[in] timeout_ms Timeout in milliseconds, wait infinitely if it's negative.
+  /// \param[out] ready The available objects, in the order in which they completed.
+  /// An object that was requested more than once is returned once per index. Empty
+  /// iff all objects were already returned.
+  /// \return Status::TimedOut if no object became available before the timeout.
+  Status Next(int64_t timeout_ms, std::vector<ReadyObject> *ready);
+
+  /// Whether all objects were returned.
+  bool Done() const { return indices_.empty(); }
+
+ private:
+  /// The objects that the memory store reported, shared with the memory store
+  /// callbacks, which may outlive the get.
+  struct CompletionQueue {
+    absl::Mutex mu;
+    absl::CondVar cv;
+    std::deque<std::pair<ObjectID, std::shared_ptr<RayObject>>> objects
+        GUARDED_BY(mu);
+  };
+
+  /// Move the objects that the memory store reported to `ready`, and start fetching
+  /// the ones that were promoted to plasma.
+  Status DrainCompletionQueue(std::vector<ReadyObject> *ready);
+
+  /// Get the given plasma objects from the local store with the given timeout, and
+  /// add the ones that are available to `ready`.
+  Status GetFromPlasma(const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
+                       std::vector<ReadyObject> *ready);
+
+  /// Add an object to `ready` once per index it was requested at.
+  void AddReady(const ObjectID &object_id, const std::shared_ptr<RayObject> &object,
+                std::vector<ReadyObject> *ready);
+
+  /// Notify that the calling thread blocks, unless it did before.
+  void SetBlocked();
+
+  /// End the fetch and unblock the worker, if needed.
+  void Finish();
+
+  const PlasmaFetchFunction plasma_fetch_;
+  const PlasmaGetFunction plasma_get_;
+  const std::function<void()> notify_blocked_;
+  const std::function<void()> notify_done_;
+  const std::function<Status()> check_signals_;
+  std::shared_ptr<CompletionQueue> completion_queue_;
+  /// The indices of each requested object that wasn't returned yet.
+  absl::flat_hash_map<ObjectID, std::vector<size_t>> indices_;
+  /// The objects that were promoted to plasma and weren't returned yet.
+  absl::flat_hash_set<ObjectID> plasma_pending_;
+  /// Whether the raylet was notified that the calling thread is blocked.
+  bool blocked_ = false;
+  /// Whether objects were fetched from plasma.
+  bool fetched_ = false;
+};
+
+}  // namespace core
+}  // namespace ray
@@ -199,10 +199,36 @@ Status CoreWorkerPlasmaStoreProvider::FetchAndGetFromPlasmaStore(
 Status CoreWorkerPlasmaStoreProvider::GetIfLocal(
     const std::vector<ObjectID> &object_ids,
     absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results) {
-  std::vector<plasma::ObjectBuffer> plasma_results;
   // Since this path is used only for spilling, we should set is_from_worker: false.
-  RAY_RETURN_NOT_OK(store_client_.Get(object_ids, /*timeout_ms=*/0, &plasma_results,
-                                      /*is_from_worker=*/false));
+  return GetFromStore(object_ids, /*timeout_ms=*/0, /*is_from_worker=*/false, results);
+}
+
+Status CoreWorkerPlasmaStoreProvider::Fetch(const std::vector<ObjectID> &object_ids,
+                                            const WorkerContext &ctx) {
+  const size_t batch_size = RayConfig::instance().worker_fetch_request_size();
+  for (size_t start = 0; start < object_ids.size(); start += batch_size) {
+    const size_t end = std::min(start + batch_size, object_ids.size());
+    std::vector<ObjectID> batch_ids(object_ids.begin() + start, object_ids.begin() + end);
+    const auto owner_addresses = reference_counter_->GetOwnerAddresses(batch_ids);
+    RAY_RETURN_NOT_OK(raylet_client_->FetchOrReconstruct(
+        batch_ids, owner_addresses, /*fetch_only=*/false,
+        /*mark_worker_blocked*/ !ctx.CurrentTaskIsDirectCall(), ctx.GetCurrentTaskID()));
+  }
+  return Status::OK();
+}
+
+Status CoreWorkerPlasmaStoreProvider::GetFromLocalStore(
+    const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
+    absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results) {
+  return GetFromStore(object_ids, timeout_ms, /*is_from_worker=*/true, results);
+}
+
+Status CoreWorkerPlasmaStoreProvider::GetFromStore(
+    const std::vector<ObjectID> &object_ids, int64_t timeout_ms, bool is_from_worker,
+    absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results) {
+  std::vector<plasma::ObjectBuffer> plasma_results;
+  RAY_RETURN_NOT_OK(
+      store_client_.Get(object_ids, timeout_ms, &plasma_results, is_from_worker));
 
   for (size_t i = 0; i < object_ids.size(); i++) {
     if (plasma_results[i].data != nullptr || plasma_results[i].metadata != nullptr) {
@@ -242,6 +268,10 @@ Status UnblockIfNeeded(const std::shared_ptr<raylet::RayletClient> &client,
   }
 }
 
+Status CoreWorkerPlasmaStoreProvider::EndFetch(const WorkerContext &ctx) {
+  return UnblockIfNeeded(raylet_client_, ctx);
+}
+
 Status CoreWorkerPlasmaStoreProvider::Get(
     const absl::flat_hash_set<ObjectID> &object_ids, int64_t timeout_ms,
     const WorkerContext &ctx,
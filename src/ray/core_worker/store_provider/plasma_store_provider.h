@@ -154,6 +154,34 @@ class CoreWorkerPlasmaStoreProvider {
   Status GetIfLocal(const std::vector<ObjectID> &ids,
                     absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results);
 
+  /// Ask the raylet to fetch objects to the local plasma store. Unlike Get, which
+  /// cancels its fetch when it returns, the fetch stays open until EndFetch is called,
+  /// so the objects can be waited for with GetFromLocalStore across several calls
+  /// without interrupting their pulls. Objects of later calls are added to the fetch.
+  ///
+  /// \param[in] ids The IDs of the objects to fetch.
+  /// \param[in] ctx The current context.
+  /// \return Status.
+  Status Fetch(const std::vector<ObjectID> &ids, const WorkerContext &ctx);
+
+  /// Cancel the fetch started by Fetch, and notify the raylet that the worker is no
+  /// longer blocked.
+  ///
+  /// \param[in] ctx The current context.
+  /// \return Status.
+  Status EndFetch(const WorkerContext &ctx);
+
+  /// Get objects from the local plasma store, waiting for them up to the timeout. The
+  /// objects aren't fetched from other nodes, see Fetch.
+  ///
+  /// \param[in] ids The IDs of the objects to get.
+  /// \param[in] timeout_ms The timeout in milliseconds.
+  /// \param[out] results The objects that are available are added here.
+  /// \return Status.
+  Status GetFromLocalStore(
+      const std::vector<ObjectID> &ids, int64_t timeout_ms,
+      absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results);
+
   Status Contains(const ObjectID &object_id, bool *has_object);
 
   Status Wait(const absl::flat_hash_set<ObjectID> &object_ids, int num_objects,
@@ -170,6 +198,14 @@ class CoreWorkerPlasmaStoreProvider {
   std::string MemoryUsageString();
 
  private:
+  /// Get objects from the local plasma store, see GetFromLocalStore.
+  ///
+  /// \param[in] is_from_worker Whether the get is on behalf of the worker, as opposed
+  /// to, e.g., spilling.
+  Status GetFromStore(const std::vector<ObjectID> &ids, int64_t timeout_ms,
+                      bool is_from_worker,
+                      absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results);
+
   /// Ask the raylet to fetch a set of objects and then attempt to get them
   /// from the local plasma store. Successfully fetched objects will be removed
   /// from the input set of remaining IDs and added to the results map.
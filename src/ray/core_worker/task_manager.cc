@@ -29,6 +29,68 @@ const int64_t kTaskFailureThrottlingThreshold = 50;
 // Throttle task failure logs to once this interval.
 const int64_t kTaskFailureLoggingFrequencyMillis = 5000;
 
+namespace {
+
+/// Add the objects that a task depends on, i.e. its arguments passed by reference
+/// and the refs inlined in its arguments passed by value.
+void AddTaskArgIds(const TaskSpecification &spec, std::vector<ObjectID> *object_ids) {
+  for (size_t i = 0; i < spec.NumArgs(); i++) {
+    if (spec.ArgByRef(i)) {
+      object_ids->push_back(spec.ArgId(i));
+    } else {
+      const auto &inlined_refs = spec.ArgInlinedRefs(i);
+      for (const auto &inlined_ref : inlined_refs) {
+        object_ids->push_back(ObjectID::FromBinary(inlined_ref.object_id()));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+bool ObjectRefStream::CanInsert(int64_t index) const {
+  return index >= next_index_ && !items_.contains(index) &&
+         (end_index_ < 0 || index < end_index_);
+}
+
+bool ObjectRefStream::Insert(int64_t index, const ObjectID &object_id) {
+  if (!CanInsert(index)) {
+    return false;
+  }
+  items_.emplace(index, object_id);
+  return true;
+}
+
+ObjectID ObjectRefStream::TryRead() {
+  auto it = items_.find(next_index_);
+  if (IsEnded() || it == items_.end()) {
+    return ObjectID::Nil();
+  }
+  ObjectID object_id = it->second;
+  items_.erase(it);
+  next_index_++;
+  return object_id;
+}
+
+void ObjectRefStream::MarkEnd() {
+  if (end_index_ >= 0) {
+    return;
+  }
+  end_index_ = next_index_;
+  while (items_.contains(end_index_)) {
+    end_index_++;
+  }
+}
+
+std::vector<ObjectID> ObjectRefStream::UnreadItems() const {
+  std::vector<ObjectID> object_ids;
+  object_ids.reserve(items_.size());
+  for (const auto &item : items_) {
+    object_ids.push_back(item.second);
+  }
+  return object_ids;
+}
+
 std::vector<rpc::ObjectReference> TaskManager::AddPendingTask(
     const rpc::Address &caller_address, const TaskSpecification &spec,
     const std::string &call_site, int max_retries) {
@@ -88,6 +150,10 @@ std::vector<rpc::ObjectReference> TaskManager::AddPendingTask(
                   .emplace(spec.TaskId(), TaskEntry(spec, max_retries, num_returns))
                   .second);
     num_pending_tasks_++;
+    if (spec.IsStreamingGenerator()) {
+      object_ref_streams_.emplace(spec.ReturnId(0),
+                                  ObjectRefStream(caller_address, call_site));
+    }
   }
 
   return returned_refs;
@@ -112,6 +178,9 @@ Status TaskManager::ResubmitTask(const TaskID &task_id,
       } else {
         RAY_CHECK(it->second.num_retries_left == -1);
       }
+      // The spec is pinned in full again while the task is pending.
+      RAY_CHECK(lineage_log_.Get(task_id, &it->second.spec));
+      lineage_log_.Remove(task_id);
       spec = it->second.spec;
     }
   }
@@ -186,6 +255,21 @@ size_t TaskManager::NumPendingTasks() const {
   return num_pending_tasks_;
 }
 
+size_t TaskManager::NumLineageTasks() const {
+  absl::MutexLock lock(&mu_);
+  return lineage_log_.Size();
+}
+
+int64_t TaskManager::NumLineageBytes() const {
+  absl::MutexLock lock(&mu_);
+  return lineage_log_.NumBytes();
+}
+
+int64_t TaskManager::NumLineageEvictions() const {
+  absl::MutexLock lock(&mu_);
+  return num_lineage_evictions_;
+}
+
 void TaskManager::CompletePendingTask(const TaskID &task_id,
                                       const rpc::PushTaskReply &reply,
                                       const rpc::Address &worker_addr) {
@@ -211,68 +295,15 @@ void TaskManager::CompletePendingTask(const TaskID &task_id,
   for (int i = 0; i < reply.return_objects_size(); i++) {
     const auto &return_object = reply.return_objects(i);
     ObjectID object_id = ObjectID::FromBinary(return_object.object_id());
-    reference_counter_->UpdateObjectSize(object_id, return_object.size());
-    RAY_LOG(DEBUG) << "Task return object " << object_id << " has size "
-                   << return_object.size();
-
-    const auto nested_refs =
-        VectorFromProtobuf<rpc::ObjectReference>(return_object.nested_inlined_refs());
-    if (return_object.in_plasma()) {
-      const auto pinned_at_raylet_id = NodeID::FromBinary(worker_addr.raylet_id());
-      if (check_node_alive_(pinned_at_raylet_id)) {
-        reference_counter_->UpdateObjectPinnedAtRaylet(object_id, pinned_at_raylet_id);
-        // Mark it as in plasma with a dummy object.
-        RAY_CHECK(in_memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA),
-                                        object_id));
-      } else {
-        RAY_LOG(DEBUG) << "Task " << task_id << " returned object " << object_id
-                       << " in plasma on a dead node, attempting to recover.";
-        reconstruct_object_callback_(object_id);
-      }
-    } else {
-      // NOTE(swang): If a direct object was promoted to plasma, then we do not
-      // record the node ID that it was pinned at, which means that we will not
-      // be able to reconstruct it if the plasma object copy is lost. However,
-      // this is okay because the pinned copy is on the local node, so we will
-      // fate-share with the object if the local node fails.
-      std::shared_ptr<LocalMemoryBuffer> data_buffer;
-      if (return_object.data().size() > 0) {
-        data_buffer = std::make_shared<LocalMemoryBuffer>(
-            const_cast<uint8_t *>(
-                reinterpret_cast<const uint8_t *>(return_object.data().data())),
-            return_object.data().size());
-      }
-      std::shared_ptr<LocalMemoryBuffer> metadata_buffer;
-      if (return_object.metadata().size() > 0) {
-        metadata_buffer = std::make_shared<LocalMemoryBuffer>(
-            const_cast<uint8_t *>(
-                reinterpret_cast<const uint8_t *>(return_object.metadata().data())),
-            return_object.metadata().size());
-      }
-
-      RayObject object(data_buffer, metadata_buffer, nested_refs);
-      if (store_in_plasma_ids.count(object_id)) {
-        put_in_local_plasma_callback_(object, object_id);
-      } else {
-        bool stored_in_direct_memory = in_memory_store_->Put(object, object_id);
-        if (stored_in_direct_memory) {
-          direct_return_ids.push_back(object_id);
-        }
-      }
-    }
-
-    rpc::Address owner_address;
-    if (reference_counter_->GetOwner(object_id, &owner_address) && !nested_refs.empty()) {
-      std::vector<ObjectID> nested_ids;
-      for (const auto &nested_ref : nested_refs) {
-        nested_ids.emplace_back(ObjectRefToId(nested_ref));
-      }
-      reference_counter_->AddNestedObjectIds(object_id, nested_ids, owner_address);
+    if (HandleTaskReturn(return_object, worker_addr,
+                         store_in_plasma_ids.count(object_id) > 0)) {
+      direct_return_ids.push_back(object_id);
     }
   }
 
   TaskSpecification spec;
   bool release_lineage = true;
+  std::vector<ObjectID> evicted_lineage_ids;
   {
     absl::MutexLock lock(&mu_);
     auto it = submissible_tasks_.find(task_id);
@@ -302,18 +333,189 @@ void TaskManager::CompletePendingTask(const TaskID &task_id,
     bool task_retryable = it->second.num_retries_left != 0 &&
                           !it->second.reconstructable_return_ids.empty();
     if (task_retryable) {
-      // Pin the task spec if it may be retried again.
+      // Pin the task spec if it may be retried again. It's only needed to resubmit
+      // the task, so it's moved to the compact lineage log.
       release_lineage = false;
+      lineage_log_.Add(spec);
+      it->second.spec = TaskSpecification();
+      EvictLineage(&evicted_lineage_ids);
     } else {
       submissible_tasks_.erase(it);
     }
   }
 
   RemoveFinishedTaskReferences(spec, release_lineage, worker_addr, reply.borrowed_refs());
+  if (!evicted_lineage_ids.empty()) {
+    reference_counter_->ReleaseLineageReferences(evicted_lineage_ids);
+  }
+  MarkEndOfStream(spec);
 
   ShutdownIfNeeded();
 }
 
+bool TaskManager::HandleTaskReturn(const rpc::ReturnObject &return_object,
+                                   const rpc::Address &worker_addr,
+                                   bool store_in_plasma) {
+  ObjectID object_id = ObjectID::FromBinary(return_object.object_id());
+  reference_counter_->UpdateObjectSize(object_id, return_object.size());
+  RAY_LOG(DEBUG) << "Task return object " << object_id << " has size "
+                 << return_object.size();
+
+  bool stored_in_direct_memory = false;
+  const auto nested_refs =
+      VectorFromProtobuf<rpc::ObjectReference>(return_object.nested_inlined_refs());
+  if (return_object.in_plasma()) {
+    const auto pinned_at_raylet_id = NodeID::FromBinary(worker_addr.raylet_id());
+    if (check_node_alive_(pinned_at_raylet_id)) {
+      reference_counter_->UpdateObjectPinnedAtRaylet(object_id, pinned_at_raylet_id);
+      // Mark it as in plasma with a dummy object.
+      RAY_CHECK(
+          in_memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), object_id));
+    } else {
+      RAY_LOG(DEBUG) << "Task " << object_id.TaskId() << " returned object " << object_id
+                     << " in plasma on a dead node, attempting to recover.";
+      reconstruct_object_callback_(object_id);
+    }
+  } else {
+    // NOTE(swang): If a direct object was promoted to plasma, then we do not
+    // record the node ID that it was pinned at, which means that we will not
+    // be able to reconstruct it if the plasma object copy is lost. However,
+    // this is okay because the pinned copy is on the local node, so we will
+    // fate-share with the object if the local node fails.
+    std::shared_ptr<LocalMemoryBuffer> data_buffer;
+    if (return_object.data().size() > 0) {
+      data_buffer = std::make_shared<LocalMemoryBuffer>(
+          const_cast<uint8_t *>(
+              reinterpret_cast<const uint8_t *>(return_object.data().data())),
+          return_object.data().size());
+    }
+    std::shared_ptr<LocalMemoryBuffer> metadata_buffer;
+    if (return_object.metadata().size() > 0) {
+      metadata_buffer = std::make_shared<LocalMemoryBuffer>(
+          const_cast<uint8_t *>(
+              reinterpret_cast<const uint8_t *>(return_object.metadata().data())),
+          return_object.metadata().size());
+    }
+
+    RayObject object(data_buffer, metadata_buffer, nested_refs);
+    if (store_in_plasma) {
+      put_in_local_plasma_callback_(object, object_id);
+    } else {
+      stored_in_direct_memory = in_memory_store_->Put(object, object_id);
+    }
+  }
+
+  rpc::Address owner_address;
+  if (reference_counter_->GetOwner(object_id, &owner_address) && !nested_refs.empty()) {
+    std::vector<ObjectID> nested_ids;
+    for (const auto &nested_ref : nested_refs) {
+      nested_ids.emplace_back(ObjectRefToId(nested_ref));
+    }
+    reference_counter_->AddNestedObjectIds(object_id, nested_ids, owner_address);
+  }
+  return stored_in_direct_memory;
+}
+
+bool TaskManager::HandleReportGeneratorItemReturns(
+    const rpc::ReportGeneratorItemReturnsRequest &request) {
+  const auto generator_id = ObjectID::FromBinary(request.generator_id());
+  const auto object_id = ObjectID::FromBinary(request.returned_object().object_id());
+  const int64_t item_index = request.item_index();
+  rpc::Address owner_address;
+  std::string call_site;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = object_ref_streams_.find(generator_id);
+    if (it == object_ref_streams_.end() || !it->second.CanInsert(item_index)) {
+      RAY_LOG(DEBUG) << "Ignoring value " << item_index << " of stream " << generator_id;
+      return false;
+    }
+    owner_address = it->second.OwnerAddress();
+    call_site = it->second.CallSite();
+  }
+
+  // The value must be owned and stored before a reader can see it in the stream.
+  // The values of a stream are not reconstructable, since they're only known once the
+  // task runs.
+  reference_counter_->AddOwnedObject(object_id, /*inner_ids=*/{}, owner_address,
+                                     call_site, request.returned_object().size(),
+                                     /*is_reconstructable=*/false);
+  reference_counter_->AddLocalReference(object_id, call_site);
+  HandleTaskReturn(request.returned_object(), request.worker_addr(),
+                   /*store_in_plasma=*/false);
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = object_ref_streams_.find(generator_id);
+    if (it != object_ref_streams_.end() && it->second.Insert(item_index, object_id)) {
+      object_ref_stream_cv_.SignalAll();
+      return true;
+    }
+  }
+  // The stream was deleted in the meantime.
+  std::vector<ObjectID> deleted;
+  reference_counter_->RemoveLocalReference(object_id, &deleted);
+  in_memory_store_->Delete(deleted);
+  return false;
+}
+
+Status TaskManager::TryReadObjectRefStream(const ObjectID &generator_id,
+                                           ObjectID *object_id, bool *end_of_stream) {
+  absl::MutexLock lock(&mu_);
+  auto it = object_ref_streams_.find(generator_id);
+  if (it == object_ref_streams_.end()) {
+    return Status::NotFound("No stream for generator " + generator_id.Hex());
+  }
+  *object_id = it->second.TryRead();
+  *end_of_stream = it->second.IsEnded();
+  return Status::OK();
+}
+
+bool TaskManager::WaitForObjectRefStream(const ObjectID &generator_id,
+                                         int64_t timeout_ms) {
+  absl::MutexLock lock(&mu_);
+  const absl::Time deadline = absl::Now() + absl::Milliseconds(timeout_ms);
+  while (true) {
+    auto it = object_ref_streams_.find(generator_id);
+    if (it == object_ref_streams_.end() || it->second.IsReadable()) {
+      return true;
+    }
+    if (object_ref_stream_cv_.WaitWithDeadline(&mu_, deadline)) {
+      return false;
+    }
+  }
+}
+
+void TaskManager::DelObjectRefStream(const ObjectID &generator_id) {
+  std::vector<ObjectID> unread_ids;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = object_ref_streams_.find(generator_id);
+    if (it == object_ref_streams_.end()) {
+      return;
+    }
+    unread_ids = it->second.UnreadItems();
+    object_ref_streams_.erase(it);
+    object_ref_stream_cv_.SignalAll();
+  }
+  std::vector<ObjectID> deleted;
+  for (const auto &object_id : unread_ids) {
+    reference_counter_->RemoveLocalReference(object_id, &deleted);
+  }
+  in_memory_store_->Delete(deleted);
+}
+
+void TaskManager::MarkEndOfStream(const TaskSpecification &spec) {
+  if (!spec.IsStreamingGenerator()) {
+    return;
+  }
+  absl::MutexLock lock(&mu_);
+  auto it = object_ref_streams_.find(spec.ReturnId(0));
+  if (it != object_ref_streams_.end()) {
+    it->second.MarkEnd();
+    object_ref_stream_cv_.SignalAll();
+  }
+}
+
 bool TaskManager::RetryTaskIfPossible(const TaskID &task_id) {
   int num_retries_left = 0;
   TaskSpecification spec;
@@ -482,23 +684,43 @@ void TaskManager::RemoveLineageReference(const ObjectID &object_id,
   if (it->second.reconstructable_return_ids.empty() && !it->second.pending) {
     // If the task can no longer be retried, decrement the lineage ref count
     // for each of the task's args.
-    for (size_t i = 0; i < it->second.spec.NumArgs(); i++) {
-      if (it->second.spec.ArgByRef(i)) {
-        released_objects->push_back(it->second.spec.ArgId(i));
-      } else {
-        const auto &inlined_refs = it->second.spec.ArgInlinedRefs(i);
-        for (const auto &inlined_ref : inlined_refs) {
-          released_objects->push_back(ObjectID::FromBinary(inlined_ref.object_id()));
-        }
-      }
-    }
+    AddTaskArgIds(GetTaskSpecInternal(task_id, it->second), released_objects);
 
     // The task has finished and none of the return IDs are in scope anymore,
     // so it is safe to remove the task spec.
+    lineage_log_.Remove(task_id);
     submissible_tasks_.erase(it);
   }
 }
 
+TaskSpecification TaskManager::GetTaskSpecInternal(const TaskID &task_id,
+                                                   const TaskEntry &entry) const {
+  TaskSpecification spec;
+  if (!entry.pending && lineage_log_.Get(task_id, &spec)) {
+    return spec;
+  }
+  return entry.spec;
+}
+
+void TaskManager::EvictLineage(std::vector<ObjectID> *released_objects) {
+  while (lineage_log_.NumBytes() > max_lineage_bytes_) {
+    const TaskID task_id = lineage_log_.Oldest();
+    TaskSpecification spec;
+    RAY_CHECK(lineage_log_.Get(task_id, &spec));
+    RAY_LOG_EVERY_MS(WARNING, 10000)
+        << "The lineage of finished tasks exceeds " << max_lineage_bytes_
+        << " bytes, evicting the lineage of task " << task_id
+        << ". Its return values can no longer be reconstructed if they are lost. "
+        << "Set RAY_max_lineage_bytes to increase the limit.";
+    // The evicted task can no longer be resubmitted, so its return values are not
+    // reconstructable anymore, and the task no longer pins its arguments.
+    AddTaskArgIds(spec, released_objects);
+    lineage_log_.Remove(task_id);
+    submissible_tasks_.erase(task_id);
+    num_lineage_evictions_++;
+  }
+}
+
 bool TaskManager::MarkTaskCanceled(const TaskID &task_id) {
   absl::MutexLock lock(&mu_);
   auto it = submissible_tasks_.find(task_id);
@@ -546,6 +768,7 @@ void TaskManager::MarkPendingTaskFailed(
       RAY_UNUSED(in_memory_store_->Put(RayObject(error_type), object_id));
     }
   }
+  MarkEndOfStream(spec);
 }
 
 absl::optional<TaskSpecification> TaskManager::GetTaskSpec(const TaskID &task_id) const {
@@ -554,7 +777,7 @@ absl::optional<TaskSpecification> TaskManager::GetTaskSpec(const TaskID &task_id
   if (it == submissible_tasks_.end()) {
     return absl::optional<TaskSpecification>();
   }
-  return it->second.spec;
+  return GetTaskSpecInternal(task_id, it->second);
 }
 
 std::vector<TaskID> TaskManager::GetPendingChildrenTasks(
@@ -14,11 +14,14 @@
 
 #pragma once
 
+#include <limits>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/id.h"
 #include "ray/common/task/task.h"
+#include "ray/core_worker/lineage_log.h"
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
 #include "src/ray/protobuf/core_worker.pb.h"
 #include "src/ray/protobuf/gcs.pb.h"
@@ -26,6 +29,57 @@
 namespace ray {
 namespace core {
 
+/// The values that a streaming generator task reported to its caller and that the
+/// caller didn't read yet, in the order of the stream.
+class ObjectRefStream {
+ public:
+  ObjectRefStream(const rpc::Address &owner_address, const std::string &call_site)
+      : owner_address_(owner_address), call_site_(call_site) {}
+
+  /// Whether the value at the given index can still be added, i.e. it wasn't added
+  /// yet and the stream didn't end before it.
+  bool CanInsert(int64_t index) const;
+
+  /// Add the value at the given index.
+  ///
+  /// \return Whether the value was added, see CanInsert.
+  bool Insert(int64_t index, const ObjectID &object_id);
+
+  /// Read the next value in the stream.
+  ///
+  /// \return The next value, or nil if it wasn't reported yet or the stream ended.
+  ObjectID TryRead();
+
+  /// End the stream after the values that were reported without gaps so far. Values
+  /// that are reported later are ignored.
+  void MarkEnd();
+
+  /// Whether all values of the stream were read.
+  bool IsEnded() const { return end_index_ >= 0 && next_index_ >= end_index_; }
+
+  /// Whether TryRead returns a value or the stream ended.
+  bool IsReadable() const { return IsEnded() || items_.contains(next_index_); }
+
+  /// The values that were reported but weren't read yet.
+  std::vector<ObjectID> UnreadItems() const;
+
+  const rpc::Address &OwnerAddress() const { return owner_address_; }
+
+  const std::string &CallSite() const { return call_site_; }
+
+ private:
+  /// The address of the caller of the task, which owns the values.
+  const rpc::Address owner_address_;
+  /// The call site of the task.
+  const std::string call_site_;
+  /// The values that weren't read yet, by their index in the stream.
+  absl::flat_hash_map<int64_t, ObjectID> items_;
+  /// The index of the next value to read.
+  int64_t next_index_ = 0;
+  /// The number of values in the stream, or -1 while the task may still report more.
+  int64_t end_index_ = -1;
+};
+
 class TaskFinisherInterface {
  public:
   virtual void CompletePendingTask(const TaskID &task_id, const rpc::PushTaskReply &reply,
@@ -77,14 +131,16 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
               RetryTaskCallback retry_task_callback,
               const std::function<bool(const NodeID &node_id)> &check_node_alive,
               ReconstructObjectCallback reconstruct_object_callback,
-              PushErrorCallback push_error_callback)
+              PushErrorCallback push_error_callback,
+              int64_t max_lineage_bytes = std::numeric_limits<int64_t>::max())
       : in_memory_store_(in_memory_store),
         reference_counter_(reference_counter),
         put_in_local_plasma_callback_(put_in_local_plasma_callback),
         retry_task_callback_(retry_task_callback),
         check_node_alive_(check_node_alive),
         reconstruct_object_callback_(reconstruct_object_callback),
-        push_error_callback_(push_error_callback) {
+        push_error_callback_(push_error_callback),
+        max_lineage_bytes_(max_lineage_bytes) {
     reference_counter_->SetReleaseLineageCallback(
         [this](const ObjectID &object_id, std::vector<ObjectID> *ids_to_release) {
           RemoveLineageReference(object_id, ids_to_release);
@@ -181,6 +237,44 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   /// Return specs for pending children tasks of the given parent task.
   std::vector<TaskID> GetPendingChildrenTasks(const TaskID &parent_task_id) const;
 
+  /// Handle a value that the worker executing a streaming generator task reported.
+  /// The value is stored like a return value of the task and appended to the task's
+  /// stream, which holds a local reference to it until the caller reads it.
+  ///
+  /// \param[in] request The report from the executing worker.
+  /// \return Whether the value was added to the stream. False if the stream was
+  /// deleted or ended, or if the value is a duplicate from a retry of the task.
+  bool HandleReportGeneratorItemReturns(
+      const rpc::ReportGeneratorItemReturnsRequest &request) LOCKS_EXCLUDED(mu_);
+
+  /// Read the next value of a streaming generator task. The caller takes over the
+  /// local reference that the stream held to the value.
+  ///
+  /// \param[in] generator_id The return object ID of the task.
+  /// \param[out] object_id The next value, or nil if the task didn't report it yet
+  /// or the stream ended.
+  /// \param[out] end_of_stream Whether the task finished or failed and all of its
+  /// values were read.
+  /// \return NotFound if the task has no stream, e.g. because it was deleted.
+  Status TryReadObjectRefStream(const ObjectID &generator_id, ObjectID *object_id,
+                                bool *end_of_stream) LOCKS_EXCLUDED(mu_);
+
+  /// Wait until the next value of a streaming generator task can be read, the
+  /// stream ended, or the stream was deleted.
+  ///
+  /// \param[in] generator_id The return object ID of the task.
+  /// \param[in] timeout_ms Timeout in milliseconds.
+  /// \return Whether TryReadObjectRefStream returns without waiting.
+  bool WaitForObjectRefStream(const ObjectID &generator_id, int64_t timeout_ms)
+      LOCKS_EXCLUDED(mu_);
+
+  /// Delete the stream of a streaming generator task because the caller stopped
+  /// consuming it. The values that weren't read are released, and values that are
+  /// reported later are ignored.
+  ///
+  /// \param[in] generator_id The return object ID of the task.
+  void DelObjectRefStream(const ObjectID &generator_id) LOCKS_EXCLUDED(mu_);
+
   /// Return whether this task can be submitted for execution.
   ///
   /// \param[in] task_id ID of the task to query.
@@ -201,6 +295,17 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   /// Return the number of pending tasks.
   size_t NumPendingTasks() const;
 
+  /// Return the number of finished tasks whose specs are kept as lineage.
+  size_t NumLineageTasks() const;
+
+  /// Return the number of bytes of the specs of the finished tasks that are kept as
+  /// lineage, see LineageLog.
+  int64_t NumLineageBytes() const;
+
+  /// Return the number of finished tasks whose lineage was evicted to stay within
+  /// the lineage memory budget. Their return values can no longer be reconstructed.
+  int64_t NumLineageEvictions() const;
+
  private:
   struct TaskEntry {
     TaskEntry(const TaskSpecification &spec_arg, int num_retries_left_arg,
@@ -215,13 +320,14 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
     /// fail and so it may be retried in the future.
     /// - The task finished execution, but it has num_retries_left > 0 and
     /// reconstructable_return_ids is not empty. This means that the task may
-    /// be retried in the future to recreate its return objects.
+    /// be retried in the future to recreate its return objects. The spec is
+    /// then moved to the lineage log and this is empty, see GetTaskSpecInternal.
     /// TODO(swang): The TaskSpec protobuf must be copied into the
     /// PushTaskRequest protobuf when sent to a worker so that we can retry it if
     /// the worker fails. We could avoid this by either not caching the full
     /// TaskSpec for tasks that cannot be retried (e.g., actor tasks), or by
     /// storing a shared_ptr to a PushTaskRequest protobuf for all tasks.
-    const TaskSpecification spec;
+    TaskSpecification spec;
     // Number of times this task may be resubmitted. If this reaches 0, then
     // the task entry may be erased.
     int num_retries_left;
@@ -245,6 +351,19 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
     absl::flat_hash_set<ObjectID> reconstructable_return_ids;
   };
 
+  /// Get the spec of a task, which is in the lineage log if the task finished.
+  TaskSpecification GetTaskSpecInternal(const TaskID &task_id,
+                                        const TaskEntry &entry) const
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Evict the lineage of the tasks that finished first until the lineage log is
+  /// within the memory budget. The evicted tasks can no longer be resubmitted.
+  ///
+  /// \param[out] released_objects The arguments of the evicted tasks, whose lineage
+  /// references the caller should release without holding the lock.
+  void EvictLineage(std::vector<ObjectID> *released_objects)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// Remove a lineage reference to this object ID. This should be called
   /// whenever a task that depended on this object ID can no longer be retried.
   void RemoveLineageReference(const ObjectID &object_id,
@@ -261,6 +380,21 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   /// Shutdown if all tasks are finished and shutdown is scheduled.
   void ShutdownIfNeeded() LOCKS_EXCLUDED(mu_);
 
+  /// Store a return value of a task that the worker at the given address reported.
+  ///
+  /// \param[in] return_object The return value.
+  /// \param[in] worker_addr The address of the worker that executed the task.
+  /// \param[in] store_in_plasma Whether to store an inlined value in plasma, because
+  /// a previous execution of the task stored it there.
+  /// \return Whether the value was stored in the memory store, so that it doesn't
+  /// need to be reconstructed.
+  bool HandleTaskReturn(const rpc::ReturnObject &return_object,
+                        const rpc::Address &worker_addr, bool store_in_plasma);
+
+  /// End the stream of a streaming generator task that finished or failed, and wake
+  /// up the callers that wait for it.
+  void MarkEndOfStream(const TaskSpecification &spec) LOCKS_EXCLUDED(mu_);
+
   /// Used to store task results.
   std::shared_ptr<CoreWorkerMemoryStore> in_memory_store_;
 
@@ -307,6 +441,24 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   /// future.
   absl::flat_hash_map<TaskID, TaskEntry> submissible_tasks_ GUARDED_BY(mu_);
 
+  /// The specs of the tasks in submissible_tasks_ that finished execution.
+  LineageLog lineage_log_ GUARDED_BY(mu_);
+
+  /// The maximum number of bytes of the lineage log. Beyond this, the lineage of
+  /// the tasks that finished first is evicted.
+  const int64_t max_lineage_bytes_;
+
+  /// The number of tasks whose lineage was evicted.
+  int64_t num_lineage_evictions_ GUARDED_BY(mu_) = 0;
+
+  /// The streams of the streaming generator tasks, keyed by the return object ID of
+  /// the task. A stream is added when the task is submitted and is deleted once the
+  /// caller stops consuming it.
+  absl::flat_hash_map<ObjectID, ObjectRefStream> object_ref_streams_ GUARDED_BY(mu_);
+
+  /// Signaled when a stream becomes readable or is deleted.
+  absl::CondVar object_ref_stream_cv_;
+
   /// Number of tasks that are pending. This is a count of all tasks in
   /// submissible_tasks_ that have been submitted and are currently pending
   /// execution.
@@ -79,6 +79,47 @@ TEST_F(ActorCreatorTest, AsyncWaitForFinish) {
   ASSERT_EQ(101, cnt);
 }
 
+TEST_F(ActorCreatorTest, TestCreateActorsInBatch) {
+  instrumented_io_context io_service;
+  actor_creator = std::make_unique<DefaultActorCreator>(gcs_client, &io_service);
+  std::vector<TaskSpecification> task_specs;
+  std::vector<TaskSpecification> batch;
+  rpc::ClientCallback<rpc::CreateActorsReply> batch_callback;
+  EXPECT_CALL(*gcs_client->mock_actor_accessor,
+              AsyncCreateActors(::testing::_, ::testing::_))
+      .WillOnce(::testing::DoAll(::testing::SaveArg<0>(&batch),
+                                 ::testing::SaveArg<1>(&batch_callback),
+                                 ::testing::Return(Status::OK())));
+  std::vector<Status> statuses;
+  for (int i = 0; i < 3; i++) {
+    task_specs.push_back(GetTaskSpec(ActorID::Of(JobID::FromInt(1), TaskID::Nil(), i)));
+    ASSERT_TRUE(actor_creator
+                    ->AsyncCreateActor(task_specs.back(),
+                                       [&statuses](Status status,
+                                                   const rpc::CreateActorReply &reply) {
+                                         statuses.push_back(status);
+                                       })
+                    .ok());
+  }
+  // The actors are created with one request once the event loop runs.
+  ASSERT_TRUE(batch.empty());
+  io_service.poll();
+  ASSERT_EQ(batch.size(), 3);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(batch[i].ActorCreationId(), task_specs[i].ActorCreationId());
+  }
+
+  rpc::CreateActorsReply reply;
+  reply.add_replies();
+  reply.add_replies()->mutable_status()->set_code((int)StatusCode::Invalid);
+  reply.add_replies();
+  batch_callback(Status::OK(), reply);
+  ASSERT_EQ(statuses.size(), 3);
+  ASSERT_TRUE(statuses[0].ok());
+  ASSERT_TRUE(statuses[1].IsInvalid());
+  ASSERT_TRUE(statuses[2].ok());
+}
+
 }  // namespace core
 }  // namespace ray
 
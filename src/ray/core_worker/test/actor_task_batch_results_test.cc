@@ -0,0 +1,353 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/transport/actor_task_batch_results.h"
+
+#include <thread>
+
+#include "absl/strings/str_format.h"
+#include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
+#include "ray/common/test_util.h"
+#include "ray/rpc/grpc_server.h"
+#include "ray/rpc/worker/core_worker_client.h"
+#include "ray/rpc/worker/core_worker_server.h"
+
+namespace ray {
+namespace core {
+
+TEST(ActorTaskBatchResultsTest, TestResultsInOrder) {
+  ActorTaskBatchResults results;
+  auto replies = results.AddBatch("batch", 3);
+  ASSERT_EQ(replies.size(), 3);
+  for (int i = 0; i < 3; i++) {
+    replies[i]->add_return_objects()->set_object_id(std::to_string(i));
+  }
+
+  int num_replies = 0;
+  Status reply_status;
+  auto send_reply = [&num_replies, &reply_status](Status status,
+                                                  std::function<void()> success,
+                                                  std::function<void()> failure) {
+    num_replies++;
+    reply_status = status;
+  };
+  rpc::PushTasksReply reply;
+  results.Poll("batch", 0, &reply, send_reply);
+  ASSERT_EQ(num_replies, 0);
+  // The result of a task is held back until the earlier tasks finished.
+  results.SetResult("batch", 1, Status::OK());
+  ASSERT_EQ(num_replies, 0);
+  results.SetResult("batch", 0, Status::Invalid("failed"));
+  ASSERT_EQ(num_replies, 1);
+  ASSERT_TRUE(reply_status.ok());
+  ASSERT_EQ(reply.results_size(), 2);
+  ASSERT_EQ(static_cast<StatusCode>(reply.results(0).status_code()),
+            StatusCode::Invalid);
+  ASSERT_EQ(reply.results(0).reply().return_objects(0).object_id(), "0");
+  ASSERT_TRUE(reply.results(1).status_code() == 0);
+  ASSERT_EQ(reply.results(1).reply().return_objects(0).object_id(), "1");
+
+  // The last result is sent once the client polls for it.
+  results.SetResult("batch", 2, Status::OK());
+  ASSERT_EQ(results.NumBatches(), 1);
+  rpc::PushTasksReply last_reply;
+  results.Poll("batch", 2, &last_reply, send_reply);
+  ASSERT_EQ(num_replies, 2);
+  ASSERT_EQ(last_reply.results_size(), 1);
+  ASSERT_EQ(last_reply.results(0).reply().return_objects(0).object_id(), "2");
+  ASSERT_EQ(results.NumBatches(), 0);
+}
+
+TEST(ActorTaskBatchResultsTest, TestUnknownBatch) {
+  ActorTaskBatchResults results;
+  results.AddBatch("batch", 1);
+  Status reply_status;
+  auto send_reply = [&reply_status](Status status, std::function<void()> success,
+                                    std::function<void()> failure) {
+    reply_status = status;
+  };
+  rpc::PushTasksReply reply;
+  results.Poll("other", 0, &reply, send_reply);
+  ASSERT_TRUE(reply_status.IsInvalid());
+  // A poll that doesn't match the results that were sent is rejected as well.
+  results.Poll("batch", 1, &reply, send_reply);
+  ASSERT_TRUE(reply_status.IsInvalid());
+  ASSERT_EQ(reply.results_size(), 0);
+}
+
+#define NOT_IMPLEMENTED_HANDLER(METHOD)                                             \
+  void Handle##METHOD(const rpc::METHOD##Request &request, rpc::METHOD##Reply *reply, \
+                      rpc::SendReplyCallback send_reply_callback) override {        \
+    send_reply_callback(Status::NotImplemented(#METHOD), nullptr, nullptr);         \
+  }
+
+/// A worker that handles pushed actor tasks like the core worker, and finishes them
+/// when the test tells it to.
+class PushTasksServiceHandler : public rpc::CoreWorkerServiceHandler {
+ public:
+  /// \param reject_batches Whether to reject batches of tasks, like an actor that
+  /// executes tasks concurrently.
+  explicit PushTasksServiceHandler(bool reject_batches = false)
+      : reject_batches_(reject_batches) {}
+
+  void HandlePushTask(const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
+                      rpc::SendReplyCallback send_reply_callback) override {
+    absl::MutexLock lock(&mu_);
+    tasks_[request.sequence_number()] = {
+        reply, [send_reply_callback](Status status) {
+          send_reply_callback(status, nullptr, nullptr);
+        }};
+  }
+
+  void HandlePushTasks(const rpc::PushTasksRequest &request, rpc::PushTasksReply *reply,
+                       rpc::SendReplyCallback send_reply_callback) override {
+    if (request.requests_size() > 0 && reject_batches_) {
+      reply->set_batch_rejected(true);
+      send_reply_callback(Status::OK(), nullptr, nullptr);
+      return;
+    }
+    if (request.requests_size() > 0) {
+      auto replies = results_.AddBatch(request.batch_id(), request.requests_size());
+      absl::MutexLock lock(&mu_);
+      num_batches_++;
+      for (int i = 0; i < request.requests_size(); i++) {
+        tasks_[request.requests(i).sequence_number()] = {
+            replies[i], [this, batch_id = request.batch_id(), i](Status status) {
+              results_.SetResult(batch_id, i, status);
+            }};
+      }
+    }
+    results_.Poll(request.batch_id(), request.num_results_received(), reply,
+                  send_reply_callback);
+  }
+
+  NOT_IMPLEMENTED_HANDLER(StealTasks)
+  NOT_IMPLEMENTED_HANDLER(DirectActorCallArgWaitComplete)
+  NOT_IMPLEMENTED_HANDLER(GetObjectStatus)
+  NOT_IMPLEMENTED_HANDLER(GetObjectStatusBatch)
+  NOT_IMPLEMENTED_HANDLER(AddReturnObjectBorrower)
+  NOT_IMPLEMENTED_HANDLER(PushReturnObjects)
+  NOT_IMPLEMENTED_HANDLER(ReportGeneratorItemReturns)
+  NOT_IMPLEMENTED_HANDLER(WaitForActorOutOfScope)
+  NOT_IMPLEMENTED_HANDLER(PubsubLongPolling)
+  NOT_IMPLEMENTED_HANDLER(PubsubCommandBatch)
+  NOT_IMPLEMENTED_HANDLER(UpdateObjectLocationBatch)
+  NOT_IMPLEMENTED_HANDLER(GetObjectLocationsOwner)
+  NOT_IMPLEMENTED_HANDLER(KillActor)
+  NOT_IMPLEMENTED_HANDLER(CancelTask)
+  NOT_IMPLEMENTED_HANDLER(RemoteCancelTask)
+  NOT_IMPLEMENTED_HANDLER(GetCoreWorkerStats)
+  NOT_IMPLEMENTED_HANDLER(LocalGC)
+  NOT_IMPLEMENTED_HANDLER(SpillObjects)
+  NOT_IMPLEMENTED_HANDLER(RestoreSpilledObjects)
+  NOT_IMPLEMENTED_HANDLER(DeleteSpilledObjects)
+  NOT_IMPLEMENTED_HANDLER(AddSpilledUrl)
+  NOT_IMPLEMENTED_HANDLER(PlasmaObjectReady)
+  NOT_IMPLEMENTED_HANDLER(Exit)
+  NOT_IMPLEMENTED_HANDLER(AssignObjectOwner)
+
+  /// Finish a task that was pushed.
+  ///
+  /// \return Whether the task was pushed.
+  bool FinishTask(int64_t seq_no) {
+    std::function<void(Status)> finish;
+    {
+      absl::MutexLock lock(&mu_);
+      auto it = tasks_.find(seq_no);
+      if (it == tasks_.end()) {
+        return false;
+      }
+      it->second.first->add_return_objects()->set_object_id(std::to_string(seq_no));
+      finish = std::move(it->second.second);
+      tasks_.erase(it);
+    }
+    finish(Status::OK());
+    return true;
+  }
+
+  bool HasTask(int64_t seq_no) {
+    absl::MutexLock lock(&mu_);
+    return tasks_.contains(seq_no);
+  }
+
+  int NumBatches() {
+    absl::MutexLock lock(&mu_);
+    return num_batches_;
+  }
+
+  ActorTaskBatchResults results_;
+
+ private:
+  const bool reject_batches_;
+  absl::Mutex mu_;
+  /// The reply and the callback to finish each pushed task, by sequence number.
+  absl::flat_hash_map<int64_t,
+                      std::pair<rpc::PushTaskReply *, std::function<void(Status)>>>
+      tasks_ GUARDED_BY(mu_);
+  int num_batches_ GUARDED_BY(mu_) = 0;
+};
+
+class PushTasksTest : public ::testing::Test {
+ public:
+  /// \param push_batch_size The actor_task_push_batch_size of the client.
+  /// \param max_push_rpcs_in_flight The actor_task_max_push_rpcs_in_flight of the
+  /// client.
+  /// \param reject_batches Whether the worker rejects batches of tasks.
+  explicit PushTasksTest(int64_t push_batch_size = 10,
+                         int64_t max_push_rpcs_in_flight = 1,
+                         bool reject_batches = false)
+      : handler_(reject_batches),
+        push_batch_size_(push_batch_size),
+        max_push_rpcs_in_flight_(max_push_rpcs_in_flight) {}
+
+  void SetUp() override {
+    RayConfig::instance().initialize(absl::StrFormat(
+        R"({"actor_task_push_batch_size": %d, "actor_task_max_push_rpcs_in_flight": %d})",
+        push_batch_size_, max_push_rpcs_in_flight_));
+    handler_thread_ = std::thread([this]() {
+      boost::asio::io_service::work work(handler_io_service_);
+      handler_io_service_.run();
+    });
+    service_ = std::make_unique<rpc::CoreWorkerGrpcService>(handler_io_service_,
+                                                            handler_);
+    server_ = std::make_unique<rpc::GrpcServer>("test", 0, true);
+    server_->RegisterService(*service_);
+    server_->Run();
+    while (server_->GetPort() == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    client_thread_ = std::thread([this]() {
+      boost::asio::io_service::work work(client_io_service_);
+      client_io_service_.run();
+    });
+    client_call_manager_ = std::make_unique<rpc::ClientCallManager>(client_io_service_);
+    rpc::Address address;
+    address.set_ip_address("127.0.0.1");
+    address.set_port(server_->GetPort());
+    client_ = std::make_shared<rpc::CoreWorkerClient>(address, *client_call_manager_);
+  }
+
+  void TearDown() override {
+    client_.reset();
+    client_call_manager_.reset();
+    client_io_service_.stop();
+    client_thread_.join();
+    server_->Shutdown();
+    handler_io_service_.stop();
+    handler_thread_.join();
+    RayConfig::instance().initialize("{}");
+  }
+
+  void PushActorTask(int64_t seq_no) {
+    auto request = std::make_unique<rpc::PushTaskRequest>();
+    request->set_sequence_number(seq_no);
+    client_->PushActorTask(
+        std::move(request), /*skip_queue=*/false,
+        [this, seq_no](Status status, const rpc::PushTaskReply &reply) {
+          ASSERT_TRUE(status.ok());
+          ASSERT_EQ(reply.return_objects(0).object_id(), std::to_string(seq_no));
+          absl::MutexLock lock(&mu_);
+          finished_.push_back(seq_no);
+        });
+  }
+
+  std::vector<int64_t> Finished() {
+    absl::MutexLock lock(&mu_);
+    return finished_;
+  }
+
+ protected:
+  PushTasksServiceHandler handler_;
+  const int64_t push_batch_size_;
+  const int64_t max_push_rpcs_in_flight_;
+  instrumented_io_context handler_io_service_;
+  std::thread handler_thread_;
+  std::unique_ptr<rpc::CoreWorkerGrpcService> service_;
+  std::unique_ptr<rpc::GrpcServer> server_;
+
+  instrumented_io_context client_io_service_;
+  std::thread client_thread_;
+  std::unique_ptr<rpc::ClientCallManager> client_call_manager_;
+  std::shared_ptr<rpc::CoreWorkerClient> client_;
+
+  absl::Mutex mu_;
+  std::vector<int64_t> finished_ GUARDED_BY(mu_);
+};
+
+TEST_F(PushTasksTest, TestResultsAreSentAsTasksFinish) {
+  // The first task is pushed in a batch of its own, to find out whether the worker
+  // accepts batches, and the others queue up behind it.
+  for (int64_t seq_no = 0; seq_no < 3; seq_no++) {
+    PushActorTask(seq_no);
+  }
+  ASSERT_TRUE(WaitForCondition([this]() { return handler_.HasTask(0); }, 10000));
+  ASSERT_FALSE(handler_.HasTask(1));
+  ASSERT_TRUE(handler_.FinishTask(0));
+
+  // The remaining tasks are pushed in one batch.
+  ASSERT_TRUE(WaitForCondition(
+      [this]() { return handler_.HasTask(1) && handler_.HasTask(2); }, 10000));
+  ASSERT_EQ(handler_.NumBatches(), 2);
+
+  // The result of a task of the batch is received before the next task of the
+  // batch finishes, which may depend on it.
+  ASSERT_TRUE(handler_.FinishTask(1));
+  ASSERT_TRUE(WaitForCondition([this]() { return Finished().size() == 2; }, 10000));
+  ASSERT_EQ(Finished(), (std::vector<int64_t>{0, 1}));
+
+  ASSERT_TRUE(handler_.FinishTask(2));
+  ASSERT_TRUE(WaitForCondition([this]() { return Finished().size() == 3; }, 10000));
+  ASSERT_EQ(Finished(), (std::vector<int64_t>{0, 1, 2}));
+  ASSERT_TRUE(
+      WaitForCondition([this]() { return handler_.results_.NumBatches() == 0; }, 10000));
+}
+
+/// A client with the default config that pushes tasks to an asyncio actor, which
+/// rejects batches.
+class AsyncActorPushTasksTest : public PushTasksTest {
+ public:
+  AsyncActorPushTasksTest()
+      : PushTasksTest(/*push_batch_size=*/100, /*max_push_rpcs_in_flight=*/4,
+                      /*reject_batches=*/true) {}
+};
+
+TEST_F(AsyncActorPushTasksTest, TestMutuallyDependentTasks) {
+  // Each task waits until all of them are running, e.g. on an asyncio.Event that the
+  // last one sets. The tasks in flight must not hold back the last one.
+  const int num_tasks = 5;
+  for (int64_t seq_no = 0; seq_no < num_tasks; seq_no++) {
+    PushActorTask(seq_no);
+  }
+  ASSERT_TRUE(WaitForCondition(
+      [this, num_tasks]() {
+        for (int64_t seq_no = 0; seq_no < num_tasks; seq_no++) {
+          if (!handler_.HasTask(seq_no)) {
+            return false;
+          }
+        }
+        return true;
+      },
+      10000));
+  for (int64_t seq_no = 0; seq_no < num_tasks; seq_no++) {
+    ASSERT_TRUE(handler_.FinishTask(seq_no));
+  }
+  ASSERT_TRUE(
+      WaitForCondition([this]() { return Finished().size() == num_tasks; }, 10000));
+  ASSERT_EQ(handler_.NumBatches(), 0);
+}
+
+}  // namespace core
+}  // namespace ray
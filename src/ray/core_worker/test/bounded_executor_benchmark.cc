@@ -0,0 +1,55 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include "ray/core_worker/transport/bounded_executor.h"
+#include "ray/util/util.h"
+
+namespace ray {
+namespace core {
+namespace {
+
+/// Post short tasks from one thread, like the actor scheduling queue does, and return
+/// the throughput in tasks per second.
+double MeasureThroughput(int max_concurrency, int num_tasks) {
+  std::atomic<int> num_finished(0);
+  BoundedExecutor executor(max_concurrency);
+  const int64_t start_us = current_sys_time_us();
+  for (int i = 0; i < num_tasks; i++) {
+    executor.PostBlocking([&num_finished]() { num_finished++; });
+  }
+  while (num_finished < num_tasks) {
+    std::this_thread::yield();
+  }
+  const int64_t elapsed_us = std::max<int64_t>(current_sys_time_us() - start_us, 1);
+  return num_tasks * 1e6 / elapsed_us;
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace ray
+
+/// Measure the throughput of the executor of threaded actors for short tasks.
+int main(int argc, char **argv) {
+  const int num_tasks = 100000;
+  for (int max_concurrency : {1, 8, 64}) {
+    std::cout << "Max concurrency " << max_concurrency << ": "
+              << ray::core::MeasureThroughput(max_concurrency, num_tasks) << " tasks/s"
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/transport/bounded_executor.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+namespace core {
+
+TEST(BoundedExecutorTest, TestMaxConcurrency) {
+  const int max_concurrency = 4;
+  BoundedExecutor executor(max_concurrency);
+  std::atomic<int> num_running(0);
+  std::atomic<int> max_running(0);
+  std::atomic<int> num_finished(0);
+  for (int i = 0; i < 200; i++) {
+    executor.PostBlocking([&]() {
+      int running = ++num_running;
+      int max = max_running;
+      while (running > max && !max_running.compare_exchange_weak(max, running)) {
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      num_running--;
+      num_finished++;
+    });
+  }
+  while (num_finished < 200) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_LE(max_running, max_concurrency);
+  ASSERT_GT(max_running, 1);
+}
+
+TEST(BoundedExecutorTest, TestPostBlocksWhenFull) {
+  BoundedExecutor executor(1);
+  std::atomic<bool> release(false);
+  std::atomic<bool> second_posted(false);
+  executor.PostBlocking([&release]() {
+    while (!release) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  std::thread poster([&]() {
+    executor.PostBlocking([]() {});
+    second_posted = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(second_posted);
+  release = true;
+  poster.join();
+  ASSERT_TRUE(second_posted);
+}
+
+TEST(BoundedExecutorTest, TestStop) {
+  BoundedExecutor executor(1);
+  std::atomic<bool> release(false);
+  executor.PostBlocking([&release]() {
+    while (!release) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  // A post to the full executor returns when the executor is stopped.
+  std::atomic<bool> ran(false);
+  std::thread poster([&]() { executor.PostBlocking([&ran]() { ran = true; }); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  executor.Stop();
+  poster.join();
+  release = true;
+  executor.Join();
+  executor.PostBlocking([&ran]() { ran = true; });
+  ASSERT_FALSE(ran);
+}
+
+}  // namespace core
+}  // namespace ray
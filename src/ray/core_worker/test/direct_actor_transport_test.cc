@@ -65,6 +65,23 @@ rpc::PushTaskRequest CreatePushTaskRequestHelper(ActorID actor_id, int64_t count
   return request;
 }
 
+rpc::PushTaskRequest CreateActorCreationRequestHelper(ActorID actor_id,
+                                                      int max_concurrency) {
+  TaskSpecification task;
+  task.GetMutableMessage().set_task_id(TaskID::ForActorCreationTask(actor_id).Binary());
+  task.GetMutableMessage().set_type(TaskType::ACTOR_CREATION_TASK);
+  auto actor_creation_spec = task.GetMutableMessage().mutable_actor_creation_task_spec();
+  actor_creation_spec->set_actor_id(actor_id.Binary());
+  actor_creation_spec->set_max_concurrency(max_concurrency);
+  task.GetMutableMessage().set_num_returns(1);
+
+  rpc::PushTaskRequest request;
+  request.mutable_task_spec()->CopyFrom(task.GetMessage());
+  request.set_sequence_number(-1);
+  request.set_client_processed_up_to(-1);
+  return request;
+}
+
 class MockWorkerClient : public rpc::CoreWorkerClientInterface {
  public:
   const rpc::Address &Addr() const override { return addr; }
@@ -651,6 +668,35 @@ TEST_F(DirectActorReceiverTest, TestNewTaskFromDifferentWorker) {
   StopIOService();
 }
 
+TEST_F(DirectActorReceiverTest, TestExecutesActorTasksInOrder) {
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  // Batches of tasks are rejected until the worker becomes an actor.
+  ASSERT_FALSE(receiver_->ExecutesActorTasksInOrder());
+
+  auto request = CreateActorCreationRequestHelper(actor_id, /*max_concurrency=*/1);
+  rpc::PushTaskReply reply;
+  receiver_->HandleTask(request, &reply,
+                        [](Status status, std::function<void()> success,
+                           std::function<void()> failure) {});
+  ASSERT_TRUE(receiver_->ExecutesActorTasksInOrder());
+
+  StopIOService();
+}
+
+TEST_F(DirectActorReceiverTest, TestThreadedActorExecutesTasksConcurrently) {
+  ActorID actor_id = ActorID::Of(JobID::FromInt(0), TaskID::Nil(), 0);
+  auto request = CreateActorCreationRequestHelper(actor_id, /*max_concurrency=*/4);
+  rpc::PushTaskReply reply;
+  receiver_->HandleTask(request, &reply,
+                        [](Status status, std::function<void()> success,
+                           std::function<void()> failure) {});
+  // A task of a batch could wait for a later task of the same batch, whose result is
+  // held back until the earlier tasks of the batch finish.
+  ASSERT_FALSE(receiver_->ExecutesActorTasksInOrder());
+
+  StopIOService();
+}
+
 }  // namespace core
 }  // namespace ray
 
@@ -194,9 +194,10 @@ class MockRayletClient : public WorkerLeaseInterface {
   }
 
   // Trigger reply to RequestWorkerLease.
-  bool GrantWorkerLease(const std::string &address, int port,
-                        const NodeID &retry_at_raylet_id, bool cancel = false,
-                        std::string worker_id = std::string()) {
+  bool GrantWorkerLease(
+      const std::string &address, int port, const NodeID &retry_at_raylet_id,
+      bool cancel = false, std::string worker_id = std::string(),
+      const std::unordered_map<std::string, double> &resource_mapping = {}) {
     rpc::RequestWorkerLeaseReply reply;
     if (cancel) {
       reply.set_canceled(true);
@@ -213,6 +214,13 @@ class MockRayletClient : public WorkerLeaseInterface {
       if (worker_id.length() == 28) {
         reply.mutable_worker_address()->set_worker_id(worker_id);
       }
+      for (const auto &resource : resource_mapping) {
+        auto entry = reply.add_resource_mapping();
+        entry->set_name(resource.first);
+        auto resource_id = entry->add_resource_ids();
+        resource_id->set_index(0);
+        resource_id->set_quantity(resource.second);
+      }
     }
     if (callbacks.size() == 0) {
       return false;
@@ -1280,6 +1288,163 @@ TEST(DirectTaskTransportTest, TestSchedulingKeys) {
   TestSchedulingKey(store, same_deps_1, same_deps_2, different_deps);
 }
 
+TEST(DirectTaskTransportTest, TestReuseWorkerLeaseAcrossSchedulingClasses) {
+  std::unordered_map<std::string, double> large_resources(
+      {{"CPU", 1.0}, {"memory", 100.0}});
+  std::unordered_map<std::string, double> small_resources({{"CPU", 1.0}});
+  FunctionDescriptor descriptor = FunctionDescriptorBuilder::BuildPython("a", "", "", "");
+
+  // Returns the number of leases requested to run one large task followed by three
+  // small ones.
+  auto run_mixed_tasks = [&](bool reuse_leases) {
+    RayConfig::instance().initialize(
+        std::string(R"({"reuse_worker_leases_across_scheduling_classes": )") +
+        (reuse_leases ? "true" : "false") + "}");
+    rpc::Address address;
+    auto raylet_client = std::make_shared<MockRayletClient>();
+    auto worker_client = std::make_shared<MockWorkerClient>();
+    auto store = std::make_shared<CoreWorkerMemoryStore>();
+    auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+        [&](const rpc::Address &addr) { return worker_client; });
+    auto task_finisher = std::make_shared<MockTaskFinisher>();
+    auto actor_creator = std::make_shared<MockActorCreator>();
+    auto lease_policy = std::make_shared<MockLeasePolicy>();
+    CoreWorkerDirectTaskSubmitter submitter(
+        address, raylet_client, client_pool, nullptr, lease_policy, store,
+        task_finisher, NodeID::Nil(), kLongTimeout, actor_creator, 1, absl::nullopt, 1);
+
+    ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(large_resources, descriptor)).ok());
+    for (int i = 0; i < 3; i++) {
+      ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(small_resources, descriptor)).ok());
+    }
+    ASSERT_EQ(raylet_client->num_workers_requested, 2);
+    ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil(), false,
+                                                "", large_resources));
+    ASSERT_EQ(worker_client->callbacks.size(), 1);
+
+    if (reuse_leases) {
+      // The large task's worker runs the small tasks, and the lease requested for them
+      // is canceled once none are left.
+      for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(worker_client->ReplyPushTask());
+        ASSERT_EQ(worker_client->callbacks.size(), 1);
+        ASSERT_EQ(raylet_client->num_workers_returned, 0);
+      }
+      ASSERT_EQ(submitter.GetNumLeasesReused(), 1);
+      ASSERT_EQ(raylet_client->num_leases_canceled, 1);
+      ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+      ASSERT_TRUE(
+          raylet_client->GrantWorkerLease("localhost", 1001, NodeID::Nil(), true));
+      ASSERT_TRUE(worker_client->ReplyPushTask());
+      ASSERT_EQ(raylet_client->num_workers_returned, 1);
+    } else {
+      // The large task's worker is returned, and the small tasks wait for their own
+      // lease.
+      ASSERT_TRUE(worker_client->ReplyPushTask());
+      ASSERT_EQ(raylet_client->num_workers_returned, 1);
+      ASSERT_EQ(worker_client->callbacks.size(), 0);
+      ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1001, NodeID::Nil(),
+                                                  false, "", small_resources));
+      for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(worker_client->callbacks.size(), 1);
+        ASSERT_TRUE(worker_client->ReplyPushTask());
+      }
+      ASSERT_EQ(submitter.GetNumLeasesReused(), 0);
+      ASSERT_EQ(raylet_client->num_leases_canceled, 1);
+      ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+      ASSERT_TRUE(
+          raylet_client->GrantWorkerLease("localhost", 1002, NodeID::Nil(), true));
+      ASSERT_EQ(raylet_client->num_workers_returned, 2);
+    }
+    ASSERT_EQ(task_finisher->num_tasks_complete, 4);
+    ASSERT_EQ(raylet_client->num_workers_requested, reuse_leases ? 2 : 3);
+    ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+  };
+
+  run_mixed_tasks(/*reuse_leases=*/false);
+  run_mixed_tasks(/*reuse_leases=*/true);
+  RayConfig::instance().initialize(
+      R"({"reuse_worker_leases_across_scheduling_classes": false})");
+}
+
+TEST(DirectTaskTransportTest, TestNoLeaseReuseForIncompatibleResources) {
+  RayConfig::instance().initialize(
+      R"({"reuse_worker_leases_across_scheduling_classes": true})");
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, 1, absl::nullopt, 1);
+  FunctionDescriptor descriptor = FunctionDescriptorBuilder::BuildPython("a", "", "", "");
+  std::unordered_map<std::string, double> gpu_resources({{"CPU", 1.0}, {"GPU", 1.0}});
+
+  // A task that needs more than the lease was granted, and a task that didn't ask for
+  // the lease's GPU.
+  ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(gpu_resources, descriptor)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec({{"CPU", 2.0}}, descriptor)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec({{"CPU", 1.0}}, descriptor)).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 3);
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil(), false,
+                                              "", gpu_resources));
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_EQ(worker_client->callbacks.size(), 0);
+  ASSERT_EQ(submitter.GetNumLeasesReused(), 0);
+  RayConfig::instance().initialize(
+      R"({"reuse_worker_leases_across_scheduling_classes": false})");
+}
+
+TEST(DirectTaskTransportTest, TestNoLeaseReuseForDifferentDependencies) {
+  RayConfig::instance().initialize(
+      R"({"reuse_worker_leases_across_scheduling_classes": true})");
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, 1, absl::nullopt, 1);
+  FunctionDescriptor descriptor = FunctionDescriptorBuilder::BuildPython("a", "", "", "");
+  std::unordered_map<std::string, double> large_resources(
+      {{"CPU", 1.0}, {"memory", 100.0}});
+
+  ObjectID plasma_id = ObjectID::FromRandom();
+  std::string meta = std::to_string(static_cast<int>(rpc::ErrorType::OBJECT_IN_PLASMA));
+  auto metadata = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(meta.data()));
+  auto meta_buffer = std::make_shared<LocalMemoryBuffer>(metadata, meta.size());
+  auto plasma_data = RayObject(nullptr, meta_buffer, std::vector<rpc::ObjectReference>());
+  ASSERT_TRUE(store->Put(plasma_data, plasma_id));
+
+  // The small task fits in the large task's lease, but depends on a plasma object
+  // that the lease wasn't placed near.
+  TaskSpecification small_task = BuildTaskSpec({{"CPU", 1.0}}, descriptor);
+  small_task.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+      plasma_id.Binary());
+  ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(large_resources, descriptor)).ok());
+  ASSERT_TRUE(submitter.SubmitTask(small_task).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil(), false,
+                                              "", large_resources));
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_EQ(worker_client->callbacks.size(), 0);
+  ASSERT_EQ(submitter.GetNumLeasesReused(), 0);
+  RayConfig::instance().initialize(
+      R"({"reuse_worker_leases_across_scheduling_classes": false})");
+}
+
 TEST(DirectTaskTransportTest, TestBacklogReport) {
   rpc::Address address;
   auto raylet_client = std::make_shared<MockRayletClient>();
@@ -1514,6 +1679,67 @@ TEST(DirectTaskTransportTest, TestKillResolvingTask) {
   ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
 }
 
+TEST(DirectTaskTransportTest, TestRequestWorkerWhileResolving) {
+  RayConfig::instance().initialize(R"({"pipeline_task_dependency_resolution": true})");
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, client_pool, nullptr,
+                                          lease_policy, store, task_finisher,
+                                          NodeID::Nil(), kLongTimeout, actor_creator);
+
+  // The worker is requested before the argument is available, and kept until the task
+  // can run on it with the argument inlined.
+  TaskSpecification task = BuildEmptyTaskSpec();
+  ObjectID obj1 = ObjectID::FromRandom();
+  task.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(obj1.Binary());
+  ASSERT_TRUE(submitter.SubmitTask(task).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 1);
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 0);
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+  auto data = GenerateRandomObject();
+  ASSERT_TRUE(store->Put(*data, obj1));
+  ASSERT_EQ(task_finisher->num_inlined_dependencies, 1);
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_EQ(raylet_client->num_workers_requested, 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+
+  // An argument that is stored in plasma can't be inlined, so the task is leased a
+  // worker of its own and the early lease request is canceled.
+  TaskSpecification plasma_task = BuildEmptyTaskSpec();
+  ObjectID obj2 = ObjectID::FromRandom();
+  plasma_task.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+      obj2.Binary());
+  ASSERT_TRUE(submitter.SubmitTask(plasma_task).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+  std::string meta = std::to_string(static_cast<int>(rpc::ErrorType::OBJECT_IN_PLASMA));
+  auto metadata = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(meta.data()));
+  auto meta_buffer = std::make_shared<LocalMemoryBuffer>(metadata, meta.size());
+  auto plasma_data = RayObject(nullptr, meta_buffer, std::vector<rpc::ObjectReference>());
+  ASSERT_TRUE(store->Put(plasma_data, obj2));
+  ASSERT_EQ(raylet_client->num_workers_requested, 3);
+  ASSERT_EQ(raylet_client->num_leases_canceled, 1);
+  ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1001, NodeID::Nil(), true));
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1002, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 2);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 2);
+  ASSERT_EQ(task_finisher->num_tasks_failed, 0);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+  RayConfig::instance().initialize(R"({"pipeline_task_dependency_resolution": false})");
+}
+
 TEST(DirectTaskTransportTest, TestPipeliningConcurrentWorkerLeases) {
   rpc::Address address;
   auto raylet_client = std::make_shared<MockRayletClient>();
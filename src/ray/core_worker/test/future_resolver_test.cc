@@ -0,0 +1,205 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/future_resolver.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "ray/common/test_util.h"
+#include "ray/core_worker/reference_count.h"
+#include "ray/core_worker/store_provider/memory_store/memory_store.h"
+#include "ray/pubsub/mock_pubsub.h"
+
+namespace ray {
+namespace core {
+
+class MockOwnerClient : public rpc::CoreWorkerClientInterface {
+ public:
+  void GetObjectStatusBatch(
+      const rpc::GetObjectStatusBatchRequest &request,
+      const rpc::ClientCallback<rpc::GetObjectStatusBatchReply> &callback) override {
+    requests.push_back(request);
+    callbacks.push_back(callback);
+  }
+
+  /// Reply to the oldest request with the values of the given objects.
+  void ReplyObjectStatusBatch(const std::vector<ObjectID> &created_ids,
+                              Status status = Status::OK()) {
+    ASSERT_FALSE(callbacks.empty());
+    rpc::GetObjectStatusBatchReply reply;
+    for (const auto &object_id : created_ids) {
+      auto entry = reply.add_statuses();
+      entry->set_object_id(object_id.Binary());
+      entry->mutable_status()->set_status(rpc::GetObjectStatusReply::CREATED);
+      entry->mutable_status()->mutable_object()->set_data("value");
+    }
+    auto callback = callbacks.front();
+    callbacks.pop_front();
+    callback(status, reply);
+  }
+
+  std::vector<rpc::GetObjectStatusBatchRequest> requests;
+  std::list<rpc::ClientCallback<rpc::GetObjectStatusBatchReply>> callbacks;
+};
+
+class FutureResolverTest : public ::testing::Test {
+ public:
+  FutureResolverTest()
+      : store_(std::make_shared<CoreWorkerMemoryStore>()),
+        publisher_(std::make_shared<mock_pubsub::MockPublisher>()),
+        subscriber_(std::make_shared<mock_pubsub::MockSubscriber>()),
+        reference_counter_(std::make_shared<ReferenceCounter>(
+            rpc::Address(), publisher_.get(), subscriber_.get())),
+        owner_client_(std::make_shared<MockOwnerClient>()),
+        resolver_(
+            store_, reference_counter_,
+            [](const ObjectID &, const absl::flat_hash_set<NodeID> &, uint64_t) {},
+            std::make_shared<rpc::CoreWorkerClientPool>(
+                [this](const rpc::Address &) { return owner_client_; }),
+            rpc::Address(), io_service_) {
+    owner_address_.set_worker_id(WorkerID::FromRandom().Binary());
+  }
+
+  /// Send the requests that are queued for the owners.
+  void SendRequests() {
+    io_service_.poll();
+    io_service_.restart();
+  }
+
+  bool Contains(const ObjectID &object_id) {
+    return store_->GetIfExists(object_id) != nullptr;
+  }
+
+  instrumented_io_context io_service_;
+  std::shared_ptr<CoreWorkerMemoryStore> store_;
+  std::shared_ptr<mock_pubsub::MockPublisher> publisher_;
+  std::shared_ptr<mock_pubsub::MockSubscriber> subscriber_;
+  std::shared_ptr<ReferenceCounter> reference_counter_;
+  std::shared_ptr<MockOwnerClient> owner_client_;
+  rpc::Address owner_address_;
+  FutureResolver resolver_;
+};
+
+TEST_F(FutureResolverTest, TestBatchesFuturesOfOwner) {
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 3; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    resolver_.ResolveFutureAsync(object_ids.back(), owner_address_);
+  }
+  // Resolving a future twice doesn't ask for it twice.
+  resolver_.ResolveFutureAsync(object_ids[0], owner_address_);
+  SendRequests();
+  ASSERT_EQ(owner_client_->requests.size(), 1);
+  ASSERT_EQ(owner_client_->requests[0].object_ids_size(), 3);
+
+  // The owner replies once one of the values is available, and keeps the rest of the
+  // batch, which we poll for without sending the object IDs again.
+  owner_client_->ReplyObjectStatusBatch({object_ids[1]});
+  ASSERT_TRUE(Contains(object_ids[1]));
+  ASSERT_FALSE(Contains(object_ids[0]));
+  SendRequests();
+  ASSERT_EQ(owner_client_->requests.size(), 2);
+  ASSERT_EQ(owner_client_->requests[1].object_ids_size(), 0);
+  ASSERT_FALSE(owner_client_->requests[0].batch_id().empty());
+  ASSERT_EQ(owner_client_->requests[1].batch_id(),
+            owner_client_->requests[0].batch_id());
+
+  owner_client_->ReplyObjectStatusBatch({object_ids[0], object_ids[2]});
+  ASSERT_TRUE(Contains(object_ids[0]));
+  ASSERT_TRUE(Contains(object_ids[2]));
+  SendRequests();
+  ASSERT_EQ(owner_client_->requests.size(), 2);
+}
+
+TEST_F(FutureResolverTest, TestBatchSize) {
+  RayConfig::instance().initialize(R"({"get_object_status_batch_size": 2})");
+  FutureResolver resolver(
+      store_, reference_counter_,
+      [](const ObjectID &, const absl::flat_hash_set<NodeID> &, uint64_t) {},
+      std::make_shared<rpc::CoreWorkerClientPool>(
+          [this](const rpc::Address &) { return owner_client_; }),
+      rpc::Address(), io_service_);
+  for (int i = 0; i < 5; i++) {
+    resolver.ResolveFutureAsync(ObjectID::FromRandom(), owner_address_);
+  }
+  SendRequests();
+  ASSERT_EQ(owner_client_->requests.size(), 3);
+  ASSERT_EQ(owner_client_->requests[2].object_ids_size(), 1);
+  RayConfig::instance().initialize(R"({"get_object_status_batch_size": 100})");
+}
+
+TEST_F(FutureResolverTest, TestOwnerDied) {
+  auto object_id = ObjectID::FromRandom();
+  resolver_.ResolveFutureAsync(object_id, owner_address_);
+  SendRequests();
+  owner_client_->ReplyObjectStatusBatch({}, Status::IOError("owner died"));
+  auto obj = store_->GetIfExists(object_id);
+  ASSERT_NE(obj, nullptr);
+  rpc::ErrorType error_type;
+  ASSERT_TRUE(obj->IsException(&error_type));
+  ASSERT_EQ(error_type, rpc::ErrorType::OWNER_DIED);
+  SendRequests();
+  ASSERT_EQ(owner_client_->requests.size(), 1);
+}
+
+TEST_F(FutureResolverTest, TestOwnerDiedWhilePolling) {
+  auto object_id = ObjectID::FromRandom();
+  auto other_id = ObjectID::FromRandom();
+  resolver_.ResolveFutureAsync(object_id, owner_address_);
+  resolver_.ResolveFutureAsync(other_id, owner_address_);
+  SendRequests();
+  owner_client_->ReplyObjectStatusBatch({object_id});
+  ASSERT_EQ(owner_client_->requests.size(), 2);
+  owner_client_->ReplyObjectStatusBatch({}, Status::IOError("owner died"));
+  rpc::ErrorType error_type;
+  ASSERT_TRUE(store_->GetIfExists(other_id)->IsException(&error_type));
+  ASSERT_EQ(error_type, rpc::ErrorType::OWNER_DIED);
+  ASSERT_FALSE(store_->GetIfExists(object_id)->IsException());
+  SendRequests();
+  ASSERT_EQ(owner_client_->requests.size(), 2);
+}
+
+TEST_F(FutureResolverTest, TestPushedReturnObjects) {
+  auto object_id = ObjectID::FromRandom();
+  auto other_id = ObjectID::FromRandom();
+  resolver_.ResolveFutureAsync(object_id, owner_address_);
+  SendRequests();
+
+  google::protobuf::RepeatedPtrField<rpc::ReturnObject> return_objects;
+  for (const auto &id : {object_id, other_id}) {
+    auto return_object = return_objects.Add();
+    return_object->set_object_id(id.Binary());
+    return_object->set_data("pushed");
+  }
+  resolver_.ProcessPushedReturnObjects(owner_address_, return_objects);
+  ASSERT_TRUE(Contains(object_id));
+  // Objects that we don't resolve are ignored.
+  ASSERT_FALSE(Contains(other_id));
+
+  // The owner's reply for a future that was pushed is ignored.
+  owner_client_->ReplyObjectStatusBatch({object_id});
+  SendRequests();
+  ASSERT_EQ(owner_client_->requests.size(), 1);
+  auto data = store_->GetIfExists(object_id)->GetData();
+  ASSERT_EQ(std::string(reinterpret_cast<const char *>(data->Data()), data->Size()),
+            "pushed");
+}
+
+}  // namespace core
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,60 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+
+#include "ray/core_worker/lineage_log.h"
+
+namespace ray {
+namespace core {
+namespace {
+
+TaskSpecification MakeSpec(const std::string &function_name,
+                           const std::string &inlined_arg, const ObjectID &dep) {
+  TaskSpecification spec;
+  auto &message = spec.GetMutableMessage();
+  message.set_task_id(TaskID::ForFakeTask().Binary());
+  message.set_num_returns(1);
+  message.set_max_retries(3);
+  message.mutable_function_descriptor()
+      ->mutable_python_function_descriptor()
+      ->set_function_name(function_name);
+  message.mutable_function_descriptor()
+      ->mutable_python_function_descriptor()
+      ->set_module_name("module");
+  message.add_args()->set_data(inlined_arg);
+  message.add_args()->mutable_object_ref()->set_object_id(dep.Binary());
+  return spec;
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace ray
+
+/// Measure the lineage bytes per task of an iterative workload that passes the same
+/// large value to many invocations of the same function.
+int main(int argc, char **argv) {
+  const int num_tasks = 1000;
+  const std::string large_arg(10 * 1024, 'a');
+  ray::core::LineageLog log;
+  size_t spec_bytes = 0;
+  for (int i = 0; i < num_tasks; i++) {
+    auto spec = ray::core::MakeSpec("train_step", large_arg, ray::ObjectID::FromRandom());
+    spec_bytes += spec.GetMessage().ByteSizeLong();
+    log.Add(spec);
+  }
+  std::cout << "Lineage bytes per task: " << spec_bytes / num_tasks << " serialized, "
+            << log.NumBytes() / num_tasks << " in the log." << std::endl;
+  return 0;
+}
@@ -0,0 +1,115 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/lineage_log.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+namespace core {
+
+namespace {
+
+TaskSpecification MakeSpec(const std::string &function_name,
+                           const std::string &inlined_arg, const ObjectID &dep) {
+  TaskSpecification spec;
+  auto &message = spec.GetMutableMessage();
+  message.set_task_id(TaskID::ForFakeTask().Binary());
+  message.set_num_returns(1);
+  message.set_max_retries(3);
+  message.mutable_function_descriptor()
+      ->mutable_python_function_descriptor()
+      ->set_function_name(function_name);
+  message.mutable_function_descriptor()
+      ->mutable_python_function_descriptor()
+      ->set_module_name("module");
+  message.add_args()->set_data(inlined_arg);
+  message.add_args()->mutable_object_ref()->set_object_id(dep.Binary());
+  return spec;
+}
+
+}  // namespace
+
+TEST(LineageLogTest, TestRoundTrip) {
+  LineageLog log;
+  auto spec = MakeSpec("f", std::string(1024, 'a'), ObjectID::FromRandom());
+  spec.GetMutableMessage().set_parent_counter(7);
+  log.Add(spec);
+  ASSERT_EQ(log.Size(), 1);
+  ASSERT_EQ(log.Oldest(), spec.TaskId());
+  ASSERT_GT(log.NumBytes(), 1024);
+
+  TaskSpecification restored;
+  ASSERT_TRUE(log.Get(spec.TaskId(), &restored));
+  ASSERT_EQ(restored.GetMessage().SerializeAsString(),
+            spec.GetMessage().SerializeAsString());
+  ASSERT_FALSE(log.Get(TaskID::ForFakeTask(), &restored));
+
+  ASSERT_TRUE(log.Remove(spec.TaskId()));
+  ASSERT_FALSE(log.Remove(spec.TaskId()));
+  ASSERT_EQ(log.Size(), 0);
+  ASSERT_EQ(log.NumBytes(), 0);
+  ASSERT_TRUE(log.Oldest().IsNil());
+}
+
+TEST(LineageLogTest, TestSharedFields) {
+  LineageLog log;
+  const std::string large_arg(1024, 'a');
+  auto first = MakeSpec("f", large_arg, ObjectID::FromRandom());
+  auto second = MakeSpec("f", large_arg, ObjectID::FromRandom());
+  auto other = MakeSpec("g", "small", ObjectID::FromRandom());
+  log.Add(first);
+  int64_t first_bytes = log.NumBytes();
+  // The second task only adds the fields that differ from the first one.
+  log.Add(second);
+  ASSERT_LT(log.NumBytes() - first_bytes, 200);
+  log.Add(other);
+  ASSERT_EQ(log.Oldest(), first.TaskId());
+
+  TaskSpecification restored;
+  for (const auto &spec : {first, second, other}) {
+    ASSERT_TRUE(log.Get(spec.TaskId(), &restored));
+    ASSERT_EQ(restored.GetMessage().SerializeAsString(),
+              spec.GetMessage().SerializeAsString());
+  }
+
+  // The shared fields stay until the last task that has them is removed.
+  ASSERT_TRUE(log.Remove(first.TaskId()));
+  ASSERT_EQ(log.Oldest(), second.TaskId());
+  ASSERT_TRUE(log.Get(second.TaskId(), &restored));
+  ASSERT_EQ(restored.GetMessage().SerializeAsString(),
+            second.GetMessage().SerializeAsString());
+  ASSERT_TRUE(log.Remove(second.TaskId()));
+  ASSERT_LT(log.NumBytes(), 1024);
+  ASSERT_TRUE(log.Remove(other.TaskId()));
+  ASSERT_EQ(log.NumBytes(), 0);
+}
+
+/// An iterative workload that passes the same large value to many invocations of the
+/// same function only keeps one copy of it.
+TEST(LineageLogTest, TestBytesPerTask) {
+  const int num_tasks = 100;
+  const std::string large_arg(10 * 1024, 'a');
+  LineageLog log;
+  size_t spec_bytes = 0;
+  for (int i = 0; i < num_tasks; i++) {
+    auto spec = MakeSpec("train_step", large_arg, ObjectID::FromRandom());
+    spec_bytes += spec.GetMessage().ByteSizeLong();
+    log.Add(spec);
+  }
+  ASSERT_LT(log.NumBytes() * 10, static_cast<int64_t>(spec_bytes));
+}
+
+}  // namespace core
+}  // namespace ray
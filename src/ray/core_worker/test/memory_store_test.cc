@@ -14,9 +14,12 @@
 
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
 
+#include <thread>
+
 #include "absl/synchronization/mutex.h"
 #include "gtest/gtest.h"
 #include "ray/common/test_util.h"
+#include "ray/core_worker/store_provider/as_completed_get.h"
 
 namespace ray {
 namespace core {
@@ -124,6 +127,149 @@ TEST(TestMemoryStore, TestMemoryStoreStats) {
   ASSERT_EQ(item.used_object_store_memory, expected_item3.used_object_store_memory);
 }
 
+TEST(TestMemoryStore, TestAsCompletedGet) {
+  auto provider = std::make_shared<CoreWorkerMemoryStore>();
+  auto id1 = ObjectID::FromRandom();
+  auto id2 = ObjectID::FromRandom();
+  auto id3 = ObjectID::FromRandom();
+  RayObject obj(rpc::ErrorType::TASK_EXECUTION_EXCEPTION);
+  int num_plasma_calls = 0;
+  int num_blocked = 0;
+  int num_done = 0;
+  AsCompletedGet get(
+      {id1, id2, id1, id3}, *provider,
+      [&](const std::vector<ObjectID> &object_ids) {
+        num_plasma_calls++;
+        return Status::OK();
+      },
+      [&](const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
+          absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results) {
+        num_plasma_calls++;
+        return Status::OK();
+      },
+      [&]() { num_blocked++; }, [&]() { num_done++; });
+
+  // An object that is already available is returned right away.
+  RAY_CHECK(provider->Put(obj, id2));
+  std::vector<AsCompletedGet::ReadyObject> ready;
+  ASSERT_TRUE(get.Next(-1, &ready).ok());
+  ASSERT_EQ(ready.size(), 1);
+  ASSERT_EQ(ready[0].first, 1);
+  ASSERT_EQ(num_blocked, 0);
+
+  // Time out while blocked on the memory store. The worker stays blocked until the
+  // get ends.
+  ASSERT_TRUE(get.Next(10, &ready).IsTimedOut());
+  ASSERT_TRUE(ready.empty());
+  ASSERT_EQ(num_blocked, 1);
+  ASSERT_EQ(num_done, 0);
+
+  // Objects that become available while blocked are returned once per index.
+  std::thread put_thread([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    RAY_CHECK(provider->Put(obj, id1));
+  });
+  ASSERT_TRUE(get.Next(-1, &ready).ok());
+  put_thread.join();
+  ASSERT_EQ(ready.size(), 2);
+  ASSERT_EQ(ready[0].first, 0);
+  ASSERT_EQ(ready[1].first, 2);
+  ASSERT_FALSE(get.Done());
+  ASSERT_EQ(num_blocked, 1);
+
+  RAY_CHECK(provider->Put(obj, id3));
+  ASSERT_TRUE(get.Next(-1, &ready).ok());
+  ASSERT_EQ(ready.size(), 1);
+  ASSERT_EQ(ready[0].first, 3);
+  ASSERT_TRUE(get.Done());
+  ASSERT_EQ(num_done, 1);
+  ASSERT_TRUE(get.Next(-1, &ready).ok());
+  ASSERT_TRUE(ready.empty());
+  ASSERT_EQ(num_plasma_calls, 0);
+  ASSERT_EQ(num_done, 1);
+}
+
+TEST(TestMemoryStore, TestAsCompletedGetPromotedObjects) {
+  auto provider = std::make_shared<CoreWorkerMemoryStore>();
+  auto plasma_id = ObjectID::FromRandom();
+  auto memory_id = ObjectID::FromRandom();
+  auto obj = std::make_shared<RayObject>(rpc::ErrorType::TASK_EXECUTION_EXCEPTION);
+  std::vector<std::vector<ObjectID>> fetches;
+  std::vector<int64_t> plasma_timeouts;
+  std::atomic<bool> in_plasma(false);
+  int num_done = 0;
+  AsCompletedGet get(
+      {plasma_id, memory_id}, *provider,
+      [&](const std::vector<ObjectID> &object_ids) {
+        fetches.push_back(object_ids);
+        return Status::OK();
+      },
+      [&](const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
+          absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results) {
+        EXPECT_EQ(object_ids, std::vector<ObjectID>({plasma_id}));
+        plasma_timeouts.push_back(timeout_ms);
+        if (in_plasma) {
+          (*results)[plasma_id] = obj;
+        }
+        return Status::OK();
+      },
+      nullptr, [&]() { num_done++; });
+
+  // The fetch of a promoted object is started as soon as it's promoted, and the
+  // objects in the memory store don't wait for it. The object is fetched once, and
+  // polled for in the local store without interrupting the fetch.
+  RAY_CHECK(provider->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), plasma_id));
+  std::thread put_thread([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    RAY_CHECK(provider->Put(*obj, memory_id));
+  });
+  std::vector<AsCompletedGet::ReadyObject> ready;
+  ASSERT_TRUE(get.Next(-1, &ready).ok());
+  put_thread.join();
+  ASSERT_EQ(ready.size(), 1);
+  ASSERT_EQ(ready[0].first, 1);
+  ASSERT_EQ(plasma_timeouts[0], 0);
+  ASSERT_GT(plasma_timeouts.size(), 1);
+  for (size_t i = 1; i < plasma_timeouts.size(); i++) {
+    ASSERT_LE(plasma_timeouts[i],
+              RayConfig::instance().get_as_completed_plasma_poll_milliseconds());
+  }
+  ASSERT_EQ(fetches, std::vector<std::vector<ObjectID>>({{plasma_id}}));
+  ASSERT_EQ(num_done, 0);
+
+  in_plasma = true;
+  ASSERT_TRUE(get.Next(-1, &ready).ok());
+  ASSERT_EQ(ready.size(), 1);
+  ASSERT_EQ(ready[0].first, 0);
+  ASSERT_EQ(ready[0].second, obj);
+  ASSERT_TRUE(get.Done());
+  ASSERT_EQ(fetches.size(), 1);
+  // The fetch ends with the get.
+  ASSERT_EQ(num_done, 1);
+}
+
+TEST(TestMemoryStore, TestAsCompletedGetEndsFetchWhenDestroyed) {
+  auto provider = std::make_shared<CoreWorkerMemoryStore>();
+  auto plasma_id = ObjectID::FromRandom();
+  int num_done = 0;
+  {
+    AsCompletedGet get(
+        {plasma_id, ObjectID::FromRandom()}, *provider,
+        [&](const std::vector<ObjectID> &object_ids) { return Status::OK(); },
+        [&](const std::vector<ObjectID> &object_ids, int64_t timeout_ms,
+            absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results) {
+          return Status::OK();
+        },
+        nullptr, [&]() { num_done++; });
+    RAY_CHECK(provider->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), plasma_id));
+    std::vector<AsCompletedGet::ReadyObject> ready;
+    ASSERT_TRUE(get.Next(10, &ready).IsTimedOut());
+    ASSERT_EQ(num_done, 0);
+  }
+  // A get that is abandoned, e.g., because of an error, ends its fetch as well.
+  ASSERT_EQ(num_done, 1);
+}
+
 }  // namespace core
 }  // namespace ray
 
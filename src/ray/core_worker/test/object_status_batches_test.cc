@@ -0,0 +1,103 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/object_status_batches.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+namespace core {
+
+rpc::ObjectStatusEntry CreatedEntry(const std::string &object_id) {
+  rpc::ObjectStatusEntry entry;
+  entry.set_object_id(object_id);
+  entry.mutable_status()->set_status(rpc::GetObjectStatusReply::CREATED);
+  return entry;
+}
+
+TEST(ObjectStatusBatchesTest, TestStatusesAsAvailable) {
+  ObjectStatusBatches batches;
+  batches.AddBatch("batch", 3);
+  // Statuses that are known before the first poll are sent in its reply.
+  batches.AddStatus("batch", CreatedEntry("a"));
+
+  int num_replies = 0;
+  Status reply_status;
+  auto send_reply = [&num_replies, &reply_status](Status status,
+                                                  std::function<void()> success,
+                                                  std::function<void()> failure) {
+    num_replies++;
+    reply_status = status;
+  };
+  rpc::GetObjectStatusBatchReply reply;
+  batches.Poll("batch", &reply, send_reply);
+  ASSERT_EQ(num_replies, 1);
+  ASSERT_TRUE(reply_status.ok());
+  ASSERT_EQ(reply.statuses_size(), 1);
+  ASSERT_EQ(reply.statuses(0).object_id(), "a");
+
+  // The statuses that become available while the borrower isn't polling are sent
+  // together.
+  batches.AddStatus("batch", CreatedEntry("b"));
+  batches.AddStatus("batch", CreatedEntry("c"));
+  ASSERT_EQ(batches.NumBatches(), 1);
+  rpc::GetObjectStatusBatchReply last_reply;
+  batches.Poll("batch", &last_reply, send_reply);
+  ASSERT_EQ(num_replies, 2);
+  ASSERT_EQ(last_reply.statuses_size(), 2);
+  ASSERT_EQ(last_reply.statuses(0).object_id(), "b");
+  ASSERT_EQ(last_reply.statuses(1).object_id(), "c");
+  ASSERT_EQ(batches.NumBatches(), 0);
+}
+
+TEST(ObjectStatusBatchesTest, TestPollWaitsForStatus) {
+  ObjectStatusBatches batches;
+  batches.AddBatch("batch", 1);
+  int num_replies = 0;
+  auto send_reply = [&num_replies](Status status, std::function<void()> success,
+                                   std::function<void()> failure) { num_replies++; };
+  rpc::GetObjectStatusBatchReply reply;
+  batches.Poll("batch", &reply, send_reply);
+  ASSERT_EQ(num_replies, 0);
+  batches.AddStatus("batch", CreatedEntry("a"));
+  ASSERT_EQ(num_replies, 1);
+  ASSERT_EQ(reply.statuses_size(), 1);
+  ASSERT_EQ(batches.NumBatches(), 0);
+}
+
+TEST(ObjectStatusBatchesTest, TestAbandonedBatch) {
+  ObjectStatusBatches batches;
+  batches.AddBatch("batch", 2);
+  batches.AddBatch("polled", 1);
+  Status reply_status;
+  auto send_reply = [&reply_status](Status status, std::function<void()> success,
+                                    std::function<void()> failure) {
+    reply_status = status;
+  };
+  rpc::GetObjectStatusBatchReply polled_reply;
+  batches.Poll("polled", &polled_reply, send_reply);
+
+  // A batch with a pending poll is never abandoned.
+  batches.EraseAbandonedBatches(-1);
+  ASSERT_EQ(batches.NumBatches(), 1);
+  // Statuses of an abandoned batch are ignored, and polls for it are rejected.
+  batches.AddStatus("batch", CreatedEntry("a"));
+  rpc::GetObjectStatusBatchReply reply;
+  batches.Poll("batch", &reply, send_reply);
+  ASSERT_TRUE(reply_status.IsInvalid());
+  ASSERT_EQ(reply.statuses_size(), 0);
+}
+
+}  // namespace core
+}  // namespace ray
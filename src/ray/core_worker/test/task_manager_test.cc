@@ -39,7 +39,8 @@ TaskSpecification CreateTaskHelper(uint64_t num_returns,
 
 class TaskManagerTest : public ::testing::Test {
  public:
-  TaskManagerTest(bool lineage_pinning_enabled = false)
+  TaskManagerTest(bool lineage_pinning_enabled = false,
+                  int64_t max_lineage_bytes = std::numeric_limits<int64_t>::max())
       : store_(std::shared_ptr<CoreWorkerMemoryStore>(new CoreWorkerMemoryStore())),
         publisher_(std::make_shared<mock_pubsub::MockPublisher>()),
         subscriber_(std::make_shared<mock_pubsub::MockSubscriber>()),
@@ -61,7 +62,8 @@ class TaskManagerTest : public ::testing::Test {
             },
             [](const JobID &job_id, const std::string &type,
                const std::string &error_message,
-               double timestamp) { return Status::OK(); }) {}
+               double timestamp) { return Status::OK(); },
+            max_lineage_bytes) {}
 
   std::shared_ptr<CoreWorkerMemoryStore> store_;
   std::shared_ptr<mock_pubsub::MockPublisher> publisher_;
@@ -79,6 +81,12 @@ class TaskManagerLineageTest : public TaskManagerTest {
   TaskManagerLineageTest() : TaskManagerTest(true) {}
 };
 
+class TaskManagerLineageBudgetTest : public TaskManagerTest {
+ public:
+  /// A budget that fits the lineage of one task, but not of two.
+  TaskManagerLineageBudgetTest() : TaskManagerTest(true, 100) {}
+};
+
 TEST_F(TaskManagerTest, TestTaskSuccess) {
   rpc::Address caller_address;
   ObjectID dep1 = ObjectID::FromRandom();
@@ -531,6 +539,49 @@ TEST_F(TaskManagerLineageTest, TestResubmitTask) {
   ASSERT_EQ(num_retries_, 1);
 }
 
+// Test that the oldest lineage is evicted once the lineage exceeds its budget, and
+// that the evicted task can no longer be resubmitted.
+TEST_F(TaskManagerLineageBudgetTest, TestLineageEvicted) {
+  rpc::Address caller_address;
+  int num_retries = 3;
+  std::vector<TaskSpecification> specs;
+  std::vector<ObjectID> deps;
+  for (int i = 0; i < 2; i++) {
+    deps.push_back(ObjectID::FromRandom());
+    auto spec = CreateTaskHelper(1, {deps.back()});
+    manager_.AddPendingTask(caller_address, spec, "", num_retries);
+    auto return_id = spec.ReturnId(0);
+    reference_counter_->AddLocalReference(return_id, "");
+    rpc::PushTaskReply reply;
+    auto return_object = reply.add_return_objects();
+    return_object->set_object_id(return_id.Binary());
+    auto data = GenerateRandomBuffer();
+    return_object->set_data(data->Data(), data->Size());
+    return_object->set_in_plasma(true);
+    manager_.CompletePendingTask(spec.TaskId(), reply, rpc::Address());
+    specs.push_back(spec);
+  }
+
+  // The first task was evicted, and the reference to its argument was released.
+  ASSERT_EQ(manager_.NumLineageEvictions(), 1);
+  ASSERT_EQ(manager_.NumLineageTasks(), 1);
+  ASSERT_GT(manager_.NumLineageBytes(), 0);
+  ASSERT_LE(manager_.NumLineageBytes(), 100);
+  ASSERT_FALSE(manager_.IsTaskSubmissible(specs[0].TaskId()));
+  ASSERT_FALSE(reference_counter_->HasReference(deps[0]));
+  ASSERT_TRUE(manager_.IsTaskSubmissible(specs[1].TaskId()));
+  ASSERT_TRUE(reference_counter_->HasReference(deps[1]));
+
+  std::vector<ObjectID> resubmitted_task_deps;
+  ASSERT_FALSE(manager_.ResubmitTask(specs[0].TaskId(), &resubmitted_task_deps).ok());
+  ASSERT_TRUE(resubmitted_task_deps.empty());
+  ASSERT_TRUE(manager_.ResubmitTask(specs[1].TaskId(), &resubmitted_task_deps).ok());
+  ASSERT_EQ(resubmitted_task_deps, specs[1].GetDependencyIds());
+  // The spec of the resubmitted task is no longer in the lineage log.
+  ASSERT_EQ(manager_.NumLineageTasks(), 0);
+  ASSERT_EQ(manager_.NumLineageBytes(), 0);
+}
+
 // Test resubmission for a task that was successfully executed once and stored
 // its return values in plasma. On re-execution, the task's return values
 // should be stored in plasma again, even if the worker returns its values
@@ -588,6 +639,163 @@ TEST_F(TaskManagerLineageTest, TestResubmittedTaskNondeterministicReturns) {
   ASSERT_FALSE(stored_in_plasma.count(return_id2));
 }
 
+rpc::ReportGeneratorItemReturnsRequest GeneratorItemHelper(const TaskSpecification &spec,
+                                                          int64_t item_index) {
+  rpc::ReportGeneratorItemReturnsRequest request;
+  request.set_generator_id(spec.ReturnId(0).Binary());
+  request.set_item_index(item_index);
+  auto return_object = request.mutable_returned_object();
+  return_object->set_object_id(
+      ObjectID::FromIndex(spec.TaskId(), /*index=*/item_index + 2).Binary());
+  auto data = GenerateRandomBuffer();
+  return_object->set_data(data->Data(), data->Size());
+  return request;
+}
+
+TEST(ObjectRefStreamTest, TestReadInOrder) {
+  ObjectRefStream stream(rpc::Address(), "");
+  ObjectID id0 = ObjectID::FromRandom();
+  ObjectID id1 = ObjectID::FromRandom();
+  ObjectID id2 = ObjectID::FromRandom();
+  ASSERT_FALSE(stream.IsReadable());
+  ASSERT_TRUE(stream.Insert(1, id1));
+  ASSERT_FALSE(stream.Insert(1, id1));
+  // The values are read in the order of the stream, not the order they were added.
+  ASSERT_FALSE(stream.IsReadable());
+  ASSERT_TRUE(stream.TryRead().IsNil());
+  ASSERT_TRUE(stream.Insert(0, id0));
+  ASSERT_EQ(stream.TryRead(), id0);
+  ASSERT_EQ(stream.TryRead(), id1);
+  ASSERT_FALSE(stream.Insert(0, id0));
+  ASSERT_TRUE(stream.TryRead().IsNil());
+
+  // Values after a gap at the end of the stream are dropped.
+  ASSERT_TRUE(stream.Insert(3, id2));
+  stream.MarkEnd();
+  ASSERT_TRUE(stream.IsEnded());
+  ASSERT_TRUE(stream.IsReadable());
+  ASSERT_FALSE(stream.Insert(2, id2));
+  ASSERT_TRUE(stream.TryRead().IsNil());
+  ASSERT_EQ(stream.UnreadItems(), std::vector<ObjectID>{id2});
+}
+
+TEST(ObjectRefStreamTest, TestEndAfterUnreadValues) {
+  ObjectRefStream stream(rpc::Address(), "");
+  ObjectID id0 = ObjectID::FromRandom();
+  ObjectID id1 = ObjectID::FromRandom();
+  ASSERT_TRUE(stream.Insert(0, id0));
+  ASSERT_TRUE(stream.Insert(1, id1));
+  stream.MarkEnd();
+  ASSERT_FALSE(stream.IsEnded());
+  ASSERT_EQ(stream.TryRead(), id0);
+  ASSERT_EQ(stream.TryRead(), id1);
+  ASSERT_TRUE(stream.IsEnded());
+  ASSERT_TRUE(stream.TryRead().IsNil());
+}
+
+TEST_F(TaskManagerTest, TestStreamingGeneratorTask) {
+  rpc::Address caller_address;
+  auto spec = CreateTaskHelper(1, {});
+  spec.GetMutableMessage().set_streaming_generator(true);
+  manager_.AddPendingTask(caller_address, spec, "");
+  auto generator_id = spec.ReturnId(0);
+  ObjectID object_id;
+  bool end_of_stream;
+  bool in_plasma = false;
+  ASSERT_FALSE(manager_.WaitForObjectRefStream(generator_id, 0));
+
+  // The values are owned by the caller and readable as soon as they are reported.
+  auto item0 = GeneratorItemHelper(spec, 0);
+  auto item1 = GeneratorItemHelper(spec, 1);
+  auto id0 = ObjectID::FromBinary(item0.returned_object().object_id());
+  auto id1 = ObjectID::FromBinary(item1.returned_object().object_id());
+  ASSERT_TRUE(manager_.HandleReportGeneratorItemReturns(item0));
+  ASSERT_FALSE(manager_.HandleReportGeneratorItemReturns(item0));
+  ASSERT_TRUE(reference_counter_->OwnedByUs(id0));
+  ASSERT_TRUE(store_->Contains(id0, &in_plasma));
+  ASSERT_TRUE(manager_.WaitForObjectRefStream(generator_id, 0));
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_EQ(object_id, id0);
+  ASSERT_FALSE(end_of_stream);
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_TRUE(object_id.IsNil());
+  ASSERT_FALSE(end_of_stream);
+
+  // The stream ends once the task finishes and all of its values were read.
+  ASSERT_TRUE(manager_.HandleReportGeneratorItemReturns(item1));
+  rpc::PushTaskReply reply;
+  auto return_object = reply.add_return_objects();
+  return_object->set_object_id(generator_id.Binary());
+  auto data = GenerateRandomBuffer();
+  return_object->set_data(data->Data(), data->Size());
+  manager_.CompletePendingTask(spec.TaskId(), reply, rpc::Address());
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_EQ(object_id, id1);
+  ASSERT_TRUE(end_of_stream);
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_TRUE(object_id.IsNil());
+  ASSERT_TRUE(end_of_stream);
+
+  // The reader took over the references to the values.
+  std::vector<ObjectID> removed;
+  reference_counter_->RemoveLocalReference(id0, &removed);
+  reference_counter_->RemoveLocalReference(id1, &removed);
+  ASSERT_EQ(removed.size(), 2);
+  manager_.DelObjectRefStream(generator_id);
+  ASSERT_TRUE(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream)
+                  .IsNotFound());
+}
+
+TEST_F(TaskManagerTest, TestStreamingGeneratorTaskFailure) {
+  rpc::Address caller_address;
+  auto spec = CreateTaskHelper(1, {});
+  spec.GetMutableMessage().set_streaming_generator(true);
+  manager_.AddPendingTask(caller_address, spec, "");
+  auto generator_id = spec.ReturnId(0);
+  ASSERT_TRUE(manager_.HandleReportGeneratorItemReturns(GeneratorItemHelper(spec, 0)));
+
+  // A failed task ends the stream after the values that were reported.
+  manager_.PendingTaskFailed(spec.TaskId(), rpc::ErrorType::WORKER_DIED);
+  ASSERT_FALSE(manager_.HandleReportGeneratorItemReturns(GeneratorItemHelper(spec, 1)));
+  ObjectID object_id;
+  bool end_of_stream;
+  RAY_CHECK_OK(manager_.TryReadObjectRefStream(generator_id, &object_id, &end_of_stream));
+  ASSERT_FALSE(object_id.IsNil());
+  ASSERT_TRUE(end_of_stream);
+  std::vector<ObjectID> removed;
+  reference_counter_->RemoveLocalReference(object_id, &removed);
+  ASSERT_EQ(removed.size(), 1);
+
+  std::vector<std::shared_ptr<RayObject>> results;
+  WorkerContext ctx(WorkerType::WORKER, WorkerID::FromRandom(), JobID::FromInt(0));
+  RAY_CHECK_OK(store_->Get({generator_id}, 1, -1, ctx, false, &results));
+  ASSERT_TRUE(results[0]->IsException());
+}
+
+TEST_F(TaskManagerTest, TestStreamingGeneratorTaskDeleted) {
+  rpc::Address caller_address;
+  auto spec = CreateTaskHelper(1, {});
+  spec.GetMutableMessage().set_streaming_generator(true);
+  manager_.AddPendingTask(caller_address, spec, "");
+  auto generator_id = spec.ReturnId(0);
+  auto item = GeneratorItemHelper(spec, 0);
+  auto id = ObjectID::FromBinary(item.returned_object().object_id());
+  bool in_plasma = false;
+  ASSERT_TRUE(manager_.HandleReportGeneratorItemReturns(item));
+
+  // Deleting the stream releases the values that weren't read, and values that are
+  // reported later are dropped.
+  manager_.DelObjectRefStream(generator_id);
+  ASSERT_FALSE(reference_counter_->HasReference(id));
+  ASSERT_FALSE(store_->Contains(id, &in_plasma));
+  ASSERT_TRUE(manager_.WaitForObjectRefStream(generator_id, 0));
+  item = GeneratorItemHelper(spec, 1);
+  id = ObjectID::FromBinary(item.returned_object().object_id());
+  ASSERT_FALSE(manager_.HandleReportGeneratorItemReturns(item));
+  ASSERT_FALSE(reference_counter_->HasReference(id));
+  ASSERT_FALSE(store_->Contains(id, &in_plasma));
+}
+
 }  // namespace core
 }  // namespace ray
 
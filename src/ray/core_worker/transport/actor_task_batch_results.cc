@@ -0,0 +1,107 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/transport/actor_task_batch_results.h"
+
+#include "ray/util/logging.h"
+
+namespace ray {
+namespace core {
+
+std::vector<rpc::PushTaskReply *> ActorTaskBatchResults::AddBatch(
+    const std::string &batch_id, int num_tasks) {
+  absl::MutexLock lock(&mu_);
+  auto inserted = batches_.emplace(batch_id, Batch(num_tasks));
+  RAY_CHECK(inserted.second) << "Received a batch of tasks twice";
+  std::vector<rpc::PushTaskReply *> replies;
+  for (auto &result : inserted.first->second.results) {
+    replies.push_back(result.mutable_reply());
+  }
+  return replies;
+}
+
+void ActorTaskBatchResults::SetResult(const std::string &batch_id, int index,
+                                      const Status &status) {
+  rpc::SendReplyCallback send_reply_callback;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = batches_.find(batch_id);
+    RAY_CHECK(it != batches_.end());
+    auto &result = it->second.results[index];
+    result.set_status_code(static_cast<int32_t>(status.code()));
+    result.set_status_message(status.message());
+    it->second.finished[index] = true;
+    send_reply_callback = TakeReadyResults(it);
+  }
+  if (send_reply_callback) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+}
+
+void ActorTaskBatchResults::Poll(const std::string &batch_id, int num_results_received,
+                                 rpc::PushTasksReply *reply,
+                                 rpc::SendReplyCallback send_reply_callback) {
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = batches_.find(batch_id);
+    if (it != batches_.end() && it->second.reply == nullptr &&
+        it->second.num_sent == num_results_received) {
+      it->second.reply = reply;
+      it->second.send_reply_callback = std::move(send_reply_callback);
+      send_reply_callback = TakeReadyResults(it);
+    }
+  }
+  if (send_reply_callback) {
+    // Either the results are ready, or the poll doesn't match the batch, e.g.,
+    // because the batch finished already.
+    send_reply_callback(
+        reply->results_size() > 0 ? Status::OK()
+                                  : Status::Invalid("Unknown batch of actor tasks"),
+        nullptr, nullptr);
+  }
+}
+
+size_t ActorTaskBatchResults::NumBatches() const {
+  absl::MutexLock lock(&mu_);
+  return batches_.size();
+}
+
+rpc::SendReplyCallback ActorTaskBatchResults::TakeReadyResults(
+    absl::flat_hash_map<std::string, Batch>::iterator it) {
+  auto &batch = it->second;
+  if (batch.reply == nullptr) {
+    return nullptr;
+  }
+  const int num_tasks = batch.results.size();
+  int num_ready = batch.num_sent;
+  while (num_ready < num_tasks && batch.finished[num_ready]) {
+    num_ready++;
+  }
+  if (num_ready == batch.num_sent) {
+    return nullptr;
+  }
+  for (int i = batch.num_sent; i < num_ready; i++) {
+    batch.reply->add_results()->Swap(&batch.results[i]);
+  }
+  batch.num_sent = num_ready;
+  batch.reply = nullptr;
+  auto send_reply_callback = std::move(batch.send_reply_callback);
+  if (num_ready == num_tasks) {
+    batches_.erase(it);
+  }
+  return send_reply_callback;
+}
+
+}  // namespace core
+}  // namespace ray
@@ -0,0 +1,98 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/status.h"
+#include "ray/rpc/server_call.h"
+#include "src/ray/protobuf/core_worker.pb.h"
+
+namespace ray {
+namespace core {
+
+/// The results of the batches of actor tasks that a worker received in PushTasks
+/// RPCs. The result of a task is sent as soon as the task finished, in the reply of
+/// the RPC that pushed the batch or of a later one that polls for the remaining
+/// results. So a task never holds back the results of the earlier tasks of its batch,
+/// which it may depend on.
+///
+/// This class is thread-safe.
+class ActorTaskBatchResults {
+ public:
+  /// Add a batch of tasks.
+  ///
+  /// \param[in] batch_id The ID of the batch.
+  /// \param[in] num_tasks The number of tasks of the batch.
+  /// \return The replies to fill in for the tasks. They stay valid until the results
+  /// of all tasks of the batch have been sent.
+  std::vector<rpc::PushTaskReply *> AddBatch(const std::string &batch_id,
+                                             int num_tasks);
+
+  /// Record that a task of a batch finished, and send its result if the client is
+  /// waiting for it.
+  ///
+  /// \param[in] batch_id The ID of the batch.
+  /// \param[in] index The index of the task in the batch.
+  /// \param[in] status The status of the task.
+  void SetResult(const std::string &batch_id, int index, const Status &status);
+
+  /// Reply with the results of a batch after the ones that the client already
+  /// received, as soon as the next task of the batch has finished.
+  ///
+  /// \param[in] batch_id The ID of the batch.
+  /// \param[in] num_results_received The number of results the client received.
+  /// \param[out] reply The reply to fill in.
+  /// \param[in] send_reply_callback The callback to send the reply.
+  void Poll(const std::string &batch_id, int num_results_received,
+            rpc::PushTasksReply *reply, rpc::SendReplyCallback send_reply_callback);
+
+  /// \return The number of batches whose results haven't all been sent yet.
+  size_t NumBatches() const;
+
+ private:
+  struct Batch {
+    explicit Batch(int num_tasks) : results(num_tasks), finished(num_tasks, false) {}
+    /// The results of the tasks, in the order of the batch.
+    std::vector<rpc::PushTaskResult> results;
+    /// Whether each task finished.
+    std::vector<bool> finished;
+    /// The number of results that were sent.
+    int num_sent = 0;
+    /// The reply of the pending poll, or nullptr if the client isn't polling.
+    rpc::PushTasksReply *reply = nullptr;
+    rpc::SendReplyCallback send_reply_callback;
+  };
+
+  /// Move the results of the tasks that finished in order after the sent ones into
+  /// the pending reply of the batch. The batch is erased if all results were sent.
+  ///
+  /// \return The callback to send the reply, or nullptr if there is nothing to send
+  /// yet. It must be called without holding the lock.
+  rpc::SendReplyCallback TakeReadyResults(
+      absl::flat_hash_map<std::string, Batch>::iterator it)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  mutable absl::Mutex mu_;
+
+  absl::flat_hash_map<std::string, Batch> batches_ GUARDED_BY(mu_);
+};
+
+}  // namespace core
+}  // namespace ray
@@ -0,0 +1,145 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/transport/bounded_executor.h"
+
+#include "ray/util/logging.h"
+
+namespace ray {
+namespace core {
+
+BoundedExecutor::BoundedExecutor(int max_concurrency)
+    : max_concurrency_(max_concurrency),
+      num_running_(0),
+      num_queued_(0),
+      next_queue_(0),
+      stopped_(false),
+      num_idle_(0),
+      num_blocked_(0) {
+  RAY_CHECK(max_concurrency_ > 0);
+  for (int i = 0; i < max_concurrency_; i++) {
+    queues_.emplace_back(new WorkerQueue());
+  }
+  for (int i = 0; i < max_concurrency_; i++) {
+    threads_.emplace_back([this, i]() { RunWorker(i); });
+  }
+}
+
+BoundedExecutor::~BoundedExecutor() {
+  Stop();
+  Join();
+}
+
+bool BoundedExecutor::TryAdmit() {
+  int num_running = num_running_.load();
+  while (num_running < max_concurrency_) {
+    if (num_running_.compare_exchange_weak(num_running, num_running + 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void BoundedExecutor::PostBlocking(std::function<void()> fn) {
+  if (!TryAdmit()) {
+    absl::MutexLock lock(&full_mutex_);
+    num_blocked_++;
+    // A finishing task signals under the lock after releasing its slot, so the slot
+    // can't be released between this check and the wait.
+    while (!stopped_ && !TryAdmit()) {
+      full_cv_.Wait(&full_mutex_);
+    }
+    num_blocked_--;
+  }
+  if (stopped_) {
+    return;
+  }
+
+  num_queued_++;
+  auto &queue = *queues_[next_queue_++ % queues_.size()];
+  {
+    absl::MutexLock lock(&queue.mutex);
+    queue.tasks.push_back(std::move(fn));
+  }
+  // An idle thread checks `num_queued_` under the lock after announcing itself, so
+  // either it sees this task or it's waiting and gets signaled.
+  if (num_idle_ > 0) {
+    absl::MutexLock lock(&idle_mutex_);
+    idle_cv_.Signal();
+  }
+}
+
+bool BoundedExecutor::PopTask(size_t index, std::function<void()> *task) {
+  for (size_t i = 0; i < queues_.size(); i++) {
+    auto &queue = *queues_[(index + i) % queues_.size()];
+    absl::MutexLock lock(&queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      *task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    } else {
+      // Steal from the back, away from where the owner takes tasks.
+      *task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    num_queued_--;
+    return true;
+  }
+  return false;
+}
+
+void BoundedExecutor::RunWorker(size_t index) {
+  while (!stopped_) {
+    std::function<void()> task;
+    if (PopTask(index, &task)) {
+      task();
+      num_running_--;
+      if (num_blocked_ > 0) {
+        absl::MutexLock lock(&full_mutex_);
+        full_cv_.Signal();
+      }
+      continue;
+    }
+
+    absl::MutexLock lock(&idle_mutex_);
+    num_idle_++;
+    while (!stopped_ && num_queued_ == 0) {
+      idle_cv_.Wait(&idle_mutex_);
+    }
+    num_idle_--;
+  }
+}
+
+void BoundedExecutor::Stop() {
+  stopped_ = true;
+  {
+    absl::MutexLock lock(&idle_mutex_);
+    idle_cv_.SignalAll();
+  }
+  absl::MutexLock lock(&full_mutex_);
+  full_cv_.SignalAll();
+}
+
+void BoundedExecutor::Join() {
+  for (auto &thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+}  // namespace core
+}  // namespace ray
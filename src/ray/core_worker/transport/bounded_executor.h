@@ -0,0 +1,99 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+
+namespace ray {
+namespace core {
+
+/// A thread pool that runs at most `max_concurrency` tasks at a time, e.g., the tasks of
+/// one concurrency group of a threaded actor. Posts block until the pool has a free
+/// slot, which the SchedulingQueue uses to provide backpressure to clients.
+///
+/// Admission is lock free: a task takes a slot with a compare-and-swap on the number of
+/// running tasks, and only the caller of a full executor waits on a lock. Each thread
+/// has its own queue that tasks are posted to round robin, and idle threads steal
+/// tasks from the other queues, so short tasks don't contend on one shared queue.
+class BoundedExecutor {
+ public:
+  explicit BoundedExecutor(int max_concurrency);
+
+  ~BoundedExecutor();
+
+  /// Posts work to the pool, blocking if no free threads are available. Work that is
+  /// posted after `Stop` is dropped.
+  void PostBlocking(std::function<void()> fn);
+
+  /// Stop the thread pool. Tasks that are running finish, and the queued ones are
+  /// dropped.
+  void Stop();
+
+  /// Join the thread pool. This must be called after `Stop`.
+  void Join();
+
+ private:
+  /// The tasks that were posted to a thread.
+  struct WorkerQueue {
+    absl::Mutex mutex;
+    std::deque<std::function<void()>> tasks GUARDED_BY(mutex);
+  };
+
+  /// Take a slot for a task if fewer than `max_concurrency_` tasks are running.
+  bool TryAdmit();
+
+  /// Take a task from the queue of the given thread, or steal one from another thread.
+  bool PopTask(size_t index, std::function<void()> *task);
+
+  /// The loop of the thread with the given index.
+  void RunWorker(size_t index);
+
+  /// The max number of concurrently running tasks allowed.
+  const int max_concurrency_;
+  /// The number of tasks that were admitted and haven't finished yet.
+  std::atomic<int> num_running_;
+  /// The number of tasks that are being posted to a queue or were posted to one and
+  /// aren't taken yet.
+  std::atomic<int64_t> num_queued_;
+  /// The index of the queue to post the next task to.
+  std::atomic<size_t> next_queue_;
+  /// Whether the executor is stopped.
+  std::atomic<bool> stopped_;
+
+  /// The queue of each thread.
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  /// The threads of the pool.
+  std::vector<std::thread> threads_;
+
+  /// Threads that have no task to run wait here for `num_queued_` to become positive.
+  absl::Mutex idle_mutex_;
+  absl::CondVar idle_cv_;
+  std::atomic<int> num_idle_;
+
+  /// Callers of `PostBlocking` wait here for a slot when the executor is full.
+  absl::Mutex full_mutex_;
+  absl::CondVar full_cv_;
+  std::atomic<int> num_blocked_;
+};
+
+}  // namespace core
+}  // namespace ray
@@ -441,11 +441,19 @@ void CoreWorkerDirectTaskReceiver::Init(
 void CoreWorkerDirectTaskReceiver::HandleTask(
     const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
+  HandleTask(rpc::TakeRequestMessage(request), reply, std::move(send_reply_callback));
+}
+
+void CoreWorkerDirectTaskReceiver::HandleTask(
+    std::shared_ptr<rpc::PushTaskRequest> shared_request, rpc::PushTaskReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
   RAY_CHECK(waiter_ != nullptr) << "Must call init() prior to use";
-  // Use `mutable_task_spec()` here as `task_spec()` returns a const reference
-  // which doesn't work with std::move.
+  const auto &request = *shared_request;
+  // The task spec shares ownership of the request, so that it doesn't need to be copied
+  // out of the arena that the request was parsed into.
+  auto *task_spec_message = shared_request->mutable_task_spec();
   TaskSpecification task_spec(
-      std::move(*(const_cast<rpc::PushTaskRequest &>(request).mutable_task_spec())));
+      std::shared_ptr<rpc::TaskSpec>(std::move(shared_request), task_spec_message));
 
   // If GCS server is restarted after sending an actor creation task to this core worker,
   // the restarted GCS server will send the same actor creation task to the core worker
@@ -462,6 +470,9 @@ void CoreWorkerDirectTaskReceiver::HandleTask(
   if (task_spec.IsActorCreationTask()) {
     worker_context_.SetCurrentActorId(task_spec.ActorCreationId());
     SetMaxActorConcurrency(task_spec.IsAsyncioActor(), task_spec.MaxActorConcurrency());
+    executes_actor_tasks_in_order_ = !task_spec.IsAsyncioActor() &&
+                                     task_spec.MaxActorConcurrency() <= 1 &&
+                                     task_spec.ConcurrencyGroups().empty();
   }
 
   // Only assign resources for non-actor tasks. Actor tasks inherit the resources
@@ -33,6 +33,7 @@
 #include "ray/core_worker/fiber.h"
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
 #include "ray/core_worker/task_manager.h"
+#include "ray/core_worker/transport/bounded_executor.h"
 #include "ray/core_worker/transport/dependency_resolver.h"
 #include "ray/rpc/grpc_server.h"
 #include "ray/rpc/worker/core_worker_client.h"
@@ -346,46 +347,6 @@ class FiberStateManager final {
   std::shared_ptr<FiberState> default_fiber_ = nullptr;
 };
 
-/// Wraps a thread-pool to block posts until the pool has free slots. This is used
-/// by the SchedulingQueue to provide backpressure to clients.
-class BoundedExecutor {
- public:
-  BoundedExecutor(int max_concurrency)
-      : num_running_(0), max_concurrency_(max_concurrency), pool_(max_concurrency){};
-
-  /// Posts work to the pool, blocking if no free threads are available.
-  void PostBlocking(std::function<void()> fn) {
-    mu_.LockWhen(absl::Condition(this, &BoundedExecutor::ThreadsAvailable));
-    num_running_ += 1;
-    mu_.Unlock();
-    boost::asio::post(pool_, [this, fn]() {
-      fn();
-      absl::MutexLock lock(&mu_);
-      num_running_ -= 1;
-    });
-  }
-
-  /// Stop the thread pool.
-  void Stop() { pool_.stop(); }
-
-  /// Join the thread pool.
-  void Join() { pool_.join(); }
-
- private:
-  bool ThreadsAvailable() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    return num_running_ < max_concurrency_;
-  }
-
-  /// Protects access to the counters below.
-  absl::Mutex mu_;
-  /// The number of currently running tasks.
-  int num_running_ GUARDED_BY(mu_);
-  /// The max number of concurrently running tasks allowed.
-  const int max_concurrency_;
-  /// The underlying thread pool for running tasks.
-  boost::asio::thread_pool pool_;
-};
-
 /// A manager that manages a set of thread pool. which will perform
 /// the methods defined in one concurrency group.
 class PoolManager final {
@@ -917,6 +878,16 @@ class CoreWorkerDirectTaskReceiver {
   void HandleTask(const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
                   rpc::SendReplyCallback send_reply_callback);
 
+  /// Handle a `PushTask` request that the caller shares ownership of, e.g., one that is
+  /// kept in the arena of the RPC, see `rpc::TakeRequestMessage`. The task spec is
+  /// used in place instead of being copied out of the request.
+  ///
+  /// \param[in] request The request message.
+  /// \param[out] reply The reply message.
+  /// \param[in] send_reply_callback The callback to be called when the request is done.
+  void HandleTask(std::shared_ptr<rpc::PushTaskRequest> request,
+                  rpc::PushTaskReply *reply, rpc::SendReplyCallback send_reply_callback);
+
   /// Pop tasks from the queue and execute them sequentially
   void RunNormalTasksFromQueue();
 
@@ -931,6 +902,12 @@ class CoreWorkerDirectTaskReceiver {
 
   bool CancelQueuedNormalTask(TaskID task_id);
 
+  /// Whether this worker is an actor that executes its tasks one at a time, in the
+  /// order of their sequence numbers. Only such actors can handle batches of tasks,
+  /// whose results are sent in order, because a task can't wait for a later task of
+  /// the same batch to finish.
+  bool ExecutesActorTasksInOrder() const { return executes_actor_tasks_in_order_; }
+
   void Stop();
 
  protected:
@@ -966,6 +943,9 @@ class CoreWorkerDirectTaskReceiver {
   std::shared_ptr<PoolManager> pool_manager_;
   /// Whether this actor use asyncio for concurrency.
   bool is_asyncio_ = false;
+  /// Whether this actor executes its tasks one at a time and in order, see
+  /// `ExecutesActorTasksInOrder`.
+  bool executes_actor_tasks_in_order_ = false;
 
   /// Set the max concurrency for fiber actor.
   /// This should be called once for the actor creation task.
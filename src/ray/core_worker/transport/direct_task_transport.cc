@@ -19,11 +19,50 @@
 namespace ray {
 namespace core {
 
+namespace {
+
+/// Whether a worker was requested for a task before its arguments were resolved.
+/// Guarded by the submitter's mutex.
+struct PipelinedResolution {
+  bool resolved = false;
+  bool requested_worker = false;
+};
+
+}  // namespace
+
 Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
   RAY_LOG(DEBUG) << "Submit task " << task_spec.TaskId();
   num_tasks_submitted_++;
 
-  resolver_.ResolveDependencies(task_spec, [this, task_spec](Status status) {
+  // The key of the task if all of its arguments are inlined, and the spec to request a
+  // worker for it with while the arguments are resolved. The spec is built before
+  // resolution starts, since the resolver inlines the arguments into the shared
+  // message.
+  std::shared_ptr<PipelinedResolution> pipelined;
+  absl::optional<SchedulingKey> pipelined_key;
+  absl::optional<TaskSpecification> pipelined_resource_spec;
+  if (RayConfig::instance().pipeline_task_dependency_resolution() &&
+      task_spec.IsNormalTask() && !task_spec.GetDependencyIds().empty()) {
+    pipelined = std::make_shared<PipelinedResolution>();
+    pipelined_key.emplace(task_spec.GetSchedulingClass(), std::vector<ObjectID>(),
+                          ActorID::Nil(), task_spec.GetRuntimeEnvHash());
+    auto resource_spec_msg = task_spec.GetMessage();
+    resource_spec_msg.clear_args();
+    pipelined_resource_spec.emplace(std::move(resource_spec_msg));
+  }
+
+  resolver_.ResolveDependencies(task_spec, [this, task_spec, pipelined,
+                                            pipelined_key](Status status) {
+    bool requested_worker = false;
+    if (pipelined) {
+      absl::MutexLock lock(&mu_);
+      pipelined->resolved = true;
+      requested_worker = pipelined->requested_worker;
+      if (requested_worker && !status.ok()) {
+        OnTaskResolved(*pipelined_key);
+        ReleaseWorkersIfNotNeeded(*pipelined_key);
+      }
+    }
     if (!status.ok()) {
       RAY_LOG(ERROR) << "Resolving task dependencies failed " << status.ToString();
       RAY_UNUSED(task_finisher_->PendingTaskFailed(
@@ -66,6 +105,11 @@ Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
         cancelled_tasks_.erase(task_spec.TaskId());
         keep_executing = false;
       }
+      if (requested_worker) {
+        // The task no longer needs the worker requested for it if it's queued under a
+        // different key below.
+        OnTaskResolved(*pipelined_key);
+      }
       if (keep_executing) {
         // Note that the dependencies in the task spec are mutated to only contain
         // plasma dependencies after ResolveDependencies finishes.
@@ -104,15 +148,70 @@ Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
         }
         RequestNewWorkerIfNeeded(scheduling_key);
       }
+      if (requested_worker) {
+        ReleaseWorkersIfNotNeeded(*pipelined_key);
+      }
     }
     if (!keep_executing) {
       RAY_UNUSED(task_finisher_->PendingTaskFailed(
           task_spec.TaskId(), rpc::ErrorType::TASK_CANCELLED, nullptr));
     }
   });
+
+  if (pipelined) {
+    absl::MutexLock lock(&mu_);
+    // Arguments that are already available are resolved inline, so only request a
+    // worker ahead of time if the task is still waiting for some of them.
+    if (!pipelined->resolved) {
+      pipelined->requested_worker = true;
+      RequestWorkerWhileResolving(*pipelined_key, *pipelined_resource_spec);
+    }
+  }
   return Status::OK();
 }
 
+void CoreWorkerDirectTaskSubmitter::RequestWorkerWhileResolving(
+    const SchedulingKey &scheduling_key, const TaskSpecification &task_spec) {
+  auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+  scheduling_key_entry.num_resolving_tasks++;
+  if (scheduling_key_entry.task_queue.empty()) {
+    scheduling_key_entry.resource_spec = task_spec;
+  }
+  RequestNewWorkerIfNeeded(scheduling_key);
+}
+
+void CoreWorkerDirectTaskSubmitter::OnTaskResolved(const SchedulingKey &scheduling_key) {
+  auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+  RAY_CHECK(scheduling_key_entry.num_resolving_tasks > 0);
+  scheduling_key_entry.num_resolving_tasks--;
+}
+
+void CoreWorkerDirectTaskSubmitter::ReleaseWorkersIfNotNeeded(
+    const SchedulingKey &scheduling_key) {
+  auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+  if (scheduling_key_entry.num_resolving_tasks > 0 ||
+      !scheduling_key_entry.task_queue.empty()) {
+    return;
+  }
+
+  // Idle workers were kept for the tasks being resolved, see OnWorkerIdle.
+  std::vector<rpc::WorkerAddress> idle_workers;
+  for (const auto &addr : scheduling_key_entry.active_workers) {
+    const auto &lease_entry = worker_to_lease_entry_[addr];
+    if (lease_entry.tasks_in_flight == 0 && !lease_entry.WorkerIsStealing()) {
+      idle_workers.push_back(addr);
+    }
+  }
+  for (const auto &addr : idle_workers) {
+    const auto assigned_resources = worker_to_lease_entry_[addr].assigned_resources;
+    OnWorkerIdle(addr, scheduling_key, /*was_error=*/false, assigned_resources);
+  }
+  CancelWorkerLeaseIfNeeded(scheduling_key);
+  if (scheduling_key_entries_[scheduling_key].CanDelete()) {
+    scheduling_key_entries_.erase(scheduling_key);
+  }
+}
+
 void CoreWorkerDirectTaskSubmitter::AddWorkerLeaseClient(
     const rpc::WorkerAddress &addr, std::shared_ptr<WorkerLeaseInterface> lease_client,
     const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources,
@@ -332,6 +431,21 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
 
     // Return the worker only if there are no tasks in flight
     if (lease_entry.tasks_in_flight == 0) {
+      SchedulingKey compatible_key;
+      if (!was_error && current_time_ms() <= lease_entry.lease_expiration_time &&
+          current_queue.empty() &&
+          FindCompatibleSchedulingKey(scheduling_key, assigned_resources,
+                                      &compatible_key)) {
+        // Tasks queued with other resource shapes have no worker yet, so run them
+        // before stealing tasks that are already assigned to a worker.
+        ReassignIdleWorker(addr, scheduling_key, compatible_key);
+        return;
+      }
+      if (!was_error && current_time_ms() <= lease_entry.lease_expiration_time &&
+          current_queue.empty() && scheduling_key_entry.num_resolving_tasks > 0) {
+        // Keep the worker for the tasks whose arguments are still being resolved.
+        return;
+      }
       StealTasksOrReturnWorker(addr, was_error, scheduling_key, assigned_resources);
     }
   } else {
@@ -361,11 +475,75 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
   RequestNewWorkerIfNeeded(scheduling_key);
 }
 
+bool CoreWorkerDirectTaskSubmitter::FindCompatibleSchedulingKey(
+    const SchedulingKey &scheduling_key,
+    const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources,
+    SchedulingKey *compatible_key) {
+  if (!RayConfig::instance().reuse_worker_leases_across_scheduling_classes()) {
+    return false;
+  }
+  absl::flat_hash_map<std::string, double> granted_resource_map;
+  for (const auto &resource : assigned_resources) {
+    for (const auto &resource_id : resource.resource_ids()) {
+      granted_resource_map[resource.name()] += resource_id.quantity();
+    }
+  }
+  const ResourceSet granted_resources(granted_resource_map);
+  const bool has_gpus = granted_resources.GetResource(kGPU_ResourceLabel) > 0;
+
+  size_t max_queue_size = 0;
+  for (const auto &scheduling_key_and_entry : scheduling_key_entries_) {
+    const auto &candidate_key = scheduling_key_and_entry.first;
+    const auto &candidate_entry = scheduling_key_and_entry.second;
+    // Actor creation tasks always need a lease of their own, and a worker can only run
+    // tasks with its own runtime env. The lease was placed near its tasks' plasma
+    // arguments, so only reuse it for tasks with the same arguments.
+    if (candidate_key == scheduling_key || !std::get<2>(candidate_key).IsNil() ||
+        std::get<1>(candidate_key) != std::get<1>(scheduling_key) ||
+        std::get<3>(candidate_key) != std::get<3>(scheduling_key) ||
+        candidate_entry.task_queue.size() <= max_queue_size) {
+      continue;
+    }
+    const auto &required_resources =
+        candidate_entry.resource_spec.GetRequiredResources();
+    // The tasks see the resource ids assigned to the lease, so don't hand GPUs to tasks
+    // that didn't ask for any.
+    if (!required_resources.IsSubset(granted_resources) ||
+        (has_gpus && required_resources.GetResource(kGPU_ResourceLabel) == 0)) {
+      continue;
+    }
+    *compatible_key = candidate_key;
+    max_queue_size = candidate_entry.task_queue.size();
+  }
+  return max_queue_size > 0;
+}
+
+void CoreWorkerDirectTaskSubmitter::ReassignIdleWorker(const rpc::WorkerAddress &addr,
+                                                       const SchedulingKey &from_key,
+                                                       const SchedulingKey &to_key) {
+  auto &lease_entry = worker_to_lease_entry_[addr];
+  RAY_CHECK(lease_entry.tasks_in_flight == 0);
+  RAY_CHECK(!lease_entry.WorkerIsStealing());
+  RAY_LOG(DEBUG) << "Reusing the lease of worker " << addr.worker_id
+                 << " for tasks of scheduling class " << std::get<0>(to_key);
+
+  auto &from_entry = scheduling_key_entries_[from_key];
+  from_entry.active_workers.erase(addr);
+  if (from_entry.CanDelete()) {
+    scheduling_key_entries_.erase(from_key);
+  }
+  lease_entry.scheduling_key = to_key;
+  RAY_CHECK(scheduling_key_entries_[to_key].active_workers.emplace(addr).second);
+  num_leases_reused_++;
+  OnWorkerIdle(addr, to_key, /*was_error=*/false, lease_entry.assigned_resources);
+}
+
 void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
     const SchedulingKey &scheduling_key) {
   auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
   auto &task_queue = scheduling_key_entry.task_queue;
-  if (!task_queue.empty() || scheduling_key_entry.StealableTasks()) {
+  if (!task_queue.empty() || scheduling_key_entry.num_resolving_tasks > 0 ||
+      scheduling_key_entry.StealableTasks()) {
     // There are still pending tasks, or there are tasks that can be stolen by a new
     // worker, so let the worker lease request succeed.
     return;
@@ -486,13 +664,15 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
     return;
   }
 
-  const auto &task_queue = scheduling_key_entry.task_queue;
+  // Tasks whose arguments are still being resolved need a worker as well.
+  const size_t num_tasks = scheduling_key_entry.task_queue.size() +
+                           scheduling_key_entry.num_resolving_tasks;
   // Check if the task queue is empty. If that is the case, it only makes sense to
   // consider requesting a new worker if work stealing is enabled, and there is at least a
   // worker with stealable tasks. If work stealing is not enabled, or there is no tasks
   // that we can steal from existing workers, we don't need a new worker because we don't
   // have any tasks to execute on that worker.
-  if (task_queue.empty()) {
+  if (num_tasks == 0) {
     // If any worker has more than one task in flight, then that task can be stolen.
     bool stealable_tasks = scheduling_key_entry.StealableTasks();
     if (!stealable_tasks) {
@@ -503,8 +683,7 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
       }
       return;
     }
-  } else if (scheduling_key_entry.task_queue.size() <=
-             scheduling_key_entry.pending_lease_requests.size()) {
+  } else if (num_tasks <= scheduling_key_entry.pending_lease_requests.size()) {
     // All tasks have corresponding pending leases, no need to request more
     return;
   }
@@ -598,7 +777,7 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
           }
         }
       },
-      task_queue.size());
+      scheduling_key_entry.task_queue.size());
   scheduling_key_entry.pending_lease_requests.emplace(task_id, *raylet_address);
   ReportWorkerBacklogIfNeeded(scheduling_key);
 }
@@ -772,6 +951,24 @@ Status CoreWorkerDirectTaskSubmitter::CancelTask(TaskSpecification task_spec,
   return Status::OK();
 }
 
+void CoreWorkerDirectTaskSubmitter::AddReturnObjectBorrower(
+    const TaskID &task_id, const rpc::Address &borrower_address) {
+  rpc::AddReturnObjectBorrowerRequest request;
+  std::shared_ptr<rpc::CoreWorkerClientInterface> client;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = executing_tasks_.find(task_id);
+    if (it == executing_tasks_.end()) {
+      return;
+    }
+    request.set_intended_worker_id(it->second.worker_id.Binary());
+    client = client_cache_->GetOrConnect(it->second.ToProto());
+  }
+  request.set_task_id(task_id.Binary());
+  request.mutable_borrower_address()->CopyFrom(borrower_address);
+  client->AddReturnObjectBorrower(request, nullptr);
+}
+
 Status CoreWorkerDirectTaskSubmitter::CancelRemoteTask(const ObjectID &object_id,
                                                        const rpc::Address &worker_addr,
                                                        bool force_kill, bool recursive) {
@@ -97,6 +97,16 @@ class CoreWorkerDirectTaskSubmitter {
 
   Status CancelRemoteTask(const ObjectID &object_id, const rpc::Address &worker_addr,
                           bool force_kill, bool recursive);
+
+  /// Ask the worker executing a task to push the task's return values that are small
+  /// enough to be inlined to a borrower once the task finishes. This is a no-op if the
+  /// task isn't executing, in which case the borrower gets the values from us.
+  ///
+  /// \param[in] task_id The ID of the task.
+  /// \param[in] borrower_address The address of the borrower.
+  void AddReturnObjectBorrower(const TaskID &task_id,
+                               const rpc::Address &borrower_address);
+
   /// Check that the scheduling_key_entries_ hashmap is empty by calling the private
   /// CheckNoSchedulingKeyEntries function after acquiring the lock.
   bool CheckNoSchedulingKeyEntriesPublic() {
@@ -111,6 +121,11 @@ class CoreWorkerDirectTaskSubmitter {
     return num_leases_requested_;
   }
 
+  int64_t GetNumLeasesReused() {
+    absl::MutexLock lock(&mu_);
+    return num_leases_reused_;
+  }
+
   /// Report worker backlog information to the local raylet.
   /// Since each worker only reports to its local rayet
   /// we avoid double counting backlogs in autoscaler.
@@ -159,6 +174,25 @@ class CoreWorkerDirectTaskSubmitter {
   void CancelWorkerLeaseIfNeeded(const SchedulingKey &scheduling_key)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Request a worker for a task whose arguments are being resolved, under the
+  /// SchedulingKey that the task has if all of its arguments are inlined.
+  ///
+  /// \param scheduling_key The SchedulingKey of the task without plasma dependencies.
+  /// \param task_spec The task, with its arguments removed.
+  void RequestWorkerWhileResolving(const SchedulingKey &scheduling_key,
+                                   const TaskSpecification &task_spec)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Called once the arguments of a task that a worker was requested for by
+  /// RequestWorkerWhileResolving are resolved, before the task is queued.
+  void OnTaskResolved(const SchedulingKey &scheduling_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Return the idle workers and cancel the lease requests of a SchedulingKey if no
+  /// task is queued or being resolved under it anymore, e.g., because the arguments of
+  /// its last task were stored in plasma.
+  void ReleaseWorkersIfNotNeeded(const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// Set up client state for newly granted worker lease.
   void AddWorkerLeaseClient(
       const rpc::WorkerAddress &addr, std::shared_ptr<WorkerLeaseInterface> lease_client,
@@ -171,6 +205,28 @@ class CoreWorkerDirectTaskSubmitter {
   void ReturnWorker(const rpc::WorkerAddress addr, bool was_error,
                     const SchedulingKey &scheduling_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Find the scheduling key with the most queued tasks that an idle worker leased for
+  /// another scheduling key can run, because the tasks' resources fit within the
+  /// resources granted to the lease.
+  ///
+  /// \param[in] scheduling_key The scheduling key the worker is currently assigned to.
+  /// \param[in] assigned_resources Resource ids assigned to the worker.
+  /// \param[out] compatible_key The scheduling key whose tasks the worker can run.
+  /// \return Whether a compatible scheduling key with queued tasks was found.
+  bool FindCompatibleSchedulingKey(
+      const SchedulingKey &scheduling_key,
+      const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources,
+      SchedulingKey *compatible_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Move an idle worker to another scheduling key and submit that key's queued tasks
+  /// to it, instead of returning the worker to the raylet.
+  ///
+  /// \param[in] addr The address of the worker.
+  /// \param[in] from_key The scheduling key the worker is currently assigned to.
+  /// \param[in] to_key The scheduling key to assign the worker to.
+  void ReassignIdleWorker(const rpc::WorkerAddress &addr, const SchedulingKey &from_key,
+                          const SchedulingKey &to_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// Check that the scheduling_key_entries_ hashmap is empty.
   inline bool CheckNoSchedulingKeyEntries() const EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     return scheduling_key_entries_.empty();
@@ -327,13 +383,17 @@ class CoreWorkerDirectTaskSubmitter {
         absl::flat_hash_set<rpc::WorkerAddress>();
     // Keep track of how many tasks with this SchedulingKey are in flight, in total
     uint32_t total_tasks_in_flight = 0;
+    // Tasks whose arguments are still being resolved, and that a worker was requested
+    // for under this SchedulingKey ahead of time.
+    uint32_t num_resolving_tasks = 0;
     int64_t last_reported_backlog_size = 0;
 
     // Check whether it's safe to delete this SchedulingKeyEntry from the
     // scheduling_key_entries_ hashmap.
     inline bool CanDelete() const {
       if (pending_lease_requests.empty() && task_queue.empty() &&
-          active_workers.size() == 0 && total_tasks_in_flight == 0) {
+          active_workers.size() == 0 && total_tasks_in_flight == 0 &&
+          num_resolving_tasks == 0) {
         return true;
       }
 
@@ -390,6 +450,7 @@ class CoreWorkerDirectTaskSubmitter {
 
   int64_t num_tasks_submitted_ = 0;
   int64_t num_leases_requested_ GUARDED_BY(mu_) = 0;
+  int64_t num_leases_reused_ GUARDED_BY(mu_) = 0;
 };
 
 }  // namespace core
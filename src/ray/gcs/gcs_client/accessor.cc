@@ -263,6 +263,27 @@ Status ActorInfoAccessor::AsyncCreateActor(
   return Status::OK();
 }
 
+Status ActorInfoAccessor::AsyncCreateActors(
+    const std::vector<TaskSpecification> &task_specs,
+    const rpc::ClientCallback<rpc::CreateActorsReply> &callback) {
+  RAY_CHECK(callback);
+  rpc::CreateActorsRequest request;
+  for (const auto &task_spec : task_specs) {
+    RAY_CHECK(task_spec.IsActorCreationTask());
+    request.add_task_specs()->CopyFrom(task_spec.GetMessage());
+  }
+  client_impl_->GetGcsRpcClient().CreateActors(
+      request,
+      [callback](const Status & /*unused*/, const rpc::CreateActorsReply &reply) {
+        auto status =
+            reply.status().code() == (int)StatusCode::OK
+                ? Status()
+                : Status(StatusCode(reply.status().code()), reply.status().message());
+        callback(status, reply);
+      });
+  return Status::OK();
+}
+
 Status ActorInfoAccessor::AsyncSubscribeAll(
     const SubscribeCallback<ActorID, rpc::ActorTableData> &subscribe,
     const StatusCallback &done) {
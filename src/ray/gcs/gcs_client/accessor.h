@@ -110,6 +110,20 @@ class ActorInfoAccessor {
       const TaskSpecification &task_spec,
       const rpc::ClientCallback<rpc::CreateActorReply> &callback);
 
+  /// Asynchronously request GCS to register and create a batch of actors, with one
+  /// request, one storage write and one scheduling pass for the whole batch.
+  ///
+  /// This should be called after the worker has resolved the actor dependencies. The
+  /// request will only reply after every actor is either created or failed.
+  ///
+  /// \param task_specs The specifications for the actor creation tasks.
+  /// \param callback Callback that will be called with the reply of each actor, in the
+  /// order of `task_specs`.
+  /// \return Status
+  virtual Status AsyncCreateActors(
+      const std::vector<TaskSpecification> &task_specs,
+      const rpc::ClientCallback<rpc::CreateActorsReply> &callback);
+
   /// Subscribe to any register or update operations of actors.
   ///
   /// \param subscribe Callback that will be called each time when an actor is registered
@@ -191,6 +191,122 @@ void GcsActorManager::HandleCreateActor(const rpc::CreateActorRequest &request,
   ++counts_[CountType::CREATE_ACTOR_REQUEST];
 }
 
+void GcsActorManager::HandleCreateActors(const rpc::CreateActorsRequest &request,
+                                         rpc::CreateActorsReply *reply,
+                                         rpc::SendReplyCallback send_reply_callback) {
+  const int num_actors = request.task_specs_size();
+  RAY_LOG(INFO) << "Creating a batch of " << num_actors << " actors";
+  ++counts_[CountType::CREATE_ACTORS_REQUEST];
+  if (num_actors == 0) {
+    GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+    return;
+  }
+  for (int i = 0; i < num_actors; i++) {
+    reply->add_replies();
+  }
+
+  // Reply once every actor of the batch is either created or failed. An actor is
+  // finished only once, even if it fails after it was created.
+  auto finished = std::make_shared<std::vector<bool>>(num_actors, false);
+  auto num_pending = std::make_shared<int>(num_actors);
+  auto on_actor_finished = [reply, send_reply_callback, finished, num_pending](
+                               int index, const Status &status,
+                               const std::shared_ptr<GcsActor> &actor,
+                               const rpc::PushTaskReply &task_reply) {
+    if ((*finished)[index]) {
+      return;
+    }
+    (*finished)[index] = true;
+    auto actor_reply = reply->mutable_replies(index);
+    if (actor) {
+      actor_reply->mutable_actor_address()->CopyFrom(actor->GetAddress());
+      actor_reply->mutable_borrowed_refs()->CopyFrom(task_reply.borrowed_refs());
+    }
+    actor_reply->mutable_status()->set_code((int)status.code());
+    actor_reply->mutable_status()->set_message(status.message());
+    if (--(*num_pending) == 0) {
+      RAY_LOG(INFO) << "Finished creating a batch of " << reply->replies_size()
+                    << " actors";
+      GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+    }
+  };
+
+  // Register all actors in memory, and persist the new ones with one storage write.
+  std::vector<std::shared_ptr<GcsActor>> new_actors;
+  std::vector<ActorID> actor_ids;
+  std::vector<rpc::ActorTableData> actor_table_data;
+  for (int i = 0; i < num_actors; i++) {
+    const auto &task_spec = request.task_specs(i);
+    RAY_CHECK(task_spec.type() == TaskType::ACTOR_CREATION_TASK);
+    std::shared_ptr<GcsActor> actor;
+    Status status = AddRegisteredActor(
+        task_spec, [](const std::shared_ptr<GcsActor> &) {}, &actor);
+    if (!status.ok()) {
+      RAY_LOG(ERROR) << "Failed to register actor: " << status.ToString()
+                     << ", actor id = "
+                     << ActorID::FromBinary(
+                            task_spec.actor_creation_task_spec().actor_id());
+      on_actor_finished(i, status, nullptr, rpc::PushTaskReply());
+    } else if (actor) {
+      actor_ids.emplace_back(actor->GetActorID());
+      actor_table_data.emplace_back(actor->GetActorTableData());
+      new_actors.emplace_back(std::move(actor));
+    }
+  }
+
+  if (*num_pending == 0) {
+    return;
+  }
+
+  // NOTE: The request is alive until the reply is sent, and the reply isn't sent before
+  // the last actor that isn't finished yet is visited below.
+  auto create_actors = [this, &request, num_actors, new_actors, finished,
+                        on_actor_finished]() {
+    for (const auto &actor : new_actors) {
+      OnActorRegistrationPersisted(actor);
+    }
+    std::vector<std::shared_ptr<GcsActor>> actors_to_schedule;
+    for (int i = 0; i < num_actors; i++) {
+      if ((*finished)[i]) {
+        continue;
+      }
+      const auto &task_spec = request.task_specs(i);
+      auto actor_id =
+          ActorID::FromBinary(task_spec.actor_creation_task_spec().actor_id());
+      Status status = DoCreateActor(
+          task_spec,
+          [on_actor_finished, i](const std::shared_ptr<GcsActor> &actor,
+                                 const rpc::PushTaskReply &task_reply) {
+            on_actor_finished(i, Status::OK(), actor, task_reply);
+          },
+          &actors_to_schedule);
+      if (!status.ok()) {
+        RAY_LOG(WARNING) << "Failed to create actor, job id = " << actor_id.JobId()
+                         << ", actor id = " << actor_id
+                         << ", status: " << status.ToString();
+        on_actor_finished(i, status, nullptr, rpc::PushTaskReply());
+      } else if (actor_to_create_callbacks_.contains(actor_id)) {
+        actor_to_create_failure_callbacks_[actor_id].emplace_back(
+            [on_actor_finished, i](const Status &status) {
+              on_actor_finished(i, status, nullptr, rpc::PushTaskReply());
+            });
+      }
+    }
+    gcs_actor_scheduler_->ScheduleBatch(std::move(actors_to_schedule));
+  };
+
+  if (new_actors.empty()) {
+    create_actors();
+    return;
+  }
+  // The backend storage is supposed to be reliable, so the status must be ok.
+  RAY_CHECK_OK(gcs_table_storage_->ActorTable().BatchPut(
+      actor_ids, actor_table_data, [create_actors](const Status &status) {
+        RAY_CHECK_OK(status);
+        create_actors();
+      }));
+}
+
 void GcsActorManager::HandleGetActorInfo(const rpc::GetActorInfoRequest &request,
                                          rpc::GetActorInfoReply *reply,
                                          rpc::SendReplyCallback send_reply_callback) {
@@ -326,8 +442,30 @@ Status GcsActorManager::RegisterActor(const ray::rpc::RegisterActorRequest &requ
   // the GCS server is restarted, it is required to continue to register actor
   // successfully.
   RAY_CHECK(success_callback);
-  const auto &actor_creation_task_spec = request.task_spec().actor_creation_task_spec();
+  std::shared_ptr<GcsActor> actor;
+  RAY_RETURN_NOT_OK(
+      AddRegisteredActor(request.task_spec(), std::move(success_callback), &actor));
+  if (!actor) {
+    return Status::OK();
+  }
+
+  // The backend storage is supposed to be reliable, so the status must be ok.
+  RAY_CHECK_OK(gcs_table_storage_->ActorTable().Put(
+      actor->GetActorID(), *actor->GetMutableActorTableData(),
+      [this, actor](const Status &status) {
+        // The backend storage is supposed to be reliable, so the status must be ok.
+        RAY_CHECK_OK(status);
+        OnActorRegistrationPersisted(actor);
+      }));
+  return Status::OK();
+}
+
+Status GcsActorManager::AddRegisteredActor(const rpc::TaskSpec &task_spec,
+                                           RegisterActorCallback success_callback,
+                                           std::shared_ptr<GcsActor> *new_actor) {
+  const auto &actor_creation_task_spec = task_spec.actor_creation_task_spec();
   auto actor_id = ActorID::FromBinary(actor_creation_task_spec.actor_id());
+  new_actor->reset();
 
   auto iter = registered_actors_.find(actor_id);
   if (iter != registered_actors_.end()) {
@@ -347,7 +485,7 @@ Status GcsActorManager::RegisterActor(const ray::rpc::RegisterActorRequest &requ
     return Status::OK();
   }
 
-  const auto job_id = JobID::FromBinary(request.task_spec().job_id());
+  const auto job_id = JobID::FromBinary(task_spec.job_id());
 
   // Use the namespace in task options by default. Otherwise use the
   // namespace from the job.
@@ -355,7 +493,7 @@ Status GcsActorManager::RegisterActor(const ray::rpc::RegisterActorRequest &requ
   if (ray_namespace.empty()) {
     ray_namespace = get_ray_namespace_(job_id);
   }
-  auto actor = std::make_shared<GcsActor>(request.task_spec(), ray_namespace);
+  auto actor = std::make_shared<GcsActor>(task_spec, ray_namespace);
   if (!actor->GetName().empty()) {
     auto &actors_in_namespace = named_actors_[actor->GetRayNamespace()];
     auto it = actors_in_namespace.find(actor->GetName());
@@ -400,50 +538,55 @@ Status GcsActorManager::RegisterActor(const ray::rpc::RegisterActorRequest &requ
   } else {
     // If it's a detached actor, we need to register the runtime env it used to GC.
     runtime_env_manager_.AddURIReference(actor->GetActorID().Hex(),
-                                         request.task_spec().runtime_env());
+                                         task_spec.runtime_env());
   }
 
-  // The backend storage is supposed to be reliable, so the status must be ok.
-  RAY_CHECK_OK(gcs_table_storage_->ActorTable().Put(
-      actor->GetActorID(), *actor->GetMutableActorTableData(),
-      [this, actor](const Status &status) {
-        // The backend storage is supposed to be reliable, so the status must be ok.
-        RAY_CHECK_OK(status);
-        // If a creator dies before this callback is called, the actor could have been
-        // already destroyed. It is okay not to invoke a callback because we don't need
-        // to reply to the creator as it is already dead.
-        auto registered_actor_it = registered_actors_.find(actor->GetActorID());
-        if (registered_actor_it == registered_actors_.end()) {
-          // NOTE(sang): This logic assumes that the ordering of backend call is
-          // guaranteed. It is currently true because we use a single TCP socket to call
-          // the default Redis backend. If ordering is not guaranteed, we should overwrite
-          // the actor state to DEAD to avoid race condition.
-          return;
-        }
-        RAY_CHECK_OK(gcs_publisher_->PublishActor(actor->GetActorID(),
-                                                  actor->GetActorTableData(), nullptr));
-        // Invoke all callbacks for all registration requests of this actor (duplicated
-        // requests are included) and remove all of them from
-        // actor_to_register_callbacks_.
-        // Reply to the owner to indicate that the actor has been registered.
-        auto iter = actor_to_register_callbacks_.find(actor->GetActorID());
-        RAY_CHECK(iter != actor_to_register_callbacks_.end() && !iter->second.empty());
-        auto callbacks = std::move(iter->second);
-        actor_to_register_callbacks_.erase(iter);
-        for (auto &callback : callbacks) {
-          callback(actor);
-        }
-      }));
+  *new_actor = std::move(actor);
   return Status::OK();
 }
 
+void GcsActorManager::OnActorRegistrationPersisted(
+    const std::shared_ptr<GcsActor> &actor) {
+  // If a creator dies before the actor is persisted, the actor could have been already
+  // destroyed. It is okay not to invoke a callback because we don't need to reply to the
+  // creator as it is already dead.
+  auto registered_actor_it = registered_actors_.find(actor->GetActorID());
+  if (registered_actor_it == registered_actors_.end()) {
+    // NOTE(sang): This logic assumes that the ordering of backend call is
+    // guaranteed. It is currently true because we use a single TCP socket to call
+    // the default Redis backend. If ordering is not guaranteed, we should overwrite
+    // the actor state to DEAD to avoid race condition.
+    return;
+  }
+  RAY_CHECK_OK(gcs_publisher_->PublishActor(actor->GetActorID(),
+                                            actor->GetActorTableData(), nullptr));
+  // Invoke all callbacks for all registration requests of this actor (duplicated
+  // requests are included) and remove all of them from
+  // actor_to_register_callbacks_.
+  // Reply to the owner to indicate that the actor has been registered.
+  auto iter = actor_to_register_callbacks_.find(actor->GetActorID());
+  RAY_CHECK(iter != actor_to_register_callbacks_.end() && !iter->second.empty());
+  auto callbacks = std::move(iter->second);
+  actor_to_register_callbacks_.erase(iter);
+  for (auto &callback : callbacks) {
+    callback(actor);
+  }
+}
+
 Status GcsActorManager::CreateActor(const ray::rpc::CreateActorRequest &request,
                                     CreateActorCallback callback) {
   // NOTE: After the abnormal recovery of the network between GCS client and GCS server or
   // the GCS server is restarted, it is required to continue to create actor
   // successfully.
   RAY_CHECK(callback);
-  const auto &actor_creation_task_spec = request.task_spec().actor_creation_task_spec();
+  return DoCreateActor(request.task_spec(), std::move(callback),
+                       /*actors_to_schedule=*/nullptr);
+}
+
+Status GcsActorManager::DoCreateActor(
+    const rpc::TaskSpec &task_spec, CreateActorCallback callback,
+    std::vector<std::shared_ptr<GcsActor>> *actors_to_schedule) {
+  const auto &actor_creation_task_spec = task_spec.actor_creation_task_spec();
   auto actor_id = ActorID::FromBinary(actor_creation_task_spec.actor_id());
 
   auto iter = registered_actors_.find(actor_id);
@@ -484,9 +627,8 @@ Status GcsActorManager::CreateActor(const ray::rpc::CreateActorRequest &request,
   }
 
   // Remove the actor from the unresolved actor map.
-  const auto job_id = JobID::FromBinary(request.task_spec().job_id());
-  auto actor =
-      std::make_shared<GcsActor>(request.task_spec(), get_ray_namespace_(job_id));
+  const auto job_id = JobID::FromBinary(task_spec.job_id());
+  auto actor = std::make_shared<GcsActor>(task_spec, get_ray_namespace_(job_id));
   actor->GetMutableActorTableData()->set_state(rpc::ActorTableData::PENDING_CREATION);
   const auto &actor_table_data = actor->GetActorTableData();
   // Pub this state for dashboard showing.
@@ -498,7 +640,11 @@ Status GcsActorManager::CreateActor(const ray::rpc::CreateActorRequest &request,
   registered_actors_[actor_id] = actor;
 
   // Schedule the actor.
-  gcs_actor_scheduler_->Schedule(actor);
+  if (actors_to_schedule) {
+    actors_to_schedule->emplace_back(std::move(actor));
+  } else {
+    gcs_actor_scheduler_->Schedule(actor);
+  }
   return Status::OK();
 }
 
@@ -581,6 +727,14 @@ void GcsActorManager::DestroyActor(const ActorID &actor_id) {
                 << ", job id = " << actor_id.JobId();
   actor_to_register_callbacks_.erase(actor_id);
   actor_to_create_callbacks_.erase(actor_id);
+  auto failure_callbacks_it = actor_to_create_failure_callbacks_.find(actor_id);
+  if (failure_callbacks_it != actor_to_create_failure_callbacks_.end()) {
+    auto failure_callbacks = std::move(failure_callbacks_it->second);
+    actor_to_create_failure_callbacks_.erase(failure_callbacks_it);
+    for (auto &callback : failure_callbacks) {
+      callback(Status::Invalid("Actor was destroyed before it was created."));
+    }
+  }
   auto it = registered_actors_.find(actor_id);
   if (it == registered_actors_.end()) {
     RAY_LOG(INFO) << "Tried to destroy actor that does not exist " << actor_id;
@@ -974,6 +1128,7 @@ void GcsActorManager::OnActorCreationSuccess(const std::shared_ptr<GcsActor> &ac
           }
           actor_to_create_callbacks_.erase(iter);
         }
+        actor_to_create_failure_callbacks_.erase(actor_id);
       }));
 }
 
@@ -985,9 +1140,8 @@ void GcsActorManager::SchedulePendingActors() {
 
   RAY_LOG(DEBUG) << "Scheduling actor creation tasks, size = " << pending_actors_.size();
   auto actors = std::move(pending_actors_);
-  for (auto &actor : actors) {
-    gcs_actor_scheduler_->Schedule(std::move(actor));
-  }
+  pending_actors_.clear();
+  gcs_actor_scheduler_->ScheduleBatch(std::move(actors));
 }
 
 bool GcsActorManager::GetSchedulePendingActorsPosted() const {
@@ -1264,6 +1418,7 @@ std::string GcsActorManager::DebugString() const {
          << ", KillActor request count: " << counts_[CountType::KILL_ACTOR_REQUEST]
          << ", ListNamedActors request count: "
          << counts_[CountType::LIST_NAMED_ACTORS_REQUEST]
+         << ", CreateActors request count: " << counts_[CountType::CREATE_ACTORS_REQUEST]
          << ", Registered actors count: " << registered_actors_.size()
          << ", Destroyed actors count: " << destroyed_actors_.size()
          << ", Named actors count: " << num_named_actors
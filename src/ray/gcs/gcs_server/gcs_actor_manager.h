@@ -215,6 +215,13 @@ class GcsActorManager : public rpc::ActorInfoHandler {
                          rpc::CreateActorReply *reply,
                          rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Register and create a batch of actors whose dependencies are resolved. The new
+  /// actors are persisted with one storage write and scheduled together, and the reply
+  /// is sent once every actor is either created or failed.
+  void HandleCreateActors(const rpc::CreateActorsRequest &request,
+                          rpc::CreateActorsReply *reply,
+                          rpc::SendReplyCallback send_reply_callback) override;
+
   void HandleGetActorInfo(const rpc::GetActorInfoRequest &request,
                           rpc::GetActorInfoReply *reply,
                           rpc::SendReplyCallback send_reply_callback) override;
@@ -407,6 +414,34 @@ class GcsActorManager : public rpc::ActorInfoHandler {
   /// \param actor The actor to be removed.
   void RemoveUnresolvedActor(const std::shared_ptr<GcsActor> &actor);
 
+  /// Add an actor to the in-memory registry without persisting it.
+  ///
+  /// \param task_spec The actor creation task of the actor.
+  /// \param success_callback Will be invoked after the actor is persisted.
+  /// \param[out] new_actor The new actor, which must be persisted and then passed to
+  /// `OnActorRegistrationPersisted`. Set to nullptr if the actor was already registered.
+  /// \return Status::Invalid if this is a named actor and an actor with the specified
+  /// name already exists. The callback will not be called in this case.
+  Status AddRegisteredActor(const rpc::TaskSpec &task_spec,
+                            RegisterActorCallback success_callback,
+                            std::shared_ptr<GcsActor> *new_actor);
+
+  /// Publish a registered actor and invoke its registration callbacks once it has been
+  /// persisted.
+  ///
+  /// \param actor The actor that has been persisted.
+  void OnActorRegistrationPersisted(const std::shared_ptr<GcsActor> &actor);
+
+  /// Create a registered actor.
+  ///
+  /// \param task_spec The actor creation task of the actor, with resolved dependencies.
+  /// \param callback Will be invoked after the actor is created successfully.
+  /// \param[out] actors_to_schedule If not nullptr, the actor is added to it instead of
+  /// being scheduled, so that the caller can schedule a batch of actors at once.
+  /// \return Status::Invalid if the actor isn't registered.
+  Status DoCreateActor(const rpc::TaskSpec &task_spec, CreateActorCallback callback,
+                       std::vector<std::shared_ptr<GcsActor>> *actors_to_schedule);
+
   /// Remove the specified actor from owner.
   ///
   /// \param actor The actor to be removed.
@@ -470,6 +505,11 @@ class GcsActorManager : public rpc::ActorInfoHandler {
   /// messages come from a Driver/Worker caused by some network problems.
   absl::flat_hash_map<ActorID, std::vector<CreateActorCallback>>
       actor_to_create_callbacks_;
+  /// Callbacks of batched actor creation requests that are invoked if the actor is
+  /// destroyed before it is created. They are cleared along with
+  /// `actor_to_create_callbacks_`.
+  absl::flat_hash_map<ActorID, std::vector<std::function<void(const Status &)>>>
+      actor_to_create_failure_callbacks_;
   /// All registered actors (unresoved and pending actors are also included).
   /// TODO(swang): Use unique_ptr instead of shared_ptr.
   absl::flat_hash_map<ActorID, std::shared_ptr<GcsActor>> registered_actors_;
@@ -534,7 +574,8 @@ class GcsActorManager : public rpc::ActorInfoHandler {
     GET_ALL_ACTOR_INFO_REQUEST = 4,
     KILL_ACTOR_REQUEST = 5,
     LIST_NAMED_ACTORS_REQUEST = 6,
-    CountType_MAX = 7,
+    CREATE_ACTORS_REQUEST = 7,
+    CountType_MAX = 8,
   };
   uint64_t counts_[CountType::CountType_MAX] = {0};
 };
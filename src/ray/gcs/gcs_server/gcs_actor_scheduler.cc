@@ -42,30 +42,49 @@ GcsActorScheduler::GcsActorScheduler(
 }
 
 void GcsActorScheduler::Schedule(std::shared_ptr<GcsActor> actor) {
-  RAY_CHECK(actor->GetNodeID().IsNil() && actor->GetWorkerID().IsNil());
-
-  // Select a node to lease worker for the actor.
-  auto node_id = SelectNode(actor);
+  ScheduleBatch({std::move(actor)});
+}
 
-  auto node = gcs_node_manager_.GetAliveNode(node_id);
-  if (!node.has_value()) {
-    // There are no available nodes to schedule the actor, so just trigger the failed
-    // handler.
-    schedule_failure_handler_(std::move(actor), /*destroy_actor*/ false);
-    return;
-  }
+void GcsActorScheduler::ScheduleBatch(std::vector<std::shared_ptr<GcsActor>> actors) {
+  // Select the nodes for all actors first, so that the lease requests can be grouped by
+  // node. The nodes are kept in the order they were first selected.
+  std::vector<std::pair<std::shared_ptr<rpc::GcsNodeInfo>,
+                        std::vector<std::shared_ptr<GcsActor>>>>
+      node_to_actors;
+  absl::flat_hash_map<NodeID, size_t> node_index;
+  for (auto &actor : actors) {
+    RAY_CHECK(actor->GetNodeID().IsNil() && actor->GetWorkerID().IsNil());
+
+    // Select a node to lease worker for the actor.
+    auto node_id = SelectNode(actor);
+    auto it = node_index.find(node_id);
+    if (it == node_index.end()) {
+      auto node = gcs_node_manager_.GetAliveNode(node_id);
+      if (!node.has_value()) {
+        // There are no available nodes to schedule the actor, so just trigger the failed
+        // handler.
+        schedule_failure_handler_(std::move(actor), /*destroy_actor*/ false);
+        continue;
+      }
+      it = node_index.emplace(node_id, node_to_actors.size()).first;
+      node_to_actors.emplace_back(node.value(), std::vector<std::shared_ptr<GcsActor>>());
+    }
 
-  // Update the address of the actor as it is tied to a node.
-  rpc::Address address;
-  address.set_raylet_id(node.value()->node_id());
-  actor->UpdateAddress(address);
+    // Update the address of the actor as it is tied to a node.
+    rpc::Address address;
+    address.set_raylet_id(node_id.Binary());
+    actor->UpdateAddress(address);
 
-  RAY_CHECK(node_to_actors_when_leasing_[actor->GetNodeID()]
-                .emplace(actor->GetActorID())
-                .second);
+    RAY_CHECK(node_to_actors_when_leasing_[actor->GetNodeID()]
+                  .emplace(actor->GetActorID())
+                  .second);
+    node_to_actors[it->second].second.emplace_back(std::move(actor));
+  }
 
-  // Lease worker directly from the node.
-  LeaseWorkerFromNode(actor, node.value());
+  // Lease workers directly from the nodes.
+  for (auto &entry : node_to_actors) {
+    LeaseWorkersFromNode(std::move(entry.second), entry.first);
+  }
 }
 
 void GcsActorScheduler::Reschedule(std::shared_ptr<GcsActor> actor) {
@@ -207,16 +226,21 @@ void GcsActorScheduler::ReleaseUnusedWorkers(
 
 void GcsActorScheduler::LeaseWorkerFromNode(std::shared_ptr<GcsActor> actor,
                                             std::shared_ptr<rpc::GcsNodeInfo> node) {
-  RAY_CHECK(actor && node);
+  LeaseWorkersFromNode({std::move(actor)}, std::move(node));
+}
 
-  auto node_id = NodeID::FromBinary(node->node_id());
-  RAY_LOG(INFO) << "Start leasing worker from node " << node_id << " for actor "
-                << actor->GetActorID() << ", job id = " << actor->GetActorID().JobId();
+void GcsActorScheduler::LeaseWorkersFromNode(
+    std::vector<std::shared_ptr<GcsActor>> actors,
+    std::shared_ptr<rpc::GcsNodeInfo> node) {
+  RAY_CHECK(node);
 
+  auto node_id = NodeID::FromBinary(node->node_id());
   // We need to ensure that the RequestWorkerLease won't be sent before the reply of
   // ReleaseUnusedWorkers is returned.
   if (nodes_of_releasing_unused_workers_.contains(node_id)) {
-    RetryLeasingWorkerFromNode(actor, node);
+    for (auto &actor : actors) {
+      RetryLeasingWorkerFromNode(std::move(actor), node);
+    }
     return;
   }
 
@@ -225,15 +249,20 @@ void GcsActorScheduler::LeaseWorkerFromNode(std::shared_ptr<GcsActor> actor,
   remote_address.set_ip_address(node->node_manager_address());
   remote_address.set_port(node->node_manager_port());
   auto lease_client = GetOrConnectLeaseClient(remote_address);
-  // Actor leases should be sent to the raylet immediately, so we should never build up a
-  // backlog in GCS.
-  lease_client->RequestWorkerLease(
-      actor->GetActorTableData().task_spec(),
-      [this, actor, node](const Status &status,
-                          const rpc::RequestWorkerLeaseReply &reply) {
-        HandleWorkerLeaseReply(actor, node, status, reply);
-      },
-      0);
+  for (auto &actor : actors) {
+    RAY_CHECK(actor);
+    RAY_LOG(INFO) << "Start leasing worker from node " << node_id << " for actor "
+                  << actor->GetActorID() << ", job id = " << actor->GetActorID().JobId();
+    // Actor leases should be sent to the raylet immediately, so we should never build up
+    // a backlog in GCS.
+    lease_client->RequestWorkerLease(
+        actor->GetActorTableData().task_spec(),
+        [this, actor, node](const Status &status,
+                            const rpc::RequestWorkerLeaseReply &reply) {
+          HandleWorkerLeaseReply(actor, node, status, reply);
+        },
+        0);
+  }
 }
 
 void GcsActorScheduler::RetryLeasingWorkerFromNode(
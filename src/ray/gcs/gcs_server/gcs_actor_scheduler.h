@@ -43,6 +43,15 @@ class GcsActorSchedulerInterface {
   /// \param actor to be scheduled.
   virtual void Schedule(std::shared_ptr<GcsActor> actor) = 0;
 
+  /// Schedule a batch of actors. By default the actors are scheduled one by one.
+  ///
+  /// \param actors The actors to be scheduled.
+  virtual void ScheduleBatch(std::vector<std::shared_ptr<GcsActor>> actors) {
+    for (auto &actor : actors) {
+      Schedule(std::move(actor));
+    }
+  }
+
   /// Reschedule the specified actor after gcs server restarts.
   ///
   /// \param actor to be scheduled.
@@ -115,6 +124,14 @@ class GcsActorScheduler : public GcsActorSchedulerInterface {
   /// \param actor to be scheduled.
   void Schedule(std::shared_ptr<GcsActor> actor) override;
 
+  /// Schedule a batch of actors. Nodes are selected for all of the actors first, and
+  /// then the lease requests to each node are sent together through one lease client.
+  /// If there is no available node for an actor then the `schedule_failed_handler_`
+  /// will be triggered for it.
+  ///
+  /// \param actors The actors to be scheduled.
+  void ScheduleBatch(std::vector<std::shared_ptr<GcsActor>> actors) override;
+
   /// Reschedule the specified actor after gcs server restarts.
   ///
   /// \param actor to be scheduled.
@@ -221,6 +238,13 @@ class GcsActorScheduler : public GcsActorSchedulerInterface {
   void LeaseWorkerFromNode(std::shared_ptr<GcsActor> actor,
                            std::shared_ptr<rpc::GcsNodeInfo> node);
 
+  /// Lease workers from the specified node for a batch of actors.
+  ///
+  /// \param actors The actors to create, which are all tied to the node.
+  /// \param node The node that the workers will be leased from.
+  void LeaseWorkersFromNode(std::vector<std::shared_ptr<GcsActor>> actors,
+                            std::shared_ptr<rpc::GcsNodeInfo> node);
+
   /// Handler to process a worker lease reply.
   ///
   /// \param actor The actor to be scheduled.
@@ -0,0 +1,69 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/gcs_event_loops.h"
+
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+namespace ray {
+namespace gcs {
+
+GcsEventLoops::GcsEventLoops(instrumented_io_context &main_service, size_t num_loops)
+    : main_service_(main_service) {
+  for (size_t i = 1; i < num_loops; i++) {
+    io_services_.emplace_back(new instrumented_io_context());
+  }
+}
+
+GcsEventLoops::~GcsEventLoops() { Stop(); }
+
+void GcsEventLoops::Start() {
+  RAY_CHECK(threads_.empty());
+  for (size_t i = 0; i < io_services_.size(); i++) {
+    auto &io_service = *io_services_[i];
+    threads_.emplace_back(new std::thread([&io_service, i] {
+      SetThreadName("gcs_loop_" + std::to_string(i + 1));
+      /// The asio work to keep io_service alive.
+      boost::asio::io_service::work io_service_work(io_service);
+      io_service.run();
+    }));
+  }
+  RAY_LOG(INFO) << "Started " << io_services_.size()
+                << " GCS event loops besides the main one.";
+}
+
+void GcsEventLoops::Stop() {
+  for (auto &io_service : io_services_) {
+    io_service->stop();
+  }
+  for (auto &thread : threads_) {
+    if (thread->joinable()) {
+      thread->join();
+    }
+  }
+  threads_.clear();
+}
+
+instrumented_io_context &GcsEventLoops::Next() {
+  if (io_services_.empty()) {
+    return main_service_;
+  }
+  auto &io_service = *io_services_[next_];
+  next_ = (next_ + 1) % io_services_.size();
+  return io_service;
+}
+
+}  // namespace gcs
+}  // namespace ray
@@ -0,0 +1,68 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ray/common/asio/instrumented_io_context.h"
+
+namespace ray {
+namespace gcs {
+
+/// The event loops that drive the GCS managers. The main event loop drives the
+/// managers that share state with each other, e.g., the actor, node and placement group
+/// managers. Each additional loop runs on its own thread and drives managers that don't
+/// share state with the ones on other loops, so that they don't compete for the main
+/// thread. Managers on different loops only interact by posting to each other's loop.
+/// This class is not thread-safe.
+class GcsEventLoops {
+ public:
+  /// Create the event loops.
+  ///
+  /// \param main_service The main event loop, which is run by the caller.
+  /// \param num_loops The total number of loops, including the main one.
+  GcsEventLoops(instrumented_io_context &main_service, size_t num_loops);
+
+  ~GcsEventLoops();
+
+  /// Start running the additional loops on their own threads. Managers should be
+  /// attached to their loops before this is called.
+  void Start();
+
+  /// Stop the additional loops and wait for their threads to exit.
+  void Stop();
+
+  /// The main event loop.
+  instrumented_io_context &Main() { return main_service_; }
+
+  /// Pick the loop for the next manager that doesn't share state with the managers on
+  /// the main loop. The additional loops are assigned round robin, and if there are
+  /// none, this is the main loop.
+  instrumented_io_context &Next();
+
+  /// The total number of loops, including the main one.
+  size_t Size() const { return io_services_.size() + 1; }
+
+ private:
+  instrumented_io_context &main_service_;
+  std::vector<std::unique_ptr<instrumented_io_context>> io_services_;
+  std::vector<std::unique_ptr<std::thread>> threads_;
+  size_t next_ = 0;
+};
+
+}  // namespace gcs
+}  // namespace ray
@@ -13,22 +13,62 @@
 // limitations under the License.
 
 #include "ray/gcs/gcs_server/gcs_heartbeat_manager.h"
+
+#include <cmath>
+
 #include "ray/common/ray_config.h"
 #include "ray/gcs/pb_util.h"
+#include "ray/util/util.h"
 #include "src/ray/protobuf/gcs.pb.h"
 
 namespace ray {
 namespace gcs {
 
+namespace {
+
+/// The weight of the last interval in the moving average of the heartbeat intervals.
+const double kIntervalSmoothing = 0.1;
+
+/// The adaptive timeout of a node is at most this many times the fixed one, so that a
+/// node that paused for long once can't hide its death for long.
+const int64_t kMaxTimeoutFactor = 4;
+
+/// The number of standard deviations of a normal distribution above which the
+/// probability is 10^-phi.
+double PhiToStddevs(double phi) {
+  const double tail = std::pow(10, -phi);
+  double low = 0;
+  double high = 40;
+  for (int i = 0; i < 100; i++) {
+    double mid = (low + high) / 2;
+    if (0.5 * std::erfc(mid / std::sqrt(2.0)) > tail) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return high;
+}
+
+}  // namespace
+
 GcsHeartbeatManager::GcsHeartbeatManager(
     instrumented_io_context &io_service,
-    std::function<void(const NodeID &)> on_node_death_callback)
+    std::function<void(const NodeID &)> on_node_death_callback,
+    std::function<int64_t()> now_ms)
     : io_service_(io_service),
       on_node_death_callback_(std::move(on_node_death_callback)),
       num_heartbeats_timeout_(RayConfig::instance().num_heartbeats_timeout()),
+      heartbeat_period_ms_(std::max<uint64_t>(
+          1, RayConfig::instance().raylet_heartbeat_period_milliseconds())),
+      now_ms_(std::move(now_ms)),
       periodical_runner_(io_service) {
+  const double phi_threshold = RayConfig::instance().gcs_heartbeat_phi_threshold();
+  if (phi_threshold > 0) {
+    phi_timeout_stddevs_ = PhiToStddevs(phi_threshold);
+  }
   RAY_LOG(INFO) << "GcsHeartbeatManager start, num_heartbeats_timeout="
-                << num_heartbeats_timeout_;
+                << num_heartbeats_timeout_ << ", phi_threshold=" << phi_threshold;
   io_service_thread_.reset(new std::thread([this] {
     SetThreadName("heartbeat");
     /// The asio work to keep io_service_ alive.
@@ -40,7 +80,7 @@ GcsHeartbeatManager::GcsHeartbeatManager(
 void GcsHeartbeatManager::Initialize(const GcsInitData &gcs_init_data) {
   for (const auto &item : gcs_init_data.Nodes()) {
     if (item.second.state() == rpc::GcsNodeInfo::ALIVE) {
-      heartbeats_.emplace(item.first, num_heartbeats_timeout_);
+      TrackNode(item.first);
     }
   }
 }
@@ -67,9 +107,8 @@ void GcsHeartbeatManager::Stop() {
 }
 
 void GcsHeartbeatManager::AddNode(const NodeID &node_id) {
-  io_service_.post(
-      [this, node_id] { heartbeats_.emplace(node_id, num_heartbeats_timeout_); },
-      "GcsHeartbeatManager.AddNode");
+  io_service_.post([this, node_id] { TrackNode(node_id); },
+                   "GcsHeartbeatManager.AddNode");
 }
 
 void GcsHeartbeatManager::HandleReportHeartbeat(
@@ -84,7 +123,7 @@ void GcsHeartbeatManager::HandleReportHeartbeat(
     return;
   }
 
-  iter->second = num_heartbeats_timeout_;
+  RecordHeartbeat(node_id, &iter->second);
   GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
 }
 
@@ -95,18 +134,57 @@ void GcsHeartbeatManager::HandleCheckAlive(const rpc::CheckAliveRequest &request
 }
 
 void GcsHeartbeatManager::DetectDeadNodes() {
-  for (auto it = heartbeats_.begin(); it != heartbeats_.end();) {
-    auto current = it++;
-    current->second = current->second - 1;
-    if (current->second == 0) {
-      auto node_id = current->first;
-      RAY_LOG(WARNING) << "Node timed out: " << node_id;
-      heartbeats_.erase(current);
-      if (on_node_death_callback_) {
-        on_node_death_callback_(node_id);
-      }
+  deadlines_.Advance(deadlines_.CurrentTick() + 1, [this](const NodeID &node_id) {
+    RAY_LOG(WARNING) << "Node timed out: " << node_id;
+    heartbeats_.erase(node_id);
+    if (on_node_death_callback_) {
+      on_node_death_callback_(node_id);
     }
+  });
+}
+
+void GcsHeartbeatManager::TrackNode(const NodeID &node_id) {
+  auto inserted = heartbeats_.emplace(node_id, NodeHeartbeat());
+  if (!inserted.second) {
+    return;
+  }
+  auto &heartbeat = inserted.first->second;
+  // Until there is a history, expect heartbeats every period, give or take a quarter.
+  heartbeat.mean_interval_ms = heartbeat_period_ms_;
+  heartbeat.interval_variance = std::pow(heartbeat_period_ms_ / 4.0, 2);
+  deadlines_.Schedule(node_id, deadlines_.CurrentTick() + TimeoutTicks(heartbeat));
+}
+
+void GcsHeartbeatManager::RecordHeartbeat(const NodeID &node_id,
+                                          NodeHeartbeat *heartbeat) {
+  if (phi_timeout_stddevs_ > 0) {
+    auto now_ms = NowMs();
+    if (heartbeat->last_heartbeat_ms > 0) {
+      // Exponentially weighted moving average and variance of the intervals.
+      double diff = (now_ms - heartbeat->last_heartbeat_ms) - heartbeat->mean_interval_ms;
+      heartbeat->mean_interval_ms += kIntervalSmoothing * diff;
+      heartbeat->interval_variance =
+          (1 - kIntervalSmoothing) *
+          (heartbeat->interval_variance + kIntervalSmoothing * diff * diff);
+    }
+    heartbeat->last_heartbeat_ms = now_ms;
+  }
+  deadlines_.Schedule(node_id, deadlines_.CurrentTick() + TimeoutTicks(*heartbeat));
+}
+
+int64_t GcsHeartbeatManager::TimeoutTicks(const NodeHeartbeat &heartbeat) const {
+  if (phi_timeout_stddevs_ <= 0) {
+    return num_heartbeats_timeout_;
   }
+  double timeout_ms = heartbeat.mean_interval_ms +
+                      phi_timeout_stddevs_ * std::sqrt(heartbeat.interval_variance);
+  auto ticks = static_cast<int64_t>(std::ceil(timeout_ms / heartbeat_period_ms_));
+  return std::min(std::max(ticks, num_heartbeats_timeout_),
+                  kMaxTimeoutFactor * num_heartbeats_timeout_);
+}
+
+int64_t GcsHeartbeatManager::NowMs() const {
+  return now_ms_ ? now_ms_() : current_time_ms();
 }
 
 }  // namespace gcs
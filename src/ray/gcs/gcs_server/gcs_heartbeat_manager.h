@@ -22,6 +22,7 @@
 #include "ray/gcs/gcs_server/gcs_init_data.h"
 #include "ray/rpc/client_call.h"
 #include "ray/rpc/gcs_server/gcs_rpc_server.h"
+#include "ray/util/timing_wheel.h"
 #include "src/ray/protobuf/gcs.pb.h"
 
 namespace ray {
@@ -29,6 +30,10 @@ namespace gcs {
 
 /// GcsHeartbeatManager is responsible for monitoring nodes liveness as well as
 /// handing heartbeat rpc requests. This class is not thread-safe.
+///
+/// The deadline of each node is kept in a timing wheel that advances one tick per
+/// heartbeat period, so a heartbeat reschedules its node in O(1) and a tick only
+/// touches the nodes that time out.
 class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
  public:
   /// Create a GcsHeartbeatManager.
@@ -36,9 +41,12 @@ class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
   /// \param io_service The event loop to run the monitor on.
   /// \param on_node_death_callback Callback that will be called when node death is
   /// detected.
+  /// \param now_ms The clock that heartbeat intervals are measured with, the system
+  /// clock by default.
   explicit GcsHeartbeatManager(
       instrumented_io_context &io_service,
-      std::function<void(const NodeID &)> on_node_death_callback);
+      std::function<void(const NodeID &)> on_node_death_callback,
+      std::function<int64_t()> now_ms = nullptr);
 
   /// Handle heartbeat rpc come from raylet.
   void HandleReportHeartbeat(const rpc::ReportHeartbeatRequest &request,
@@ -74,6 +82,26 @@ class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
   void DetectDeadNodes();
 
  private:
+  /// The heartbeat history of a node.
+  struct NodeHeartbeat {
+    /// The time of the last heartbeat, or 0 before the first one.
+    int64_t last_heartbeat_ms = 0;
+    /// The moving average and variance of the intervals between heartbeats.
+    double mean_interval_ms;
+    double interval_variance;
+  };
+
+  /// Track a node, and schedule its deadline.
+  void TrackNode(const NodeID &node_id);
+
+  /// Record a heartbeat of a node, and reschedule its deadline.
+  void RecordHeartbeat(const NodeID &node_id, NodeHeartbeat *heartbeat);
+
+  /// The number of ticks that a node may miss heartbeats for before it's declared dead.
+  int64_t TimeoutTicks(const NodeHeartbeat &heartbeat) const;
+
+  int64_t NowMs() const;
+
   /// The main event loop for node failure detector.
   instrumented_io_context &io_service_;
   std::unique_ptr<std::thread> io_service_thread_;
@@ -81,11 +109,18 @@ class GcsHeartbeatManager : public rpc::HeartbeatInfoHandler {
   std::function<void(const NodeID &)> on_node_death_callback_;
   /// The number of heartbeats that can be missed before a node is removed.
   int64_t num_heartbeats_timeout_;
+  /// The period of heartbeats, and of the ticks of the failure detector.
+  uint64_t heartbeat_period_ms_;
+  /// The number of standard deviations above the mean heartbeat interval after which
+  /// a node is declared dead, if the timeouts are adaptive, otherwise 0.
+  double phi_timeout_stddevs_ = 0;
+  std::function<int64_t()> now_ms_;
   /// The runner to run function periodically.
   PeriodicalRunner periodical_runner_;
-  /// For each Raylet that we receive a heartbeat from, the number of ticks
-  /// that may pass before the Raylet will be declared dead.
-  absl::flat_hash_map<NodeID, int64_t> heartbeats_;
+  /// The heartbeat history of each Raylet that we receive heartbeats from.
+  absl::flat_hash_map<NodeID, NodeHeartbeat> heartbeats_;
+  /// The tick at which each Raylet will be declared dead, unless it sends a heartbeat.
+  TimingWheel<NodeID> deadlines_;
   /// Is the detect started.
   bool is_started_ = false;
 };
@@ -14,9 +14,110 @@
 
 #include "ray/gcs/gcs_server/gcs_init_data.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace ray {
 namespace gcs {
+
+namespace {
+
+/// Parse the entries of a table of the snapshot. Large tables are parsed by several
+/// threads, since parsing is most of the time to load them.
+template <typename Key, typename Data>
+void ParseTable(std::unordered_map<std::string, std::string> &&table,
+                std::unordered_map<Key, Data> *result) {
+  const size_t kMinEntriesPerThread = 1000;
+  std::vector<std::pair<Key, Data>> entries;
+  entries.reserve(table.size());
+  std::vector<const std::string *> values;
+  values.reserve(table.size());
+  for (const auto &entry : table) {
+    entries.emplace_back(Key::FromBinary(entry.first), Data());
+    values.push_back(&entry.second);
+  }
+  auto parse = [&entries, &values](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      RAY_CHECK(entries[i].second.ParseFromString(*values[i]));
+    }
+  };
+  const size_t num_threads =
+      std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(),
+                                           entries.size() / kMinEntriesPerThread));
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(parse, i * entries.size() / num_threads,
+                         (i + 1) * entries.size() / num_threads);
+  }
+  parse(0, entries.size() / num_threads);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  result->reserve(entries.size());
+  for (auto &entry : entries) {
+    result->emplace(entry.first, std::move(entry.second));
+  }
+}
+
+}  // namespace
+
+absl::flat_hash_map<std::string, SnapshotStoreClient::IndexFunction>
+GcsInitData::SnapshotTables() {
+  return {
+      {TablePrefix_Name(TablePrefix::JOB), nullptr},
+      {TablePrefix_Name(TablePrefix::NODE), nullptr},
+      {TablePrefix_Name(TablePrefix::NODE_RESOURCE), nullptr},
+      {TablePrefix_Name(TablePrefix::PLACEMENT_GROUP), nullptr},
+      // The tables that are indexed by job, see `GcsTableWithJobId`.
+      {TablePrefix_Name(TablePrefix::ACTOR),
+       [](const std::string &key) { return ActorID::FromBinary(key).JobId().Binary(); }},
+      {TablePrefix_Name(TablePrefix::OBJECT),
+       [](const std::string &key) {
+         return ObjectID::FromBinary(key).TaskId().JobId().Binary();
+       }},
+  };
+}
+
 void GcsInitData::AsyncLoad(const EmptyCallback &on_done) {
+  if (snapshot_store_client_) {
+    snapshot_store_client_->AsyncLoad(
+        [this, on_done](boost::optional<SnapshotStoreClient::Tables> tables) {
+          if (!tables) {
+            RAY_LOG(INFO) << "There is no snapshot of the GCS tables, loading them "
+                             "from the store.";
+            AsyncLoadTables(on_done);
+            return;
+          }
+          LoadFromSnapshot(std::move(*tables));
+          if (on_done) {
+            on_done();
+          }
+        });
+  } else {
+    AsyncLoadTables(on_done);
+  }
+}
+
+void GcsInitData::LoadFromSnapshot(SnapshotStoreClient::Tables &&tables) {
+  ParseTable(std::move(tables[TablePrefix_Name(TablePrefix::JOB)]), &job_table_data_);
+  ParseTable(std::move(tables[TablePrefix_Name(TablePrefix::NODE)]), &node_table_data_);
+  ParseTable(std::move(tables[TablePrefix_Name(TablePrefix::OBJECT)]),
+             &object_table_data_);
+  ParseTable(std::move(tables[TablePrefix_Name(TablePrefix::NODE_RESOURCE)]),
+             &resource_table_data_);
+  ParseTable(std::move(tables[TablePrefix_Name(TablePrefix::ACTOR)]),
+             &actor_table_data_);
+  ParseTable(std::move(tables[TablePrefix_Name(TablePrefix::PLACEMENT_GROUP)]),
+             &placement_group_table_data_);
+  RAY_LOG(INFO) << "Finished loading the GCS tables from the snapshot, "
+                << job_table_data_.size() << " jobs, " << node_table_data_.size()
+                << " nodes, " << object_table_data_.size() << " objects, "
+                << resource_table_data_.size() << " node resources, "
+                << actor_table_data_.size() << " actors, "
+                << placement_group_table_data_.size() << " placement groups.";
+}
+
+void GcsInitData::AsyncLoadTables(const EmptyCallback &on_done) {
   // There are 6 kinds of table data need to be loaded.
   auto count_down = std::make_shared<int>(6);
   auto on_load_finished = [count_down, on_done] {
@@ -17,6 +17,7 @@
 #include "ray/common/id.h"
 #include "ray/gcs/callback.h"
 #include "ray/gcs/gcs_server/gcs_table_storage.h"
+#include "ray/gcs/store_client/snapshot_store_client.h"
 #include "src/ray/protobuf/gcs.pb.h"
 
 namespace ray {
@@ -31,10 +32,21 @@ class GcsInitData {
   /// Create a GcsInitData.
   ///
   /// \param gcs_table_storage The storage from which the metadata will be loaded.
-  explicit GcsInitData(std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage)
-      : gcs_table_storage_(std::move(gcs_table_storage)) {}
+  /// \param snapshot_store_client The snapshot of the tables, if they are snapshotted.
+  explicit GcsInitData(
+      std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage,
+      std::shared_ptr<SnapshotStoreClient> snapshot_store_client = nullptr)
+      : gcs_table_storage_(std::move(gcs_table_storage)),
+        snapshot_store_client_(std::move(snapshot_store_client)) {}
+
+  /// The tables that are loaded, and their index functions, to snapshot them with a
+  /// `SnapshotStoreClient`.
+  static absl::flat_hash_map<std::string, SnapshotStoreClient::IndexFunction>
+  SnapshotTables();
 
   /// Load all required metadata from the store into memory at once asynchronously.
+  /// If the tables are snapshotted, they are loaded from the snapshot with a single
+  /// read, otherwise from each table.
   ///
   /// \param on_done The callback when all metadatas are loaded successfully.
   void AsyncLoad(const EmptyCallback &on_done);
@@ -71,6 +83,16 @@ class GcsInitData {
   }
 
  private:
+  /// Load all required metadata from each table.
+  ///
+  /// \param on_done The callback when all metadatas are loaded successfully.
+  void AsyncLoadTables(const EmptyCallback &on_done);
+
+  /// Load the metadata from the snapshot of the tables.
+  ///
+  /// \param tables The tables of the snapshot.
+  void LoadFromSnapshot(SnapshotStoreClient::Tables &&tables);
+
   /// Load job metadata from the store into memory asynchronously.
   ///
   /// \param on_done The callback when job metadata is loaded successfully.
@@ -105,6 +127,9 @@ class GcsInitData {
   /// The gcs table storage.
   std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage_;
 
+  /// The snapshot of the tables, if they are snapshotted.
+  std::shared_ptr<SnapshotStoreClient> snapshot_store_client_;
+
   /// Job metadata.
   std::unordered_map<JobID, rpc::JobTableData> job_table_data_;
 
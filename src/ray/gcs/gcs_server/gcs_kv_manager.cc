@@ -14,78 +14,234 @@
 
 #include "ray/gcs/gcs_server/gcs_kv_manager.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
 namespace ray {
 namespace gcs {
 
-void GcsInternalKVManager::HandleInternalKVGet(
-    const rpc::InternalKVGetRequest &request, rpc::InternalKVGetReply *reply,
-    rpc::SendReplyCallback send_reply_callback) {
-  std::vector<std::string> cmd = {"HGET", request.key(), "value"};
+void RedisInternalKV::Get(const std::string &key,
+                          std::function<void(boost::optional<std::string>)> callback) {
+  std::vector<std::string> cmd = {"HGET", key, "value"};
   RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
-      cmd, [reply, send_reply_callback](auto redis_reply) {
+      cmd, [callback = std::move(callback)](auto redis_reply) {
         if (!redis_reply->IsNil()) {
-          reply->set_value(redis_reply->ReadAsString());
-          GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+          callback(redis_reply->ReadAsString());
         } else {
-          GCS_RPC_SEND_REPLY(send_reply_callback, reply,
-                             Status::NotFound("Failed to find the key"));
+          callback(boost::none);
+        }
+      }));
+}
+
+void RedisInternalKV::Put(const std::string &key, const std::string &value,
+                          bool overwrite, std::function<void(bool)> callback) {
+  std::vector<std::string> cmd = {overwrite ? "HSET" : "HSETNX", key, "value", value};
+  RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
+      cmd, [callback = std::move(callback)](auto redis_reply) {
+        callback(redis_reply->ReadAsInteger() > 0);
+      }));
+}
+
+void RedisInternalKV::Del(const std::string &key, std::function<void(int)> callback) {
+  std::vector<std::string> cmd = {"HDEL", key, "value"};
+  RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
+      cmd, [callback = std::move(callback)](auto redis_reply) {
+        callback(redis_reply->ReadAsInteger());
+      }));
+}
+
+void RedisInternalKV::Exists(const std::string &key, std::function<void(bool)> callback) {
+  std::vector<std::string> cmd = {"HEXISTS", key, "value"};
+  RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
+      cmd, [callback = std::move(callback)](auto redis_reply) {
+        callback(redis_reply->ReadAsInteger() > 0);
+      }));
+}
+
+void RedisInternalKV::Keys(const std::string &prefix,
+                           std::function<void(std::vector<std::string>)> callback) {
+  std::vector<std::string> cmd = {"KEYS", prefix + "*"};
+  RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
+      cmd, [callback = std::move(callback)](auto redis_reply) {
+        const auto &results = redis_reply->ReadAsStringArray();
+        std::vector<std::string> keys;
+        keys.reserve(results.size());
+        for (const auto &result : results) {
+          RAY_CHECK(result.has_value());
+          keys.push_back(*result);
         }
+        callback(std::move(keys));
       }));
 }
 
+MemoryInternalKV::MemoryInternalKV(instrumented_io_context &io_service,
+                                   std::shared_ptr<StoreClient> store_client)
+    : io_service_(io_service),
+      store_client_(std::move(store_client)),
+      table_name_(TablePrefix_Name(rpc::TablePrefix::KV)) {
+  RAY_CHECK_OK(store_client_->AsyncGetAll(
+      table_name_, [this](const std::unordered_map<std::string, std::string> &result) {
+        io_service_.post(
+            [this, result]() {
+              kv_.insert(result.begin(), result.end());
+              loaded_ = true;
+              RAY_LOG(INFO) << "Loaded " << kv_.size() << " keys of the internal KV.";
+              auto operations = std::move(pending_operations_);
+              pending_operations_.clear();
+              for (auto &operation : operations) {
+                operation();
+              }
+            },
+            "MemoryInternalKV.Load");
+      }));
+}
+
+void MemoryInternalKV::RunWhenLoaded(std::function<void()> operation) {
+  if (loaded_) {
+    operation();
+  } else {
+    pending_operations_.emplace_back(std::move(operation));
+  }
+}
+
+std::function<void(Status)> MemoryInternalKV::OnPersisted(
+    std::function<void()> callback) {
+  return [this, callback = std::move(callback)](const Status &status) {
+    if (!status.ok()) {
+      RAY_LOG(ERROR) << "Failed to persist the internal KV: " << status;
+    }
+    io_service_.post(callback, "MemoryInternalKV.OnPersisted");
+  };
+}
+
+void MemoryInternalKV::Get(const std::string &key,
+                           std::function<void(boost::optional<std::string>)> callback) {
+  RunWhenLoaded([this, key, callback = std::move(callback)]() {
+    auto it = kv_.find(key);
+    if (it == kv_.end()) {
+      callback(boost::none);
+    } else {
+      callback(it->second);
+    }
+  });
+}
+
+void MemoryInternalKV::Put(const std::string &key, const std::string &value,
+                           bool overwrite, std::function<void(bool)> callback) {
+  RunWhenLoaded([this, key, value, overwrite, callback = std::move(callback)]() {
+    auto result = kv_.emplace(key, value);
+    if (!result.second) {
+      if (!overwrite) {
+        callback(false);
+        return;
+      }
+      result.first->second = value;
+    }
+    // Reads see the new value right away, and the reply waits for it to be stored.
+    bool added = result.second;
+    RAY_CHECK_OK(store_client_->AsyncPut(
+        table_name_, key, value, OnPersisted([callback, added]() { callback(added); })));
+  });
+}
+
+void MemoryInternalKV::Del(const std::string &key, std::function<void(int)> callback) {
+  RunWhenLoaded([this, key, callback = std::move(callback)]() {
+    if (kv_.erase(key) == 0) {
+      callback(0);
+      return;
+    }
+    RAY_CHECK_OK(store_client_->AsyncDelete(
+        table_name_, key, OnPersisted([callback]() { callback(1); })));
+  });
+}
+
+void MemoryInternalKV::Exists(const std::string &key,
+                              std::function<void(bool)> callback) {
+  RunWhenLoaded([this, key, callback = std::move(callback)]() {
+    callback(kv_.find(key) != kv_.end());
+  });
+}
+
+void MemoryInternalKV::Keys(const std::string &prefix,
+                            std::function<void(std::vector<std::string>)> callback) {
+  RunWhenLoaded([this, prefix, callback = std::move(callback)]() {
+    std::vector<std::string> keys;
+    for (auto it = kv_.lower_bound(prefix);
+         it != kv_.end() && absl::StartsWith(it->first, prefix); ++it) {
+      keys.push_back(it->first);
+    }
+    callback(std::move(keys));
+  });
+}
+
+std::string GcsInternalKVManager::MakeKey(const std::string &ns, const std::string &key) {
+  if (ns.empty()) {
+    return key;
+  }
+  return absl::StrCat("@namespace_", ns, ":", key);
+}
+
+void GcsInternalKVManager::HandleInternalKVGet(
+    const rpc::InternalKVGetRequest &request, rpc::InternalKVGetReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  kv_->Get(MakeKey(request.namespace_(), request.key()),
+           [reply, send_reply_callback](boost::optional<std::string> value) {
+             if (value) {
+               reply->set_value(std::move(*value));
+               GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+             } else {
+               GCS_RPC_SEND_REPLY(send_reply_callback, reply,
+                                  Status::NotFound("Failed to find the key"));
+             }
+           });
+}
+
 void GcsInternalKVManager::HandleInternalKVPut(
     const rpc::InternalKVPutRequest &request, rpc::InternalKVPutReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
-  std::vector<std::string> cmd = {request.overwrite() ? "HSET" : "HSETNX", request.key(),
-                                  "value", request.value()};
-  RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
-      cmd, [reply, send_reply_callback](auto redis_reply) {
-        reply->set_added_num(redis_reply->ReadAsInteger());
-        GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
-      }));
+  kv_->Put(MakeKey(request.namespace_(), request.key()), request.value(),
+           request.overwrite(), [reply, send_reply_callback](bool added) {
+             reply->set_added_num(added ? 1 : 0);
+             GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+           });
 }
 
 void GcsInternalKVManager::HandleInternalKVDel(
     const rpc::InternalKVDelRequest &request, rpc::InternalKVDelReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
-  InternalKVDelAsync(request.key(), [reply, send_reply_callback](int deleted_num) {
-    reply->set_deleted_num(deleted_num);
-    GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
-  });
+  InternalKVDelAsync(MakeKey(request.namespace_(), request.key()),
+                     [reply, send_reply_callback](int deleted_num) {
+                       reply->set_deleted_num(deleted_num);
+                       GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+                     });
 }
 
 void GcsInternalKVManager::InternalKVDelAsync(const std::string &key,
                                               std::function<void(int)> cb) {
-  std::vector<std::string> cmd = {"HDEL", key, "value"};
-  RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
-      cmd, [cb](auto redis_reply) { cb(redis_reply->ReadAsInteger()); }));
+  kv_->Del(key, std::move(cb));
 }
 
 void GcsInternalKVManager::HandleInternalKVExists(
     const rpc::InternalKVExistsRequest &request, rpc::InternalKVExistsReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
-  std::vector<std::string> cmd = {"HEXISTS", request.key(), "value"};
-  RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
-      cmd, [reply, send_reply_callback](auto redis_reply) {
-        bool exists = redis_reply->ReadAsInteger() > 0;
-        reply->set_exists(exists);
-        GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
-      }));
+  kv_->Exists(MakeKey(request.namespace_(), request.key()),
+              [reply, send_reply_callback](bool exists) {
+                reply->set_exists(exists);
+                GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+              });
 }
 
 void GcsInternalKVManager::HandleInternalKVKeys(
     const rpc::InternalKVKeysRequest &request, rpc::InternalKVKeysReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
-  std::vector<std::string> cmd = {"KEYS", request.prefix() + "*"};
-  RAY_CHECK_OK(redis_client_->GetPrimaryContext()->RunArgvAsync(
-      cmd, [reply, send_reply_callback](auto redis_reply) {
-        const auto &results = redis_reply->ReadAsStringArray();
-        for (const auto &result : results) {
-          RAY_CHECK(result.has_value());
-          reply->add_results(*result);
-        }
-        GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
-      }));
+  const auto ns_prefix = MakeKey(request.namespace_(), "");
+  kv_->Keys(MakeKey(request.namespace_(), request.prefix()),
+            [reply, send_reply_callback, ns_prefix](std::vector<std::string> keys) {
+              for (auto &key : keys) {
+                reply->add_results(key.substr(ns_prefix.size()));
+              }
+              GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
+            });
 }
 
 }  // namespace gcs
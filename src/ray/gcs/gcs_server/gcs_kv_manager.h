@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #pragma once
+#include <map>
 #include <memory>
+
+#include "ray/common/asio/instrumented_io_context.h"
 #include "ray/gcs/redis_client.h"
 #include "ray/gcs/store_client/redis_store_client.h"
 #include "ray/rpc/gcs_server/gcs_rpc_server.h"
@@ -21,11 +24,120 @@
 namespace ray {
 namespace gcs {
 
+/// The storage of the internal KV. The methods and the callbacks are called on the
+/// event loop of the KV manager.
+class InternalKVInterface {
+ public:
+  virtual ~InternalKVInterface() = default;
+
+  /// Get the value of a key.
+  ///
+  /// \param key The key.
+  /// \param callback Called with the value, or none if the key doesn't exist.
+  virtual void Get(const std::string &key,
+                   std::function<void(boost::optional<std::string>)> callback) = 0;
+
+  /// Set the value of a key.
+  ///
+  /// \param key The key.
+  /// \param value The value.
+  /// \param overwrite Whether to overwrite the value if the key exists.
+  /// \param callback Called with whether the key was added, once the value is stored.
+  virtual void Put(const std::string &key, const std::string &value, bool overwrite,
+                   std::function<void(bool)> callback) = 0;
+
+  /// Delete a key.
+  ///
+  /// \param key The key.
+  /// \param callback Called with the number of deleted keys, once the key is deleted.
+  virtual void Del(const std::string &key, std::function<void(int)> callback) = 0;
+
+  /// Check whether a key exists.
+  ///
+  /// \param key The key.
+  /// \param callback Called with whether the key exists.
+  virtual void Exists(const std::string &key, std::function<void(bool)> callback) = 0;
+
+  /// Get the keys with a prefix.
+  ///
+  /// \param prefix The prefix.
+  /// \param callback Called with the keys that start with `prefix`.
+  virtual void Keys(const std::string &prefix,
+                    std::function<void(std::vector<std::string>)> callback) = 0;
+};
+
+/// An internal KV that stores each key as a Redis hash, and runs every operation on
+/// Redis.
+class RedisInternalKV : public InternalKVInterface {
+ public:
+  explicit RedisInternalKV(std::shared_ptr<RedisClient> redis_client)
+      : redis_client_(std::move(redis_client)) {}
+
+  void Get(const std::string &key,
+           std::function<void(boost::optional<std::string>)> callback) override;
+
+  void Put(const std::string &key, const std::string &value, bool overwrite,
+           std::function<void(bool)> callback) override;
+
+  void Del(const std::string &key, std::function<void(int)> callback) override;
+
+  void Exists(const std::string &key, std::function<void(bool)> callback) override;
+
+  void Keys(const std::string &prefix,
+            std::function<void(std::vector<std::string>)> callback) override;
+
+ private:
+  std::shared_ptr<RedisClient> redis_client_;
+};
+
+/// An internal KV that serves every operation from an ordered map in memory, and
+/// persists the writes through a store client. Reads never leave the process, and
+/// listing the keys with a prefix takes O(log(N) + matches).
+///
+/// The KV is loaded from the store client on construction. Operations that are called
+/// before the load finishes are queued until it does.
+class MemoryInternalKV : public InternalKVInterface {
+ public:
+  /// \param io_service The event loop of the KV manager.
+  /// \param store_client The store client that persists the KV.
+  MemoryInternalKV(instrumented_io_context &io_service,
+                   std::shared_ptr<StoreClient> store_client);
+
+  void Get(const std::string &key,
+           std::function<void(boost::optional<std::string>)> callback) override;
+
+  void Put(const std::string &key, const std::string &value, bool overwrite,
+           std::function<void(bool)> callback) override;
+
+  void Del(const std::string &key, std::function<void(int)> callback) override;
+
+  void Exists(const std::string &key, std::function<void(bool)> callback) override;
+
+  void Keys(const std::string &prefix,
+            std::function<void(std::vector<std::string>)> callback) override;
+
+ private:
+  /// Run an operation now if the KV is loaded, or after it's loaded otherwise.
+  void RunWhenLoaded(std::function<void()> operation);
+
+  /// Wrap a callback of a store client operation so that it runs on the event loop.
+  std::function<void(Status)> OnPersisted(std::function<void()> callback);
+
+  instrumented_io_context &io_service_;
+  std::shared_ptr<StoreClient> store_client_;
+  const std::string table_name_;
+  /// The KV, ordered by key so that the keys with a prefix are adjacent.
+  std::map<std::string, std::string> kv_;
+  bool loaded_ = false;
+  /// The operations that are waiting for the KV to be loaded.
+  std::vector<std::function<void()>> pending_operations_;
+};
+
 /// This implementation class of `InternalKVHandler`.
 class GcsInternalKVManager : public rpc::InternalKVHandler {
  public:
-  explicit GcsInternalKVManager(std::shared_ptr<RedisClient> redis_client)
-      : redis_client_(redis_client) {}
+  explicit GcsInternalKVManager(std::unique_ptr<InternalKVInterface> kv)
+      : kv_(std::move(kv)) {}
 
   void HandleInternalKVGet(const rpc::InternalKVGetRequest &request,
                            rpc::InternalKVGetReply *reply,
@@ -50,7 +162,11 @@ class GcsInternalKVManager : public rpc::InternalKVHandler {
                             rpc::SendReplyCallback send_reply_callback);
 
  private:
-  std::shared_ptr<RedisClient> redis_client_;
+  /// Get the key that stores a key of a namespace. Keys of the global namespace are
+  /// stored as is.
+  static std::string MakeKey(const std::string &ns, const std::string &key);
+
+  std::unique_ptr<InternalKVInterface> kv_;
 };
 
 }  // namespace gcs
@@ -15,6 +15,7 @@
 #include "ray/gcs/gcs_server/gcs_resource_manager.h"
 
 #include "ray/common/ray_config.h"
+#include "ray/common/resource_usage_delta.h"
 #include "ray/stats/stats.h"
 
 namespace ray {
@@ -179,7 +180,10 @@ void GcsResourceManager::HandleGetAllAvailableResources(
   ++counts_[CountType::GET_ALL_AVAILABLE_RESOURCES_REQUEST];
 }
 
-void GcsResourceManager::UpdateFromResourceReport(const rpc::ResourcesData &data) {
+bool GcsResourceManager::UpdateFromResourceReport(const rpc::ResourcesData &data) {
+  if (data.version() > 0) {
+    return UpdateFromVersionedResourceReport(data);
+  }
   NodeID node_id = NodeID::FromBinary(data.node_id());
   auto resources_data = std::make_shared<rpc::ResourcesData>();
   resources_data->CopyFrom(data);
@@ -203,6 +207,47 @@ void GcsResourceManager::UpdateFromResourceReport(const rpc::ResourcesData &data
     absl::MutexLock guard(&resource_buffer_mutex_);
     resources_buffer_[node_id] = *resources_data;
   }
+  return true;
+}
+
+bool GcsResourceManager::UpdateFromVersionedResourceReport(
+    const rpc::ResourcesData &data) {
+  NodeID node_id = NodeID::FromBinary(data.node_id());
+  auto iter = node_resource_usages_.find(node_id);
+  if (data.is_delta() && (iter == node_resource_usages_.end() ||
+                          iter->second.version() != data.base_version())) {
+    RAY_LOG(DEBUG) << "Dropping a resource report of node " << node_id
+                   << " on top of version " << data.base_version()
+                   << ", which the GCS doesn't have.";
+    return false;
+  }
+  if (iter == node_resource_usages_.end()) {
+    iter = node_resource_usages_.emplace(node_id, rpc::ResourcesData()).first;
+  }
+  auto &usage = iter->second;
+  const int64_t last_version = usage.version();
+  ApplyResourceUsageDelta(data, &usage);
+  if (usage.version() == last_version) {
+    return true;
+  }
+
+  if (RayConfig::instance().gcs_actor_scheduling_enabled()) {
+    UpdateNodeNormalTaskResources(node_id, usage);
+  } else if (!data.is_delta() || usage.resources_available_changed()) {
+    SetAvailableResources(node_id,
+                          ResourceSet(MapFromProtobuf(usage.resources_available())));
+  }
+
+  // Forward every version, so that the receivers can tell when they missed one. Deltas
+  // that haven't been broadcast yet are merged.
+  absl::MutexLock guard(&resource_buffer_mutex_);
+  auto buffered = resources_buffer_.find(node_id);
+  if (buffered == resources_buffer_.end()) {
+    resources_buffer_.emplace(node_id, data);
+  } else {
+    ApplyResourceUsageDelta(data, &buffered->second);
+  }
+  return true;
 }
 
 void GcsResourceManager::HandleReportResourceUsage(
@@ -312,6 +357,11 @@ const absl::flat_hash_map<NodeID, SchedulingResources>
   return cluster_scheduling_resources_;
 }
 
+const absl::flat_hash_map<NodeID, std::string>
+    &GcsResourceManager::GetNodeTopologyPaths() const {
+  return node_topology_paths_;
+}
+
 void GcsResourceManager::SetAvailableResources(const NodeID &node_id,
                                                const ResourceSet &resources) {
   cluster_scheduling_resources_[node_id].SetAvailableResources(ResourceSet(resources));
@@ -351,6 +401,9 @@ void GcsResourceManager::OnNodeAdd(const rpc::GcsNodeInfo &node) {
     ResourceSet node_resources(resource_mapping);
     cluster_scheduling_resources_.emplace(node_id, SchedulingResources(node_resources));
   }
+  if (!node.topology_path().empty()) {
+    node_topology_paths_[node_id] = node.topology_path();
+  }
 }
 
 void GcsResourceManager::OnNodeDead(const NodeID &node_id) {
@@ -360,6 +413,7 @@ void GcsResourceManager::OnNodeDead(const NodeID &node_id) {
   }
   node_resource_usages_.erase(node_id);
   cluster_scheduling_resources_.erase(node_id);
+  node_topology_paths_.erase(node_id);
   latest_resources_normal_task_timestamp_.erase(node_id);
 }
 
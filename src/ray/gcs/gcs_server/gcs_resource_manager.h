@@ -84,6 +84,11 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
   /// \return The resources of all nodes in the cluster.
   const absl::flat_hash_map<NodeID, SchedulingResources> &GetClusterResources() const;
 
+  /// Get the topology paths of the nodes in the cluster, e.g., "us-west-2a/rack-17".
+  ///
+  /// \return The topology path of each node that has one.
+  const absl::flat_hash_map<NodeID, std::string> &GetNodeTopologyPaths() const;
+
   /// Handle a node registration.
   ///
   /// \param node The specified node to add.
@@ -150,7 +155,10 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
 
   /// Process a new resource report from a node, independent of the rpc handler it came
   /// from.
-  void UpdateFromResourceReport(const rpc::ResourcesData &data);
+  ///
+  /// \return False if the report is a delta on top of a version of the node's report
+  /// that the GCS doesn't have, in which case it is dropped.
+  bool UpdateFromResourceReport(const rpc::ResourcesData &data);
 
   /// Update the placement group load information so that it will be reported through
   /// heartbeat.
@@ -177,6 +185,11 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
   /// Send any buffered resource usage as a single publish.
   void SendBatchedResourceUsage();
 
+  /// Process a resource report that has a version, see
+  /// `resource_report_delta_encoding`. The report is merged into the newest resource
+  /// usage of the node, and into the delta that will be broadcast next.
+  bool UpdateFromVersionedResourceReport(const rpc::ResourcesData &data);
+
   /// Prelocked version of GetResourceUsageBatchForBroadcast. This is necessary for need
   /// the functionality as part of a larger transaction.
   void GetResourceUsageBatchForBroadcast_Locked(rpc::ResourceUsageBatchData &buffer)
@@ -205,6 +218,8 @@ class GcsResourceManager : public rpc::NodeResourceInfoHandler {
   const bool redis_broadcast_enabled_;
   /// Map from node id to the scheduling resources of the node.
   absl::flat_hash_map<NodeID, SchedulingResources> cluster_scheduling_resources_;
+  /// Map from node id to the topology path of the node, for nodes that have one.
+  absl::flat_hash_map<NodeID, std::string> node_topology_paths_;
   /// Placement group load information that is used for autoscaler.
   absl::optional<std::shared_ptr<rpc::PlacementGroupLoad>> placement_group_load_;
   /// Normal task resources could be uploaded by 1) Raylets' periodical reporters; 2)
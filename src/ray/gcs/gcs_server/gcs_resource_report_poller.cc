@@ -19,10 +19,10 @@ namespace gcs {
 
 GcsResourceReportPoller::GcsResourceReportPoller(
     std::shared_ptr<rpc::NodeManagerClientPool> raylet_client_pool,
-    std::function<void(const rpc::ResourcesData &)> handle_resource_report,
+    std::function<bool(const rpc::ResourcesData &)> handle_resource_report,
     std::function<int64_t(void)> get_current_time_milli,
     std::function<void(
-        const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &,
+        const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &, int64_t,
         std::function<void(const Status &, const rpc::RequestResourceReportReply &)>)>
         request_report)
     : ticker_(polling_service_),
@@ -127,25 +127,31 @@ void GcsResourceReportPoller::PullResourceReport(const std::shared_ptr<PullState
   inflight_pulls_++;
 
   request_report_(
-      state->address, raylet_client_pool_,
+      state->address, raylet_client_pool_, state->last_applied_version,
       [this, state](const Status &status, const rpc::RequestResourceReportReply &reply) {
+        int64_t applied_version = 0;
         if (status.ok()) {
           // TODO (Alex): This callback is always posted onto the main thread. Since most
           // of the work is in the callback we should move this callback's execution to
           // the polling thread. We will need to implement locking once we switch threads.
-          handle_resource_report_(reply.resources());
+          if (handle_resource_report_(reply.resources())) {
+            applied_version = reply.resources().version();
+          }
         } else {
           RAY_LOG(INFO) << "Couldn't get resource request from raylet " << state->node_id
                         << ": " << status.ToString();
         }
-        polling_service_.post([this, state]() { NodeResourceReportReceived(state); });
+        polling_service_.post([this, state, applied_version]() {
+          NodeResourceReportReceived(state, applied_version);
+        });
       });
 }
 
 void GcsResourceReportPoller::NodeResourceReportReceived(
-    const std::shared_ptr<PullState> state) {
+    const std::shared_ptr<PullState> state, int64_t applied_version) {
   absl::MutexLock guard(&mutex_);
   inflight_pulls_--;
+  state->last_applied_version = applied_version;
 
   // Schedule the next pull. The scheduling `TryPullResourceReport` loop will handle
   // validating that this node is still in the cluster.
@@ -48,21 +48,22 @@ class GcsResourceReportPoller {
  public:
   GcsResourceReportPoller(
       std::shared_ptr<rpc::NodeManagerClientPool> raylet_client_pool,
-      std::function<void(const rpc::ResourcesData &)> handle_resource_report,
+      std::function<bool(const rpc::ResourcesData &)> handle_resource_report,
       /* Default values should only be changed for testing. */
       std::function<int64_t(void)> get_current_time_milli =
           []() { return absl::GetCurrentTimeNanos() / (1000 * 1000); },
       std::function<void(
-          const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &,
+          const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &, int64_t,
           std::function<void(const Status &, const rpc::RequestResourceReportReply &)>)>
           request_report =
               [](const rpc::Address &address,
                  std::shared_ptr<rpc::NodeManagerClientPool> &raylet_client_pool,
+                 int64_t last_applied_version,
                  std::function<void(const Status &,
                                     const rpc::RequestResourceReportReply &)>
                      callback) {
                 auto raylet_client = raylet_client_pool->GetOrConnectByAddress(address);
-                raylet_client->RequestResourceReport(callback);
+                raylet_client->RequestResourceReport(last_applied_version, callback);
               });
 
   ~GcsResourceReportPoller();
@@ -95,16 +96,17 @@ class GcsResourceReportPoller {
   uint64_t inflight_pulls_;
   // The shared, thread safe pool of raylet clients, which we use to minimize connections.
   std::shared_ptr<rpc::NodeManagerClientPool> raylet_client_pool_;
-  // Handle receiving a resource report (e.g. update the resource manager).
+  // Handle receiving a resource report (e.g. update the resource manager). Returns
+  // false if the report was dropped.
   // This function is guaranteed to be called on the main thread. It is not necessarily
   // safe to call it from the polling thread.
-  std::function<void(const rpc::ResourcesData &)> handle_resource_report_;
+  std::function<bool(const rpc::ResourcesData &)> handle_resource_report_;
 
   // Return the current time in miliseconds
   std::function<int64_t(void)> get_current_time_milli_;
   // Send the `RequestResourceReport` RPC.
   std::function<void(
-      const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &,
+      const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &, int64_t,
       std::function<void(const Status &, const rpc::RequestResourceReportReply &)>)>
       request_report_;
   // The minimum delay between two pull requests to the same thread.
@@ -115,6 +117,9 @@ class GcsResourceReportPoller {
     rpc::Address address;
     int64_t last_pull_time;
     int64_t next_pull_time;
+    // The version of the last report of the node that was applied, so that the raylet
+    // can reply with a delta on top of it. 0 if none.
+    int64_t last_applied_version = 0;
 
     PullState(NodeID _node_id, rpc::Address _address, int64_t _last_pull_time,
               int64_t _next_pull_time)
@@ -143,8 +148,11 @@ class GcsResourceReportPoller {
   void PullResourceReport(const std::shared_ptr<PullState> state);
   /// A resource report was successfully pulled (and the resource manager was already
   /// updated). This method is thread safe.
-  void NodeResourceReportReceived(const std::shared_ptr<PullState> state)
-      LOCKS_EXCLUDED(mutex_);
+  ///
+  /// \param applied_version The version of the report that was applied, or 0 if the
+  /// report wasn't applied and the next one should be a full report.
+  void NodeResourceReportReceived(const std::shared_ptr<PullState> state,
+                                  int64_t applied_version) LOCKS_EXCLUDED(mutex_);
 
   friend class GcsResourceReportPollerTest;
 };
@@ -14,9 +14,80 @@
 
 #include "ray/gcs/gcs_server/gcs_resource_scheduler.h"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
+
+#include "ray/common/ray_config.h"
+#include "ray/raylet/scheduling/cluster_resource_data.h"
+
 namespace ray {
 namespace gcs {
 
+namespace {
+
+/// The maximum number of nodes that the bounded search tries for each resource.
+constexpr size_t kMaxSearchBranches = 4;
+
+/// Ranks topology paths by how far away they are from the closest of the nodes selected
+/// so far, so that resources spread across zones and racks before they share them.
+class TopologySpreadRanker {
+ public:
+  /// Rank a topology path, the farther away from the selected nodes the lower.
+  int Rank(const std::string &topology_path) {
+    auto it = min_distances_.find(topology_path);
+    if (it == min_distances_.end()) {
+      int min_distance = std::numeric_limits<int>::max();
+      for (const auto &selected_path : selected_paths_) {
+        min_distance =
+            std::min(min_distance, TopologyDistance(selected_path, topology_path));
+      }
+      it = min_distances_.emplace(topology_path, min_distance).first;
+    }
+    return -it->second;
+  }
+
+  /// Add the topology path of a selected node.
+  void AddSelected(const std::string &topology_path) {
+    if (!selected_paths_.insert(topology_path).second) {
+      return;
+    }
+    for (auto &entry : min_distances_) {
+      entry.second = std::min(entry.second, TopologyDistance(topology_path, entry.first));
+    }
+  }
+
+ private:
+  /// The distinct topology paths of the selected nodes.
+  absl::flat_hash_set<std::string> selected_paths_;
+  /// The distance of each ranked topology path to the closest selected path.
+  absl::flat_hash_map<std::string, int> min_distances_;
+};
+
+/// Get the available resources of a node that are not used by normal tasks.
+ResourceSet GetActualAvailableResources(const SchedulingResources &node_resources) {
+  ResourceSet available_resources = node_resources.GetAvailableResources();
+  if (!node_resources.GetNormalTaskResources().IsEmpty()) {
+    available_resources.SubtractResources(node_resources.GetNormalTaskResources());
+  }
+  return available_resources;
+}
+
+}  // namespace
+
+PackingAlgorithm ParsePackingAlgorithm(const std::string &name) {
+  if (name == "best_fit_decreasing") {
+    return PackingAlgorithm::BEST_FIT_DECREASING;
+  } else if (name == "bounded_search") {
+    return PackingAlgorithm::BOUNDED_SEARCH;
+  }
+  if (name != "greedy") {
+    RAY_LOG(WARNING) << "Unknown packing algorithm " << name << ", fall back to greedy.";
+  }
+  return PackingAlgorithm::GREEDY;
+}
+
 double LeastResourceScorer::Score(const ResourceSet &required_resources,
                                   const SchedulingResources &node_resources) {
   // In GCS-based actor scheduling, the `resources_available_` (of class
@@ -64,8 +135,53 @@ double LeastResourceScorer::Calculate(const FixedPoint &requested,
   return (available - requested).Double() / available.Double();
 }
 
+double BestFitScorer::Score(const ResourceSet &required_resources,
+                           const SchedulingResources &node_resources) {
+  // See `LeastResourceScorer::Score` for why the resources of normal tasks are
+  // subtracted.
+  const auto available_resources = GetActualAvailableResources(node_resources);
+  if (!required_resources.IsSubset(available_resources)) {
+    return -1;
+  }
+
+  // Average the fraction of each resource of the node that is left after the
+  // allocation, the less the better.
+  double left_fraction = 0.0;
+  int num_resources = 0;
+  for (const auto &entry : node_resources.GetTotalResources().GetResourceAmountMap()) {
+    if (entry.second <= 0) {
+      continue;
+    }
+    auto left = available_resources.GetResource(entry.first) -
+                required_resources.GetResource(entry.first);
+    left_fraction += std::max(left.Double(), 0.0) / entry.second.Double();
+    num_resources++;
+  }
+  return num_resources == 0 ? 1.0 : 1.0 - left_fraction / num_resources;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
+GcsResourceScheduler::GcsResourceScheduler(GcsResourceManager &gcs_resource_manager)
+    : gcs_resource_manager_(gcs_resource_manager),
+      node_scorer_(new LeastResourceScorer()),
+      best_fit_scorer_(new BestFitScorer()) {
+  std::fill(std::begin(packing_algorithms_), std::end(packing_algorithms_),
+            PackingAlgorithm::GREEDY);
+  packing_algorithms_[SchedulingType::PACK] =
+      ParsePackingAlgorithm(RayConfig::instance().gcs_pack_placement_algorithm());
+  packing_algorithms_[SchedulingType::SPREAD] =
+      ParsePackingAlgorithm(RayConfig::instance().gcs_spread_placement_algorithm());
+}
+
+void GcsResourceScheduler::SetPackingAlgorithm(const SchedulingType &scheduling_type,
+                                               PackingAlgorithm packing_algorithm) {
+  RAY_CHECK(scheduling_type == SchedulingType::PACK ||
+            scheduling_type == SchedulingType::SPREAD)
+      << "Packing algorithms only apply to PACK and SPREAD, got " << scheduling_type;
+  packing_algorithms_[scheduling_type] = packing_algorithm;
+}
+
 SchedulingResult GcsResourceScheduler::Schedule(
     const std::vector<ResourceSet> &required_resources_list,
     const SchedulingType &scheduling_type,
@@ -86,15 +202,21 @@ SchedulingResult GcsResourceScheduler::Schedule(
 
   // Score and rank nodes.
   SchedulingResult result;
+  auto packing_algorithm = packing_algorithms_[scheduling_type];
+  if ((scheduling_type == SPREAD || scheduling_type == PACK) &&
+      packing_algorithm == PackingAlgorithm::BOUNDED_SEARCH) {
+    return BoundedSearchSchedule(to_schedule_resources, candidate_nodes,
+                                 scheduling_type);
+  }
   switch (scheduling_type) {
   case SPREAD:
-    result = SpreadSchedule(to_schedule_resources, candidate_nodes);
+    result = SpreadSchedule(to_schedule_resources, candidate_nodes, packing_algorithm);
     break;
   case STRICT_SPREAD:
     result = StrictSpreadSchedule(to_schedule_resources, candidate_nodes);
     break;
   case PACK:
-    result = PackSchedule(to_schedule_resources, candidate_nodes);
+    result = PackSchedule(to_schedule_resources, candidate_nodes, packing_algorithm);
     break;
   case STRICT_PACK:
     result = StrictPackSchedule(to_schedule_resources, candidate_nodes);
@@ -128,6 +250,45 @@ const std::vector<ResourceSet> &GcsResourceScheduler::SortRequiredResources(
   return required_resources;
 }
 
+std::vector<int> GcsResourceScheduler::GetPlacementOrder(
+    const std::vector<ResourceSet> &required_resources_list,
+    const absl::flat_hash_set<NodeID> &candidate_nodes,
+    PackingAlgorithm packing_algorithm) {
+  std::vector<int> order(required_resources_list.size());
+  for (size_t index = 0; index < order.size(); index++) {
+    order[index] = index;
+  }
+  if (packing_algorithm == PackingAlgorithm::GREEDY) {
+    return order;
+  }
+
+  // The size of a resource set is the sum of its resources, each relative to the
+  // largest node, so that scarce resources (such as GPU) count more than abundant ones.
+  absl::flat_hash_map<std::string, double> max_node_resources;
+  const auto &cluster_resources = gcs_resource_manager_.GetClusterResources();
+  for (const auto &node_id : candidate_nodes) {
+    const auto &iter = cluster_resources.find(node_id);
+    RAY_CHECK(iter != cluster_resources.end());
+    for (const auto &entry : iter->second.GetTotalResources().GetResourceAmountMap()) {
+      auto &max_amount = max_node_resources[entry.first];
+      max_amount = std::max(max_amount, entry.second.Double());
+    }
+  }
+  std::vector<double> sizes(required_resources_list.size());
+  for (size_t index = 0; index < sizes.size(); index++) {
+    for (const auto &entry : required_resources_list[index].GetResourceAmountMap()) {
+      auto it = max_node_resources.find(entry.first);
+      // Resources that no node has are infeasible anyway, so try them first.
+      sizes[index] += it == max_node_resources.end() || it->second <= 0
+                          ? 1.0
+                          : entry.second.Double() / it->second;
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&sizes](int a, int b) { return sizes[a] > sizes[b]; });
+  return order;
+}
+
 SchedulingResult GcsResourceScheduler::StrictSpreadSchedule(
     const std::vector<ResourceSet> &required_resources_list,
     const absl::flat_hash_set<NodeID> &candidate_nodes) {
@@ -141,13 +302,18 @@ SchedulingResult GcsResourceScheduler::StrictSpreadSchedule(
 
   std::vector<NodeID> result_nodes;
   absl::flat_hash_set<NodeID> candidate_nodes_copy(candidate_nodes);
+  TopologySpreadRanker spread_ranker;
+  auto spread_rank = [&spread_ranker](const std::string &topology_path) {
+    return spread_ranker.Rank(topology_path);
+  };
   for (const auto &iter : required_resources_list) {
     // Score and sort nodes.
-    auto best_node = GetBestNode(iter, candidate_nodes_copy);
+    auto best_node = GetBestNodeByTopologyRank(iter, candidate_nodes_copy, spread_rank);
 
     // There are nodes to meet the scheduling requirements.
     if (best_node) {
       candidate_nodes_copy.erase(*best_node);
+      spread_ranker.AddSelected(GetTopologyPath(*best_node));
       result_nodes.emplace_back(std::move(*best_node));
     } else {
       // There is no node to meet the scheduling requirements.
@@ -164,36 +330,52 @@ SchedulingResult GcsResourceScheduler::StrictSpreadSchedule(
 
 SchedulingResult GcsResourceScheduler::SpreadSchedule(
     const std::vector<ResourceSet> &required_resources_list,
-    const absl::flat_hash_set<NodeID> &candidate_nodes) {
+    const absl::flat_hash_set<NodeID> &candidate_nodes,
+    PackingAlgorithm packing_algorithm) {
   std::vector<NodeID> result_nodes;
+  result_nodes.resize(required_resources_list.size());
+  size_t num_scheduled = 0;
   absl::flat_hash_set<NodeID> candidate_nodes_copy(candidate_nodes);
   absl::flat_hash_set<NodeID> selected_nodes;
-  for (const auto &iter : required_resources_list) {
+  TopologySpreadRanker spread_ranker;
+  auto spread_rank = [&spread_ranker](const std::string &topology_path) {
+    return spread_ranker.Rank(topology_path);
+  };
+  // Best fit keeps the large nodes for the large resources, which are placed first.
+  NodeScorer *node_scorer = packing_algorithm == PackingAlgorithm::GREEDY
+                                ? node_scorer_.get()
+                                : best_fit_scorer_.get();
+  for (int index :
+       GetPlacementOrder(required_resources_list, candidate_nodes, packing_algorithm)) {
+    const auto &iter = required_resources_list[index];
     // Score and sort nodes.
-    auto best_node = GetBestNode(iter, candidate_nodes_copy);
+    auto best_node =
+        GetBestNodeByTopologyRank(iter, candidate_nodes_copy, spread_rank, node_scorer);
 
     // There are nodes to meet the scheduling requirements.
     if (best_node) {
-      result_nodes.emplace_back(std::move(*best_node));
-      RAY_CHECK(gcs_resource_manager_.AcquireResources(result_nodes.back(), iter));
-      candidate_nodes_copy.erase(result_nodes.back());
-      selected_nodes.insert(result_nodes.back());
+      result_nodes[index] = *best_node;
+      RAY_CHECK(gcs_resource_manager_.AcquireResources(*best_node, iter));
+      candidate_nodes_copy.erase(*best_node);
+      selected_nodes.insert(*best_node);
+      spread_ranker.AddSelected(GetTopologyPath(*best_node));
     } else {
       // Scheduling from selected nodes.
-      auto best_node = GetBestNode(iter, selected_nodes);
+      auto best_node = GetBestNode(iter, selected_nodes, node_scorer);
       if (best_node) {
-        result_nodes.push_back(std::move(*best_node));
-        RAY_CHECK(gcs_resource_manager_.AcquireResources(result_nodes.back(), iter));
+        result_nodes[index] = *best_node;
+        RAY_CHECK(gcs_resource_manager_.AcquireResources(*best_node, iter));
       } else {
         break;
       }
     }
+    num_scheduled++;
   }
 
   // Releasing the resources temporarily deducted from `gcs_resource_manager_`.
   ReleaseTemporarilyDeductedResources(required_resources_list, result_nodes);
 
-  if (result_nodes.size() != required_resources_list.size()) {
+  if (num_scheduled != required_resources_list.size()) {
     // Can't meet the scheduling requirements temporarily.
     return std::make_pair(SchedulingResultStatus::FAILED, std::vector<NodeID>());
   }
@@ -245,27 +427,61 @@ SchedulingResult GcsResourceScheduler::StrictPackSchedule(
 
 SchedulingResult GcsResourceScheduler::PackSchedule(
     const std::vector<ResourceSet> &required_resources_list,
-    const absl::flat_hash_set<NodeID> &candidate_nodes) {
+    const absl::flat_hash_set<NodeID> &candidate_nodes,
+    PackingAlgorithm packing_algorithm) {
   std::vector<NodeID> result_nodes;
   result_nodes.resize(required_resources_list.size());
   absl::flat_hash_set<NodeID> candidate_nodes_copy(candidate_nodes);
   std::list<std::pair<int, ResourceSet>> required_resources_list_copy;
-  int index = 0;
-  for (const auto &iter : required_resources_list) {
-    required_resources_list_copy.emplace_back(index++, iter);
+  ResourceSet total_required_resources;
+  for (int index :
+       GetPlacementOrder(required_resources_list, candidate_nodes, packing_algorithm)) {
+    required_resources_list_copy.emplace_back(index, required_resources_list[index]);
+    total_required_resources.AddResources(required_resources_list[index]);
+  }
+
+  // Pack the resources into the topology group (e.g., the rack) that can host all of
+  // them, and then into the groups closest to it.
+  std::optional<std::string> anchor_topology_path;
+  if (IsTopologyAware()) {
+    anchor_topology_path =
+        GetBestTopologyGroup(total_required_resources, candidate_nodes);
   }
+  auto pack_rank = [&anchor_topology_path](const std::string &topology_path) {
+    return anchor_topology_path ? TopologyDistance(*anchor_topology_path, topology_path)
+                                : 0;
+  };
 
   while (!required_resources_list_copy.empty()) {
     const auto &required_resources_index = required_resources_list_copy.front().first;
     const auto &required_resources = required_resources_list_copy.front().second;
-    auto best_node = GetBestNode(required_resources, candidate_nodes_copy);
+    std::optional<NodeID> best_node;
+    if (packing_algorithm == PackingAlgorithm::GREEDY) {
+      best_node =
+          GetBestNodeByTopologyRank(required_resources, candidate_nodes_copy, pack_rank);
+    } else {
+      // Open the node that fits all the remaining resources most tightly, or else the
+      // one that fits the largest remaining resource most tightly.
+      best_node = GetBestNodeByTopologyRank(total_required_resources,
+                                            candidate_nodes_copy, pack_rank,
+                                            best_fit_scorer_.get());
+      if (!best_node) {
+        best_node = GetBestNodeByTopologyRank(required_resources, candidate_nodes_copy,
+                                              pack_rank, best_fit_scorer_.get());
+      }
+    }
     if (!best_node) {
       // There is no node to meet the scheduling requirements.
       break;
     }
+    if (!anchor_topology_path && IsTopologyAware()) {
+      // No group can host all the resources, so stay close to the first node instead.
+      anchor_topology_path = GetTopologyPath(*best_node);
+    }
 
     RAY_CHECK(gcs_resource_manager_.AcquireResources(*best_node, required_resources));
     result_nodes[required_resources_index] = *best_node;
+    total_required_resources.SubtractResources(required_resources);
     required_resources_list_copy.pop_front();
 
     // We try to schedule more resources on one node.
@@ -273,6 +489,7 @@ SchedulingResult GcsResourceScheduler::PackSchedule(
          iter != required_resources_list_copy.end();) {
       if (gcs_resource_manager_.AcquireResources(*best_node, iter->second)) {
         result_nodes[iter->first] = *best_node;
+        total_required_resources.SubtractResources(iter->second);
         required_resources_list_copy.erase(iter++);
       } else {
         ++iter;
@@ -291,9 +508,110 @@ SchedulingResult GcsResourceScheduler::PackSchedule(
   return std::make_pair(SchedulingResultStatus::SUCCESS, result_nodes);
 }
 
+SchedulingResult GcsResourceScheduler::BoundedSearchSchedule(
+    const std::vector<ResourceSet> &required_resources_list,
+    const absl::flat_hash_set<NodeID> &candidate_nodes,
+    const SchedulingType &scheduling_type) {
+  PlacementSearchState state;
+  state.pack = scheduling_type == SchedulingType::PACK;
+  state.order = GetPlacementOrder(required_resources_list, candidate_nodes,
+                                  PackingAlgorithm::BEST_FIT_DECREASING);
+  state.placement.resize(required_resources_list.size());
+  state.remaining_steps = RayConfig::instance().gcs_placement_search_max_steps();
+
+  // The best fit decreasing placement is the one to beat.
+  auto result = state.pack
+                    ? PackSchedule(required_resources_list, candidate_nodes,
+                                   PackingAlgorithm::BEST_FIT_DECREASING)
+                    : SpreadSchedule(required_resources_list, candidate_nodes,
+                                     PackingAlgorithm::BEST_FIT_DECREASING);
+  if (result.first == SchedulingResultStatus::SUCCESS) {
+    absl::flat_hash_set<NodeID> nodes(result.second.begin(), result.second.end());
+    state.best_placement = std::move(result.second);
+    state.best_num_nodes = nodes.size();
+  }
+
+  SearchPlacement(required_resources_list, candidate_nodes, 0, &state);
+
+  if (state.best_placement.empty()) {
+    // Can't meet the scheduling requirements temporarily.
+    return std::make_pair(SchedulingResultStatus::FAILED, std::vector<NodeID>());
+  }
+  return std::make_pair(SchedulingResultStatus::SUCCESS,
+                        std::move(state.best_placement));
+}
+
+void GcsResourceScheduler::SearchPlacement(
+    const std::vector<ResourceSet> &required_resources_list,
+    const absl::flat_hash_set<NodeID> &candidate_nodes, size_t depth,
+    PlacementSearchState *state) {
+  // Stop at the partial placements that can't beat the best placement found so far.
+  const size_t num_nodes = state->node_usage.size();
+  if (!state->best_placement.empty()) {
+    if (state->pack && num_nodes >= state->best_num_nodes) {
+      return;
+    }
+    const size_t max_num_nodes =
+        std::min(num_nodes + state->order.size() - depth, candidate_nodes.size());
+    if (!state->pack && max_num_nodes <= state->best_num_nodes) {
+      return;
+    }
+  }
+  if (depth == state->order.size()) {
+    state->best_placement = state->placement;
+    state->best_num_nodes = num_nodes;
+    return;
+  }
+
+  const int index = state->order[depth];
+  const auto &required_resources = required_resources_list[index];
+  const auto &cluster_resources = gcs_resource_manager_.GetClusterResources();
+  // Try the nodes that keep the number of nodes low (`PACK`) or high (`SPREAD`)
+  // first, and among them the ones that the resources fit most tightly.
+  std::vector<std::tuple<bool, double, NodeID>> branches;
+  for (const auto &node_id : candidate_nodes) {
+    const auto &iter = cluster_resources.find(node_id);
+    RAY_CHECK(iter != cluster_resources.end());
+    double node_score = best_fit_scorer_->Score(required_resources, iter->second);
+    if (node_score >= 0) {
+      bool preferred = state->node_usage.contains(node_id) == state->pack;
+      branches.emplace_back(preferred, node_score, node_id);
+    }
+  }
+  std::sort(branches.begin(), branches.end(), [](const auto &a, const auto &b) {
+    return std::tie(std::get<0>(a), std::get<1>(a)) >
+           std::tie(std::get<0>(b), std::get<1>(b));
+  });
+  if (branches.size() > kMaxSearchBranches) {
+    branches.resize(kMaxSearchBranches);
+  }
+
+  for (const auto &branch : branches) {
+    if (state->remaining_steps == 0) {
+      return;
+    }
+    state->remaining_steps--;
+    const auto &node_id = std::get<2>(branch);
+    RAY_CHECK(gcs_resource_manager_.AcquireResources(node_id, required_resources));
+    state->node_usage[node_id]++;
+    state->placement[index] = node_id;
+
+    SearchPlacement(required_resources_list, candidate_nodes, depth + 1, state);
+
+    state->placement[index] = NodeID::Nil();
+    if (--state->node_usage[node_id] == 0) {
+      state->node_usage.erase(node_id);
+    }
+    RAY_CHECK(gcs_resource_manager_.ReleaseResources(node_id, required_resources));
+  }
+}
+
 std::optional<NodeID> GcsResourceScheduler::GetBestNode(
     const ResourceSet &required_resources,
-    const absl::flat_hash_set<NodeID> &candidate_nodes) {
+    const absl::flat_hash_set<NodeID> &candidate_nodes, NodeScorer *node_scorer) {
+  if (node_scorer == nullptr) {
+    node_scorer = node_scorer_.get();
+  }
   double best_node_score = -1;
   const NodeID *best_node_id = nullptr;
   const auto &cluster_resources = gcs_resource_manager_.GetClusterResources();
@@ -302,7 +620,7 @@ std::optional<NodeID> GcsResourceScheduler::GetBestNode(
   for (const auto &node_id : candidate_nodes) {
     const auto &iter = cluster_resources.find(node_id);
     RAY_CHECK(iter != cluster_resources.end());
-    double node_score = node_scorer_->Score(required_resources, iter->second);
+    double node_score = node_scorer->Score(required_resources, iter->second);
     if (best_node_id == nullptr || best_node_score < node_score) {
       best_node_id = &node_id;
       best_node_score = node_score;
@@ -315,6 +633,83 @@ std::optional<NodeID> GcsResourceScheduler::GetBestNode(
   }
 }
 
+std::optional<NodeID> GcsResourceScheduler::GetBestNodeByTopologyRank(
+    const ResourceSet &required_resources,
+    const absl::flat_hash_set<NodeID> &candidate_nodes,
+    const std::function<int(const std::string &)> &rank_func, NodeScorer *node_scorer) {
+  if (!IsTopologyAware()) {
+    return GetBestNode(required_resources, candidate_nodes, node_scorer);
+  }
+  // Rank each distinct topology path only once.
+  absl::flat_hash_map<std::string, int> topology_path_ranks;
+  std::map<int, absl::flat_hash_set<NodeID>> ranked_nodes;
+  for (const auto &node_id : candidate_nodes) {
+    const auto &topology_path = GetTopologyPath(node_id);
+    auto it = topology_path_ranks.find(topology_path);
+    if (it == topology_path_ranks.end()) {
+      it = topology_path_ranks.emplace(topology_path, rank_func(topology_path)).first;
+    }
+    ranked_nodes[it->second].insert(node_id);
+  }
+  for (const auto &entry : ranked_nodes) {
+    auto best_node = GetBestNode(required_resources, entry.second, node_scorer);
+    if (best_node) {
+      return best_node;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> GcsResourceScheduler::GetBestTopologyGroup(
+    const ResourceSet &required_resources,
+    const absl::flat_hash_set<NodeID> &candidate_nodes) {
+  struct TopologyGroup {
+    ResourceSet total;
+    ResourceSet available;
+    ResourceSet normal_task_resources;
+  };
+  absl::flat_hash_map<std::string, TopologyGroup> groups;
+  const auto &cluster_resources = gcs_resource_manager_.GetClusterResources();
+  for (const auto &node_id : candidate_nodes) {
+    const auto &iter = cluster_resources.find(node_id);
+    RAY_CHECK(iter != cluster_resources.end());
+    auto &group = groups[GetTopologyPath(node_id)];
+    group.total.AddResources(iter->second.GetTotalResources());
+    group.available.AddResources(iter->second.GetAvailableResources());
+    group.normal_task_resources.AddResources(iter->second.GetNormalTaskResources());
+  }
+
+  double best_group_score = -1;
+  const std::string *best_topology_path = nullptr;
+  for (auto &entry : groups) {
+    SchedulingResources group_resources(entry.second.total);
+    group_resources.SetAvailableResources(std::move(entry.second.available));
+    group_resources.SetNormalTaskResources(entry.second.normal_task_resources);
+    double group_score = node_scorer_->Score(required_resources, group_resources);
+    if (group_score >= 0 &&
+        (best_topology_path == nullptr || best_group_score < group_score)) {
+      best_topology_path = &entry.first;
+      best_group_score = group_score;
+    }
+  }
+  if (best_topology_path) {
+    return *best_topology_path;
+  }
+  return std::nullopt;
+}
+
+bool GcsResourceScheduler::IsTopologyAware() const {
+  return RayConfig::instance().scheduler_topology_aware() &&
+         !gcs_resource_manager_.GetNodeTopologyPaths().empty();
+}
+
+const std::string &GcsResourceScheduler::GetTopologyPath(const NodeID &node_id) const {
+  static const std::string kNoTopologyPath;
+  const auto &node_topology_paths = gcs_resource_manager_.GetNodeTopologyPaths();
+  auto it = node_topology_paths.find(node_id);
+  return it == node_topology_paths.end() ? kNoTopologyPath : it->second;
+}
+
 void GcsResourceScheduler::ReleaseTemporarilyDeductedResources(
     const std::vector<ResourceSet> &required_resources_list,
     const std::vector<NodeID> &nodes) {
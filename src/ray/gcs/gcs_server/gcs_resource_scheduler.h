@@ -15,6 +15,7 @@
 #pragma once
 #include <optional>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "ray/common/task/scheduling_resources.h"
 #include "ray/gcs/gcs_server/gcs_resource_manager.h"
@@ -36,6 +37,26 @@ enum SchedulingType {
   SchedulingType_MAX = 4,
 };
 
+// Algorithm that places the resources of a `PACK` or `SPREAD` scheduling request.
+enum PackingAlgorithm {
+  // Places the resources one by one in the given order, each on the node with the most
+  // resources left.
+  GREEDY = 0,
+  // Places the largest resources first, each on the node that it fits most tightly,
+  // which leaves fewer fragments of free resources behind.
+  BEST_FIT_DECREASING = 1,
+  // Starts from the best fit decreasing placement and searches a bounded number of
+  // alternative placements for one that uses fewer (`PACK`) or more (`SPREAD`) nodes,
+  // or for any placement if best fit decreasing fails.
+  BOUNDED_SEARCH = 2,
+};
+
+/// Parse a packing algorithm from its name in the config, e.g., "best_fit_decreasing".
+///
+/// \param name The name of the packing algorithm.
+/// \return The packing algorithm, or `GREEDY` if the name is unknown.
+PackingAlgorithm ParsePackingAlgorithm(const std::string &name);
+
 // Status of resource scheduling result.
 enum SchedulingResultStatus {
   // Scheduling failed but retryable.
@@ -81,13 +102,21 @@ class LeastResourceScorer : public NodeScorer {
   double Calculate(const FixedPoint &requested, const FixedPoint &available);
 };
 
+/// BestFitScorer is a score plugin that favors the nodes that have the fewest
+/// resources left after the allocation, across all the resources of the node. Nodes
+/// with resources that are not requested, e.g., GPU nodes for CPU only requests, are
+/// less favored.
+class BestFitScorer : public NodeScorer {
+ public:
+  double Score(const ResourceSet &required_resources,
+               const SchedulingResources &node_resources) override;
+};
+
 /// Gcs resource scheduler implementation.
 /// Non-thread safe.
 class GcsResourceScheduler {
  public:
-  GcsResourceScheduler(GcsResourceManager &gcs_resource_manager)
-      : gcs_resource_manager_(gcs_resource_manager),
-        node_scorer_(new LeastResourceScorer()) {}
+  GcsResourceScheduler(GcsResourceManager &gcs_resource_manager);
 
   virtual ~GcsResourceScheduler() = default;
 
@@ -106,7 +135,32 @@ class GcsResourceScheduler {
       const SchedulingType &scheduling_type,
       const std::function<bool(const NodeID &)> &node_filter_func = nullptr);
 
+  /// Set the packing algorithm of a scheduling type, which overrides the config.
+  ///
+  /// \param scheduling_type The scheduling type, which is either `PACK` or `SPREAD`.
+  /// \param packing_algorithm The packing algorithm to place its resources with.
+  void SetPackingAlgorithm(const SchedulingType &scheduling_type,
+                           PackingAlgorithm packing_algorithm);
+
  private:
+  /// The state of a bounded search of placements.
+  struct PlacementSearchState {
+    /// Whether to minimize (`PACK`) or maximize (`SPREAD`) the number of nodes.
+    bool pack;
+    /// The order in which to place the resources.
+    std::vector<int> order;
+    /// The current partial placement, which corresponds to the resources one by one.
+    std::vector<NodeID> placement;
+    /// The number of resources on each node of the current placement.
+    absl::flat_hash_map<NodeID, int> node_usage;
+    /// The best complete placement found so far, empty if none.
+    std::vector<NodeID> best_placement;
+    /// The number of distinct nodes of the best placement.
+    size_t best_num_nodes = 0;
+    /// The number of resource placements that the search may still try.
+    uint64_t remaining_steps = 0;
+  };
+
   /// Filter out candidate nodes which can be used for scheduling.
   ///
   /// \param cluster_resources The cluster node resources.
@@ -127,6 +181,17 @@ class GcsResourceScheduler {
   const std::vector<ResourceSet> &SortRequiredResources(
       const std::vector<ResourceSet> &required_resources);
 
+  /// Get the order in which a packing algorithm places the resources.
+  ///
+  /// \param required_resources_list The resources to be scheduled.
+  /// \param candidate_nodes The nodes can be used for scheduling.
+  /// \param packing_algorithm The packing algorithm.
+  /// \return The indexes of the resources, in the order to place them.
+  std::vector<int> GetPlacementOrder(
+      const std::vector<ResourceSet> &required_resources_list,
+      const absl::flat_hash_set<NodeID> &candidate_nodes,
+      PackingAlgorithm packing_algorithm);
+
   /// Schedule resources according to `STRICT_SPREAD` strategy.
   ///
   /// \param required_resources_list The resources to be scheduled.
@@ -145,8 +210,10 @@ class GcsResourceScheduler {
   /// \return `SchedulingResult`, including the selected nodes if schedule successful,
   /// otherwise, it will return an empty vector and a flag to indicate whether this
   /// request can be retry or not.
+  /// \param packing_algorithm Either `GREEDY` or `BEST_FIT_DECREASING`.
   SchedulingResult SpreadSchedule(const std::vector<ResourceSet> &required_resources_list,
-                                  const absl::flat_hash_set<NodeID> &candidate_nodes);
+                                  const absl::flat_hash_set<NodeID> &candidate_nodes,
+                                  PackingAlgorithm packing_algorithm);
 
   /// Schedule resources according to `STRICT_PACK` strategy.
   ///
@@ -166,16 +233,81 @@ class GcsResourceScheduler {
   /// \return `SchedulingResult`, including the selected nodes if schedule successful,
   /// otherwise, it will return an empty vector and a flag to indicate whether this
   /// request can be retry or not.
+  /// \param packing_algorithm Either `GREEDY` or `BEST_FIT_DECREASING`.
   SchedulingResult PackSchedule(const std::vector<ResourceSet> &required_resources_list,
-                                const absl::flat_hash_set<NodeID> &candidate_nodes);
+                                const absl::flat_hash_set<NodeID> &candidate_nodes,
+                                PackingAlgorithm packing_algorithm);
+
+  /// Schedule resources according to `PACK` or `SPREAD` strategy with a bounded search
+  /// of placements, see `PackingAlgorithm::BOUNDED_SEARCH`. The search doesn't take the
+  /// topology paths of the nodes into account.
+  ///
+  /// \param required_resources_list The resources to be scheduled.
+  /// \param candidate_nodes The nodes can be used for scheduling.
+  /// \param scheduling_type Either `PACK` or `SPREAD`.
+  /// \return `SchedulingResult`, including the selected nodes if schedule successful,
+  /// otherwise, it will return an empty vector and a flag to indicate whether this
+  /// request can be retry or not.
+  SchedulingResult BoundedSearchSchedule(
+      const std::vector<ResourceSet> &required_resources_list,
+      const absl::flat_hash_set<NodeID> &candidate_nodes,
+      const SchedulingType &scheduling_type);
+
+  /// Search the placements of the remaining resources depth first, trying the nodes
+  /// that each resource fits best first. The resources placed so far are temporarily
+  /// deducted from `gcs_resource_manager_`.
+  ///
+  /// \param required_resources_list The resources to be scheduled.
+  /// \param candidate_nodes The nodes can be used for scheduling.
+  /// \param depth The number of resources placed so far.
+  /// \param state The state of the search.
+  void SearchPlacement(const std::vector<ResourceSet> &required_resources_list,
+                       const absl::flat_hash_set<NodeID> &candidate_nodes, size_t depth,
+                       PlacementSearchState *state);
 
   /// Score all nodes according to the specified resources.
   ///
   /// \param required_resources The resources to be scheduled.
   /// \param candidate_nodes The nodes can be used for scheduling.
+  /// \param node_scorer The scorer to use, `node_scorer_` if nullptr.
   /// \return Score of all nodes.
   std::optional<NodeID> GetBestNode(const ResourceSet &required_resources,
-                                    const absl::flat_hash_set<NodeID> &candidate_nodes);
+                                    const absl::flat_hash_set<NodeID> &candidate_nodes,
+                                    NodeScorer *node_scorer = nullptr);
+
+  /// Score the nodes like `GetBestNode`, but prefer the nodes whose topology path has
+  /// the lowest rank. The nodes of a rank are only considered if no node of a lower rank
+  /// can host the required resources. This is the same as `GetBestNode` if the
+  /// scheduling isn't topology aware.
+  ///
+  /// \param required_resources The resources to be scheduled.
+  /// \param candidate_nodes The nodes can be used for scheduling.
+  /// \param rank_func Rank a topology path, the lower the better.
+  /// \param node_scorer The scorer to use, `node_scorer_` if nullptr.
+  /// \return The best node, if any can host the required resources.
+  std::optional<NodeID> GetBestNodeByTopologyRank(
+      const ResourceSet &required_resources,
+      const absl::flat_hash_set<NodeID> &candidate_nodes,
+      const std::function<int(const std::string &)> &rank_func,
+      NodeScorer *node_scorer = nullptr);
+
+  /// Group the candidate nodes by their topology path, e.g., by rack, and score the
+  /// groups by their aggregated resources.
+  ///
+  /// \param required_resources The resources to be scheduled.
+  /// \param candidate_nodes The nodes can be used for scheduling.
+  /// \return The topology path of the best group, if the aggregated resources of any
+  /// group can host the required resources.
+  std::optional<std::string> GetBestTopologyGroup(
+      const ResourceSet &required_resources,
+      const absl::flat_hash_set<NodeID> &candidate_nodes);
+
+  /// Whether to take the topology paths of the nodes into account. This is only the case
+  /// if any node has a topology path.
+  bool IsTopologyAware() const;
+
+  /// Get the topology path of a node, or an empty string if it has none.
+  const std::string &GetTopologyPath(const NodeID &node_id) const;
 
   /// Return the resources temporarily deducted from gcs resource manager.
   ///
@@ -191,6 +323,12 @@ class GcsResourceScheduler {
 
   /// Scorer to make a grade to the node.
   std::unique_ptr<NodeScorer> node_scorer_;
+
+  /// Scorer to find the node that resources fit most tightly.
+  std::unique_ptr<NodeScorer> best_fit_scorer_;
+
+  /// The packing algorithm of each scheduling type.
+  PackingAlgorithm packing_algorithms_[SchedulingType::SchedulingType_MAX];
 };
 
 }  // namespace gcs
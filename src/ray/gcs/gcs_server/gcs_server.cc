@@ -35,6 +35,7 @@ GcsServer::GcsServer(const ray::gcs::GcsServerConfig &config,
                      instrumented_io_context &main_service)
     : config_(config),
       main_service_(main_service),
+      event_loops_(main_service, std::max<uint16_t>(config.num_event_loops, 1)),
       rpc_server_(config.grpc_server_name, config.grpc_server_port,
                   config.node_ip_address == "127.0.0.1", config.grpc_server_thread_num,
                   /*keepalive_time_ms=*/RayConfig::instance().grpc_keepalive_time_ms()),
@@ -82,10 +83,37 @@ void GcsServer::Start() {
       std::make_shared<GcsPublisher>(redis_client_, std::move(inner_publisher));
 
   // Init gcs table storage.
-  gcs_table_storage_ = std::make_shared<gcs::RedisGcsTableStorage>(redis_client_);
+  if (RayConfig::instance().gcs_storage_dir().empty()) {
+    store_client_ = std::make_shared<gcs::RedisStoreClient>(redis_client_);
+  } else {
+    file_store_ =
+        std::make_shared<FileStore>(RayConfig::instance().gcs_storage_dir(),
+                                    RayConfig::instance().gcs_storage_compaction_bytes());
+    store_client_ = std::make_shared<gcs::FileStoreClient>(main_service_, file_store_);
+  }
+  // The tables that are loaded on restart are only written from the main loop.
+  if (RayConfig::instance().gcs_init_data_snapshot_interval_ms() > 0) {
+    snapshot_store_client_ = std::make_shared<gcs::SnapshotStoreClient>(
+        store_client_, GcsInitData::SnapshotTables());
+    store_client_ = snapshot_store_client_;
+  } else {
+    // A snapshot that was taken before would miss the writes from now on.
+    RAY_CHECK_OK(gcs::SnapshotStoreClient::AsyncDeleteSnapshot(*store_client_, nullptr));
+  }
+  // The actor and placement group managers, which write the most, run on the main
+  // loop, so only the writes of the main loop are coalesced.
+  if (RayConfig::instance().gcs_storage_write_coalescing_ms() > 0) {
+    gcs_table_storage_ = std::make_shared<gcs::WriteCoalescingGcsTableStorage>(
+        main_service_, store_client_,
+        RayConfig::instance().gcs_storage_write_coalescing_ms(),
+        RayConfig::instance().maximum_gcs_storage_operation_batch_size());
+  } else {
+    gcs_table_storage_ = std::make_shared<gcs::GcsTableStorage>(store_client_);
+  }
 
   // Load gcs tables data asynchronously.
-  auto gcs_init_data = std::make_shared<GcsInitData>(gcs_table_storage_);
+  auto gcs_init_data =
+      std::make_shared<GcsInitData>(gcs_table_storage_, snapshot_store_client_);
   gcs_init_data->AsyncLoad([this, gcs_init_data] { DoStart(*gcs_init_data); });
 }
 
@@ -141,6 +169,9 @@ void GcsServer::DoStart(const GcsInitData &gcs_init_data) {
   // Install event listeners.
   InstallEventListeners();
 
+  // Start the event loops of the managers that don't run on the main loop.
+  event_loops_.Start();
+
   // Start RPC server when all tables have finished loading initial
   // data.
   rpc_server_.Run();
@@ -161,6 +192,12 @@ void GcsServer::DoStart(const GcsInitData &gcs_init_data) {
 
   CollectStats();
 
+  if (snapshot_store_client_) {
+    execute_after(
+        main_service_, [this] { TakeInitDataSnapshot(); },
+        RayConfig::instance().gcs_init_data_snapshot_interval_ms() /* milliseconds */);
+  }
+
   is_started_ = true;
 }
 
@@ -183,6 +220,8 @@ void GcsServer::Stop() {
     // Shutdown the rpc server
     rpc_server_.Shutdown();
 
+    event_loops_.Stop();
+
     is_stopped_ = true;
     RAY_LOG(INFO) << "GCS server stopped.";
   }
@@ -369,7 +408,7 @@ void GcsServer::InitTaskInfoHandler() {
 void GcsServer::InitResourceReportPolling(const GcsInitData &gcs_init_data) {
   gcs_resource_report_poller_.reset(new GcsResourceReportPoller(
       raylet_client_pool_, [this](const rpc::ResourcesData &report) {
-        gcs_resource_manager_->UpdateFromResourceReport(report);
+        return gcs_resource_manager_->UpdateFromResourceReport(report);
       }));
 
   gcs_resource_report_poller_->Initialize(gcs_init_data);
@@ -393,24 +432,35 @@ void GcsServer::InitResourceReportBroadcasting(const GcsInitData &gcs_init_data)
 
 void GcsServer::InitStatsHandler() {
   RAY_CHECK(gcs_table_storage_);
-  stats_handler_.reset(new rpc::DefaultStatsHandler(gcs_table_storage_));
+  auto &io_service = event_loops_.Next();
+  stats_handler_.reset(
+      new rpc::DefaultStatsHandler(GetEventLoopStorage(io_service).gcs_table_storage));
   // Register service.
-  stats_service_.reset(new rpc::StatsGrpcService(main_service_, *stats_handler_));
+  stats_service_.reset(new rpc::StatsGrpcService(io_service, *stats_handler_));
   rpc_server_.RegisterService(*stats_service_);
 }
 
 void GcsServer::InitKVManager() {
-  kv_manager_ = std::make_unique<GcsInternalKVManager>(redis_client_);
-  kv_service_ = std::make_unique<rpc::InternalKVGrpcService>(main_service_, *kv_manager_);
+  kv_io_service_ = &event_loops_.Next();
+  const auto &storage = GetEventLoopStorage(*kv_io_service_);
+  std::unique_ptr<InternalKVInterface> kv;
+  if (RayConfig::instance().gcs_internal_kv_in_memory()) {
+    kv = std::make_unique<MemoryInternalKV>(*kv_io_service_, storage.store_client);
+  } else {
+    kv = std::make_unique<RedisInternalKV>(storage.redis_client);
+  }
+  kv_manager_ = std::make_unique<GcsInternalKVManager>(std::move(kv));
+  kv_service_ =
+      std::make_unique<rpc::InternalKVGrpcService>(*kv_io_service_, *kv_manager_);
   // Register service.
   rpc_server_.RegisterService(*kv_service_);
 }
 
-// TODO: Investigating optimal threading for PubSub, e.g. separate io_context.
 void GcsServer::InitPubSubHandler() {
+  // The publisher is thread-safe, so the handler can run on any loop.
   pubsub_handler_ = std::make_unique<InternalPubSubHandler>(gcs_publisher_);
-  pubsub_service_ =
-      std::make_unique<rpc::InternalPubSubGrpcService>(main_service_, *pubsub_handler_);
+  pubsub_service_ = std::make_unique<rpc::InternalPubSubGrpcService>(
+      event_loops_.Next(), *pubsub_handler_);
   // Register service.
   rpc_server_.RegisterService(*pubsub_service_);
 }
@@ -429,24 +479,29 @@ void GcsServer::InitRuntimeEnvManager() {
             // Skip other uri
             cb(true);
           } else {
-            this->kv_manager_->InternalKVDelAsync(uri, [cb](int deleted_num) {
-              if (deleted_num == 0) {
-                cb(false);
-              } else {
-                cb(true);
-              }
-            });
+            // The KV manager may run on another loop, so post the deletion to it and
+            // the result back to the main loop.
+            kv_io_service_->post(
+                [this, uri, cb] {
+                  kv_manager_->InternalKVDelAsync(uri, [this, cb](int deleted_num) {
+                    main_service_.post([cb, deleted_num] { cb(deleted_num != 0); },
+                                       "GcsServer.InternalKVDelCallback");
+                  });
+                },
+                "GcsServer.InternalKVDel");
           }
         }
       });
 }
 
 void GcsServer::InitGcsWorkerManager() {
-  gcs_worker_manager_ =
-      std::make_unique<GcsWorkerManager>(gcs_table_storage_, gcs_publisher_);
+  auto &io_service = event_loops_.Next();
+  const auto &storage = GetEventLoopStorage(io_service);
+  gcs_worker_manager_ = std::make_unique<GcsWorkerManager>(storage.gcs_table_storage,
+                                                           storage.gcs_publisher);
   // Register service.
   worker_info_service_.reset(
-      new rpc::WorkerInfoGrpcService(main_service_, *gcs_worker_manager_));
+      new rpc::WorkerInfoGrpcService(io_service, *gcs_worker_manager_));
   rpc_server_.RegisterService(*worker_info_service_);
 }
 
@@ -479,20 +534,25 @@ void GcsServer::InstallEventListeners() {
         }
       });
 
-  // Install worker event listener.
+  // Install worker event listener. The worker manager may run on another loop, so the
+  // event is posted to the main loop that the actor manager runs on.
   gcs_worker_manager_->AddWorkerDeadListener(
       [this](std::shared_ptr<rpc::WorkerTableData> worker_failure_data) {
-        auto &worker_address = worker_failure_data->worker_address();
-        auto worker_id = WorkerID::FromBinary(worker_address.worker_id());
-        auto node_id = NodeID::FromBinary(worker_address.raylet_id());
-        std::shared_ptr<rpc::RayException> creation_task_exception = nullptr;
-        if (worker_failure_data->has_creation_task_exception()) {
-          creation_task_exception = std::make_shared<rpc::RayException>(
-              worker_failure_data->creation_task_exception());
-        }
-        gcs_actor_manager_->OnWorkerDead(node_id, worker_id,
-                                         worker_failure_data->exit_type(),
-                                         creation_task_exception);
+        main_service_.post(
+            [this, worker_failure_data] {
+              auto &worker_address = worker_failure_data->worker_address();
+              auto worker_id = WorkerID::FromBinary(worker_address.worker_id());
+              auto node_id = NodeID::FromBinary(worker_address.raylet_id());
+              std::shared_ptr<rpc::RayException> creation_task_exception = nullptr;
+              if (worker_failure_data->has_creation_task_exception()) {
+                creation_task_exception = std::make_shared<rpc::RayException>(
+                    worker_failure_data->creation_task_exception());
+              }
+              gcs_actor_manager_->OnWorkerDead(node_id, worker_id,
+                                               worker_failure_data->exit_type(),
+                                               creation_task_exception);
+            },
+            "GcsServer.WorkerDeadCallback");
       });
 
   // Install job event listeners.
@@ -513,6 +573,38 @@ void GcsServer::InstallEventListeners() {
   }
 }
 
+const GcsServer::EventLoopStorage &GcsServer::GetEventLoopStorage(
+    instrumented_io_context &io_service) {
+  auto it = event_loop_storages_.find(&io_service);
+  if (it != event_loop_storages_.end()) {
+    return it->second;
+  }
+  EventLoopStorage storage;
+  if (&io_service == &main_service_) {
+    storage = {redis_client_, store_client_, gcs_table_storage_, gcs_publisher_};
+  } else {
+    RedisClientOptions redis_client_options(config_.redis_address, config_.redis_port,
+                                            config_.redis_password,
+                                            config_.enable_sharding_conn);
+    storage.redis_client = std::make_shared<RedisClient>(redis_client_options);
+    auto status = storage.redis_client->Connect(io_service);
+    RAY_CHECK(status.ok()) << "Failed to init redis gcs client as " << status;
+    if (file_store_) {
+      storage.store_client =
+          std::make_shared<gcs::FileStoreClient>(io_service, file_store_);
+    } else {
+      storage.store_client =
+          std::make_shared<gcs::RedisStoreClient>(storage.redis_client);
+    }
+    storage.gcs_table_storage =
+        std::make_shared<gcs::GcsTableStorage>(storage.store_client);
+    // Only the Redis based channels are published from other loops.
+    storage.gcs_publisher =
+        std::make_shared<GcsPublisher>(storage.redis_client, /*publisher=*/nullptr);
+  }
+  return event_loop_storages_.emplace(&io_service, std::move(storage)).first->second;
+}
+
 void GcsServer::CollectStats() {
   gcs_actor_manager_->CollectStats();
   gcs_placement_group_manager_->CollectStats();
@@ -521,6 +613,24 @@ void GcsServer::CollectStats() {
       (RayConfig::instance().metrics_report_interval_ms() / 2) /* milliseconds */);
 }
 
+void GcsServer::TakeInitDataSnapshot() {
+  if (!snapshot_store_client_->ShouldTakeSnapshot(
+          RayConfig::instance().gcs_init_data_snapshot_min_tail_ratio())) {
+    execute_after(
+        main_service_, [this] { TakeInitDataSnapshot(); },
+        RayConfig::instance().gcs_init_data_snapshot_interval_ms() /* milliseconds */);
+    return;
+  }
+  snapshot_store_client_->AsyncTakeSnapshot([this](const Status &status) {
+    if (!status.ok()) {
+      RAY_LOG(WARNING) << "Failed to snapshot the GCS tables: " << status;
+    }
+    execute_after(
+        main_service_, [this] { TakeInitDataSnapshot(); },
+        RayConfig::instance().gcs_init_data_snapshot_interval_ms() /* milliseconds */);
+  });
+}
+
 void GcsServer::PrintDebugInfo() {
   std::ostringstream stream;
   stream << gcs_node_manager_->DebugString() << "\n"
@@ -14,8 +14,10 @@
 
 #pragma once
 
+#include "absl/container/flat_hash_map.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/runtime_env_manager.h"
+#include "ray/gcs/gcs_server/gcs_event_loops.h"
 #include "ray/gcs/gcs_server/gcs_heartbeat_manager.h"
 #include "ray/gcs/gcs_server/gcs_init_data.h"
 #include "ray/gcs/gcs_server/gcs_kv_manager.h"
@@ -40,6 +42,7 @@ struct GcsServerConfig {
   std::string grpc_server_name = "GcsServer";
   uint16_t grpc_server_port = 0;
   uint16_t grpc_server_thread_num = 1;
+  uint16_t num_event_loops = 1;
   std::string redis_password;
   std::string redis_address;
   uint16_t redis_port = 6379;
@@ -151,9 +154,28 @@ class GcsServer {
   /// Print debug info periodically.
   void PrintDebugInfo();
 
+  /// Snapshot the tables that are loaded on restart periodically.
+  void TakeInitDataSnapshot();
+
   /// Print the asio event loop stats for debugging.
   void PrintAsioStats();
 
+  /// The storage clients that are driven by an event loop. Redis connections are not
+  /// thread-safe, so managers on different loops use different ones.
+  struct EventLoopStorage {
+    std::shared_ptr<RedisClient> redis_client;
+    std::shared_ptr<StoreClient> store_client;
+    std::shared_ptr<GcsTableStorage> gcs_table_storage;
+    std::shared_ptr<GcsPublisher> gcs_publisher;
+  };
+
+  /// Get the storage clients of an event loop, and connect them on first use.
+  ///
+  /// \param io_service The event loop.
+  /// \return The storage clients of the main loop if `io_service` is the main loop, or
+  /// ones that are dedicated to `io_service` otherwise.
+  const EventLoopStorage &GetEventLoopStorage(instrumented_io_context &io_service);
+
   /// Gcs server configuration.
   GcsServerConfig config_;
   /// The main io service to drive event posted from grpc threads.
@@ -161,6 +183,11 @@ class GcsServer {
   /// The io service used by heartbeat manager in case of node failure detector being
   /// blocked by main thread.
   instrumented_io_context heartbeat_manager_io_service_;
+  /// The event loops of the managers that don't share state with the ones on the main
+  /// loop.
+  GcsEventLoops event_loops_;
+  /// The storage clients of each event loop.
+  absl::flat_hash_map<instrumented_io_context *, EventLoopStorage> event_loop_storages_;
   /// The grpc server
   rpc::GrpcServer rpc_server_;
   /// The `ClientCallManager` object that is shared by all `NodeManagerWorkerClient`s.
@@ -211,8 +238,9 @@ class GcsServer {
   std::unique_ptr<rpc::WorkerInfoGrpcService> worker_info_service_;
   /// Placement Group info handler and service.
   std::unique_ptr<rpc::PlacementGroupInfoGrpcService> placement_group_info_service_;
-  /// Global KV storage handler and service.
+  /// Global KV storage handler and service, and the loop that drives them.
   std::unique_ptr<GcsInternalKVManager> kv_manager_;
+  instrumented_io_context *kv_io_service_ = nullptr;
   std::unique_ptr<rpc::InternalKVGrpcService> kv_service_;
   /// GCS PubSub handler and service.
   std::unique_ptr<InternalPubSubHandler> pubsub_handler_;
@@ -223,8 +251,14 @@ class GcsServer {
   std::shared_ptr<GcsPublisher> gcs_publisher_;
   /// Grpc based pubsub's periodical runner.
   PeriodicalRunner pubsub_periodical_runner_;
+  /// The store client of the main loop.
+  std::shared_ptr<gcs::StoreClient> store_client_;
+  /// The snapshot of the tables that are loaded on restart, if they are snapshotted.
+  std::shared_ptr<gcs::SnapshotStoreClient> snapshot_store_client_;
   /// The gcs table storage.
   std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage_;
+  /// The local storage of the gcs tables, if they are not stored in Redis.
+  std::shared_ptr<FileStore> file_store_;
   std::unique_ptr<ray::RuntimeEnvManager> runtime_env_manager_;
   /// Gcs service state flag, which is used for ut.
   std::atomic<bool> is_started_;
@@ -67,19 +67,27 @@ int main(int argc, char *argv[]) {
     RAY_CHECK(status.ok()) << "Failed to init redis gcs client as " << status;
 
     // Init storage.
-    auto storage = std::make_shared<ray::gcs::RedisGcsTableStorage>(redis_client);
+    std::shared_ptr<ray::gcs::GcsTableStorage> storage;
+    if (RayConfig::instance().gcs_storage_dir().empty()) {
+      storage = std::make_shared<ray::gcs::RedisGcsTableStorage>(redis_client);
+    } else {
+      storage = std::make_shared<ray::gcs::FileGcsTableStorage>(
+          service, std::make_shared<ray::gcs::FileStore>(
+                       RayConfig::instance().gcs_storage_dir(),
+                       RayConfig::instance().gcs_storage_compaction_bytes()));
+    }
 
     // The internal_config is only set on the gcs--other nodes get it from GCS.
-    auto on_done = [promise, &service](const ray::Status &status) {
-      promise->set_value();
-      service.stop();
-    };
+    auto on_done = [&service](const ray::Status &status) { service.stop(); };
     ray::rpc::StoredConfig config;
     config.set_config(config_list);
     RAY_CHECK_OK(
         storage->InternalConfigTable().Put(ray::UniqueID::Nil(), config, on_done));
     boost::asio::io_service::work work(service);
     service.run();
+    // Close the storage before the GCS server opens it.
+    storage.reset();
+    promise->set_value();
   }).detach();
   promise->get_future().get();
 
@@ -107,6 +115,7 @@ int main(int argc, char *argv[]) {
   gcs_server_config.grpc_server_port = gcs_server_port;
   gcs_server_config.grpc_server_thread_num =
       RayConfig::instance().gcs_server_rpc_server_thread_num();
+  gcs_server_config.num_event_loops = RayConfig::instance().gcs_server_num_event_loops();
   gcs_server_config.redis_address = redis_address;
   gcs_server_config.redis_port = redis_port;
   gcs_server_config.redis_password = redis_password;
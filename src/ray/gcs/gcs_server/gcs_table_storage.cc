@@ -28,6 +28,22 @@ Status GcsTable<Key, Data>::Put(const Key &key, const Data &value,
                                  callback);
 }
 
+template <typename Key, typename Data>
+Status GcsTable<Key, Data>::BatchPut(const std::vector<Key> &keys,
+                                     const std::vector<Data> &values,
+                                     const StatusCallback &callback) {
+  RAY_CHECK(keys.size() == values.size());
+  std::vector<std::string> keys_to_put;
+  std::vector<std::string> data;
+  keys_to_put.reserve(keys.size());
+  data.reserve(values.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys_to_put.emplace_back(keys[i].Binary());
+    data.emplace_back(values[i].SerializeAsString());
+  }
+  return store_client_->AsyncBatchPut(table_name_, keys_to_put, {}, data, callback);
+}
+
 template <typename Key, typename Data>
 Status GcsTable<Key, Data>::Get(const Key &key,
                                 const OptionalItemCallback<Data> &callback) {
@@ -85,6 +101,26 @@ Status GcsTableWithJobId<Key, Data>::Put(const Key &key, const Data &value,
                                                 value.SerializeAsString(), callback);
 }
 
+template <typename Key, typename Data>
+Status GcsTableWithJobId<Key, Data>::BatchPut(const std::vector<Key> &keys,
+                                              const std::vector<Data> &values,
+                                              const StatusCallback &callback) {
+  RAY_CHECK(keys.size() == values.size());
+  std::vector<std::string> keys_to_put;
+  std::vector<std::string> index_keys;
+  std::vector<std::string> data;
+  keys_to_put.reserve(keys.size());
+  index_keys.reserve(keys.size());
+  data.reserve(values.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys_to_put.emplace_back(keys[i].Binary());
+    index_keys.emplace_back(GetJobIdFromKey(keys[i]).Binary());
+    data.emplace_back(values[i].SerializeAsString());
+  }
+  return this->store_client_->AsyncBatchPut(this->table_name_, keys_to_put, index_keys,
+                                            data, callback);
+}
+
 template <typename Key, typename Data>
 Status GcsTableWithJobId<Key, Data>::GetByJobId(const JobID &job_id,
                                                 const MapCallback<Key, Data> &callback) {
@@ -18,8 +18,10 @@
 #include <utility>
 
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/gcs/store_client/file_store_client.h"
 #include "ray/gcs/store_client/in_memory_store_client.h"
 #include "ray/gcs/store_client/redis_store_client.h"
+#include "ray/gcs/store_client/write_coalescing_store_client.h"
 #include "src/ray/protobuf/gcs.pb.h"
 
 namespace ray {
@@ -65,6 +67,15 @@ class GcsTable {
   /// \return Status
   virtual Status Put(const Key &key, const Data &value, const StatusCallback &callback);
 
+  /// Write a batch of data to the table asynchronously with one storage write.
+  ///
+  /// \param keys The keys that will be written to the table.
+  /// \param values The values of the given keys, they are in one-to-one correspondence.
+  /// \param callback Callback that will be called after all writes finish.
+  /// \return Status
+  virtual Status BatchPut(const std::vector<Key> &keys, const std::vector<Data> &values,
+                          const StatusCallback &callback);
+
   /// Get data from the table asynchronously.
   ///
   /// \param key The key to lookup from the table.
@@ -118,6 +129,15 @@ class GcsTableWithJobId : public GcsTable<Key, Data> {
   /// \return Status
   Status Put(const Key &key, const Data &value, const StatusCallback &callback) override;
 
+  /// Write a batch of data and index to the table asynchronously with one storage write.
+  ///
+  /// \param keys The keys that will be written to the table.
+  /// \param values The values of the given keys, they are in one-to-one correspondence.
+  /// \param callback Callback that will be called after all writes finish.
+  /// \return Status
+  Status BatchPut(const std::vector<Key> &keys, const std::vector<Data> &values,
+                  const StatusCallback &callback) override;
+
   /// Get all the data of the specified job id from the table asynchronously.
   ///
   /// \param job_id The key to lookup from the table.
@@ -418,5 +438,30 @@ class InMemoryGcsTableStorage : public GcsTableStorage {
       : GcsTableStorage(std::make_shared<InMemoryStoreClient>(main_io_service)) {}
 };
 
+/// \class FileGcsTableStorage
+/// FileGcsTableStorage is an implementation of `GcsTableStorage`
+/// that uses files in a local directory as storage.
+class FileGcsTableStorage : public GcsTableStorage {
+ public:
+  FileGcsTableStorage(instrumented_io_context &main_io_service,
+                      std::shared_ptr<FileStore> file_store)
+      : GcsTableStorage(
+            std::make_shared<FileStoreClient>(main_io_service, std::move(file_store))) {}
+};
+
+/// \class WriteCoalescingGcsTableStorage
+/// WriteCoalescingGcsTableStorage is an implementation of `GcsTableStorage`
+/// that buffers and batches the writes to another store client, see
+/// `WriteCoalescingStoreClient`.
+class WriteCoalescingGcsTableStorage : public GcsTableStorage {
+ public:
+  WriteCoalescingGcsTableStorage(instrumented_io_context &main_io_service,
+                                 std::shared_ptr<StoreClient> store_client,
+                                 uint32_t flush_interval_ms, size_t max_batch_size)
+      : GcsTableStorage(std::make_shared<WriteCoalescingStoreClient>(
+            main_io_service, std::move(store_client), flush_interval_ms,
+            max_batch_size)) {}
+};
+
 }  // namespace gcs
 }  // namespace ray
@@ -14,6 +14,9 @@
 
 #include "ray/gcs/gcs_server/grpc_based_resource_broadcaster.h"
 
+#include <algorithm>
+
+#include "ray/common/broadcast_tree.h"
 #include "ray/stats/stats.h"
 
 namespace ray {
@@ -25,6 +28,7 @@ GrpcBasedResourceBroadcaster::GrpcBasedResourceBroadcaster(
         get_resource_usage_batch_for_broadcast,
     std::function<void(const rpc::Address &,
                        std::shared_ptr<rpc::NodeManagerClientPool> &, std::string &,
+                       const std::vector<rpc::Address> &,
                        const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &)>
         send_batch
 
@@ -35,7 +39,8 @@ GrpcBasedResourceBroadcaster::GrpcBasedResourceBroadcaster(
       get_resource_usage_batch_for_broadcast_(get_resource_usage_batch_for_broadcast),
       send_batch_(send_batch),
       broadcast_period_ms_(
-          RayConfig::instance().raylet_report_resources_period_milliseconds()) {}
+          RayConfig::instance().raylet_report_resources_period_milliseconds()),
+      relay_fanout_(RayConfig::instance().resource_broadcast_relay_fanout()) {}
 
 GrpcBasedResourceBroadcaster::~GrpcBasedResourceBroadcaster() {}
 
@@ -116,17 +121,60 @@ void GrpcBasedResourceBroadcaster::SendBroadcast() {
   std::string serialized_batch = batch.SerializeAsString();
   stats::OutboundHeartbeatSizeKB.Record((double)(serialized_batch.size() / 1024.0));
 
-  absl::MutexLock guard(&mutex_);
-  for (const auto &pair : nodes_) {
-    const auto &address = pair.second;
+  std::vector<rpc::Address> receivers;
+  {
+    absl::MutexLock guard(&mutex_);
+    receivers.reserve(nodes_.size());
+    for (const auto &pair : nodes_) {
+      receivers.push_back(pair.second);
+    }
+  }
+  if (relay_fanout_ > 0) {
+    // Keep the tree stable across rounds, so that raylets keep relaying to the same
+    // nodes over the same connections.
+    std::sort(receivers.begin(), receivers.end(),
+              [](const rpc::Address &a, const rpc::Address &b) {
+                return a.raylet_id() < b.raylet_id();
+              });
+  }
+  SendBatch(std::make_shared<std::string>(std::move(serialized_batch)), receivers);
+}
+
+void GrpcBasedResourceBroadcaster::SendBatch(
+    const std::shared_ptr<std::string> &serialized_batch,
+    const std::vector<rpc::Address> &receivers) {
+  if (relay_fanout_ == 0) {
+    for (const auto &address : receivers) {
+      double start_time = absl::GetCurrentTimeNanos();
+      auto callback = [start_time](const Status &status,
+                                   const rpc::UpdateResourceUsageReply &reply) {
+        double end_time = absl::GetCurrentTimeNanos();
+        double lapsed_time_ms = static_cast<double>(end_time - start_time) / 1e6;
+        ray::stats::GcsUpdateResourceUsageTime.Record(lapsed_time_ms);
+      };
+      send_batch_(address, raylet_client_pool_, *serialized_batch, {}, callback);
+    }
+    return;
+  }
+
+  for (const auto &subtree : SplitBroadcastTree(receivers, relay_fanout_)) {
     double start_time = absl::GetCurrentTimeNanos();
-    auto callback = [start_time](const Status &status,
-                                 const rpc::UpdateResourceUsageReply &reply) {
+    auto callback = [this, start_time, serialized_batch,
+                     relay_addresses = subtree.second](
+                        const Status &status,
+                        const rpc::UpdateResourceUsageReply &reply) {
       double end_time = absl::GetCurrentTimeNanos();
       double lapsed_time_ms = static_cast<double>(end_time - start_time) / 1e6;
       ray::stats::GcsUpdateResourceUsageTime.Record(lapsed_time_ms);
+      if (!status.ok() && !relay_addresses.empty()) {
+        RAY_LOG(DEBUG) << "Failed to send a resource broadcast to a relaying raylet, "
+                       << "sending it to the " << relay_addresses.size()
+                       << " nodes it relays to instead: " << status.ToString();
+        SendBatch(serialized_batch, relay_addresses);
+      }
     };
-    send_batch_(address, raylet_client_pool_, serialized_batch, callback);
+    send_batch_(subtree.first, raylet_client_pool_, *serialized_batch, subtree.second,
+                callback);
   }
 }
 
@@ -30,15 +30,17 @@ class GrpcBasedResourceBroadcaster {
       /* Default values should only be changed for testing. */
       std::function<void(const rpc::Address &,
                          std::shared_ptr<rpc::NodeManagerClientPool> &, std::string &,
+                         const std::vector<rpc::Address> &,
                          const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &)>
           send_batch =
               [](const rpc::Address &address,
                  std::shared_ptr<rpc::NodeManagerClientPool> &raylet_client_pool,
                  std::string &serialized_resource_usage_batch,
+                 const std::vector<rpc::Address> &relay_addresses,
                  const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) {
                 auto raylet_client = raylet_client_pool->GetOrConnectByAddress(address);
                 raylet_client->UpdateResourceUsage(serialized_resource_usage_batch,
-                                                   callback);
+                                                   relay_addresses, callback);
               });
   ~GrpcBasedResourceBroadcaster();
 
@@ -76,7 +78,7 @@ class GrpcBasedResourceBroadcaster {
       get_resource_usage_batch_for_broadcast_;
 
   std::function<void(const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &,
-                     std::string &,
+                     std::string &, const std::vector<rpc::Address> &,
                      const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &)>
       send_batch_;
 
@@ -87,8 +89,18 @@ class GrpcBasedResourceBroadcaster {
 
   const uint64_t broadcast_period_ms_;
 
+  /// See `resource_broadcast_relay_fanout`. 0 means the batch is sent to every node
+  /// directly.
+  const uint64_t relay_fanout_;
+
   void SendBroadcast();
 
+  /// Send a serialized batch to the given nodes, either directly or along a tree of
+  /// relaying raylets. If a relaying raylet can't be reached, the batch is sent to
+  /// the nodes it should have relayed to instead.
+  void SendBatch(const std::shared_ptr<std::string> &serialized_batch,
+                 const std::vector<rpc::Address> &receivers);
+
   friend class GrpcBasedResourceBroadcasterTest;
 };
 }  // namespace gcs
@@ -0,0 +1,149 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+
+#include "absl/time/clock.h"
+#include "ray/gcs/gcs_server/gcs_actor_manager.h"
+#include "ray/gcs/gcs_server/test/gcs_server_test_util.h"
+#include "ray/gcs/test/gcs_test_util.h"
+
+namespace ray {
+namespace gcs {
+namespace {
+
+/// An actor manager with a raylet based actor scheduler on one node, whose mocked
+/// raylet grants every lease and whose mocked workers create every actor.
+class ActorCreationBenchmark {
+ public:
+  ActorCreationBenchmark()
+      : raylet_client_(std::make_shared<GcsServerMocker::MockRayletClient>()),
+        worker_client_(std::make_shared<GcsServerMocker::MockWorkerClient>()),
+        runtime_env_manager_([](auto, auto f) { f(true); }),
+        node_(Mocker::GenNodeInfo()) {
+    auto raylet_client_pool = std::make_shared<rpc::NodeManagerClientPool>(
+        [this](const rpc::Address &) { return raylet_client_; });
+    auto gcs_publisher = std::make_shared<GcsPublisher>(
+        std::make_unique<GcsServerMocker::MockGcsPubSub>(nullptr));
+    gcs_table_storage_ = std::make_shared<InMemoryGcsTableStorage>(io_service_);
+    gcs_node_manager_ = std::make_shared<GcsNodeManager>(
+        gcs_publisher, gcs_table_storage_, raylet_client_pool);
+    gcs_node_manager_->AddNode(node_);
+    auto client_factory = [this](const rpc::Address &) { return worker_client_; };
+    auto scheduler = std::make_shared<RayletBasedActorScheduler>(
+        io_service_, gcs_table_storage_->ActorTable(), *gcs_node_manager_,
+        [this](std::shared_ptr<GcsActor> actor, bool destroy_actor) {
+          gcs_actor_manager_->OnActorCreationFailed(std::move(actor), destroy_actor);
+        },
+        [this](std::shared_ptr<GcsActor> actor, const rpc::PushTaskReply &reply) {
+          gcs_actor_manager_->OnActorCreationSuccess(std::move(actor), reply);
+        },
+        raylet_client_pool, client_factory);
+    gcs_actor_manager_ = std::make_unique<GcsActorManager>(
+        io_service_, scheduler, gcs_table_storage_, gcs_publisher, runtime_env_manager_,
+        [](const ActorID &) {}, [](const JobID &) { return ""; },
+        [](std::function<void(void)> fn, boost::posix_time::milliseconds) { fn(); },
+        client_factory);
+  }
+
+  /// Register and create each actor with its own requests, and return the actors ready
+  /// per second.
+  double CreateOneByOne(int num_actors) {
+    std::vector<rpc::RegisterActorRequest> requests;
+    for (int i = 0; i < num_actors; i++) {
+      requests.emplace_back(Mocker::GenRegisterActorRequest(JobID::FromInt(1)));
+    }
+    int num_ready = 0;
+    auto start = absl::Now();
+    for (const auto &request : requests) {
+      RAY_CHECK_OK(gcs_actor_manager_->RegisterActor(
+          request, [this, &num_ready](std::shared_ptr<GcsActor> actor) {
+            rpc::CreateActorRequest create_request;
+            create_request.mutable_task_spec()->CopyFrom(
+                actor->GetActorTableData().task_spec());
+            RAY_CHECK_OK(gcs_actor_manager_->CreateActor(
+                create_request,
+                [&num_ready](std::shared_ptr<GcsActor>, const rpc::PushTaskReply &) {
+                  num_ready++;
+                }));
+          }));
+    }
+    RunUntil([&num_ready, num_actors]() { return num_ready == num_actors; });
+    return num_actors / absl::ToDoubleSeconds(absl::Now() - start);
+  }
+
+  /// Create all actors with one CreateActors request, and return the actors ready per
+  /// second.
+  double CreateBatch(int num_actors) {
+    rpc::CreateActorsRequest request;
+    for (int i = 0; i < num_actors; i++) {
+      request.add_task_specs()->CopyFrom(
+          Mocker::GenCreateActorRequest(JobID::FromInt(1)).task_spec());
+    }
+    rpc::CreateActorsReply reply;
+    bool replied = false;
+    auto start = absl::Now();
+    gcs_actor_manager_->HandleCreateActors(
+        request, &reply,
+        [&replied](Status, std::function<void()>, std::function<void()>) {
+          replied = true;
+        });
+    RunUntil([&replied]() { return replied; });
+    for (const auto &actor_reply : reply.replies()) {
+      RAY_CHECK(actor_reply.status().code() == static_cast<int>(StatusCode::OK));
+    }
+    return num_actors / absl::ToDoubleSeconds(absl::Now() - start);
+  }
+
+ private:
+  /// Run the event loop, grant the leases and reply to the pushes of the actor creation
+  /// tasks until `done` returns true.
+  void RunUntil(std::function<bool()> done) {
+    while (!done()) {
+      io_service_.restart();
+      io_service_.poll();
+      while (raylet_client_->GrantWorkerLease(
+          node_->node_manager_address(), node_->node_manager_port(),
+          WorkerID::FromRandom(), NodeID::FromBinary(node_->node_id()), NodeID::Nil())) {
+      }
+      while (worker_client_->ReplyPushTask()) {
+      }
+    }
+  }
+
+  instrumented_io_context io_service_;
+  std::shared_ptr<GcsServerMocker::MockRayletClient> raylet_client_;
+  std::shared_ptr<GcsServerMocker::MockWorkerClient> worker_client_;
+  RuntimeEnvManager runtime_env_manager_;
+  std::shared_ptr<rpc::GcsNodeInfo> node_;
+  std::shared_ptr<GcsTableStorage> gcs_table_storage_;
+  std::shared_ptr<GcsNodeManager> gcs_node_manager_;
+  std::unique_ptr<GcsActorManager> gcs_actor_manager_;
+};
+
+}  // namespace
+}  // namespace gcs
+}  // namespace ray
+
+/// Measure the actors ready per second when the actors are registered and created one
+/// by one, and when they are created with one batch.
+int main(int argc, char **argv) {
+  const int num_actors = 2000;
+  ray::gcs::ActorCreationBenchmark benchmark;
+  double one_by_one = benchmark.CreateOneByOne(num_actors);
+  double batch = benchmark.CreateBatch(num_actors);
+  std::cout << "Actors ready per second: " << one_by_one << " one by one, " << batch
+            << " batched." << std::endl;
+  return 0;
+}
@@ -30,6 +30,10 @@ class MockActorScheduler : public gcs::GcsActorSchedulerInterface {
   MockActorScheduler() {}
 
   void Schedule(std::shared_ptr<gcs::GcsActor> actor) { actors.push_back(actor); }
+  void ScheduleBatch(std::vector<std::shared_ptr<gcs::GcsActor>> batch) {
+    num_batches++;
+    gcs::GcsActorSchedulerInterface::ScheduleBatch(std::move(batch));
+  }
   void Reschedule(std::shared_ptr<gcs::GcsActor> actor) {}
   void ReleaseUnusedWorkers(
       const std::unordered_map<NodeID, std::vector<WorkerID>> &node_to_workers) {}
@@ -41,6 +45,7 @@ class MockActorScheduler : public gcs::GcsActorSchedulerInterface {
                                      const TaskID &task_id));
 
   std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  int num_batches = 0;
 };
 
 class MockWorkerClient : public rpc::CoreWorkerClientInterface {
@@ -746,6 +751,61 @@ TEST_F(GcsActorManagerTest, TestDestroyActorBeforeActorCreationCompletes) {
   ASSERT_EQ(actor->GetState(), rpc::ActorTableData::DEAD);
 }
 
+TEST_F(GcsActorManagerTest, TestCreateActors) {
+  auto job_id = JobID::FromInt(1);
+  rpc::CreateActorsRequest request;
+  for (int i = 0; i < 4; i++) {
+    request.add_task_specs()->CopyFrom(
+        Mocker::GenCreateActorRequest(job_id, 0, false, i < 2 ? "" : "actor")
+            .task_spec());
+  }
+  // A duplicate of an actor in the batch.
+  request.add_task_specs()->CopyFrom(request.task_specs(0));
+
+  rpc::CreateActorsReply reply;
+  std::promise<void> replied;
+  io_service_.post([this, &request, &reply, &replied]() {
+    gcs_actor_manager_->HandleCreateActors(
+        request, &reply,
+        [&replied](Status status, std::function<void()> success,
+                   std::function<void()> failure) { replied.set_value(); });
+  });
+  // The new actors are persisted with one write and scheduled together. The second
+  // actor named "actor" fails to register.
+  auto condition = [this]() {
+    std::promise<size_t> promise;
+    io_service_.post(
+        [this, &promise]() { promise.set_value(mock_actor_scheduler_->actors.size()); });
+    return promise.get_future().get() == 3;
+  };
+  ASSERT_TRUE(WaitForCondition(condition, timeout_ms_.count()));
+  ASSERT_EQ(mock_actor_scheduler_->num_batches, 1);
+
+  // The first actor is destroyed before it is created.
+  ASSERT_TRUE(worker_client_->Reply());
+  std::promise<void> created;
+  io_service_.post([this, &created]() {
+    for (size_t i = 1; i < mock_actor_scheduler_->actors.size(); i++) {
+      auto actor = mock_actor_scheduler_->actors[i];
+      actor->UpdateAddress(RandomAddress());
+      gcs_actor_manager_->OnActorCreationSuccess(actor, rpc::PushTaskReply());
+    }
+    created.set_value();
+  });
+  created.get_future().get();
+  ASSERT_EQ(replied.get_future().wait_for(timeout_ms_), std::future_status::ready);
+
+  ASSERT_EQ(reply.status().code(), (int)StatusCode::OK);
+  ASSERT_EQ(reply.replies_size(), 5);
+  ASSERT_EQ(reply.replies(0).status().code(), (int)StatusCode::Invalid);
+  ASSERT_EQ(reply.replies(1).status().code(), (int)StatusCode::OK);
+  ASSERT_EQ(reply.replies(1).actor_address().worker_id(),
+            mock_actor_scheduler_->actors[1]->GetAddress().worker_id());
+  ASSERT_EQ(reply.replies(2).status().code(), (int)StatusCode::OK);
+  ASSERT_EQ(reply.replies(3).status().code(), (int)StatusCode::Invalid);
+  ASSERT_EQ(reply.replies(4).status().code(), (int)StatusCode::Invalid);
+}
+
 TEST_F(GcsActorManagerTest, TestRaceConditionCancelLease) {
   // Covers a scenario 1 in this PR https://github.com/ray-project/ray/pull/9215.
   auto job_id = JobID::FromInt(1);
@@ -0,0 +1,134 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/gcs_event_loops.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "absl/time/clock.h"
+#include "gtest/gtest.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+namespace gcs {
+
+class GcsEventLoopsTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    main_thread_.reset(new std::thread([this] {
+      boost::asio::io_service::work work(main_service_);
+      main_service_.run();
+    }));
+  }
+
+  void TearDown() override {
+    main_service_.stop();
+    main_thread_->join();
+  }
+
+  /// Simulate a request handler that keeps its event loop busy for a while.
+  static void HandleRequest(std::atomic<int> *num_handled) {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::microseconds(20)) {
+    }
+    (*num_handled)++;
+  }
+
+  /// Run a mix of actor registrations, which are handled on the main loop, and KV ops,
+  /// which are handled on their own loop if there is one.
+  ///
+  /// \return The number of requests handled per second.
+  double RunWorkload(size_t num_loops) {
+    const int num_actor_registrations = 5000;
+    const int num_kv_ops = 5000;
+    GcsEventLoops event_loops(main_service_, num_loops);
+    auto &kv_service = event_loops.Next();
+    event_loops.Start();
+
+    std::atomic<int> num_handled(0);
+    auto start = absl::Now();
+    for (int i = 0; i < num_actor_registrations + num_kv_ops; i++) {
+      auto &io_service = i % 2 == 0 ? main_service_ : kv_service;
+      io_service.post([&num_handled] { HandleRequest(&num_handled); }, "Request");
+    }
+    while (num_handled < num_actor_registrations + num_kv_ops) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+    event_loops.Stop();
+    return (num_actor_registrations + num_kv_ops) / seconds;
+  }
+
+  instrumented_io_context main_service_;
+  std::unique_ptr<std::thread> main_thread_;
+};
+
+TEST_F(GcsEventLoopsTest, TestNext) {
+  GcsEventLoops single_loop(main_service_, 1);
+  ASSERT_EQ(single_loop.Size(), 1);
+  ASSERT_EQ(&single_loop.Next(), &main_service_);
+
+  GcsEventLoops event_loops(main_service_, 3);
+  ASSERT_EQ(event_loops.Size(), 3);
+  auto *first = &event_loops.Next();
+  auto *second = &event_loops.Next();
+  ASSERT_NE(first, &main_service_);
+  ASSERT_NE(second, &main_service_);
+  ASSERT_NE(first, second);
+  ASSERT_EQ(&event_loops.Next(), first);
+}
+
+TEST_F(GcsEventLoopsTest, TestCrossLoopMessages) {
+  GcsEventLoops event_loops(main_service_, 2);
+  auto &io_service = event_loops.Next();
+  event_loops.Start();
+
+  // A request is handled on its manager's loop, and the result is posted back to the
+  // main loop.
+  std::promise<std::pair<std::thread::id, std::thread::id>> promise;
+  io_service.post(
+      [this, &promise] {
+        auto handler_thread = std::this_thread::get_id();
+        main_service_.post(
+            [&promise, handler_thread] {
+              promise.set_value({handler_thread, std::this_thread::get_id()});
+            },
+            "Reply");
+      },
+      "Request");
+  auto threads = promise.get_future().get();
+  ASSERT_NE(threads.first, main_thread_->get_id());
+  ASSERT_EQ(threads.second, main_thread_->get_id());
+  event_loops.Stop();
+}
+
+/// Measure the throughput of a mixed actor registration and KV workload with one loop,
+/// and with the KV ops moved to a loop of their own.
+TEST_F(GcsEventLoopsTest, TestThroughput) {
+  double single_loop = RunWorkload(1);
+  double multiple_loops = RunWorkload(2);
+  RAY_LOG(INFO) << "Requests per second: " << single_loop << " with 1 loop, "
+                << multiple_loops << " with 2 loops.";
+}
+
+}  // namespace gcs
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
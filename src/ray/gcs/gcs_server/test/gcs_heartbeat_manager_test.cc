@@ -0,0 +1,141 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/gcs_heartbeat_manager.h"
+
+#include <future>
+
+#include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
+
+namespace ray {
+namespace gcs {
+
+class MockGcsHeartbeatManager : public GcsHeartbeatManager {
+ public:
+  using GcsHeartbeatManager::DetectDeadNodes;
+  using GcsHeartbeatManager::GcsHeartbeatManager;
+};
+
+class GcsHeartbeatManagerTest : public ::testing::Test {
+ public:
+  void TearDown() override {
+    if (heartbeat_manager_) {
+      heartbeat_manager_->Stop();
+    }
+    RayConfig::instance().initialize(
+        R"({"num_heartbeats_timeout": 30, "gcs_heartbeat_phi_threshold": 0})");
+  }
+
+ protected:
+  void CreateHeartbeatManager() {
+    heartbeat_manager_ = std::make_unique<MockGcsHeartbeatManager>(
+        io_service_, [this](const NodeID &node_id) { dead_nodes_.push_back(node_id); },
+        [this]() { return now_ms_; });
+  }
+
+  /// Run a function on the loop of the heartbeat manager and wait for it.
+  void RunOnLoop(std::function<void()> fn) {
+    std::promise<bool> promise;
+    io_service_.post(
+        [&fn, &promise]() {
+          fn();
+          promise.set_value(true);
+        },
+        "GcsHeartbeatManagerTest.RunOnLoop");
+    promise.get_future().get();
+  }
+
+  NodeID AddNode() {
+    auto node_id = NodeID::FromRandom();
+    heartbeat_manager_->AddNode(node_id);
+    return node_id;
+  }
+
+  /// Send a heartbeat of a node, and return whether it's accepted.
+  bool ReportHeartbeat(const NodeID &node_id) {
+    rpc::ReportHeartbeatReply reply;
+    RunOnLoop([this, &node_id, &reply]() {
+      rpc::ReportHeartbeatRequest request;
+      request.mutable_heartbeat()->set_node_id(node_id.Binary());
+      heartbeat_manager_->HandleReportHeartbeat(
+          request, &reply, [](Status, std::function<void()>, std::function<void()>) {});
+    });
+    return reply.status().code() == static_cast<int>(StatusCode::OK);
+  }
+
+  /// Run ticks of the failure detector, advancing the clock by a heartbeat period per
+  /// tick, and send heartbeats of the given nodes on every tick.
+  void Tick(int num_ticks, const std::vector<NodeID> &alive_nodes = {}) {
+    for (int i = 0; i < num_ticks; i++) {
+      now_ms_ += RayConfig::instance().raylet_heartbeat_period_milliseconds();
+      for (const auto &node_id : alive_nodes) {
+        ASSERT_TRUE(ReportHeartbeat(node_id));
+      }
+      RunOnLoop([this]() { heartbeat_manager_->DetectDeadNodes(); });
+    }
+  }
+
+  instrumented_io_context io_service_;
+  std::unique_ptr<MockGcsHeartbeatManager> heartbeat_manager_;
+  std::vector<NodeID> dead_nodes_;
+  int64_t now_ms_ = 1;
+};
+
+TEST_F(GcsHeartbeatManagerTest, TestNodeTimeout) {
+  RayConfig::instance().initialize(R"({"num_heartbeats_timeout": 5})");
+  CreateHeartbeatManager();
+  auto node_1 = AddNode();
+  auto node_2 = AddNode();
+
+  Tick(4, {node_2});
+  ASSERT_TRUE(dead_nodes_.empty());
+  ASSERT_TRUE(ReportHeartbeat(node_1));
+  Tick(4, {node_2});
+  ASSERT_TRUE(dead_nodes_.empty());
+  Tick(1, {node_2});
+  ASSERT_EQ(dead_nodes_, std::vector<NodeID>({node_1}));
+
+  // A node that timed out can't send heartbeats anymore.
+  ASSERT_FALSE(ReportHeartbeat(node_1));
+  Tick(5);
+  ASSERT_EQ(dead_nodes_, std::vector<NodeID>({node_1, node_2}));
+}
+
+TEST_F(GcsHeartbeatManagerTest, TestPhiAccrualTimeout) {
+  RayConfig::instance().initialize(
+      R"({"num_heartbeats_timeout": 5, "gcs_heartbeat_phi_threshold": 8})");
+  CreateHeartbeatManager();
+  auto steady_node = AddNode();
+  auto pausing_node = AddNode();
+  ASSERT_TRUE(ReportHeartbeat(steady_node));
+  ASSERT_TRUE(ReportHeartbeat(pausing_node));
+
+  // The second node pauses for 4 periods, e.g., for GC, every 10 periods.
+  for (int i = 0; i < 10; i++) {
+    Tick(4, {steady_node});
+    Tick(6, {steady_node, pausing_node});
+  }
+  ASSERT_TRUE(dead_nodes_.empty());
+
+  // Once both nodes die, the steady one is detected after the fixed timeout, while
+  // the one that paused before gets more time, up to a bound.
+  Tick(5);
+  ASSERT_EQ(dead_nodes_, std::vector<NodeID>({steady_node}));
+  Tick(15);
+  ASSERT_EQ(dead_nodes_, std::vector<NodeID>({steady_node, pausing_node}));
+}
+
+}  // namespace gcs
+}  // namespace ray
@@ -0,0 +1,114 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <future>
+#include <iostream>
+#include <thread>
+
+#include "absl/time/clock.h"
+#include "ray/common/test_util.h"
+#include "ray/gcs/gcs_server/gcs_init_data.h"
+#include "ray/gcs/store_client/redis_store_client.h"
+#include "ray/gcs/test/gcs_test_util.h"
+
+namespace ray {
+namespace gcs {
+namespace {
+
+std::shared_ptr<GcsInitData> Load(std::shared_ptr<GcsInitData> gcs_init_data) {
+  std::promise<bool> promise;
+  gcs_init_data->AsyncLoad([&promise] { promise.set_value(true); });
+  promise.get_future().get();
+  return gcs_init_data;
+}
+
+void WaitForStatus(std::function<Status(const StatusCallback &)> operation) {
+  std::promise<Status> promise;
+  RAY_CHECK_OK(
+      operation([&promise](const Status &status) { promise.set_value(status); }));
+  RAY_CHECK_OK(promise.get_future().get());
+}
+
+/// Compare the time to load the init data of a cluster with many dead actors on
+/// restart, from each table in Redis and from the snapshot in the same Redis.
+void RunBenchmark() {
+  const int num_jobs = 100;
+  const int num_actors_per_job = 500;
+  instrumented_io_context io_service;
+  std::thread thread([&io_service]() {
+    boost::asio::io_service::work work(io_service);
+    io_service.run();
+  });
+  RedisClientOptions options("127.0.0.1", TEST_REDIS_SERVER_PORTS.front(), "",
+                             /*enable_sharding_conn=*/false);
+  auto redis_client = std::make_shared<RedisClient>(options);
+  RAY_CHECK_OK(redis_client->Connect(io_service));
+  auto store_client = std::make_shared<RedisStoreClient>(redis_client);
+
+  auto snapshot_store_client =
+      std::make_shared<SnapshotStoreClient>(store_client, GcsInitData::SnapshotTables());
+  auto gcs_table_storage = std::make_shared<GcsTableStorage>(snapshot_store_client);
+  Load(std::make_shared<GcsInitData>(gcs_table_storage, snapshot_store_client));
+  for (int i = 1; i <= num_jobs; i++) {
+    auto job_id = JobID::FromInt(i);
+    WaitForStatus([&](const StatusCallback &callback) {
+      return gcs_table_storage->JobTable().Put(
+          job_id, *Mocker::GenJobTableData(job_id), callback);
+    });
+    for (int j = 0; j < num_actors_per_job; j++) {
+      auto actor = Mocker::GenActorTableData(job_id);
+      actor->set_state(rpc::ActorTableData::DEAD);
+      WaitForStatus([&](const StatusCallback &callback) {
+        return gcs_table_storage->ActorTable().Put(
+            ActorID::FromBinary(actor->actor_id()), *actor, callback);
+      });
+    }
+  }
+  WaitForStatus([&](const StatusCallback &callback) {
+    snapshot_store_client->AsyncTakeSnapshot(callback);
+    return Status::OK();
+  });
+
+  auto start = absl::GetCurrentTimeNanos();
+  Load(std::make_shared<GcsInitData>(std::make_shared<GcsTableStorage>(store_client)));
+  auto tables_ms = (absl::GetCurrentTimeNanos() - start) / 1e6;
+  start = absl::GetCurrentTimeNanos();
+  snapshot_store_client =
+      std::make_shared<SnapshotStoreClient>(store_client, GcsInitData::SnapshotTables());
+  auto from_snapshot = Load(std::make_shared<GcsInitData>(
+      std::make_shared<GcsTableStorage>(snapshot_store_client), snapshot_store_client));
+  auto snapshot_ms = (absl::GetCurrentTimeNanos() - start) / 1e6;
+
+  std::cout << "Loaded " << from_snapshot->Actors().size() << " actors in " << tables_ms
+            << " ms from the tables, " << snapshot_ms << " ms from the snapshot."
+            << std::endl;
+
+  io_service.stop();
+  thread.join();
+  redis_client->Disconnect();
+}
+
+}  // namespace
+}  // namespace gcs
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  RAY_CHECK(argc == 3) << "Usage: " << argv[0] << " <redis-server> <redis-cli>";
+  ray::TEST_REDIS_SERVER_EXEC_PATH = argv[1];
+  ray::TEST_REDIS_CLIENT_EXEC_PATH = argv[2];
+  ray::TestSetupUtil::StartUpRedisServers(std::vector<int>());
+  ray::gcs::RunBenchmark();
+  ray::TestSetupUtil::ShutDownRedisServers();
+  return 0;
+}
@@ -0,0 +1,266 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <future>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ray/gcs/gcs_server/gcs_init_data.h"
+#include "ray/gcs/store_client/in_memory_store_client.h"
+#include "ray/gcs/test/gcs_test_util.h"
+
+namespace ray {
+namespace gcs {
+
+class GcsInitDataSnapshotTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    thread_.reset(new std::thread([this] {
+      boost::asio::io_service::work work(io_service_);
+      io_service_.run();
+    }));
+    store_client_ = std::make_shared<InMemoryStoreClient>(io_service_);
+  }
+
+  void TearDown() override {
+    io_service_.stop();
+    thread_->join();
+  }
+
+ protected:
+  /// Start a GCS server on the tables, which snapshots them, and load its init data.
+  std::shared_ptr<GcsInitData> Restart() {
+    snapshot_store_client_ = std::make_shared<SnapshotStoreClient>(
+        store_client_, GcsInitData::SnapshotTables());
+    gcs_table_storage_ = std::make_shared<GcsTableStorage>(snapshot_store_client_);
+    return Load(
+        std::make_shared<GcsInitData>(gcs_table_storage_, snapshot_store_client_));
+  }
+
+  /// Load the init data from each table, without the snapshot.
+  std::shared_ptr<GcsInitData> LoadTables() {
+    return Load(std::make_shared<GcsInitData>(
+        std::make_shared<GcsTableStorage>(store_client_)));
+  }
+
+  std::shared_ptr<GcsInitData> Load(std::shared_ptr<GcsInitData> gcs_init_data) {
+    std::promise<bool> promise;
+    gcs_init_data->AsyncLoad([&promise] { promise.set_value(true); });
+    promise.get_future().get();
+    return gcs_init_data;
+  }
+
+  void WaitForStatus(std::function<Status(const StatusCallback &)> operation) {
+    std::promise<Status> promise;
+    RAY_CHECK_OK(
+        operation([&promise](const Status &status) { promise.set_value(status); }));
+    RAY_CHECK_OK(promise.get_future().get());
+  }
+
+  void TakeSnapshot() {
+    WaitForStatus([this](const StatusCallback &callback) {
+      snapshot_store_client_->AsyncTakeSnapshot(callback);
+      return Status::OK();
+    });
+  }
+
+  ActorID PutActor(const JobID &job_id, bool dead = false) {
+    auto actor = Mocker::GenActorTableData(job_id);
+    if (dead) {
+      actor->set_state(rpc::ActorTableData::DEAD);
+    }
+    auto actor_id = ActorID::FromBinary(actor->actor_id());
+    WaitForStatus([this, &actor_id, &actor](const StatusCallback &callback) {
+      return gcs_table_storage_->ActorTable().Put(actor_id, *actor, callback);
+    });
+    return actor_id;
+  }
+
+  void PutJob(const JobID &job_id) {
+    WaitForStatus([this, &job_id](const StatusCallback &callback) {
+      return gcs_table_storage_->JobTable().Put(
+          job_id, *Mocker::GenJobTableData(job_id), callback);
+    });
+  }
+
+  size_t TailSize() {
+    std::promise<size_t> promise;
+    RAY_CHECK_OK(store_client_->AsyncGetAll(
+        TablePrefix_Name(TablePrefix::GCS_SNAPSHOT_TAIL),
+        [&promise](const std::unordered_map<std::string, std::string> &tail) {
+          promise.set_value(tail.size());
+        }));
+    return promise.get_future().get();
+  }
+
+  template <typename Key, typename Data>
+  void AssertSameTable(const std::unordered_map<Key, Data> &a,
+                       const std::unordered_map<Key, Data> &b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (const auto &entry : a) {
+      auto it = b.find(entry.first);
+      ASSERT_TRUE(it != b.end());
+      ASSERT_EQ(it->second.SerializeAsString(), entry.second.SerializeAsString());
+    }
+  }
+
+  void AssertSameInitData(const GcsInitData &a, const GcsInitData &b) {
+    AssertSameTable(a.Jobs(), b.Jobs());
+    AssertSameTable(a.Nodes(), b.Nodes());
+    AssertSameTable(a.Objects(), b.Objects());
+    AssertSameTable(a.ClusterResources(), b.ClusterResources());
+    AssertSameTable(a.Actors(), b.Actors());
+    AssertSameTable(a.PlacementGroups(), b.PlacementGroups());
+  }
+
+  instrumented_io_context io_service_;
+  std::unique_ptr<std::thread> thread_;
+  std::shared_ptr<StoreClient> store_client_;
+  std::shared_ptr<SnapshotStoreClient> snapshot_store_client_;
+  std::shared_ptr<GcsTableStorage> gcs_table_storage_;
+};
+
+TEST_F(GcsInitDataSnapshotTest, TestLoadWithoutSnapshot) {
+  auto gcs_init_data = Restart();
+  ASSERT_TRUE(gcs_init_data->Actors().empty());
+  auto job_id = JobID::FromInt(1);
+  PutJob(job_id);
+  for (int i = 0; i < 10; i++) {
+    PutActor(job_id);
+  }
+
+  // Without a snapshot, the tables are loaded from the store.
+  gcs_init_data = Restart();
+  ASSERT_EQ(gcs_init_data->Jobs().size(), 1);
+  ASSERT_EQ(gcs_init_data->Actors().size(), 10);
+  AssertSameInitData(*gcs_init_data, *LoadTables());
+}
+
+TEST_F(GcsInitDataSnapshotTest, TestLoadSnapshotAndTail) {
+  Restart();
+  std::vector<ActorID> actor_ids;
+  for (int i = 1; i <= 3; i++) {
+    auto job_id = JobID::FromInt(i);
+    PutJob(job_id);
+    for (int j = 0; j < 10; j++) {
+      actor_ids.push_back(PutActor(job_id));
+    }
+  }
+  TakeSnapshot();
+
+  // Mutate the tables after the snapshot.
+  auto job_id = JobID::FromInt(4);
+  PutJob(job_id);
+  for (int j = 0; j < 10; j++) {
+    PutActor(job_id, /*dead=*/true);
+  }
+  WaitForStatus([this, &actor_ids](const StatusCallback &callback) {
+    return gcs_table_storage_->ActorTable().Delete(actor_ids[0], callback);
+  });
+  WaitForStatus([this, &actor_ids](const StatusCallback &callback) {
+    return gcs_table_storage_->ActorTable().BatchDelete({actor_ids[1], actor_ids[2]},
+                                                        callback);
+  });
+  WaitForStatus([this](const StatusCallback &callback) {
+    return gcs_table_storage_->ActorTable().DeleteByJobId(JobID::FromInt(2), callback);
+  });
+  ASSERT_EQ(TailSize(), 14);
+
+  auto gcs_init_data = Restart();
+  ASSERT_EQ(gcs_init_data->Jobs().size(), 4);
+  ASSERT_EQ(gcs_init_data->Actors().size(), 27);
+  AssertSameInitData(*gcs_init_data, *LoadTables());
+
+  // Mutations after the restart are ordered after the tail.
+  PutActor(job_id);
+  TakeSnapshot();
+  ASSERT_EQ(TailSize(), 0);
+  gcs_init_data = Restart();
+  ASSERT_EQ(gcs_init_data->Actors().size(), 28);
+  AssertSameInitData(*gcs_init_data, *LoadTables());
+}
+
+TEST_F(GcsInitDataSnapshotTest, TestSnapshotWithMutationsInFlight) {
+  Restart();
+  auto job_id = JobID::FromInt(1);
+  PutJob(job_id);
+  // Start mutations that are still in flight when the snapshot is taken.
+  const int num_actors = 100;
+  std::vector<std::promise<Status>> promises(num_actors);
+  for (int i = 0; i < num_actors; i++) {
+    auto actor = Mocker::GenActorTableData(job_id);
+    RAY_CHECK_OK(gcs_table_storage_->ActorTable().Put(
+        ActorID::FromBinary(actor->actor_id()), *actor,
+        [&promises, i](const Status &status) { promises[i].set_value(status); }));
+    if (i == num_actors / 2) {
+      snapshot_store_client_->AsyncTakeSnapshot(nullptr);
+    }
+  }
+  for (auto &promise : promises) {
+    RAY_CHECK_OK(promise.get_future().get());
+  }
+  TakeSnapshot();
+
+  auto gcs_init_data = Restart();
+  ASSERT_EQ(gcs_init_data->Actors().size(), num_actors);
+  AssertSameInitData(*gcs_init_data, *LoadTables());
+}
+
+TEST_F(GcsInitDataSnapshotTest, TestShouldTakeSnapshot) {
+  const double min_tail_ratio = 0.25;
+  Restart();
+  // An idle GCS doesn't take snapshots.
+  ASSERT_FALSE(snapshot_store_client_->ShouldTakeSnapshot(min_tail_ratio));
+  auto job_id = JobID::FromInt(1);
+  PutJob(job_id);
+  for (int i = 0; i < 7; i++) {
+    PutActor(job_id);
+  }
+  ASSERT_TRUE(snapshot_store_client_->ShouldTakeSnapshot(min_tail_ratio));
+  TakeSnapshot();
+  ASSERT_FALSE(snapshot_store_client_->ShouldTakeSnapshot(min_tail_ratio));
+
+  // The snapshot has 8 entries, so it takes 2 mutations to take the next one.
+  PutActor(job_id);
+  ASSERT_FALSE(snapshot_store_client_->ShouldTakeSnapshot(min_tail_ratio));
+  PutActor(job_id);
+  ASSERT_TRUE(snapshot_store_client_->ShouldTakeSnapshot(min_tail_ratio));
+  // The tail and the snapshot are counted again on restart.
+  Restart();
+  ASSERT_TRUE(snapshot_store_client_->ShouldTakeSnapshot(min_tail_ratio));
+  ASSERT_FALSE(snapshot_store_client_->ShouldTakeSnapshot(min_tail_ratio * 2));
+}
+
+TEST_F(GcsInitDataSnapshotTest, TestDeleteSnapshot) {
+  Restart();
+  PutJob(JobID::FromInt(1));
+  TakeSnapshot();
+  PutJob(JobID::FromInt(2));
+  ASSERT_GT(TailSize(), 0);
+
+  // Writes without the snapshot store client make the snapshot and its tail stale, so
+  // they are deleted.
+  WaitForStatus([this](const StatusCallback &callback) {
+    return SnapshotStoreClient::AsyncDeleteSnapshot(*store_client_, callback);
+  });
+  ASSERT_EQ(TailSize(), 0);
+  gcs_table_storage_ = std::make_shared<GcsTableStorage>(store_client_);
+  PutJob(JobID::FromInt(3));
+
+  auto gcs_init_data = Restart();
+  ASSERT_EQ(gcs_init_data->Jobs().size(), 3);
+}
+
+}  // namespace gcs
+}  // namespace ray
@@ -0,0 +1,147 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <thread>
+
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "ray/common/test_util.h"
+#include "ray/gcs/gcs_server/gcs_kv_manager.h"
+
+namespace ray {
+namespace gcs {
+namespace {
+
+/// Run a function on the event loop, where the operations of the KVs run, and wait for
+/// it to return.
+void RunOnEventLoop(instrumented_io_context &io_service, std::function<void()> fn) {
+  std::promise<void> promise;
+  io_service.post(
+      [&fn, &promise]() {
+        fn();
+        promise.set_value();
+      },
+      "GcsKVManagerBenchmark.RunOnEventLoop");
+  promise.get_future().get();
+}
+
+/// Run `num_ops` puts and gets, half of each, and return the ops per second.
+double RunPutsAndGets(instrumented_io_context &io_service, InternalKVInterface *kv,
+                      int num_ops) {
+  std::atomic<int> num_done(0);
+  auto start = absl::Now();
+  io_service.post(
+      [kv, num_ops, &num_done]() {
+        for (int i = 0; i < num_ops / 2; i++) {
+          auto key = absl::StrCat("key_", i % 1000);
+          kv->Put(key, std::string(100, 'x'), true, [&num_done](bool) { num_done++; });
+          kv->Get(key, [&num_done](boost::optional<std::string>) { num_done++; });
+        }
+      },
+      "GcsKVManagerBenchmark.RunPutsAndGets");
+  RAY_CHECK(
+      WaitForCondition([&num_done, num_ops]() { return num_done == num_ops; }, 60000));
+  return num_ops / absl::ToDoubleSeconds(absl::Now() - start);
+}
+
+/// Fill the KV with 100000 keys, and return the prefix listings per second of
+/// prefixes that match 11 keys each.
+double RunKeys(instrumented_io_context &io_service, InternalKVInterface *kv,
+               int num_listings) {
+  const int num_keys = 100000;
+  std::atomic<int> num_puts(0);
+  io_service.post(
+      [kv, &num_puts]() {
+        for (int i = 0; i < num_keys; i++) {
+          kv->Put(absl::StrCat("prefix_", i), "value", true,
+                  [&num_puts](bool) { num_puts++; });
+        }
+      },
+      "GcsKVManagerBenchmark.FillKeys");
+  RAY_CHECK(WaitForCondition([&num_puts]() { return num_puts == num_keys; }, 60000));
+  std::atomic<int> num_done(0);
+  auto start = absl::Now();
+  io_service.post(
+      [kv, num_listings, &num_done]() {
+        for (int i = 0; i < num_listings; i++) {
+          // E.g., "prefix_1234" matches itself and "prefix_12340" to "prefix_12349".
+          kv->Keys(absl::StrCat("prefix_", 1000 + i % 9000),
+                   [&num_done](std::vector<std::string> keys) {
+                     RAY_CHECK(keys.size() == 11);
+                     num_done++;
+                   });
+        }
+      },
+      "GcsKVManagerBenchmark.RunKeys");
+  RAY_CHECK(WaitForCondition(
+      [&num_done, num_listings]() { return num_done == num_listings; }, 60000));
+  return num_listings / absl::ToDoubleSeconds(absl::Now() - start);
+}
+
+/// Compare the ops per second of the KV on Redis and the KV in memory, which is
+/// persisted to the same Redis.
+void RunBenchmark() {
+  const int num_ops = 100000;
+  const int num_listings = 1000;
+  instrumented_io_context io_service;
+  std::thread thread([&io_service]() {
+    boost::asio::io_service::work work(io_service);
+    io_service.run();
+  });
+  RedisClientOptions options("127.0.0.1", TEST_REDIS_SERVER_PORTS.front(), "",
+                             /*enable_sharding_conn=*/false);
+  auto redis_client = std::make_shared<RedisClient>(options);
+  RAY_CHECK_OK(redis_client->Connect(io_service));
+  auto store_client = std::make_shared<RedisStoreClient>(redis_client);
+
+  std::unique_ptr<InternalKVInterface> kv;
+  RunOnEventLoop(io_service,
+                 [&]() { kv = std::make_unique<RedisInternalKV>(redis_client); });
+  double redis_ops = RunPutsAndGets(io_service, kv.get(), num_ops);
+  double redis_listings = RunKeys(io_service, kv.get(), num_listings);
+  TestSetupUtil::FlushAllRedisServers();
+
+  RunOnEventLoop(io_service, [&]() {
+    kv = std::make_unique<MemoryInternalKV>(io_service, store_client);
+  });
+  double memory_ops = RunPutsAndGets(io_service, kv.get(), num_ops);
+  double memory_listings = RunKeys(io_service, kv.get(), num_listings);
+  RunOnEventLoop(io_service, [&]() { kv.reset(); });
+
+  std::cout << "Puts and gets per second: " << redis_ops << " on Redis, " << memory_ops
+            << " in memory." << std::endl;
+  std::cout << "Prefix listings per second: " << redis_listings << " on Redis, "
+            << memory_listings << " in memory." << std::endl;
+
+  io_service.stop();
+  thread.join();
+  redis_client->Disconnect();
+}
+
+}  // namespace
+}  // namespace gcs
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  RAY_CHECK(argc == 3) << "Usage: " << argv[0] << " <redis-server> <redis-cli>";
+  ray::TEST_REDIS_SERVER_EXEC_PATH = argv[1];
+  ray::TEST_REDIS_CLIENT_EXEC_PATH = argv[2];
+  ray::TestSetupUtil::StartUpRedisServers(std::vector<int>());
+  ray::gcs::RunBenchmark();
+  ray::TestSetupUtil::ShutDownRedisServers();
+  return 0;
+}
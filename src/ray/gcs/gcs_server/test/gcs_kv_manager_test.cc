@@ -0,0 +1,216 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/gcs_kv_manager.h"
+
+#include <future>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ray/gcs/store_client/in_memory_store_client.h"
+
+namespace ray {
+namespace gcs {
+
+class GcsKVManagerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    thread_.reset(new std::thread([this] {
+      boost::asio::io_service::work work(io_service_);
+      io_service_.run();
+    }));
+    store_client_ = std::make_shared<InMemoryStoreClient>(io_service_);
+  }
+
+  void TearDown() override {
+    // Destroy the KVs on the event loop, where their operations run.
+    Sync<bool>([this](std::function<void(bool)> done) {
+      kv_manager_.reset();
+      done(true);
+    });
+    io_service_.stop();
+    thread_->join();
+  }
+
+ protected:
+  /// Run an asynchronous operation on the event loop and wait for its result.
+  template <typename T>
+  T Sync(std::function<void(std::function<void(T)>)> operation) {
+    std::promise<T> promise;
+    io_service_.post(
+        [&operation, &promise]() {
+          operation([&promise](T value) { promise.set_value(std::move(value)); });
+        },
+        "GcsKVManagerTest.Sync");
+    return promise.get_future().get();
+  }
+
+  /// Create a KV manager on the event loop, and return its KV.
+  InternalKVInterface *CreateKV(
+      std::function<std::unique_ptr<InternalKVInterface>()> create) {
+    InternalKVInterface *kv = nullptr;
+    Sync<bool>([this, &create, &kv](std::function<void(bool)> done) {
+      auto internal_kv = create();
+      kv = internal_kv.get();
+      kv_manager_ = std::make_unique<GcsInternalKVManager>(std::move(internal_kv));
+      done(true);
+    });
+    return kv;
+  }
+
+  InternalKVInterface *CreateMemoryKV() {
+    return CreateKV([this]() {
+      return std::make_unique<MemoryInternalKV>(io_service_, store_client_);
+    });
+  }
+
+  bool Put(InternalKVInterface *kv, const std::string &key, const std::string &value,
+           bool overwrite = true) {
+    return Sync<bool>([&](std::function<void(bool)> done) {
+      kv->Put(key, value, overwrite, done);
+    });
+  }
+
+  boost::optional<std::string> Get(InternalKVInterface *kv, const std::string &key) {
+    return Sync<boost::optional<std::string>>(
+        [&](std::function<void(boost::optional<std::string>)> done) {
+          kv->Get(key, done);
+        });
+  }
+
+  int Del(InternalKVInterface *kv, const std::string &key) {
+    return Sync<int>([&](std::function<void(int)> done) { kv->Del(key, done); });
+  }
+
+  bool Exists(InternalKVInterface *kv, const std::string &key) {
+    return Sync<bool>([&](std::function<void(bool)> done) { kv->Exists(key, done); });
+  }
+
+  std::vector<std::string> Keys(InternalKVInterface *kv, const std::string &prefix) {
+    auto keys = Sync<std::vector<std::string>>(
+        [&](std::function<void(std::vector<std::string>)> done) {
+          kv->Keys(prefix, done);
+        });
+    std::sort(keys.begin(), keys.end());
+    return keys;
+  }
+
+  instrumented_io_context io_service_;
+  std::unique_ptr<std::thread> thread_;
+  std::shared_ptr<StoreClient> store_client_;
+  std::unique_ptr<GcsInternalKVManager> kv_manager_;
+};
+
+TEST_F(GcsKVManagerTest, TestMemoryKV) {
+  auto kv = CreateMemoryKV();
+  ASSERT_TRUE(Put(kv, "a", "1"));
+  ASSERT_TRUE(Put(kv, "ab", "2"));
+  ASSERT_TRUE(Put(kv, "b", "3"));
+  ASSERT_EQ(*Get(kv, "a"), "1");
+  ASSERT_FALSE(Get(kv, "c"));
+  ASSERT_TRUE(Exists(kv, "ab"));
+  ASSERT_FALSE(Exists(kv, "c"));
+
+  // Overwrite.
+  ASSERT_FALSE(Put(kv, "a", "4", /*overwrite=*/false));
+  ASSERT_EQ(*Get(kv, "a"), "1");
+  ASSERT_FALSE(Put(kv, "a", "4", /*overwrite=*/true));
+  ASSERT_EQ(*Get(kv, "a"), "4");
+
+  // Prefix listing.
+  ASSERT_EQ(Keys(kv, "a"), std::vector<std::string>({"a", "ab"}));
+  ASSERT_EQ(Keys(kv, ""), std::vector<std::string>({"a", "ab", "b"}));
+  ASSERT_TRUE(Keys(kv, "c").empty());
+
+  // Delete.
+  ASSERT_EQ(Del(kv, "a"), 1);
+  ASSERT_EQ(Del(kv, "a"), 0);
+  ASSERT_FALSE(Exists(kv, "a"));
+  ASSERT_EQ(Keys(kv, "a"), std::vector<std::string>({"ab"}));
+}
+
+TEST_F(GcsKVManagerTest, TestMemoryKVLoad) {
+  auto kv = CreateMemoryKV();
+  ASSERT_TRUE(Put(kv, "a", "1"));
+  ASSERT_TRUE(Put(kv, "b", "2"));
+  ASSERT_EQ(Del(kv, "b"), 1);
+
+  // A new KV loads the persisted keys. The operations that are called before the load
+  // finishes are queued.
+  auto value = Sync<boost::optional<std::string>>(
+      [this](std::function<void(boost::optional<std::string>)> done) {
+        auto new_kv = std::make_unique<MemoryInternalKV>(io_service_, store_client_);
+        new_kv->Get("a", done);
+        kv_manager_ = std::make_unique<GcsInternalKVManager>(std::move(new_kv));
+      });
+  ASSERT_EQ(*value, "1");
+  kv = CreateMemoryKV();
+  ASSERT_EQ(Keys(kv, ""), std::vector<std::string>({"a"}));
+}
+
+TEST_F(GcsKVManagerTest, TestNamespace) {
+  CreateMemoryKV();
+  auto put = [this](const std::string &ns, const std::string &key) {
+    rpc::InternalKVPutRequest request;
+    request.set_namespace_(ns);
+    request.set_key(key);
+    request.set_value(ns);
+    request.set_overwrite(true);
+    rpc::InternalKVPutReply reply;
+    Sync<bool>([&](std::function<void(bool)> done) {
+      kv_manager_->HandleInternalKVPut(
+          request, &reply,
+          [done](Status, std::function<void()>, std::function<void()>) { done(true); });
+    });
+    return reply.added_num();
+  };
+  auto get = [this](const std::string &ns, const std::string &key) {
+    rpc::InternalKVGetRequest request;
+    request.set_namespace_(ns);
+    request.set_key(key);
+    rpc::InternalKVGetReply reply;
+    Sync<bool>([&](std::function<void(bool)> done) {
+      kv_manager_->HandleInternalKVGet(
+          request, &reply,
+          [done](Status, std::function<void()>, std::function<void()>) { done(true); });
+    });
+    return reply.value();
+  };
+  auto keys = [this](const std::string &ns, const std::string &prefix) {
+    rpc::InternalKVKeysRequest request;
+    request.set_namespace_(ns);
+    request.set_prefix(prefix);
+    rpc::InternalKVKeysReply reply;
+    Sync<bool>([&](std::function<void(bool)> done) {
+      kv_manager_->HandleInternalKVKeys(
+          request, &reply,
+          [done](Status, std::function<void()>, std::function<void()>) { done(true); });
+    });
+    return std::vector<std::string>(reply.results().begin(), reply.results().end());
+  };
+
+  ASSERT_EQ(put("", "key"), 1);
+  ASSERT_EQ(put("ns1", "key"), 1);
+  ASSERT_EQ(put("ns2", "key"), 1);
+  ASSERT_EQ(put("ns1", "key"), 0);
+  ASSERT_EQ(get("", "key"), "");
+  ASSERT_EQ(get("ns1", "key"), "ns1");
+  ASSERT_EQ(get("ns2", "key"), "ns2");
+  // The keys of a namespace are listed without the namespace.
+  ASSERT_EQ(keys("ns1", "k"), std::vector<std::string>({"key"}));
+  ASSERT_TRUE(keys("ns3", "").empty());
+}
+
+}  // namespace gcs
+}  // namespace ray
@@ -0,0 +1,223 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
+#include <sstream>
+
+#include "absl/strings/str_split.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/gcs/gcs_server/gcs_resource_scheduler.h"
+#include "ray/util/util.h"
+
+namespace ray {
+namespace {
+
+/// A placement group of the trace.
+struct PlacementGroupArrival {
+  int64_t arrival_time;
+  int64_t lifetime;
+  gcs::SchedulingType scheduling_type;
+  std::vector<ResourceSet> bundles;
+};
+
+/// The result of replaying a trace with a packing algorithm.
+struct SimulationResult {
+  size_t num_scheduled = 0;
+  size_t num_failed = 0;
+  int64_t total_scheduling_time_us = 0;
+};
+
+class PackingSimulation {
+ public:
+  /// \param trace_file_path The placement group arrival trace to replay, a generated
+  /// one if empty. Each line of the trace is a placement group:
+  /// "<arrival time> <lifetime> <PACK|SPREAD> <bundle>...", where a bundle is
+  /// "<num cpus>:<num gpus>", e.g., "0 30 PACK 2:0 2:0 8:1".
+  explicit PackingSimulation(const std::string &trace_file_path)
+      : trace_(trace_file_path.empty() ? GenTrace(/*num_placement_groups=*/2000)
+                                       : LoadTrace(trace_file_path)) {}
+
+  size_t TraceSize() const { return trace_.size(); }
+
+  /// Replay the trace against a fresh cluster. The bundles of a scheduled placement
+  /// group hold their resources until it departs, and a placement group that fails to
+  /// schedule is dropped instead of retried.
+  SimulationResult Replay(gcs::PackingAlgorithm packing_algorithm) {
+    gcs::GcsResourceManager gcs_resource_manager(io_service_, nullptr, nullptr, true);
+    AddClusterNodes(&gcs_resource_manager);
+    gcs::GcsResourceScheduler gcs_resource_scheduler(gcs_resource_manager);
+    gcs_resource_scheduler.SetPackingAlgorithm(gcs::SchedulingType::PACK,
+                                               packing_algorithm);
+    gcs_resource_scheduler.SetPackingAlgorithm(gcs::SchedulingType::SPREAD,
+                                               packing_algorithm);
+
+    using Departure = std::pair<int64_t, std::vector<std::pair<NodeID, ResourceSet>>>;
+    auto later = [](const Departure &a, const Departure &b) { return a.first > b.first; };
+    std::priority_queue<Departure, std::vector<Departure>, decltype(later)> departures(
+        later);
+    auto release_until = [&gcs_resource_manager, &departures](int64_t time) {
+      while (!departures.empty() && departures.top().first <= time) {
+        for (const auto &bundle : departures.top().second) {
+          RAY_CHECK(gcs_resource_manager.ReleaseResources(bundle.first, bundle.second));
+        }
+        departures.pop();
+      }
+    };
+
+    SimulationResult result;
+    for (const auto &arrival : trace_) {
+      release_until(arrival.arrival_time);
+      int64_t start_us = current_sys_time_us();
+      auto scheduling_result =
+          gcs_resource_scheduler.Schedule(arrival.bundles, arrival.scheduling_type);
+      result.total_scheduling_time_us += current_sys_time_us() - start_us;
+      if (scheduling_result.first != gcs::SchedulingResultStatus::SUCCESS) {
+        result.num_failed++;
+        continue;
+      }
+      result.num_scheduled++;
+      Departure departure;
+      departure.first = arrival.arrival_time + arrival.lifetime;
+      for (size_t i = 0; i < arrival.bundles.size(); i++) {
+        RAY_CHECK(gcs_resource_manager.AcquireResources(scheduling_result.second[i],
+                                                        arrival.bundles[i]));
+        departure.second.emplace_back(scheduling_result.second[i], arrival.bundles[i]);
+      }
+      departures.push(std::move(departure));
+    }
+    release_until(std::numeric_limits<int64_t>::max());
+
+    // All the resources are back once every placement group has departed.
+    for (const auto &entry : gcs_resource_manager.GetClusterResources()) {
+      RAY_CHECK(entry.second.GetAvailableResources().IsEqual(
+          entry.second.GetTotalResources()));
+    }
+    return result;
+  }
+
+ private:
+  /// Add the nodes of a synthetic cluster: many small and medium CPU nodes and a few
+  /// large GPU nodes.
+  void AddClusterNodes(gcs::GcsResourceManager *gcs_resource_manager) {
+    auto add_nodes = [gcs_resource_manager](int num_nodes, double num_cpus,
+                                            double num_gpus) {
+      for (int i = 0; i < num_nodes; i++) {
+        absl::flat_hash_map<std::string, double> resource_map;
+        resource_map["CPU"] = num_cpus;
+        if (num_gpus > 0) {
+          resource_map["GPU"] = num_gpus;
+        }
+        gcs_resource_manager->UpdateResourceCapacity(NodeID::FromRandom(), resource_map);
+      }
+    };
+    add_nodes(/*num_nodes=*/8, /*num_cpus=*/8, /*num_gpus=*/0);
+    add_nodes(/*num_nodes=*/8, /*num_cpus=*/16, /*num_gpus=*/0);
+    add_nodes(/*num_nodes=*/4, /*num_cpus=*/32, /*num_gpus=*/4);
+  }
+
+  /// Generate a trace of placement groups that arrive one per time unit and keep the
+  /// cluster close to full.
+  std::vector<PlacementGroupArrival> GenTrace(int num_placement_groups) {
+    std::mt19937 gen(/*seed=*/42);
+    std::uniform_int_distribution<int64_t> lifetime_dist(20, 80);
+    std::uniform_int_distribution<int> num_bundles_dist(1, 6);
+    std::discrete_distribution<int> num_cpus_dist({4, 3, 2, 1});
+    std::bernoulli_distribution gpu_dist(0.1);
+    std::bernoulli_distribution pack_dist(0.5);
+    std::vector<PlacementGroupArrival> trace;
+    for (int i = 0; i < num_placement_groups; i++) {
+      PlacementGroupArrival arrival;
+      arrival.arrival_time = i;
+      arrival.lifetime = lifetime_dist(gen);
+      arrival.scheduling_type =
+          pack_dist(gen) ? gcs::SchedulingType::PACK : gcs::SchedulingType::SPREAD;
+      int num_bundles = num_bundles_dist(gen);
+      for (int j = 0; j < num_bundles; j++) {
+        absl::flat_hash_map<std::string, double> resource_map;
+        resource_map["CPU"] = 1 << num_cpus_dist(gen);
+        if (gpu_dist(gen)) {
+          resource_map["GPU"] = 1;
+        }
+        arrival.bundles.emplace_back(resource_map);
+      }
+      trace.push_back(std::move(arrival));
+    }
+    return trace;
+  }
+
+  std::vector<PlacementGroupArrival> LoadTrace(const std::string &path) {
+    std::ifstream file(path);
+    RAY_CHECK(file.is_open()) << "Failed to open trace file " << path;
+    std::vector<PlacementGroupArrival> trace;
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream stream(line);
+      PlacementGroupArrival arrival;
+      std::string strategy;
+      if (!(stream >> arrival.arrival_time >> arrival.lifetime >> strategy)) {
+        continue;
+      }
+      RAY_CHECK(strategy == "PACK" || strategy == "SPREAD")
+          << "Unsupported strategy " << strategy;
+      arrival.scheduling_type =
+          strategy == "PACK" ? gcs::SchedulingType::PACK : gcs::SchedulingType::SPREAD;
+      std::string bundle;
+      while (stream >> bundle) {
+        std::vector<std::string> amounts = absl::StrSplit(bundle, ':');
+        RAY_CHECK(amounts.size() == 2) << "Invalid bundle " << bundle;
+        absl::flat_hash_map<std::string, double> resource_map;
+        resource_map["CPU"] = std::stod(amounts[0]);
+        if (std::stod(amounts[1]) > 0) {
+          resource_map["GPU"] = std::stod(amounts[1]);
+        }
+        arrival.bundles.emplace_back(resource_map);
+      }
+      trace.push_back(std::move(arrival));
+    }
+    return trace;
+  }
+
+  std::vector<PlacementGroupArrival> trace_;
+  instrumented_io_context io_service_;
+};
+
+}  // namespace
+}  // namespace ray
+
+/// Replay a placement group arrival trace against a synthetic heterogeneous cluster,
+/// and print the placement success rate and the mean scheduling time per packing
+/// algorithm. The trace is generated, or read from the file passed as the argument.
+int main(int argc, char **argv) {
+  ray::PackingSimulation simulation(argc > 1 ? argv[1] : "");
+  const std::vector<std::pair<std::string, ray::gcs::PackingAlgorithm>>
+      packing_algorithms = {
+          {"greedy", ray::gcs::PackingAlgorithm::GREEDY},
+          {"best_fit_decreasing", ray::gcs::PackingAlgorithm::BEST_FIT_DECREASING},
+          {"bounded_search", ray::gcs::PackingAlgorithm::BOUNDED_SEARCH}};
+  for (const auto &entry : packing_algorithms) {
+    auto result = simulation.Replay(entry.second);
+    std::cout << entry.first << ": placed "
+              << 100.0 * result.num_scheduled / simulation.TraceSize() << "% of "
+              << simulation.TraceSize() << " placement groups, "
+              << static_cast<double>(result.total_scheduling_time_us) /
+                     simulation.TraceSize()
+              << "us per scheduling." << std::endl;
+  }
+  return 0;
+}
@@ -18,6 +18,7 @@
 
 #include "gtest/gtest.h"
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/resource_usage_delta.h"
 #include "ray/gcs/test/gcs_test_util.h"
 
 namespace ray {
@@ -86,6 +87,62 @@ TEST_F(GcsResourceManagerTest, TestResourceUsageAPI) {
   ASSERT_EQ(get_all_reply2.resource_usage_data().batch().size(), 0);
 }
 
+TEST_F(GcsResourceManagerTest, TestVersionedResourceReport) {
+  auto node = Mocker::GenNodeInfo();
+  auto node_id = NodeID::FromBinary(node->node_id());
+  gcs_resource_manager_->OnNodeAdd(*node);
+
+  rpc::ResourcesData v1;
+  v1.set_node_id(node->node_id());
+  v1.set_version(1);
+  (*v1.mutable_resources_total())["CPU"] = 4;
+  (*v1.mutable_resources_available())["CPU"] = 4;
+  (*v1.mutable_resources_total())["GPU"] = 1;
+  (*v1.mutable_resources_available())["GPU"] = 1;
+  ASSERT_TRUE(gcs_resource_manager_->UpdateFromResourceReport(v1));
+
+  auto v2 = v1;
+  v2.set_version(2);
+  (*v2.mutable_resources_available())["CPU"] = 1;
+  auto v3 = v2;
+  v3.set_version(3);
+  v3.mutable_resources_available()->erase("GPU");
+  rpc::ResourcesData d2, d3;
+  ASSERT_TRUE(ComputeResourceUsageDelta(v1, v2, &d2));
+  ASSERT_TRUE(ComputeResourceUsageDelta(v2, v3, &d3));
+
+  // A delta on top of a version that the GCS doesn't have is dropped.
+  ASSERT_FALSE(gcs_resource_manager_->UpdateFromResourceReport(d3));
+  ASSERT_TRUE(gcs_resource_manager_->UpdateFromResourceReport(d2));
+  ASSERT_TRUE(gcs_resource_manager_->UpdateFromResourceReport(d3));
+
+  const auto &available =
+      gcs_resource_manager_->GetClusterResources().at(node_id).GetAvailableResources();
+  ASSERT_EQ(available.GetResource("CPU").Double(), 1);
+  ASSERT_EQ(available.GetResource("GPU").Double(), 0);
+
+  // The full view is stored for receivers that need to resync.
+  rpc::GetAllResourceUsageReply get_all_reply;
+  gcs_resource_manager_->HandleGetAllResourceUsage(
+      rpc::GetAllResourceUsageRequest(), &get_all_reply,
+      [](ray::Status status, std::function<void()> f1, std::function<void()> f2) {});
+  ASSERT_EQ(get_all_reply.resource_usage_data().batch().size(), 1);
+  const auto &view = get_all_reply.resource_usage_data().batch(0);
+  ASSERT_FALSE(view.is_delta());
+  ASSERT_EQ(view.version(), 3);
+  ASSERT_EQ(view.resources_available().count("GPU"), 0);
+
+  // The deltas that weren't broadcast yet are merged into one on top of the full
+  // report.
+  rpc::ResourceUsageBroadcastData broadcast;
+  gcs_resource_manager_->GetResourceUsageBatchForBroadcast(broadcast);
+  ASSERT_EQ(broadcast.batch().size(), 1);
+  const auto &forwarded = broadcast.batch(0).data();
+  ASSERT_FALSE(forwarded.is_delta());
+  ASSERT_EQ(forwarded.version(), 3);
+  ASSERT_EQ(forwarded.resources_available().at("CPU"), 1);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -28,13 +28,18 @@ class GcsResourceReportPollerTest : public ::testing::Test {
   GcsResourceReportPollerTest()
       : current_time_(0),
         gcs_resource_report_poller_(
-            nullptr, [](const rpc::ResourcesData &) {},
+            nullptr,
+            [this](const rpc::ResourcesData &data) {
+              return handle_resource_report_ ? handle_resource_report_(data) : true;
+            },
             [this]() { return current_time_; },
             [this](const rpc::Address &address,
                    std::shared_ptr<rpc::NodeManagerClientPool> &client_pool,
+                   int64_t last_applied_version,
                    std::function<void(const Status &,
                                       const rpc::RequestResourceReportReply &)>
                        callback) {
+              last_applied_version_ = last_applied_version;
               if (request_report_) {
                 request_report_(address, client_pool, callback);
               }
@@ -55,6 +60,8 @@ class GcsResourceReportPollerTest : public ::testing::Test {
   }
 
   int64_t current_time_;
+  int64_t last_applied_version_ = -1;
+  std::function<bool(const rpc::ResourcesData &)> handle_resource_report_;
   std::function<void(
       const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &,
       std::function<void(const Status &, const rpc::RequestResourceReportReply &)>)>
@@ -95,6 +102,38 @@ TEST_F(GcsResourceReportPollerTest, TestBasic) {
   ASSERT_TRUE(rpc_sent);
 }
 
+TEST_F(GcsResourceReportPollerTest, TestLastAppliedVersion) {
+  bool applied = true;
+  handle_resource_report_ = [&applied](const rpc::ResourcesData &) { return applied; };
+  int64_t version = 0;
+  request_report_ =
+      [&version](
+          const rpc::Address &, std::shared_ptr<rpc::NodeManagerClientPool> &,
+          std::function<void(const Status &, const rpc::RequestResourceReportReply &)>
+              callback) {
+        rpc::RequestResourceReportReply reply;
+        reply.mutable_resources()->set_version(++version);
+        callback(Status::OK(), reply);
+      };
+
+  auto node_info = Mocker::GenNodeInfo();
+  gcs_resource_report_poller_.HandleNodeAdded(*node_info);
+  RunPollingService();
+  // The first pull asks for a full report.
+  ASSERT_EQ(last_applied_version_, 0);
+
+  // The next pull asks for a delta on top of the report that was applied.
+  applied = false;
+  Tick(100);
+  RunPollingService();
+  ASSERT_EQ(last_applied_version_, 1);
+
+  // The report was dropped, so the next pull asks for a full report again.
+  Tick(100);
+  RunPollingService();
+  ASSERT_EQ(last_applied_version_, 0);
+}
+
 TEST_F(GcsResourceReportPollerTest, TestFailedRpc) {
   bool rpc_sent = false;
   request_report_ =
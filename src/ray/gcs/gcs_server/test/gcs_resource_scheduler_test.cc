@@ -45,6 +45,14 @@ class GcsResourceSchedulerTest : public ::testing::Test {
     gcs_resource_manager_->UpdateResourceCapacity(node_id, resource_map);
   }
 
+  NodeID AddNodeWithTopologyPath(const std::string &topology_path, double num_cpus) {
+    auto node = Mocker::GenNodeInfo();
+    node->set_topology_path(topology_path);
+    (*node->mutable_resources_total())["CPU"] = num_cpus;
+    gcs_resource_manager_->OnNodeAdd(*node);
+    return NodeID::FromBinary(node->node_id());
+  }
+
   void CheckClusterAvailableResources(const NodeID &node_id,
                                       const std::string &resource_name,
                                       double resource_value) {
@@ -55,6 +63,16 @@ class GcsResourceSchedulerTest : public ::testing::Test {
               resource_value);
   }
 
+  std::vector<ResourceSet> GenCpuResourcesList(const std::vector<double> &cpu_nums) {
+    std::vector<ResourceSet> required_resources_list;
+    for (double cpu_num : cpu_nums) {
+      absl::flat_hash_map<std::string, double> resource_map;
+      resource_map["CPU"] = cpu_num;
+      required_resources_list.emplace_back(resource_map);
+    }
+    return required_resources_list;
+  }
+
   void TestResourceLeaks(const gcs::SchedulingType &scheduling_type) {
     // Add node resources.
     const auto &node_id = NodeID::FromRandom();
@@ -104,6 +122,30 @@ TEST_F(GcsResourceSchedulerTest, TestSpreadScheduleResourceLeaks) {
   TestResourceLeaks(gcs::SchedulingType::SPREAD);
 }
 
+TEST_F(GcsResourceSchedulerTest, TestBestFitDecreasingPackScheduleResourceLeaks) {
+  gcs_resource_scheduler_->SetPackingAlgorithm(
+      gcs::SchedulingType::PACK, gcs::PackingAlgorithm::BEST_FIT_DECREASING);
+  TestResourceLeaks(gcs::SchedulingType::PACK);
+}
+
+TEST_F(GcsResourceSchedulerTest, TestBestFitDecreasingSpreadScheduleResourceLeaks) {
+  gcs_resource_scheduler_->SetPackingAlgorithm(
+      gcs::SchedulingType::SPREAD, gcs::PackingAlgorithm::BEST_FIT_DECREASING);
+  TestResourceLeaks(gcs::SchedulingType::SPREAD);
+}
+
+TEST_F(GcsResourceSchedulerTest, TestBoundedSearchPackScheduleResourceLeaks) {
+  gcs_resource_scheduler_->SetPackingAlgorithm(gcs::SchedulingType::PACK,
+                                               gcs::PackingAlgorithm::BOUNDED_SEARCH);
+  TestResourceLeaks(gcs::SchedulingType::PACK);
+}
+
+TEST_F(GcsResourceSchedulerTest, TestBoundedSearchSpreadScheduleResourceLeaks) {
+  gcs_resource_scheduler_->SetPackingAlgorithm(gcs::SchedulingType::SPREAD,
+                                               gcs::PackingAlgorithm::BOUNDED_SEARCH);
+  TestResourceLeaks(gcs::SchedulingType::SPREAD);
+}
+
 TEST_F(GcsResourceSchedulerTest, TestNodeFilter) {
   // Add node resources.
   const auto &node_id = NodeID::FromRandom();
@@ -173,6 +215,131 @@ TEST_F(GcsResourceSchedulerTest, TestSchedulingResultStatusForStrictStrategy) {
   CheckClusterAvailableResources(node_tow_id, cpu_resource, node_cpu_num);
 }
 
+TEST_F(GcsResourceSchedulerTest, TestSpreadScheduleAcrossTopologyGroups) {
+  // The nodes of the first rack have the most resources, so they'd be picked first
+  // without the topology.
+  const auto &rack_one_node_one_id = AddNodeWithTopologyPath("z1/r1", 4);
+  const auto &rack_one_node_two_id = AddNodeWithTopologyPath("z1/r1", 4);
+  const auto &rack_two_node_id = AddNodeWithTopologyPath("z1/r2", 2);
+  const auto &zone_two_node_id = AddNodeWithTopologyPath("z2/r1", 2);
+
+  std::vector<ResourceSet> required_resources_list;
+  absl::flat_hash_map<std::string, double> resource_map;
+  resource_map["CPU"] = 1;
+  for (int bundle_number = 0; bundle_number < 3; bundle_number++) {
+    required_resources_list.emplace_back(resource_map);
+  }
+
+  for (const auto &scheduling_type :
+       {gcs::SchedulingType::SPREAD, gcs::SchedulingType::STRICT_SPREAD}) {
+    const auto &result =
+        gcs_resource_scheduler_->Schedule(required_resources_list, scheduling_type);
+    ASSERT_TRUE(result.first == gcs::SchedulingResultStatus::SUCCESS);
+    ASSERT_EQ(result.second.size(), 3);
+    // The bundles spread across zones first, and then across racks.
+    ASSERT_TRUE(result.second[0] == rack_one_node_one_id ||
+                result.second[0] == rack_one_node_two_id);
+    ASSERT_EQ(result.second[1], zone_two_node_id);
+    ASSERT_EQ(result.second[2], rack_two_node_id);
+  }
+}
+
+TEST_F(GcsResourceSchedulerTest, TestPackScheduleWithinTopologyGroup) {
+  // The node in the second zone has the most resources, but only the first rack can
+  // host all the bundles.
+  const auto &rack_one_node_one_id = AddNodeWithTopologyPath("z1/r1", 3);
+  const auto &rack_one_node_two_id = AddNodeWithTopologyPath("z1/r1", 3);
+  AddNodeWithTopologyPath("z1/r2", 3);
+  AddNodeWithTopologyPath("z2/r1", 3.5);
+
+  std::vector<ResourceSet> required_resources_list;
+  absl::flat_hash_map<std::string, double> resource_map;
+  resource_map["CPU"] = 1;
+  for (int bundle_number = 0; bundle_number < 4; bundle_number++) {
+    required_resources_list.emplace_back(resource_map);
+  }
+
+  const auto &result = gcs_resource_scheduler_->Schedule(required_resources_list,
+                                                         gcs::SchedulingType::PACK);
+  ASSERT_TRUE(result.first == gcs::SchedulingResultStatus::SUCCESS);
+  ASSERT_EQ(result.second.size(), 4);
+  for (const auto &node_id : result.second) {
+    ASSERT_TRUE(node_id == rack_one_node_one_id || node_id == rack_one_node_two_id);
+  }
+}
+
+TEST_F(GcsResourceSchedulerTest, TestBestFitDecreasingPackSchedule) {
+  const auto &large_node_id = NodeID::FromRandom();
+  AddClusterResources(large_node_id, "CPU", 4);
+  const auto &small_node_id = NodeID::FromRandom();
+  AddClusterResources(small_node_id, "CPU", 2);
+  auto required_resources_list = GenCpuResourcesList({1, 1, 4});
+
+  // The small bundles fragment the large node, so the large bundle doesn't fit.
+  auto result = gcs_resource_scheduler_->Schedule(required_resources_list,
+                                                  gcs::SchedulingType::PACK);
+  ASSERT_TRUE(result.first == gcs::SchedulingResultStatus::FAILED);
+
+  gcs_resource_scheduler_->SetPackingAlgorithm(
+      gcs::SchedulingType::PACK, gcs::PackingAlgorithm::BEST_FIT_DECREASING);
+  result = gcs_resource_scheduler_->Schedule(required_resources_list,
+                                             gcs::SchedulingType::PACK);
+  ASSERT_TRUE(result.first == gcs::SchedulingResultStatus::SUCCESS);
+  ASSERT_EQ(result.second[0], small_node_id);
+  ASSERT_EQ(result.second[1], small_node_id);
+  ASSERT_EQ(result.second[2], large_node_id);
+  CheckClusterAvailableResources(large_node_id, "CPU", 4);
+  CheckClusterAvailableResources(small_node_id, "CPU", 2);
+}
+
+TEST_F(GcsResourceSchedulerTest, TestBestFitDecreasingSpreadSchedule) {
+  const auto &large_node_id = NodeID::FromRandom();
+  AddClusterResources(large_node_id, "CPU", 8);
+  const auto &small_node_id = NodeID::FromRandom();
+  AddClusterResources(small_node_id, "CPU", 2);
+  auto required_resources_list = GenCpuResourcesList({1, 8});
+
+  // The small bundle takes the node with the most resources left.
+  auto result = gcs_resource_scheduler_->Schedule(required_resources_list,
+                                                  gcs::SchedulingType::SPREAD);
+  ASSERT_TRUE(result.first == gcs::SchedulingResultStatus::FAILED);
+
+  gcs_resource_scheduler_->SetPackingAlgorithm(
+      gcs::SchedulingType::SPREAD, gcs::PackingAlgorithm::BEST_FIT_DECREASING);
+  result = gcs_resource_scheduler_->Schedule(required_resources_list,
+                                             gcs::SchedulingType::SPREAD);
+  ASSERT_TRUE(result.first == gcs::SchedulingResultStatus::SUCCESS);
+  ASSERT_EQ(result.second[0], small_node_id);
+  ASSERT_EQ(result.second[1], large_node_id);
+}
+
+TEST_F(GcsResourceSchedulerTest, TestBoundedSearchPackSchedule) {
+  const auto &node_one_id = NodeID::FromRandom();
+  AddClusterResources(node_one_id, "CPU", 10);
+  const auto &node_two_id = NodeID::FromRandom();
+  AddClusterResources(node_two_id, "CPU", 10);
+  // The bundles only fit as {5, 3, 2} and {4, 4, 2}, which best fit decreasing misses.
+  auto required_resources_list = GenCpuResourcesList({5, 4, 4, 3, 2, 2});
+
+  gcs_resource_scheduler_->SetPackingAlgorithm(
+      gcs::SchedulingType::PACK, gcs::PackingAlgorithm::BEST_FIT_DECREASING);
+  auto result = gcs_resource_scheduler_->Schedule(required_resources_list,
+                                                  gcs::SchedulingType::PACK);
+  ASSERT_TRUE(result.first == gcs::SchedulingResultStatus::FAILED);
+
+  gcs_resource_scheduler_->SetPackingAlgorithm(gcs::SchedulingType::PACK,
+                                               gcs::PackingAlgorithm::BOUNDED_SEARCH);
+  result = gcs_resource_scheduler_->Schedule(required_resources_list,
+                                             gcs::SchedulingType::PACK);
+  ASSERT_TRUE(result.first == gcs::SchedulingResultStatus::SUCCESS);
+  ASSERT_EQ(result.second.size(), 6);
+  ASSERT_EQ(result.second[0], result.second[3]);
+  ASSERT_EQ(result.second[1], result.second[2]);
+  ASSERT_NE(result.second[0], result.second[1]);
+  CheckClusterAvailableResources(node_one_id, "CPU", 10);
+  CheckClusterAvailableResources(node_two_id, "CPU", 10);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
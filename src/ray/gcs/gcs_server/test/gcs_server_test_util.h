@@ -269,13 +269,14 @@ struct GcsServerMocker {
 
     /// ResourceUsageInterface
     void RequestResourceReport(
+        int64_t last_applied_version,
         const rpc::ClientCallback<rpc::RequestResourceReportReply> &callback) override {
       RAY_CHECK(false) << "Unused";
     };
 
     /// ResourceUsageInterface
     void UpdateResourceUsage(
-        std::string &address,
+        std::string &address, const std::vector<rpc::Address> &relay_addresses,
         const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) override {
       RAY_CHECK(false) << "Unused";
     };
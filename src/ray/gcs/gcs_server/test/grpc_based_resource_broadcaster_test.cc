@@ -15,9 +15,12 @@
 
 #include "ray/gcs/gcs_server/grpc_based_resource_broadcaster.h"
 
+#include <cmath>
 #include <memory>
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
+#include "ray/common/broadcast_tree.h"
 #include "ray/gcs/test/gcs_test_util.h"
 
 namespace ray {
@@ -43,13 +46,76 @@ class GrpcBasedResourceBroadcasterTest : public ::testing::Test {
             /*send_batch*/
             [this](const rpc::Address &address,
                    std::shared_ptr<rpc::NodeManagerClientPool> &pool, std::string &data,
+                   const std::vector<rpc::Address> &relay_addresses,
                    const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) {
               num_batches_sent_++;
               callbacks_.push_back(callback);
             }) {}
 
+  void TearDown() override {
+    RayConfig::instance().initialize(R"({"resource_broadcast_relay_fanout": 0})");
+  }
+
   void SendBroadcast() { broadcaster_.SendBroadcast(); }
 
+  struct SentBatch {
+    rpc::Address address;
+    size_t size;
+    std::vector<rpc::Address> relay_addresses;
+    rpc::ClientCallback<rpc::UpdateResourceUsageReply> callback;
+  };
+
+  /// Create a broadcaster that relays batches along a tree with the given fanout and
+  /// records the batches it sends in `sent`.
+  std::unique_ptr<GrpcBasedResourceBroadcaster> CreateRelayingBroadcaster(
+      uint64_t fanout, int batch_size, std::deque<SentBatch> *sent) {
+    RayConfig::instance().initialize(
+        absl::StrCat(R"({"resource_broadcast_relay_fanout": )", fanout, "}"));
+    return std::make_unique<GrpcBasedResourceBroadcaster>(
+        /*raylet_client_pool*/ nullptr,
+        /*get_resource_usage_batch_for_broadcast*/
+        [batch_size](rpc::ResourceUsageBroadcastData &batch) {
+          for (int i = 0; i < batch_size; i++) {
+            auto data = batch.add_batch()->mutable_data();
+            data->set_node_id(NodeID::FromRandom().Binary());
+            (*data->mutable_resources_available())["CPU"] = 8;
+            (*data->mutable_resources_total())["CPU"] = 16;
+            (*data->mutable_resources_total())["memory"] = 64ULL << 30;
+          }
+        },
+        /*send_batch*/
+        [sent](const rpc::Address &address,
+               std::shared_ptr<rpc::NodeManagerClientPool> &pool, std::string &data,
+               const std::vector<rpc::Address> &relay_addresses,
+               const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) {
+          sent->push_back({address, data.size(), relay_addresses, callback});
+        });
+  }
+
+  void SendBroadcast(GrpcBasedResourceBroadcaster &broadcaster) {
+    broadcaster.SendBroadcast();
+  }
+
+  /// Relay a batch the way raylets do, and return the number of hops it takes to reach
+  /// each node.
+  absl::flat_hash_map<std::string, int> SimulateRelay(const std::deque<SentBatch> &sent,
+                                                      uint64_t fanout) {
+    absl::flat_hash_map<std::string, int> hops;
+    std::deque<std::pair<std::pair<rpc::Address, std::vector<rpc::Address>>, int>> queue;
+    for (const auto &batch : sent) {
+      queue.push_back({{batch.address, batch.relay_addresses}, 1});
+    }
+    while (!queue.empty()) {
+      auto entry = queue.front();
+      queue.pop_front();
+      EXPECT_TRUE(hops.emplace(entry.first.first.raylet_id(), entry.second).second);
+      for (auto &subtree : SplitBroadcastTree(entry.first.second, fanout)) {
+        queue.push_back({subtree, entry.second + 1});
+      }
+    }
+    return hops;
+  }
+
   void AssertNoLeaks() {
     absl::MutexLock guard(&broadcaster_.mutex_);
     ASSERT_EQ(broadcaster_.nodes_.size(), 0);
@@ -88,5 +154,119 @@ TEST_F(GrpcBasedResourceBroadcasterTest, TestNodeRemoval) {
   AssertNoLeaks();
 }
 
+TEST_F(GrpcBasedResourceBroadcasterTest, TestRelayTree) {
+  std::deque<SentBatch> sent;
+  auto broadcaster = CreateRelayingBroadcaster(/*fanout=*/4, /*batch_size=*/1, &sent);
+  for (int i = 0; i < 100; i++) {
+    broadcaster->HandleNodeAdded(*Mocker::GenNodeInfo());
+  }
+  SendBroadcast(*broadcaster);
+  // The GCS only sends to the first level of the tree.
+  ASSERT_EQ(sent.size(), 4);
+  auto hops = SimulateRelay(sent, /*fanout=*/4);
+  // Every node gets the batch exactly once.
+  ASSERT_EQ(hops.size(), 100);
+  int max_hops = 0;
+  for (const auto &entry : hops) {
+    max_hops = std::max(max_hops, entry.second);
+  }
+  ASSERT_LE(max_hops, 4);
+
+  // The tree is the same in every round.
+  std::deque<SentBatch> first_round = std::move(sent);
+  sent.clear();
+  SendBroadcast(*broadcaster);
+  ASSERT_EQ(sent.size(), first_round.size());
+  for (size_t i = 0; i < sent.size(); i++) {
+    ASSERT_EQ(sent[i].address.raylet_id(), first_round[i].address.raylet_id());
+    ASSERT_EQ(sent[i].relay_addresses.size(), first_round[i].relay_addresses.size());
+  }
+}
+
+TEST_F(GrpcBasedResourceBroadcasterTest, TestRelayFailure) {
+  std::deque<SentBatch> sent;
+  auto broadcaster = CreateRelayingBroadcaster(/*fanout=*/2, /*batch_size=*/1, &sent);
+  for (int i = 0; i < 10; i++) {
+    broadcaster->HandleNodeAdded(*Mocker::GenNodeInfo());
+  }
+  SendBroadcast(*broadcaster);
+  ASSERT_EQ(sent.size(), 2);
+  auto failed = sent.front();
+  sent.clear();
+  ASSERT_EQ(failed.relay_addresses.size(), 4);
+
+  // The GCS takes over the subtree of a relay that it can't reach.
+  failed.callback(Status::IOError("Unreachable"), rpc::UpdateResourceUsageReply());
+  ASSERT_EQ(sent.size(), 2);
+  auto hops = SimulateRelay(sent, /*fanout=*/2);
+  ASSERT_EQ(hops.size(), failed.relay_addresses.size());
+  for (const auto &address : failed.relay_addresses) {
+    ASSERT_TRUE(hops.contains(address.raylet_id()));
+  }
+
+  // Replies from healthy relays don't resend anything.
+  sent.front().callback(Status::OK(), rpc::UpdateResourceUsageReply());
+  ASSERT_EQ(sent.size(), 2);
+}
+
+/// Compare the outbound bandwidth of the GCS and the staleness of the resource view of
+/// the last node to get a broadcast, in a simulated large cluster. Direct broadcasts
+/// are limited by the bandwidth of the GCS, which has to send the whole batch to every
+/// node, and relayed broadcasts by the number of hops.
+TEST_F(GrpcBasedResourceBroadcasterTest, TestRelayTreeSimulation) {
+  const int num_nodes = 2000;
+  const uint64_t relay_fanout = 8;
+  const double link_bytes_per_ms = 1.25e6;  // 10 Gbps.
+  const double hop_latency_ms = 0.5;
+  const double rounds_per_s =
+      1000. / RayConfig::instance().raylet_report_resources_period_milliseconds();
+
+  auto simulate = [&](uint64_t fanout, double *gcs_bytes_per_s,
+                      double *max_staleness_ms) {
+    std::deque<SentBatch> sent;
+    auto broadcaster = CreateRelayingBroadcaster(fanout, num_nodes, &sent);
+    for (int i = 0; i < num_nodes; i++) {
+      broadcaster->HandleNodeAdded(*Mocker::GenNodeInfo());
+    }
+    SendBroadcast(*broadcaster);
+    size_t batch_size = sent.front().size;
+    double gcs_bytes = 0;
+    for (const auto &batch : sent) {
+      rpc::UpdateResourceUsageRequest request;
+      for (const auto &address : batch.relay_addresses) {
+        request.add_relay_addresses()->CopyFrom(address);
+      }
+      gcs_bytes += batch.size + request.ByteSizeLong();
+    }
+    *gcs_bytes_per_s = gcs_bytes * rounds_per_s;
+    if (fanout == 0) {
+      // The GCS sends the batches back to back.
+      *max_staleness_ms = gcs_bytes / link_bytes_per_ms + hop_latency_ms;
+      return;
+    }
+    auto hops = SimulateRelay(sent, fanout);
+    EXPECT_EQ(hops.size(), num_nodes);
+    int max_hops = 0;
+    for (const auto &entry : hops) {
+      max_hops = std::max(max_hops, entry.second);
+    }
+    // Every hop sends the batch to `fanout` children back to back.
+    *max_staleness_ms =
+        max_hops * (fanout * batch_size / link_bytes_per_ms + hop_latency_ms);
+  };
+
+  double direct_bytes_per_s, direct_staleness_ms;
+  simulate(/*fanout=*/0, &direct_bytes_per_s, &direct_staleness_ms);
+  double relay_bytes_per_s, relay_staleness_ms;
+  simulate(relay_fanout, &relay_bytes_per_s, &relay_staleness_ms);
+  RAY_LOG(INFO) << num_nodes << " nodes, direct: " << direct_bytes_per_s / 1e6
+                << " MB/s from the GCS, " << direct_staleness_ms
+                << " ms max staleness. Relayed with fanout " << relay_fanout << ": "
+                << relay_bytes_per_s / 1e6 << " MB/s from the GCS, "
+                << relay_staleness_ms << " ms max staleness.";
+  ASSERT_LT(relay_bytes_per_s * 100, direct_bytes_per_s);
+  ASSERT_LT(relay_staleness_ms, direct_staleness_ms);
+}
+
 }  // namespace gcs
 }  // namespace ray
@@ -122,6 +122,42 @@ TEST_F(RayletBasedActorSchedulerTest, TestScheduleActorSuccess) {
   ASSERT_EQ(actor->GetWorkerID(), worker_id);
 }
 
+TEST_F(RayletBasedActorSchedulerTest, TestScheduleBatch) {
+  auto node = Mocker::GenNodeInfo();
+  auto node_id = NodeID::FromBinary(node->node_id());
+  gcs_node_manager_->AddNode(node);
+  ASSERT_EQ(1, gcs_node_manager_->GetAllAliveNodes().size());
+
+  auto job_id = JobID::FromInt(1);
+  std::vector<std::shared_ptr<gcs::GcsActor>> actors;
+  for (int i = 0; i < 3; i++) {
+    auto create_actor_request = Mocker::GenCreateActorRequest(job_id);
+    actors.emplace_back(
+        std::make_shared<gcs::GcsActor>(create_actor_request.task_spec(), ""));
+  }
+
+  // Schedule the batch, and the lease requests of all actors should be sent to the node.
+  gcs_actor_scheduler_->ScheduleBatch(actors);
+  ASSERT_EQ(3, raylet_client_->num_workers_requested);
+  ASSERT_EQ(3, raylet_client_->callbacks.size());
+  for (const auto &actor : actors) {
+    ASSERT_EQ(actor->GetNodeID(), node_id);
+  }
+
+  // Grant the workers and reply the actor creation requests.
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(raylet_client_->GrantWorkerLease(node->node_manager_address(),
+                                                 node->node_manager_port(),
+                                                 WorkerID::FromRandom(), node_id,
+                                                 NodeID::Nil()));
+  }
+  ASSERT_EQ(3, worker_client_->callbacks.size());
+  while (worker_client_->ReplyPushTask()) {
+  }
+  ASSERT_EQ(0, failure_actors_.size());
+  ASSERT_EQ(3, success_actors_.size());
+}
+
 TEST_F(RayletBasedActorSchedulerTest, TestScheduleRetryWhenLeasing) {
   auto node = Mocker::GenNodeInfo();
   auto node_id = NodeID::FromBinary(node->node_id());
@@ -0,0 +1,226 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+#include "ray/common/test_util.h"
+#include "ray/gcs/gcs_server/gcs_table_storage.h"
+#include "ray/gcs/gcs_server/test/gcs_table_storage_test_base.h"
+#include "ray/gcs/store_client/in_memory_store_client.h"
+#include "ray/gcs/store_client/write_coalescing_store_client.h"
+
+namespace ray {
+
+namespace gcs {
+
+/// An in memory store client that counts the write operations and the keys written.
+class CountingStoreClient : public InMemoryStoreClient {
+ public:
+  explicit CountingStoreClient(instrumented_io_context &io_service)
+      : InMemoryStoreClient(io_service) {}
+
+  Status AsyncPutWithIndex(const std::string &table_name, const std::string &key,
+                           const std::string &index_key, const std::string &data,
+                           const StatusCallback &callback) override {
+    if (counting_) {
+      ++num_write_ops_;
+      ++num_keys_written_;
+    }
+    return InMemoryStoreClient::AsyncPutWithIndex(table_name, key, index_key, data,
+                                                  callback);
+  }
+
+  Status AsyncBatchPut(const std::string &table_name,
+                       const std::vector<std::string> &keys,
+                       const std::vector<std::string> &index_keys,
+                       const std::vector<std::string> &data,
+                       const StatusCallback &callback) override {
+    ++num_write_ops_;
+    num_keys_written_ += keys.size();
+    // Don't count the writes that the default implementation forwards to.
+    counting_ = false;
+    auto status =
+        StoreClient::AsyncBatchPut(table_name, keys, index_keys, data, callback);
+    counting_ = true;
+    return status;
+  }
+
+  void ResetCounts() {
+    num_write_ops_ = 0;
+    num_keys_written_ = 0;
+  }
+
+  std::atomic<int> num_write_ops_{0};
+  std::atomic<int> num_keys_written_{0};
+
+ private:
+  std::atomic<bool> counting_{true};
+};
+
+class WriteCoalescingGcsTableStorageTest : public GcsTableStorageTestBase {
+ public:
+  void SetUp() override {
+    store_client_ = std::make_shared<CountingStoreClient>(*(io_service_pool_->Get()));
+    coalescing_store_client_ = std::make_shared<WriteCoalescingStoreClient>(
+        *(io_service_pool_->Get()), store_client_, flush_interval_ms_, max_batch_size_);
+    gcs_table_storage_ = std::make_shared<GcsTableStorage>(coalescing_store_client_);
+  }
+
+ protected:
+  /// Put the states of an actor lifecycle, without waiting for the writes.
+  void PutActorLifecycle(const std::vector<std::shared_ptr<rpc::ActorTableData>> &actors,
+                         std::atomic<int> *pending_count) {
+    const std::vector<rpc::ActorTableData::ActorState> states = {
+        rpc::ActorTableData::DEPENDENCIES_UNREADY, rpc::ActorTableData::PENDING_CREATION,
+        rpc::ActorTableData::ALIVE,                rpc::ActorTableData::RESTARTING,
+        rpc::ActorTableData::ALIVE,                rpc::ActorTableData::DEAD};
+    for (auto state : states) {
+      for (const auto &actor : actors) {
+        actor->set_state(state);
+        ++(*pending_count);
+        RAY_CHECK_OK(gcs_table_storage_->ActorTable().Put(
+            ActorID::FromBinary(actor->actor_id()), *actor,
+            [pending_count](const Status &status) {
+              RAY_CHECK_OK(status);
+              --(*pending_count);
+            }));
+      }
+    }
+  }
+
+  uint32_t flush_interval_ms_ = 5;
+  size_t max_batch_size_ = 1000;
+  std::shared_ptr<CountingStoreClient> store_client_;
+  std::shared_ptr<WriteCoalescingStoreClient> coalescing_store_client_;
+};
+
+TEST_F(WriteCoalescingGcsTableStorageTest, TestGcsTableApi) { TestGcsTableApi(); }
+
+TEST_F(WriteCoalescingGcsTableStorageTest, TestGcsTableWithJobIdApi) {
+  TestGcsTableWithJobIdApi();
+}
+
+TEST_F(WriteCoalescingGcsTableStorageTest, TestReadBufferedWrites) {
+  // Don't flush on the timer.
+  flush_interval_ms_ = 60 * 1000;
+  SetUp();
+  auto &table = gcs_table_storage_->ActorTable();
+  JobID job_id = JobID::FromInt(1);
+  auto actor1 = Mocker::GenActorTableData(job_id);
+  auto actor2 = Mocker::GenActorTableData(job_id);
+  ActorID actor_id1 = ActorID::FromBinary(actor1->actor_id());
+  ActorID actor_id2 = ActorID::FromBinary(actor2->actor_id());
+
+  std::atomic<int> num_written(0);
+  auto on_written = [&num_written](const Status &status) {
+    RAY_CHECK_OK(status);
+    ++num_written;
+  };
+  RAY_CHECK_OK(table.Put(actor_id1, *actor1, on_written));
+  RAY_CHECK_OK(table.Put(actor_id2, *actor2, on_written));
+  ASSERT_EQ(coalescing_store_client_->NumBufferedWrites(), 2);
+  ASSERT_EQ(store_client_->num_write_ops_, 0);
+
+  // The buffered writes are visible before they are flushed.
+  std::vector<rpc::ActorTableData> values;
+  ASSERT_EQ(Get(table, actor_id1, values), 1);
+  ASSERT_EQ(GetByJobId(table, job_id, actor_id1, values), 2);
+
+  // Deleting a key drops its buffered write, whose callback is called with the delete.
+  Delete(table, actor_id1);
+  ASSERT_EQ(Get(table, actor_id1, values), 0);
+  ASSERT_EQ(GetByJobId(table, job_id, actor_id1, values), 1);
+  ASSERT_EQ(num_written, 1);
+  ASSERT_EQ(coalescing_store_client_->NumBufferedWrites(), 1);
+
+  coalescing_store_client_->Flush();
+  ASSERT_TRUE(WaitForCondition([&num_written]() { return num_written == 2; }, 5000));
+  ASSERT_EQ(coalescing_store_client_->NumBufferedWrites(), 0);
+  ASSERT_EQ(Get(table, actor_id2, values), 1);
+  ASSERT_EQ(store_client_->num_write_ops_, 1);
+}
+
+TEST_F(WriteCoalescingGcsTableStorageTest, TestFlushOnBatchSize) {
+  flush_interval_ms_ = 60 * 1000;
+  max_batch_size_ = 10;
+  SetUp();
+  std::atomic<int> pending_count(0);
+  std::vector<std::shared_ptr<rpc::ActorTableData>> actors;
+  for (size_t i = 0; i < max_batch_size_ * 3; i++) {
+    actors.push_back(Mocker::GenActorTableData(JobID::FromInt(1)));
+  }
+  PutActorLifecycle(actors, &pending_count);
+  // Each key is written once per lifecycle state, and flushed once the batch is full.
+  WaitPendingDone(pending_count);
+  ASSERT_EQ(coalescing_store_client_->NumBufferedWrites(), 0);
+  ASSERT_EQ(store_client_->num_write_ops_, 6 * 3);
+}
+
+/// Measure the storage operations per actor lifecycle, with and without coalescing,
+/// when a burst of actors goes through their lifecycle at once.
+TEST_F(WriteCoalescingGcsTableStorageTest, TestStorageOpsPerActorLifecycle) {
+  const int num_actors = 1000;
+  std::vector<std::shared_ptr<rpc::ActorTableData>> actors;
+  for (int i = 0; i < num_actors; i++) {
+    actors.push_back(Mocker::GenActorTableData(JobID::FromInt(1)));
+  }
+
+  // Without coalescing.
+  std::atomic<int> pending_count(0);
+  gcs_table_storage_ = std::make_shared<GcsTableStorage>(store_client_);
+  PutActorLifecycle(actors, &pending_count);
+  WaitPendingDone(pending_count);
+  const double ops = 1.0 * store_client_->num_write_ops_ / num_actors;
+  const double keys = 1.0 * store_client_->num_keys_written_ / num_actors;
+
+  // With coalescing.
+  store_client_->ResetCounts();
+  flush_interval_ms_ = 10;
+  max_batch_size_ = 10 * num_actors;
+  SetUp();
+  PutActorLifecycle(actors, &pending_count);
+  WaitPendingDone(pending_count);
+  const double coalesced_ops = 1.0 * store_client_->num_write_ops_ / num_actors;
+  const double coalesced_keys = 1.0 * store_client_->num_keys_written_ / num_actors;
+
+  RAY_LOG(INFO) << "Storage ops per actor lifecycle: " << ops << " round trips and "
+                << keys << " records without coalescing, " << coalesced_ops
+                << " round trips and " << coalesced_keys << " records with coalescing.";
+  ASSERT_EQ(ops, 6);
+  ASSERT_LT(coalesced_ops, 0.1);
+  ASSERT_LT(coalesced_keys, keys);
+
+  // The last state of every actor is written.
+  std::unordered_map<ActorID, rpc::ActorTableData> result;
+  ++pending_count;
+  RAY_CHECK_OK(gcs_table_storage_->ActorTable().GetAll(
+      [&result, &pending_count](
+          const std::unordered_map<ActorID, rpc::ActorTableData> &values) {
+        result = values;
+        --pending_count;
+      }));
+  WaitPendingDone(pending_count);
+  ASSERT_EQ(result.size(), num_actors);
+  for (const auto &entry : result) {
+    ASSERT_EQ(entry.second.state(), rpc::ActorTableData::DEAD);
+  }
+}
+
+}  // namespace gcs
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
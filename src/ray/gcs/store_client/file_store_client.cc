@@ -0,0 +1,520 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/file_store_client.h"
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "boost/filesystem.hpp"
+#include "ray/common/id.h"
+#include "ray/util/filesystem.h"
+#include "ray/util/util.h"
+
+namespace ray {
+
+namespace gcs {
+
+namespace {
+
+/// Each record is framed by its size and the hash of its bytes, so that a record that
+/// was torn by a crash is detected when the file is replayed.
+constexpr size_t kRecordHeaderSize = sizeof(uint32_t) + sizeof(uint64_t);
+
+void AppendRecord(const rpc::GcsStoreLogRecord &record, std::string *buffer) {
+  std::string bytes = record.SerializeAsString();
+  uint32_t size = bytes.size();
+  uint64_t hash = MurmurHash64A(bytes.data(), bytes.size(), 0);
+  buffer->append(reinterpret_cast<const char *>(&size), sizeof(size));
+  buffer->append(reinterpret_cast<const char *>(&hash), sizeof(hash));
+  buffer->append(bytes);
+}
+
+int OpenFile(const std::string &path, int flags) {
+#ifdef _WIN32
+  flags |= _O_BINARY;
+#endif
+  int fd = open(path.c_str(), flags, 0644);
+  RAY_CHECK(fd >= 0) << "Failed to open " << path << ": " << strerror(errno);
+  return fd;
+}
+
+void WriteFile(int fd, const std::string &data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    auto n = write(fd, data.data() + written, data.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    RAY_CHECK(n > 0) << "Failed to write the GCS storage: " << strerror(errno);
+    written += n;
+  }
+}
+
+void SyncFile(int fd) {
+#ifdef _WIN32
+  int result = _commit(fd);
+#elif defined(__linux__)
+  int result = fdatasync(fd);
+#else
+  int result = fsync(fd);
+#endif
+  RAY_CHECK(result == 0) << "Failed to sync the GCS storage: " << strerror(errno);
+}
+
+void TruncateFile(int fd, uint64_t size) {
+#ifdef _WIN32
+  int result = _chsize_s(fd, size);
+#else
+  int result = ftruncate(fd, size);
+#endif
+  RAY_CHECK(result == 0) << "Failed to truncate the GCS storage: " << strerror(errno);
+}
+
+}  // namespace
+
+FileStore::FileStore(const std::string &dir, uint64_t compaction_bytes)
+    : log_path_(JoinPaths(dir, "gcs_storage.log")),
+      snapshot_path_(JoinPaths(dir, "gcs_storage.snapshot")),
+      compaction_bytes_(compaction_bytes) {
+  boost::filesystem::create_directories(dir);
+  size_t log_size = 0;
+  {
+    absl::MutexLock lock(&mutex_);
+    Replay(snapshot_path_);
+    log_size = Replay(log_path_);
+  }
+  absl::MutexLock log_lock(&log_mutex_);
+  log_fd_ = OpenFile(log_path_, O_WRONLY | O_CREAT | O_APPEND);
+  // Drop the record that was torn by a crash, so that new records are appended after
+  // the valid ones.
+  TruncateFile(log_fd_, log_size);
+  log_bytes_ = log_size;
+  RAY_LOG(INFO) << "Opened the GCS storage in " << dir << " with a log of " << log_size
+                << " bytes.";
+  flush_thread_.reset(new std::thread([this] {
+    SetThreadName("gcs_storage");
+    FlushLoop();
+  }));
+}
+
+FileStore::~FileStore() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopped_ = true;
+    pending_cv_.Signal();
+  }
+  flush_thread_->join();
+  absl::MutexLock log_lock(&log_mutex_);
+  close(log_fd_);
+}
+
+void FileStore::Write(const rpc::GcsStoreLogRecord &record,
+                      std::function<void()> on_durable) {
+  absl::MutexLock lock(&mutex_);
+  Apply(record);
+  AppendRecord(record, &pending_records_);
+  pending_callbacks_.push_back(std::move(on_durable));
+  num_appended_++;
+  pending_cv_.Signal();
+}
+
+boost::optional<std::string> FileStore::Get(const std::string &table_name,
+                                            const std::string &key) const {
+  absl::MutexLock lock(&mutex_);
+  auto table = tables_.find(table_name);
+  if (table == tables_.end()) {
+    return boost::none;
+  }
+  auto iter = table->second.records.find(key);
+  if (iter == table->second.records.end()) {
+    return boost::none;
+  }
+  return iter->second;
+}
+
+std::unordered_map<std::string, std::string> FileStore::GetAll(
+    const std::string &table_name) const {
+  absl::MutexLock lock(&mutex_);
+  std::unordered_map<std::string, std::string> result;
+  auto table = tables_.find(table_name);
+  if (table != tables_.end()) {
+    result.insert(table->second.records.begin(), table->second.records.end());
+  }
+  return result;
+}
+
+std::unordered_map<std::string, std::string> FileStore::GetByIndex(
+    const std::string &table_name, const std::string &index_key) const {
+  absl::MutexLock lock(&mutex_);
+  std::unordered_map<std::string, std::string> result;
+  auto table = tables_.find(table_name);
+  if (table == tables_.end()) {
+    return result;
+  }
+  auto iter = table->second.index_keys.find(index_key);
+  if (iter != table->second.index_keys.end()) {
+    for (const auto &key : iter->second) {
+      auto kv_iter = table->second.records.find(key);
+      if (kv_iter != table->second.records.end()) {
+        result[kv_iter->first] = kv_iter->second;
+      }
+    }
+  }
+  return result;
+}
+
+int FileStore::NextJobID() {
+  absl::MutexLock lock(&mutex_);
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::JOB_COUNTER);
+  record.set_job_counter(job_counter_ + 1);
+  Apply(record);
+  AppendRecord(record, &pending_records_);
+  pending_callbacks_.push_back(nullptr);
+  const uint64_t sequence = ++num_appended_;
+  pending_cv_.Signal();
+  // The job ID must not be reused after a restart.
+  while (num_synced_ < sequence) {
+    synced_cv_.Wait(&mutex_);
+  }
+  return record.job_counter();
+}
+
+void FileStore::Compact() {
+  absl::MutexLock log_lock(&log_mutex_);
+  // Only copy the tables under the lock, so that reads and writes don't wait for the
+  // snapshot to be serialized and written. The flush thread can't write to the log
+  // until it is truncated, so the records applied after the copy stay pending.
+  absl::flat_hash_map<std::string, Table> tables;
+  int job_counter;
+  {
+    absl::MutexLock lock(&mutex_);
+    tables = tables_;
+    job_counter = job_counter_;
+  }
+
+  std::string snapshot;
+  for (const auto &table : tables) {
+    rpc::GcsStoreLogRecord record;
+    record.set_type(rpc::GcsStoreLogRecord::PUT);
+    record.set_table_name(table.first);
+    absl::flat_hash_set<std::string> indexed;
+    for (const auto &index : table.second.index_keys) {
+      for (const auto &key : index.second) {
+        auto iter = table.second.records.find(key);
+        if (iter != table.second.records.end()) {
+          record.clear_keys();
+          record.add_keys(key);
+          record.clear_index_keys();
+          record.add_index_keys(index.first);
+          record.set_data(iter->second);
+          AppendRecord(record, &snapshot);
+          indexed.insert(key);
+        }
+      }
+    }
+    record.clear_index_keys();
+    for (const auto &entry : table.second.records) {
+      if (!indexed.contains(entry.first)) {
+        record.clear_keys();
+        record.add_keys(entry.first);
+        record.set_data(entry.second);
+        AppendRecord(record, &snapshot);
+      }
+    }
+  }
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::JOB_COUNTER);
+  record.set_job_counter(job_counter);
+  AppendRecord(record, &snapshot);
+
+  // Replace the snapshot atomically, and only then drop the log. The records that were
+  // pending during the snapshot are written to the new log, and replaying them on top
+  // of the snapshot is harmless since records are idempotent.
+  const std::string tmp_path = snapshot_path_ + ".tmp";
+  int fd = OpenFile(tmp_path, O_WRONLY | O_CREAT | O_TRUNC);
+  WriteFile(fd, snapshot);
+  SyncFile(fd);
+  close(fd);
+  boost::filesystem::rename(tmp_path, snapshot_path_);
+#ifndef _WIN32
+  int dir_fd = OpenFile(boost::filesystem::path(snapshot_path_).parent_path().string(),
+                        O_RDONLY);
+  fsync(dir_fd);
+  close(dir_fd);
+#endif
+  TruncateFile(log_fd_, 0);
+  SyncFile(log_fd_);
+  RAY_LOG(DEBUG) << "Compacted a GCS storage log of " << log_bytes_
+                 << " bytes into a snapshot of " << snapshot.size() << " bytes.";
+  log_bytes_ = 0;
+}
+
+uint64_t FileStore::LogBytes() const {
+  absl::MutexLock log_lock(&log_mutex_);
+  return log_bytes_;
+}
+
+void FileStore::Apply(const rpc::GcsStoreLogRecord &record) {
+  if (record.type() == rpc::GcsStoreLogRecord::JOB_COUNTER) {
+    job_counter_ = std::max(job_counter_, record.job_counter());
+    return;
+  }
+  auto &table = tables_[record.table_name()];
+  auto remove_from_index = [&table](const std::string &index_key,
+                                    const std::string &key) {
+    auto iter = table.index_keys.find(index_key);
+    if (iter != table.index_keys.end()) {
+      iter->second.erase(key);
+      if (iter->second.empty()) {
+        table.index_keys.erase(iter);
+      }
+    }
+  };
+  switch (record.type()) {
+  case rpc::GcsStoreLogRecord::PUT:
+    table.records[record.keys(0)] = record.data();
+    if (record.index_keys_size() > 0) {
+      table.index_keys[record.index_keys(0)].insert(record.keys(0));
+    }
+    break;
+  case rpc::GcsStoreLogRecord::DELETE:
+    for (int i = 0; i < record.keys_size(); i++) {
+      table.records.erase(record.keys(i));
+      if (i < record.index_keys_size()) {
+        remove_from_index(record.index_keys(i), record.keys(i));
+      }
+    }
+    break;
+  case rpc::GcsStoreLogRecord::DELETE_BY_INDEX: {
+    auto iter = table.index_keys.find(record.index_keys(0));
+    if (iter != table.index_keys.end()) {
+      for (const auto &key : iter->second) {
+        table.records.erase(key);
+      }
+      table.index_keys.erase(iter);
+    }
+    break;
+  }
+  default:
+    RAY_LOG(FATAL) << "Unknown GCS storage record type " << record.type();
+  }
+}
+
+size_t FileStore::Replay(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return 0;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const std::string contents = buffer.str();
+
+  size_t offset = 0;
+  size_t num_records = 0;
+  rpc::GcsStoreLogRecord record;
+  while (offset + kRecordHeaderSize <= contents.size()) {
+    uint32_t size;
+    uint64_t hash;
+    std::memcpy(&size, contents.data() + offset, sizeof(size));
+    std::memcpy(&hash, contents.data() + offset + sizeof(size), sizeof(hash));
+    const char *bytes = contents.data() + offset + kRecordHeaderSize;
+    if (offset + kRecordHeaderSize + size > contents.size() ||
+        MurmurHash64A(bytes, size, 0) != hash || !record.ParseFromArray(bytes, size)) {
+      break;
+    }
+    Apply(record);
+    offset += kRecordHeaderSize + size;
+    num_records++;
+  }
+  if (offset < contents.size()) {
+    RAY_LOG(WARNING) << "Dropping the last " << contents.size() - offset
+                     << " bytes of " << path << ", which were torn by a crash.";
+  }
+  RAY_LOG(INFO) << "Replayed " << num_records << " records from " << path << ".";
+  return offset;
+}
+
+void FileStore::FlushLoop() {
+  while (true) {
+    std::string records;
+    std::vector<std::function<void()>> callbacks;
+    uint64_t sequence;
+    {
+      absl::MutexLock lock(&mutex_);
+      while (!stopped_ && pending_records_.empty()) {
+        pending_cv_.Wait(&mutex_);
+      }
+      if (pending_records_.empty()) {
+        return;
+      }
+      // Group commit: everything that was appended while the last batch was being
+      // synced is written and synced at once.
+      records.swap(pending_records_);
+      callbacks.swap(pending_callbacks_);
+      sequence = num_appended_;
+    }
+
+    bool should_compact = false;
+    {
+      absl::MutexLock log_lock(&log_mutex_);
+      WriteFile(log_fd_, records);
+      SyncFile(log_fd_);
+      log_bytes_ += records.size();
+      should_compact = log_bytes_ >= compaction_bytes_;
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      num_synced_ = sequence;
+      synced_cv_.SignalAll();
+    }
+    for (const auto &callback : callbacks) {
+      if (callback) {
+        callback();
+      }
+    }
+    if (should_compact) {
+      Compact();
+    }
+  }
+}
+
+Status FileStoreClient::Write(const rpc::GcsStoreLogRecord &record,
+                              const StatusCallback &callback, const std::string &name) {
+  auto io_service = &main_io_service_;
+  file_store_->Write(record, [io_service, callback, name]() {
+    io_service->post(
+        [callback]() {
+          if (callback) {
+            callback(Status::OK());
+          }
+        },
+        name);
+  });
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncPut(const std::string &table_name, const std::string &key,
+                                 const std::string &data,
+                                 const StatusCallback &callback) {
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::PUT);
+  record.set_table_name(table_name);
+  record.add_keys(key);
+  record.set_data(data);
+  return Write(record, callback, "GcsFileStore.Put");
+}
+
+Status FileStoreClient::AsyncPutWithIndex(const std::string &table_name,
+                                          const std::string &key,
+                                          const std::string &index_key,
+                                          const std::string &data,
+                                          const StatusCallback &callback) {
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::PUT);
+  record.set_table_name(table_name);
+  record.add_keys(key);
+  record.add_index_keys(index_key);
+  record.set_data(data);
+  return Write(record, callback, "GcsFileStore.PutWithIndex");
+}
+
+Status FileStoreClient::AsyncGet(const std::string &table_name, const std::string &key,
+                                 const OptionalItemCallback<std::string> &callback) {
+  auto data = file_store_->Get(table_name, key);
+  main_io_service_.post([callback, data]() { callback(Status::OK(), data); },
+                        "GcsFileStore.Get");
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncGetByIndex(
+    const std::string &table_name, const std::string &index_key,
+    const MapCallback<std::string, std::string> &callback) {
+  auto result = file_store_->GetByIndex(table_name, index_key);
+  main_io_service_.post([result, callback]() { callback(result); },
+                        "GcsFileStore.GetByIndex");
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncGetAll(
+    const std::string &table_name,
+    const MapCallback<std::string, std::string> &callback) {
+  auto result = file_store_->GetAll(table_name);
+  main_io_service_.post([result, callback]() { callback(result); },
+                        "GcsFileStore.GetAll");
+  return Status::OK();
+}
+
+Status FileStoreClient::AsyncDelete(const std::string &table_name,
+                                    const std::string &key,
+                                    const StatusCallback &callback) {
+  return AsyncBatchDelete(table_name, {key}, callback);
+}
+
+Status FileStoreClient::AsyncDeleteWithIndex(const std::string &table_name,
+                                             const std::string &key,
+                                             const std::string &index_key,
+                                             const StatusCallback &callback) {
+  return AsyncBatchDeleteWithIndex(table_name, {key}, {index_key}, callback);
+}
+
+Status FileStoreClient::AsyncBatchDelete(const std::string &table_name,
+                                         const std::vector<std::string> &keys,
+                                         const StatusCallback &callback) {
+  return AsyncBatchDeleteWithIndex(table_name, keys, {}, callback);
+}
+
+Status FileStoreClient::AsyncBatchDeleteWithIndex(
+    const std::string &table_name, const std::vector<std::string> &keys,
+    const std::vector<std::string> &index_keys, const StatusCallback &callback) {
+  RAY_CHECK(index_keys.empty() || keys.size() == index_keys.size());
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::DELETE);
+  record.set_table_name(table_name);
+  for (const auto &key : keys) {
+    record.add_keys(key);
+  }
+  for (const auto &index_key : index_keys) {
+    record.add_index_keys(index_key);
+  }
+  return Write(record, callback, "GcsFileStore.Delete");
+}
+
+Status FileStoreClient::AsyncDeleteByIndex(const std::string &table_name,
+                                           const std::string &index_key,
+                                           const StatusCallback &callback) {
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::DELETE_BY_INDEX);
+  record.set_table_name(table_name);
+  record.add_index_keys(index_key);
+  return Write(record, callback, "GcsFileStore.DeleteByIndex");
+}
+
+int FileStoreClient::GetNextJobID() { return file_store_->NextJobID(); }
+
+}  // namespace gcs
+
+}  // namespace ray
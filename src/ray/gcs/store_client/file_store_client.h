@@ -0,0 +1,198 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/gcs/store_client/store_client.h"
+#include "src/ray/protobuf/gcs.pb.h"
+
+namespace ray {
+
+namespace gcs {
+
+/// \class FileStore
+///
+/// Tables that are kept in memory and persisted to a local directory, so that a GCS
+/// without Redis can restart from local disk. Every mutation is applied in memory and
+/// appended to a write-ahead log. A background thread writes the log with group commit:
+/// all the records that were appended while the last batch was synced are written and
+/// synced together, and then their callbacks are called. When the log gets too large,
+/// it's compacted into a snapshot of the tables.
+///
+/// This class is thread safe.
+class FileStore {
+ public:
+  /// Open the store, and recover the tables from the snapshot and the log in `dir`.
+  ///
+  /// \param dir The directory of the log and snapshot, which is created if needed.
+  /// \param compaction_bytes The size of the log above which it's compacted.
+  FileStore(const std::string &dir, uint64_t compaction_bytes);
+
+  /// Sync the pending records and close the log.
+  ~FileStore();
+
+  /// Apply a mutation to the tables and append it to the log.
+  ///
+  /// \param record The mutation.
+  /// \param on_durable Called from the background thread after the mutation is synced
+  /// to disk. May be nullptr.
+  void Write(const rpc::GcsStoreLogRecord &record, std::function<void()> on_durable);
+
+  /// Get the data of a key, or boost::none if there is none.
+  boost::optional<std::string> Get(const std::string &table_name,
+                                   const std::string &key) const;
+
+  /// Get all the data of a table.
+  std::unordered_map<std::string, std::string> GetAll(
+      const std::string &table_name) const;
+
+  /// Get the data of the keys in an index.
+  std::unordered_map<std::string, std::string> GetByIndex(
+      const std::string &table_name, const std::string &index_key) const;
+
+  /// Increment the job counter, and wait until the new value is synced to disk.
+  ///
+  /// \return The new value of the job counter.
+  int NextJobID();
+
+  /// Write a snapshot of the tables and truncate the log. The tables are only locked
+  /// while they are copied, reads and writes proceed while the snapshot is written.
+  void Compact();
+
+  /// The size of the log in bytes.
+  uint64_t LogBytes() const;
+
+ private:
+  struct Table {
+    // Mapping from key to data.
+    absl::flat_hash_map<std::string, std::string> records;
+    // Mapping from index key to keys.
+    absl::flat_hash_map<std::string, absl::flat_hash_set<std::string>> index_keys;
+  };
+
+  /// Apply a mutation to the tables.
+  void Apply(const rpc::GcsStoreLogRecord &record) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Apply the records in a file to the tables.
+  ///
+  /// \return The size of the valid prefix of the file, which is shorter than the file
+  /// if its last record was torn by a crash.
+  size_t Replay(const std::string &path) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Write the pending records to the log until the store is destroyed.
+  void FlushLoop();
+
+  /// The log and snapshot files.
+  const std::string log_path_;
+  const std::string snapshot_path_;
+  const uint64_t compaction_bytes_;
+
+  /// Mutex to protect the tables and the pending records.
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, Table> tables_ GUARDED_BY(mutex_);
+  int job_counter_ GUARDED_BY(mutex_) = 0;
+  /// The records that were applied but not written to the log yet, and their callbacks.
+  std::string pending_records_ GUARDED_BY(mutex_);
+  std::vector<std::function<void()>> pending_callbacks_ GUARDED_BY(mutex_);
+  /// The number of records that were appended, and the number of them that are synced.
+  uint64_t num_appended_ GUARDED_BY(mutex_) = 0;
+  uint64_t num_synced_ GUARDED_BY(mutex_) = 0;
+  absl::CondVar pending_cv_;
+  absl::CondVar synced_cv_;
+  bool stopped_ GUARDED_BY(mutex_) = false;
+
+  /// Mutex to protect the log file, which is written by the background thread and
+  /// truncated by compactions.
+  mutable absl::Mutex log_mutex_;
+  int log_fd_ GUARDED_BY(log_mutex_) = -1;
+  uint64_t log_bytes_ GUARDED_BY(log_mutex_) = 0;
+
+  std::unique_ptr<std::thread> flush_thread_;
+};
+
+/// \class FileStoreClient
+///
+/// A `StoreClient` that is backed by a `FileStore`. Several clients whose callbacks run
+/// on different event loops can share a store. Mutation callbacks are called after the
+/// mutation is synced to disk, and reads see mutations as soon as they are issued.
+///
+/// This class is thread safe.
+class FileStoreClient : public StoreClient {
+ public:
+  FileStoreClient(instrumented_io_context &main_io_service,
+                  std::shared_ptr<FileStore> file_store)
+      : main_io_service_(main_io_service), file_store_(std::move(file_store)) {}
+
+  Status AsyncPut(const std::string &table_name, const std::string &key,
+                  const std::string &data, const StatusCallback &callback) override;
+
+  Status AsyncPutWithIndex(const std::string &table_name, const std::string &key,
+                           const std::string &index_key, const std::string &data,
+                           const StatusCallback &callback) override;
+
+  Status AsyncGet(const std::string &table_name, const std::string &key,
+                  const OptionalItemCallback<std::string> &callback) override;
+
+  Status AsyncGetByIndex(const std::string &table_name, const std::string &index_key,
+                         const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncGetAll(const std::string &table_name,
+                     const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncDelete(const std::string &table_name, const std::string &key,
+                     const StatusCallback &callback) override;
+
+  Status AsyncDeleteWithIndex(const std::string &table_name, const std::string &key,
+                              const std::string &index_key,
+                              const StatusCallback &callback) override;
+
+  Status AsyncBatchDelete(const std::string &table_name,
+                          const std::vector<std::string> &keys,
+                          const StatusCallback &callback) override;
+
+  Status AsyncBatchDeleteWithIndex(const std::string &table_name,
+                                   const std::vector<std::string> &keys,
+                                   const std::vector<std::string> &index_keys,
+                                   const StatusCallback &callback) override;
+
+  Status AsyncDeleteByIndex(const std::string &table_name, const std::string &index_key,
+                            const StatusCallback &callback) override;
+
+  int GetNextJobID() override;
+
+ private:
+  /// Write a mutation to the store, and post the callback to main_io_service_ once it's
+  /// durable.
+  Status Write(const rpc::GcsStoreLogRecord &record, const StatusCallback &callback,
+               const std::string &name);
+
+  /// Async API Callback needs to post to main_io_service_ to ensure the orderly execution
+  /// of the callback.
+  instrumented_io_context &main_io_service_;
+
+  std::shared_ptr<FileStore> file_store_;
+};
+
+}  // namespace gcs
+
+}  // namespace ray
@@ -58,6 +58,71 @@ Status RedisStoreClient::AsyncPutWithIndex(const std::string &table_name,
   return status;
 }
 
+Status RedisStoreClient::AsyncBatchPut(const std::string &table_name,
+                                       const std::vector<std::string> &keys,
+                                       const std::vector<std::string> &index_keys,
+                                       const std::vector<std::string> &data,
+                                       const StatusCallback &callback) {
+  RAY_CHECK(keys.size() == data.size());
+  RAY_CHECK(index_keys.empty() || index_keys.size() == keys.size());
+  if (keys.empty()) {
+    if (callback) {
+      callback(Status::OK());
+    }
+    return Status::OK();
+  }
+
+  // Like `AsyncPutWithIndex`, the indexes are written before the data. The commands of
+  // a shard are executed in order, so it's enough to add them to the batches first.
+  std::vector<std::pair<std::string, std::string>> entries;
+  entries.reserve(keys.size() + index_keys.size());
+  for (size_t i = 0; i < index_keys.size(); i++) {
+    entries.emplace_back(GenRedisKey(table_name, keys[i], index_keys[i]), keys[i]);
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    entries.emplace_back(GenRedisKey(table_name, keys[i]), data[i]);
+  }
+
+  // Write the entries of each shard with `MSET` commands of at most
+  // `maximum_gcs_storage_operation_batch_size` entries.
+  const size_t batch_size =
+      RayConfig::instance().maximum_gcs_storage_operation_batch_size();
+  std::unordered_map<RedisContext *, std::list<std::vector<std::string>>>
+      commands_by_shards;
+  int total_count = 0;
+  for (auto &entry : entries) {
+    auto shard_context = redis_client_->GetShardContext(entry.first).get();
+    auto &commands = commands_by_shards[shard_context];
+    if (commands.empty() || (commands.back().size() - 1) / 2 == batch_size) {
+      commands.emplace_back();
+      commands.back().push_back("MSET");
+      total_count++;
+    }
+    commands.back().push_back(std::move(entry.first));
+    commands.back().push_back(std::move(entry.second));
+  }
+
+  auto finished_count = std::make_shared<int>(0);
+  auto batch_status = std::make_shared<Status>();
+  for (auto &command_list : commands_by_shards) {
+    for (auto &command : command_list.second) {
+      auto write_callback = [finished_count, total_count, batch_status,
+                             callback](const std::shared_ptr<CallbackReply> &reply) {
+        auto status = reply->ReadAsStatus();
+        if (!status.ok()) {
+          *batch_status = status;
+        }
+        ++(*finished_count);
+        if (*finished_count == total_count && callback) {
+          callback(*batch_status);
+        }
+      };
+      RAY_CHECK_OK(command_list.first->RunArgvAsync(command, write_callback));
+    }
+  }
+  return Status::OK();
+}
+
 Status RedisStoreClient::AsyncGet(const std::string &table_name, const std::string &key,
                                   const OptionalItemCallback<std::string> &callback) {
   RAY_CHECK(callback != nullptr);
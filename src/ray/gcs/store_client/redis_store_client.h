@@ -36,6 +36,12 @@ class RedisStoreClient : public StoreClient {
                            const std::string &index_key, const std::string &data,
                            const StatusCallback &callback) override;
 
+  Status AsyncBatchPut(const std::string &table_name,
+                       const std::vector<std::string> &keys,
+                       const std::vector<std::string> &index_keys,
+                       const std::vector<std::string> &data,
+                       const StatusCallback &callback) override;
+
   Status AsyncGet(const std::string &table_name, const std::string &key,
                   const OptionalItemCallback<std::string> &callback) override;
 
@@ -0,0 +1,569 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/snapshot_store_client.h"
+
+#include <algorithm>
+#include <boost/asio/post.hpp>
+
+#include "absl/strings/str_format.h"
+
+namespace ray {
+
+namespace gcs {
+
+namespace {
+
+const std::string kSnapshotKey = "snapshot";
+
+rpc::GcsStoreLogRecord PutRecord(const std::string &table_name, const std::string &key,
+                                 const std::string &index_key, const std::string &data) {
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::PUT);
+  record.set_table_name(table_name);
+  record.add_keys(key);
+  if (!index_key.empty()) {
+    record.add_index_keys(index_key);
+  }
+  record.set_data(data);
+  return record;
+}
+
+rpc::GcsStoreLogRecord DeleteRecord(const std::string &table_name,
+                                    const std::vector<std::string> &keys) {
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::DELETE);
+  record.set_table_name(table_name);
+  for (const auto &key : keys) {
+    record.add_keys(key);
+  }
+  return record;
+}
+
+}  // namespace
+
+SnapshotStoreClient::SnapshotStoreClient(
+    std::shared_ptr<StoreClient> store_client,
+    absl::flat_hash_map<std::string, IndexFunction> tables)
+    : store_client_(std::move(store_client)),
+      tables_(std::move(tables)),
+      snapshot_table_name_(TablePrefix_Name(rpc::TablePrefix::GCS_SNAPSHOT)),
+      tail_table_name_(TablePrefix_Name(rpc::TablePrefix::GCS_SNAPSHOT_TAIL)) {}
+
+Status SnapshotStoreClient::AsyncPut(const std::string &table_name,
+                                     const std::string &key, const std::string &data,
+                                     const StatusCallback &callback) {
+  if (!tables_.contains(table_name)) {
+    return store_client_->AsyncPut(table_name, key, data, callback);
+  }
+  return LogAndMutate(
+      {PutRecord(table_name, key, "", data)},
+      [=](const StatusCallback &on_done) {
+        return store_client_->AsyncPut(table_name, key, data, on_done);
+      },
+      callback);
+}
+
+Status SnapshotStoreClient::AsyncPutWithIndex(const std::string &table_name,
+                                              const std::string &key,
+                                              const std::string &index_key,
+                                              const std::string &data,
+                                              const StatusCallback &callback) {
+  if (!tables_.contains(table_name)) {
+    return store_client_->AsyncPutWithIndex(table_name, key, index_key, data, callback);
+  }
+  return LogAndMutate(
+      {PutRecord(table_name, key, index_key, data)},
+      [=](const StatusCallback &on_done) {
+        return store_client_->AsyncPutWithIndex(table_name, key, index_key, data,
+                                                on_done);
+      },
+      callback);
+}
+
+Status SnapshotStoreClient::AsyncBatchPut(const std::string &table_name,
+                                          const std::vector<std::string> &keys,
+                                          const std::vector<std::string> &index_keys,
+                                          const std::vector<std::string> &data,
+                                          const StatusCallback &callback) {
+  if (!tables_.contains(table_name)) {
+    return store_client_->AsyncBatchPut(table_name, keys, index_keys, data, callback);
+  }
+  std::vector<rpc::GcsStoreLogRecord> records;
+  records.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    records.push_back(PutRecord(table_name, keys[i],
+                                index_keys.empty() ? "" : index_keys[i], data[i]));
+  }
+  return LogAndMutate(
+      std::move(records),
+      [=](const StatusCallback &on_done) {
+        return store_client_->AsyncBatchPut(table_name, keys, index_keys, data, on_done);
+      },
+      callback);
+}
+
+Status SnapshotStoreClient::AsyncGet(const std::string &table_name,
+                                     const std::string &key,
+                                     const OptionalItemCallback<std::string> &callback) {
+  return store_client_->AsyncGet(table_name, key, callback);
+}
+
+Status SnapshotStoreClient::AsyncGetByIndex(
+    const std::string &table_name, const std::string &index_key,
+    const MapCallback<std::string, std::string> &callback) {
+  return store_client_->AsyncGetByIndex(table_name, index_key, callback);
+}
+
+Status SnapshotStoreClient::AsyncGetAll(
+    const std::string &table_name,
+    const MapCallback<std::string, std::string> &callback) {
+  return store_client_->AsyncGetAll(table_name, callback);
+}
+
+Status SnapshotStoreClient::AsyncDelete(const std::string &table_name,
+                                        const std::string &key,
+                                        const StatusCallback &callback) {
+  if (!tables_.contains(table_name)) {
+    return store_client_->AsyncDelete(table_name, key, callback);
+  }
+  return LogAndMutate(
+      {DeleteRecord(table_name, {key})},
+      [=](const StatusCallback &on_done) {
+        return store_client_->AsyncDelete(table_name, key, on_done);
+      },
+      callback);
+}
+
+Status SnapshotStoreClient::AsyncDeleteWithIndex(const std::string &table_name,
+                                                 const std::string &key,
+                                                 const std::string &index_key,
+                                                 const StatusCallback &callback) {
+  if (!tables_.contains(table_name)) {
+    return store_client_->AsyncDeleteWithIndex(table_name, key, index_key, callback);
+  }
+  return LogAndMutate(
+      {DeleteRecord(table_name, {key})},
+      [=](const StatusCallback &on_done) {
+        return store_client_->AsyncDeleteWithIndex(table_name, key, index_key, on_done);
+      },
+      callback);
+}
+
+Status SnapshotStoreClient::AsyncBatchDelete(const std::string &table_name,
+                                             const std::vector<std::string> &keys,
+                                             const StatusCallback &callback) {
+  if (!tables_.contains(table_name)) {
+    return store_client_->AsyncBatchDelete(table_name, keys, callback);
+  }
+  return LogAndMutate(
+      {DeleteRecord(table_name, keys)},
+      [=](const StatusCallback &on_done) {
+        return store_client_->AsyncBatchDelete(table_name, keys, on_done);
+      },
+      callback);
+}
+
+Status SnapshotStoreClient::AsyncBatchDeleteWithIndex(
+    const std::string &table_name, const std::vector<std::string> &keys,
+    const std::vector<std::string> &index_keys, const StatusCallback &callback) {
+  if (!tables_.contains(table_name)) {
+    return store_client_->AsyncBatchDeleteWithIndex(table_name, keys, index_keys,
+                                                    callback);
+  }
+  return LogAndMutate(
+      {DeleteRecord(table_name, keys)},
+      [=](const StatusCallback &on_done) {
+        return store_client_->AsyncBatchDeleteWithIndex(table_name, keys, index_keys,
+                                                        on_done);
+      },
+      callback);
+}
+
+Status SnapshotStoreClient::AsyncDeleteByIndex(const std::string &table_name,
+                                               const std::string &index_key,
+                                               const StatusCallback &callback) {
+  if (!tables_.contains(table_name)) {
+    return store_client_->AsyncDeleteByIndex(table_name, index_key, callback);
+  }
+  rpc::GcsStoreLogRecord record;
+  record.set_type(rpc::GcsStoreLogRecord::DELETE_BY_INDEX);
+  record.set_table_name(table_name);
+  record.add_index_keys(index_key);
+  return LogAndMutate(
+      {std::move(record)},
+      [=](const StatusCallback &on_done) {
+        return store_client_->AsyncDeleteByIndex(table_name, index_key, on_done);
+      },
+      callback);
+}
+
+int SnapshotStoreClient::GetNextJobID() { return store_client_->GetNextJobID(); }
+
+Status SnapshotStoreClient::LogAndMutate(
+    std::vector<rpc::GcsStoreLogRecord> records,
+    std::function<Status(const StatusCallback &)> mutate,
+    const StatusCallback &callback) {
+  std::vector<std::string> tail_keys;
+  std::vector<std::string> tail_values;
+  tail_keys.reserve(records.size());
+  tail_values.reserve(records.size());
+  int64_t version;
+  {
+    absl::MutexLock lock(&mutex_);
+    version = version_;
+    for (const auto &record : records) {
+      tail_keys.push_back(TailKey(version, next_sequence_++));
+      tail_values.push_back(record.SerializeAsString());
+    }
+    auto &keys = tail_keys_[version];
+    keys.insert(keys.end(), tail_keys.begin(), tail_keys.end());
+    ++num_mutations_in_flight_[version];
+    num_records_since_snapshot_ += records.size();
+  }
+
+  auto on_done = [this, version, callback](const Status &status) {
+    OnMutationDone(version);
+    if (callback) {
+      callback(status);
+    }
+  };
+  // The mutation is only applied once it's logged, so that the tables never have a
+  // mutation that the tail doesn't. It also only completes once it's logged, so a
+  // snapshot that waits for it to complete doesn't need its tail.
+  auto status = store_client_->AsyncBatchPut(
+      tail_table_name_, tail_keys, /*index_keys=*/{}, tail_values,
+      [mutate = std::move(mutate), on_done](const Status &status) {
+        if (!status.ok()) {
+          on_done(status);
+          return;
+        }
+        auto mutate_status = mutate(on_done);
+        if (!mutate_status.ok()) {
+          on_done(mutate_status);
+        }
+      });
+  if (!status.ok()) {
+    OnMutationDone(version);
+  }
+  return status;
+}
+
+void SnapshotStoreClient::OnMutationDone(int64_t version) {
+  std::function<void()> snapshot;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = num_mutations_in_flight_.find(version);
+    RAY_CHECK(it != num_mutations_in_flight_.end());
+    if (--it->second == 0) {
+      num_mutations_in_flight_.erase(it);
+    }
+    if (pending_snapshot_ && (num_mutations_in_flight_.empty() ||
+                              num_mutations_in_flight_.begin()->first >=
+                                  pending_snapshot_version_)) {
+      snapshot = std::move(pending_snapshot_);
+      pending_snapshot_ = nullptr;
+    }
+  }
+  if (snapshot) {
+    snapshot();
+  }
+}
+
+bool SnapshotStoreClient::ShouldTakeSnapshot(double min_tail_ratio) {
+  absl::MutexLock lock(&mutex_);
+  return num_records_since_snapshot_ > 0 &&
+         num_records_since_snapshot_ >= min_tail_ratio * snapshot_num_entries_;
+}
+
+void SnapshotStoreClient::AsyncTakeSnapshot(const StatusCallback &callback) {
+  int64_t version;
+  bool ready;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (snapshot_in_progress_) {
+      if (callback) {
+        callback(Status::OK());
+      }
+      return;
+    }
+    snapshot_in_progress_ = true;
+    version = ++version_;
+    next_sequence_ = 0;
+    num_records_since_snapshot_ = 0;
+    ready = num_mutations_in_flight_.empty() ||
+            num_mutations_in_flight_.begin()->first >= version;
+    if (!ready) {
+      pending_snapshot_version_ = version;
+      pending_snapshot_ = [this, version, callback]() {
+        WriteSnapshot(version, callback);
+      };
+    }
+  }
+  if (ready) {
+    WriteSnapshot(version, callback);
+  }
+}
+
+void SnapshotStoreClient::WriteSnapshot(int64_t version, const StatusCallback &callback) {
+  struct PendingSnapshot {
+    absl::Mutex mutex;
+    size_t num_pending;
+    int64_t num_entries = 0;
+    rpc::GcsTablesSnapshot snapshot;
+  };
+  auto pending = std::make_shared<PendingSnapshot>();
+  pending->num_pending = tables_.size();
+  pending->snapshot.set_version(version);
+  auto on_snapshot_written = [this, version, pending, callback](const Status &status) {
+    if (!status.ok()) {
+      RAY_LOG(WARNING) << "Failed to write the snapshot of version " << version << ": "
+                       << status;
+      {
+        absl::MutexLock lock(&mutex_);
+        snapshot_in_progress_ = false;
+      }
+      if (callback) {
+        callback(status);
+      }
+      return;
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      snapshot_num_entries_ = pending->num_entries;
+    }
+    TruncateTail(version, callback);
+  };
+
+  for (const auto &table : tables_) {
+    const auto table_name = table.first;
+    RAY_CHECK_OK(store_client_->AsyncGetAll(
+        table_name, [this, table_name, pending, on_snapshot_written](
+                        const std::unordered_map<std::string, std::string> &result) {
+          {
+            absl::MutexLock lock(&pending->mutex);
+            pending->num_entries += result.size();
+            auto snapshot_table = pending->snapshot.add_tables();
+            snapshot_table->set_table_name(table_name);
+            snapshot_table->mutable_keys()->Reserve(result.size());
+            snapshot_table->mutable_values()->Reserve(result.size());
+            for (const auto &entry : result) {
+              snapshot_table->add_keys(entry.first);
+              snapshot_table->add_values(entry.second);
+            }
+            if (--pending->num_pending > 0) {
+              return;
+            }
+          }
+          // Serializing all tables takes long, so it's kept off the caller's thread.
+          boost::asio::post(snapshot_thread_, [this, pending, on_snapshot_written]() {
+            auto serialized = pending->snapshot.SerializeAsString();
+            RAY_LOG(INFO) << "Writing a snapshot of the GCS tables of version "
+                          << pending->snapshot.version() << ", " << serialized.size()
+                          << " bytes.";
+            RAY_CHECK_OK(store_client_->AsyncPut(snapshot_table_name_, kSnapshotKey,
+                                                 serialized, on_snapshot_written));
+          });
+        }));
+  }
+}
+
+void SnapshotStoreClient::TruncateTail(int64_t version, const StatusCallback &callback) {
+  std::vector<std::string> keys;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto end = tail_keys_.lower_bound(version);
+    for (auto it = tail_keys_.begin(); it != end; ++it) {
+      keys.insert(keys.end(), it->second.begin(), it->second.end());
+    }
+    tail_keys_.erase(tail_keys_.begin(), end);
+  }
+  auto on_done = [this, callback](const Status &status) {
+    {
+      absl::MutexLock lock(&mutex_);
+      snapshot_in_progress_ = false;
+    }
+    if (callback) {
+      callback(status);
+    }
+  };
+  if (keys.empty()) {
+    on_done(Status::OK());
+  } else {
+    RAY_CHECK_OK(store_client_->AsyncBatchDelete(tail_table_name_, keys, on_done));
+  }
+}
+
+void SnapshotStoreClient::AsyncLoad(
+    std::function<void(boost::optional<Tables>)> callback) {
+  auto on_tail_loaded = [this, callback](
+                            const boost::optional<std::string> &serialized_snapshot,
+                            const std::unordered_map<std::string, std::string> &tail) {
+    std::vector<std::string> tail_keys;
+    tail_keys.reserve(tail.size());
+    for (const auto &entry : tail) {
+      tail_keys.push_back(entry.first);
+    }
+    // The tail keys are ordered by version and sequence number.
+    std::sort(tail_keys.begin(), tail_keys.end());
+
+    rpc::GcsTablesSnapshot snapshot;
+    if (serialized_snapshot) {
+      RAY_CHECK(snapshot.ParseFromString(*serialized_snapshot));
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      int64_t max_version = snapshot.version();
+      num_records_since_snapshot_ = 0;
+      for (const auto &key : tail_keys) {
+        int64_t version = TailKeyVersion(key);
+        tail_keys_[version].push_back(key);
+        max_version = std::max(max_version, version);
+        if (version >= snapshot.version()) {
+          num_records_since_snapshot_++;
+        }
+      }
+      snapshot_num_entries_ = 0;
+      for (const auto &snapshot_table : snapshot.tables()) {
+        snapshot_num_entries_ += snapshot_table.keys_size();
+      }
+      // Log the mutations after the restart with a new version, so that they are
+      // ordered after the tail.
+      version_ = max_version + 1;
+      next_sequence_ = 0;
+    }
+    if (!serialized_snapshot) {
+      callback(boost::none);
+      return;
+    }
+
+    Tables tables;
+    for (auto &snapshot_table : *snapshot.mutable_tables()) {
+      auto &table = tables[snapshot_table.table_name()];
+      table.reserve(snapshot_table.keys_size());
+      for (int i = 0; i < snapshot_table.keys_size(); i++) {
+        table.emplace(std::move(*snapshot_table.mutable_keys(i)),
+                      std::move(*snapshot_table.mutable_values(i)));
+      }
+    }
+    size_t num_replayed = 0;
+    for (const auto &key : tail_keys) {
+      if (TailKeyVersion(key) < snapshot.version()) {
+        // Left over from before the snapshot, and already in it.
+        continue;
+      }
+      rpc::GcsStoreLogRecord record;
+      RAY_CHECK(record.ParseFromString(tail.at(key)));
+      ApplyRecord(record, &tables);
+      num_replayed++;
+    }
+    RAY_LOG(INFO) << "Loaded the snapshot of the GCS tables of version "
+                  << snapshot.version() << ", and replayed " << num_replayed
+                  << " mutations after it.";
+    callback(std::move(tables));
+  };
+
+  RAY_CHECK_OK(store_client_->AsyncGet(
+      snapshot_table_name_, kSnapshotKey,
+      [this, on_tail_loaded](const Status &status,
+                             const boost::optional<std::string> &serialized_snapshot) {
+        RAY_CHECK_OK(status);
+        RAY_CHECK_OK(store_client_->AsyncGetAll(
+            tail_table_name_,
+            [serialized_snapshot,
+             on_tail_loaded](const std::unordered_map<std::string, std::string> &tail) {
+              on_tail_loaded(serialized_snapshot, tail);
+            }));
+      }));
+}
+
+void SnapshotStoreClient::ApplyRecord(const rpc::GcsStoreLogRecord &record,
+                                      Tables *tables) const {
+  auto &table = (*tables)[record.table_name()];
+  switch (record.type()) {
+  case rpc::GcsStoreLogRecord::PUT:
+    table[record.keys(0)] = record.data();
+    break;
+  case rpc::GcsStoreLogRecord::DELETE:
+    for (const auto &key : record.keys()) {
+      table.erase(key);
+    }
+    break;
+  case rpc::GcsStoreLogRecord::DELETE_BY_INDEX: {
+    auto it = tables_.find(record.table_name());
+    RAY_CHECK(it != tables_.end() && it->second)
+        << "Table " << record.table_name() << " has no index function.";
+    for (auto entry = table.begin(); entry != table.end();) {
+      if (it->second(entry->first) == record.index_keys(0)) {
+        table.erase(entry++);
+      } else {
+        ++entry;
+      }
+    }
+    break;
+  }
+  default:
+    RAY_LOG(FATAL) << "Unexpected record type " << record.type();
+  }
+}
+
+Status SnapshotStoreClient::AsyncDeleteSnapshot(StoreClient &store_client,
+                                                const StatusCallback &callback) {
+  // Delete the snapshot first, since the tail is ignored without it.
+  return store_client.AsyncDelete(
+      TablePrefix_Name(rpc::TablePrefix::GCS_SNAPSHOT), kSnapshotKey,
+      [&store_client, callback](const Status &status) {
+        if (!status.ok()) {
+          if (callback) {
+            callback(status);
+          }
+          return;
+        }
+        const std::string tail_table_name =
+            TablePrefix_Name(rpc::TablePrefix::GCS_SNAPSHOT_TAIL);
+        RAY_CHECK_OK(store_client.AsyncGetAll(
+            tail_table_name,
+            [&store_client, tail_table_name,
+             callback](const std::unordered_map<std::string, std::string> &tail) {
+              auto on_done = [callback](const Status &status) {
+                if (callback) {
+                  callback(status);
+                }
+              };
+              std::vector<std::string> keys;
+              keys.reserve(tail.size());
+              for (const auto &entry : tail) {
+                keys.push_back(entry.first);
+              }
+              if (keys.empty()) {
+                on_done(Status::OK());
+              } else {
+                RAY_CHECK_OK(
+                    store_client.AsyncBatchDelete(tail_table_name, keys, on_done));
+              }
+            }));
+      });
+}
+
+std::string SnapshotStoreClient::TailKey(int64_t version, int64_t sequence) {
+  return absl::StrFormat("%020d:%020d", version, sequence);
+}
+
+int64_t SnapshotStoreClient::TailKeyVersion(const std::string &tail_key) {
+  return std::stoll(tail_key.substr(0, 20));
+}
+
+}  // namespace gcs
+
+}  // namespace ray
@@ -0,0 +1,191 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio/thread_pool.hpp>
+#include <map>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/gcs/store_client/store_client.h"
+#include "src/ray/protobuf/gcs.pb.h"
+
+namespace ray {
+
+namespace gcs {
+
+/// \class SnapshotStoreClient
+/// A store client that keeps a snapshot of some of the tables of another store client,
+/// so that they can be loaded with a single read instead of a scan of every table.
+///
+/// The snapshot is a single value that holds all the entries of the tables. Every
+/// mutation of the tables is first logged to a tail table, with the version of the next
+/// snapshot, and only applied to the tables once the log record is written. So every
+/// mutation that is in the tables is also in the snapshot or its tail. A mutation that
+/// is interrupted by a failure may only be in the tail, but it never completed.
+///
+/// A snapshot is taken by starting a new version, waiting for the mutations of the
+/// previous versions to complete, and reading the tables. The snapshot may contain some
+/// of the mutations of its own version, which is fine because replaying the tail is
+/// idempotent. The snapshot is serialized and written on a background thread. Once it
+/// is written, the tail of the previous versions is deleted.
+///
+/// This class is thread safe.
+class SnapshotStoreClient : public StoreClient {
+ public:
+  /// Get the index key of a key of a table that is written with indexes.
+  using IndexFunction = std::function<std::string(const std::string &key)>;
+
+  /// The entries of the tables, by table name and key.
+  using Tables =
+      std::unordered_map<std::string, std::unordered_map<std::string, std::string>>;
+
+  /// Create a snapshot store client.
+  ///
+  /// \param store_client The store client of the tables.
+  /// \param tables The names of the tables that are snapshotted, and their index
+  /// functions if they are written with indexes.
+  SnapshotStoreClient(std::shared_ptr<StoreClient> store_client,
+                      absl::flat_hash_map<std::string, IndexFunction> tables);
+
+  Status AsyncPut(const std::string &table_name, const std::string &key,
+                  const std::string &data, const StatusCallback &callback) override;
+
+  Status AsyncPutWithIndex(const std::string &table_name, const std::string &key,
+                           const std::string &index_key, const std::string &data,
+                           const StatusCallback &callback) override;
+
+  Status AsyncBatchPut(const std::string &table_name,
+                       const std::vector<std::string> &keys,
+                       const std::vector<std::string> &index_keys,
+                       const std::vector<std::string> &data,
+                       const StatusCallback &callback) override;
+
+  Status AsyncGet(const std::string &table_name, const std::string &key,
+                  const OptionalItemCallback<std::string> &callback) override;
+
+  Status AsyncGetByIndex(const std::string &table_name, const std::string &index_key,
+                         const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncGetAll(const std::string &table_name,
+                     const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncDelete(const std::string &table_name, const std::string &key,
+                     const StatusCallback &callback) override;
+
+  Status AsyncDeleteWithIndex(const std::string &table_name, const std::string &key,
+                              const std::string &index_key,
+                              const StatusCallback &callback) override;
+
+  Status AsyncBatchDelete(const std::string &table_name,
+                          const std::vector<std::string> &keys,
+                          const StatusCallback &callback) override;
+
+  Status AsyncBatchDeleteWithIndex(const std::string &table_name,
+                                   const std::vector<std::string> &keys,
+                                   const std::vector<std::string> &index_keys,
+                                   const StatusCallback &callback) override;
+
+  Status AsyncDeleteByIndex(const std::string &table_name, const std::string &index_key,
+                            const StatusCallback &callback) override;
+
+  int GetNextJobID() override;
+
+  /// Load the last snapshot and replay the tail of the mutations after it. This must be
+  /// called once, before any mutation.
+  ///
+  /// \param callback Called with the snapshotted tables, or none if there is no
+  /// snapshot, in which case they have to be read from the store client.
+  void AsyncLoad(std::function<void(boost::optional<Tables>)> callback);
+
+  /// Whether enough mutations were logged since the last snapshot to take a new one.
+  ///
+  /// \param min_tail_ratio The minimum number of tail records per entry of the last
+  /// snapshot.
+  /// \return True if the tail has records and at least `min_tail_ratio` times as many
+  /// as the last snapshot has entries.
+  bool ShouldTakeSnapshot(double min_tail_ratio) LOCKS_EXCLUDED(mutex_);
+
+  /// Take a snapshot of the tables, and delete the tail of the mutations before it.
+  /// Does nothing if a snapshot is already being taken.
+  ///
+  /// \param callback Called when the snapshot is written and the tail is truncated.
+  void AsyncTakeSnapshot(const StatusCallback &callback);
+
+  /// Delete the snapshot of a store client and the tail after it. A snapshot must be
+  /// deleted if the store client is used without logging the tail, because it would
+  /// become stale.
+  ///
+  /// \param store_client The store client of the tables. It must outlive the deletion.
+  /// \param callback Called when the snapshot and the tail are deleted.
+  static Status AsyncDeleteSnapshot(StoreClient &store_client,
+                                    const StatusCallback &callback);
+
+ private:
+  /// Log mutation records to the tail, and run the mutation once they are written. The
+  /// callback is called once the mutation is done, or if the log fails.
+  Status LogAndMutate(std::vector<rpc::GcsStoreLogRecord> records,
+                      std::function<Status(const StatusCallback &)> mutate,
+                      const StatusCallback &callback) LOCKS_EXCLUDED(mutex_);
+
+  /// Called when a mutation that is logged with `version` completes.
+  void OnMutationDone(int64_t version) LOCKS_EXCLUDED(mutex_);
+
+  /// Read the tables and write them as the snapshot of `version`.
+  void WriteSnapshot(int64_t version, const StatusCallback &callback);
+
+  /// Delete the tail of the mutations before `version`.
+  void TruncateTail(int64_t version, const StatusCallback &callback)
+      LOCKS_EXCLUDED(mutex_);
+
+  /// Apply a mutation record to the tables.
+  void ApplyRecord(const rpc::GcsStoreLogRecord &record, Tables *tables) const;
+
+  static std::string TailKey(int64_t version, int64_t sequence);
+
+  static int64_t TailKeyVersion(const std::string &tail_key);
+
+  std::shared_ptr<StoreClient> store_client_;
+  const absl::flat_hash_map<std::string, IndexFunction> tables_;
+  const std::string snapshot_table_name_;
+  const std::string tail_table_name_;
+
+  absl::Mutex mutex_;
+  /// The version that mutations are logged with.
+  int64_t version_ GUARDED_BY(mutex_) = 1;
+  /// The sequence number of the next mutation of `version_`.
+  int64_t next_sequence_ GUARDED_BY(mutex_) = 0;
+  /// The number of tail records that are logged after the last snapshot.
+  int64_t num_records_since_snapshot_ GUARDED_BY(mutex_) = 0;
+  /// The number of entries of the last snapshot.
+  int64_t snapshot_num_entries_ GUARDED_BY(mutex_) = 0;
+  /// The number of mutations of each version that haven't completed yet.
+  std::map<int64_t, int> num_mutations_in_flight_ GUARDED_BY(mutex_);
+  /// The keys of the tail, by version.
+  std::map<int64_t, std::vector<std::string>> tail_keys_ GUARDED_BY(mutex_);
+  /// Whether a snapshot is being taken.
+  bool snapshot_in_progress_ GUARDED_BY(mutex_) = false;
+  /// The snapshot that waits for the mutations before its version to complete.
+  std::function<void()> pending_snapshot_ GUARDED_BY(mutex_);
+  int64_t pending_snapshot_version_ GUARDED_BY(mutex_) = 0;
+
+  /// Serializes and writes snapshots off the thread that reads the tables, which is
+  /// usually the main loop of the GCS. Declared last so that it's joined first.
+  boost::asio::thread_pool snapshot_thread_{1};
+};
+
+}  // namespace gcs
+
+}  // namespace ray
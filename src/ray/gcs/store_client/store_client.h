@@ -14,8 +14,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ray/common/asio/io_service_pool.h"
 #include "ray/common/id.h"
@@ -56,6 +58,50 @@ class StoreClient {
                                    const std::string &index_key, const std::string &data,
                                    const StatusCallback &callback) = 0;
 
+  /// Write a batch of data to the given table asynchronously. Stores that support it
+  /// override this to write the batch with fewer round trips than one write per key.
+  ///
+  /// \param table_name The name of the table to be written.
+  /// \param keys The keys that will be written to the table.
+  /// \param index_keys The secondary keys of the given keys, they are in one-to-one
+  ///                   correspondence. Empty if the data isn't indexed.
+  /// \param data The values of the given keys, they are in one-to-one correspondence.
+  /// \param callback Callback that will be called after all writes finish.
+  /// \return Status
+  virtual Status AsyncBatchPut(const std::string &table_name,
+                               const std::vector<std::string> &keys,
+                               const std::vector<std::string> &index_keys,
+                               const std::vector<std::string> &data,
+                               const StatusCallback &callback) {
+    RAY_CHECK(keys.size() == data.size());
+    RAY_CHECK(index_keys.empty() || index_keys.size() == keys.size());
+    if (keys.empty()) {
+      if (callback) {
+        callback(Status::OK());
+      }
+      return Status::OK();
+    }
+    auto num_pending = std::make_shared<std::atomic<size_t>>(keys.size());
+    auto failed = std::make_shared<std::atomic<bool>>(false);
+    auto on_done = [num_pending, failed, callback](const Status &status) {
+      if (!status.ok()) {
+        *failed = true;
+      }
+      if (--(*num_pending) == 0 && callback) {
+        callback(*failed ? Status::IOError("Failed to write the batch.") : Status::OK());
+      }
+    };
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (index_keys.empty()) {
+        RAY_RETURN_NOT_OK(AsyncPut(table_name, keys[i], data[i], on_done));
+      } else {
+        RAY_RETURN_NOT_OK(
+            AsyncPutWithIndex(table_name, keys[i], index_keys[i], data[i], on_done));
+      }
+    }
+    return Status::OK();
+  }
+
   /// Get data from the given table asynchronously.
   ///
   /// \param table_name The name of the table to be read.
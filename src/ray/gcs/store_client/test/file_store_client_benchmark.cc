@@ -0,0 +1,86 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include "absl/time/clock.h"
+#include "boost/filesystem.hpp"
+#include "ray/common/test_util.h"
+#include "ray/gcs/store_client/file_store_client.h"
+
+/// Measure the write latency of 1M entries, and the time to recover them from disk.
+int main(int argc, char **argv) {
+  const int num_entries = 1000 * 1000;
+  const uint64_t compaction_bytes = 64 * 1024 * 1024;
+  const std::string table_name = "benchmark_table";
+  const std::string data(100, 'x');
+  const auto dir =
+      (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+          .string();
+  instrumented_io_context io_service;
+  std::thread thread([&io_service]() {
+    boost::asio::io_service::work work(io_service);
+    io_service.run();
+  });
+
+  auto file_store = std::make_shared<ray::gcs::FileStore>(dir, compaction_bytes);
+  auto store_client = std::make_shared<ray::gcs::FileStoreClient>(io_service, file_store);
+  std::vector<int64_t> latencies_us(num_entries);
+  std::atomic<int> num_done(0);
+  auto start = absl::Now();
+  for (int i = 0; i < num_entries; i++) {
+    auto issued = absl::GetCurrentTimeNanos();
+    RAY_CHECK_OK(store_client->AsyncPutWithIndex(
+        table_name, std::to_string(i), std::to_string(i % 1000), data,
+        [i, issued, &latencies_us, &num_done](const ray::Status &status) {
+          latencies_us[i] = (absl::GetCurrentTimeNanos() - issued) / 1000;
+          num_done++;
+        }));
+  }
+  RAY_CHECK(ray::WaitForCondition([&num_done]() { return num_done == num_entries; },
+                                  60 * 1000));
+  double write_seconds = absl::ToDoubleSeconds(absl::Now() - start);
+  std::sort(latencies_us.begin(), latencies_us.end());
+
+  store_client.reset();
+  file_store.reset();
+  start = absl::Now();
+  file_store = std::make_shared<ray::gcs::FileStore>(dir, compaction_bytes);
+  double recovery_seconds = absl::ToDoubleSeconds(absl::Now() - start);
+  std::cout << num_entries << " writes took " << write_seconds
+            << "s, with a median latency of " << latencies_us[num_entries / 2]
+            << "us and a p99 latency of " << latencies_us[num_entries * 99 / 100]
+            << "us. Recovery took " << recovery_seconds << "s." << std::endl;
+
+  store_client = std::make_shared<ray::gcs::FileStoreClient>(io_service, file_store);
+  std::atomic<bool> recovered(false);
+  RAY_CHECK_OK(store_client->AsyncGetAll(
+      table_name,
+      [&recovered](const std::unordered_map<std::string, std::string> &result) {
+        RAY_CHECK(result.size() == num_entries);
+        recovered = true;
+      }));
+  RAY_CHECK(
+      ray::WaitForCondition([&recovered]() { return recovered.load(); }, 60 * 1000));
+
+  store_client.reset();
+  file_store.reset();
+  io_service.stop();
+  thread.join();
+  boost::filesystem::remove_all(dir);
+  return 0;
+}
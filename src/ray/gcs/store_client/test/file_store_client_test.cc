@@ -0,0 +1,145 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/file_store_client.h"
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#include "boost/filesystem.hpp"
+#include "ray/gcs/store_client/test/store_client_test_base.h"
+
+namespace ray {
+
+namespace gcs {
+
+class FileStoreClientTest : public StoreClientTestBase {
+ public:
+  void InitStoreClient() override {
+    dir_ = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+               .string();
+    Open(/*compaction_bytes=*/64 * 1024 * 1024);
+  }
+
+  void DisconnectStoreClient() override {
+    Close();
+    boost::filesystem::remove_all(dir_);
+  }
+
+ protected:
+  void Open(uint64_t compaction_bytes) {
+    file_store_ = std::make_shared<FileStore>(dir_, compaction_bytes);
+    store_client_ =
+        std::make_shared<FileStoreClient>(*(io_service_pool_->Get()), file_store_);
+  }
+
+  void Close() {
+    store_client_.reset();
+    file_store_.reset();
+  }
+
+  /// Close the store, and open it again from disk.
+  void Restart(uint64_t compaction_bytes = 64 * 1024 * 1024) {
+    Close();
+    Open(compaction_bytes);
+  }
+
+  std::string dir_;
+  std::shared_ptr<FileStore> file_store_;
+};
+
+TEST_F(FileStoreClientTest, AsyncPutAndAsyncGetTest) { TestAsyncPutAndAsyncGet(); }
+
+TEST_F(FileStoreClientTest, AsyncPutAndDeleteWithIndexTest) {
+  TestAsyncPutAndDeleteWithIndex();
+}
+
+TEST_F(FileStoreClientTest, AsyncGetAllAndBatchDeleteTest) {
+  TestAsyncGetAllAndBatchDelete();
+}
+
+TEST_F(FileStoreClientTest, TestAsyncDeleteWithIndex) { TestAsyncDeleteWithIndex(); }
+
+TEST_F(FileStoreClientTest, TestAsyncBatchDeleteWithIndex) {
+  TestAsyncBatchDeleteWithIndex();
+}
+
+TEST_F(FileStoreClientTest, TestRestart) {
+  PutWithIndex();
+  int job_id = store_client_->GetNextJobID();
+  Restart();
+  Get();
+  GetByIndex();
+  ASSERT_EQ(store_client_->GetNextJobID(), job_id + 1);
+
+  DeleteByIndex();
+  Restart();
+  GetEmpty();
+}
+
+TEST_F(FileStoreClientTest, TestCompaction) {
+  Restart(/*compaction_bytes=*/4096);
+  PutWithIndex();
+  ASSERT_TRUE(boost::filesystem::exists(dir_ + "/gcs_storage.snapshot"));
+  ASSERT_LT(file_store_->LogBytes(), 4096);
+
+  Restart(/*compaction_bytes=*/4096);
+  GetByIndex();
+  DeleteWithIndex();
+  Restart(/*compaction_bytes=*/4096);
+  GetEmpty();
+}
+
+TEST_F(FileStoreClientTest, TestWritesDuringCompaction) {
+  std::atomic<bool> stopped(false);
+  std::thread compactor([this, &stopped]() {
+    while (!stopped) {
+      file_store_->Compact();
+    }
+  });
+  PutWithIndex();
+  int job_id = store_client_->GetNextJobID();
+  stopped = true;
+  compactor.join();
+
+  Restart();
+  Get();
+  GetByIndex();
+  ASSERT_EQ(store_client_->GetNextJobID(), job_id + 1);
+}
+
+TEST_F(FileStoreClientTest, TestTornRecord) {
+  Put();
+  Close();
+  {
+    // Simulate a crash in the middle of writing a record.
+    std::ofstream log(dir_ + "/gcs_storage.log", std::ios::binary | std::ios::app);
+    log << "torn";
+  }
+  Open(/*compaction_bytes=*/64 * 1024 * 1024);
+  Get();
+  Delete();
+  Restart();
+  GetEmpty();
+}
+
+}  // namespace gcs
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
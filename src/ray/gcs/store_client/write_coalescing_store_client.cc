@@ -0,0 +1,306 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/store_client/write_coalescing_store_client.h"
+
+#include "ray/common/asio/asio_util.h"
+
+namespace ray {
+
+namespace gcs {
+
+WriteCoalescingStoreClient::WriteCoalescingStoreClient(
+    instrumented_io_context &io_service, std::shared_ptr<StoreClient> store_client,
+    uint32_t flush_interval_ms, size_t max_batch_size)
+    : io_service_(io_service),
+      store_client_(std::move(store_client)),
+      flush_interval_ms_(flush_interval_ms),
+      max_batch_size_(std::max<size_t>(max_batch_size, 1)) {}
+
+WriteCoalescingStoreClient::~WriteCoalescingStoreClient() {
+  absl::MutexLock lock(&mutex_);
+  if (flush_timer_) {
+    flush_timer_->cancel();
+  }
+}
+
+Status WriteCoalescingStoreClient::AsyncPut(const std::string &table_name,
+                                            const std::string &key,
+                                            const std::string &data,
+                                            const StatusCallback &callback) {
+  return BufferWrite(table_name, key, /*index_key=*/"", data, callback);
+}
+
+Status WriteCoalescingStoreClient::AsyncPutWithIndex(const std::string &table_name,
+                                                     const std::string &key,
+                                                     const std::string &index_key,
+                                                     const std::string &data,
+                                                     const StatusCallback &callback) {
+  return BufferWrite(table_name, key, index_key, data, callback);
+}
+
+Status WriteCoalescingStoreClient::BufferWrite(const std::string &table_name,
+                                               const std::string &key,
+                                               const std::string &index_key,
+                                               const std::string &data,
+                                               const StatusCallback &callback) {
+  bool flush = false;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto result = buffered_writes_[table_name].try_emplace(key);
+    if (result.second) {
+      ++num_buffered_writes_;
+    }
+    auto &write = result.first->second;
+    write.index_key = index_key;
+    write.data = data;
+    if (callback) {
+      write.callbacks.push_back(callback);
+    }
+    if (num_buffered_writes_ >= max_batch_size_) {
+      flush = true;
+    } else if (!flush_timer_) {
+      flush_timer_ = execute_after(
+          io_service_, [this]() { Flush(); }, flush_interval_ms_);
+    }
+  }
+  if (flush) {
+    Flush();
+  }
+  return Status::OK();
+}
+
+void WriteCoalescingStoreClient::Flush() {
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, BufferedWrite>>
+      buffered_writes;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (flush_timer_) {
+      flush_timer_->cancel();
+      flush_timer_ = nullptr;
+    }
+    buffered_writes.swap(buffered_writes_);
+    num_buffered_writes_ = 0;
+  }
+
+  for (auto &table : buffered_writes) {
+    std::vector<std::string> keys;
+    std::vector<std::string> index_keys;
+    std::vector<std::string> data;
+    auto callbacks = std::make_shared<std::vector<StatusCallback>>();
+    keys.reserve(table.second.size());
+    data.reserve(table.second.size());
+    // A table either indexes all of its keys or none of them.
+    const bool indexed = !table.second.begin()->second.index_key.empty();
+    for (auto &entry : table.second) {
+      keys.push_back(entry.first);
+      if (indexed) {
+        index_keys.push_back(std::move(entry.second.index_key));
+      }
+      data.push_back(std::move(entry.second.data));
+      for (auto &callback : entry.second.callbacks) {
+        callbacks->push_back(std::move(callback));
+      }
+    }
+    RAY_CHECK_OK(store_client_->AsyncBatchPut(
+        table.first, keys, index_keys, data, [callbacks](const Status &status) {
+          for (const auto &callback : *callbacks) {
+            callback(status);
+          }
+        }));
+  }
+}
+
+size_t WriteCoalescingStoreClient::NumBufferedWrites() {
+  absl::MutexLock lock(&mutex_);
+  return num_buffered_writes_;
+}
+
+Status WriteCoalescingStoreClient::AsyncGet(
+    const std::string &table_name, const std::string &key,
+    const OptionalItemCallback<std::string> &callback) {
+  {
+    absl::MutexLock lock(&mutex_);
+    auto table_it = buffered_writes_.find(table_name);
+    if (table_it != buffered_writes_.end()) {
+      auto it = table_it->second.find(key);
+      if (it != table_it->second.end()) {
+        boost::optional<std::string> data(it->second.data);
+        io_service_.post([callback, data]() { callback(Status::OK(), data); },
+                         "WriteCoalescingStoreClient.AsyncGet");
+        return Status::OK();
+      }
+    }
+  }
+  return store_client_->AsyncGet(table_name, key, callback);
+}
+
+Status WriteCoalescingStoreClient::AsyncGetByIndex(
+    const std::string &table_name, const std::string &index_key,
+    const MapCallback<std::string, std::string> &callback) {
+  // The buffered writes are flushed after the read is sent, so the read doesn't see
+  // them and they have to be merged into its result.
+  std::unordered_map<std::string, std::string> buffered;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto table_it = buffered_writes_.find(table_name);
+    if (table_it != buffered_writes_.end()) {
+      for (const auto &entry : table_it->second) {
+        if (entry.second.index_key == index_key) {
+          buffered.emplace(entry.first, entry.second.data);
+        }
+      }
+    }
+  }
+  return store_client_->AsyncGetByIndex(
+      table_name, index_key,
+      [callback, buffered](const std::unordered_map<std::string, std::string> &result) {
+        if (buffered.empty()) {
+          callback(result);
+          return;
+        }
+        auto merged = result;
+        for (const auto &entry : buffered) {
+          merged[entry.first] = entry.second;
+        }
+        callback(merged);
+      });
+}
+
+Status WriteCoalescingStoreClient::AsyncGetAll(
+    const std::string &table_name,
+    const MapCallback<std::string, std::string> &callback) {
+  std::unordered_map<std::string, std::string> buffered;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto table_it = buffered_writes_.find(table_name);
+    if (table_it != buffered_writes_.end()) {
+      for (const auto &entry : table_it->second) {
+        buffered.emplace(entry.first, entry.second.data);
+      }
+    }
+  }
+  return store_client_->AsyncGetAll(
+      table_name,
+      [callback, buffered](const std::unordered_map<std::string, std::string> &result) {
+        if (buffered.empty()) {
+          callback(result);
+          return;
+        }
+        auto merged = result;
+        for (const auto &entry : buffered) {
+          merged[entry.first] = entry.second;
+        }
+        callback(merged);
+      });
+}
+
+Status WriteCoalescingStoreClient::AsyncDelete(const std::string &table_name,
+                                               const std::string &key,
+                                               const StatusCallback &callback) {
+  auto dropped = DropBufferedWrites(table_name, {key});
+  return store_client_->AsyncDelete(table_name, key,
+                                    ChainCallbacks(callback, std::move(dropped)));
+}
+
+Status WriteCoalescingStoreClient::AsyncDeleteWithIndex(const std::string &table_name,
+                                                        const std::string &key,
+                                                        const std::string &index_key,
+                                                        const StatusCallback &callback) {
+  auto dropped = DropBufferedWrites(table_name, {key});
+  return store_client_->AsyncDeleteWithIndex(
+      table_name, key, index_key, ChainCallbacks(callback, std::move(dropped)));
+}
+
+Status WriteCoalescingStoreClient::AsyncBatchDelete(const std::string &table_name,
+                                                    const std::vector<std::string> &keys,
+                                                    const StatusCallback &callback) {
+  auto dropped = DropBufferedWrites(table_name, keys);
+  return store_client_->AsyncBatchDelete(table_name, keys,
+                                         ChainCallbacks(callback, std::move(dropped)));
+}
+
+Status WriteCoalescingStoreClient::AsyncBatchDeleteWithIndex(
+    const std::string &table_name, const std::vector<std::string> &keys,
+    const std::vector<std::string> &index_keys, const StatusCallback &callback) {
+  auto dropped = DropBufferedWrites(table_name, keys);
+  return store_client_->AsyncBatchDeleteWithIndex(
+      table_name, keys, index_keys, ChainCallbacks(callback, std::move(dropped)));
+}
+
+Status WriteCoalescingStoreClient::AsyncDeleteByIndex(const std::string &table_name,
+                                                      const std::string &index_key,
+                                                      const StatusCallback &callback) {
+  std::vector<std::string> keys;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto table_it = buffered_writes_.find(table_name);
+    if (table_it != buffered_writes_.end()) {
+      for (const auto &entry : table_it->second) {
+        if (entry.second.index_key == index_key) {
+          keys.push_back(entry.first);
+        }
+      }
+    }
+  }
+  auto dropped = DropBufferedWrites(table_name, keys);
+  return store_client_->AsyncDeleteByIndex(table_name, index_key,
+                                           ChainCallbacks(callback, std::move(dropped)));
+}
+
+int WriteCoalescingStoreClient::GetNextJobID() { return store_client_->GetNextJobID(); }
+
+std::vector<StatusCallback> WriteCoalescingStoreClient::DropBufferedWrites(
+    const std::string &table_name, const std::vector<std::string> &keys) {
+  std::vector<StatusCallback> dropped;
+  absl::MutexLock lock(&mutex_);
+  auto table_it = buffered_writes_.find(table_name);
+  if (table_it == buffered_writes_.end()) {
+    return dropped;
+  }
+  for (const auto &key : keys) {
+    auto it = table_it->second.find(key);
+    if (it == table_it->second.end()) {
+      continue;
+    }
+    for (auto &callback : it->second.callbacks) {
+      dropped.push_back(std::move(callback));
+    }
+    table_it->second.erase(it);
+    --num_buffered_writes_;
+  }
+  if (table_it->second.empty()) {
+    buffered_writes_.erase(table_it);
+  }
+  return dropped;
+}
+
+StatusCallback WriteCoalescingStoreClient::ChainCallbacks(
+    const StatusCallback &callback, std::vector<StatusCallback> dropped) {
+  if (dropped.empty()) {
+    return callback;
+  }
+  return [callback, dropped = std::move(dropped)](const Status &status) {
+    for (const auto &dropped_callback : dropped) {
+      dropped_callback(status);
+    }
+    if (callback) {
+      callback(status);
+    }
+  };
+}
+
+}  // namespace gcs
+
+}  // namespace ray
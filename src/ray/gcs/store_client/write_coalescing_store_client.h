@@ -0,0 +1,140 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio/deadline_timer.hpp>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/gcs/store_client/store_client.h"
+
+namespace ray {
+
+namespace gcs {
+
+/// \class WriteCoalescingStoreClient
+/// A write-behind buffer in front of another store client. Writes are buffered per key,
+/// so that a key that is written several times before the buffer is flushed is only
+/// written once, with its last value. The buffer is flushed with one batch write per
+/// table, `flush_interval_ms` after the first buffered write or as soon as
+/// `max_batch_size` keys are buffered. The callback of a write is called once the
+/// batch that contains the write (or a later write of the same key) is written by the
+/// underlying store client.
+///
+/// Reads see the buffered writes, and deletes drop the buffered writes of the deleted
+/// keys before they are forwarded.
+///
+/// This class is thread safe.
+class WriteCoalescingStoreClient : public StoreClient {
+ public:
+  /// Create a write-behind buffer.
+  ///
+  /// \param io_service The event loop that runs the flush timer and the callbacks of
+  /// buffered reads.
+  /// \param store_client The store client that the writes are flushed to.
+  /// \param flush_interval_ms The maximum time a write is buffered.
+  /// \param max_batch_size The number of buffered keys that triggers a flush.
+  WriteCoalescingStoreClient(instrumented_io_context &io_service,
+                             std::shared_ptr<StoreClient> store_client,
+                             uint32_t flush_interval_ms, size_t max_batch_size);
+
+  ~WriteCoalescingStoreClient();
+
+  Status AsyncPut(const std::string &table_name, const std::string &key,
+                  const std::string &data, const StatusCallback &callback) override;
+
+  Status AsyncPutWithIndex(const std::string &table_name, const std::string &key,
+                           const std::string &index_key, const std::string &data,
+                           const StatusCallback &callback) override;
+
+  Status AsyncGet(const std::string &table_name, const std::string &key,
+                  const OptionalItemCallback<std::string> &callback) override;
+
+  Status AsyncGetByIndex(const std::string &table_name, const std::string &index_key,
+                         const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncGetAll(const std::string &table_name,
+                     const MapCallback<std::string, std::string> &callback) override;
+
+  Status AsyncDelete(const std::string &table_name, const std::string &key,
+                     const StatusCallback &callback) override;
+
+  Status AsyncDeleteWithIndex(const std::string &table_name, const std::string &key,
+                              const std::string &index_key,
+                              const StatusCallback &callback) override;
+
+  Status AsyncBatchDelete(const std::string &table_name,
+                          const std::vector<std::string> &keys,
+                          const StatusCallback &callback) override;
+
+  Status AsyncBatchDeleteWithIndex(const std::string &table_name,
+                                   const std::vector<std::string> &keys,
+                                   const std::vector<std::string> &index_keys,
+                                   const StatusCallback &callback) override;
+
+  Status AsyncDeleteByIndex(const std::string &table_name, const std::string &index_key,
+                            const StatusCallback &callback) override;
+
+  int GetNextJobID() override;
+
+  /// Write all the buffered writes to the underlying store client now.
+  void Flush();
+
+  /// Get the number of keys whose writes are buffered.
+  size_t NumBufferedWrites() LOCKS_EXCLUDED(mutex_);
+
+ private:
+  /// The last buffered value of a key, and the callbacks of all the buffered writes of
+  /// the key.
+  struct BufferedWrite {
+    std::string index_key;
+    std::string data;
+    std::vector<StatusCallback> callbacks;
+  };
+
+  /// Buffer a write, and flush the buffer if it's full.
+  Status BufferWrite(const std::string &table_name, const std::string &key,
+                     const std::string &index_key, const std::string &data,
+                     const StatusCallback &callback);
+
+  /// Drop the buffered writes of the given keys.
+  ///
+  /// \return The callbacks of the dropped writes.
+  std::vector<StatusCallback> DropBufferedWrites(const std::string &table_name,
+                                                 const std::vector<std::string> &keys);
+
+  /// Chain the callbacks of the writes that a delete dropped to the callback of the
+  /// delete, because they are durable once the delete is.
+  static StatusCallback ChainCallbacks(const StatusCallback &callback,
+                                       std::vector<StatusCallback> dropped);
+
+  instrumented_io_context &io_service_;
+  std::shared_ptr<StoreClient> store_client_;
+  const uint32_t flush_interval_ms_;
+  const size_t max_batch_size_;
+
+  absl::Mutex mutex_;
+  /// The buffered writes, by table name and key.
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, BufferedWrite>>
+      buffered_writes_ GUARDED_BY(mutex_);
+  size_t num_buffered_writes_ GUARDED_BY(mutex_) = 0;
+  /// The timer of the next flush. Only set while writes are buffered.
+  std::shared_ptr<boost::asio::deadline_timer> flush_timer_ GUARDED_BY(mutex_);
+};
+
+}  // namespace gcs
+
+}  // namespace ray
@@ -0,0 +1,218 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/cpu_affinity.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <tuple>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+
+/// Read a single integer from a sysfs file. Returns false if it can't be read.
+bool ReadIntFromFile(const std::string &path, int *value) {
+  std::ifstream file(path);
+  int result;
+  if (!(file >> result)) {
+    return false;
+  }
+  *value = result;
+  return true;
+}
+
+}  // namespace
+
+CpuAffinity::CpuAffinity(std::vector<LogicalCpu> topology) {
+  std::sort(topology.begin(), topology.end(),
+            [](const LogicalCpu &a, const LogicalCpu &b) {
+              return std::tie(a.numa_node, a.package_id, a.core_id, a.cpu_id) <
+                     std::tie(b.numa_node, b.package_id, b.core_id, b.cpu_id);
+            });
+  // The rank of each CPU among the hyperthreads of its physical core.
+  std::vector<std::pair<int, LogicalCpu>> ranked;
+  for (size_t i = 0; i < topology.size(); i++) {
+    int rank = 0;
+    if (i > 0) {
+      const auto &prev = topology[i - 1];
+      const auto &cpu = topology[i];
+      if (std::tie(prev.numa_node, prev.package_id, prev.core_id) ==
+          std::tie(cpu.numa_node, cpu.package_id, cpu.core_id)) {
+        rank = ranked.back().first + 1;
+      }
+    }
+    ranked.emplace_back(rank, topology[i]);
+  }
+  // Use the first hyperthread of every core before any of the siblings, and keep
+  // the NUMA node order within each rank.
+  std::stable_sort(
+      ranked.begin(), ranked.end(),
+      [](const std::pair<int, LogicalCpu> &a, const std::pair<int, LogicalCpu> &b) {
+        return a.first < b.first;
+      });
+  for (const auto &entry : ranked) {
+    pinning_order_.push_back(entry.second.cpu_id);
+  }
+}
+
+CpuAffinity CpuAffinity::FromLocalMachine(const std::string &cpu_list) {
+  std::vector<int> cpu_ids;
+  if (!cpu_list.empty()) {
+    cpu_ids = ParseCpuList(cpu_list);
+    if (cpu_ids.empty()) {
+      RAY_LOG(WARNING) << "Ignoring the malformed CPU list \"" << cpu_list << "\".";
+    }
+  }
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (cpu_ids.empty() && sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+    for (int cpu_id = 0; cpu_id < CPU_SETSIZE; cpu_id++) {
+      if (CPU_ISSET(cpu_id, &cpu_set)) {
+        cpu_ids.push_back(cpu_id);
+      }
+    }
+  }
+#endif
+  if (cpu_ids.empty()) {
+    for (int cpu_id = 0; cpu_id < static_cast<int>(std::thread::hardware_concurrency());
+         cpu_id++) {
+      cpu_ids.push_back(cpu_id);
+    }
+  }
+  return CpuAffinity(ReadTopology("/sys/devices/system/cpu", cpu_ids));
+}
+
+std::vector<int> CpuAffinity::GetCpuIds(const std::vector<double> &cpu_instances,
+                                        size_t *num_unmapped) const {
+  std::vector<int> cpu_ids;
+  bool has_whole_instance = false;
+  size_t unmapped = 0;
+  for (size_t i = 0; i < cpu_instances.size(); i++) {
+    if (cpu_instances[i] <= 0.) {
+      continue;
+    }
+    if (i >= pinning_order_.size()) {
+      unmapped++;
+      continue;
+    }
+    has_whole_instance |= cpu_instances[i] >= 1.;
+    cpu_ids.push_back(pinning_order_[i]);
+  }
+  if (num_unmapped != nullptr) {
+    *num_unmapped = unmapped;
+  }
+  if (!has_whole_instance) {
+    cpu_ids.clear();
+  }
+  return cpu_ids;
+}
+
+Status CpuAffinity::SetProcessAffinity(pid_t pid, const std::vector<int> &cpu_ids) const {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu_id : cpu_ids.empty() ? pinning_order_ : cpu_ids) {
+    if (cpu_id >= 0 && cpu_id < CPU_SETSIZE) {
+      CPU_SET(cpu_id, &cpu_set);
+    }
+  }
+  // The affinity is per thread, and the threads the worker has already started don't
+  // inherit it from the main thread.
+  std::vector<pid_t> thread_ids;
+  boost::system::error_code ec;
+  boost::filesystem::directory_iterator it("/proc/" + std::to_string(pid) + "/task",
+                                           ec);
+  for (; !ec && it != boost::filesystem::directory_iterator(); it.increment(ec)) {
+    int thread_id;
+    if (absl::SimpleAtoi(it->path().filename().string(), &thread_id)) {
+      thread_ids.push_back(thread_id);
+    }
+  }
+  if (thread_ids.empty()) {
+    thread_ids.push_back(pid);
+  }
+  for (pid_t thread_id : thread_ids) {
+    // The thread may have exited in the meantime.
+    if (sched_setaffinity(thread_id, sizeof(cpu_set), &cpu_set) != 0 && errno != ESRCH) {
+      return Status::IOError("Failed to set the CPU affinity of process " +
+                             std::to_string(pid) + ": " + strerror(errno));
+    }
+  }
+  return Status::OK();
+#else
+  return Status::NotImplemented("Setting the CPU affinity is only supported on Linux.");
+#endif
+}
+
+std::vector<LogicalCpu> CpuAffinity::ReadTopology(const std::string &sysfs_cpu_dir,
+                                                  const std::vector<int> &cpu_ids) {
+  std::vector<LogicalCpu> topology;
+  for (int cpu_id : cpu_ids) {
+    const std::string cpu_dir = sysfs_cpu_dir + "/cpu" + std::to_string(cpu_id);
+    LogicalCpu cpu{cpu_id, /*numa_node=*/0, /*package_id=*/0, /*core_id=*/cpu_id};
+    ReadIntFromFile(cpu_dir + "/topology/physical_package_id", &cpu.package_id);
+    ReadIntFromFile(cpu_dir + "/topology/core_id", &cpu.core_id);
+    // The NUMA node is only exposed as a `nodeN` link in the CPU's directory.
+    boost::system::error_code ec;
+    boost::filesystem::directory_iterator it(cpu_dir, ec);
+    for (; !ec && it != boost::filesystem::directory_iterator(); it.increment(ec)) {
+      const std::string name = it->path().filename().string();
+      int numa_node;
+      if (name.rfind("node", 0) == 0 && absl::SimpleAtoi(name.substr(4), &numa_node)) {
+        cpu.numa_node = numa_node;
+        break;
+      }
+    }
+    topology.push_back(cpu);
+  }
+  return topology;
+}
+
+std::vector<int> CpuAffinity::ParseCpuList(const std::string &cpu_list) {
+  std::vector<int> cpu_ids;
+  for (absl::string_view range :
+       absl::StrSplit(cpu_list, ',', absl::SkipWhitespace())) {
+    std::vector<absl::string_view> bounds = absl::StrSplit(range, '-');
+    int first;
+    int last;
+    if (bounds.size() > 2 || !absl::SimpleAtoi(bounds[0], &first) ||
+        !absl::SimpleAtoi(bounds.back(), &last) || first < 0 || last < first) {
+      return {};
+    }
+    for (int cpu_id = first; cpu_id <= last; cpu_id++) {
+      cpu_ids.push_back(cpu_id);
+    }
+  }
+  return cpu_ids;
+}
+
+}  // namespace raylet
+
+}  // namespace ray
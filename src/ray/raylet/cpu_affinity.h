@@ -0,0 +1,100 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ray/common/status.h"
+#include "ray/util/process.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// A logical CPU (hardware thread) and its place in the machine topology.
+struct LogicalCpu {
+  /// The ID used by the OS, e.g., in `sched_setaffinity`.
+  int cpu_id;
+  /// The NUMA node the CPU belongs to.
+  int numa_node;
+  /// The physical package (socket) the CPU belongs to.
+  int package_id;
+  /// The physical core the CPU belongs to. Hyperthread siblings share it.
+  int core_id;
+};
+
+/// \class CpuAffinity
+///
+/// Maps the instances of the CPU resource to concrete logical CPUs, so that workers
+/// that are allocated whole CPUs can be pinned to them. Instances are mapped in an
+/// order that keeps consecutive instances on the same NUMA node and uses one
+/// hyperthread per physical core before using their siblings, since the scheduler
+/// allocates whole instances in index order.
+class CpuAffinity {
+ public:
+  /// \param topology The logical CPUs that workers may be pinned to.
+  explicit CpuAffinity(std::vector<LogicalCpu> topology);
+
+  /// Create a CpuAffinity for the CPUs of the local machine.
+  ///
+  /// \param cpu_list The CPUs that workers may be pinned to, in the format of
+  /// `ParseCpuList`. If empty, these are the CPUs the raylet itself may run on.
+  static CpuAffinity FromLocalMachine(const std::string &cpu_list);
+
+  /// The logical CPU IDs that the given allocation of CPU instances should be pinned
+  /// to. An allocation is only pinned if it has at least one whole instance, in which
+  /// case it is pinned to every instance it has a share of. E.g., 1.5 CPUs are pinned
+  /// to two CPUs, one of which is shared with (unpinned) fractional workers.
+  ///
+  /// \param[in] cpu_instances The allocated quantity of each CPU instance.
+  /// \param[out] num_unmapped If not null, set to the number of allocated instances
+  /// that have no logical CPU to be pinned to.
+  /// \return The logical CPU IDs, or an empty vector if nothing should be pinned.
+  std::vector<int> GetCpuIds(const std::vector<double> &cpu_instances,
+                             size_t *num_unmapped = nullptr) const;
+
+  /// All logical CPU IDs, in the order that CPU instances are mapped to them.
+  const std::vector<int> &GetPinningOrder() const { return pinning_order_; }
+
+  /// Restrict all threads of a process to the given logical CPUs.
+  ///
+  /// \param pid The process to pin.
+  /// \param cpu_ids The logical CPU IDs. If empty, the process may run on any CPU
+  /// known to this CpuAffinity.
+  /// \return Status::NotImplemented if not supported on this platform.
+  Status SetProcessAffinity(pid_t pid, const std::vector<int> &cpu_ids) const;
+
+  /// Read the topology of the given logical CPUs from sysfs. Missing topology
+  /// information is filled in as if each CPU were its own core on NUMA node 0.
+  ///
+  /// \param sysfs_cpu_dir Usually `/sys/devices/system/cpu`.
+  /// \param cpu_ids The logical CPU IDs.
+  static std::vector<LogicalCpu> ReadTopology(const std::string &sysfs_cpu_dir,
+                                              const std::vector<int> &cpu_ids);
+
+  /// Parse a Linux CPU list, e.g., "0-3,8,10-11".
+  ///
+  /// \return The logical CPU IDs, or an empty vector if the list is malformed.
+  static std::vector<int> ParseCpuList(const std::string &cpu_list);
+
+ private:
+  /// The logical CPU ID of each CPU instance, in instance order.
+  std::vector<int> pinning_order_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,125 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/cpu_affinity.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// Two NUMA nodes with two cores each, and two hyperthreads per core. The IDs are
+/// interleaved across the nodes like on many dual-socket machines.
+std::vector<LogicalCpu> DualSocketTopology() {
+  return {
+      {0, 0, 0, 0}, {1, 1, 1, 0}, {2, 0, 0, 1}, {3, 1, 1, 1},
+      {4, 0, 0, 0}, {5, 1, 1, 0}, {6, 0, 0, 1}, {7, 1, 1, 1},
+  };
+}
+
+TEST(CpuAffinityTest, PinningOrder) {
+  CpuAffinity cpu_affinity(DualSocketTopology());
+  // One hyperthread per core first, NUMA node by NUMA node, then the siblings.
+  ASSERT_EQ(cpu_affinity.GetPinningOrder(), std::vector<int>({0, 2, 1, 3, 4, 6, 5, 7}));
+}
+
+TEST(CpuAffinityTest, GetCpuIds) {
+  CpuAffinity cpu_affinity(DualSocketTopology());
+  ASSERT_EQ(cpu_affinity.GetCpuIds({1, 1, 0, 0, 0, 0, 0, 0}), std::vector<int>({0, 2}));
+  // The fractional part of an allocation above one CPU is pinned to its shared CPU.
+  ASSERT_EQ(cpu_affinity.GetCpuIds({0, 0.5, 1, 0, 0, 0, 0, 0}),
+            std::vector<int>({2, 1}));
+  // Allocations without a whole CPU aren't pinned.
+  ASSERT_TRUE(cpu_affinity.GetCpuIds({0.5}).empty());
+  ASSERT_TRUE(cpu_affinity.GetCpuIds({0, 0.25, 0.5}).empty());
+  ASSERT_TRUE(cpu_affinity.GetCpuIds({}).empty());
+  // Instances beyond the known CPUs can't be pinned, and are reported.
+  size_t num_unmapped = 0;
+  ASSERT_EQ(cpu_affinity.GetCpuIds({0, 0, 0, 0, 0, 0, 0, 1, 1, 0}, &num_unmapped),
+            std::vector<int>({7}));
+  ASSERT_EQ(num_unmapped, 1);
+  ASSERT_TRUE(cpu_affinity.GetCpuIds({0, 0, 0, 0, 0, 0, 0, 0, 1}, &num_unmapped).empty());
+  ASSERT_EQ(num_unmapped, 1);
+  cpu_affinity.GetCpuIds({1, 1}, &num_unmapped);
+  ASSERT_EQ(num_unmapped, 0);
+}
+
+TEST(CpuAffinityTest, ParseCpuList) {
+  ASSERT_EQ(CpuAffinity::ParseCpuList("0-3,8,10-11"),
+            std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+  ASSERT_EQ(CpuAffinity::ParseCpuList("5"), std::vector<int>({5}));
+  ASSERT_TRUE(CpuAffinity::ParseCpuList("").empty());
+  ASSERT_TRUE(CpuAffinity::ParseCpuList("3-1").empty());
+  ASSERT_TRUE(CpuAffinity::ParseCpuList("a-b").empty());
+  ASSERT_TRUE(CpuAffinity::ParseCpuList("1-2-3").empty());
+}
+
+TEST(CpuAffinityTest, ReadTopology) {
+  auto sysfs_cpu_dir =
+      boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  auto write_cpu = [&sysfs_cpu_dir](int cpu_id, int numa_node, int package_id,
+                                    int core_id) {
+    auto cpu_dir = sysfs_cpu_dir / ("cpu" + std::to_string(cpu_id));
+    boost::filesystem::create_directories(cpu_dir / "topology");
+    boost::filesystem::create_directories(cpu_dir / ("node" + std::to_string(numa_node)));
+    std::ofstream((cpu_dir / "topology" / "physical_package_id").string()) << package_id;
+    std::ofstream((cpu_dir / "topology" / "core_id").string()) << core_id;
+  };
+  write_cpu(0, 0, 0, 0);
+  write_cpu(1, 1, 1, 0);
+  write_cpu(2, 0, 0, 0);
+
+  auto topology = CpuAffinity::ReadTopology(sysfs_cpu_dir.string(), {0, 1, 2, 3});
+  ASSERT_EQ(topology.size(), 4);
+  ASSERT_EQ(topology[1].cpu_id, 1);
+  ASSERT_EQ(topology[1].numa_node, 1);
+  ASSERT_EQ(topology[1].package_id, 1);
+  ASSERT_EQ(topology[2].core_id, 0);
+  // Missing topology information is filled in.
+  ASSERT_EQ(topology[3].numa_node, 0);
+  ASSERT_EQ(topology[3].core_id, 3);
+  ASSERT_EQ(CpuAffinity(topology).GetPinningOrder(), std::vector<int>({0, 3, 1, 2}));
+  boost::filesystem::remove_all(sysfs_cpu_dir);
+}
+
+#ifdef __linux__
+TEST(CpuAffinityTest, SetProcessAffinity) {
+  auto cpu_affinity = CpuAffinity::FromLocalMachine("");
+  const auto &cpu_ids = cpu_affinity.GetPinningOrder();
+  ASSERT_FALSE(cpu_ids.empty());
+  ASSERT_TRUE(cpu_affinity.SetProcessAffinity(getpid(), {cpu_ids.back()}).ok());
+  cpu_set_t cpu_set;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set), &cpu_set), 0);
+  ASSERT_EQ(CPU_COUNT(&cpu_set), 1);
+  ASSERT_TRUE(CPU_ISSET(cpu_ids.back(), &cpu_set));
+
+  // Unpinning restores all CPUs.
+  ASSERT_TRUE(cpu_affinity.SetProcessAffinity(getpid(), {}).ok());
+  ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set), &cpu_set), 0);
+  ASSERT_EQ(CPU_COUNT(&cpu_set), static_cast<int>(cpu_ids.size()));
+}
+#endif
+
+}  // namespace raylet
+
+}  // namespace ray
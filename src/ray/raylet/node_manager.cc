@@ -23,15 +23,19 @@
 #include "boost/system/error_code.hpp"
 #include "ray/common/asio/asio_util.h"
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/broadcast_tree.h"
 #include "ray/common/buffer.h"
 #include "ray/common/common_protocol.h"
 #include "ray/common/constants.h"
+#include "ray/common/resource_usage_delta.h"
 #include "ray/common/status.h"
+#include "ray/common/task/task_event_buffer.h"
 #include "ray/gcs/pb_util.h"
 #include "ray/raylet/format/node_manager_generated.h"
 #include "ray/stats/stats.h"
 #include "ray/util/event.h"
 #include "ray/util/event_label.h"
+#include "ray/util/filesystem.h"
 #include "ray/util/sample.h"
 #include "ray/util/util.h"
 
@@ -306,6 +310,8 @@ NodeManager::NodeManager(instrumented_io_context &io_service, const NodeID &self
           self_node_id_.Binary(), local_resources.GetTotalResources().GetResourceMap(),
           *gcs_client_, [this]() { return object_manager_.GetUsedMemory(); },
           [this]() { return object_manager_.PullManagerHasPullsQueued(); }));
+  cluster_resource_scheduler_->SetNodeTopologyPath(self_node_id_.Binary(),
+                                                   config.topology_path);
 
   auto get_node_info_func = [this](const NodeID &node_id) {
     return gcs_client_->Nodes().Get(node_id);
@@ -361,6 +367,22 @@ NodeManager::NodeManager(instrumented_io_context &io_service, const NodeID &self
   node_manager_server_.Run();
 
   worker_pool_.SetNodeManagerPort(GetServerPort());
+  if (!config.session_dir.empty()) {
+    worker_pool_.SetForkServerSocketDir(JoinPaths(config.session_dir, "sockets"));
+  }
+  if (RayConfig::instance().task_events_buffer_size() > 0 &&
+      !RayConfig::instance().task_events_buffer_directory().empty()) {
+    task_events_directory_ = TaskEventBuffer::GetNodeDirectory(
+        RayConfig::instance().task_events_buffer_directory(), self_node_id_);
+    boost::system::error_code error_code;
+    boost::filesystem::create_directories(task_events_directory_, error_code);
+    if (error_code) {
+      RAY_LOG(WARNING) << "Failed to create the task event directory "
+                       << task_events_directory_ << ", error: " << error_code.message()
+                       << ". Task events are only kept in the memory of the workers.";
+      task_events_directory_.clear();
+    }
+  }
 
   auto agent_command_line = ParseCommandLine(config.agent_command);
   for (auto &arg : agent_command_line) {
@@ -556,13 +578,17 @@ void NodeManager::HandleJobFinished(const JobID &job_id, const JobTableData &job
 void NodeManager::FillNormalTaskResourceUsage(rpc::ResourcesData &resources_data) {
   auto last_heartbeat_resources = gcs_client_->NodeResources().GetLastResourceUsage();
   ResourceSet normal_task_resources = cluster_task_manager_->CalcNormalTaskResources();
-  if (!last_heartbeat_resources->GetNormalTaskResources().IsEqual(
-          normal_task_resources)) {
-    RAY_LOG(DEBUG) << "normal_task_resources = " << normal_task_resources.ToString();
-    resources_data.set_resources_normal_task_changed(true);
+  bool changed =
+      !last_heartbeat_resources->GetNormalTaskResources().IsEqual(normal_task_resources);
+  // Delta encoded reports are computed from full reports, which always include the map.
+  if (changed || RayConfig::instance().resource_report_delta_encoding()) {
     auto &normal_task_map = *(resources_data.mutable_resources_normal_task());
     normal_task_map = {normal_task_resources.GetResourceMap().begin(),
                        normal_task_resources.GetResourceMap().end()};
+  }
+  if (changed) {
+    RAY_LOG(DEBUG) << "normal_task_resources = " << normal_task_resources.ToString();
+    resources_data.set_resources_normal_task_changed(true);
     resources_data.set_resources_normal_task_timestamp(absl::GetCurrentTimeNanos());
     last_heartbeat_resources->SetNormalTaskResources(normal_task_resources);
   }
@@ -775,6 +801,8 @@ void NodeManager::NodeAdded(const GcsNodeInfo &node_info) {
   // Store address of the new node manager for rpc requests.
   remote_node_manager_addresses_[node_id] =
       std::make_pair(node_info.node_manager_address(), node_info.node_manager_port());
+  cluster_resource_scheduler_->SetNodeTopologyPath(node_id.Binary(),
+                                                   node_info.topology_path());
 
   // Fetch resource info for the remote node and update cluster resource map.
   RAY_CHECK_OK(gcs_client_->NodeResources().AsyncGetResources(
@@ -831,6 +859,7 @@ void NodeManager::NodeRemoved(const NodeID &node_id) {
   if (node_entry != remote_node_manager_addresses_.end()) {
     remote_node_manager_addresses_.erase(node_entry);
   }
+  resource_relay_clients_.erase(node_id);
 
   // Notify the object directory that the node has been removed so that it
   // can remove it from any cached locations.
@@ -929,6 +958,12 @@ void NodeManager::ResourceDeleted(const NodeID &node_id,
 void NodeManager::UpdateResourceUsage(const NodeID &node_id,
                                       const rpc::ResourcesData &resource_data) {
   if (!cluster_resource_scheduler_->UpdateNode(node_id.Binary(), resource_data)) {
+    if (resource_data.is_delta()) {
+      RAY_LOG(DEBUG) << "[UpdateResourceUsage]: missed a resource report of node "
+                     << node_id << ", resyncing from the GCS.";
+      ResyncResourceUsage();
+      return;
+    }
     RAY_LOG(INFO)
         << "[UpdateResourceUsage]: received resource usage from unknown node id "
         << node_id;
@@ -945,6 +980,23 @@ void NodeManager::UpdateResourceUsage(const NodeID &node_id,
   cluster_task_manager_->ScheduleAndDispatchTasks();
 }
 
+void NodeManager::ResyncResourceUsage() {
+  if (resource_resync_in_flight_) {
+    return;
+  }
+  resource_resync_in_flight_ = true;
+  RAY_CHECK_OK(gcs_client_->NodeResources().AsyncGetAllResourceUsage(
+      [this](const rpc::ResourceUsageBatchData &batch) {
+        resource_resync_in_flight_ = false;
+        for (const auto &resource_usage : batch.batch()) {
+          const NodeID &node_id = NodeID::FromBinary(resource_usage.node_id());
+          if (node_id != self_node_id_ && !resource_usage.is_delta()) {
+            UpdateResourceUsage(node_id, resource_usage);
+          }
+        }
+      }));
+}
+
 void NodeManager::ResourceUsageBatchReceived(
     const ResourceUsageBatchData &resource_usage_batch) {
   // Update load information provided by each message.
@@ -1215,6 +1267,14 @@ void NodeManager::DisconnectClient(
   // Erase any lease metadata.
   leased_workers_.erase(worker->WorkerId());
 
+  // Remove the task event buffer that the worker leaves behind if it didn't exit
+  // cleanly.
+  if (!task_events_directory_.empty()) {
+    boost::system::error_code error_code;
+    boost::filesystem::remove(
+        TaskEventBuffer::GetPath(task_events_directory_, worker->WorkerId()), error_code);
+  }
+
   if (creation_task_exception != nullptr) {
     RAY_LOG(INFO) << "Formatted creation task exception: "
                   << creation_task_exception->formatted_exception_string()
@@ -1472,9 +1532,25 @@ void NodeManager::ProcessPushErrorRequestMessage(const uint8_t *message_data) {
 void NodeManager::HandleUpdateResourceUsage(
     const rpc::UpdateResourceUsageRequest &request, rpc::UpdateResourceUsageReply *reply,
     rpc::SendReplyCallback send_reply_callback) {
+  if (request.relay_addresses_size() > 0) {
+    RelayResourceUsage(
+        std::make_shared<std::string>(request.serialized_resource_usage_batch()),
+        std::vector<rpc::Address>(request.relay_addresses().begin(),
+                                  request.relay_addresses().end()));
+  }
+
   rpc::ResourceUsageBroadcastData resource_usage_batch;
   resource_usage_batch.ParseFromString(request.serialized_resource_usage_batch());
 
+  if (resource_usage_batch.seq_no() < next_resource_seq_no_) {
+    // Batches relayed along different paths of the broadcast tree may arrive out of
+    // order. Don't let an older batch overwrite the newer view.
+    RAY_LOG(DEBUG) << "Dropping a stale resource broadcast, expected seq#: "
+                   << next_resource_seq_no_
+                   << ", but got: " << resource_usage_batch.seq_no() << ".";
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
   if (resource_usage_batch.seq_no() != next_resource_seq_no_) {
     RAY_LOG(WARNING)
         << "Raylet may have missed a resource broadcast. This either means that GCS has "
@@ -1514,13 +1590,65 @@ void NodeManager::HandleUpdateResourceUsage(
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
+void NodeManager::RelayResourceUsage(const std::shared_ptr<std::string> &serialized_batch,
+                                     const std::vector<rpc::Address> &receivers) {
+  for (const auto &subtree : SplitBroadcastTree(
+           receivers, RayConfig::instance().resource_broadcast_relay_fanout())) {
+    const auto &address = subtree.first;
+    const auto node_id = NodeID::FromBinary(address.raylet_id());
+    auto it = resource_relay_clients_.find(node_id);
+    if (it == resource_relay_clients_.end()) {
+      it = resource_relay_clients_
+               .emplace(node_id, rpc::NodeManagerWorkerClient::make(
+                                     address.ip_address(), address.port(),
+                                     client_call_manager_))
+               .first;
+    }
+    rpc::UpdateResourceUsageRequest request;
+    request.set_serialized_resource_usage_batch(*serialized_batch);
+    for (const auto &relay_address : subtree.second) {
+      request.add_relay_addresses()->CopyFrom(relay_address);
+    }
+    it->second->UpdateResourceUsage(
+        request, [this, serialized_batch, relay_addresses = subtree.second](
+                     const Status &status, const rpc::UpdateResourceUsageReply &reply) {
+          if (!status.ok() && !relay_addresses.empty()) {
+            RAY_LOG(DEBUG) << "Failed to relay a resource broadcast, relaying it to the "
+                           << relay_addresses.size()
+                           << " nodes in the subtree instead: " << status.ToString();
+            RelayResourceUsage(serialized_batch, relay_addresses);
+          }
+        });
+  }
+}
+
 void NodeManager::HandleRequestResourceReport(
     const rpc::RequestResourceReportRequest &request,
     rpc::RequestResourceReportReply *reply, rpc::SendReplyCallback send_reply_callback) {
   auto resources_data = reply->mutable_resources();
-  FillResourceReport(*resources_data);
-  resources_data->set_cluster_full_of_actors_detected(resource_deadlock_warned_ >= 1);
+  if (!RayConfig::instance().resource_report_delta_encoding()) {
+    FillResourceReport(*resources_data);
+    resources_data->set_cluster_full_of_actors_detected(resource_deadlock_warned_ >= 1);
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
 
+  auto report = std::make_unique<rpc::ResourcesData>();
+  FillResourceReport(*report);
+  report->set_cluster_full_of_actors_detected(resource_deadlock_warned_ >= 1);
+  if (last_resource_report_ != nullptr &&
+      request.last_applied_version() == last_resource_report_->version()) {
+    // The GCS has the last report, so only send what changed since then.
+    report->set_version(resource_report_version_ + 1);
+    if (ComputeResourceUsageDelta(*last_resource_report_, *report, resources_data)) {
+      resource_report_version_++;
+      last_resource_report_ = std::move(report);
+    }
+  } else {
+    report->set_version(++resource_report_version_);
+    resources_data->CopyFrom(*report);
+    last_resource_report_ = std::move(report);
+  }
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
@@ -2169,6 +2297,19 @@ void NodeManager::HandleGetGcsServerAddress(
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
+void NodeManager::HandleGetTaskEventsTrace(const rpc::GetTaskEventsTraceRequest &request,
+                                           rpc::GetTaskEventsTraceReply *reply,
+                                           rpc::SendReplyCallback send_reply_callback) {
+  if (task_events_directory_.empty()) {
+    send_reply_callback(
+        Status::Invalid("Task event buffers are disabled on this node."), nullptr,
+        nullptr);
+    return;
+  }
+  auto status = ReadTaskEventsTrace(task_events_directory_, reply->mutable_trace());
+  send_reply_callback(status, nullptr, nullptr);
+}
+
 void NodeManager::HandleGetNodeStats(const rpc::GetNodeStatsRequest &node_stats_request,
                                      rpc::GetNodeStatsReply *reply,
                                      rpc::SendReplyCallback send_reply_callback) {
@@ -2432,6 +2573,10 @@ void NodeManager::TriggerGlobalGC() {
 
 void NodeManager::Stop() {
   object_manager_.Stop();
+  if (!task_events_directory_.empty()) {
+    boost::system::error_code error_code;
+    boost::filesystem::remove_all(task_events_directory_, error_code);
+  }
   if (heartbeat_sender_) {
     heartbeat_sender_.reset();
   }
@@ -96,6 +96,8 @@ struct NodeManagerConfig {
   std::string resource_dir;
   /// If true make Ray debugger available externally.
   int ray_debugger_external;
+  /// The topology path of this node, e.g., "us-west-2a/rack-17", or empty if unknown.
+  std::string topology_path;
   /// The raylet config list of this node.
   std::string raylet_config;
   // The time between record metrics in milliseconds, or 0 to disable.
@@ -261,6 +263,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// \return Void.
   void UpdateResourceUsage(const NodeID &id, const rpc::ResourcesData &data);
 
+  /// Resync the views of the remote nodes with the full resource reports stored in the
+  /// GCS. This is needed when a delta encoded report of a node was missed.
+  void ResyncResourceUsage();
+
   /// Handler for a resource usage batch notification from the GCS
   ///
   /// \param resource_usage_batch The batch of resource usage data.
@@ -464,6 +470,15 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
                                  rpc::UpdateResourceUsageReply *reply,
                                  rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Relay a resource broadcast to the given raylets along a broadcast tree. If a
+  /// child can't be reached, the batch is relayed to the raylets in its subtree
+  /// instead.
+  ///
+  /// \param serialized_batch The serialized ResourceUsageBroadcastData.
+  /// \param receivers The raylets that this raylet is responsible for.
+  void RelayResourceUsage(const std::shared_ptr<std::string> &serialized_batch,
+                          const std::vector<rpc::Address> &receivers);
+
   /// Handle a `RequestResourceReport` request.
   void HandleRequestResourceReport(const rpc::RequestResourceReportRequest &request,
                                    rpc::RequestResourceReportReply *reply,
@@ -553,6 +568,11 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
                                  rpc::GetGcsServerAddressReply *reply,
                                  rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle a `GetTaskEventsTrace` request.
+  void HandleGetTaskEventsTrace(const rpc::GetTaskEventsTraceRequest &request,
+                                rpc::GetTaskEventsTraceReply *reply,
+                                rpc::SendReplyCallback send_reply_callback) override;
+
   /// Trigger local GC on each worker of this raylet.
   void DoLocalGC();
 
@@ -649,6 +669,9 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   std::string temp_dir_;
   /// Initial node manager configuration.
   const NodeManagerConfig initial_config_;
+  /// The directory that workers create their task event buffers in, see
+  /// TaskEventBuffer::GetNodeDirectory. Empty if they aren't shared.
+  std::string task_events_directory_;
 
   /// A manager to resolve objects needed by queued tasks and workers that
   /// called `ray.get` or `ray.wait`.
@@ -674,6 +697,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   absl::flat_hash_map<NodeID, std::pair<std::string, int32_t>>
       remote_node_manager_addresses_;
 
+  /// Connections to the raylets that this raylet relays resource broadcasts to.
+  absl::flat_hash_map<NodeID, std::shared_ptr<rpc::NodeManagerWorkerClient>>
+      resource_relay_clients_;
+
   /// Map of workers leased out to direct call clients.
   absl::flat_hash_map<WorkerID, std::shared_ptr<WorkerInterface>> leased_workers_;
 
@@ -752,6 +779,16 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// indicate network issues (dropped/duplicated/ooo packets, etc).
   int64_t next_resource_seq_no_;
 
+  /// The last full resource report that was sent to the GCS, if resource reports are
+  /// delta encoded. The next report is a delta on top of it if the GCS has applied it.
+  std::unique_ptr<rpc::ResourcesData> last_resource_report_;
+
+  /// The version of the last resource report that was sent to the GCS.
+  int64_t resource_report_version_ = 0;
+
+  /// Whether a resync of the remote nodes' resource views is in flight.
+  bool resource_resync_in_flight_ = false;
+
   /// Whether or not if the node draining process has already received.
   bool is_node_drained_ = false;
 };
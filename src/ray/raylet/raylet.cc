@@ -80,6 +80,7 @@ Raylet::Raylet(instrumented_io_context &main_service, const std::string &socket_
   self_node_info_.set_node_manager_port(node_manager_.GetServerPort());
   self_node_info_.set_node_manager_hostname(boost::asio::ip::host_name());
   self_node_info_.set_metrics_export_port(metrics_export_port);
+  self_node_info_.set_topology_path(node_manager_config.topology_path);
 }
 
 Raylet::~Raylet() {}
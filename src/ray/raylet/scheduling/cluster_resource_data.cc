@@ -14,6 +14,8 @@
 
 #include "ray/raylet/scheduling/cluster_resource_data.h"
 
+#include <algorithm>
+
 #include "ray/common/bundle_spec.h"
 #include "ray/common/task/scheduling_resources.h"
 
@@ -555,6 +557,40 @@ std::string TaskResourceInstances::DebugString(const StringIdMap &string_id_map)
   return buffer.str();
 }
 
+namespace {
+
+std::vector<std::string> SplitTopologyPath(const std::string &path) {
+  std::vector<std::string> levels;
+  size_t start = 0;
+  while (start < path.size()) {
+    size_t end = path.find('/', start);
+    if (end == std::string::npos) {
+      end = path.size();
+    }
+    if (end > start) {
+      levels.push_back(path.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return levels;
+}
+
+}  // namespace
+
+int TopologyDistance(const std::string &path_a, const std::string &path_b) {
+  if (path_a == path_b) {
+    return 0;
+  }
+  const auto levels_a = SplitTopologyPath(path_a);
+  const auto levels_b = SplitTopologyPath(path_b);
+  size_t common = 0;
+  while (common < levels_a.size() && common < levels_b.size() &&
+         levels_a[common] == levels_b[common]) {
+    common++;
+  }
+  return std::max(levels_a.size(), levels_b.size()) - common;
+}
+
 bool EqualVectors(const std::vector<FixedPoint> &v1, const std::vector<FixedPoint> &v2) {
   return (v1.size() == v2.size() && std::equal(v1.begin(), v1.end(), v2.begin()));
 }
@@ -230,4 +230,13 @@ ResourceRequest ResourceMapToResourceRequest(
     const absl::flat_hash_map<std::string, double> &resource_map,
     bool requires_object_store_memory);
 
+/// Compute how far apart two nodes are in the cluster topology. A node's topology path
+/// is a "/"-separated list of labels from the widest failure domain to the narrowest,
+/// e.g., "us-west-2a/rack-17". Nodes with the same path form a topology group.
+///
+/// \return The number of trailing levels in which the two paths differ, e.g., 0 for
+/// nodes in the same rack, 1 for nodes in different racks of the same zone, and 2 for
+/// nodes in different zones.
+int TopologyDistance(const std::string &path_a, const std::string &path_b);
+
 }  // namespace ray
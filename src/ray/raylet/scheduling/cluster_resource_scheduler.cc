@@ -79,6 +79,10 @@ void ClusterResourceScheduler::InitResourceUnitInstanceInfo() {
       predefined_unit_instance_resources_.emplace(resource);
     }
   }
+  if (RayConfig::instance().worker_cpu_pinning_enabled()) {
+    // Each CPU instance is mapped to a core that workers are pinned to.
+    predefined_unit_instance_resources_.emplace(CPU);
+  }
   std::string custom_unit_instance_resources =
       RayConfig::instance().custom_unit_instance_resources();
   if (!custom_unit_instance_resources.empty()) {
@@ -118,6 +122,9 @@ bool ClusterResourceScheduler::UpdateNode(const std::string &node_id_string,
   if (!nodes_.contains(node_id)) {
     return false;
   }
+  if (resource_data.version() > 0) {
+    return UpdateNodeFromVersionedReport(node_id, resource_data);
+  }
 
   auto resources_total = MapFromProtobuf(resource_data.resources_total());
   auto resources_available = MapFromProtobuf(resource_data.resources_available());
@@ -152,6 +159,69 @@ bool ClusterResourceScheduler::UpdateNode(const std::string &node_id_string,
   return true;
 }
 
+bool ClusterResourceScheduler::UpdateNodeFromVersionedReport(
+    int64_t node_id, const rpc::ResourcesData &resource_data) {
+  auto version = node_report_versions_.find(node_id);
+  if (resource_data.is_delta()) {
+    if (version == node_report_versions_.end() ||
+        version->second != resource_data.base_version()) {
+      // We missed a version of the node's report, so the delta can't be applied until
+      // the view is resynced with a full report.
+      return false;
+    }
+  } else if (version != node_report_versions_.end() &&
+             resource_data.version() < version->second) {
+    // A full report that is older than the view, e.g., from a slow resync.
+    return true;
+  }
+
+  NodeResources local_view;
+  RAY_CHECK(GetNodeResources(node_id, &local_view));
+  if (!resource_data.is_delta()) {
+    local_view = ResourceMapToNodeResources(
+        string_to_int_map_, MapFromProtobuf(resource_data.resources_total()),
+        MapFromProtobuf(resource_data.resources_available()));
+  } else {
+    auto capacity = [this, &local_view](const std::string &label) -> ResourceCapacity & {
+      for (int i = 0; i < PredefinedResources_MAX; i++) {
+        if (label == ResourceEnumToString(static_cast<PredefinedResources>(i))) {
+          return local_view.predefined_resources[i];
+        }
+      }
+      return local_view.custom_resources[string_to_int_map_.Insert(label)];
+    };
+    for (const auto &entry : resource_data.resources_total()) {
+      capacity(entry.first).total = entry.second;
+    }
+    for (const auto &entry : resource_data.resources_available()) {
+      capacity(entry.first).available = entry.second;
+    }
+    for (const auto &label : resource_data.deleted_resources()) {
+      auto &deleted = capacity(label);
+      deleted.total = deleted.available = 0;
+      auto custom_id = string_to_int_map_.Get(label);
+      if (custom_id != -1) {
+        local_view.custom_resources.erase(custom_id);
+      }
+    }
+  }
+  local_view.object_pulls_queued = resource_data.object_pulls_queued();
+
+  AddOrUpdateNode(node_id, local_view);
+  node_report_versions_[node_id] = resource_data.version();
+  return true;
+}
+
+void ClusterResourceScheduler::SetNodeTopologyPath(const std::string &node_id_string,
+                                                   const std::string &topology_path) {
+  auto node_id = string_to_int_map_.Insert(node_id_string);
+  if (topology_path.empty()) {
+    node_topology_paths_.erase(node_id);
+  } else {
+    node_topology_paths_[node_id] = topology_path;
+  }
+}
+
 bool ClusterResourceScheduler::RemoveNode(int64_t node_id) {
   auto it = nodes_.find(node_id);
   if (it == nodes_.end()) {
@@ -159,6 +229,8 @@ bool ClusterResourceScheduler::RemoveNode(int64_t node_id) {
     return false;
   } else {
     nodes_.erase(it);
+    node_topology_paths_.erase(node_id);
+    node_report_versions_.erase(node_id);
     return true;
   }
 }
@@ -278,9 +350,17 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(
   }
   // TODO (Alex): Setting require_available == force_spillback is a hack in order to
   // remain bug compatible with the legacy scheduling algorithms.
-  int64_t best_node_id = raylet_scheduling_policy::HybridPolicy(
-      resource_request, local_node_id_, nodes_, spread_threshold, force_spillback,
-      force_spillback, [this](auto node_id) { return this->NodeAlive(node_id); });
+  int64_t best_node_id;
+  if (RayConfig::instance().scheduler_topology_aware() && !node_topology_paths_.empty()) {
+    best_node_id = raylet_scheduling_policy::HierarchicalPolicy(
+        resource_request, local_node_id_, nodes_, node_topology_paths_, spread_threshold,
+        force_spillback, force_spillback,
+        [this](auto node_id) { return this->NodeAlive(node_id); });
+  } else {
+    best_node_id = raylet_scheduling_policy::HybridPolicy(
+        resource_request, local_node_id_, nodes_, spread_threshold, force_spillback,
+        force_spillback, [this](auto node_id) { return this->NodeAlive(node_id); });
+  }
   *is_infeasible = best_node_id == -1 ? true : false;
   if (!*is_infeasible) {
     // TODO (Alex): Support soft constraints if needed later.
@@ -1009,17 +1089,20 @@ void ClusterResourceScheduler::FillResourceUsage(rpc::ResourcesData &resources_d
     capacity.available = FixedPoint(capacity.total.Double() - used);
   }
 
+  // Delta encoded reports are computed from full reports by the node manager.
+  const bool report_all = RayConfig::instance().resource_report_delta_encoding();
   for (int i = 0; i < PredefinedResources_MAX; i++) {
     const auto &label = ResourceEnumToString((PredefinedResources)i);
     const auto &capacity = resources.predefined_resources[i];
     const auto &last_capacity = last_report_resources_->predefined_resources[i];
     // Note: available may be negative, but only report positive to GCS.
-    if (capacity.available != last_capacity.available && capacity.available > 0) {
+    if ((report_all || capacity.available != last_capacity.available) &&
+        capacity.available > 0) {
       resources_data.set_resources_available_changed(true);
       (*resources_data.mutable_resources_available())[label] =
           capacity.available.Double();
     }
-    if (capacity.total != last_capacity.total) {
+    if (report_all ? capacity.total > 0 : capacity.total != last_capacity.total) {
       (*resources_data.mutable_resources_total())[label] = capacity.total.Double();
     }
   }
@@ -1029,19 +1112,21 @@ void ClusterResourceScheduler::FillResourceUsage(rpc::ResourcesData &resources_d
     const auto &last_capacity = last_report_resources_->custom_resources[custom_id];
     const auto &label = string_to_int_map_.Get(custom_id);
     // Note: available may be negative, but only report positive to GCS.
-    if (capacity.available != last_capacity.available && capacity.available > 0) {
+    if ((report_all || capacity.available != last_capacity.available) &&
+        capacity.available > 0) {
       resources_data.set_resources_available_changed(true);
       (*resources_data.mutable_resources_available())[label] =
           capacity.available.Double();
     }
-    if (capacity.total != last_capacity.total) {
+    if (report_all ? capacity.total > 0 : capacity.total != last_capacity.total) {
       (*resources_data.mutable_resources_total())[label] = capacity.total.Double();
     }
   }
 
   if (get_pull_manager_at_capacity_ != nullptr) {
     resources.object_pulls_queued = get_pull_manager_at_capacity_();
-    if (last_report_resources_->object_pulls_queued != resources.object_pulls_queued) {
+    if (report_all ||
+        last_report_resources_->object_pulls_queued != resources.object_pulls_queued) {
       resources_data.set_object_pulls_queued(resources.object_pulls_queued);
       resources_data.set_resources_available_changed(true);
     }
@@ -74,9 +74,20 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   ///
   /// \param node_id_string ID of the node which resoruces need to be udpated.
   /// \param resource_data The node resource data.
+  /// \return False if the node doesn't exist, or if the data is a delta on top of a
+  /// version of the node's report that this view doesn't have. In the latter case, the
+  /// node should be resynced with a full report.
   bool UpdateNode(const std::string &node_id_string,
                   const rpc::ResourcesData &resource_data) override;
 
+  /// Set the topology path of a node, e.g., "us-west-2a/rack-17". See
+  /// `TopologyDistance` for the format.
+  ///
+  /// \param node_id_string ID of the node.
+  /// \param topology_path The topology path of the node, or empty if unknown.
+  void SetNodeTopologyPath(const std::string &node_id_string,
+                           const std::string &topology_path);
+
   /// Remove node from the cluster data structure. This happens
   /// when a node fails or it is removed from the cluster.
   ///
@@ -421,11 +432,27 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   bool SubtractRemoteNodeAvailableResources(int64_t node_id,
                                             const ResourceRequest &resource_request);
 
+  /// Update the view of a remote node from a versioned resource report, which is
+  /// either a full report or a delta on top of the last version that was applied.
+  ///
+  /// \param node_id: ID of the node that sent the report.
+  /// \param resource_data: The versioned report.
+  ///
+  /// \return false if the report is a delta on top of a version this view doesn't
+  /// have, and true otherwise.
+  bool UpdateNodeFromVersionedReport(int64_t node_id,
+                                     const rpc::ResourcesData &resource_data);
+
   /// The threshold at which to switch from packing to spreading.
   const float spread_threshold_;
   /// List of nodes in the clusters and their resources organized as a map.
   /// The key of the map is the node ID.
   absl::flat_hash_map<int64_t, Node> nodes_;
+  /// The topology path of each node that has one.
+  absl::flat_hash_map<int64_t, std::string> node_topology_paths_;
+  /// The version of the last resource report that was applied to the view of each
+  /// remote node, for nodes that send versioned reports.
+  absl::flat_hash_map<int64_t, int64_t> node_report_versions_;
   /// Identifier of local node.
   int64_t local_node_id_;
   /// Internally maintained random number generator.
@@ -451,6 +478,7 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   // Specify custom resources that consists of unit-size instances.
   std::unordered_set<int64_t> custom_unit_instance_resources_{};
   FRIEND_TEST(ClusterResourceSchedulerTest, SchedulingResourceRequestTest);
+  FRIEND_TEST(ClusterResourceSchedulerTest, VersionedResourceReportTest);
 };
 
 }  // end namespace ray
@@ -1296,6 +1296,51 @@ TEST_F(ClusterResourceSchedulerTest, CustomResourceInstanceTest) {
   ASSERT_FALSE(success) << resource_scheduler.DebugString();
 }
 
+TEST_F(ClusterResourceSchedulerTest, VersionedResourceReportTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 1}}, *gcs_client_);
+  auto remote = NodeID::FromRandom().Binary();
+  absl::flat_hash_map<std::string, double> resources({{"CPU", 4}, {"custom", 2}});
+  resource_scheduler.AddOrUpdateNode(remote, resources, resources);
+  auto remote_id = resource_scheduler.string_to_int_map_.Get(remote);
+  auto custom_id = resource_scheduler.string_to_int_map_.Get("custom");
+
+  rpc::ResourcesData v1;
+  v1.set_node_id(remote);
+  v1.set_version(1);
+  (*v1.mutable_resources_total())["CPU"] = 4;
+  (*v1.mutable_resources_available())["CPU"] = 2;
+  (*v1.mutable_resources_total())["custom"] = 2;
+  (*v1.mutable_resources_available())["custom"] = 2;
+  ASSERT_TRUE(resource_scheduler.UpdateNode(remote, v1));
+
+  rpc::ResourcesData d3;
+  d3.set_node_id(remote);
+  d3.set_is_delta(true);
+  d3.set_base_version(2);
+  d3.set_version(3);
+  (*d3.mutable_resources_available())["CPU"] = 1;
+  // The view doesn't have version 2, so it needs to be resynced.
+  ASSERT_FALSE(resource_scheduler.UpdateNode(remote, d3));
+
+  rpc::ResourcesData d2 = d3;
+  d2.set_base_version(1);
+  d2.set_version(2);
+  d2.add_deleted_resources("custom");
+  ASSERT_TRUE(resource_scheduler.UpdateNode(remote, d2));
+  ASSERT_TRUE(resource_scheduler.UpdateNode(remote, d3));
+
+  NodeResources view;
+  ASSERT_TRUE(resource_scheduler.GetNodeResources(remote_id, &view));
+  ASSERT_EQ(view.predefined_resources[CPU].total, 4);
+  ASSERT_EQ(view.predefined_resources[CPU].available, 1);
+  ASSERT_FALSE(view.custom_resources.contains(custom_id));
+
+  // A stale full report, e.g., from a resync, doesn't roll back the view.
+  ASSERT_TRUE(resource_scheduler.UpdateNode(remote, v1));
+  ASSERT_TRUE(resource_scheduler.GetNodeResources(remote_id, &view));
+  ASSERT_EQ(view.predefined_resources[CPU].available, 1);
+}
+
 TEST_F(ClusterResourceSchedulerTest, TaskResourceInstancesSerializedStringTest) {
   ClusterResourceScheduler resource_scheduler(
       "local", {{"CPU", 4}, {"memory", 4}, {"GPU", 2}}, *gcs_client_);
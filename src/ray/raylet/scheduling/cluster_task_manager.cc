@@ -16,8 +16,10 @@
 
 #include <google/protobuf/map.h>
 
+#include <boost/asio/post.hpp>
 #include <boost/range/join.hpp>
 
+#include "absl/strings/str_join.h"
 #include "ray/stats/stats.h"
 #include "ray/util/logging.h"
 
@@ -54,7 +56,13 @@ ClusterTaskManager::ClusterTaskManager(
       max_pinned_task_arguments_bytes_(max_pinned_task_arguments_bytes),
       metric_tasks_queued_(0),
       metric_tasks_dispatched_(0),
-      metric_tasks_spilled_(0) {}
+      metric_tasks_spilled_(0) {
+  if (RayConfig::instance().worker_cpu_pinning_enabled()) {
+    cpu_affinity_ = std::make_unique<CpuAffinity>(CpuAffinity::FromLocalMachine(
+        RayConfig::instance().worker_cpu_pinning_cpus()));
+    cpu_pinning_thread_ = std::make_unique<boost::asio::thread_pool>(1);
+  }
+}
 
 bool ClusterTaskManager::SchedulePendingTasks() {
   // Always try to schedule infeasible tasks in case they are now feasible.
@@ -1143,6 +1151,33 @@ void ClusterTaskManager::Dispatch(
   } else {
     allocated_resources = worker->GetAllocatedInstances();
   }
+  if (cpu_affinity_ && !worker->GetProcess().IsNull()) {
+    // Pin the worker to the cores of its CPU instances if it has a whole one. A worker
+    // without any is unpinned, since it may have been pinned during a previous lease.
+    size_t num_unmapped = 0;
+    auto cpu_ids = cpu_affinity_->GetCpuIds(allocated_resources->GetCPUInstancesDouble(),
+                                            &num_unmapped);
+    if (num_unmapped > 0) {
+      RAY_LOG_EVERY_MS(WARNING, 10000)
+          << "Worker " << worker->WorkerId() << " is granted " << num_unmapped
+          << " CPU instance(s) beyond the " << cpu_affinity_->GetPinningOrder().size()
+          << " CPUs that workers can be pinned to, which it isn't pinned to. Set "
+             "num_cpus to at most the number of CPUs in worker_cpu_pinning_cpus.";
+    }
+    boost::asio::post(*cpu_pinning_thread_, [cpu_affinity = cpu_affinity_.get(),
+                                             pid = worker->GetProcess().GetId(),
+                                             worker_id = worker->WorkerId(),
+                                             cpu_ids = std::move(cpu_ids)]() {
+      auto status = cpu_affinity->SetProcessAffinity(pid, cpu_ids);
+      if (!status.ok()) {
+        RAY_LOG(WARNING) << "Failed to pin worker " << worker_id
+                         << " to its CPUs: " << status.ToString();
+      } else if (!cpu_ids.empty()) {
+        RAY_LOG(DEBUG) << "Pinned worker " << worker_id << " to CPUs "
+                       << absl::StrJoin(cpu_ids, ",");
+      }
+    });
+  }
   auto predefined_resources = allocated_resources->predefined_resources;
   ::ray::rpc::ResourceMapEntry *resource;
   for (size_t res_idx = 0; res_idx < predefined_resources.size(); res_idx++) {
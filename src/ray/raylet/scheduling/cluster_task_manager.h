@@ -14,11 +14,14 @@
 
 #pragma once
 
+#include <boost/asio/thread_pool.hpp>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "ray/common/ray_object.h"
 #include "ray/common/task/task.h"
 #include "ray/common/task/task_common.h"
+#include "ray/raylet/cpu_affinity.h"
 #include "ray/raylet/dependency_manager.h"
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 #include "ray/raylet/scheduling/cluster_task_manager_interface.h"
@@ -390,6 +393,15 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   uint64_t metric_tasks_dispatched_;
   uint64_t metric_tasks_spilled_;
 
+  /// Maps CPU instances to the logical CPUs that leased workers are pinned to. Only
+  /// set if `worker_cpu_pinning_enabled` is set.
+  std::unique_ptr<CpuAffinity> cpu_affinity_;
+
+  /// A single thread that pins leased workers, so that walking the threads of a
+  /// worker and the affinity syscalls don't block the main thread. Only set if
+  /// `cpu_affinity_` is set, and declared after it so that it's joined first.
+  std::unique_ptr<boost::asio::thread_pool> cpu_pinning_thread_;
+
   /// Determine whether a task should be immediately dispatched,
   /// or placed on a wait queue.
   ///
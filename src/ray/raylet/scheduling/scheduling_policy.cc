@@ -15,6 +15,7 @@
 #include "ray/raylet/scheduling/scheduling_policy.h"
 
 #include <functional>
+#include <tuple>
 
 namespace ray {
 
@@ -34,63 +35,28 @@ bool DoesNodeHaveGPUs(const NodeResources &resources) {
   }
   return resources.predefined_resources[GPU].total > 0;
 }
-}  // namespace
-
-int64_t HybridPolicyWithFilter(const ResourceRequest &resource_request,
-                               const int64_t local_node_id,
-                               const absl::flat_hash_map<int64_t, Node> &nodes,
-                               float spread_threshold, bool force_spillback,
-                               bool require_available,
-                               std::function<bool(int64_t)> is_node_available,
-                               NodeFilter node_filter) {
-  // Step 1: Generate the traversal order. We guarantee that the first node is local, to
-  // encourage local scheduling. The rest of the traversal order should be globally
-  // consistent, to encourage using "warm" workers.
-  std::vector<int64_t> round;
-  round.reserve(nodes.size());
-  const auto local_it = nodes.find(local_node_id);
-  RAY_CHECK(local_it != nodes.end());
-  auto predicate = [node_filter, &is_node_available](
-                       int64_t node_id, const NodeResources &node_resources) {
-    if (!is_node_available(node_id)) {
-      return false;
-    }
-    if (node_filter == NodeFilter::kAny) {
-      return true;
-    }
-    const bool has_gpu = DoesNodeHaveGPUs(node_resources);
-    if (node_filter == NodeFilter::kGPU) {
-      return has_gpu;
-    }
-    RAY_CHECK(node_filter == NodeFilter::kNonGpu);
-    return !has_gpu;
-  };
 
-  const auto &local_node_view = local_it->second.GetLocalView();
-  // If we should include local node at all, make sure it is at the front of the list
-  // so that
-  // 1. It's first in traversal order.
-  // 2. It's easy to avoid sorting it.
-  if (predicate(local_node_id, local_node_view) && !force_spillback) {
-    round.push_back(local_node_id);
+bool MatchesNodeFilter(NodeFilter node_filter, const NodeResources &node_resources) {
+  if (node_filter == NodeFilter::kAny) {
+    return true;
   }
-
-  const auto start_index = round.size();
-  for (const auto &pair : nodes) {
-    if (pair.first != local_node_id &&
-        predicate(pair.first, pair.second.GetLocalView())) {
-      round.push_back(pair.first);
-    }
+  const bool has_gpu = DoesNodeHaveGPUs(node_resources);
+  if (node_filter == NodeFilter::kGPU) {
+    return has_gpu;
   }
-  // Sort all the nodes, making sure that if we added the local node in front, it stays in
-  // place.
-  std::sort(round.begin() + start_index, round.end());
+  RAY_CHECK(node_filter == NodeFilter::kNonGpu);
+  return !has_gpu;
+}
 
+/// Run the priority scheduler over the nodes in traversal order.
+int64_t PickBestNode(const ResourceRequest &resource_request, const int64_t local_node_id,
+                     const absl::flat_hash_map<int64_t, Node> &nodes,
+                     const std::vector<int64_t> &round, float spread_threshold,
+                     bool require_available) {
   int64_t best_node_id = -1;
   float best_utilization_score = INFINITY;
   bool best_is_available = false;
 
-  // Step 2: Perform the round robin.
   auto round_it = round.begin();
   for (; round_it != round.end(); round_it++) {
     const auto &node_id = *round_it;
@@ -146,6 +112,70 @@ int64_t HybridPolicyWithFilter(const ResourceRequest &resource_request,
   return best_node_id;
 }
 
+/// Add the total and available resources of a node to the resources of its group.
+void AddNodeResources(const NodeResources &node_resources,
+                      NodeResources *group_resources) {
+  auto &predefined_resources = group_resources->predefined_resources;
+  if (predefined_resources.size() < node_resources.predefined_resources.size()) {
+    predefined_resources.resize(node_resources.predefined_resources.size());
+  }
+  for (size_t i = 0; i < node_resources.predefined_resources.size(); i++) {
+    predefined_resources[i].total += node_resources.predefined_resources[i].total;
+    predefined_resources[i].available +=
+        node_resources.predefined_resources[i].available;
+  }
+  for (const auto &entry : node_resources.custom_resources) {
+    auto &capacity = group_resources->custom_resources[entry.first];
+    capacity.total += entry.second.total;
+    capacity.available += entry.second.available;
+  }
+}
+}  // namespace
+
+int64_t HybridPolicyWithFilter(const ResourceRequest &resource_request,
+                               const int64_t local_node_id,
+                               const absl::flat_hash_map<int64_t, Node> &nodes,
+                               float spread_threshold, bool force_spillback,
+                               bool require_available,
+                               std::function<bool(int64_t)> is_node_available,
+                               NodeFilter node_filter) {
+  // Step 1: Generate the traversal order. We guarantee that the first node is local, to
+  // encourage local scheduling. The rest of the traversal order should be globally
+  // consistent, to encourage using "warm" workers.
+  std::vector<int64_t> round;
+  round.reserve(nodes.size());
+  const auto local_it = nodes.find(local_node_id);
+  RAY_CHECK(local_it != nodes.end());
+  auto predicate = [node_filter, &is_node_available](
+                       int64_t node_id, const NodeResources &node_resources) {
+    return is_node_available(node_id) && MatchesNodeFilter(node_filter, node_resources);
+  };
+
+  const auto &local_node_view = local_it->second.GetLocalView();
+  // If we should include local node at all, make sure it is at the front of the list
+  // so that
+  // 1. It's first in traversal order.
+  // 2. It's easy to avoid sorting it.
+  if (predicate(local_node_id, local_node_view) && !force_spillback) {
+    round.push_back(local_node_id);
+  }
+
+  const auto start_index = round.size();
+  for (const auto &pair : nodes) {
+    if (pair.first != local_node_id &&
+        predicate(pair.first, pair.second.GetLocalView())) {
+      round.push_back(pair.first);
+    }
+  }
+  // Sort all the nodes, making sure that if we added the local node in front, it stays in
+  // place.
+  std::sort(round.begin() + start_index, round.end());
+
+  // Step 2: Perform the round robin.
+  return PickBestNode(resource_request, local_node_id, nodes, round, spread_threshold,
+                      require_available);
+}
+
 int64_t HybridPolicy(const ResourceRequest &resource_request, const int64_t local_node_id,
                      const absl::flat_hash_map<int64_t, Node> &nodes,
                      float spread_threshold, bool force_spillback, bool require_available,
@@ -171,5 +201,108 @@ int64_t HybridPolicy(const ResourceRequest &resource_request, const int64_t loca
                                 force_spillback, require_available, is_node_available);
 }
 
+int64_t HierarchicalPolicy(
+    const ResourceRequest &resource_request, const int64_t local_node_id,
+    const absl::flat_hash_map<int64_t, Node> &nodes,
+    const absl::flat_hash_map<int64_t, std::string> &node_topology_paths,
+    float spread_threshold, bool force_spillback, bool require_available,
+    std::function<bool(int64_t)> is_node_available, bool scheduler_avoid_gpu_nodes) {
+  static const std::string kNoTopologyPath;
+  auto get_topology_path =
+      [&node_topology_paths](int64_t node_id) -> const std::string & {
+        auto it = node_topology_paths.find(node_id);
+        return it == node_topology_paths.end() ? kNoTopologyPath : it->second;
+      };
+
+  // Step 1: Group the candidate nodes by their topology path and aggregate the resources
+  // of each group.
+  struct TopologyGroup {
+    std::vector<int64_t> node_ids;
+    NodeResources resources;
+  };
+  absl::flat_hash_map<std::string, TopologyGroup> groups;
+  for (const auto &pair : nodes) {
+    if ((force_spillback && pair.first == local_node_id) ||
+        !is_node_available(pair.first)) {
+      continue;
+    }
+    auto &group = groups[get_topology_path(pair.first)];
+    group.node_ids.push_back(pair.first);
+    AddNodeResources(pair.second.GetLocalView(), &group.resources);
+  }
+  if (groups.size() <= 1) {
+    return HybridPolicy(resource_request, local_node_id, nodes, spread_threshold,
+                        force_spillback, require_available, std::move(is_node_available),
+                        scheduler_avoid_gpu_nodes);
+  }
+
+  // Step 2: Rank the groups. The aggregated resources of a group being available is
+  // necessary, but not sufficient, for one of its nodes to be available.
+  const std::string &local_topology_path = get_topology_path(local_node_id);
+  const bool prefer_local_group = resource_request.requires_object_store_memory;
+  struct GroupRank {
+    int distance;
+    float utilization;
+    const std::string *topology_path;
+    TopologyGroup *group;
+  };
+  std::vector<GroupRank> ranked_groups;
+  for (auto &pair : groups) {
+    if (!pair.second.resources.IsAvailable(resource_request,
+                                           /*ignore_pull_manager_at_capacity=*/true)) {
+      continue;
+    }
+    float utilization = pair.second.resources.CalculateCriticalResourceUtilization();
+    if (utilization < spread_threshold) {
+      utilization = 0;
+    }
+    ranked_groups.push_back({TopologyDistance(local_topology_path, pair.first),
+                             utilization, &pair.first, &pair.second});
+  }
+  std::sort(ranked_groups.begin(), ranked_groups.end(),
+            [prefer_local_group](const GroupRank &a, const GroupRank &b) {
+              if (prefer_local_group) {
+                return std::tie(a.distance, a.utilization, *a.topology_path) <
+                       std::tie(b.distance, b.utilization, *b.topology_path);
+              }
+              return std::tie(a.utilization, a.distance, *a.topology_path) <
+                     std::tie(b.utilization, b.distance, *b.topology_path);
+            });
+
+  // Step 3: Pick an available node within the best ranked group that has one. Like
+  // `HybridPolicy`, try the nodes without GPUs first if we should avoid the GPU nodes.
+  std::vector<NodeFilter> node_filters = {NodeFilter::kAny};
+  if (scheduler_avoid_gpu_nodes && !IsGPURequest(resource_request)) {
+    node_filters.insert(node_filters.begin(), NodeFilter::kNonGpu);
+  }
+  std::vector<int64_t> round;
+  for (const auto node_filter : node_filters) {
+    for (const auto &ranked_group : ranked_groups) {
+      round.clear();
+      for (const auto node_id : ranked_group.group->node_ids) {
+        if (MatchesNodeFilter(node_filter, nodes.at(node_id).GetLocalView())) {
+          round.push_back(node_id);
+        }
+      }
+      // The local node goes first, and the rest in a globally consistent order.
+      std::sort(round.begin(), round.end(), [local_node_id](int64_t a, int64_t b) {
+        return std::make_pair(a != local_node_id, a) <
+               std::make_pair(b != local_node_id, b);
+      });
+      int64_t best_node_id =
+          PickBestNode(resource_request, local_node_id, nodes, round, spread_threshold,
+                       /*require_available=*/true);
+      if (best_node_id != -1) {
+        return best_node_id;
+      }
+    }
+  }
+
+  // Step 4: No node is available right now, so pick a feasible node to queue on.
+  return HybridPolicy(resource_request, local_node_id, nodes, spread_threshold,
+                      force_spillback, require_available, std::move(is_node_available),
+                      scheduler_avoid_gpu_nodes);
+}
+
 }  // namespace raylet_scheduling_policy
 }  // namespace ray
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
 #include <vector>
 
 #include "ray/common/ray_config.h"
@@ -64,6 +65,34 @@ int64_t HybridPolicy(
     std::function<bool(int64_t)> is_node_available,
     bool scheduler_avoid_gpu_nodes = RayConfig::instance().scheduler_avoid_gpu_nodes());
 
+/// A two-level variant of `HybridPolicy` for clusters whose nodes carry topology paths
+/// (see `TopologyDistance`), e.g., "zone/rack". Choosing a node among thousands while
+/// ignoring the topology spreads related tasks across racks, so that their arguments
+/// cross the rack uplinks. Instead, we
+///   1. Group the nodes by their topology path and aggregate the resources of each
+///   group.
+///   2. Rank the groups that have enough aggregated resources for the request. Requests
+///   that need object store memory for their arguments rank the groups by their topology
+///   distance to the local node first, since they'd otherwise pull their arguments
+///   across racks. Other requests rank the groups by their aggregated critical resource
+///   utilization (truncated below the spread threshold), and break ties by distance.
+///   3. Pick an available node in the best ranked group that has one, with the same
+///   per-node priorities as `HybridPolicy`.
+/// If no node is available, this falls back to `HybridPolicy`, which picks a feasible
+/// node to queue the request on.
+///
+/// \param node_topology_paths: The topology path of each node. Nodes without a path
+/// form a group of their own.
+///
+/// See `HybridPolicy` for the other parameters and the return value.
+int64_t HierarchicalPolicy(
+    const ResourceRequest &resource_request, const int64_t local_node_id,
+    const absl::flat_hash_map<int64_t, Node> &nodes,
+    const absl::flat_hash_map<int64_t, std::string> &node_topology_paths,
+    float spread_threshold, bool force_spillback, bool require_available,
+    std::function<bool(int64_t)> is_node_available,
+    bool scheduler_avoid_gpu_nodes = RayConfig::instance().scheduler_avoid_gpu_nodes());
+
 enum class NodeFilter {
   /// Default scheduling.
   kAny,
@@ -14,8 +14,11 @@
 
 #include "ray/raylet/scheduling/scheduling_policy.h"
 
+#include <random>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "ray/util/util.h"
 
 namespace ray {
 
@@ -378,6 +381,166 @@ TEST_F(SchedulingPolicyTest, NonGpuNodePreferredSchedulingTest) {
   ASSERT_EQ(to_schedule, remote_node_1);
 }
 
+TEST_F(SchedulingPolicyTest, TopologyDistanceTest) {
+  ASSERT_EQ(TopologyDistance("z1/r1", "z1/r1"), 0);
+  ASSERT_EQ(TopologyDistance("z1/r1", "z1/r2"), 1);
+  ASSERT_EQ(TopologyDistance("z1/r1", "z2/r1"), 2);
+  ASSERT_EQ(TopologyDistance("z1", "z1/r1"), 1);
+  ASSERT_EQ(TopologyDistance("", "z1/r1"), 2);
+  // Empty labels are ignored.
+  ASSERT_EQ(TopologyDistance("/z1/r1", "z1/r1/"), 0);
+}
+
+TEST_F(SchedulingPolicyTest, HierarchicalPolicyTest) {
+  StringIdMap map;
+  ResourceRequest req = ResourceMapToResourceRequest(map, {{"CPU", 1}}, false);
+  ResourceRequest data_heavy_req = ResourceMapToResourceRequest(map, {{"CPU", 1}}, true);
+  int64_t local_node = 0;
+  int64_t remote_node_other_zone = 1;
+  int64_t remote_node_same_zone = 2;
+  int64_t remote_node_same_rack = 3;
+
+  absl::flat_hash_map<int64_t, Node> nodes;
+  nodes.emplace(local_node, CreateNodeResources(0, 2, 0, 0, 0, 0));
+  nodes.emplace(remote_node_other_zone, CreateNodeResources(2, 2, 0, 0, 0, 0));
+  nodes.emplace(remote_node_same_zone, CreateNodeResources(2, 2, 0, 0, 0, 0));
+  nodes.emplace(remote_node_same_rack, CreateNodeResources(1, 2, 0, 0, 0, 0));
+  absl::flat_hash_map<int64_t, std::string> node_topology_paths = {
+      {local_node, "z1/r1"},
+      {remote_node_other_zone, "z2/r1"},
+      {remote_node_same_zone, "z1/r2"},
+      {remote_node_same_rack, "z1/r1"}};
+
+  // The flat policy spills to the remote node with the lowest ID.
+  int to_schedule = raylet_scheduling_policy::HybridPolicy(
+      data_heavy_req, local_node, nodes, 0.5, false, false, [](auto) { return true; });
+  ASSERT_EQ(to_schedule, remote_node_other_zone);
+
+  // Requests that pull their arguments stay in the local rack, even though it's busier.
+  to_schedule = raylet_scheduling_policy::HierarchicalPolicy(
+      data_heavy_req, local_node, nodes, node_topology_paths, 0.5, false, false,
+      [](auto) { return true; });
+  ASSERT_EQ(to_schedule, remote_node_same_rack);
+
+  // Other requests go to the least utilized rack, and the closest one among those.
+  to_schedule = raylet_scheduling_policy::HierarchicalPolicy(
+      req, local_node, nodes, node_topology_paths, 0.5, false, false,
+      [](auto) { return true; });
+  ASSERT_EQ(to_schedule, remote_node_same_zone);
+
+  // Once the local rack is full, requests that pull their arguments stay in the zone.
+  nodes.at(remote_node_same_rack) = Node(CreateNodeResources(0, 2, 0, 0, 0, 0));
+  to_schedule = raylet_scheduling_policy::HierarchicalPolicy(
+      data_heavy_req, local_node, nodes, node_topology_paths, 0.5, false, false,
+      [](auto) { return true; });
+  ASSERT_EQ(to_schedule, remote_node_same_zone);
+
+  // Unavailable nodes are skipped.
+  to_schedule = raylet_scheduling_policy::HierarchicalPolicy(
+      data_heavy_req, local_node, nodes, node_topology_paths, 0.5, false, false,
+      [&](auto node_id) { return node_id != remote_node_same_zone; });
+  ASSERT_EQ(to_schedule, remote_node_other_zone);
+}
+
+TEST_F(SchedulingPolicyTest, HierarchicalPolicyFallbackTest) {
+  // If no node is available, the request is queued on a feasible node like in the flat
+  // policy.
+  StringIdMap map;
+  ResourceRequest req = ResourceMapToResourceRequest(map, {{"CPU", 1}}, true);
+  int64_t local_node = 0;
+  int64_t remote_node = 1;
+
+  absl::flat_hash_map<int64_t, Node> nodes;
+  nodes.emplace(local_node, CreateNodeResources(0, 2, 0, 0, 0, 0));
+  nodes.emplace(remote_node, CreateNodeResources(0, 2, 0, 0, 0, 0));
+  absl::flat_hash_map<int64_t, std::string> node_topology_paths = {
+      {local_node, "z1/r1"}, {remote_node, "z1/r2"}};
+
+  int to_schedule = raylet_scheduling_policy::HierarchicalPolicy(
+      req, local_node, nodes, node_topology_paths, 0.5, false, false,
+      [](auto) { return true; });
+  ASSERT_EQ(to_schedule, local_node);
+
+  to_schedule = raylet_scheduling_policy::HierarchicalPolicy(
+      req, local_node, nodes, node_topology_paths, 0.5, false, true,
+      [](auto) { return true; });
+  ASSERT_EQ(to_schedule, -1);
+
+  req = ResourceMapToResourceRequest(map, {{"CPU", 3}}, true);
+  to_schedule = raylet_scheduling_policy::HierarchicalPolicy(
+      req, local_node, nodes, node_topology_paths, 0.5, false, false,
+      [](auto) { return true; });
+  ASSERT_EQ(to_schedule, -1);
+}
+
+TEST_F(SchedulingPolicyTest, HierarchicalPolicySimulationTest) {
+  // Simulate spillback decisions on a cluster of 10 zones with 25 racks of 20 nodes
+  // each, where most nodes are busy. Every request pulls its arguments from the node
+  // that submitted it.
+  const int num_zones = 10;
+  const int num_racks_per_zone = 25;
+  const int num_nodes_per_rack = 20;
+  const int num_requests = 1000;
+  absl::flat_hash_map<int64_t, std::string> node_topology_paths;
+  for (int zone = 0; zone < num_zones; zone++) {
+    for (int rack = 0; rack < num_racks_per_zone; rack++) {
+      for (int node = 0; node < num_nodes_per_rack; node++) {
+        int64_t node_id =
+            (zone * num_racks_per_zone + rack) * num_nodes_per_rack + node;
+        node_topology_paths[node_id] =
+            "zone-" + std::to_string(zone) + "/rack-" + std::to_string(rack);
+      }
+    }
+  }
+  StringIdMap map;
+  ResourceRequest req = ResourceMapToResourceRequest(map, {{"CPU", 1}}, true);
+
+  auto simulate = [&](bool hierarchical) {
+    std::mt19937 gen(0);
+    absl::flat_hash_map<int64_t, Node> nodes;
+    for (const auto &entry : node_topology_paths) {
+      // Three out of four nodes are fully utilized.
+      double available_cpu = gen() % 4 == 0 ? 4 : 0;
+      nodes.emplace(entry.first, CreateNodeResources(available_cpu, 4, 0, 0, 0, 0));
+    }
+    std::uniform_int_distribution<int64_t> random_node(0, nodes.size() - 1);
+    int num_cross_rack = 0;
+    int num_cross_zone = 0;
+    int64_t start_ms = current_time_ms();
+    for (int i = 0; i < num_requests; i++) {
+      int64_t local_node = random_node(gen);
+      int64_t to_schedule =
+          hierarchical
+              ? raylet_scheduling_policy::HierarchicalPolicy(
+                    req, local_node, nodes, node_topology_paths, 0.5, false, false,
+                    [](auto) { return true; })
+              : raylet_scheduling_policy::HybridPolicy(req, local_node, nodes, 0.5,
+                                                       false, false,
+                                                       [](auto) { return true; });
+      RAY_CHECK(to_schedule != -1);
+      int distance = TopologyDistance(node_topology_paths[local_node],
+                                      node_topology_paths[to_schedule]);
+      num_cross_rack += distance > 0;
+      num_cross_zone += distance > 1;
+      auto &cpu = nodes.at(to_schedule).GetMutableLocalView()->predefined_resources[CPU];
+      if (cpu.available >= 1) {
+        cpu.available -= 1;
+      }
+    }
+    int64_t duration_ms = current_time_ms() - start_ms;
+    RAY_LOG(INFO) << (hierarchical ? "Hierarchical" : "Hybrid") << " policy scheduled "
+                  << num_requests << " requests on " << nodes.size() << " nodes in "
+                  << duration_ms << "ms, " << num_cross_rack << " across racks, "
+                  << num_cross_zone << " across zones.";
+    return std::make_pair(num_cross_rack, num_cross_zone);
+  };
+
+  auto hybrid = simulate(/*hierarchical=*/false);
+  auto hierarchical = simulate(/*hierarchical=*/true);
+  ASSERT_LT(hierarchical.first, hybrid.first);
+  ASSERT_LT(hierarchical.second, hybrid.second);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -116,6 +116,7 @@ class WorkerInterface {
   FRIEND_TEST(WorkerPoolTest, TestWorkerCapping);
   FRIEND_TEST(WorkerPoolTest, TestWorkerCappingLaterNWorkersNotOwningObjects);
   FRIEND_TEST(WorkerPoolTest, MaximumStartupConcurrency);
+  FRIEND_TEST(WorkerPoolTest, PrestartWorkersForPredictedDemand);
 };
 
 /// Worker class encapsulates the implementation details of a worker. A worker
@@ -0,0 +1,72 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_demand_history.h"
+
+#include <algorithm>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+WorkerDemandHistory::WorkerDemandHistory(int64_t burst_gap_ms, size_t max_bursts)
+    : burst_gap_ms_(burst_gap_ms), max_bursts_(max_bursts) {
+  RAY_CHECK(max_bursts_ > 0);
+}
+
+void WorkerDemandHistory::RecordDemand(int64_t now_ms, int64_t demand) {
+  if (last_demand_ms_ == -1 || now_ms - last_demand_ms_ > burst_gap_ms_) {
+    // A new burst starts.
+    burst_starts_ms_.push_back(now_ms);
+    burst_peaks_.push_back(0);
+    if (burst_starts_ms_.size() > max_bursts_) {
+      burst_starts_ms_.pop_front();
+      burst_peaks_.pop_front();
+    }
+  }
+  last_demand_ms_ = std::max(last_demand_ms_, now_ms);
+  burst_peaks_.back() = std::max(burst_peaks_.back(), demand);
+}
+
+bool WorkerDemandHistory::PredictNextBurst(size_t min_bursts, int64_t *start_ms,
+                                           int64_t *demand) const {
+  if (burst_starts_ms_.size() < std::max<size_t>(min_bursts, 2)) {
+    return false;
+  }
+  int64_t min_interval = INT64_MAX;
+  int64_t max_interval = 0;
+  for (size_t i = 1; i < burst_starts_ms_.size(); i++) {
+    int64_t interval = burst_starts_ms_[i] - burst_starts_ms_[i - 1];
+    min_interval = std::min(min_interval, interval);
+    max_interval = std::max(max_interval, interval);
+  }
+  int64_t mean_interval = (burst_starts_ms_.back() - burst_starts_ms_.front()) /
+                          static_cast<int64_t>(burst_starts_ms_.size() - 1);
+  // Only predict if the bursts arrive periodically, i.e., the intervals between them
+  // don't vary by more than half of the mean interval.
+  if (max_interval - min_interval > mean_interval / 2) {
+    return false;
+  }
+  *start_ms = burst_starts_ms_.back() + mean_interval;
+  // Provision for the largest recent burst, since under-provisioning is what we are
+  // trying to avoid and idle workers are reclaimed anyway.
+  *demand = *std::max_element(burst_peaks_.begin(), burst_peaks_.end());
+  return true;
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,69 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace ray {
+
+namespace raylet {
+
+/// \class WorkerDemandHistory
+///
+/// The history of worker demand bursts of a single (job, runtime env). A burst is a
+/// period of demand in which no two consecutive observations are further apart than
+/// `burst_gap_ms`. If the recent bursts arrived periodically, this predicts when the
+/// next burst will start and how many workers it will need.
+class WorkerDemandHistory {
+ public:
+  /// \param burst_gap_ms The minimum time without demand that separates two bursts.
+  /// \param max_bursts The number of most recent bursts to remember.
+  WorkerDemandHistory(int64_t burst_gap_ms, size_t max_bursts);
+
+  /// Record the number of workers that were needed at the given time.
+  void RecordDemand(int64_t now_ms, int64_t demand);
+
+  /// Predict the next burst.
+  ///
+  /// \param min_bursts The minimum number of observed bursts to predict from.
+  /// \param[out] start_ms The predicted start time of the next burst.
+  /// \param[out] demand The predicted peak demand of the next burst.
+  /// \return Whether the recent bursts were periodic enough to make a prediction.
+  bool PredictNextBurst(size_t min_bursts, int64_t *start_ms, int64_t *demand) const;
+
+  /// The last time any demand was recorded, or -1 if none was.
+  int64_t LastDemandTimeMs() const { return last_demand_ms_; }
+
+  /// The number of bursts remembered, including the current one.
+  size_t NumBursts() const { return burst_starts_ms_.size(); }
+
+ private:
+  /// The minimum time without demand that separates two bursts.
+  const int64_t burst_gap_ms_;
+  /// The number of most recent bursts to remember.
+  const size_t max_bursts_;
+  /// The last time any demand was recorded.
+  int64_t last_demand_ms_ = -1;
+  /// The start times of the most recent bursts, oldest first.
+  std::deque<int64_t> burst_starts_ms_;
+  /// The peak demand of the most recent bursts, oldest first.
+  std::deque<int64_t> burst_peaks_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,369 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_fork_server.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+
+#ifndef _WIN32
+/// How often to retry connecting while the listen backlog of the template is full.
+constexpr int64_t kConnectRetryIntervalMs = 10;
+
+/// Wait until the socket is ready for the given events or the deadline passes. A
+/// negative fd only waits for the deadline. Returns false on timeout, or once the
+/// shutdown fd becomes readable.
+bool PollSocket(int fd, short events, int shutdown_fd, int64_t deadline_ms,
+                std::error_code &ec) {
+  pollfd pfds[2] = {{fd, events, 0}, {shutdown_fd, POLLIN, 0}};
+  int r;
+  do {
+    const int64_t timeout_ms = std::max<int64_t>(deadline_ms - current_time_ms(), 0);
+    r = poll(pfds, 2, static_cast<int>(timeout_ms));
+  } while (r == -1 && errno == EINTR);
+  if (r == -1) {
+    ec = std::error_code(errno, std::system_category());
+    return false;
+  }
+  if (pfds[1].revents != 0) {
+    ec = std::make_error_code(std::errc::operation_canceled);
+    return false;
+  }
+  if (r == 0) {
+    ec = std::make_error_code(std::errc::timed_out);
+    return false;
+  }
+  return true;
+}
+
+/// Connect to the fork server socket without blocking past the deadline or the
+/// shutdown. Returns -1 on failure.
+int ConnectToSocket(const std::string &socket_path, int shutdown_fd, int64_t deadline_ms,
+                    std::error_code &ec) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    ec = std::make_error_code(std::errc::filename_too_long);
+    return -1;
+  }
+  strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == -1) {
+    ec = std::error_code(errno, std::system_category());
+    return -1;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  while (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1) {
+    if (errno == EINPROGRESS || errno == EINTR) {
+      // The connection completes asynchronously.
+      int error = 0;
+      socklen_t len = sizeof(error);
+      if (!PollSocket(fd, POLLOUT, shutdown_fd, deadline_ms, ec)) {
+        close(fd);
+        return -1;
+      }
+      if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) == -1 || error != 0) {
+        ec = std::error_code(error != 0 ? error : errno, std::system_category());
+        close(fd);
+        return -1;
+      }
+      return fd;
+    }
+    if (errno != EAGAIN) {
+      ec = std::error_code(errno, std::system_category());
+      close(fd);
+      return -1;
+    }
+    // The listen backlog of the template is full.
+    const int64_t retry_ms = current_time_ms() + kConnectRetryIntervalMs;
+    if (retry_ms >= deadline_ms) {
+      ec = std::make_error_code(std::errc::timed_out);
+      close(fd);
+      return -1;
+    }
+    if (!PollSocket(-1, 0, shutdown_fd, retry_ms, ec) && ec != std::errc::timed_out) {
+      close(fd);
+      return -1;
+    }
+    ec = std::error_code();
+  }
+  return fd;
+}
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = MSG_DONTWAIT;
+#endif
+#endif
+
+/// How often the spare worker thread checks whether the template is ready.
+constexpr int64_t kReadyCheckIntervalMs = 100;
+
+}  // namespace
+
+WorkerForkServer::WorkerForkServer(const std::string &socket_path,
+                                   Process template_process, int64_t num_spare_workers,
+                                   int64_t request_timeout_ms)
+    : socket_path_(socket_path),
+      template_process_(std::move(template_process)),
+      num_spare_workers_(std::max<int64_t>(num_spare_workers, 1)),
+      request_timeout_ms_(request_timeout_ms) {
+#ifndef _WIN32
+  RAY_CHECK(pipe(shutdown_fds_) == 0)
+      << "Failed to create a pipe: " << strerror(errno);
+  spare_worker_thread_ = std::thread([this] { ForkSpareWorkers(); });
+#endif
+}
+
+WorkerForkServer::~WorkerForkServer() {
+  {
+    absl::MutexLock lock(&mu_);
+    stopped_ = true;
+  }
+#ifndef _WIN32
+  // Interrupt waiting for the template, so that the destruction doesn't block the
+  // caller for up to the request timeout.
+  char byte = 0;
+  if (write(shutdown_fds_[1], &byte, 1) == -1) {
+    RAY_LOG(WARNING) << "Failed to interrupt the spare worker thread of fork server "
+                     << socket_path_ << ": " << strerror(errno);
+  }
+#endif
+  if (spare_worker_thread_.joinable()) {
+    spare_worker_thread_.join();
+  }
+#ifndef _WIN32
+  close(shutdown_fds_[0]);
+  close(shutdown_fds_[1]);
+#endif
+  {
+    absl::MutexLock lock(&mu_);
+    for (const auto &spare_worker : spare_workers_) {
+      DiscardSpareWorker(spare_worker);
+    }
+    spare_workers_.clear();
+  }
+  template_process_.Kill();
+#ifndef _WIN32
+  unlink(socket_path_.c_str());
+#endif
+}
+
+bool WorkerForkServer::IsReady() const {
+#ifdef _WIN32
+  return false;
+#else
+  return IsAlive() && access(socket_path_.c_str(), F_OK) == 0;
+#endif
+}
+
+bool WorkerForkServer::IsAlive() const {
+  return template_process_.IsValid() && IsProcessAlive(template_process_.GetId());
+}
+
+std::string WorkerForkServer::EncodeRequest(
+    const std::vector<std::string> &worker_command_args, const ProcessEnvironment &env) {
+  std::string payload;
+  for (const auto &arg : worker_command_args) {
+    payload.append(arg).push_back('\0');
+  }
+  // An empty string separates the arguments from the environment variables.
+  payload.push_back('\0');
+  for (const auto &entry : env) {
+    payload.append(entry.first).append("=").append(entry.second).push_back('\0');
+  }
+  std::string request;
+  uint32_t size = static_cast<uint32_t>(payload.size());
+  for (int i = 0; i < 4; i++) {
+    request.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+  }
+  request.append(payload);
+  return request;
+}
+
+pid_t WorkerForkServer::DecodeReply(const std::string &reply) {
+  auto end = reply.find('\n');
+  if (end == std::string::npos || end == 0) {
+    return -1;
+  }
+  pid_t pid = 0;
+  for (size_t i = 0; i < end; i++) {
+    if (reply[i] < '0' || reply[i] > '9') {
+      return -1;
+    }
+    pid = pid * 10 + (reply[i] - '0');
+  }
+  return pid > 0 ? pid : -1;
+}
+
+Process WorkerForkServer::Fork(const std::vector<std::string> &worker_command_args,
+                               const ProcessEnvironment &env, std::error_code &ec) {
+  ec = std::error_code();
+#ifdef _WIN32
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return Process();
+#else
+  SpareWorker spare_worker;
+  {
+    absl::MutexLock lock(&mu_);
+    if (error_) {
+      ec = error_;
+      return Process();
+    }
+    if (spare_workers_.empty()) {
+      return Process();
+    }
+    spare_worker = spare_workers_.front();
+    spare_workers_.pop_front();
+  }
+
+  // The spare worker is waiting for the request, so it fits into the socket buffer
+  // unless it is huge. Never wait for the socket on the event loop.
+  const std::string request = EncodeRequest(worker_command_args, env);
+  size_t written = 0;
+  while (written < request.size()) {
+    ssize_t r = send(spare_worker.fd, request.data() + written, request.size() - written,
+                     kSendFlags);
+    if (r == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        RAY_LOG(WARNING) << "The fork request of " << request.size()
+                         << " bytes doesn't fit into the socket buffer of fork server "
+                         << socket_path_;
+      } else {
+        ec = std::error_code(errno, std::system_category());
+      }
+      // The spare worker exits once it sees the truncated request.
+      DiscardSpareWorker(spare_worker);
+      return Process();
+    }
+    written += static_cast<size_t>(r);
+  }
+  close(spare_worker.fd);
+  // NOTE: The forked worker is a child of the template, not of the raylet. The
+  // template reaps it, so the returned process must not be waited on.
+  return Process::FromPid(spare_worker.pid);
+#endif
+}
+
+bool WorkerForkServer::ShouldForkOrStop() const {
+  return stopped_ || (!error_ && spare_workers_.size() < num_spare_workers_);
+}
+
+void WorkerForkServer::ForkSpareWorkers() {
+  mu_.Lock();
+  while (true) {
+    mu_.Await(absl::Condition(this, &WorkerForkServer::ShouldForkOrStop));
+    if (stopped_) {
+      break;
+    }
+    if (!IsReady()) {
+      // The template is still initializing.
+      mu_.AwaitWithTimeout(absl::Condition(&stopped_),
+                           absl::Milliseconds(kReadyCheckIntervalMs));
+      continue;
+    }
+    mu_.Unlock();
+    std::error_code ec;
+    SpareWorker spare_worker = ForkSpareWorker(ec);
+    mu_.Lock();
+    if (stopped_) {
+      if (!ec) {
+        DiscardSpareWorker(spare_worker);
+      }
+    } else if (ec) {
+      RAY_LOG(WARNING) << "Failed to fork a spare worker from fork server "
+                       << socket_path_ << " with error " << ec << ": " << ec.message();
+      error_ = ec;
+    } else {
+      spare_workers_.push_back(spare_worker);
+    }
+  }
+  mu_.Unlock();
+}
+
+WorkerForkServer::SpareWorker WorkerForkServer::ForkSpareWorker(
+    std::error_code &ec) const {
+  SpareWorker spare_worker = {-1, -1};
+#ifndef _WIN32
+  const int64_t deadline_ms = current_time_ms() + request_timeout_ms_;
+  int fd = ConnectToSocket(socket_path_, shutdown_fds_[0], deadline_ms, ec);
+  if (fd == -1) {
+    return spare_worker;
+  }
+  std::string reply;
+  char buf[32];
+  while (reply.find('\n') == std::string::npos) {
+    if (!PollSocket(fd, POLLIN, shutdown_fds_[0], deadline_ms, ec)) {
+      close(fd);
+      return spare_worker;
+    }
+    ssize_t r = recv(fd, buf, sizeof(buf), 0);
+    if (r == -1 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+      continue;
+    }
+    if (r <= 0) {
+      ec = r == 0 ? std::make_error_code(std::errc::connection_reset)
+                  : std::error_code(errno, std::system_category());
+      close(fd);
+      return spare_worker;
+    }
+    reply.append(buf, static_cast<size_t>(r));
+  }
+
+  pid_t pid = DecodeReply(reply);
+  if (pid == -1) {
+    RAY_LOG(WARNING) << "Received a malformed reply from worker fork server "
+                     << socket_path_ << ": " << reply;
+    ec = std::make_error_code(std::errc::bad_message);
+    close(fd);
+    return spare_worker;
+  }
+  spare_worker.pid = pid;
+  spare_worker.fd = fd;
+#endif
+  return spare_worker;
+}
+
+void WorkerForkServer::DiscardSpareWorker(const SpareWorker &spare_worker) {
+#ifndef _WIN32
+  close(spare_worker.fd);
+#endif
+}
+
+}  // namespace raylet
+
+}  // namespace ray
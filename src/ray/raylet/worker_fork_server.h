@@ -0,0 +1,143 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/util/process.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// \class WorkerForkServer
+///
+/// A handle to a pre-initialized worker process (the "template") that forks new
+/// worker processes on demand. The template is started with the regular worker
+/// command plus `--fork-server-socket=<path>`, imports the worker runtime and then
+/// listens on a Unix domain socket instead of connecting to the raylet.
+///
+/// The template forks a spare worker for each connection and replies with the decimal
+/// PID of the spare followed by a newline. The spare keeps the connection and waits
+/// for its request: a 4-byte little-endian payload length followed by the payload,
+/// which is the NUL-terminated command line arguments of the worker, an empty string,
+/// and the NUL-terminated `KEY=VALUE` environment variables to set. A spare whose
+/// connection is closed without a request exits.
+///
+/// A dedicated thread keeps a few spare workers forked, so that starting a worker on
+/// the raylet's event loop only hands a request to a spare without blocking. Waiting
+/// for the template is interrupted on destruction, so destroying the handle doesn't
+/// block either.
+class WorkerForkServer {
+ public:
+  /// Create a handle to a fork server.
+  ///
+  /// \param socket_path The path of the Unix domain socket the template listens on.
+  /// \param template_process The template process. It is killed on destruction.
+  /// \param num_spare_workers The number of spare workers to keep forked.
+  /// \param request_timeout_ms The timeout of forking a spare worker, including
+  /// connecting to the template and waiting for its reply.
+  WorkerForkServer(const std::string &socket_path, Process template_process,
+                   int64_t num_spare_workers, int64_t request_timeout_ms);
+
+  ~WorkerForkServer();
+
+  /// Whether the template has finished initializing and accepts fork requests.
+  bool IsReady() const;
+
+  /// Whether the template process is still running.
+  bool IsAlive() const;
+
+  /// Start a worker from a spare forked worker. This doesn't block.
+  ///
+  /// \param worker_command_args The command line the worker would have been started
+  /// with. The forked worker parses its options from it.
+  /// \param env The environment variables to set in the forked worker.
+  /// \param[out] ec Any error that occurred, including a failure to fork spare
+  /// workers.
+  /// \return The forked worker process, or a null process if there is no spare
+  /// worker yet or on failure.
+  Process Fork(const std::vector<std::string> &worker_command_args,
+               const ProcessEnvironment &env, std::error_code &ec);
+
+  const Process &GetTemplateProcess() const { return template_process_; }
+
+  const std::string &GetSocketPath() const { return socket_path_; }
+
+  /// Serialize a fork request, including the length prefix.
+  static std::string EncodeRequest(const std::vector<std::string> &worker_command_args,
+                                   const ProcessEnvironment &env);
+
+  /// Parse the reply of the template.
+  ///
+  /// \return The PID of the forked worker, or -1 if the reply is malformed.
+  static pid_t DecodeReply(const std::string &reply);
+
+ private:
+  /// A forked worker that waits for its request on a connection.
+  struct SpareWorker {
+    pid_t pid;
+    int fd;
+  };
+
+  /// Keep `num_spare_workers_` spare workers forked until the handle is destroyed or
+  /// forking fails. Runs on `spare_worker_thread_`.
+  void ForkSpareWorkers();
+
+  /// Whether the spare worker thread should fork another spare worker or exit.
+  bool ShouldForkOrStop() const EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Ask the template for a spare worker. This blocks for up to
+  /// `request_timeout_ms_`, or until the handle is destroyed.
+  ///
+  /// \param[out] ec Any error that occurred.
+  /// \return The spare worker, with a fd of -1 on failure.
+  SpareWorker ForkSpareWorker(std::error_code &ec) const;
+
+  /// Discard a spare worker. The worker exits once its connection is closed.
+  static void DiscardSpareWorker(const SpareWorker &spare_worker);
+
+  /// The path of the Unix domain socket the template listens on.
+  const std::string socket_path_;
+  /// The template process.
+  Process template_process_;
+  /// The number of spare workers to keep forked.
+  const size_t num_spare_workers_;
+  /// The timeout of forking a spare worker.
+  const int64_t request_timeout_ms_;
+
+  mutable absl::Mutex mu_;
+  /// The spare workers, oldest first.
+  std::deque<SpareWorker> spare_workers_ GUARDED_BY(mu_);
+  /// The error that stopped forking spare workers.
+  std::error_code error_ GUARDED_BY(mu_);
+  /// Whether the handle is being destroyed.
+  bool stopped_ GUARDED_BY(mu_) = false;
+  /// A pipe that is written on destruction, to interrupt the spare worker thread while
+  /// it waits for the template.
+  int shutdown_fds_[2] = {-1, -1};
+  /// The thread that forks the spare workers.
+  std::thread spare_worker_thread_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -26,6 +26,7 @@
 #include "ray/core_worker/common.h"
 #include "ray/gcs/pb_util.h"
 #include "ray/stats/stats.h"
+#include "ray/util/filesystem.h"
 #include "ray/util/logging.h"
 #include "ray/util/util.h"
 
@@ -51,6 +52,9 @@ bool RemoveWorker(
   return worker_pool.erase(worker) > 0;
 }
 
+/// The number of most recent bursts of tasks used to predict the next one.
+constexpr size_t kNumWorkerDemandBurstsToRemember = 8;
+
 }  // namespace
 
 namespace ray {
@@ -88,6 +92,8 @@ WorkerPool::WorkerPool(instrumented_io_context &io_service, const NodeID node_id
   // processes have started before a task runs on the node (as opposed to the
   // metric not existing at all).
   stats::NumWorkersStarted.Record(0);
+  stats::NumPredictivePrestartedWorkers.Record(0);
+  stats::NumPredictivePrestartHits.Record(0);
 #ifndef _WIN32
   // Ignore SIGCHLD signals. If we don't do this, then worker processes will
   // become zombies instead of dying gracefully.
@@ -124,6 +130,15 @@ WorkerPool::WorkerPool(instrumented_io_context &io_service, const NodeID node_id
         RayConfig::instance().kill_idle_workers_interval_ms(),
         "RayletWorkerPool.deadline_timer.kill_idle_workers");
   }
+  if (RayConfig::instance().predictive_worker_prestart_enabled()) {
+    // Check the predictions often enough to prestart workers well within the lead
+    // time of a burst.
+    periodical_runner_.RunFnPeriodically(
+        [this] { PrestartWorkersForPredictedDemand(); },
+        std::max<int64_t>(
+            1, RayConfig::instance().predictive_worker_prestart_lead_time_ms() / 10),
+        "RayletWorkerPool.deadline_timer.predictive_prestart_workers");
+  }
 }
 
 WorkerPool::~WorkerPool() {
@@ -155,6 +170,10 @@ void WorkerPool::SetAgentManager(std::shared_ptr<AgentManager> agent_manager) {
   agent_manager_ = agent_manager;
 }
 
+void WorkerPool::SetForkServerSocketDir(const std::string &socket_dir) {
+  fork_server_socket_dir_ = socket_dir;
+}
+
 void WorkerPool::PopWorkerCallbackAsync(const PopWorkerCallback &callback,
                                         std::shared_ptr<WorkerInterface> worker,
                                         PopWorkerStatus status) {
@@ -208,8 +227,23 @@ Process WorkerPool::StartWorkerProcess(
     }
   }
 
+  // Workers forked from a ready fork server start much faster, so more of them are
+  // allowed to be pending registration at the same time.
+  const bool fork_worker_process =
+      RayConfig::instance().worker_fork_server_enabled() &&
+      CanForkWorkerProcess(language, worker_type, dynamic_options);
+  int64_t maximum_startup_concurrency = maximum_startup_concurrency_;
+  if (fork_worker_process) {
+    auto it = state.fork_servers.find(runtime_env_hash);
+    if (it != state.fork_servers.end() && it->second->IsReady()) {
+      maximum_startup_concurrency = std::max<int64_t>(
+          maximum_startup_concurrency,
+          RayConfig::instance().worker_fork_server_max_startup_concurrency());
+    }
+  }
+
   // Here we consider both task workers and I/O workers.
-  if (starting_workers >= maximum_startup_concurrency_) {
+  if (starting_workers >= maximum_startup_concurrency) {
     // Workers have been started, but not registered. Force start disabled -- returning.
     RAY_LOG(DEBUG) << "Worker not started, " << starting_workers
                    << " workers of language type " << static_cast<int>(language)
@@ -408,7 +442,14 @@ Process WorkerPool::StartWorkerProcess(
 
   // Start a process and measure the startup time.
   auto start = std::chrono::high_resolution_clock::now();
-  Process proc = StartProcess(worker_command_args, env);
+  Process proc;
+  if (fork_worker_process) {
+    proc = StartProcessFromForkServer(state, language, runtime_env_hash,
+                                      worker_command_args, env);
+  }
+  if (proc.IsNull()) {
+    proc = StartProcess(worker_command_args, env);
+  }
   auto end = std::chrono::high_resolution_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
   stats::ProcessStartupTimeMs.Record(duration.count());
@@ -516,6 +557,82 @@ Process WorkerPool::StartProcess(const std::vector<std::string> &worker_command_
   return child;
 }
 
+bool WorkerPool::CanForkWorkerProcess(
+    const Language &language, const rpc::WorkerType worker_type,
+    const std::vector<std::string> &dynamic_options) const {
+#ifdef _WIN32
+  return false;
+#else
+  // Only Python workers import enough at startup to benefit from forking, and
+  // dynamic options may change the interpreter itself, so they are never forked.
+  return language == Language::PYTHON && worker_type == rpc::WorkerType::WORKER &&
+         dynamic_options.empty();
+#endif
+}
+
+Process WorkerPool::StartProcessFromForkServer(
+    State &state, const Language &language, int runtime_env_hash,
+    const std::vector<std::string> &worker_command_args, const ProcessEnvironment &env) {
+  auto it = state.fork_servers.find(runtime_env_hash);
+  if (it != state.fork_servers.end() && !it->second->IsAlive()) {
+    RAY_LOG(WARNING) << "Worker fork server with pid "
+                     << it->second->GetTemplateProcess().GetId()
+                     << " has exited, restarting it.";
+    state.fork_servers.erase(it);
+    it = state.fork_servers.end();
+  }
+
+  if (it == state.fork_servers.end()) {
+    // Start the template from the same command as the worker, so that it sets up the
+    // same runtime env. The job ID is passed to each forked worker instead.
+    // Unix domain socket paths are limited to about 100 characters, so keep the name
+    // short. Several raylets may share the session dir.
+    const std::string socket_path =
+        JoinPaths(fork_server_socket_dir_.empty() ? GetUserTempDir()
+                                                  : fork_server_socket_dir_,
+                  "fork_server_" + node_id_.Hex().substr(0, 8) + "_" +
+                      std::to_string(runtime_env_hash) + ".sock");
+    std::vector<std::string> template_args = worker_command_args;
+    template_args.push_back("--fork-server-socket=" + socket_path);
+    ProcessEnvironment template_env = env;
+    template_env.erase(kEnvVarKeyJobId);
+    RAY_LOG(INFO) << "Starting worker fork server for runtime env hash "
+                  << runtime_env_hash << " listening on " << socket_path;
+    Process template_process = StartProcess(template_args, template_env);
+    state.fork_servers.emplace(
+        runtime_env_hash,
+        std::make_unique<WorkerForkServer>(
+            socket_path, std::move(template_process),
+            RayConfig::instance().worker_fork_server_num_spare_workers(),
+            RayConfig::instance().worker_fork_server_request_timeout_ms()));
+    // Start this worker from scratch, the template takes as long to initialize.
+    return Process();
+  }
+
+  auto &fork_server = it->second;
+  if (!fork_server->IsReady()) {
+    return Process();
+  }
+  // This hands the request to a spare worker that the fork server forked in the
+  // background, and doesn't block. If there is no spare worker yet, the worker is
+  // started from scratch.
+  std::error_code ec;
+  Process proc = fork_server->Fork(worker_command_args, env, ec);
+  if (!ec && proc.IsNull()) {
+    return Process();
+  }
+  if (ec || !proc.IsValid()) {
+    RAY_LOG(WARNING) << "Failed to fork a worker from fork server "
+                     << fork_server->GetSocketPath() << " with error " << ec << ": "
+                     << ec.message() << ". Falling back to starting a new process.";
+    state.fork_servers.erase(it);
+    return Process();
+  }
+  RAY_LOG(DEBUG) << "Forked worker process with pid " << proc.GetId()
+                 << " from fork server " << fork_server->GetSocketPath();
+  return proc;
+}
+
 Status WorkerPool::GetNextFreePort(int *port) {
   if (!free_ports_) {
     *port = 0;
@@ -574,6 +691,13 @@ void WorkerPool::HandleJobFinished(const JobID &job_id) {
   // https://github.com/ray-project/ray/issues/11437.
   // unfinished_jobs_.erase(job_id);
   finished_jobs_.insert(job_id);
+  for (auto it = worker_demand_.begin(); it != worker_demand_.end();) {
+    if (std::get<1>(it->first) == job_id) {
+      worker_demand_.erase(it++);
+    } else {
+      it++;
+    }
+  }
 }
 
 boost::optional<const rpc::JobConfig &> WorkerPool::GetJobConfig(
@@ -644,6 +768,13 @@ void WorkerPool::OnWorkerStarted(const std::shared_ptr<WorkerInterface> &worker)
     io_worker_state.num_starting_io_workers--;
   }
 
+  auto prestart_it = predictive_prestart_processes_.find(worker_startup_token);
+  if (prestart_it != predictive_prestart_processes_.end()) {
+    warm_workers_[worker] = prestart_it->second;
+    num_predictive_prestarted_workers_++;
+    stats::NumPredictivePrestartedWorkers.Record(1);
+  }
+
   // This is a workaround to finish driver registration after all initial workers are
   // registered to Raylet if and only if Raylet is started by a Python driver and the
   // job config is not set in `ray.init(...)`.
@@ -885,6 +1016,11 @@ void WorkerPool::TryKillingIdleWorkers() {
       continue;
     }
 
+    if (IsKeptWarm(idle_worker, now)) {
+      // The worker was prestarted for a predicted burst of tasks that isn't over yet.
+      continue;
+    }
+
     if (now - idle_pair.second <
         RayConfig::instance().idle_worker_killing_time_threshold_ms()) {
       break;
@@ -1115,6 +1251,10 @@ void WorkerPool::PopWorker(const TaskSpecification &task_spec,
       worker = std::move(lit->first);
       idle_of_all_languages_.erase(lit);
       idle_of_all_languages_map_.erase(worker);
+      if (warm_workers_.erase(worker) > 0) {
+        num_predictive_prestart_hits_++;
+        stats::NumPredictivePrestartHits.Record(1);
+      }
       break;
     }
 
@@ -1153,6 +1293,12 @@ void WorkerPool::PopWorker(const TaskSpecification &task_spec,
 
 void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec, int64_t backlog_size,
                                  int64_t num_available_cpus) {
+  if (RayConfig::instance().predictive_worker_prestart_enabled() &&
+      !(task_spec.IsActorCreationTask() && !task_spec.DynamicWorkerOptions().empty())) {
+    RecordWorkerDemand(task_spec,
+                       std::max<int64_t>(1, std::min(num_available_cpus, backlog_size)));
+  }
+
   // Code path of task that needs a dedicated worker.
   if ((task_spec.IsActorCreationTask() && !task_spec.DynamicWorkerOptions().empty()) ||
       task_spec.HasRuntimeEnv()) {
@@ -1183,11 +1329,135 @@ void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec, int64_t bac
   }
 }
 
+void WorkerPool::RecordWorkerDemand(const TaskSpecification &task_spec,
+                                    int64_t demand) {
+  WorkerDemandKey key(task_spec.GetLanguage(), task_spec.JobId(),
+                      task_spec.GetRuntimeEnvHash());
+  auto it = worker_demand_.find(key);
+  if (it == worker_demand_.end()) {
+    it = worker_demand_
+             .emplace(key, WorkerDemandState(WorkerDemandHistory(
+                               RayConfig::instance()
+                                   .predictive_worker_prestart_burst_gap_ms(),
+                               kNumWorkerDemandBurstsToRemember)))
+             .first;
+    if (task_spec.HasRuntimeEnv()) {
+      it->second.serialized_runtime_env = task_spec.SerializedRuntimeEnv();
+    }
+  }
+  it->second.history.RecordDemand(static_cast<int64_t>(get_time_()), demand);
+}
+
+void WorkerPool::PrestartWorkersForPredictedDemand() {
+  const int64_t now = get_time_();
+  for (auto it = warm_workers_.begin(); it != warm_workers_.end();) {
+    if (it->second <= now) {
+      warm_workers_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+  for (auto it = predictive_prestart_processes_.begin();
+       it != predictive_prestart_processes_.end();) {
+    if (it->second <= now) {
+      predictive_prestart_processes_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+
+  const int64_t keep_warm_ms =
+      RayConfig::instance().predictive_worker_prestart_keep_warm_ms();
+  for (auto &entry : worker_demand_) {
+    const auto &language = std::get<0>(entry.first);
+    const auto &job_id = std::get<1>(entry.first);
+    const int runtime_env_hash = std::get<2>(entry.first);
+    auto &demand_state = entry.second;
+    int64_t burst_start_ms;
+    int64_t burst_demand;
+    if (!demand_state.history.PredictNextBurst(
+            RayConfig::instance().predictive_worker_prestart_min_bursts(),
+            &burst_start_ms, &burst_demand)) {
+      continue;
+    }
+    if (burst_start_ms == demand_state.prestarted_burst_start_ms ||
+        burst_start_ms - now >
+            RayConfig::instance().predictive_worker_prestart_lead_time_ms() ||
+        now >= burst_start_ms + keep_warm_ms || finished_jobs_.count(job_id)) {
+      // Already prestarted, too early, or the predicted burst never came.
+      continue;
+    }
+    demand_state.prestarted_burst_start_ms = burst_start_ms;
+
+    // Account for the idle workers that can already serve the burst.
+    int64_t num_usable_workers = 0;
+    for (const auto &idle_pair : idle_of_all_languages_) {
+      const auto &idle_worker = idle_pair.first;
+      if (idle_worker->GetLanguage() == language &&
+          idle_worker->GetAssignedJobId() == job_id &&
+          idle_worker->GetRuntimeEnvHash() == runtime_env_hash &&
+          !idle_worker->IsDead() &&
+          !pending_exit_idle_workers_.count(idle_worker->WorkerId())) {
+        num_usable_workers++;
+      }
+    }
+    int64_t num_needed =
+        std::min<int64_t>(burst_demand, num_workers_soft_limit_) - num_usable_workers;
+    if (num_needed <= 0) {
+      continue;
+    }
+    RAY_LOG(DEBUG) << "Prestarting " << num_needed << " workers for job " << job_id
+                   << " ahead of a burst of tasks predicted in " << burst_start_ms - now
+                   << " ms";
+    for (int64_t i = 0; i < num_needed; i++) {
+      PrestartWorkerForPredictedDemand(language, job_id, runtime_env_hash,
+                                       demand_state.serialized_runtime_env,
+                                       burst_start_ms + keep_warm_ms);
+    }
+  }
+}
+
+void WorkerPool::PrestartWorkerForPredictedDemand(
+    const Language &language, const JobID &job_id, int runtime_env_hash,
+    const std::string &serialized_runtime_env, int64_t keep_warm_deadline_ms) {
+  auto start_worker_process_fn = [this, language, job_id, runtime_env_hash,
+                                  serialized_runtime_env, keep_warm_deadline_ms](
+                                     const std::string &serialized_runtime_env_context) {
+    PopWorkerStatus status = PopWorkerStatus::OK;
+    StartupToken startup_token = worker_startup_token_counter_;
+    Process proc = StartWorkerProcess(language, rpc::WorkerType::WORKER, job_id, &status,
+                                      {}, runtime_env_hash, serialized_runtime_env,
+                                      serialized_runtime_env_context);
+    if (status == PopWorkerStatus::OK && proc.IsValid()) {
+      predictive_prestart_processes_[startup_token] = keep_warm_deadline_ms;
+    }
+  };
+  if (serialized_runtime_env.empty()) {
+    start_worker_process_fn("");
+  } else {
+    CreateRuntimeEnv(
+        serialized_runtime_env, job_id,
+        [start_worker_process_fn](bool successful,
+                                  const std::string &serialized_runtime_env_context) {
+          if (successful) {
+            start_worker_process_fn(serialized_runtime_env_context);
+          }
+        });
+  }
+}
+
+bool WorkerPool::IsKeptWarm(const std::shared_ptr<WorkerInterface> &worker,
+                            int64_t now) const {
+  auto it = warm_workers_.find(worker);
+  return it != warm_workers_.end() && now < it->second;
+}
+
 bool WorkerPool::DisconnectWorker(const std::shared_ptr<WorkerInterface> &worker,
                                   rpc::WorkerExitType disconnect_type) {
   auto &state = GetStateForLanguage(worker->GetLanguage());
   RAY_CHECK(RemoveWorker(state.registered_workers, worker));
   RAY_UNUSED(RemoveWorker(state.pending_disconnection_workers, worker));
+  warm_workers_.erase(worker);
 
   for (auto it = idle_of_all_languages_.begin(); it != idle_of_all_languages_.end();
        it++) {
@@ -1394,6 +1664,11 @@ std::string WorkerPool::DebugString() const {
            << entry.second.util_io_worker_state.pending_io_tasks.size();
   }
   result << "\n- num idle workers: " << idle_of_all_languages_.size();
+  if (RayConfig::instance().predictive_worker_prestart_enabled()) {
+    result << "\n- num predictive prestarted workers: "
+           << num_predictive_prestarted_workers_
+           << ", used by a task: " << num_predictive_prestart_hits_;
+  }
   return result.str();
 }
 
@@ -33,6 +33,8 @@
 #include "ray/gcs/gcs_client/gcs_client.h"
 #include "ray/raylet/agent_manager.h"
 #include "ray/raylet/worker.h"
+#include "ray/raylet/worker_demand_history.h"
+#include "ray/raylet/worker_fork_server.h"
 
 namespace ray {
 
@@ -192,6 +194,10 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// Set agent manager.
   void SetAgentManager(std::shared_ptr<AgentManager> agent_manager);
 
+  /// Set the directory of the sockets of the worker fork servers.
+  /// \param socket_dir A directory of this session, which is removed with it.
+  void SetForkServerSocketDir(const std::string &socket_dir);
+
   /// Handles the event that a job is started.
   ///
   /// \param job_id ID of the started job.
@@ -334,6 +340,12 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   void PrestartWorkers(const TaskSpecification &task_spec, int64_t backlog_size,
                        int64_t num_available_cpus);
 
+  /// Prestart workers for the bursts of tasks that are predicted to start soon, based
+  /// on the demand recorded by `PrestartWorkers`. The prestarted workers are kept from
+  /// being killed as idle until the predicted burst is over. This is called
+  /// periodically if `predictive_worker_prestart_enabled` is set.
+  void PrestartWorkersForPredictedDemand();
+
   /// Return the current size of the worker pool for the requested language. Counts only
   /// idle workers.
   ///
@@ -429,6 +441,12 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// Push an warning message to user if worker pool is getting to big.
   virtual void WarnAboutSize();
 
+  /// Whether a worker process with the given properties can be forked from a fork
+  /// server instead of being started from scratch.
+  virtual bool CanForkWorkerProcess(
+      const Language &language, const rpc::WorkerType worker_type,
+      const std::vector<std::string> &dynamic_options) const;
+
   /// Make this synchronized function for unit test.
   void PopWorkerCallbackInternal(const PopWorkerCallback &callback,
                                  std::shared_ptr<WorkerInterface> worker,
@@ -505,6 +523,9 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
     /// processes.
     absl::flat_hash_map<Process, TaskWaitingForWorkerInfo>
         starting_dedicated_workers_to_tasks;
+    /// The fork servers of this language, keyed by the runtime env hash of the workers
+    /// they fork. Only used if `worker_fork_server_enabled` is set.
+    absl::flat_hash_map<int, std::unique_ptr<WorkerForkServer>> fork_servers;
     /// We'll push a warning to the user every time a multiple of this many
     /// worker processes has been started.
     int multiple_for_warning;
@@ -526,6 +547,22 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// for a given language.
   State &GetStateForLanguage(const Language &language);
 
+  /// Fork a worker process from the fork server of the given runtime env. If there is
+  /// no running fork server for the runtime env yet, one is started from the given
+  /// command and a null process is returned, so that the caller falls back to
+  /// `StartProcess` until the fork server is ready.
+  ///
+  /// \param state The pool state of the worker's language.
+  /// \param language The language of the worker.
+  /// \param runtime_env_hash The hash of the worker's runtime env.
+  /// \param worker_command_args The command arguments of the new worker process.
+  /// \param env Additional environment variables of the new worker process.
+  /// \return The forked worker process, or a null process if it couldn't be forked.
+  Process StartProcessFromForkServer(State &state, const Language &language,
+                                     int runtime_env_hash,
+                                     const std::vector<std::string> &worker_command_args,
+                                     const ProcessEnvironment &env);
+
   /// Start a timer to monitor the starting worker process.
   ///
   /// If any workers in this process don't register within the timeout
@@ -612,6 +649,27 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
       const PopWorkerStatus &status, bool *found /* output */,
       bool *worker_used /* output */, TaskID *task_id /* output */);
 
+  /// Record the demand for workers of the given task's job and runtime env, which
+  /// is used to predict bursts of tasks.
+  void RecordWorkerDemand(const TaskSpecification &task_spec, int64_t demand);
+
+  /// Start a worker process ahead of a predicted burst of tasks.
+  ///
+  /// \param language The language of the worker.
+  /// \param job_id The job of the worker.
+  /// \param runtime_env_hash The hash of the worker's runtime env.
+  /// \param serialized_runtime_env The runtime env of the worker.
+  /// \param keep_warm_deadline_ms The time until which the worker is kept from being
+  /// killed as idle.
+  void PrestartWorkerForPredictedDemand(const Language &language, const JobID &job_id,
+                                        int runtime_env_hash,
+                                        const std::string &serialized_runtime_env,
+                                        int64_t keep_warm_deadline_ms);
+
+  /// Whether the given idle worker was prestarted for a predicted burst of tasks that
+  /// isn't over yet.
+  bool IsKeptWarm(const std::shared_ptr<WorkerInterface> &worker, int64_t now) const;
+
   /// Create runtime env asynchronously by runtime env agent.
   void CreateRuntimeEnv(
       const std::string &serialized_runtime_env, const JobID &job_id,
@@ -633,6 +691,9 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   std::unique_ptr<std::queue<int>> free_ports_;
   /// The port Raylet uses for listening to incoming connections.
   int node_manager_port_ = 0;
+  /// The directory of the sockets of the worker fork servers. If empty, the user's
+  /// temp dir is used.
+  std::string fork_server_socket_dir_;
   /// A client connection to the GCS.
   std::shared_ptr<gcs::GcsClient> gcs_client_;
   /// The native library path which includes the core libraries.
@@ -674,6 +735,39 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   absl::flat_hash_map<WorkerID, std::shared_ptr<WorkerInterface>>
       pending_exit_idle_workers_;
 
+  /// The language, job and runtime env hash of workers whose demand is tracked.
+  using WorkerDemandKey = std::tuple<Language, JobID, int>;
+
+  struct WorkerDemandState {
+    explicit WorkerDemandState(WorkerDemandHistory history)
+        : history(std::move(history)) {}
+    /// The history of demand bursts.
+    WorkerDemandHistory history;
+    /// The runtime env of the workers.
+    std::string serialized_runtime_env;
+    /// The predicted start time of the last burst that workers were prestarted for.
+    int64_t prestarted_burst_start_ms = -1;
+  };
+
+  /// The worker demand history per language, job and runtime env. Only populated if
+  /// `predictive_worker_prestart_enabled` is set.
+  absl::flat_hash_map<WorkerDemandKey, WorkerDemandState> worker_demand_;
+
+  /// The startup tokens of the processes started ahead of predicted bursts of tasks,
+  /// mapped to the time until which their workers are kept warm.
+  absl::flat_hash_map<StartupToken, int64_t> predictive_prestart_processes_;
+
+  /// The workers started ahead of predicted bursts of tasks that haven't been used by
+  /// a task yet, mapped to the time until which they are kept warm.
+  absl::flat_hash_map<std::shared_ptr<WorkerInterface>, int64_t> warm_workers_;
+
+  /// The number of workers started ahead of predicted bursts of tasks.
+  int64_t num_predictive_prestarted_workers_ = 0;
+
+  /// The number of workers started ahead of predicted bursts of tasks that were used
+  /// by a task while warm.
+  int64_t num_predictive_prestart_hits_ = 0;
+
   /// The runner to run function periodically.
   PeriodicalRunner periodical_runner_;
 
@@ -14,12 +14,19 @@
 
 #include "ray/raylet/worker_pool.h"
 
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <thread>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/asio/asio_util.h"
 #include "ray/common/asio/instrumented_io_context.h"
 #include "ray/common/constants.h"
 #include "ray/raylet/node_manager.h"
+#include "ray/raylet/worker_fork_server.h"
+#include "ray/util/filesystem.h"
 #include "ray/util/process.h"
 
 namespace ray {
@@ -169,12 +176,12 @@ class WorkerPoolMock : public WorkerPool {
   }
 
   int NumSpillWorkerStarting() const {
-    auto state = states_by_lang_.find(Language::PYTHON)->second;
+    const auto &state = states_by_lang_.find(Language::PYTHON)->second;
     return state.spill_io_worker_state.num_starting_io_workers;
   }
 
   int NumRestoreWorkerStarting() const {
-    auto state = states_by_lang_.find(Language::PYTHON)->second;
+    const auto &state = states_by_lang_.find(Language::PYTHON)->second;
     return state.restore_io_worker_state.num_starting_io_workers;
   }
 
@@ -1451,6 +1458,199 @@ TEST_F(WorkerPoolTest, PopWorkerStatus) {
   worker_pool_->ClearProcesses();
 }
 
+TEST_F(WorkerPoolTest, StartWorkerForkServer) {
+  RayConfig::instance().initialize(R"({"worker_fork_server_enabled": true})");
+  PopWorkerStatus status;
+  // The first Python worker starts the fork server template as well as a worker
+  // process from scratch, since the template isn't ready yet.
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID,
+                                   &status);
+  ASSERT_EQ(status, PopWorkerStatus::OK);
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 2);
+  int num_templates = 0;
+  for (const auto &entry : worker_pool_->GetProcesses()) {
+    for (const auto &arg : entry.second) {
+      if (arg.find("--fork-server-socket=") == 0) {
+        num_templates++;
+      }
+    }
+  }
+  ASSERT_EQ(num_templates, 1);
+  // The template isn't counted as a starting worker.
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 1);
+
+  // Workers with dynamic options are never forked.
+  worker_pool_->ClearProcesses();
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID,
+                                   &status, {"XXX=YYY"});
+  ASSERT_EQ(status, PopWorkerStatus::OK);
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 1);
+  RayConfig::instance().initialize(R"({"worker_fork_server_enabled": false})");
+  worker_pool_->ClearProcesses();
+}
+
+TEST_F(WorkerPoolTest, PrestartWorkersForPredictedDemand) {
+  RayConfig::instance().initialize(R"({"predictive_worker_prestart_enabled": true})");
+  const auto task_spec = ExampleTaskSpec();
+  // Three bursts of 3 tasks, 20s apart.
+  for (int i = 0; i < 3; i++) {
+    worker_pool_->SetCurrentTimeMs(i * 20000);
+    worker_pool_->PrestartWorkers(task_spec, 3, /*num_available_cpus=*/8);
+  }
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 3);
+  worker_pool_->ClearProcesses();
+
+  // The next burst is predicted at 60s, which is too far away.
+  worker_pool_->SetCurrentTimeMs(45000);
+  worker_pool_->PrestartWorkersForPredictedDemand();
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 0);
+
+  // Within the lead time, workers are prestarted for the whole burst, but only once.
+  worker_pool_->SetCurrentTimeMs(55000);
+  worker_pool_->PrestartWorkersForPredictedDemand();
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 3);
+  worker_pool_->PrestartWorkersForPredictedDemand();
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 3);
+
+  // A prestarted worker is used by the burst.
+  const auto &proc = worker_pool_->GetProcesses().begin()->first;
+  auto worker = worker_pool_->CreateWorker(Process());
+  worker->SetStartupToken(worker_pool_->GetStartupToken(proc));
+  RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, proc.GetId(), proc.GetId(),
+                                            worker_pool_->GetStartupToken(proc),
+                                            [](Status, int) {}));
+  worker_pool_->OnWorkerStarted(worker);
+  worker_pool_->PushWorker(worker);
+  worker_pool_->SetCurrentTimeMs(60000);
+  ASSERT_EQ(worker_pool_->PopWorkerSync(task_spec), worker);
+  ASSERT_NE(worker_pool_->DebugString().find("used by a task: 1"), std::string::npos);
+
+  RayConfig::instance().initialize(R"({"predictive_worker_prestart_enabled": false})");
+  worker_pool_->ClearProcesses();
+}
+
+TEST(WorkerForkServerTest, EncodeRequestAndDecodeReply) {
+  ProcessEnvironment env;
+  env["RAY_JOB_ID"] = "01000000";
+  auto request = WorkerForkServer::EncodeRequest({"python", "--startup-token=1"}, env);
+  std::string payload("python\0--startup-token=1\0\0RAY_JOB_ID=01000000\0", 46);
+  ASSERT_EQ(request.size(), 4 + payload.size());
+  ASSERT_EQ(static_cast<uint8_t>(request[0]), payload.size());
+  ASSERT_EQ(request[1], 0);
+  ASSERT_EQ(request.substr(4), payload);
+
+  ASSERT_EQ(WorkerForkServer::DecodeReply("1234\n"), 1234);
+  ASSERT_EQ(WorkerForkServer::DecodeReply("1234"), -1);
+  ASSERT_EQ(WorkerForkServer::DecodeReply("\n"), -1);
+  ASSERT_EQ(WorkerForkServer::DecodeReply("12a4\n"), -1);
+}
+
+#ifndef _WIN32
+TEST(WorkerForkServerTest, ForkOverSocket) {
+  const std::string socket_path =
+      JoinPaths(GetUserTempDir(), "ray_fork_server_test_" + std::to_string(getpid()));
+  unlink(socket_path.c_str());
+  // Start the template before listening, so that it doesn't inherit the socket.
+  Process template_process = Process::Spawn({"sleep", "60"}, false).first;
+  boost::asio::io_service io_service;
+  boost::asio::local::stream_protocol::acceptor acceptor(
+      io_service, boost::asio::local::stream_protocol::endpoint(socket_path));
+  std::string received;
+  // A fake template that "forks" the test process itself as a spare worker, which
+  // then reads its request. Later spare workers fail to connect.
+  std::thread server([&acceptor, &received]() {
+    boost::asio::local::stream_protocol::socket socket(acceptor.get_executor());
+    acceptor.accept(socket);
+    acceptor.close();
+    boost::asio::write(socket, boost::asio::buffer(std::to_string(getpid()) + "\n"));
+    char header[4];
+    boost::asio::read(socket, boost::asio::buffer(header, 4));
+    uint32_t size = 0;
+    for (int i = 0; i < 4; i++) {
+      size |= static_cast<uint32_t>(static_cast<uint8_t>(header[i])) << (8 * i);
+    }
+    received.resize(size);
+    boost::asio::read(socket, boost::asio::buffer(&received[0], size));
+  });
+
+  WorkerForkServer fork_server(socket_path, std::move(template_process),
+                               /*num_spare_workers=*/1, /*request_timeout_ms=*/10000);
+  // Starting a worker doesn't wait for the spare worker to be forked.
+  std::error_code ec;
+  Process proc;
+  while (proc.IsNull()) {
+    proc = fork_server.Fork({"python", "worker.py"}, {}, ec);
+    ASSERT_FALSE(ec);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  server.join();
+  ASSERT_EQ(proc.GetId(), getpid());
+  ASSERT_EQ(received, std::string("python\0worker.py\0\0", 18));
+}
+
+TEST(WorkerForkServerTest, DestroyWhileWaitingForTemplate) {
+  const std::string socket_path = JoinPaths(
+      GetUserTempDir(), "ray_fork_server_destroy_test_" + std::to_string(getpid()));
+  unlink(socket_path.c_str());
+  Process template_process = Process::Spawn({"sleep", "60"}, false).first;
+  boost::asio::io_service io_service;
+  boost::asio::local::stream_protocol::acceptor acceptor(
+      io_service, boost::asio::local::stream_protocol::endpoint(socket_path));
+  boost::asio::local::stream_protocol::socket socket(io_service);
+
+  auto fork_server = std::make_unique<WorkerForkServer>(
+      socket_path, std::move(template_process),
+      /*num_spare_workers=*/1, /*request_timeout_ms=*/60000);
+  // A template that accepts the connection but never replies.
+  acceptor.accept(socket);
+  // Destroying the handle interrupts waiting for the reply instead of blocking until
+  // the request times out.
+  int64_t start_ms = current_time_ms();
+  fork_server.reset();
+  ASSERT_LT(current_time_ms() - start_ms, 10000);
+}
+#endif
+
+TEST(WorkerDemandHistoryTest, PredictPeriodicBursts) {
+  WorkerDemandHistory history(/*burst_gap_ms=*/1000, /*max_bursts=*/4);
+  int64_t start_ms;
+  int64_t demand;
+  // Demand less than the burst gap apart belongs to the same burst.
+  history.RecordDemand(0, 2);
+  history.RecordDemand(500, 4);
+  history.RecordDemand(1200, 1);
+  ASSERT_EQ(history.NumBursts(), 1);
+  ASSERT_FALSE(history.PredictNextBurst(2, &start_ms, &demand));
+
+  history.RecordDemand(10000, 3);
+  ASSERT_EQ(history.NumBursts(), 2);
+  ASSERT_FALSE(history.PredictNextBurst(3, &start_ms, &demand));
+  history.RecordDemand(21000, 2);
+  ASSERT_TRUE(history.PredictNextBurst(3, &start_ms, &demand));
+  ASSERT_EQ(start_ms, 31500);
+  ASSERT_EQ(demand, 4);
+
+  // Only the most recent bursts are remembered.
+  history.RecordDemand(31000, 2);
+  history.RecordDemand(41000, 2);
+  ASSERT_EQ(history.NumBursts(), 4);
+  ASSERT_TRUE(history.PredictNextBurst(3, &start_ms, &demand));
+  ASSERT_EQ(start_ms, 51333);
+  ASSERT_EQ(demand, 3);
+  ASSERT_EQ(history.LastDemandTimeMs(), 41000);
+}
+
+TEST(WorkerDemandHistoryTest, NoPredictionForIrregularBursts) {
+  WorkerDemandHistory history(/*burst_gap_ms=*/1000, /*max_bursts=*/8);
+  history.RecordDemand(0, 1);
+  history.RecordDemand(2000, 1);
+  history.RecordDemand(30000, 1);
+  history.RecordDemand(33000, 1);
+  int64_t start_ms;
+  int64_t demand;
+  ASSERT_FALSE(history.PredictNextBurst(3, &start_ms, &demand));
+}
+
 }  // namespace raylet
 
 }  // namespace ray
@@ -454,17 +454,22 @@ void raylet::RayletClient::GlobalGC(
 }
 
 void raylet::RayletClient::UpdateResourceUsage(
-
     std::string &serialized_resource_usage_batch,
+    const std::vector<rpc::Address> &relay_addresses,
     const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) {
   rpc::UpdateResourceUsageRequest request;
   request.set_serialized_resource_usage_batch(serialized_resource_usage_batch);
+  for (const auto &address : relay_addresses) {
+    request.add_relay_addresses()->CopyFrom(address);
+  }
   grpc_client_->UpdateResourceUsage(request, callback);
 }
 
 void raylet::RayletClient::RequestResourceReport(
+    int64_t last_applied_version,
     const rpc::ClientCallback<rpc::RequestResourceReportReply> &callback) {
   rpc::RequestResourceReportRequest request;
+  request.set_last_applied_version(last_applied_version);
   grpc_client_->RequestResourceReport(request, callback);
 }
 
@@ -157,11 +157,23 @@ class DependencyWaiterInterface {
 /// Inteface for getting resource reports.
 class ResourceTrackingInterface {
  public:
+  /// Send a batch of resource usage updates to the raylet.
+  ///
+  /// \param serialized_resource_usage_batch The serialized ResourceUsageBroadcastData.
+  /// \param relay_addresses The raylets that the receiver should relay the batch to.
+  /// \param callback Callback that will be called after the raylet replies.
   virtual void UpdateResourceUsage(
       std::string &serialized_resource_usage_batch,
+      const std::vector<rpc::Address> &relay_addresses,
       const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) = 0;
 
+  /// Request a report of the raylet's resources.
+  ///
+  /// \param last_applied_version The version of the last report of the raylet that the
+  /// requester has, or 0 if none.
+  /// \param callback Callback that will be called with the report.
   virtual void RequestResourceReport(
+      int64_t last_applied_version,
       const rpc::ClientCallback<rpc::RequestResourceReportReply> &callback) = 0;
 
   virtual ~ResourceTrackingInterface(){};
@@ -443,9 +455,11 @@ class RayletClient : public RayletClientInterface {
 
   void UpdateResourceUsage(
       std::string &serialized_resource_usage_batch,
+      const std::vector<rpc::Address> &relay_addresses,
       const rpc::ClientCallback<rpc::UpdateResourceUsageReply> &callback) override;
 
   void RequestResourceReport(
+      int64_t last_applied_version,
       const rpc::ClientCallback<rpc::RequestResourceReportReply> &callback) override;
 
   // Subscribe to receive notification on plasma object
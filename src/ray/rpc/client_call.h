@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <google/protobuf/arena.h>
 #include <grpcpp/grpcpp.h>
 
 #include <boost/asio.hpp>
@@ -72,6 +73,7 @@ class ClientCallImpl : public ClientCall {
                           int64_t timeout_ms = -1)
       : callback_(std::move(const_cast<ClientCallback<Reply> &>(callback))),
         stats_handle_(std::move(stats_handle)) {
+    reply_ = google::protobuf::Arena::CreateMessage<Reply>(&arena_);
     if (timeout_ms != -1) {
       auto deadline =
           std::chrono::system_clock::now() + std::chrono::milliseconds(timeout_ms);
@@ -96,15 +98,18 @@ class ClientCallImpl : public ClientCall {
       status = return_status_;
     }
     if (callback_ != nullptr) {
-      callback_(status, reply_);
+      callback_(status, *reply_);
     }
   }
 
   std::shared_ptr<StatsHandle> GetStatsHandle() override { return stats_handle_; }
 
  private:
-  /// The reply message.
-  Reply reply_;
+  /// The memory pool for the reply, so that parsing it doesn't allocate field by field.
+  google::protobuf::Arena arena_;
+
+  /// The reply message. This one is owned by arena.
+  Reply *reply_;
 
   /// The callback function to handle the reply.
   ClientCallback<Reply> callback_;
@@ -245,7 +250,7 @@ class ClientCallManager {
     // `ClientCall` is safe to use. But `response_reader_->Finish` only accepts a raw
     // pointer.
     auto tag = new ClientCallTag(call);
-    call->response_reader_->Finish(&call->reply_, &call->status_, (void *)tag);
+    call->response_reader_->Finish(call->reply_, &call->status_, (void *)tag);
     return call;
   }
 
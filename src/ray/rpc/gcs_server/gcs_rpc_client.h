@@ -141,6 +141,9 @@ class GcsRpcClient {
   /// Create actor via GCS Service.
   VOID_GCS_RPC_CLIENT_METHOD(ActorInfoGcsService, CreateActor, actor_info_grpc_client_, )
 
+  /// Create a batch of actors via GCS Service.
+  VOID_GCS_RPC_CLIENT_METHOD(ActorInfoGcsService, CreateActors, actor_info_grpc_client_, )
+
   /// Get actor data from GCS Service.
   VOID_GCS_RPC_CLIENT_METHOD(ActorInfoGcsService, GetActorInfo, actor_info_grpc_client_, )
 
@@ -144,6 +144,10 @@ class ActorInfoGcsServiceHandler {
                                  CreateActorReply *reply,
                                  SendReplyCallback send_reply_callback) = 0;
 
+  virtual void HandleCreateActors(const CreateActorsRequest &request,
+                                  CreateActorsReply *reply,
+                                  SendReplyCallback send_reply_callback) = 0;
+
   virtual void HandleGetActorInfo(const GetActorInfoRequest &request,
                                   GetActorInfoReply *reply,
                                   SendReplyCallback send_reply_callback) = 0;
@@ -185,6 +189,7 @@ class ActorInfoGrpcService : public GrpcService {
     /// distributed deadlock.
     ACTOR_INFO_SERVICE_RPC_HANDLER(RegisterActor, -1);
     ACTOR_INFO_SERVICE_RPC_HANDLER(CreateActor, -1);
+    ACTOR_INFO_SERVICE_RPC_HANDLER(CreateActors, -1);
 
     /// Others need back pressure.
     ACTOR_INFO_SERVICE_RPC_HANDLER(
@@ -121,6 +121,9 @@ class NodeManagerWorkerClient
   /// Get gcs server address.
   VOID_RPC_CLIENT_METHOD(NodeManagerService, GetGcsServerAddress, grpc_client_, )
 
+  /// Get the task events of the workers of the raylet.
+  VOID_RPC_CLIENT_METHOD(NodeManagerService, GetTaskEventsTrace, grpc_client_, )
+
  private:
   /// Constructor.
   ///
@@ -43,6 +43,7 @@ namespace rpc {
   RPC_SERVICE_HANDLER(NodeManagerService, ReleaseUnusedBundles, -1)   \
   RPC_SERVICE_HANDLER(NodeManagerService, GetSystemConfig, -1)        \
   RPC_SERVICE_HANDLER(NodeManagerService, GetGcsServerAddress, -1)    \
+  RPC_SERVICE_HANDLER(NodeManagerService, GetTaskEventsTrace, -1)     \
   RPC_SERVICE_HANDLER(NodeManagerService, ShutdownRaylet, -1)
 
 /// Interface of the `NodeManagerService`, see `src/ray/protobuf/node_manager.proto`.
@@ -137,6 +138,10 @@ class NodeManagerServiceHandler {
   virtual void HandleGetGcsServerAddress(const GetGcsServerAddressRequest &request,
                                          GetGcsServerAddressReply *reply,
                                          SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleGetTaskEventsTrace(const GetTaskEventsTraceRequest &request,
+                                        GetTaskEventsTraceReply *reply,
+                                        SendReplyCallback send_reply_callback) = 0;
 };
 
 /// The `GrpcService` for `NodeManagerService`.
@@ -54,6 +54,38 @@ enum class ServerCallState {
 
 class ServerCallFactory;
 
+namespace internal {
+/// The arena of the request that the current thread is handling.
+inline thread_local std::shared_ptr<google::protobuf::Arena> current_request_arena;
+}  // namespace internal
+
+/// Get the arena of the request that the current thread is handling. A handler can
+/// share ownership of the arena to keep parts of the request alive after the reply is
+/// sent, e.g., with an aliasing `std::shared_ptr`, instead of copying them out of the
+/// arena. This must be called from the handler itself, not from a callback it posts.
+///
+/// \return The arena, or nullptr if the thread isn't handling a request.
+inline std::shared_ptr<google::protobuf::Arena> GetCurrentRequestArena() {
+  return internal::current_request_arena;
+}
+
+/// Take shared ownership of a message of the request that the current thread is
+/// handling without copying it. If the message is in the arena of the request, the
+/// returned pointer keeps the arena alive, otherwise the message is moved out of the
+/// request.
+///
+/// \param message The message, e.g., the request itself or one of its fields.
+/// \return A pointer to the message that can outlive the request.
+template <class Message>
+std::shared_ptr<Message> TakeRequestMessage(const Message &message) {
+  auto arena = GetCurrentRequestArena();
+  auto *mutable_message = const_cast<Message *>(&message);
+  if (arena != nullptr && message.GetArena() == arena.get()) {
+    return std::shared_ptr<Message>(std::move(arena), mutable_message);
+  }
+  return std::make_shared<Message>(std::move(*mutable_message));
+}
+
 /// Represents an incoming request of a gRPC server.
 ///
 /// The lifecycle and state transition of a `ServerCall` is as follows:
@@ -147,7 +179,9 @@ class ServerCallImpl : public ServerCall {
         io_service_(io_service),
         call_name_(std::move(call_name)),
         start_time_(0) {
-    reply_ = google::protobuf::Arena::CreateMessage<Reply>(&arena_);
+    arena_ = std::make_shared<google::protobuf::Arena>();
+    request_ = google::protobuf::Arena::CreateMessage<Request>(arena_.get());
+    reply_ = google::protobuf::Arena::CreateMessage<Reply>(arena_.get());
     // TODO call_name_ sometimes get corrunpted due to memory issues.
     RAY_CHECK(!call_name_.empty()) << "Call name is empty";
     STATS_grpc_server_req_new.Record(1.0, call_name_);
@@ -184,8 +218,10 @@ class ServerCallImpl : public ServerCall {
       // a new request comes in.
       factory.CreateCall();
     }
+    // The handler may share the arena, and may delete this call before it returns.
+    internal::current_request_arena = arena_;
     (service_handler_.*handle_request_function_)(
-        request_, reply_,
+        *request_, reply_,
         [this](Status status, std::function<void()> success,
                std::function<void()> failure) {
           // These two callbacks must be set before `SendReply`, because `SendReply`
@@ -198,6 +234,7 @@ class ServerCallImpl : public ServerCall {
           // this server call might be deleted
           SendReply(status);
         });
+    internal::current_request_arena = nullptr;
   }
 
   void OnReplySent() override {
@@ -233,9 +270,11 @@ class ServerCallImpl : public ServerCall {
     response_writer_.Finish(*reply_, RayStatusToGrpcStatus(status), this);
   }
 
-  /// The memory pool for this request. It's used for reply.
-  /// With arena, we'll be able to setup the reply without copying some field.
-  google::protobuf::Arena arena_;
+  /// The memory pool for this request. It's used for the request and the reply, so
+  /// that parsing the request and building the reply don't allocate field by field.
+  /// With arena, we'll be able to setup the reply without copying some field. The
+  /// handler may share it to keep parts of the request alive beyond this call.
+  std::shared_ptr<google::protobuf::Arena> arena_;
 
   /// State of this call.
   ServerCallState state_;
@@ -259,8 +298,8 @@ class ServerCallImpl : public ServerCall {
   /// The event loop.
   instrumented_io_context &io_service_;
 
-  /// The request message.
-  Request request_;
+  /// The request message. This one is owned by arena.
+  Request *request_;
 
   /// The reply message. This one is owned by arena. It's not valid beyond
   /// the life-cycle of this call.
@@ -337,7 +376,7 @@ class ServerCallFactoryImpl : public ServerCallFactory {
         *this, service_handler_, handle_request_function_, io_service_, call_name_);
     /// Request gRPC runtime to starting accepting this kind of request, using the call as
     /// the tag.
-    (service_.*request_call_function_)(&call->context_, &call->request_,
+    (service_.*request_call_function_)(&call->context_, call->request_,
                                        &call->response_writer_, cq_.get(), cq_.get(),
                                        call);
   }
@@ -0,0 +1,136 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "ray/common/id.h"
+#include "ray/rpc/server_call.h"
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+#include "src/ray/protobuf/core_worker.pb.h"
+
+namespace {
+/// The number of heap allocations of the benchmark process.
+std::atomic<int64_t> num_allocations(0);
+}  // namespace
+
+void *operator new(size_t size) {
+  num_allocations++;
+  void *ptr = std::malloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace ray {
+namespace rpc {
+
+namespace {
+
+PushTaskRequest MakePushTaskRequest(int num_args) {
+  PushTaskRequest request;
+  auto task_spec = request.mutable_task_spec();
+  task_spec->set_task_id(std::string(TaskID::Size(), 't'));
+  task_spec->set_name("f()");
+  auto function = task_spec->mutable_function_descriptor()
+                      ->mutable_python_function_descriptor();
+  function->set_module_name("module");
+  function->set_function_name("f");
+  task_spec->mutable_caller_address()->set_ip_address("127.0.0.1");
+  (*task_spec->mutable_required_resources())["CPU"] = 1;
+  for (int i = 0; i < num_args; i++) {
+    auto arg = task_spec->add_args();
+    arg->set_data(std::string(100, 'd'));
+    arg->mutable_object_ref()->set_object_id(std::string(ObjectID::Size(), 'o'));
+  }
+  request.set_intended_worker_id(std::string(WorkerID::Size(), 'w'));
+  return request;
+}
+
+PushTaskReply MakePushTaskReply(int num_returns) {
+  PushTaskReply reply;
+  for (int i = 0; i < num_returns; i++) {
+    auto return_object = reply.add_return_objects();
+    return_object->set_object_id(std::string(ObjectID::Size(), 'r'));
+    return_object->set_data(std::string(100, 'd'));
+    return_object->set_metadata("m");
+  }
+  return reply;
+}
+
+/// Handle a request the way the server does: parse it, set the current request arena
+/// while the handler runs, and take the parts of the request the handler keeps.
+template <class Request, class Handler>
+void HandleRequest(const std::string &serialized, bool use_arena, Handler handler) {
+  if (use_arena) {
+    auto arena = std::make_shared<google::protobuf::Arena>();
+    auto request = google::protobuf::Arena::CreateMessage<Request>(arena.get());
+    request->ParseFromString(serialized);
+    internal::current_request_arena = std::move(arena);
+    handler(*request);
+    internal::current_request_arena = nullptr;
+  } else {
+    Request request;
+    request.ParseFromString(serialized);
+    handler(request);
+  }
+}
+
+/// Receive a task like the receiver does, and its reply like the submitter does.
+void ReceiveTask(const std::string &request, const std::string &reply, bool use_arena) {
+  // The receiver keeps the task spec until the task finishes.
+  std::shared_ptr<TaskSpec> task_spec;
+  HandleRequest<PushTaskRequest>(request, use_arena,
+                                 [&task_spec](const PushTaskRequest &request) {
+                                   task_spec = TakeRequestMessage(request.task_spec());
+                                 });
+  // The submitter reads the reply in the callback.
+  HandleRequest<PushTaskReply>(reply, use_arena, [](const PushTaskReply &reply) {
+    RAY_CHECK(reply.return_objects_size() == 3);
+  });
+}
+
+}  // namespace
+}  // namespace rpc
+}  // namespace ray
+
+/// Measure the heap allocations and the latency of receiving a task and its reply,
+/// with the messages on the heap and in an arena.
+int main(int argc, char **argv) {
+  const int num_tasks = 10000;
+  const auto request = ray::rpc::MakePushTaskRequest(3).SerializeAsString();
+  const auto reply = ray::rpc::MakePushTaskReply(3).SerializeAsString();
+  for (bool use_arena : {false, true}) {
+    const int64_t start_allocations = num_allocations;
+    const int64_t start_us = current_sys_time_us();
+    for (int i = 0; i < num_tasks; i++) {
+      ray::rpc::ReceiveTask(request, reply, use_arena);
+    }
+    const int64_t elapsed_us = current_sys_time_us() - start_us;
+    const int64_t allocations = num_allocations - start_allocations;
+    std::cout << (use_arena ? "Arena" : "Heap") << " messages: "
+              << static_cast<double>(allocations) / num_tasks << " allocations and "
+              << static_cast<double>(elapsed_us) / num_tasks << "us per task."
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "gtest/gtest.h"
+#include "ray/common/id.h"
+#include "ray/rpc/server_call.h"
+#include "ray/util/logging.h"
+#include "src/ray/protobuf/core_worker.pb.h"
+
+namespace {
+/// The number of heap allocations of the test process.
+std::atomic<int64_t> num_allocations(0);
+}  // namespace
+
+void *operator new(size_t size) {
+  num_allocations++;
+  void *ptr = std::malloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace ray {
+namespace rpc {
+
+namespace {
+
+PushTaskRequest MakePushTaskRequest(int num_args) {
+  PushTaskRequest request;
+  auto task_spec = request.mutable_task_spec();
+  task_spec->set_task_id(std::string(TaskID::Size(), 't'));
+  task_spec->set_name("f()");
+  auto function = task_spec->mutable_function_descriptor()
+                      ->mutable_python_function_descriptor();
+  function->set_module_name("module");
+  function->set_function_name("f");
+  task_spec->mutable_caller_address()->set_ip_address("127.0.0.1");
+  (*task_spec->mutable_required_resources())["CPU"] = 1;
+  for (int i = 0; i < num_args; i++) {
+    auto arg = task_spec->add_args();
+    arg->set_data(std::string(100, 'd'));
+    arg->mutable_object_ref()->set_object_id(std::string(ObjectID::Size(), 'o'));
+  }
+  request.set_intended_worker_id(std::string(WorkerID::Size(), 'w'));
+  return request;
+}
+
+PushTaskReply MakePushTaskReply(int num_returns) {
+  PushTaskReply reply;
+  for (int i = 0; i < num_returns; i++) {
+    auto return_object = reply.add_return_objects();
+    return_object->set_object_id(std::string(ObjectID::Size(), 'r'));
+    return_object->set_data(std::string(100, 'd'));
+    return_object->set_metadata("m");
+  }
+  return reply;
+}
+
+/// Handle a request the way the server does: parse it, set the current request arena
+/// while the handler runs, and take the parts of the request the handler keeps.
+template <class Request, class Handler>
+void HandleRequest(const std::string &serialized, bool use_arena, Handler handler) {
+  if (use_arena) {
+    auto arena = std::make_shared<google::protobuf::Arena>();
+    auto request = google::protobuf::Arena::CreateMessage<Request>(arena.get());
+    request->ParseFromString(serialized);
+    internal::current_request_arena = std::move(arena);
+    handler(*request);
+    internal::current_request_arena = nullptr;
+  } else {
+    Request request;
+    request.ParseFromString(serialized);
+    handler(request);
+  }
+}
+
+/// Receive a task like the receiver does, and its reply like the submitter does.
+void ReceiveTask(const std::string &request, const std::string &reply, bool use_arena) {
+  // The receiver keeps the task spec until the task finishes.
+  std::shared_ptr<TaskSpec> task_spec;
+  HandleRequest<PushTaskRequest>(request, use_arena,
+                                 [&task_spec](const PushTaskRequest &request) {
+                                   task_spec = TakeRequestMessage(request.task_spec());
+                                 });
+  // The submitter reads the reply in the callback.
+  HandleRequest<PushTaskReply>(reply, use_arena, [](const PushTaskReply &reply) {
+    RAY_CHECK(reply.return_objects_size() == 3);
+  });
+}
+
+}  // namespace
+
+TEST(RequestArenaTest, TestTakeMessageInArena) {
+  const auto serialized = MakePushTaskRequest(1).SerializeAsString();
+  std::shared_ptr<TaskSpec> task_spec;
+  const TaskSpec *in_arena = nullptr;
+  HandleRequest<PushTaskRequest>(serialized, /*use_arena=*/true,
+                                 [&](const PushTaskRequest &request) {
+                                   in_arena = &request.task_spec();
+                                   task_spec = TakeRequestMessage(request.task_spec());
+                                 });
+  // The message wasn't copied, and the arena outlives the handler.
+  ASSERT_EQ(task_spec.get(), in_arena);
+  ASSERT_NE(task_spec->GetArena(), nullptr);
+  ASSERT_EQ(task_spec->name(), "f()");
+  ASSERT_EQ(task_spec->args_size(), 1);
+  ASSERT_EQ(GetCurrentRequestArena(), nullptr);
+}
+
+TEST(RequestArenaTest, TestTakeMessageOutsideArena) {
+  auto request = MakePushTaskRequest(1);
+  auto task_spec = TakeRequestMessage(request.task_spec());
+  ASSERT_EQ(task_spec->GetArena(), nullptr);
+  ASSERT_EQ(task_spec->name(), "f()");
+  ASSERT_EQ(task_spec->args_size(), 1);
+}
+
+/// Receiving a task and its reply allocates less on the heap with the messages in an
+/// arena.
+TEST(RequestArenaTest, TestAllocationsPerTask) {
+  const int num_tasks = 100;
+  const auto request = MakePushTaskRequest(3).SerializeAsString();
+  const auto reply = MakePushTaskReply(3).SerializeAsString();
+  int64_t allocations[2];
+  for (bool use_arena : {false, true}) {
+    const int64_t start_allocations = num_allocations;
+    for (int i = 0; i < num_tasks; i++) {
+      ReceiveTask(request, reply, use_arena);
+    }
+    allocations[use_arena] = num_allocations - start_allocations;
+  }
+  ASSERT_LT(allocations[true], allocations[false]);
+}
+
+}  // namespace rpc
+}  // namespace ray
@@ -22,6 +22,7 @@
 
 #include <grpcpp/grpcpp.h>
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -29,6 +30,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/hash/hash.h"
+#include "ray/common/ray_config.h"
 #include "ray/common/status.h"
 #include "ray/pubsub/subscriber.h"
 #include "ray/rpc/grpc_client.h"
@@ -133,6 +135,27 @@ class CoreWorkerClientInterface : public pubsub::SubscriberClientInterface {
   virtual void GetObjectStatus(const GetObjectStatusRequest &request,
                                const ClientCallback<GetObjectStatusReply> &callback) {}
 
+  /// Ask the owner of several objects about the objects' current status.
+  virtual void GetObjectStatusBatch(
+      const GetObjectStatusBatchRequest &request,
+      const ClientCallback<GetObjectStatusBatchReply> &callback) {}
+
+  /// Ask the worker executing a task to push the task's small return values to a
+  /// borrower.
+  virtual void AddReturnObjectBorrower(
+      const AddReturnObjectBorrowerRequest &request,
+      const ClientCallback<AddReturnObjectBorrowerReply> &callback) {}
+
+  /// Push the small return values of a task to a borrower.
+  virtual void PushReturnObjects(const PushReturnObjectsRequest &request,
+                                 const ClientCallback<PushReturnObjectsReply> &callback) {
+  }
+
+  /// Report a value of a streaming generator task to the caller of the task.
+  virtual void ReportGeneratorItemReturns(
+      const ReportGeneratorItemReturnsRequest &request,
+      const ClientCallback<ReportGeneratorItemReturnsReply> &callback) {}
+
   /// Ask the actor's owner to reply when the actor has gone out of scope.
   virtual void WaitForActorOutOfScope(
       const WaitForActorOutOfScopeRequest &request,
@@ -214,7 +237,10 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   /// \param[in] port Port of the worker server.
   /// \param[in] client_call_manager The `ClientCallManager` used for managing requests.
   CoreWorkerClient(const rpc::Address &address, ClientCallManager &client_call_manager)
-      : addr_(address) {
+      : addr_(address),
+        push_batch_size_(::RayConfig::instance().actor_task_push_batch_size()),
+        max_push_rpcs_in_flight_(
+            ::RayConfig::instance().actor_task_max_push_rpcs_in_flight()) {
     grpc_client_ = std::make_unique<GrpcClient<CoreWorkerService>>(
         addr_.ip_address(), addr_.port(), client_call_manager);
   };
@@ -226,6 +252,16 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetObjectStatus, grpc_client_, override)
 
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetObjectStatusBatch, grpc_client_, override)
+
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, AddReturnObjectBorrower, grpc_client_,
+                         override)
+
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, PushReturnObjects, grpc_client_, override)
+
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, ReportGeneratorItemReturns, grpc_client_,
+                         override)
+
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, KillActor, grpc_client_, override)
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, CancelTask, grpc_client_, override)
@@ -300,37 +336,45 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   /// The client will guarantee no more than kMaxBytesInFlight bytes of RPCs are being
   /// sent at once. This prevents the server scheduling queue from being overwhelmed.
   /// See direct_actor.proto for a description of the ordering protocol.
+  ///
+  /// A worker only accepts batches of tasks if it executes tasks one at a time, see
+  /// BatchSupport. Once it accepted a batch, the client also keeps no more than
+  /// `max_push_rpcs_in_flight_` RPCs in flight, and pushes the tasks that queue up
+  /// meanwhile in batches of up to `push_batch_size_` tasks. This limit is never
+  /// applied to workers that execute tasks concurrently, whose tasks may block until
+  /// later tasks are pushed.
   void SendRequests() {
     absl::MutexLock lock(&mutex_);
     auto this_ptr = this->shared_from_this();
+    const bool batching =
+        push_batch_size_ > 1 && batch_support_ != BatchSupport::REJECTED;
+    const size_t batch_size = batching ? push_batch_size_ : 1;
+    // Until the worker accepted a batch, one batch is pushed at a time to find out.
+    const int64_t max_rpcs_in_flight =
+        batch_support_ == BatchSupport::ACCEPTED ? max_push_rpcs_in_flight_ : 1;
 
     while (!send_queue_.empty() && rpc_bytes_in_flight_ < kMaxBytesInFlight) {
-      auto pair = std::move(*send_queue_.begin());
-      send_queue_.pop_front();
-
-      auto request = std::move(pair.first);
-      int64_t task_size = RequestSizeInBytes(*request);
-      int64_t seq_no = request->sequence_number();
-      request->set_client_processed_up_to(max_finished_seq_no_);
-      rpc_bytes_in_flight_ += task_size;
-
-      auto rpc_callback = [this, this_ptr, seq_no, task_size,
-                           callback = std::move(pair.second)](
-                              Status status, const rpc::PushTaskReply &reply) {
-        {
-          absl::MutexLock lock(&mutex_);
-          if (seq_no > max_finished_seq_no_) {
-            max_finished_seq_no_ = seq_no;
-          }
-          rpc_bytes_in_flight_ -= task_size;
-          RAY_CHECK(rpc_bytes_in_flight_ >= 0);
-        }
-        SendRequests();
-        callback(status, reply);
-      };
-
-      RAY_UNUSED(INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request,
-                                 std::move(rpc_callback), grpc_client_));
+      if (batching && push_rpcs_in_flight_ >= max_rpcs_in_flight) {
+        break;
+      }
+      std::vector<PendingTask> batch;
+      int64_t batch_bytes = 0;
+      while (!send_queue_.empty() && batch.size() < batch_size &&
+             rpc_bytes_in_flight_ + batch_bytes < kMaxBytesInFlight) {
+        auto pair = std::move(*send_queue_.begin());
+        send_queue_.pop_front();
+        pair.first->set_client_processed_up_to(max_finished_seq_no_);
+        batch_bytes += RequestSizeInBytes(*pair.first);
+        batch.push_back(std::move(pair));
+      }
+      rpc_bytes_in_flight_ += batch_bytes;
+      push_rpcs_in_flight_++;
+
+      if (batch.size() > 1 || (batching && batch_support_ == BatchSupport::UNKNOWN)) {
+        SendPushTasks(this_ptr, std::move(batch), batch_bytes);
+      } else {
+        SendPushTask(this_ptr, std::move(batch.front()), batch_bytes);
+      }
     }
 
     if (!send_queue_.empty()) {
@@ -345,6 +389,165 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   }
 
  private:
+  using PendingTask =
+      std::pair<std::unique_ptr<PushTaskRequest>, ClientCallback<PushTaskReply>>;
+
+  /// Push a task in its own RPC.
+  ///
+  /// \param this_ptr A reference to this client to keep it alive until the reply.
+  /// \param task The request of the task and its callback.
+  /// \param task_size The estimated size in bytes of the request.
+  void SendPushTask(const std::shared_ptr<CoreWorkerClient> &this_ptr, PendingTask task,
+                    int64_t task_size) EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    auto request = std::move(task.first);
+    int64_t seq_no = request->sequence_number();
+    auto rpc_callback = [this, this_ptr, seq_no, task_size,
+                         callback = std::move(task.second)](
+                            Status status, const rpc::PushTaskReply &reply) {
+      OnPushFinished(seq_no, task_size);
+      SendRequests();
+      callback(status, reply);
+    };
+
+    RAY_UNUSED(INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request,
+                               std::move(rpc_callback), grpc_client_));
+  }
+
+  /// A batch of tasks that was pushed in one RPC, whose results are polled until all
+  /// of them have been received.
+  struct PushTasksBatch {
+    /// The ID of the batch.
+    std::string batch_id;
+    /// The request that pushed the batch, until the worker accepted the batch.
+    std::shared_ptr<PushTasksRequest> request;
+    /// The callbacks of the tasks, in the order of the batch.
+    std::vector<ClientCallback<PushTaskReply>> callbacks;
+    /// The number of results received so far.
+    int num_results_received = 0;
+    /// The max sequence number of the tasks.
+    int64_t seq_no;
+    /// The estimated size in bytes of the requests.
+    int64_t size;
+  };
+
+  /// Push a batch of tasks in one RPC. The worker replies as soon as the first tasks
+  /// finished, and the client polls for the results of the remaining tasks. If the
+  /// worker rejects the batch, the tasks are pushed again one by one.
+  ///
+  /// \param this_ptr A reference to this client to keep it alive until the reply.
+  /// \param tasks The requests of the tasks and their callbacks, in the order of their
+  /// sequence numbers.
+  /// \param batch_size The estimated size in bytes of the requests.
+  void SendPushTasks(const std::shared_ptr<CoreWorkerClient> &this_ptr,
+                     std::vector<PendingTask> tasks, int64_t batch_size)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    auto batch = std::make_shared<PushTasksBatch>();
+    batch->batch_id = UniqueID::FromRandom().Binary();
+    batch->request = std::make_shared<PushTasksRequest>();
+    batch->request->set_batch_id(batch->batch_id);
+    batch->callbacks.reserve(tasks.size());
+    for (auto &task : tasks) {
+      batch->request->add_requests()->Swap(task.first.get());
+      batch->callbacks.push_back(std::move(task.second));
+    }
+    batch->seq_no =
+        batch->request->requests(batch->request->requests_size() - 1).sequence_number();
+    batch->size = batch_size;
+
+    auto rpc_callback = [this, this_ptr, batch](Status status,
+                                                const rpc::PushTasksReply &reply) {
+      OnPushTasksReply(this_ptr, batch, status, reply);
+    };
+    RAY_UNUSED(INVOKE_RPC_CALL(CoreWorkerService, PushTasks, *batch->request,
+                               std::move(rpc_callback), grpc_client_));
+  }
+
+  /// Handle a reply that pushed a batch of tasks or polled for their results, and poll
+  /// for the remaining results.
+  ///
+  /// \param this_ptr A reference to this client to keep it alive until the reply.
+  /// \param batch The batch of tasks.
+  /// \param status The status of the RPC.
+  /// \param reply The reply of the RPC.
+  void OnPushTasksReply(const std::shared_ptr<CoreWorkerClient> &this_ptr,
+                        const std::shared_ptr<PushTasksBatch> &batch,
+                        const Status &status, const rpc::PushTasksReply &reply)
+      LOCKS_EXCLUDED(mutex_) {
+    if (status.ok() && reply.batch_rejected()) {
+      {
+        absl::MutexLock lock(&mutex_);
+        RAY_LOG(DEBUG) << "Worker " << WorkerID::FromBinary(addr_.worker_id())
+                       << " rejected a batch of " << batch->callbacks.size()
+                       << " tasks, pushing them one by one.";
+        batch_support_ = BatchSupport::REJECTED;
+        rpc_bytes_in_flight_ -= batch->size;
+        push_rpcs_in_flight_--;
+        for (int i = batch->request->requests_size() - 1; i >= 0; i--) {
+          auto task_request = std::make_unique<PushTaskRequest>();
+          task_request->Swap(batch->request->mutable_requests(i));
+          send_queue_.emplace_front(std::move(task_request), batch->callbacks[i]);
+        }
+      }
+      SendRequests();
+      return;
+    }
+    if (status.ok() && batch->request) {
+      // The worker accepted the batch, so the tasks that queued up behind it can be
+      // pushed, up to `max_push_rpcs_in_flight_` RPCs at a time.
+      {
+        absl::MutexLock lock(&mutex_);
+        batch_support_ = BatchSupport::ACCEPTED;
+      }
+      SendRequests();
+    }
+    batch->request.reset();
+
+    const int num_tasks = batch->callbacks.size();
+    if (!status.ok()) {
+      OnPushFinished(batch->seq_no, batch->size);
+      SendRequests();
+      for (int i = batch->num_results_received; i < num_tasks; i++) {
+        batch->callbacks[i](status, rpc::PushTaskReply());
+      }
+      return;
+    }
+    RAY_CHECK(batch->num_results_received + reply.results_size() <= num_tasks);
+    for (const auto &result : reply.results()) {
+      auto code = static_cast<StatusCode>(result.status_code());
+      batch->callbacks[batch->num_results_received++](
+          code == StatusCode::OK ? Status::OK() : Status(code, result.status_message()),
+          result.reply());
+    }
+    if (batch->num_results_received < num_tasks) {
+      PushTasksRequest request;
+      request.set_batch_id(batch->batch_id);
+      request.set_num_results_received(batch->num_results_received);
+      auto rpc_callback = [this, this_ptr, batch](Status status,
+                                                  const rpc::PushTasksReply &reply) {
+        OnPushTasksReply(this_ptr, batch, status, reply);
+      };
+      RAY_UNUSED(INVOKE_RPC_CALL(CoreWorkerService, PushTasks, request,
+                                 std::move(rpc_callback), grpc_client_));
+      return;
+    }
+    OnPushFinished(batch->seq_no, batch->size);
+    SendRequests();
+  }
+
+  /// Account for the reply of a push RPC.
+  ///
+  /// \param seq_no The max sequence number of the pushed tasks.
+  /// \param size The estimated size in bytes of the pushed tasks.
+  void OnPushFinished(int64_t seq_no, int64_t size) LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    if (seq_no > max_finished_seq_no_) {
+      max_finished_seq_no_ = seq_no;
+    }
+    rpc_bytes_in_flight_ -= size;
+    RAY_CHECK(rpc_bytes_in_flight_ >= 0);
+    push_rpcs_in_flight_--;
+  }
+
   /// Protects against unsafe concurrent access from the callback thread.
   absl::Mutex mutex_;
 
@@ -355,14 +558,37 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   std::unique_ptr<GrpcClient<CoreWorkerService>> grpc_client_;
 
   /// Queue of requests to send.
-  std::deque<std::pair<std::unique_ptr<PushTaskRequest>, ClientCallback<PushTaskReply>>>
-      send_queue_ GUARDED_BY(mutex_);
+  std::deque<PendingTask> send_queue_ GUARDED_BY(mutex_);
 
   /// The number of bytes currently in flight.
   int64_t rpc_bytes_in_flight_ GUARDED_BY(mutex_) = 0;
 
   /// The max sequence number we have processed responses for.
   int64_t max_finished_seq_no_ GUARDED_BY(mutex_) = -1;
+
+  /// The number of RPCs pushing tasks from `send_queue_` that are in flight.
+  int64_t push_rpcs_in_flight_ GUARDED_BY(mutex_) = 0;
+
+  /// Whether the worker accepts batches of tasks. Until the first batch is accepted or
+  /// rejected, every push is a batch, even of one task, and only one is in flight.
+  enum class BatchSupport {
+    /// No batch was accepted or rejected yet.
+    UNKNOWN,
+    /// The worker executes tasks one at a time, so the tasks that queue up behind the
+    /// pushes in flight can wait for them.
+    ACCEPTED,
+    /// The worker executes tasks concurrently, e.g. it's an asyncio or threaded actor.
+    /// Tasks are pushed one by one as soon as they are queued, since a task in flight
+    /// may wait for a later one.
+    REJECTED,
+  };
+  BatchSupport batch_support_ GUARDED_BY(mutex_) = BatchSupport::UNKNOWN;
+
+  /// The maximum number of tasks to push in one RPC.
+  const int64_t push_batch_size_;
+
+  /// The maximum number of push RPCs in flight when pushing tasks in batches.
+  const int64_t max_push_rpcs_in_flight_;
 };
 
 typedef std::function<std::shared_ptr<CoreWorkerClientInterface>(const rpc::Address &)>
@@ -29,9 +29,14 @@ namespace rpc {
 /// NOTE: See src/ray/core_worker/core_worker.h on how to add a new grpc handler.
 #define RAY_CORE_WORKER_RPC_HANDLERS                                         \
   RPC_SERVICE_HANDLER(CoreWorkerService, PushTask, -1)                       \
+  RPC_SERVICE_HANDLER(CoreWorkerService, PushTasks, -1)                      \
   RPC_SERVICE_HANDLER(CoreWorkerService, StealTasks, -1)                     \
   RPC_SERVICE_HANDLER(CoreWorkerService, DirectActorCallArgWaitComplete, -1) \
   RPC_SERVICE_HANDLER(CoreWorkerService, GetObjectStatus, -1)                \
+  RPC_SERVICE_HANDLER(CoreWorkerService, GetObjectStatusBatch, -1)           \
+  RPC_SERVICE_HANDLER(CoreWorkerService, AddReturnObjectBorrower, -1)        \
+  RPC_SERVICE_HANDLER(CoreWorkerService, PushReturnObjects, -1)              \
+  RPC_SERVICE_HANDLER(CoreWorkerService, ReportGeneratorItemReturns, -1)     \
   RPC_SERVICE_HANDLER(CoreWorkerService, WaitForActorOutOfScope, -1)         \
   RPC_SERVICE_HANDLER(CoreWorkerService, PubsubLongPolling, -1)              \
   RPC_SERVICE_HANDLER(CoreWorkerService, PubsubCommandBatch, -1)             \
@@ -52,9 +57,14 @@ namespace rpc {
 
 #define RAY_CORE_WORKER_DECLARE_RPC_HANDLERS                              \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(PushTask)                       \
+  DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(PushTasks)                      \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(StealTasks)                     \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(DirectActorCallArgWaitComplete) \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(GetObjectStatus)                \
+  DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(GetObjectStatusBatch)           \
+  DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(AddReturnObjectBorrower)        \
+  DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(PushReturnObjects)              \
+  DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(ReportGeneratorItemReturns)     \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(WaitForActorOutOfScope)         \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(PubsubLongPolling)              \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(PubsubCommandBatch)             \
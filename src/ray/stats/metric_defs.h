@@ -117,6 +117,17 @@ static Sum NumWorkersStarted(
     "internal_num_processes_started",
     "The total number of worker processes the worker pool has created.", "processes");
 
+static Sum NumPredictivePrestartedWorkers(
+    "internal_num_predictive_prestarted_workers",
+    "The total number of workers prestarted ahead of predicted bursts of tasks.",
+    "workers");
+
+static Sum NumPredictivePrestartHits(
+    "internal_num_predictive_prestart_hits",
+    "The total number of workers prestarted ahead of predicted bursts of tasks that "
+    "were used by a task before they expired.",
+    "workers");
+
 static Sum NumReceivedTasks(
     "internal_num_received_tasks",
     "The cumulative number of lease requeusts that this raylet has received.", "tasks");
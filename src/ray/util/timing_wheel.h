@@ -0,0 +1,159 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+/// \class TimingWheel
+/// A hierarchical timing wheel of deadlines, in ticks, of a set of keys. Scheduling,
+/// rescheduling and cancelling the deadline of a key are O(1), and advancing the wheel
+/// costs O(1) per tick plus the keys that expire, so the cost doesn't depend on the
+/// number of keys that are waiting.
+///
+/// The wheel has `kNumLevels` levels of `kNumSlots` slots. A slot of level `l` spans
+/// `kNumSlots^l` ticks, and a deadline is kept at the lowest level whose slots it
+/// shares the higher bits of with the current tick. When the current tick enters a new
+/// slot of a higher level, the keys in that slot are cascaded down to the lower levels.
+///
+/// This class is not thread safe.
+template <class KEY>
+class TimingWheel {
+ public:
+  /// Create a timing wheel.
+  ///
+  /// \param current_tick The tick that the wheel starts at.
+  explicit TimingWheel(uint64_t current_tick = 0) : current_tick_(current_tick) {}
+
+  /// Schedule the deadline of a key, replacing its previous deadline if it has one.
+  ///
+  /// \param key The key to schedule.
+  /// \param deadline_tick The tick at which the key expires. A deadline that has
+  /// passed expires on the next tick.
+  void Schedule(const KEY &key, uint64_t deadline_tick) {
+    Cancel(key);
+    Insert(key, std::max(deadline_tick, current_tick_ + 1));
+  }
+
+  /// Cancel the deadline of a key.
+  ///
+  /// \return Whether the key had a deadline.
+  bool Cancel(const KEY &key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+    slots_[it->second.level][it->second.slot].erase(it->second.position);
+    entries_.erase(it);
+    return true;
+  }
+
+  /// Whether a key has a deadline.
+  bool Contains(const KEY &key) const { return entries_.contains(key); }
+
+  /// The number of keys that have a deadline.
+  size_t Size() const { return entries_.size(); }
+
+  /// The tick that the wheel has advanced to.
+  uint64_t CurrentTick() const { return current_tick_; }
+
+  /// Advance the wheel to a tick, and expire the keys whose deadline is at or before it.
+  /// The expired keys are no longer scheduled when `on_expired` is called, so it may
+  /// schedule them again.
+  ///
+  /// \param tick The tick to advance to.
+  /// \param on_expired Called with each expired key, in the order of their deadlines.
+  void Advance(uint64_t tick, const std::function<void(const KEY &)> &on_expired) {
+    std::vector<KEY> expired;
+    while (current_tick_ < tick) {
+      current_tick_++;
+      Cascade();
+      auto &slot = slots_[0][current_tick_ & kSlotMask];
+      for (const auto &key : slot) {
+        entries_.erase(key);
+        expired.push_back(key);
+      }
+      slot.clear();
+    }
+    for (const auto &key : expired) {
+      on_expired(key);
+    }
+  }
+
+ private:
+  static constexpr int kSlotBits = 6;
+  static constexpr uint64_t kNumSlots = 1 << kSlotBits;
+  static constexpr uint64_t kSlotMask = kNumSlots - 1;
+  /// Enough levels for every 64 bit deadline.
+  static constexpr int kNumLevels = (64 + kSlotBits - 1) / kSlotBits;
+
+  struct Entry {
+    int level;
+    uint64_t slot;
+    uint64_t deadline_tick;
+    typename std::list<KEY>::iterator position;
+  };
+
+  /// Insert a key with a deadline after the current tick.
+  void Insert(const KEY &key, uint64_t deadline_tick) {
+    int level = 0;
+    while (level < kNumLevels - 1 &&
+           (deadline_tick >> ((level + 1) * kSlotBits)) !=
+               (current_tick_ >> ((level + 1) * kSlotBits))) {
+      level++;
+    }
+    uint64_t slot = (deadline_tick >> (level * kSlotBits)) & kSlotMask;
+    auto &keys = slots_[level][slot];
+    keys.push_back(key);
+    entries_[key] = {level, slot, deadline_tick, std::prev(keys.end())};
+  }
+
+  /// Cascade the keys of the slots that the current tick entered down to lower levels.
+  /// Higher levels are cascaded first, since their keys may move to the slots of lower
+  /// levels that are cascaded next.
+  void Cascade() {
+    int top = 0;
+    while (top < kNumLevels - 1 &&
+           ((current_tick_ >> ((top + 1) * kSlotBits)) << ((top + 1) * kSlotBits)) ==
+               current_tick_) {
+      top++;
+    }
+    for (int level = top; level > 0; level--) {
+      auto &slot = slots_[level][(current_tick_ >> (level * kSlotBits)) & kSlotMask];
+      std::list<KEY> keys;
+      keys.swap(slot);
+      for (const auto &key : keys) {
+        auto deadline_tick = entries_[key].deadline_tick;
+        Insert(key, deadline_tick);
+      }
+    }
+  }
+
+  uint64_t current_tick_;
+  std::array<std::array<std::list<KEY>, kNumSlots>, kNumLevels> slots_;
+  absl::flat_hash_map<KEY, Entry> entries_;
+};
+
+}  // namespace ray
@@ -0,0 +1,88 @@
+// Copyright 2021 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/timing_wheel.h"
+
+#include <map>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+TEST(TimingWheelTest, TestExpire) {
+  TimingWheel<int> wheel;
+  std::vector<int> expired;
+  auto on_expired = [&expired](const int &key) { expired.push_back(key); };
+  wheel.Schedule(1, 10);
+  wheel.Schedule(2, 5);
+  wheel.Schedule(3, 100);
+  ASSERT_EQ(wheel.Size(), 3);
+
+  wheel.Advance(4, on_expired);
+  ASSERT_TRUE(expired.empty());
+  wheel.Advance(10, on_expired);
+  ASSERT_EQ(expired, std::vector<int>({2, 1}));
+  ASSERT_FALSE(wheel.Contains(1));
+  ASSERT_TRUE(wheel.Contains(3));
+
+  // Rescheduling replaces the deadline, and a passed deadline expires on the next tick.
+  wheel.Schedule(3, 200);
+  wheel.Advance(150, on_expired);
+  ASSERT_EQ(expired.size(), 2);
+  wheel.Schedule(4, 0);
+  ASSERT_TRUE(wheel.Cancel(3));
+  ASSERT_FALSE(wheel.Cancel(3));
+  wheel.Advance(1000, on_expired);
+  ASSERT_EQ(expired, std::vector<int>({2, 1, 4}));
+  ASSERT_EQ(wheel.Size(), 0);
+}
+
+TEST(TimingWheelTest, TestRandomDeadlines) {
+  // Compare the wheel with an ordered map of deadlines, across all the levels.
+  std::mt19937_64 gen(42);
+  TimingWheel<int> wheel(12345);
+  std::map<int, uint64_t> deadlines;
+  uint64_t tick = 12345;
+  for (int round = 0; round < 200; round++) {
+    for (int i = 0; i < 50; i++) {
+      int key = gen() % 1000;
+      uint64_t deadline = tick + 1 + gen() % (uint64_t(1) << (gen() % 30));
+      wheel.Schedule(key, deadline);
+      deadlines[key] = deadline;
+    }
+    tick += 1 + gen() % (uint64_t(1) << (gen() % 20));
+    std::vector<int> expired;
+    wheel.Advance(tick, [&expired](const int &key) { expired.push_back(key); });
+    std::vector<int> expected;
+    for (auto it = deadlines.begin(); it != deadlines.end();) {
+      if (it->second <= tick) {
+        expected.push_back(it->first);
+        it = deadlines.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    std::sort(expired.begin(), expired.end());
+    ASSERT_EQ(expired, expected);
+    ASSERT_EQ(wheel.Size(), deadlines.size());
+  }
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}